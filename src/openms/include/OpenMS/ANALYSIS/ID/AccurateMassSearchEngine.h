@@ -78,7 +78,7 @@ namespace OpenMS
 
     /// checks if an adduct (e.g.a 'M+2K-H;1+') is valid, i.e if the losses (==negative amounts) can actually be lost by the compound given in @p db_entry.
     /// If the negative parts are present in @p db_entry, true is returned.
-    bool isCompatible(EmpiricalFormula db_entry) const;
+    bool isCompatible(const EmpiricalFormula& db_entry) const;
 
     /// get charge of adduct
     int getCharge() const;
@@ -277,14 +277,16 @@ public:
 
     /// main method of AccurateMassSearchEngine
     /// input map is not const, since it will get annotated with results
+    /// Features are queried in parallel (if OpenMP is enabled); results are identical to a serial run.
     void run(FeatureMap&, MzTab&) const;
 
     /// main method of AccurateMassSearchEngine
     /// input map is not const, since it will get annotated with results
     /// @note Call init() before calling run!
+    /// Consensus features are queried in parallel (if OpenMP is enabled); results are identical to a serial run.
     void run(ConsensusMap&, MzTab&) const;
 
-    /// parse database and adduct files
+    /// parse database and adduct files (and precompute which DB entries are compatible with which adduct)
     void init();
 
 protected:
@@ -342,6 +344,12 @@ private:
     void parseAdductsFile_(const String& filename, std::vector<AdductInfo>& result);
     void searchMass_(double neutral_query_mass, double diff_mass, std::pair<Size, Size>& hit_indices) const;
 
+    /// typedef for a table which holds a compatibility flag for each adduct (outer index) and each DB entry (inner index, same order as mass_mappings_)
+    typedef std::vector<std::vector<bool> > AdductCompatibilityTable;
+
+    /// for all @p adducts, check which DB entries are compatible with them (i.e. can lose the adduct's negative parts); each DB formula is parsed only once
+    void computeAdductCompatibility_(const std::vector<AdductInfo>& adducts, AdductCompatibilityTable& compatible) const;
+
     /// add search results to a Consensus/Feature
     void annotate_(const std::vector<AccurateMassSearchResult>&, BaseFeature&) const;
 
@@ -406,6 +414,9 @@ private:
     std::vector<AdductInfo> pos_adducts_;
     std::vector<AdductInfo> neg_adducts_;
 
+    AdductCompatibilityTable pos_adducts_compatible_; ///< DB entry compatibility for each adduct in pos_adducts_
+    AdductCompatibilityTable neg_adducts_compatible_; ///< DB entry compatibility for each adduct in neg_adducts_
+
     String database_name_;
     String database_version_;
 
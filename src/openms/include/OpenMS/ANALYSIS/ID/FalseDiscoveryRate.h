@@ -35,6 +35,7 @@
 #pragma once
 
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
+#include <OpenMS/METADATA/ColumnarPSMStore.h>
 #include <OpenMS/METADATA/ID/IdentificationData.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
 #include <OpenMS/METADATA/ProteinIdentification.h>
@@ -96,6 +97,16 @@ public:
     */
     void apply(std::vector<PeptideIdentification>& id) const;
 
+    /**
+    @brief Calculates the FDR of one run from a concatenated sequence DB search, working directly on a ColumnarPSMStore
+
+    Equivalent to apply(std::vector<PeptideIdentification>&), but avoids the conversion of all hits to PeptideHit objects.
+    Identifications without hits are left untouched.
+
+    @param ids peptide identifications, containing target and decoy hits
+    */
+    void apply(ColumnarPSMStore& ids) const;
+
     /**
     @brief Calculates the FDR of two runs, a forward run and decoy run on protein level
 
@@ -175,6 +186,14 @@ private:
     /// calculates the FDR, given two vectors of scores
     void calculateFDRs_(std::map<double, double>& score_to_fdr, std::vector<double>& target_scores, std::vector<double>& decoy_scores, bool q_value, bool higher_score_better) const;
 
+    /**
+      @brief Calculates and annotates the FDRs of (sorted) peptide hits; shared by apply(std::vector<PeptideIdentification>&) and apply(ColumnarPSMStore&)
+
+      @p ids provides hit-level access with the interface of ColumnarPSMStore. Score types and ranks are not updated.
+    */
+    template <typename PSMContainer>
+    void applyToHits_(PSMContainer& ids) const;
+
     /// Helper function for applyToQueryMatches()
     void handleQueryMatch_(
         IdentificationData::QueryMatchRef match_ref,
@@ -135,6 +135,10 @@ public:
                         TransformationDescription trafo, PeakMap& swath_map);
 
     /** @brief Pick features in one experiment containing chromatogram
+     *
+     * Transition groups are picked and scored in parallel (if OpenMP is
+     * enabled); the order of the features in @p output does not depend on
+     * the number of threads.
      *
      * @param input The input chromatograms
      * @param output The output features with corresponding scores
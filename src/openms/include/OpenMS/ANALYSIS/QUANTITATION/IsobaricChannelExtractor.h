@@ -44,6 +44,7 @@ namespace OpenMS
   class IsobaricQuantitationMethod;
   class ConsensusMap;
   class ConsensusFeature;
+  class OnDiscMSExperiment;
 
   /**
     @brief Extracts individual channels from MS/MS spectra for isobaric labeling experiments.
@@ -62,6 +63,10 @@ namespace OpenMS
     for improvement of protein identification and accuracy of isobaric mass tag quantification on Orbitrap-type mass
     spectrometers. Analytical chemistry 83: 8959-67. http://www.ncbi.nlm.nih.gov/pubmed/22017476
 
+    The extraction works in two passes: first, the MSn scans used for quantification are selected and their
+    preceding and following MS1 scans are determined. Second, precursor purities and reporter intensities are
+    computed for all selected scans in parallel. The result does not depend on the number of threads.
+
     @note Centroided MS and MS/MS data is required.
 
     @htmlinclude OpenMS_IsobaricChannelExtractor.parameters
@@ -91,46 +96,50 @@ public:
     */
     void extractChannels(const PeakMap& ms_exp_data, ConsensusMap& consensus_map);
 
-private:
     /**
-      @brief Small struct to capture the current state of the purity computation.
-
-      It basically contains two iterators pointing to the current potential
-      MS1 precursor scan of an MS2 scan and the MS1 scan immediately
-      following the current MS2 scan.
-    */
-    struct PuritySate_
-    {
-      /// Iterator pointing to the potential MS1 precursor scan
-      PeakMap::ConstIterator precursorScan;
-      /// Iterator pointing to the potential follow up MS1 scan
-      PeakMap::ConstIterator followUpScan;
-
-      /// Indicates if a follow up scan was found
-      bool hasFollowUpScan;
-      /// reference to the experiment to analyze
-      const PeakMap& baseExperiment;
-
-      /**
-        @brief C'tor taking the experiment that will be analyzed.
+      @brief Extracts the isobaric channels from tandem MS data on disc (indexed mzML) and stores intensity values in a consensus map.
 
-        @param targetExp The experiment that will be analyzed.
-      */
-      PuritySate_(const PeakMap& targetExp);
+      Only the meta data of the spectra is kept in memory; the peaks of the MSn scans and of their MS1 neighbours
+      are loaded chunk-wise (in parallel, with one file stream per thread) and sorted by m/z if necessary. The result
+      is identical to the one of extractChannels(const PeakMap&, ConsensusMap&) on the m/z sorted experiment.
 
-      /**
-        @brief Searches the experiment for the next MS1 spectrum with a retention time bigger then @p rt.
-
-        @param rt The next follow up scan should have a retention bigger then this value.
-      */
-      void advanceFollowUp(const double rt);
+      @param ms_exp_data Raw data to search for isobaric quantitation channels.
+      @param consensus_map Output map containing the identified channels and the corresponding intensities.
+    */
+    void extractChannels(OnDiscMSExperiment& ms_exp_data, ConsensusMap& consensus_map);
 
-      /**
-        @brief Check if the currently selected follow up scan has a retention time bigger then the given value.
+private:
+    /// MSn scan selected for quantification, together with the scans required for its precursor information and purity.
+    struct QuantScan_
+    {
+      /// Index of the MSn scan
+      Size msn;
+      /// Index of the MS2 scan holding the MS1 precursor information (== msn for MS2 quantification; -1 if missing)
+      Size ms2;
+      /// Index of the preceding MS1 scan (potential precursor scan; -1 if none)
+      Size precursor_scan;
+      /// Index of the first MS1 scan with a retention time bigger than the one of the MSn scan (-1 if none)
+      Size follow_up_scan;
+    };
 
-        @param rt The retention time to check.
-      */
-      bool followUpValid(const double rt);
+    /// Result of the purity computation and reporter extraction for a single MSn scan.
+    struct ScanQuantification_
+    {
+      ScanQuantification_() :
+        empty_scan(false),
+        precursor_purity(-1.0)
+      {}
+
+      /// The MSn scan has no peaks (nothing was computed)
+      bool empty_scan;
+      /// Precursor purity (-1 if it was not computed)
+      double precursor_purity;
+      /// Reporter intensities (one per channel); empty if the scan did not pass the precursor filters
+      std::vector<Peak2D::IntensityType> intensities;
+      /// m/z distance between expected and closest observed reporter ion (NaN if there is none within 0.5 Th)
+      std::vector<double> mz_deltas;
+      /// Flags for channels with more than one peak within the allowed reporter mass shift
+      std::vector<bool> not_unique;
     };
 
     /// The used quantitation method (itraq4plex, tmt6plex,..).
@@ -166,6 +175,36 @@ private:
     /// add channel information to the map after it has been filled
     void registerChannelsInOutputMap_(ConsensusMap& consensus_map);
 
+    /**
+      @brief Implementation of both extractChannels() variants.
+
+      @param ms_exp_data The experiment; only its meta data is used if @p on_disc is given.
+      @param on_disc Source of the peak data, or null if @p ms_exp_data contains the peaks.
+      @param consensus_map Output map
+    */
+    void extractChannels_(const PeakMap& ms_exp_data, OnDiscMSExperiment* on_disc, ConsensusMap& consensus_map);
+
+    /**
+      @brief First pass: selects the MSn scans used for quantification and determines their MS1 neighbours.
+
+      Only meta data of @p ms_exp_data (MS levels, retention times, precursors) is used.
+
+      @param ms_exp_data The (RT sorted) experiment.
+      @param scans The selected scans, in the order of the experiment.
+      @return $false$ if no scan passes the activation method filter, $true$ otherwise.
+    */
+    bool selectQuantScans_(const PeakMap& ms_exp_data, std::vector<QuantScan_>& scans) const;
+
+    /**
+      @brief Second pass: computes the precursor purity and the reporter intensities of a single MSn scan (thread-safe).
+
+      @param msn The MSn scan.
+      @param precursor_scan The preceding MS1 scan (null if there is none).
+      @param follow_up_scan The following MS1 scan (null if there is none).
+      @param result The result of the computations.
+    */
+    void quantifyScan_(const PeakMap::SpectrumType& msn, const PeakMap::SpectrumType* precursor_scan, const PeakMap::SpectrumType* follow_up_scan, ScanQuantification_& result) const;
+
     /**
       @brief Checks if the given precursor fulfills all constraints for extractions.
 
@@ -183,22 +222,23 @@ private:
     bool hasLowIntensityReporter_(const ConsensusFeature& cf) const;
 
     /**
-      @brief Computes the purity of the precursor given an iterator pointing to the MS/MS spectrum and one to the precursor spectrum.
+      @brief Computes the purity of the precursor of an MS/MS spectrum, interpolated between the precursor spectrum and the following MS1 spectrum.
 
-      @param ms2_spec Iterator pointing to the MS2 spectrum.
-      @param precursor Iterator pointing to the precursor spectrum of ms2_spec.
+      @param ms2_spec The MS2 spectrum.
+      @param precursor_spec The precursor spectrum of ms2_spec.
+      @param follow_up_spec The MS1 spectrum following ms2_spec (null if there is none).
       @return Fraction of the total intensity in the isolation window of the precursor spectrum that was assigned to the precursor.
     */
-    double computePrecursorPurity_(const PeakMap::ConstIterator& ms2_spec, const PuritySate_& pState) const;
+    double computePrecursorPurity_(const PeakMap::SpectrumType& ms2_spec, const PeakMap::SpectrumType& precursor_spec, const PeakMap::SpectrumType* follow_up_spec) const;
 
     /**
-      @brief Computes the purity of the precursor given an iterator pointing to the MS/MS spectrum and a reference to the potential precursor spectrum.
+      @brief Computes the purity of the precursor given the MS/MS spectrum and the potential precursor spectrum.
 
-      @param ms2_spec Iterator pointing to the MS2 spectrum.
-      @param precursor Iterator pointing to the precursor spectrum of ms2_spec.
+      @param ms2_spec The MS2 spectrum.
+      @param precursor_spec The precursor spectrum of ms2_spec.
       @return Fraction of the total intensity in the isolation window of the precursor spectrum that was assigned to the precursor.
     */
-    double computeSingleScanPrecursorPurity_(const PeakMap::ConstIterator& ms2_spec, const PeakMap::SpectrumType& precursor_spec) const;
+    double computeSingleScanPrecursorPurity_(const PeakMap::SpectrumType& ms2_spec, const PeakMap::SpectrumType& precursor_spec) const;
 
     /**
       @brief Get the first (of potentially many) activation methods (HCD,CID,...) of this spectrum.
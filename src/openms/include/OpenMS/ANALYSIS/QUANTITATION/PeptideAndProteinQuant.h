@@ -41,6 +41,8 @@
 #include <OpenMS/METADATA/ProteinIdentification.h>
 #include <OpenMS/METADATA/ExperimentalDesign.h>
 
+#include <unordered_map>
+
 namespace OpenMS
 {
   /**
@@ -48,6 +50,11 @@ namespace OpenMS
 
       This class is used by @ref TOPP_ProteinQuantifier. See there for further documentation.
 
+      Quantitative data can be read from a single map (readQuantData()), or from many runs one at a time
+      (startQuantData(), addQuantData(), finishQuantData()). In the latter case, only compact accumulators
+      (interned peptide sequences and protein accessions, with packed abundance columns per fraction, charge and sample)
+      are kept between the runs, so the maps themselves can be released after each call.
+
       @htmlinclude OpenMS_PeptideAndProteinQuant.parameters
   */
   class OPENMS_DLLAPI PeptideAndProteinQuant :
@@ -158,6 +165,40 @@ public:
                        std::vector<PeptideIdentification>& peptides,
                        const ExperimentalDesign& ed);
 
+    /**
+         @brief Start reading quantitative data from several runs, one at a time (streaming).
+
+         Clears all results. Add the runs with addQuantData() and call finishQuantData() afterwards.
+    */
+    void startQuantData(const ExperimentalDesign& ed);
+
+    /**
+         @brief Add quantitative data from the feature map of one run (see startQuantData()).
+
+         @param features Features of the run
+         @param ms_file_row Row of the run in the MS file section of the experimental design (determines fraction and sample)
+
+         @exception Exception::IndexOverflow if @p ms_file_row is not a row of the experimental design
+    */
+    void addQuantData(FeatureMap& features, Size ms_file_row);
+
+    /**
+         @brief Add quantitative data from a consensus map (see startQuantData()).
+
+         @param consensus Consensus map (e.g. of one run, or of one fraction)
+         @param first_ms_file_row Row in the MS file section of the experimental design that corresponds to map index 0 of @p consensus (map index @em i corresponds to row @p first_ms_file_row + @em i)
+
+         @exception Exception::IndexOverflow if a map index does not correspond to a row of the experimental design
+    */
+    void addQuantData(ConsensusMap& consensus, Size first_ms_file_row = 0);
+
+    /**
+         @brief Finish reading quantitative data (see startQuantData()).
+
+         Afterwards, peptide results are available for quantifyPeptides().
+    */
+    void finishQuantData();
+
     /**
          @brief Compute peptide abundances.
 
@@ -205,6 +246,63 @@ private:
     /// Protein quantification data
     ProteinQuant prot_quant_;
 
+    /// Compact quantitative data of a peptide, used while reading the input (see startQuantData())
+    struct PeptideAccumulator_
+    {
+      /// protein accessions (indexes assigned in @p accession_index_, sorted)
+      std::vector<Size> accessions;
+
+      /// charge states of identifications (first fraction)
+      std::vector<Int> id_charges;
+
+      /// fraction/charge/sample of the abundances (see abundanceKey_(), sorted)
+      std::vector<UInt64> abundance_keys;
+
+      /// abundances (parallel to @p abundance_keys)
+      std::vector<double> abundances;
+
+      /// number of identifications
+      Size id_count;
+
+      /// constructor
+      PeptideAccumulator_() :
+        id_count(0) {}
+    };
+
+    /// Hash of an AASequence (based on the residue and modification pointers)
+    struct SequenceHash_
+    {
+      std::size_t operator()(const AASequence& sequence) const;
+    };
+
+    /// Experimental design of the data being read
+    ExperimentalDesign design_;
+
+    /// Mapping: peptide sequence (modified) -> index in @p pep_accumulators_
+    std::unordered_map<AASequence, Size, SequenceHash_> peptide_index_;
+
+    /// Accumulated peptide data
+    std::vector<PeptideAccumulator_> pep_accumulators_;
+
+    /// Mapping: protein accession -> index (used in PeptideAccumulator_::accessions)
+    std::unordered_map<String, Size> accession_index_;
+
+    /// Returns the accumulator for peptide @p seq (inserted if necessary)
+    PeptideAccumulator_& getAccumulator_(const AASequence& seq);
+
+    /**
+         @brief Packs fraction, charge and sample into a key for PeptideAccumulator_::abundance_keys.
+
+         @exception Exception::OutOfRange if a value exceeds the range of the key (fractions: 16 bits, charges: 16 bits (signed), samples: 32 bits)
+    */
+    static UInt64 abundanceKey_(size_t fraction, Int charge, size_t sample);
+
+    /// Adds @p abundance to the abundance for fraction/charge/sample of @p seq
+    void addAbundance_(const AASequence& seq, size_t fraction, Int charge, size_t sample, double abundance);
+
+    /// Adds the quantitative information of the peptide identifications attached to @p features (feature map of one run)
+    void addFeatures_(FeatureMap& features, size_t fraction, size_t sample);
+
 
     /**
          @brief Get the "canonical" annotation (a single peptide hit) of a feature/consensus feature from the associated list of peptide identifications.
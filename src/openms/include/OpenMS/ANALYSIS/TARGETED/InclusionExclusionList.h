@@ -37,8 +37,12 @@
 #include <OpenMS/ANALYSIS/TARGETED/TargetedExperiment.h>
 #include <OpenMS/FORMAT/FASTAFile.h>
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
+#include <OpenMS/DATASTRUCTURES/DPosition.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
 
+#include <algorithm>
+#include <limits>
+
 namespace OpenMS
 {
   class FeatureMap;
@@ -62,11 +66,24 @@ protected:
       {
       }
 
+      /// position used to sort windows for clustering (start of the window)
+      double getRT() const
+      {
+        return RTmin_;
+      }
+
+      double getMZ() const
+      {
+        return MZ_;
+      }
+
       double RTmin_;
       double RTmax_;
       double MZ_;
     };
 
+    typedef std::vector<IEWindow> WindowList;
+
     /**
       @brief Determine distance between two spectra
 
@@ -80,8 +97,38 @@ public:
       WindowDistance_(const double rt_bridge, const double mz_max, const bool mz_as_ppm) :
         rt_bridge_(rt_bridge),
         mz_max_(mz_max),
-        mz_as_ppm_(mz_as_ppm)
+        mz_as_ppm_(mz_as_ppm),
+        max_rt_width_(-1),
+        max_window_mz_(-1)
+      {
+      }
+
+      /// Sets the largest RT width and m/z of the windows to compare (required for a bounded getBoundingTolerance())
+      void setWindowBounds(const WindowList& windows)
       {
+        max_rt_width_ = 0;
+        max_window_mz_ = 0;
+        for (const IEWindow& w : windows)
+        {
+          max_rt_width_ = std::max(max_rt_width_, w.RTmax_ - w.RTmin_);
+          max_window_mz_ = std::max(max_window_mz_, w.MZ_);
+        }
+      }
+
+      /**
+        @brief Maximal difference in RT start and m/z of windows with non-zero similarity
+
+        Used by ClusterHierarchical to compare only nearby windows. Unbounded if setWindowBounds() was not called.
+      */
+      DPosition<2> getBoundingTolerance() const
+      {
+        if (max_rt_width_ < 0)
+        {
+          return DPosition<2>(std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+        }
+        double mz_tol = mz_as_ppm_ ? mz_max_ * max_window_mz_ * 1e-6 : mz_max_;
+        // slightly wider than needed, so that rounding never drops a pair the ()-operator accepts
+        return DPosition<2>((max_rt_width_ + rt_bridge_) * (1 + 1e-9), mz_tol * (1 + 1e-9));
       }
 
       // measure of SIMILARITY (not distance, i.e. 1-distance)!!
@@ -120,12 +167,12 @@ protected:
       double rt_bridge_; ///< max rt distance between two windows in order to be considered overlapping
       double mz_max_; ///< max m/z distance between two ...
       bool mz_as_ppm_; ///< m/z distance unit
+      double max_rt_width_; ///< largest RT width of the windows to compare (negative: unknown)
+      double max_window_mz_; ///< largest m/z of the windows to compare
 
     }; // end of WindowDistance_
 
 
-    typedef std::vector<IEWindow> WindowList;
-
     /**
       @brief Merges overlapping windows using m/z tolerance
 
@@ -95,6 +95,11 @@ namespace OpenMS
 
       /**
        * @brief Enumerates precursor masses for all candidates in an XL-MS search
+
+          The spectrum precursors are merged into candidate mass windows and the second peptide of each cross-link is looked up by
+          binary search in the (ascending) sorted @p peptides, so the runtime depends on the number of matching candidates instead of
+          the number of peptide pairs. The first peptides are processed in parallel, the order of the result does not depend on the number of threads.
+
        * @param peptides The peptides with precomputed masses from the digestDatabase function
        * @param cross_link_mass_light Mass of the cross-linker, only the light one if a labeled linker is used
        * @param cross_link_mass_mono_link A list of possible masses for the cross-link, if it is attached to a peptide on one side
@@ -108,6 +113,43 @@ namespace OpenMS
        */
       static std::vector<OPXLDataStructs::XLPrecursor> enumerateCrossLinksAndMasses(const std::vector<OPXLDataStructs::AASeqWithMass>&  peptides, double cross_link_mass_light, const DoubleList& cross_link_mass_mono_link, const StringList& cross_link_residue1, const StringList& cross_link_residue2, const std::vector< double >& spectrum_precursors, std::vector< int >& precursor_correction_positions, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm);
 
+      /**
+       * @brief Enumerates cross-link candidates starting from observed masses of one of the linked peptides (alpha first)
+
+          Open search strategy for MS-cleavable cross-linkers, where the masses of the linked peptides can be derived from signature
+          ion doublets in the MS/MS spectrum (see findSignatureDoubletMasses()). Only peptides matching one of the @p alpha_masses are considered for one side of the link,
+          the other side is looked up by binary search on the remaining precursor mass. Only cross-links between two peptides are
+          enumerated, no mono-links or loop-links. Each peptide pair is reported once, with the smaller index as alpha_index.
+
+       * @param peptides The peptides with precomputed masses from the digestDatabase function, sorted by mass (ascending)
+       * @param cross_link_mass Mass of the cross-linker, only the light one if a labeled linker is used
+       * @param alpha_masses The observed masses of linked peptides (without the cross-linker)
+       * @param alpha_mass_tolerance The tolerance for matching @p alpha_masses to peptide masses
+       * @param alpha_mass_tolerance_unit_ppm The unit of the alpha mass tolerance, "ppm" if true, "Da" if false
+       * @param spectrum_precursors A vector of MS2 precursor masses (sorted ascending). Used to filter out candidates.
+       * @param precursor_correction_positions A vector of the position of the used precursor correction
+       * @param precursor_mass_tolerance The precursor mass tolerance
+       * @param precursor_mass_tolerance_unit_ppm The unit of the precursor mass tolerance, "ppm" if true, "Da" if false
+       * @return A vector of XLPrecursors containing the candidate cross-links
+       */
+      static std::vector<OPXLDataStructs::XLPrecursor> enumerateCrossLinksAlphaFirst(const std::vector<OPXLDataStructs::AASeqWithMass>& peptides, double cross_link_mass, const std::vector< double >& alpha_masses, double alpha_mass_tolerance, bool alpha_mass_tolerance_unit_ppm, const std::vector< double >& spectrum_precursors, std::vector< int >& precursor_correction_positions, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm);
+
+      /**
+       * @brief Finds the masses of linked peptides from signature ion doublets of an MS-cleavable cross-linker
+
+          After cleavage of the linker in MS/MS, each linked peptide carries one of two remnants (stubs) of the linker, e.g. the
+          alkene and the thiol stub of DSSO. Two peaks with the same charge, whose masses differ by the difference of the stub masses, are
+          considered a doublet. The peptide mass is the mass of the lighter peak minus the lighter stub.
+
+       * @param spectrum The MS/MS spectrum, sorted by m/z
+       * @param stub_masses The masses of the two stubs of the cross-linker
+       * @param max_charge The maximal charge of the signature ions (usually the precursor charge)
+       * @param fragment_mass_tolerance The tolerance for matching the second peak of a doublet
+       * @param fragment_mass_tolerance_unit_ppm The unit of the fragment mass tolerance, "ppm" if true, "Da" if false
+       * @return The peptide masses (sorted ascending, without duplicates)
+       */
+      static std::vector< double > findSignatureDoubletMasses(const PeakSpectrum& spectrum, const DoubleList& stub_masses, Int max_charge, double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm);
+
       /**
        * @brief Digests a database with the given EnzymaticDigestion settings and precomputes masses for all peptides
 
@@ -240,6 +282,8 @@ namespace OpenMS
 
           This function uses enumerateCrossLinksAndMasses and buildCandidates to search for peptide pairs fitting to the given precursor mass_light
           and all considered precursor corrections.
+          If @p alpha_masses are given (e.g. from findSignatureDoubletMasses()), enumerateCrossLinksAlphaFirst is used instead as a pre-filter:
+          only cross-links with one peptide matching one of the @p alpha_masses are considered.
 
        * @param precursor_correction_steps An IntList of integers as indices of isotopic peaks around the experimental precursor
        * @param precursor_mass The decharged precursor mass
@@ -251,8 +295,11 @@ namespace OpenMS
        * @param cross_link_residue1 A list of one-letter-code residues, that the first side of the cross-linker can attach to
        * @param cross_link_residue2 A list of one-letter-code residues, that the second side of the cross-linker can attach to
        * @param cross_link_name The name of the cross-linker, e.g. "DSS" or "BS3"
+       * @param alpha_masses Observed masses of linked peptides for the alpha first pre-filter (no pre-filter if empty)
+       * @param alpha_mass_tolerance The tolerance for matching @p alpha_masses to peptide masses
+       * @param alpha_mass_tolerance_unit_ppm The unit of the alpha mass tolerance, "ppm" if true, "Da" if false
        */
-      static std::vector <OPXLDataStructs::ProteinProteinCrossLink> collectPrecursorCandidates(const IntList& precursor_correction_steps, double precursor_mass, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm, const std::vector<OPXLDataStructs::AASeqWithMass>& filtered_peptide_masses, double cross_link_mass, DoubleList cross_link_mass_mono_link, StringList cross_link_residue1, StringList cross_link_residue2, String cross_link_name);
+      static std::vector <OPXLDataStructs::ProteinProteinCrossLink> collectPrecursorCandidates(const IntList& precursor_correction_steps, double precursor_mass, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm, const std::vector<OPXLDataStructs::AASeqWithMass>& filtered_peptide_masses, double cross_link_mass, DoubleList cross_link_mass_mono_link, StringList cross_link_residue1, StringList cross_link_residue2, String cross_link_name, const std::vector< double >& alpha_masses = std::vector< double >(), double alpha_mass_tolerance = 0.0, bool alpha_mass_tolerance_unit_ppm = false);
 
       /**
        * @brief Computes the mass error of a precursor mass to a hit
@@ -274,6 +321,12 @@ namespace OpenMS
 
     private:
 
+      // helper function for enumerateCrossLinksAndMasses: sorted, disjoint ranges of candidate masses that can match any of the spectrum precursors
+      static std::vector< std::pair<double, double> > precursor_mass_windows(const std::vector< double >& spectrum_precursors, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm);
+
+      // helper function for enumerateCrossLinksAndMasses: true, if the mass lies within one of the windows
+      static bool in_mass_windows(const std::vector< std::pair<double, double> >& windows, double mass);
+
       // helper function for enumerateCrossLinksAndMasses
       static bool filter_and_add_candidate(std::vector<OPXLDataStructs::XLPrecursor>& mass_to_candidates, const std::vector< double >& spectrum_precursors, std::vector< int >& precursor_correction_positions, bool precursor_mass_tolerance_unit_ppm, double precursor_mass_tolerance, OPXLDataStructs::XLPrecursor precursor);
 
@@ -169,6 +169,7 @@ private:
     double cross_link_mass_iso_shift_;
     DoubleList cross_link_mass_mono_link_;
     String cross_link_name_;
+    DoubleList cross_link_stub_masses_;
 
     StringList fixedModNames_;
     StringList varModNames_;
@@ -0,0 +1,107 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CHEMISTRY/InternedAASequence.h>
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace OpenMS
+{
+  /** @ingroup Chemistry
+
+      @brief Pool of shared peptide sequences (hash-consing)
+
+      intern() returns an InternedAASequence handle; equal sequences map to
+      the same shared object, so they are stored (and their masses computed)
+      only once, no matter how many peptide hits refer to them.
+
+      The pool does not keep sequences alive: an entry is released as soon as
+      the last handle referring to it is destroyed.
+
+      This class is a singleton and thread-safe.
+  */
+  class OPENMS_DLLAPI AASequencePool
+  {
+public:
+    /// this member function serves as a replacement of the constructor
+    static AASequencePool* getInstance();
+
+    /// Destructor
+    ~AASequencePool();
+
+    /// Returns the shared handle for @p sequence
+    InternedAASequence intern(const AASequence& sequence);
+
+    /**
+      @brief Returns the shared handle for the sequence given as string
+
+      The string is only parsed (using AASequence::fromString()) if the
+      same string has not been interned before.
+
+      @exception Exception::ParseError is thrown if the string cannot be parsed
+    */
+    InternedAASequence intern(const String& sequence);
+
+    /// Returns the number of distinct sequences in the pool that are still in use
+    Size size() const;
+
+protected:
+    typedef std::weak_ptr<InternedAASequence::Data_> WeakData_;
+
+    /// Removes entries that are not used any more (if there are enough of them); requires the lock on @p mutex_
+    void purge_();
+
+    /// Entries by canonical sequence (AASequence::toString()); the sequence itself is only stored in the shared data
+    std::unordered_map<String, WeakData_> by_sequence_;
+    /// Entries by string as passed to intern(const String&) (which need not be canonical)
+    std::unordered_map<String, WeakData_> by_string_;
+    Size purge_threshold_;
+    /// Guards the tables
+    mutable std::mutex mutex_;
+
+private:
+    AASequencePool();
+
+    /// Not implemented
+    AASequencePool(const AASequencePool&);
+
+    /// Not implemented
+    AASequencePool& operator=(const AASequencePool&);
+  };
+
+} // namespace OpenMS
@@ -0,0 +1,155 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CHEMISTRY/AASequence.h>
+
+#include <memory>
+#include <vector>
+
+namespace OpenMS
+{
+  class AASequencePool;
+
+  /** @ingroup Chemistry
+
+      @brief Shared, immutable amino acid sequence with cached masses
+
+      An InternedAASequence is a cheap, reference-counted handle to an
+      AASequence that cannot be modified any more. Copying a handle does not
+      copy the sequence, so many peptide hits (e.g. of an identification
+      file) can refer to the same sequence object.
+
+      The monoisotopic and average weights as well as an array of prefix
+      masses are computed on first use and then cached with the sequence,
+      so they are shared by all handles. The memory for the cache is only
+      allocated when a mass is requested.
+
+      Handles created by the constructors wrap their own copy of the
+      sequence. To let equal sequences share a single object, obtain handles
+      from AASequencePool instead.
+
+      All member functions are thread-safe.
+  */
+  class OPENMS_DLLAPI InternedAASequence
+  {
+public:
+    /// Default constructor (empty sequence)
+    InternedAASequence();
+
+    /// Wraps a copy of @p sequence (not pooled)
+    explicit InternedAASequence(const AASequence& sequence);
+
+    /// Wraps @p sequence (not pooled)
+    explicit InternedAASequence(AASequence&& sequence);
+
+    /// Copy constructor (shares the sequence)
+    InternedAASequence(const InternedAASequence&) = default;
+
+    /// Move constructor (leaves @p rhs as an empty sequence)
+    InternedAASequence(InternedAASequence&& rhs) noexcept;
+
+    /// Destructor
+    ~InternedAASequence();
+
+    /// Assignment operator (shares the sequence)
+    InternedAASequence& operator=(const InternedAASequence&) = default;
+
+    /// Move assignment operator (leaves @p rhs as an empty sequence)
+    InternedAASequence& operator=(InternedAASequence&& rhs) noexcept;
+
+    /// Returns the sequence
+    const AASequence& getSequence() const;
+
+    /**
+      @brief Returns the (cached) monoisotopic weight of the full peptide
+
+      Equivalent to <tt>getSequence().getMonoWeight(Residue::Full, charge)</tt>.
+
+      @exception Exception::InvalidValue is thrown for sequences containing 'X' (unknown mass)
+    */
+    double getMonoWeight(Int charge = 0) const;
+
+    /**
+      @brief Returns the (cached) average weight of the uncharged full peptide
+
+      Equivalent to <tt>getSequence().getAverageWeight()</tt>.
+
+      @exception Exception::InvalidValue is thrown for sequences containing 'X' (unknown mass)
+    */
+    double getAverageWeight() const;
+
+    /**
+      @brief Returns the (cached) monoisotopic prefix masses
+
+      Element @e i is the sum of the internal monoisotopic residue masses of
+      the first @e i residues, plus the mass difference of the N-terminal
+      modification (if any). The array has size() + 1 elements. Prefix and
+      suffix ion masses can be obtained by adding the appropriate
+      <tt>Residue::getInternalTo...()</tt> formula (and, for suffixes, the
+      C-terminal modification) to these values.
+
+      @exception Exception::InvalidValue is thrown for sequences containing 'X' (unknown mass)
+    */
+    const std::vector<double>& getPrefixMonoWeights() const;
+
+    /// Returns whether the sequence was obtained from AASequencePool
+    bool isPooled() const;
+
+    /// Equality operator (compares the sequences)
+    bool operator==(const InternedAASequence& rhs) const;
+
+    /// Inequality operator
+    bool operator!=(const InternedAASequence& rhs) const;
+
+    /// Shared data (sequence and cached values)
+    struct Data_;
+
+protected:
+    friend class AASequencePool;
+
+    /// Constructor from shared data
+    explicit InternedAASequence(const std::shared_ptr<Data_>& data);
+
+    /// Creates a handle that is marked as pooled (used by AASequencePool)
+    static InternedAASequence createPooled_(const AASequence& sequence);
+
+    /// Shared data of empty sequences
+    static const std::shared_ptr<Data_>& emptyData_();
+
+    std::shared_ptr<Data_> data_;
+  };
+
+} // namespace OpenMS
@@ -5,6 +5,7 @@ set(directory include/OpenMS/CHEMISTRY)
 set(sources_list_h
 AAIndex.h
 AASequence.h
+AASequencePool.h
 CrossLinksDB.h
 Element.h
 ElementDB.h
@@ -15,6 +16,7 @@ DigestionEnzyme.h
 DigestionEnzymeProtein.h
 DigestionEnzymeRNA.h
 DigestionEnzymeDB.h
+InternedAASequence.h
 ModificationDefinition.h
 ModificationDefinitionsSet.h
 ModifiedNASequenceGenerator.h
@@ -83,6 +83,19 @@ public:
     */
     void operator()(DistanceMatrix<float> & original_distance, std::vector<BinaryTreeNode> & cluster_tree, const float threshold = 1) const override;
 
+    /**
+        @brief clusters the indices according to their respective element distances, given as sparse matrix
+
+        @param distance SparseDistanceMatrix holding the stored pairs, all other pairs are considered to have its missing value
+        @param cluster_tree vector< BinaryTreeNode >, represents the clustering, each node contains the next merged clusters (not element indices) and their distance, strict order is kept: left_child < right_child
+        @param threshold float value, the minimal distance from which on cluster merging is considered unrealistic
+        @throw ClusterFunctor::InsufficientInput thrown if input is <2
+
+        Pairs that are not stored enter the average with the missing value, so the result equals the DistanceMatrix version (for distinct distances) if all pairs with a value different from the missing value are stored.
+        @see ClusterFunctor , BinaryTreeNode
+    */
+    void operator()(const SparseDistanceMatrix & distance, std::vector<BinaryTreeNode> & cluster_tree, const float threshold = 1) const override;
+
     /// creates a new instance of a AverageLinkage object
     static ClusterFunctor * create();
 
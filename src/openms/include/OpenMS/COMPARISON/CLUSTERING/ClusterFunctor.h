@@ -35,9 +35,11 @@
 #pragma once
 
 #include <OpenMS/DATASTRUCTURES/DistanceMatrix.h>
+#include <OpenMS/DATASTRUCTURES/SparseDistanceMatrix.h>
 #include <OpenMS/CONCEPT/Exception.h>
 #include <OpenMS/COMPARISON/CLUSTERING/ClusterAnalyzer.h>
 
+#include <functional>
 #include <vector>
 
 namespace OpenMS
@@ -96,9 +98,36 @@ public:
     */
     virtual void operator()(DistanceMatrix<float> & original_distance, std::vector<BinaryTreeNode> & cluster_tree, const float threshold = 1) const = 0;
 
+    /**
+        @brief clustering the indices according to their respective element distances, given as sparse matrix
+
+        Same as the DistanceMatrix version, but pairs that are not stored in @p distance are considered to have the missing value of @p distance.
+        Runtime and memory depend on the number of stored pairs instead of the square of the number of elements.
+
+        @throw ClusterFunctor::InsufficientInput thrown if input is <2
+        @throw Exception::NotImplemented if the cluster method does not support sparse input (default)
+    */
+    virtual void operator()(const SparseDistanceMatrix & distance, std::vector<BinaryTreeNode> & cluster_tree, const float threshold = 1) const;
+
     /// registers all derived products
     static void registerChildren();
 
+protected:
+
+    /**
+        @brief generic agglomerative clustering on a sparse distance matrix
+
+        Repeatedly merges the closest pair of clusters below @p threshold. After merging clusters @em a and @em b, the distance of the new cluster to
+        every neighbour @em k of @em a or @em b is @p update(d(a,k), |a|, d(b,k), |b|), where missing pairs contribute the missing value of @p distance.
+        Clusters are represented by their smallest element index, ties are broken by smallest indices. @p cluster_tree is filled with dummy nodes
+        (distance -1) to the root afterwards, like the DistanceMatrix versions do.
+    */
+    static void clusterSparse_(const SparseDistanceMatrix & distance, std::vector<BinaryTreeNode> & cluster_tree, const float threshold,
+                               const std::function<float(float, Size, float, Size)> & update);
+
+    /// appends dummy nodes (distance -1) joining the clusters represented by @p roots (ascending, first is 0) until @p cluster_tree has @p size - 1 nodes
+    static void fillDummyNodes_(const std::vector<Size> & roots, Size size, std::vector<BinaryTreeNode> & cluster_tree);
+
   };
 
 }
@@ -42,17 +42,48 @@
 
 #include <OpenMS/KERNEL/StandardTypes.h>
 #include <OpenMS/DATASTRUCTURES/DistanceMatrix.h>
+#include <OpenMS/DATASTRUCTURES/DPosition.h>
+#include <OpenMS/DATASTRUCTURES/SparseDistanceMatrix.h>
 #include <OpenMS/COMPARISON/CLUSTERING/ClusterFunctor.h>
 #include <OpenMS/COMPARISON/CLUSTERING/ClusterAnalyzer.h>
 #include <OpenMS/COMPARISON/SPECTRA/PeakSpectrumCompareFunctor.h>
 #include <OpenMS/COMPARISON/SPECTRA/BinnedSpectrum.h>
 #include <OpenMS/COMPARISON/SPECTRA/BinnedSpectrumCompareFunctor.h>
 #include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/CONCEPT/ParallelExceptionCollector.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace OpenMS
 {
+  namespace Internal
+  {
+    /**
+        @brief Detects similarity functors with a bounded support in RT and m/z
+
+        True if @p SimilarityComparator has a const method @p getBoundingTolerance() returning a DPosition<2> (RT, m/z) outside of which
+        the similarity is 0, and @p Data provides @p getRT() and @p getMZ().
+    */
+    template <typename Data, typename SimilarityComparator, typename = void>
+    struct HasBoundingTolerance :
+      std::false_type
+    {
+    };
+
+    template <typename Data, typename SimilarityComparator>
+    struct HasBoundingTolerance<Data, SimilarityComparator,
+                                decltype(void(DPosition<2>(std::declval<const SimilarityComparator&>().getBoundingTolerance())),
+                                         void(std::declval<const Data&>().getRT()),
+                                         void(std::declval<const Data&>().getMZ()))> :
+      std::true_type
+    {
+    };
+  }
 
   /**
       @brief Hierarchical clustering with generic clustering functions
@@ -134,6 +165,40 @@ public:
       clusterer(original_distance, cluster_tree, threshold_);
     }
 
+    /**
+        @brief Clustering function on a sparse distance matrix
+
+        Same as the DistanceMatrix version, but only pairs with a distance below ClusterHierarchical::threshold_ are stored, so memory is linear
+        in the number of related pairs. All other pairs get distance 1. The pairwise similarities are computed in parallel (if OpenMP is enabled),
+        so the ()-operator of @p comparator must be safe to call concurrently.
+
+        If @p comparator provides <tt>DPosition<2> getBoundingTolerance() const</tt> (maximal RT and m/z difference of elements with a non-zero
+        similarity) and @p Data provides @p getRT() and @p getMZ(), only pairs within this tolerance are compared (sweep over RT-sorted data)
+        instead of all pairs.
+
+        @param data vector of objects to be clustered
+        @param comparator similarity functor fitting for types in data
+        @param clusterer a clustermethod implementation supporting sparse input, baseclass ClusterFunctor
+        @param cluster_tree the vector that will hold the BinaryTreeNodes representing the clustering (for further investigation with the ClusterAnalyzer methods)
+        @param distance the SparseDistanceMatrix holding the pairwise distances of the elements in @p data, will be made newly if given size does not fit to the number of elements given in @p data
+        @see ClusterFunctor, BinaryTreeNode, ClusterAnalyzer, SparseDistanceMatrix
+    */
+    template <typename Data, typename SimilarityComparator>
+    void cluster(const std::vector<Data> & data,
+      const SimilarityComparator & comparator,
+      const ClusterFunctor & clusterer,
+      std::vector<BinaryTreeNode> & cluster_tree,
+      SparseDistanceMatrix & distance)
+    {
+      if (distance.dimensionsize() != data.size())
+      {
+        distance = createSparseDistances_(data, comparator, Internal::HasBoundingTolerance<Data, SimilarityComparator>());
+      }
+
+      // create clustering with ClusterMethod, SparseDistanceMatrix and Data
+      clusterer(distance, cluster_tree, threshold_);
+    }
+
     /**
         @brief clustering function for binned PeakSpectrum
 
@@ -195,12 +260,114 @@ public:
 
     /// set the threshold (in terms of distance)
     /// The default is 1, i.e. only at similarity 0 the clustering stops.
-    /// Warning: clustering is not supported by all methods yet (e.g. SingleLinkage does ignore it).
+    /// Warning: clustering is not supported by all methods yet (e.g. SingleLinkage does ignore it on a DistanceMatrix).
     void setThreshold(double x)
     {
       threshold_ = x;
     }
 
+private:
+
+    /// compares all pairs
+    template <typename Data, typename SimilarityComparator>
+    SparseDistanceMatrix createSparseDistances_(const std::vector<Data> & data, const SimilarityComparator & comparator, std::false_type) const
+    {
+      std::vector<Size> order(data.size());
+      for (Size i = 0; i < order.size(); ++i)
+      {
+        order[i] = i;
+      }
+      const std::vector<double> position(data.size(), 0.0);
+      const double unbounded = std::numeric_limits<double>::max();
+      return fillSparseDistances_(data, comparator, order, position, position, DPosition<2>(unbounded, unbounded));
+    }
+
+    /// compares only pairs within the bounding tolerance of @p comparator
+    template <typename Data, typename SimilarityComparator>
+    SparseDistanceMatrix createSparseDistances_(const std::vector<Data> & data, const SimilarityComparator & comparator, std::true_type) const
+    {
+      std::vector<Size> order(data.size());
+      for (Size i = 0; i < order.size(); ++i)
+      {
+        order[i] = i;
+      }
+      std::stable_sort(order.begin(), order.end(), [&data](Size a, Size b)
+      {
+        return data[a].getRT() < data[b].getRT();
+      });
+      std::vector<double> rt(data.size()), mz(data.size());
+      for (Size p = 0; p < order.size(); ++p)
+      {
+        rt[p] = data[order[p]].getRT();
+        mz[p] = data[order[p]].getMZ();
+      }
+      return fillSparseDistances_(data, comparator, order, rt, mz, DPosition<2>(comparator.getBoundingTolerance()));
+    }
+
+    /**
+        @brief computes the distances of all pairs of @p data (in RT order @p order) that are within @p tolerance
+
+        @p rt and @p mz hold the positions of the elements in the order of @p order, @p rt must be ascending.
+    */
+    template <typename Data, typename SimilarityComparator>
+    SparseDistanceMatrix fillSparseDistances_(const std::vector<Data> & data, const SimilarityComparator & comparator, const std::vector<Size> & order,
+                                              const std::vector<double> & rt, const std::vector<double> & mz, const DPosition<2> & tolerance) const
+    {
+      std::vector<SparseDistanceMatrix::Entry> entries;
+
+      // the first exception (by position) thrown inside the parallel region; rethrown afterwards
+      ParallelExceptionCollector errors;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+      {
+        std::vector<SparseDistanceMatrix::Entry> thread_entries;
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 16)
+#endif
+        for (SignedSize p = 0; p < (SignedSize)order.size(); ++p)
+        {
+          try
+          {
+            for (Size q = p + 1; q < order.size() && rt[q] - rt[p] <= tolerance[0]; ++q)
+            {
+              if (std::fabs(mz[q] - mz[p]) > tolerance[1]) continue;
+
+              // same argument order as the DistanceMatrix version: larger index first
+              const Size i = std::max(order[p], order[q]);
+              const Size j = std::min(order[p], order[q]);
+              // distance value is 1-similarity value, since similarity is in range of [0,1]
+              const float value = 1 - comparator(data[i], data[j]);
+              if (value < threshold_)
+              {
+                thread_entries.push_back(SparseDistanceMatrix::Entry(i, j, value));
+              }
+            }
+          }
+          catch (...)
+          {
+            errors.capture(p);
+          }
+        }
+
+#ifdef _OPENMP
+#pragma omp critical (ClusterHierarchical_entries)
+#endif
+        try
+        {
+          entries.insert(entries.end(), thread_entries.begin(), thread_entries.end());
+        }
+        catch (...)
+        {
+          errors.capture(order.size()); // after all errors of the loop
+        }
+      }
+      errors.rethrowFirst();
+
+      return SparseDistanceMatrix(data.size(), entries, 1);
+    }
+
   };
 
   /** @brief Exception thrown if clustering is attempted without a normalized compare functor
@@ -83,6 +83,19 @@ public:
     */
     void operator()(DistanceMatrix<float> & original_distance, std::vector<BinaryTreeNode> & cluster_tree, const float threshold = 1) const override;
 
+    /**
+        @brief clusters the indices according to their respective element distances, given as sparse matrix
+
+        @param distance SparseDistanceMatrix holding the stored pairs, all other pairs are considered to have its missing value
+        @param cluster_tree vector< BinaryTreeNode >, represents the clustering, each node contains the next merged clusters (not element indices) and their distance, strict order is kept: left_child < right_child
+        @param threshold float value, the minimal distance from which on cluster merging is considered unrealistic
+        @throw ClusterFunctor::InsufficientInput thrown if input is <2
+
+        Yields the same tree as the DistanceMatrix version (for distinct distances) if all pairs below @p threshold are stored and the missing value is >= @p threshold.
+        @see ClusterFunctor , BinaryTreeNode
+    */
+    void operator()(const SparseDistanceMatrix & distance, std::vector<BinaryTreeNode> & cluster_tree, const float threshold = 1) const override;
+
     /// creates a new instance of a CompleteLinkage object
     static ClusterFunctor * create();
 
@@ -83,6 +83,20 @@ public:
     */
     void operator()(DistanceMatrix<float> & original_distance, std::vector<BinaryTreeNode> & cluster_tree, const float threshold = 1) const override;
 
+    /**
+        @brief clusters the indices according to their respective element distances, given as sparse matrix
+
+        @param distance SparseDistanceMatrix holding the stored pairs, all other pairs are considered to have its missing value
+        @param cluster_tree vector< BinaryTreeNode >, represents the clustering, each node contains the next merged clusters (not element indices) and their distance, strict order is kept: left_child < right_child
+        @param threshold float value, only pairs closer than @p threshold are merged
+        @throw ClusterFunctor::InsufficientInput thrown if input is <2
+
+        Single linkage only depends on the stored pairs: they are merged in order of increasing distance (Kruskal), which yields the same tree as the DistanceMatrix version.
+        Unlike the DistanceMatrix version, a @p threshold < 1 is supported. Remaining clusters are joined by dummy nodes (distance -1) to the root.
+        @see ClusterFunctor , BinaryTreeNode
+    */
+    void operator()(const SparseDistanceMatrix & distance, std::vector<BinaryTreeNode> & cluster_tree, const float threshold = 1) const override;
+
     /// creates a new instance of a SingleLinkage object
     static ClusterFunctor * create();
 
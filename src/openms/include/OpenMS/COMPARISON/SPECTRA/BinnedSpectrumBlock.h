@@ -0,0 +1,175 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+//
+#pragma once
+
+#include <OpenMS/COMPARISON/SPECTRA/BinnedSpectrum.h>
+
+#include <Eigen/Core>
+
+#include <vector>
+
+namespace OpenMS
+{
+
+  /**
+    @brief Packed storage of many binned spectra for batched comparisons
+
+    The bins of all spectra are stored in one compressed sparse row (CSR)
+    layout: the bins of spectrum @p i are at positions
+    [getRowOffsets()[i], getRowOffsets()[i + 1]) of getBinIndices() and
+    getIntensities(), in increasing bin order. Together with the precomputed
+    sums and squared norms of the spectra, this allows to compare one query to
+    all spectra of the block without the overhead of pairwise sparse vector
+    operations (see BinnedSpectrumCompareFunctor).
+
+    Optionally, a dense copy of the block over its bin range ("dense window",
+    see createDenseWindow()) can be created. Comparisons then use vectorized
+    operations over contiguous bins, which is faster for blocks with densely
+    occupied bin ranges (e.g. low-resolution bins), at the cost of
+    size() * (getLastBin() - getFirstBin() + 1) floats of memory.
+
+    All spectra in a block need to have the same bin layout (see BinnedSpectrum::isCompatible()).
+    Precursor information is not stored.
+
+    @ingroup SpectraComparison
+  */
+  class OPENMS_DLLAPI BinnedSpectrumBlock
+  {
+public:
+    /// type of bin indices
+    typedef BinnedSpectrum::SparseVectorIndexType BinIndex;
+
+    /// type of the dense window (one row per spectrum)
+    typedef Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> DenseMatrixType;
+
+    /// Default constructor (empty block)
+    BinnedSpectrumBlock();
+
+    /**
+      @brief Detailed constructor
+
+      @exception Exception::IllegalArgument if the spectra have different bin layouts
+    */
+    explicit BinnedSpectrumBlock(const std::vector<BinnedSpectrum>& spectra);
+
+    /// Destructor
+    virtual ~BinnedSpectrumBlock();
+
+    /// Returns the number of spectra
+    Size size() const;
+
+    /// Returns whether the block contains no spectra
+    bool empty() const;
+
+    /// Returns the total number of stored bins
+    Size nonZeros() const;
+
+    /// Returns whether @p spec has the same bin layout as the spectra in this block (always true for empty blocks)
+    bool isCompatible(const BinnedSpectrum& spec) const;
+
+    /// Returns the offsets of the spectra in the bin arrays (size: size() + 1)
+    const std::vector<Size>& getRowOffsets() const;
+
+    /// Returns the bin indices of all spectra
+    const std::vector<BinIndex>& getBinIndices() const;
+
+    /// Returns the bin intensities of all spectra
+    const std::vector<float>& getIntensities() const;
+
+    /// Returns the lowest bin index occupied by any spectrum (0 if there are no bins)
+    BinIndex getFirstBin() const;
+
+    /// Returns the highest bin index occupied by any spectrum (-1 if there are no bins)
+    BinIndex getLastBin() const;
+
+    /// Returns the sum of the bin intensities of spectrum @p index
+    float getSum(Size index) const;
+
+    /// Returns the squared norm (dot product with itself) of spectrum @p index
+    float getSquaredNorm(Size index) const;
+
+    /**
+      @brief Returns spectrum @p index as a BinnedSpectrum (without precursors)
+
+      @exception Exception::IndexOverflow if @p index is out of range
+    */
+    BinnedSpectrum getSpectrum(Size index) const;
+
+    /// Creates the dense window (see class description)
+    void createDenseWindow();
+
+    /// Frees the memory of the dense window
+    void clearDenseWindow();
+
+    /// Returns whether the dense window was created
+    bool hasDenseWindow() const;
+
+    /// Returns the dense window; column @p j corresponds to bin getFirstBin() + j
+    const DenseMatrixType& getDenseWindow() const;
+
+protected:
+    /// binned spectrum without bins, which defines the bin layout
+    BinnedSpectrum layout_;
+
+    /// offsets of the spectra in @p bins_ and @p intensities_
+    std::vector<Size> row_offsets_;
+
+    /// bin indices
+    std::vector<BinIndex> bins_;
+
+    /// bin intensities
+    std::vector<float> intensities_;
+
+    /// sums of the bin intensities per spectrum
+    std::vector<float> sums_;
+
+    /// squared norms per spectrum
+    std::vector<float> squared_norms_;
+
+    /// lowest occupied bin
+    BinIndex first_bin_;
+
+    /// highest occupied bin
+    BinIndex last_bin_;
+
+    /// dense copy of the bins in [first_bin_, last_bin_]
+    DenseMatrixType dense_;
+
+    /// whether @p dense_ was created
+    bool has_dense_;
+  };
+
+}
+
@@ -37,6 +37,7 @@
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
 #include <OpenMS/CONCEPT/Exception.h>
 #include <OpenMS/COMPARISON/SPECTRA/BinnedSpectrum.h>
+#include <OpenMS/COMPARISON/SPECTRA/BinnedSpectrumBlock.h>
 
 #include <cmath>
 
@@ -51,6 +52,11 @@ namespace OpenMS
     documentation of the concrete functors.
     Functors normalized in the range [0,1] are identifiable at the set "normalized" parameter of the ParameterHandler
 
+    To compare one spectrum to many others (e.g. for all-vs-all comparisons),
+    store the others in a BinnedSpectrumBlock and use the batched function call
+    operator, which derived classes implement without pairwise sparse vector
+    operations (and with vectorized operations if the block has a dense window).
+
     @ingroup SpectraComparison
   */
   class OPENMS_DLLAPI BinnedSpectrumCompareFunctor :
@@ -78,6 +84,16 @@ public:
     /// function call operator, calculates self similarity
     virtual double operator()(const BinnedSpectrum& spec) const = 0;
 
+    /**
+      @brief Batched function call operator, calculates the similarities of @p query to all spectra in @p block
+
+      @p scores is resized to the size of @p block. The default implementation
+      uses the pairwise function call operator for every spectrum of the block.
+
+      @exception Exception::IllegalArgument is thrown if the bin layouts of @p query and @p block differ
+    */
+    virtual void operator()(const BinnedSpectrum& query, const BinnedSpectrumBlock& block, std::vector<double>& scores) const;
+
     /// registers all derived products
     static void registerChildren();
 
@@ -87,6 +103,13 @@ public:
       return "BinnedSpectrumCompareFunctor";
     }
 
+protected:
+    /// checks that @p query and @p block are compatible (throws Exception::IllegalArgument otherwise) and resizes @p scores
+    static void prepareBatch_(const BinnedSpectrum& query, const BinnedSpectrumBlock& block, std::vector<double>& scores);
+
+    /// returns the bins of @p query in the bin range of @p block as a dense vector (column @p j: bin block.getFirstBin() + j)
+    static Eigen::RowVectorXf denseQuery_(const BinnedSpectrum& query, const BinnedSpectrumBlock& block);
+
   };
 
 }
@@ -89,6 +89,12 @@ public:
     /// function call operator, calculates self similarity
     double operator()(const BinnedSpectrum& spec) const override;
 
+    /** @brief Batched function call operator, calculates the similarities of @p query to all spectra in @p block
+
+      Gives the same results as the pairwise function call operator (up to rounding).
+    */
+    void operator()(const BinnedSpectrum& query, const BinnedSpectrumBlock& block, std::vector<double>& scores) const override;
+
     ///
     static BinnedSpectrumCompareFunctor* create() { return new BinnedSumAgreeingIntensities(); }
 
@@ -0,0 +1,153 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+//
+#pragma once
+
+#include <OpenMS/COMPARISON/SPECTRA/BinnedSpectrum.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace OpenMS
+{
+
+  /**
+    @brief Search index for spectral libraries
+
+    The library spectra are sorted by precursor m/z (first precursor of each
+    spectrum) and binned once (see BinnedSpectrum), so that candidates for a
+    query can be found by a binary search and scored by a sparse dot product
+    of the cached, normalized bin vectors (see getBinnedSpectrum()). The
+    default bin settings are those used by SpectraSTSimilarityScore::transform(),
+    i.e. dot products of cached vectors equal SpectraST similarity scores.
+
+    In addition, the @p top_bins most intense bins of every library spectrum
+    are stored in an inverted index (bin -> library spectra). findCandidates()
+    uses it to restrict candidates in a precursor window to those that share a
+    minimum number of top bins with the query.
+
+    Library spectra are referred to by their positions in the vector passed to
+    build().
+
+    @ingroup SpectraComparison
+  */
+  class OPENMS_DLLAPI SpectralLibraryIndex
+  {
+public:
+    /// type of bin indices
+    typedef BinnedSpectrum::SparseVectorIndexType BinIndex;
+
+    /**
+      @brief Constructor
+
+      @param bin_size Bin width (in Th)
+      @param bin_spread Number of neighboring bins a peak is also added to
+      @param offset Bin offset
+      @param top_bins Number of most intense bins per library spectrum stored in the inverted index
+    */
+    SpectralLibraryIndex(float bin_size = 1.0f, UInt bin_spread = 1, float offset = BinnedSpectrum::DEFAULT_BIN_OFFSET_LOWRES, Size top_bins = 5);
+
+    /// Destructor
+    virtual ~SpectralLibraryIndex();
+
+    /**
+      @brief Builds the index for a library (replaces any previous content)
+
+      Library spectra need to be sorted by m/z.
+
+      @exception Exception::MissingInformation if a library spectrum has no precursor
+    */
+    void build(const std::vector<PeakSpectrum>& library);
+
+    /// Returns the number of library spectra
+    Size size() const;
+
+    /// Returns the number of bins per library spectrum stored in the inverted index
+    Size getNumberOfTopBins() const;
+
+    /**
+      @brief Returns the library spectra with precursor m/z in [@p min_mz, @p max_mz]
+
+      Spectra are returned in order of increasing precursor m/z (spectra with equal precursor m/z in library order).
+    */
+    std::vector<Size> findByPrecursor(double min_mz, double max_mz) const;
+
+    /**
+      @brief Returns the library spectra with precursor m/z in [@p min_mz, @p max_mz] that share at least @p min_shared_bins of their top bins with the top bins of @p query
+
+      @p query should have been created with binSpectrum(). Order as for findByPrecursor(), which gives the same result if @p min_shared_bins is zero.
+    */
+    std::vector<Size> findCandidates(const BinnedSpectrum& query, double min_mz, double max_mz, Size min_shared_bins) const;
+
+    /**
+      @brief Returns the cached, normalized binned spectrum of a library spectrum
+
+      @exception Exception::IndexOverflow if @p index is out of range
+    */
+    const BinnedSpectrum& getBinnedSpectrum(Size index) const;
+
+    /// Bins (and normalizes) a spectrum with the settings of this index, e.g. a query
+    BinnedSpectrum binSpectrum(const PeakSpectrum& spectrum) const;
+
+    /// Returns the indices of the @p getNumberOfTopBins() most intense bins (ties: lower index first), in increasing order
+    std::vector<BinIndex> getTopBins(const BinnedSpectrum& binned) const;
+
+protected:
+    /// bin width
+    float bin_size_;
+
+    /// bin spread
+    UInt bin_spread_;
+
+    /// bin offset
+    float offset_;
+
+    /// number of indexed bins per library spectrum
+    Size top_bins_;
+
+    /// precursor m/z and library position, sorted by m/z
+    std::vector<std::pair<double, Size> > precursors_;
+
+    /// binned library spectra (by library position)
+    std::vector<BinnedSpectrum> binned_;
+
+    /// inverted index: bin -> ranks (positions in @p precursors_) of library spectra with this bin among their top bins (sorted)
+    std::unordered_map<BinIndex, std::vector<Size> > postings_;
+
+    /// returns the range of ranks with precursor m/z in [@p min_mz, @p max_mz]
+    std::pair<Size, Size> precursorRange_(double min_mz, double max_mz) const;
+  };
+
+}
+
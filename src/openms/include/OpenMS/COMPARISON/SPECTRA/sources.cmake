@@ -6,11 +6,13 @@ set(sources_list_h
 BinnedSharedPeakCount.h
 BinnedSpectralContrastAngle.h
 BinnedSpectrum.h
+BinnedSpectrumBlock.h
 BinnedSpectrumCompareFunctor.h
 BinnedSumAgreeingIntensities.h
 PeakAlignment.h
 PeakSpectrumCompareFunctor.h
 SpectraSTSimilarityScore.h
+SpectralLibraryIndex.h
 SpectrumAlignment.h
 SpectrumAlignmentScore.h
 SpectrumCheapDPCorr.h
@@ -0,0 +1,127 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+
+#include <exception>
+#include <limits>
+#include <mutex>
+
+namespace OpenMS
+{
+
+  /**
+    @brief Collects the exceptions thrown in the iterations of a parallel loop and rethrows the one of the lowest iteration.
+
+    Exceptions must not leave an OpenMP parallel region. Catch them in the loop body, pass them on with capture()
+    and call rethrowFirst() after the region. Of several exceptions, the one of the lowest iteration index is
+    rethrown, independent of the thread schedule, i.e. the same one a serial run would throw first.
+
+    @code
+    ParallelExceptionCollector errors;
+    #pragma omp parallel for
+    for (SignedSize i = 0; i < n; ++i)
+    {
+      try
+      {
+        ...
+      }
+      catch (...)
+      {
+        errors.capture(i);
+      }
+    }
+    errors.rethrowFirst();
+    @endcode
+
+    capture() may be called concurrently from any thread.
+
+    @ingroup Concept
+  */
+  class ParallelExceptionCollector
+  {
+public:
+    /// Default constructor
+    ParallelExceptionCollector() :
+      first_index_(std::numeric_limits<SignedSize>::max())
+    {
+    }
+
+    /// Stores the exception currently handled (call it in a catch block), unless one of a lower @p index is stored already
+    void capture(SignedSize index)
+    {
+      capture(index, std::current_exception());
+    }
+
+    /// Stores @p error, unless one of a lower @p index is stored already
+    void capture(SignedSize index, std::exception_ptr error)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (error && index < first_index_)
+      {
+        first_index_ = index;
+        first_error_ = error;
+      }
+    }
+
+    /// Returns whether an exception was captured (only reliable after the parallel region)
+    bool hasError() const
+    {
+      return first_error_ != nullptr;
+    }
+
+    /// Returns the index of the first exception (only meaningful if hasError())
+    SignedSize getFirstIndex() const
+    {
+      return first_index_;
+    }
+
+    /// Rethrows the exception of the lowest index, if any (call it after the parallel region)
+    void rethrowFirst() const
+    {
+      if (first_error_)
+      {
+        std::rethrow_exception(first_error_);
+      }
+    }
+
+private:
+    std::mutex mutex_;
+    SignedSize first_index_;
+    std::exception_ptr first_error_;
+  };
+
+} // namespace OpenMS
@@ -37,6 +37,7 @@
 #include <OpenMS/CONCEPT/Types.h>
 
 #include <map>
+#include <vector>
 
 namespace OpenMS
 {
@@ -49,6 +50,9 @@ namespace OpenMS
 
     Use startProgress, setProgress and endProgress for the actual logging.
 
+    If the Profiler is enabled, each startProgress / endProgress pair is recorded as a span
+    (category "progress") named after the label, independent of the log type.
+
     @note All methods are const, so it can be used through a const reference or in const methods as well!
   */
   class OPENMS_DLLAPI ProgressLogger
@@ -130,6 +134,9 @@ protected:
 
     mutable ProgressLoggerImpl* current_logger_;
 
+    /// Profiler spans opened by startProgress (innermost last); not copied
+    mutable std::vector<std::pair<Size, SignedSize> > profile_spans_;
+
   };
 
 } // namespace OpenMS
@@ -41,6 +41,7 @@
 #include <OpenMS/OpenMSConfig.h>
 
 #include <iosfwd>
+#include <memory>
 #include <set>
 
 namespace OpenMS
@@ -67,6 +68,9 @@ namespace OpenMS
     Each parameter can be annotated with an arbitrary number of tags. Tags must not contain comma characters!
     @n E.g. the <i>advanced</i> tag indicates if this parameter is shown to all users or in advanced mode only.
 
+    Copies of a Param share their data until one of them is modified, so copying is cheap even for large trees.
+    Lookups of full keys (getValue(), exists(), ...) use a hash index which is built on demand.
+
     @see DefaultParamHandler
 
     @ingroup Datastructures
@@ -259,7 +263,7 @@ protected:
     Param(const Param&) = default;
 
     /// Move constructor
-    Param(Param&&) = default;
+    Param(Param&& rhs);
 
     /// Destructor
     ~Param();
@@ -268,7 +272,7 @@ protected:
     Param& operator=(const Param&) = default;
 
     /// Move assignment operator
-    Param& operator=(Param&&) & = default;
+    Param& operator=(Param&& rhs) &;
 
     /// Equality operator
     bool operator==(const Param& rhs) const;
@@ -643,18 +647,44 @@ protected:
 
 protected:
 
+    /// Root node and lookup index, shared by copies of a Param until one of them is modified
+    struct ParamData;
+
+    /**
+      @brief Returns a parameter entry.
+
+      @exception Exception::ElementNotFound is thrown for unset parameters
+    */
+    const ParamEntry& getEntry_(const String& key) const;
+
     /**
-      @brief Returns a mutable reference to a parameter entry.
+      @brief Returns a mutable reference to a parameter entry (detaches shared data).
 
       @exception Exception::ElementNotFound is thrown for unset parameters
     */
-    ParamEntry& getEntry_(const String& key) const;
+    ParamEntry& getMutableEntry_(const String& key);
+
+    /// Returns the entry with the full name @p key (or nullptr)
+    ParamEntry* findEntry_(const String& key) const;
+
+    /// Returns the root node for reading (the tree must not be modified through it)
+    ParamNode& getRoot_() const;
+
+    /**
+      @brief Returns the root node for modification.
+
+      Detaches the data from other copies. If @p structural is set (entries or sections are added or removed), the lookup index is dropped.
+    */
+    ParamNode& getMutableRoot_(bool structural = true);
+
+    /// Shared data of empty Params
+    static const std::shared_ptr<ParamData>& emptyData_();
 
     /// Constructor from a node which is used as root node
     Param(const Param::ParamNode& node);
 
-    /// Invisible root node that stores all the data
-    mutable Param::ParamNode root_;
+    /// Invisible root node that stores all the data, together with the lookup index
+    std::shared_ptr<ParamData> data_;
   };
 
   /// Output of Param to a stream.
@@ -0,0 +1,182 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Mathias Walzer $
+// $Authors: $
+// --------------------------------------------------------------------------
+//
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/DistanceMatrix.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+
+  /**
+    @brief A symmetric distance matrix that only stores selected pairs
+
+    Counterpart of OpenMS::DistanceMatrix for data sets where most pairwise
+    distances are irrelevant to the clustering, e.g. because they are above
+    the clustering threshold. Only the given pairs are stored, in compressed
+    sparse row (CSR) layout and mirrored at the main diagonal, so each row
+    lists all its stored neighbours with increasing column index. All pairs
+    that are not stored are reported with the missing value (by default 1,
+    i.e. "unrelated" for distances derived from normalized similarities);
+    the main diagonal is always 0.
+
+    Memory is linear in the number of stored pairs instead of quadratic in
+    the number of elements. The matrix is immutable after construction.
+
+    @see ClusterHierarchical, ClusterFunctor
+
+    @ingroup Datastructures
+  */
+  class OPENMS_DLLAPI SparseDistanceMatrix
+  {
+public:
+
+    /// A single stored pair (order of @p row and @p column does not matter)
+    struct OPENMS_DLLAPI Entry
+    {
+      Size row;
+      Size column;
+      float value;
+
+      Entry() :
+        row(0), column(0), value(0)
+      {
+      }
+
+      Entry(Size r, Size c, float v) :
+        row(r), column(c), value(v)
+      {
+      }
+    };
+
+    /// default constructor, creates an empty matrix
+    SparseDistanceMatrix();
+
+    /**
+      @brief detailed constructor
+
+      @param dimensionsize the number of rows (and therewith cols)
+      @param entries the pairs to store; pairs on the main diagonal are ignored, if a pair is given more than once the smallest value is kept
+      @param missing_value the value reported for pairs that are not stored
+      @throw Exception::IndexOverflow if an entry refers to an element >= @p dimensionsize
+    */
+    SparseDistanceMatrix(Size dimensionsize, const std::vector<Entry>& entries, float missing_value = 1);
+
+    /**
+      @brief conversion from a dense DistanceMatrix
+
+      Stores all pairs of @p matrix with a value below @p cutoff.
+    */
+    SparseDistanceMatrix(const DistanceMatrix<float>& matrix, float cutoff, float missing_value = 1);
+
+    /// Equality operator
+    bool operator==(const SparseDistanceMatrix& rhs) const;
+
+    /// gets the number of rows (and therewith cols)
+    Size dimensionsize() const
+    {
+      return dimensionsize_;
+    }
+
+    /// gets the number of stored pairs (each mirrored pair is counted once)
+    Size size() const
+    {
+      return values_.size() / 2;
+    }
+
+    /// gets the value reported for pairs that are not stored
+    float getMissingValue() const
+    {
+      return missing_value_;
+    }
+
+    /// returns true if the pair (@p i, @p j) is stored
+    bool hasValue(Size i, Size j) const;
+
+    /**
+      @brief gets the value of the pair (@p i, @p j)
+
+      Returns 0 on the main diagonal and the missing value for pairs that are
+      not stored. Lookup is a binary search in row @p i.
+
+      @throw Exception::IndexOverflow if @p i or @p j is >= dimensionsize()
+    */
+    float getValue(Size i, Size j) const;
+
+    /**
+      @name CSR access
+
+      The stored neighbours of row @p i are
+      <tt>getColumns()[k]</tt> with values <tt>getValues()[k]</tt> for
+      <tt>k</tt> in <tt>[getRowOffsets()[i], getRowOffsets()[i + 1])</tt>.
+    */
+    //@{
+    const std::vector<Size>& getRowOffsets() const
+    {
+      return row_offsets_;
+    }
+
+    const std::vector<Size>& getColumns() const
+    {
+      return columns_;
+    }
+
+    const std::vector<float>& getValues() const
+    {
+      return values_;
+    }
+    //@}
+
+protected:
+
+    /// builds the CSR arrays from @p entries
+    void build_(const std::vector<Entry>& entries);
+
+    /// number of rows and columns
+    Size dimensionsize_;
+    /// value of pairs that are not stored
+    float missing_value_;
+    /// start of each row in columns_ and values_ (dimensionsize_ + 1 entries)
+    std::vector<Size> row_offsets_;
+    /// column indices, sorted within each row
+    std::vector<Size> columns_;
+    /// stored values, parallel to columns_
+    std::vector<float> values_;
+  };
+
+} // namespace OpenMS
+
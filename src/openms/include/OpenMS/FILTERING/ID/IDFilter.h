@@ -40,6 +40,7 @@
 #include <OpenMS/FORMAT/FASTAFile.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/KERNEL/StandardTypes.h>
+#include <OpenMS/METADATA/ColumnarPSMStore.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
 #include <OpenMS/METADATA/PeptideEvidence.h>
 #include <OpenMS/METADATA/ProteinIdentification.h>
@@ -1308,6 +1309,24 @@ public:
     static void removeDecoys(IdentificationData& id_data);
     ///@}
 
+
+    /// @name Filter functions for class ColumnarPSMStore
+    ///
+    /// These work directly on the columns of the container and behave like the corresponding functions for vectors of PeptideIdentification.
+    ///@{
+    /// Removes identifications that have no hits in them
+    static void removeEmptyIdentifications(ColumnarPSMStore& psms);
+
+    /// Keeps only hits with a score at least as good as @p threshold_score (score orientation is taken into account)
+    static void filterHitsByScore(ColumnarPSMStore& psms, double threshold_score);
+
+    /// Keeps the @p n best hits per identification (score orientation is taken into account)
+    static void keepNBestHits(ColumnarPSMStore& psms, Size n);
+
+    /// Removes hits annotated as decoys (meta value "target_decoy" is "decoy" or "isDecoy" is "true")
+    static void removeDecoyHits(ColumnarPSMStore& psms);
+    ///@}
+
   };
 
 } // namespace OpenMS
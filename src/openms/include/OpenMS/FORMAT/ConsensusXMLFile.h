@@ -107,7 +107,10 @@ protected:
 
 
     /// Writes a peptide identification to a stream (for assigned/unassigned peptide identifications)
-    void writePeptideIdentification_(const String& filename, std::ostream& os, const PeptideIdentification& id, const String& tag_name, UInt indentation_level);
+    void writePeptideIdentification_(const String& filename, std::ostream& os, const PeptideIdentification& id, const String& tag_name, UInt indentation_level) const;
+
+    /// Writes a consensus feature to a stream (thread-safe, used in parallel by store())
+    void writeConsensusElement_(const String& filename, std::ostream& os, const ConsensusFeature& elem) const;
 
 
     /// Options that can be set
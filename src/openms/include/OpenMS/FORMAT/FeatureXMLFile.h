@@ -44,6 +44,7 @@
 #include <OpenMS/DATASTRUCTURES/Param.h>
 #include <OpenMS/DATASTRUCTURES/Map.h>
 
+#include <functional>
 #include <iosfwd>
 
 namespace OpenMS
@@ -89,6 +90,24 @@ public:
     */
     void load(const String& filename, FeatureMap& feature_map);
 
+    /**
+        @brief Reads the file with name @p filename feature by feature
+
+        Instead of collecting all features in a FeatureMap, every (top-level)
+        feature is passed to @p consumer as soon as it has been read, so the
+        memory needed does not depend on the number of features.
+        Range restrictions of the options are applied as in load().
+
+        @p feature_map receives everything else (identifiers, data processing,
+        protein identifications and unassigned peptide identifications), which
+        is stored in front of the features and thus available to @p consumer.
+        It does not contain any features afterwards, and its ranges are not updated.
+
+        @exception Exception::FileNotFound is thrown if the file could not be opened
+        @exception Exception::ParseError is thrown if an error occurs during parsing
+    */
+    void transform(const String& filename, FeatureMap& feature_map, const std::function<void(Feature&)>& consumer);
+
     Size loadSize(const String& filename);
 
     /**
@@ -121,11 +140,14 @@ protected:
     // Docu in base class
     void characters(const XMLCh* const chars, const XMLSize_t length) override;
 
-    /// Writes a feature to a stream
-    void writeFeature_(const String& filename, std::ostream& os, const Feature& feat, const String& identifier_prefix, UInt64 identifier, UInt indentation_level);
+    /// Writes a feature to a stream (thread-safe, used in parallel by store())
+    void writeFeature_(const String& filename, std::ostream& os, const Feature& feat, const String& identifier_prefix, UInt64 identifier, UInt indentation_level) const;
 
     /// Writes a peptide identification to a stream (for assigned/unassigned peptide identifications)
-    void writePeptideIdentification_(const String& filename, std::ostream& os, const PeptideIdentification& id, const String& tag_name, UInt indentation_level);
+    void writePeptideIdentification_(const String& filename, std::ostream& os, const PeptideIdentification& id, const String& tag_name, UInt indentation_level) const;
+
+    /// Passes the top-level feature that was read last to consumer_ (if set) and removes it from map_
+    void consumeFeature_();
 
 
     /**
@@ -144,6 +166,10 @@ protected:
     Feature* current_feature_;
     /// Feature map pointer for reading
     FeatureMap* map_;
+    /// Receives the features while reading in transform() (or null)
+    const std::function<void(Feature&)>* consumer_;
+    /// Number of features passed to consumer_ so far
+    Size consumed_features_;
     /// Options that can be set
     FeatureFileOptions options_;
     /// only parse until "count" tag is reached (used in loadSize())
@@ -39,12 +39,16 @@
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 #include <OpenMS/FORMAT/OPTIONS/PeakFileOptions.h>
 
+#include <vector>
+
 namespace OpenMS
 {
   class PeakFileOptions;
   class MSSpectrum;
   class MSExperiment;
   class FeatureMap;
+  class ProteinIdentification;
+  class PeptideIdentification;
 
   /**
     @brief Facilitates file handling by file type recognition.
@@ -146,6 +150,38 @@ public:
     */
     bool loadFeatures(const String& filename, FeatureMap& map, FileTypes::Type force_type = FileTypes::UNKNOWN);
 
+    /**
+      @brief Loads a file with protein and peptide identifications
+
+      Supported formats are idXML, idBin and mzIdentML.
+
+      @param filename The file name of the file to load.
+      @param protein_ids The protein identifications (identification runs) to load the data into.
+      @param peptide_ids The peptide identifications to load the data into.
+      @param force_type Forces to load the file with that file type. If no type is forced, it is determined from the extension (or from the content if that fails).
+
+      @return true if the file could be loaded, false otherwise
+
+      @exception Exception::FileNotFound is thrown if the file could not be opened
+      @exception Exception::ParseError is thrown if an error occurs during parsing
+    */
+    bool loadIdentifications(const String& filename, std::vector<ProteinIdentification>& protein_ids, std::vector<PeptideIdentification>& peptide_ids, FileTypes::Type force_type = FileTypes::UNKNOWN);
+
+    /**
+      @brief Stores protein and peptide identifications to a file
+
+      Supported formats for storing are idXML, idBin and mzIdentML.
+
+      @param filename The name of the file to store the data in.
+      @param protein_ids The protein identifications (identification runs) to store.
+      @param peptide_ids The peptide identifications to store.
+      @param force_type Forces to store the file with that file type. If no type is forced, it is determined from the extension.
+
+      @exception Exception::InvalidParameter is thrown if the file type is not supported or cannot be determined from the file name
+      @exception Exception::UnableToCreateFile is thrown if the file could not be written
+    */
+    void storeIdentifications(const String& filename, const std::vector<ProteinIdentification>& protein_ids, const std::vector<PeptideIdentification>& peptide_ids, FileTypes::Type force_type = FileTypes::UNKNOWN);
+
     /**
       @brief Computes a SHA-1 hash value for the content of the given file.
 
@@ -49,6 +49,7 @@
 #include <OpenMS/FORMAT/ControlledVocabulary.h>
 #include <OpenMS/FORMAT/VALIDATORS/SemanticValidator.h>
 
+#include <memory>
 
 //MISSING:
 // - more than one selected ion per precursor (warning if more than one)
@@ -230,6 +231,23 @@ protected:
       */
       void populateChromatogramsWithData_();
 
+      /**
+          @brief Hand over the spectra and chromatograms on the work stacks to the decoding pipeline
+
+          Used instead of populateSpectraWithData_() / populateChromatogramsWithData_()
+          if PeakFileOptions::getPipelinedDecoding() is set. The pipeline is
+          started on first use.
+      */
+      void pipelineData_();
+
+      /**
+          @brief Wait until all data handed to the decoding pipeline has been delivered
+
+          Rethrows the first exception that occurred while decoding or
+          consuming data in the pipeline. No-op if no pipeline is running.
+      */
+      void drainPipeline_();
+
       /**
           @brief Add extra data arrays to a spectrum
 
@@ -479,6 +497,18 @@ protected:
       /// Vector of chromatogram data stored for later parallel processing
       std::vector<ChromatogramData> chromatogram_data_;
 
+      /// Decodes the binary data of all spectra in @p data (using multiple threads if available)
+      void decodeSpectra_(std::vector<SpectrumData>& data);
+
+      /// Appends all (decoded) spectra in @p data to the experiment / consumer
+      void deliverSpectra_(std::vector<SpectrumData>& data);
+
+      /// Decodes the binary data of all chromatograms in @p data (using multiple threads if available)
+      void decodeChromatograms_(std::vector<ChromatogramData>& data);
+
+      /// Appends all (decoded) chromatograms in @p data to the experiment / consumer
+      void deliverChromatograms_(std::vector<ChromatogramData>& data);
+
       //@}
       /**@name temporary data structures to hold written data
        *
@@ -508,6 +538,11 @@ protected:
       ControlledVocabulary cv_;
       CVMappings mapping_;
 
+private:
+
+      /// Background threads decoding and delivering data (see PeakFileOptions::setPipelinedDecoding())
+      class DecodingPipeline_;
+      std::unique_ptr<DecodingPipeline_> pipeline_;
     };
 
     //--------------------------------------------------------------------------------
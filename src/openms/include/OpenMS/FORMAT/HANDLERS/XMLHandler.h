@@ -36,6 +36,7 @@
 
 #include <OpenMS/CONCEPT/Types.h>
 #include <OpenMS/CONCEPT/Macros.h>
+#include <OpenMS/CONCEPT/ParallelExceptionCollector.h>
 
 #include <OpenMS/DATASTRUCTURES/ListUtils.h> // StringList
 #include <OpenMS/DATASTRUCTURES/DateTime.h>
@@ -49,7 +50,9 @@
 
 #include <algorithm>
 #include <iosfwd>
+#include <sstream>
 #include <string>
+#include <vector>
 
 namespace OpenMS
 {
@@ -288,6 +291,62 @@ protected:
 
       //@}
 
+      /**
+        @brief Writes @p count elements to @p os, rendering them in parallel
+
+        <tt>render(buffer, i)</tt> has to write element @e i to the stream
+        @p buffer and must be thread-safe. Elements are rendered block-wise
+        into separate text buffers (using the precision of @p os) and written
+        to @p os in their original order, so the output is identical to that
+        of a sequential loop. After each block, <tt>progress(n)</tt> is called
+        with the number of elements written so far.
+
+        The first exception thrown by @p render is rethrown.
+      */
+      template <typename RenderFunction, typename ProgressFunction>
+      static void writeElementsParallel_(std::ostream & os, Size count, RenderFunction render, ProgressFunction progress)
+      {
+        const Size chunk_size = 32; // elements per text buffer
+        const Size block_size = 256 * chunk_size; // bounds the memory used for buffers
+        const std::streamsize precision = os.precision();
+        std::vector<std::string> buffers;
+
+        for (Size block_begin = 0; block_begin < count; block_begin += block_size)
+        {
+          const Size block_end = std::min(count, block_begin + block_size);
+          const SignedSize n_chunks = (block_end - block_begin + chunk_size - 1) / chunk_size;
+          buffers.assign(n_chunks, std::string());
+          ParallelExceptionCollector errors;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+          for (SignedSize c = 0; c < n_chunks; ++c)
+          {
+            try
+            {
+              std::ostringstream buffer;
+              buffer.precision(precision);
+              const Size end = std::min(block_end, block_begin + (c + 1) * chunk_size);
+              for (Size i = block_begin + c * chunk_size; i < end; ++i)
+              {
+                render(buffer, i);
+              }
+              buffers[c] = buffer.str();
+            }
+            catch (...)
+            {
+              errors.capture(c);
+            }
+          }
+          errors.rethrowFirst();
+          for (const std::string& buffer : buffers)
+          {
+            os << buffer;
+          }
+          progress(block_end);
+        }
+      }
+
       ///@name controlled vocabulary handling methods
       //@{
 
@@ -0,0 +1,266 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CONCEPT/ProgressLogger.h>
+#include <OpenMS/METADATA/ColumnarPSMStore.h>
+#include <OpenMS/METADATA/ProteinIdentification.h>
+#include <OpenMS/METADATA/PeptideIdentification.h>
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class QFile;
+
+namespace OpenMS
+{
+  /**
+    @brief Used to load and store binary identification files (.idBin)
+
+    The idBin format holds the same information as idXML (protein
+    identification runs, protein hits and groups, peptide identifications
+    with their hits, evidences, analysis results, fragment annotations and
+    all meta values), but is laid out for fast loading instead of
+    readability:
+
+    - The file starts with a fixed header (magic number, format version,
+      byte order mark) followed by a table of sections.
+    - All strings (identifiers, accessions, sequences, meta value names and
+      string values) are interned in a single string table section and are
+      referenced by index everywhere else. Each distinct peptide sequence
+      is therefore parsed only once per load.
+    - Peptide identifications, peptide hits and peptide evidences are stored
+      column-wise (one contiguous array per attribute), as in
+      ColumnarPSMStore. Variable-sized data (meta values etc.) lives in a
+      separate section with an offset table, so that every identification
+      and hit can be located in constant time.
+    - Each section can optionally be zlib-compressed (see setCompression()).
+      Uncompressed sections can be used directly from a memory-mapped file.
+
+    Numbers are stored in the byte order of the machine that wrote the file;
+    files written on a machine with a different byte order are rejected.
+
+    Besides loading everything at once, MappedFile provides random access to
+    single identifications and hits of a memory-mapped idBin file without
+    materializing the rest of the file.
+
+    @ingroup FileIO
+  */
+  class OPENMS_DLLAPI IdBinaryFile :
+    public ProgressLogger
+  {
+public:
+    /// Version of the file format written by this class
+    static const UInt32 FORMAT_VERSION;
+
+    /**
+      @brief Read-only, memory-mapped access to an idBin file
+
+      Opening a file maps it into memory (or reads it, if mapping is not
+      possible) and decompresses compressed sections. Peptide
+      identifications and hits are only converted into OpenMS data
+      structures when they are requested.
+
+      All const member functions can be called concurrently.
+    */
+    class OPENMS_DLLAPI MappedFile
+    {
+public:
+      /**
+        @brief Opens the given idBin file
+
+        @exception Exception::FileNotFound is thrown if the file does not exist
+        @exception Exception::ParseError is thrown if the file is not a valid idBin file
+      */
+      explicit MappedFile(const String& filename);
+
+      /// Destructor (unmaps the file)
+      ~MappedFile();
+
+      /// Number of peptide identifications
+      Size size() const;
+
+      /// Total number of peptide hits
+      Size getNumberOfHits() const;
+
+      /// Materializes the protein identification runs
+      void getProteinIdentifications(std::vector<ProteinIdentification>& protein_ids) const;
+
+      /// Materializes the peptide identification at position @p id_index (including its hits)
+      PeptideIdentification getPeptideIdentification(Size id_index) const;
+
+      /// Materializes a single peptide hit (global hit index)
+      PeptideHit getPeptideHit(Size hit_index) const;
+
+      /// Index of the first hit of a peptide identification
+      Size getHitBegin(Size id_index) const;
+
+      /// Index past the last hit of a peptide identification
+      Size getHitEnd(Size id_index) const;
+
+      /// Retention time of a peptide identification (read directly from the file)
+      double getRT(Size id_index) const;
+
+      /// m/z of a peptide identification (read directly from the file)
+      double getMZ(Size id_index) const;
+
+      /// Score of a peptide hit (read directly from the file)
+      double getScore(Size hit_index) const;
+
+      /// Sequence string of a peptide hit (read directly from the file, not parsed)
+      String getSequenceString(Size hit_index) const;
+
+protected:
+      /// A section of the file (either pointing into the mapping or into a decompressed buffer)
+      struct Section_
+      {
+        const char* data;
+        UInt64 size;
+      };
+
+      /// Returns the section of the given kind (or an empty section)
+      const Section_& getSection_(UInt32 kind) const;
+
+      /// Returns string number @p index of the string table
+      String getString_(UInt32 index) const;
+
+      /// Reads element @p index of a column starting at @p column_offset in @p section
+      template <typename T>
+      T readColumn_(const Section_& section, UInt64 column_offset, Size index) const;
+
+      /**
+        @brief Materializes a peptide identification
+
+        Sequences are looked up in/added to @p sequence_cache (if given),
+        so that every distinct sequence string is only looked up once in
+        AASequencePool.
+      */
+      void fillPeptideIdentification_(Size id_index, PeptideIdentification& id, std::unordered_map<UInt32, InternedAASequence>* sequence_cache) const;
+
+      /// Materializes a peptide hit (see fillPeptideIdentification_())
+      void fillPeptideHit_(Size hit_index, PeptideHit& hit, std::unordered_map<UInt32, InternedAASequence>* sequence_cache) const;
+
+      String filename_;
+      QFile* file_;
+      const char* data_;
+      UInt64 data_size_;
+      bool mapped_; ///< whether @p data_ points to a memory mapping of @p file_
+      std::string buffer_; ///< file content if mapping was not possible
+      std::vector<std::string> decompressed_; ///< content of compressed sections
+      std::vector<Section_> sections_; ///< indexed by section kind
+
+      UInt64 n_ids_;
+      UInt64 n_hits_;
+      UInt64 n_evidences_;
+      UInt64 n_strings_;
+
+private:
+      /// Not implemented
+      MappedFile(const MappedFile&);
+      /// Not implemented
+      MappedFile& operator=(const MappedFile&);
+
+      friend class IdBinaryFile;
+    };
+
+    /// Default constructor
+    IdBinaryFile();
+
+    /// Destructor
+    ~IdBinaryFile();
+
+    /// Sets whether sections are zlib-compressed when storing (default: false)
+    void setCompression(bool compress);
+
+    /// Returns whether sections are zlib-compressed when storing
+    bool getCompression() const;
+
+    /**
+      @brief Loads an idBin file
+
+      @exception Exception::FileNotFound is thrown if the file could not be opened
+      @exception Exception::ParseError is thrown if the file is not a valid idBin file
+    */
+    void load(const String& filename, std::vector<ProteinIdentification>& protein_ids, std::vector<PeptideIdentification>& peptide_ids);
+
+    /**
+      @brief Loads an idBin file into a ColumnarPSMStore
+
+      Peptide identifications are materialized one at a time and appended
+      to @p psms, so the full vector representation is never held in memory.
+
+      @exception Exception::FileNotFound is thrown if the file could not be opened
+      @exception Exception::ParseError is thrown if the file is not a valid idBin file
+    */
+    void load(const String& filename, std::vector<ProteinIdentification>& protein_ids, ColumnarPSMStore& psms);
+
+    /**
+      @brief Stores the data in an idBin file
+
+      @exception Exception::UnableToCreateFile is thrown if the file could not be created
+    */
+    void store(const String& filename, const std::vector<ProteinIdentification>& protein_ids, const std::vector<PeptideIdentification>& peptide_ids);
+
+    /**
+      @brief Stores the data of a ColumnarPSMStore in an idBin file
+
+      @exception Exception::UnableToCreateFile is thrown if the file could not be created
+    */
+    void store(const String& filename, const std::vector<ProteinIdentification>& protein_ids, const ColumnarPSMStore& psms);
+
+    /// Checks whether the file starts with the idBin magic number
+    static bool isIdBinaryFile(const String& filename);
+
+protected:
+    /**
+      @brief Writes the file
+
+      @p get_peptide_id is called once for every index in [0, @p peptide_id_count)
+      (in order) and has to fill the given peptide identification.
+    */
+    void store_(const String& filename, const std::vector<ProteinIdentification>& protein_ids,
+                Size peptide_id_count, std::function<void(Size, PeptideIdentification&)> get_peptide_id);
+
+    /// Loads the file, handing every peptide identification to @p add_peptide_id
+    void load_(const String& filename, std::vector<ProteinIdentification>& protein_ids,
+               std::function<void(PeptideIdentification&)> add_peptide_id);
+
+    /// Whether sections are compressed when storing
+    bool compress_;
+  };
+
+} // namespace OpenMS
@@ -35,11 +35,13 @@
 #pragma once
 
 #include <OpenMS/CONCEPT/ProgressLogger.h>
+#include <OpenMS/METADATA/ColumnarPSMStore.h>
 #include <OpenMS/METADATA/ProteinIdentification.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
 #include <OpenMS/FORMAT/HANDLERS/XMLHandler.h>
 #include <OpenMS/FORMAT/XMLFile.h>
 
+#include <functional>
 #include <vector>
 
 namespace OpenMS
@@ -103,7 +105,26 @@ public:
         @exception Exception::UnableToCreateFile is thrown if the file could not be created
     */
     void store(const String& filename, const std::vector<ProteinIdentification>& protein_ids, const std::vector<PeptideIdentification>& peptide_ids, const String& document_id = "");
-  
+
+    /**
+        @brief Loads the identifications of an idXML file into a ColumnarPSMStore
+
+        Peptide identifications are appended to @p psms while parsing, i.e. they are never held as a vector of PeptideIdentification.
+
+        @exception Exception::FileNotFound is thrown if the file could not be opened
+        @exception Exception::ParseError is thrown if an error occurs during parsing
+    */
+    void load(const String& filename, std::vector<ProteinIdentification>& protein_ids, ColumnarPSMStore& psms);
+
+    /**
+        @brief Stores the data of a ColumnarPSMStore in an idXML file
+
+        Peptide identifications are reconstructed one at a time while writing. PeptideHits are sorted by score.
+
+        @exception Exception::UnableToCreateFile is thrown if the file could not be created
+    */
+    void store(const String& filename, const std::vector<ProteinIdentification>& protein_ids, const ColumnarPSMStore& psms, const String& document_id = "");
+
 
 protected:
     // Docu in base class
@@ -112,6 +133,17 @@ protected:
     // Docu in base class
     void startElement(const XMLCh* const /*uri*/, const XMLCh* const /*local_name*/, const XMLCh* const qname, const xercesc::Attributes& attributes) override;
 
+    /**
+      @brief Writes an idXML file
+
+      Peptide identifications are accessed by index through @p peptide_id_identifier (only the identifier, used for matching
+      to the protein identification runs) and @p get_peptide_id (the full identification), so different containers can be written.
+    */
+    void store_(const String& filename, const std::vector<ProteinIdentification>& protein_ids, Size peptide_id_count,
+                const std::function<const String&(Size)>& peptide_id_identifier,
+                const std::function<void(Size, PeptideIdentification&)>& get_peptide_id,
+                const String& document_id);
+
     /// Add data from ProteinGroups to a MetaInfoInterface
     /// Since it can be used during load and store, it needs to take a param for the current mode (LOAD/STORE)
     /// to throw appropriate warnings/errors
@@ -152,6 +184,8 @@ protected:
     std::vector<ProteinIdentification>* prot_ids_;
     /// Pointer to fill in peptide identifications
     std::vector<PeptideIdentification>* pep_ids_;
+    /// Pointer to fill in peptide identifications (if set, used instead of pep_ids_)
+    ColumnarPSMStore* psm_store_;
     /// Pointer to last read object with MetaInfoInterface
     MetaInfoInterface* last_meta_;
     /// Search parameters map (key is the "id")
@@ -135,6 +135,12 @@ public:
       does not require a full first pass through the file to compute the
       correct number of spectra and chromatograms in the input file.
 
+      @note If PeakFileOptions::getPipelinedDecoding() is set, parsing,
+      decoding of the binary data and the consumer run concurrently and the
+      consumer is called from a background thread (spectra and chromatograms
+      are still consumed in file order). This pays off if the consumer does
+      substantial work per spectrum.
+
       @param filename_in Filename of input mzML file to transform
       @param consumer Consumer class to operate on the input filename (implementing a transformation)
       @param skip_full_count Whether to skip computing the correct number of spectra and chromatograms in the input file
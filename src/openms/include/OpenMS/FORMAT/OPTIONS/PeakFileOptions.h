@@ -221,6 +221,32 @@ public:
     void setMaxDataPoolSize(Size size);
     //@}
 
+    /**
+        @name Pipelined decoding options
+
+        [mzML only!] When reading, decode the binary data and hand the
+        resulting spectra/chromatograms to the consumer on background threads
+        while the XML parser continues with the next data pool. Spectra and
+        chromatograms are still delivered in file order, but the consumer (and
+        the output experiment) are accessed from a thread other than the
+        calling thread.
+
+        The amount of raw (base64 encoded) data in flight between the parser
+        and the consumer is bounded by the maximal number of pipeline bytes;
+        the parser waits once this budget is exhausted (a single data pool is
+        always admitted, even if it exceeds the budget).
+    */
+    //@{
+    /// Get whether decoding and consuming is pipelined with parsing
+    bool getPipelinedDecoding() const;
+    /// Set whether decoding and consuming is pipelined with parsing
+    void setPipelinedDecoding(bool pipelined);
+    /// Get maximal number of raw data bytes in flight in the decoding pipeline
+    Size getMaxPipelineBytes() const;
+    /// Set maximal number of raw data bytes in flight in the decoding pipeline
+    void setMaxPipelineBytes(Size bytes);
+    //@}
+
     /// [mzML only!] Whether to use the "selected ion m/z" value as the precursor m/z value (alternative: use the "isolation window target m/z" value)
     bool getPrecursorMZSelectedIon() const;
 
@@ -255,6 +281,8 @@ private:
     MSNumpressCoder::NumpressConfig np_config_int_;
     MSNumpressCoder::NumpressConfig np_config_fda_;
     Size maximal_data_pool_size_;
+    bool pipelined_decoding_;
+    Size max_pipeline_bytes_;
     bool precursor_mz_selected_ion_;
   };
 
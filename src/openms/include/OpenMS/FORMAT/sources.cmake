@@ -39,6 +39,7 @@ FileHandler.h
 GzipIfstream.h
 GzipInputStream.h
 IBSpectraFile.h
+IdBinaryFile.h
 IdXMLFile.h
 IndexedMzMLFileLoader.h
 InspectInfile.h
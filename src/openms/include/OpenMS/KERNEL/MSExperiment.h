@@ -36,6 +36,7 @@
 
 #include <OpenMS/KERNEL/StandardDeclarations.h>
 #include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/CONCEPT/ParallelExceptionCollector.h>
 #include <OpenMS/DATASTRUCTURES/DRange.h>
 #include <OpenMS/KERNEL/AreaIterator.h>
 #include <OpenMS/KERNEL/MSChromatogram.h>
@@ -333,6 +334,58 @@ public:
 
     //@}
 
+    ///@name Bulk export of peaks
+    //@{
+    /**
+      @brief Returns the number of peaks exportPeaks() exports for the same selection
+
+      Use it to allocate the columns passed to exportPeaks().
+
+      @param ms_level MS level of the spectra to consider (all if negative)
+      @param min_rt Minimal retention time
+      @param max_rt Maximal retention time (exclusive)
+      @param min_mz Minimal m/z
+      @param max_mz Maximal m/z (exclusive)
+    */
+    Size countPeaks(Int ms_level = -1,
+                    CoordinateType min_rt = -std::numeric_limits<CoordinateType>::max(),
+                    CoordinateType max_rt = std::numeric_limits<CoordinateType>::max(),
+                    CoordinateType min_mz = -std::numeric_limits<CoordinateType>::max(),
+                    CoordinateType max_mz = std::numeric_limits<CoordinateType>::max()) const;
+
+    /**
+      @brief Exports the selected peaks into caller-provided contiguous columns (e.g. numpy arrays)
+
+      In contrast to get2DData(), no peak objects are created: the columns are
+      filled directly and spectra are processed in parallel. Peaks are
+      exported in order of the spectra.
+
+      Columns passed as null pointer are skipped, all others must provide
+      space for countPeaks() (same selection) elements. The ion mobility of a
+      peak is determined as in MSSpectrum::exportPeaks().
+
+      @note The spectra must be sorted by retention time if an RT range is given and by m/z if an m/z range is given.
+
+      @param rt Retention time of the spectrum of each peak
+      @param mz m/z of each peak
+      @param intensity Intensity of each peak
+      @param ion_mobility Ion mobility of each peak
+      @param spectrum_index Index of the spectrum of each peak
+      @param ms_level MS level of the spectra to consider (all if negative)
+      @param min_rt Minimal retention time
+      @param max_rt Maximal retention time (exclusive)
+      @param min_mz Minimal m/z
+      @param max_mz Maximal m/z (exclusive)
+
+      @return The number of exported peaks
+    */
+    Size exportPeaks(double* rt, double* mz, float* intensity, double* ion_mobility, Size* spectrum_index,
+                     Int ms_level = -1,
+                     CoordinateType min_rt = -std::numeric_limits<CoordinateType>::max(),
+                     CoordinateType max_rt = std::numeric_limits<CoordinateType>::max(),
+                     CoordinateType min_mz = -std::numeric_limits<CoordinateType>::max(),
+                     CoordinateType max_mz = std::numeric_limits<CoordinateType>::max()) const;
+    //@}
 
     ///@name Iterating ranges and areas
     //@{
@@ -441,6 +494,39 @@ public:
     */
     void sortChromatograms(bool sort_rt = true);
 
+    /**
+      @brief Applies @p f to every spectrum, processing the spectra in parallel
+
+      Intended for independent per-spectrum transformations (filtering,
+      calibration, ...), i.e. @p f is called as <tt>f(spectrum)</tt> with a
+      mutable SpectrumType and must not access other spectra or unsynchronized
+      shared state. Meta data of the experiment and the ranges are not updated.
+
+      If @p f throws, the remaining spectra may or may not be processed and the
+      exception thrown for the spectrum with the lowest index is rethrown.
+    */
+    template <typename FunctionType>
+    void forEachSpectrumParallel(FunctionType f)
+    {
+      const SignedSize n = static_cast<SignedSize>(spectra_.size());
+      ParallelExceptionCollector errors;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 8)
+#endif
+      for (SignedSize i = 0; i < n; ++i)
+      {
+        try
+        {
+          f(spectra_[i]);
+        }
+        catch (...)
+        {
+          errors.capture(i);
+        }
+      }
+      errors.rethrowFirst();
+    }
+
     /**
       @brief Checks if all spectra are sorted with respect to ascending RT
 
@@ -0,0 +1,232 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/KERNEL/PeakIndex.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Immutable two-dimensional (RT x m/z) index over the peaks of an MSExperiment
+
+    Answers rectangle queries (sum of intensities, highest peak, all peaks)
+    without the two binary searches per spectrum that are needed by
+    MSExperiment::areaBeginConst(). This pays off as soon as many (small)
+    windows are queried on the same map, e.g. for extracted ion chromatograms
+    or precursor purity estimation.
+
+    The spectra of the requested MS level are grouped into blocks of
+    consecutive spectra, the m/z axis is divided into bins of equal width.
+    The peaks are copied once (in parallel) into a column-oriented store that is
+    ordered by (RT block, m/z bin). Only occupied cells are stored (compressed
+    rows: per RT block, the sorted m/z bins of its cells), each with an offset
+    into the peak store and its summed and maximum intensity, so the memory
+    consumption is linear in the number of peaks, independently of the m/z range
+    and the bin width. A query only looks at the individual peaks of the cells on
+    its border, cells completely inside of the rectangle are answered from the
+    precomputed values.
+
+    Peaks are reported as PeakIndex (i.e. spectrum index in the experiment and
+    peak index in the spectrum) in the same order as by the area iterator, so
+    existing loops over an area can be ported directly:
+
+    @code
+    MSExperimentAreaIndex index(exp);
+    std::vector<PeakIndex> peaks;
+    index.extract(MSExperimentAreaIndex::Area(min_rt, max_rt, min_mz, max_mz), peaks);
+    for (const PeakIndex& pi : peaks)
+    {
+      const Peak1D& peak = pi.getPeak(exp);
+      double rt = pi.getSpectrum(exp).getRT();
+      ...
+    }
+    @endcode
+
+    All boundaries of an area are inclusive. The index holds no reference to
+    the experiment, but the reported peak indices are only meaningful as long as
+    the experiment is not modified.
+
+    @note The index keeps a copy of m/z and intensity of every indexed peak
+      (20 bytes per peak). For a handful of queries, MSExperiment::areaBeginConst()
+      is cheaper than building the index.
+
+    @ingroup Kernel
+  */
+  class OPENMS_DLLAPI MSExperimentAreaIndex
+  {
+public:
+    typedef double CoordinateType;
+
+    /// A rectangle in RT and m/z (all boundaries inclusive)
+    struct OPENMS_DLLAPI Area
+    {
+      Area();
+
+      Area(CoordinateType min_rt, CoordinateType max_rt, CoordinateType min_mz, CoordinateType max_mz);
+
+      CoordinateType min_rt;
+      CoordinateType max_rt;
+      CoordinateType min_mz;
+      CoordinateType max_mz;
+    };
+
+    /// Default constructor (empty index)
+    MSExperimentAreaIndex();
+
+    /**
+      @brief Builds the index for all spectra of MS level @p ms_level
+
+      @param exp The experiment (spectra have to be sorted by RT)
+      @param ms_level MS level of the spectra to index (like the area iterator, MS1 by default)
+      @param spectra_per_block Number of consecutive spectra per RT block
+      @param mz_bin_width Width of the m/z bins (in Th)
+
+      @exception Exception::IllegalArgument is thrown if the spectra are not sorted by RT or for a block size or bin width of zero
+    */
+    explicit MSExperimentAreaIndex(const MSExperiment& exp, UInt ms_level = 1, Size spectra_per_block = 8, CoordinateType mz_bin_width = 1.0);
+
+    /// Returns the MS level of the indexed spectra
+    UInt getMSLevel() const;
+
+    /// Returns the number of indexed spectra
+    Size getNrSpectra() const;
+
+    /// Returns the number of indexed peaks
+    Size getNrPeaks() const;
+
+    /// Returns the number of peaks inside of @p area
+    Size countPeaks(const Area& area) const;
+
+    /// Returns the sum of the intensities of all peaks inside of @p area
+    double sumIntensity(const Area& area) const;
+
+    /**
+      @brief Returns the highest peak inside of @p area
+
+      An invalid PeakIndex is returned if the area contains no peak. Of several
+      peaks with the same intensity, the first one in area iterator order is reported.
+    */
+    PeakIndex findHighestPeak(const Area& area) const;
+
+    /// Replaces the content of @p peaks with all peaks inside of @p area (ordered by spectrum and m/z)
+    void extract(const Area& area, std::vector<PeakIndex>& peaks) const;
+
+    /**
+      @name Batched queries
+
+      The results are reported in the order of the given areas. Internally the
+      areas are processed in the order of their position in the index (to
+      touch neighbouring memory one after another) and in parallel.
+    */
+    //@{
+    /// Sums of the intensities of all peaks inside of each area
+    std::vector<double> sumIntensity(const std::vector<Area>& areas) const;
+
+    /// Highest peak inside of each area (invalid PeakIndex for empty areas)
+    std::vector<PeakIndex> findHighestPeak(const std::vector<Area>& areas) const;
+
+    /// All peaks inside of each area (ordered by spectrum and m/z)
+    std::vector<std::vector<PeakIndex> > extract(const std::vector<Area>& areas) const;
+    //@}
+
+protected:
+    /// Calls @p visitor.cell(c) for all cells inside of @p area and @p visitor.peak(p) for all peaks inside of @p area that lie in a border cell
+    template <typename VisitorType>
+    void visit_(const Area& area, VisitorType& visitor) const;
+
+    /// Returns the m/z bin of @p mz (not clamped to the valid bins)
+    SignedSize mzBin_(CoordinateType mz) const;
+
+    /// Returns the order in which @p areas are processed by the batched queries
+    std::vector<Size> batchOrder_(const std::vector<Area>& areas) const;
+
+    /// Returns the PeakIndex of the peak at position @p p of the peak store
+    PeakIndex peakIndex_(Size p) const;
+
+    /// A peak of an RT block with its m/z bin (used while building the index)
+    struct BinnedPeak_
+    {
+      Size bin;
+      /// Position of the spectrum in spectrum_rt_/spectrum_index_
+      UInt spectrum;
+      /// Index of the peak in its spectrum
+      UInt peak;
+    };
+
+    /// Replaces the content of @p peaks with the peaks of RT block @p block, sorted by m/z bin
+    void binBlock_(const MSExperiment& exp, Size block, std::vector<BinnedPeak_>& peaks) const;
+
+    UInt ms_level_;
+    Size spectra_per_block_;
+    CoordinateType mz_bin_width_;
+    /// Lower boundary of the first m/z bin
+    CoordinateType mz_origin_;
+    Size mz_bins_;
+    Size rt_blocks_;
+
+    /// RT of the indexed spectra
+    std::vector<CoordinateType> spectrum_rt_;
+    /// Index of the indexed spectra in the experiment
+    std::vector<Size> spectrum_index_;
+
+    /// @name Occupied cells (ordered by RT block and m/z bin)
+    //@{
+    /// First cell of each RT block, one additional entry marks the end
+    std::vector<Size> block_cells_;
+    /// m/z bin of each cell
+    std::vector<Size> cell_bin_;
+    /// Start of each cell in the peak store, one additional entry marks the end
+    std::vector<Size> cell_offset_;
+    /// Summed intensity of each cell
+    std::vector<double> cell_sum_;
+    /// Position of the highest peak of each cell in the peak store
+    std::vector<Size> cell_max_;
+    //@}
+
+    /// @name Peak store
+    //@{
+    std::vector<CoordinateType> mz_;
+    std::vector<float> intensity_;
+    /// Position of the spectrum of each peak in spectrum_rt_/spectrum_index_
+    std::vector<UInt> spectrum_pos_;
+    /// Index of each peak in its spectrum
+    std::vector<UInt> peak_pos_;
+    //@}
+  };
+
+} // namespace OpenMS
+
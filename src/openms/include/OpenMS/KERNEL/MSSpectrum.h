@@ -480,6 +480,32 @@ public:
     */
     MSSpectrum& select(const std::vector<Size>& indices);
 
+    /**
+      @brief Returns the index of the float data array holding the ion mobility of each peak (-1 if there is none)
+
+      Recognized are arrays named "Ion Mobility..." (as written by FileConverter), "ion mobility array",
+      "mean inverse reduced ion mobility array" and "ion mobility drift time" with one value per peak.
+    */
+    Int getIonMobilityArrayIndex() const;
+
+    /**
+      @brief Bulk export of the peaks into caller-provided contiguous arrays (e.g. numpy arrays)
+
+      Writes the peaks with m/z in [@p min_mz, @p max_mz) in a single pass. Columns passed as
+      null pointer are skipped, all others must provide space for the number of exported peaks
+      (at most size()).
+
+      The ion mobility of a peak is taken from the float data array given by getIonMobilityArrayIndex()
+      or, if there is none, is the drift time of the spectrum.
+
+      @note The spectrum must be sorted by m/z if an m/z range is given.
+
+      @return The number of exported peaks
+    */
+    Size exportPeaks(double* mz, float* intensity, double* ion_mobility = nullptr,
+                     CoordinateType min_mz = -std::numeric_limits<CoordinateType>::max(),
+                     CoordinateType max_mz = std::numeric_limits<CoordinateType>::max()) const;
+
 
     /**
       @brief Determine if spectrum is profile or centroided using up to three layers of information.
@@ -84,7 +84,9 @@ public:
       @brief Open a specific file on disk.
 
       This tries to read the indexed mzML by parsing the index and then reading
-      the meta information into memory.
+      the meta information into memory. If the index cannot be parsed, the
+      meta information is not read (the file is not parsed a second time) and
+      the meta data is empty.
 
       @return Whether the parsing of the file was successful (if false, the
       file most likely was not an indexed mzML file)
@@ -95,7 +97,14 @@ public:
       indexed_mzml_file_.openFile(filename);
       if (filename != "" && !skipMetaData)
       {
-        loadMetaData_(filename);
+        if (indexed_mzml_file_.getParsingSuccess())
+        {
+          loadMetaData_(filename);
+        }
+        else
+        {
+          meta_ms_experiment_ = boost::shared_ptr<PeakMap>(new PeakMap);
+        }
       }
       return indexed_mzml_file_.getParsingSuccess();
     }
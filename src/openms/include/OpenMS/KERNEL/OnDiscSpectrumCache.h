@@ -0,0 +1,244 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/KERNEL/OnDiscMSExperiment.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief LRU cache of spectra read on demand from an indexed mzML file, with background prefetching
+
+    Wraps an OnDiscMSExperiment (which must have been opened including its
+    meta data) so that visualization code can work on arbitrarily large files
+    without ever holding the full peak map in memory:
+
+    - getSpectrum() returns a spectrum, reading it from disk on a cache miss.
+    - getCachedSpectrum() never blocks on IO and returns a null pointer on a miss.
+    - prefetch() queues spectra to be read by a background thread. Each call
+      replaces the spectra still waiting in the queue, so that only the most
+      recently requested region (e.g. the visible area) is loaded.
+
+    Spectra are evicted in least-recently-used order as soon as the total
+    number of cached peaks exceeds the peak budget (see setMaxPeaks()).
+
+    Additionally, a per-spectrum overview of all MS1 spectra (retention time,
+    total ion current, base peak intensity and m/z range) is provided. It is
+    taken from the meta data (cvParams MS:1000285, MS:1000505, MS:1000527,
+    MS:1000528 and the scan windows) whenever possible. Missing values are
+    computed by the background thread while it is not busy prefetching,
+    without adding the spectra to the cache.
+
+    The background thread works on its own copy of the OnDiscMSExperiment
+    (i.e. its own file stream), all public methods are thread-safe.
+
+    @ingroup Kernel
+  */
+  class OPENMS_DLLAPI OnDiscSpectrumCache
+  {
+public:
+    /// Shared pointer to an immutable cached spectrum
+    typedef boost::shared_ptr<const MSSpectrum> SpectrumPtr;
+
+    /// Overview information of a single MS1 spectrum
+    struct OverviewPoint
+    {
+      /// index of the spectrum in the experiment
+      Size index;
+      /// retention time
+      double rt;
+      /// total ion current (-1 if not known yet)
+      double tic;
+      /// intensity of the highest peak (-1 if not known yet)
+      double base_peak_intensity;
+      /// lowest m/z (-1 if not known yet)
+      double mz_min;
+      /// highest m/z (-1 if not known yet)
+      double mz_max;
+
+      /// true if all values are known
+      bool isComplete() const
+      {
+        return tic >= 0.0 && base_peak_intensity >= 0.0 && mz_min >= 0.0 && mz_max >= 0.0;
+      }
+    };
+
+    /**
+      @brief Constructor
+
+      @param experiment An opened on-disc experiment including meta data. It is copied, the copy uses its own file stream.
+      @param max_peaks The maximal number of peaks held in memory (at least one spectrum is always kept)
+
+      @exception Exception::MissingInformation is thrown if @p experiment has no meta data
+    */
+    explicit OnDiscSpectrumCache(const OnDiscMSExperiment& experiment, Size max_peaks = 20000000);
+
+    /// Destructor (stops the background thread)
+    ~OnDiscSpectrumCache();
+
+    /// Returns the number of spectra of the underlying experiment
+    Size size() const;
+
+    /// Returns the meta data (spectra without peaks) of the underlying experiment
+    boost::shared_ptr<const PeakMap> getMetaData() const;
+
+    /**
+      @brief Returns spectrum @p index, reading it from disk on a cache miss
+
+      @exception Exception::IndexOverflow is thrown if @p index is not smaller than size()
+    */
+    SpectrumPtr getSpectrum(Size index);
+
+    /// Returns spectrum @p index if it is cached, a null pointer otherwise (does not block on IO)
+    SpectrumPtr getCachedSpectrum(Size index);
+
+    /// Returns if spectrum @p index is cached
+    bool isCached(Size index) const;
+
+    /**
+      @brief Reads the given spectra in the background
+
+      Replaces all spectra still waiting to be read by a previous call. Spectra
+      are read in the given order, indices which are already cached or out of
+      range are skipped.
+    */
+    void prefetch(const std::vector<Size>& indices);
+
+    /// Discards all spectra waiting to be read by prefetch()
+    void cancelPrefetch();
+
+    /// Returns if prefetched spectra are still waiting to be read or being read
+    bool isPrefetching() const;
+
+    /// Returns the peak budget
+    Size getMaxPeaks() const;
+
+    /// Sets the peak budget and evicts spectra if necessary
+    void setMaxPeaks(Size max_peaks);
+
+    /// Returns the number of cached spectra
+    Size getCachedSpectrumCount() const;
+
+    /// Returns the total number of peaks of all cached spectra
+    Size getCachedPeakCount() const;
+
+    /// Removes all spectra from the cache
+    void clear();
+
+    /// Returns the overview of all MS1 spectra (sorted by spectrum index)
+    std::vector<OverviewPoint> getOverview() const;
+
+    /// Returns if all values of the overview are known
+    bool isOverviewComplete() const;
+
+    /**
+      @brief Returns the m/z and intensity range of the overview points known so far
+
+      @return false if no m/z range is known yet
+    */
+    bool getOverviewRanges(double& mz_min, double& mz_max, double& max_intensity) const;
+
+protected:
+    /// Reads spectrum @p index from disk unless the meta data already contains its peaks (thread-safe)
+    SpectrumPtr load_(Size index);
+
+    /// Inserts a spectrum as most recently used and evicts old ones (cache_mutex_ must be held)
+    void insert_(Size index, const SpectrumPtr& spectrum);
+
+    /// Evicts least recently used spectra until the budget is met (cache_mutex_ must be held)
+    void evict_();
+
+    /// Main loop of the background thread
+    void run_();
+
+    /// Entry of the cache
+    struct Entry
+    {
+      SpectrumPtr spectrum;
+      std::list<Size>::iterator lru_position;
+    };
+
+    /// On-disc experiment (guarded by io_mutex_)
+    OnDiscMSExperiment experiment_;
+    /// Meta data of the experiment
+    boost::shared_ptr<const PeakMap> meta_data_;
+    /// Serializes disc access
+    std::mutex io_mutex_;
+
+    /// Cached spectra
+    std::unordered_map<Size, Entry> cache_;
+    /// Spectrum indices in order of use (most recently used first)
+    std::list<Size> lru_;
+    /// Number of peaks in the cache
+    Size cached_peaks_;
+    /// Peak budget
+    Size max_peaks_;
+    /// Guards cache_, lru_, cached_peaks_ and max_peaks_
+    mutable std::mutex cache_mutex_;
+
+    /// Spectra waiting to be prefetched
+    std::deque<Size> queue_;
+    /// True while the background thread reads a prefetched spectrum
+    bool prefetch_busy_;
+    /// Overview of the MS1 spectra
+    std::vector<OverviewPoint> overview_;
+    /// Positions in overview_ of incomplete overview points not processed yet
+    std::deque<Size> overview_pending_;
+    /// Guards queue_, prefetch_busy_, overview_, overview_pending_ and stop_
+    mutable std::mutex queue_mutex_;
+    /// Wakes the background thread
+    std::condition_variable queue_cv_;
+    /// Tells the background thread to terminate
+    bool stop_;
+    /// The background thread
+    std::thread worker_;
+
+private:
+    /// Not implemented
+    OnDiscSpectrumCache(const OnDiscSpectrumCache&);
+    /// Not implemented
+    OnDiscSpectrumCache& operator=(const OnDiscSpectrumCache&);
+  };
+
+} // namespace OpenMS
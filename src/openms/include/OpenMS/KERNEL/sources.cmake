@@ -21,8 +21,10 @@ MRMFeature.h
 MRMTransitionGroup.h
 MSChromatogram.h
 MSExperiment.h
+MSExperimentAreaIndex.h
 MSSpectrum.h
 OnDiscMSExperiment.h
+OnDiscSpectrumCache.h
 Peak1D.h
 Peak2D.h
 PeakIndex.h
@@ -0,0 +1,340 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/CHEMISTRY/InternedAASequence.h>
+#include <OpenMS/DATASTRUCTURES/DataValue.h>
+#include <OpenMS/METADATA/PeptideIdentification.h>
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Compact, column-oriented container for large sets of peptide identifications (PSMs)
+
+    Holds the same information as a @p std::vector<PeptideIdentification>, but stores it in columns instead of one object per hit:
+    @li every distinct peptide sequence is stored only once (hits refer to it by index),
+    @li protein accessions, identifiers, score types and string meta values are interned in a string table,
+    @li scores, ranks and charges are plain numeric columns,
+    @li meta values are stored as dense columns, keyed by their MetaInfoRegistry index. Columns which only contain
+        values of one simple type (string, integer or double without unit) are stored typed; all other columns fall back to DataValue.
+
+    This reduces the memory footprint considerably for millions of hits, since the per-hit overhead of
+    MetaInfoInterface, AASequence and PeptideEvidence vanishes.
+
+    Identifications are addressed by their index (0 to size() - 1), hits by their global index (0 to getNumberOfHits() - 1).
+    The hits of identification @p i are stored contiguously in the range [getHitBegin(i), getHitEnd(i)).
+
+    Use the constructor (or assign() / push_back()) and toPeptideIdentifications() to convert between both representations.
+    IDFilter, FalseDiscoveryRate and IdXMLFile provide overloads which work on this container directly.
+
+    @ingroup Metadata
+  */
+  class OPENMS_DLLAPI ColumnarPSMStore
+  {
+public:
+    /// Index into the internal string table
+    typedef UInt StringRef;
+
+    /// @name Constructors and assignment
+    //@{
+    /// Default constructor
+    ColumnarPSMStore();
+
+    /// Conversion constructor
+    explicit ColumnarPSMStore(const std::vector<PeptideIdentification>& peptide_ids);
+
+    /// Copy constructor
+    ColumnarPSMStore(const ColumnarPSMStore&) = default;
+
+    /// Move constructor
+    ColumnarPSMStore(ColumnarPSMStore&&) = default;
+
+    /// Destructor
+    ~ColumnarPSMStore() = default;
+
+    /// Assignment operator
+    ColumnarPSMStore& operator=(const ColumnarPSMStore&) = default;
+
+    /// Move assignment operator
+    ColumnarPSMStore& operator=(ColumnarPSMStore&&) = default;
+    //@}
+
+    /// @name Conversion from/to PeptideIdentification
+    //@{
+    /// Replaces the content by @p peptide_ids
+    void assign(const std::vector<PeptideIdentification>& peptide_ids);
+
+    /// Appends a peptide identification (and its hits)
+    void push_back(const PeptideIdentification& peptide_id);
+
+    /// Converts all identifications back to PeptideIdentification objects (@p peptide_ids is cleared first)
+    void toPeptideIdentifications(std::vector<PeptideIdentification>& peptide_ids) const;
+
+    /// Reconstructs the identification at index @p id_index (including its hits)
+    PeptideIdentification getPeptideIdentification(Size id_index) const;
+
+    /// Reconstructs the hit at (global) index @p hit_index
+    PeptideHit getPeptideHit(Size hit_index) const;
+    //@}
+
+    /// @name Size
+    //@{
+    /// Returns the number of identifications (spectra)
+    Size size() const;
+
+    /// Returns the total number of hits (PSMs)
+    Size getNumberOfHits() const;
+
+    /// Returns the number of distinct peptide sequences
+    Size getNumberOfSequences() const;
+
+    /// Returns true if no identifications are stored
+    bool empty() const;
+
+    /// Removes all identifications, hits and interned strings/sequences
+    void clear();
+    //@}
+
+    /// @name Access to identifications
+    //@{
+    /// Index of the first hit of identification @p id_index
+    Size getHitBegin(Size id_index) const;
+
+    /// Index past the last hit of identification @p id_index
+    Size getHitEnd(Size id_index) const;
+
+    /// Returns the identification a hit belongs to (binary search)
+    Size getIdentificationIndex(Size hit_index) const;
+
+    double getRT(Size id_index) const;
+    void setRT(Size id_index, double rt);
+
+    double getMZ(Size id_index) const;
+    void setMZ(Size id_index, double mz);
+
+    const String& getIdentifier(Size id_index) const;
+    void setIdentifier(Size id_index, const String& identifier);
+
+    const String& getScoreType(Size id_index) const;
+    void setScoreType(Size id_index, const String& score_type);
+
+    bool isHigherScoreBetter(Size id_index) const;
+    void setHigherScoreBetter(Size id_index, bool higher_score_better);
+
+    double getSignificanceThreshold(Size id_index) const;
+    void setSignificanceThreshold(Size id_index, double threshold);
+
+    const String& getBaseName(Size id_index) const;
+    void setBaseName(Size id_index, const String& base_name);
+    //@}
+
+    /// @name Access to hits
+    //@{
+    /// Returns the (interned) sequence of a hit
+    const AASequence& getSequence(Size hit_index) const;
+
+    /// Returns the shared handle of the sequence of a hit (see InternedAASequence)
+    const InternedAASequence& getInternedSequence(Size hit_index) const;
+
+    double getScore(Size hit_index) const;
+    void setScore(Size hit_index, double score);
+
+    UInt getRank(Size hit_index) const;
+    void setRank(Size hit_index, UInt rank);
+
+    Int getCharge(Size hit_index) const;
+    void setCharge(Size hit_index, Int charge);
+
+    /// Returns the peptide evidences of a hit (reconstructed from the evidence columns)
+    std::vector<PeptideEvidence> getPeptideEvidences(Size hit_index) const;
+    //@}
+
+    /// @name Meta values
+    ///
+    /// Keys are MetaInfoRegistry indices (see MetaInfoInterface::metaRegistry()); overloads taking names are provided for convenience.
+    /// Getters return DataValue::EMPTY if the value is not set.
+    //@{
+    bool hitMetaValueExists(Size hit_index, UInt key) const;
+    bool hitMetaValueExists(Size hit_index, const String& name) const;
+    DataValue getHitMetaValue(Size hit_index, UInt key) const;
+    DataValue getHitMetaValue(Size hit_index, const String& name) const;
+    void setHitMetaValue(Size hit_index, UInt key, const DataValue& value);
+    void setHitMetaValue(Size hit_index, const String& name, const DataValue& value);
+    void removeHitMetaValue(Size hit_index, UInt key);
+
+    bool identificationMetaValueExists(Size id_index, UInt key) const;
+    DataValue getIdentificationMetaValue(Size id_index, UInt key) const;
+    DataValue getIdentificationMetaValue(Size id_index, const String& name) const;
+    void setIdentificationMetaValue(Size id_index, UInt key, const DataValue& value);
+    void setIdentificationMetaValue(Size id_index, const String& name, const DataValue& value);
+
+    /// Returns the keys of all hit meta value columns
+    std::vector<UInt> getHitMetaKeys() const;
+    //@}
+
+    /// @name Bulk operations on hits
+    //@{
+    /**
+      @brief Keeps only hits for which @p keep is true (indexed by global hit index)
+
+      Identifications are kept even if all their hits are removed (see removeEmptyIdentifications()).
+
+      @exception Exception::InvalidSize is thrown if @p keep does not have one entry per hit
+    */
+    void filterHits(const std::vector<bool>& keep);
+
+    /// Sorts the hits of each identification by score (best first, taking the score orientation into account; stable)
+    void sortHits();
+
+    /// Sorts the hits of each identification and assigns ranks (starting at 1; equal scores share a rank), like PeptideIdentification::assignRanks()
+    void assignRanks();
+
+    /// Removes identifications without hits
+    void removeEmptyIdentifications();
+    //@}
+
+protected:
+    /**
+      @brief A single dense meta value column
+
+      The storage type is determined by the first value. If a value of another type (or with a unit) is stored later,
+      the column is converted to generic DataValue storage.
+    */
+    class MetaColumn_
+    {
+public:
+      MetaColumn_();
+
+      /// Resizes the column; new rows are unset
+      void resize(Size n);
+
+      bool exists(Size row) const;
+
+      DataValue get(Size row, const std::vector<String>& strings) const;
+
+      /// Sets a value; an empty DataValue removes the entry
+      void set(Size row, const DataValue& value, ColumnarPSMStore& store);
+
+      /// Builds a new column from the rows @p new_to_old of this column
+      void gather(const std::vector<Size>& new_to_old);
+
+      /// true if at least one row is set
+      bool hasValues() const;
+
+private:
+      /// converts typed storage to generic DataValue storage
+      void toGeneric_(const std::vector<String>& strings);
+
+      DataValue::DataType type_; ///< EMPTY_VALUE until the first value was set
+      bool generic_; ///< values are stored in values_
+      std::vector<bool> present_;
+      std::vector<double> doubles_;
+      std::vector<SignedSize> ints_;
+      std::vector<StringRef> strings_;
+      std::vector<DataValue> values_;
+    };
+
+    /// Returns the index of @p s in the string table (adds it if necessary)
+    StringRef internString_(const String& s);
+
+    /// Returns the index of @p seq in the sequence table (adds it if necessary)
+    UInt internSequence_(const InternedAASequence& seq);
+
+    /// Rebuilds all hit columns from the hits @p new_to_old; @p new_hit_begin contains the new hit ranges of all identifications (size() + 1 entries)
+    void gatherHits_(const std::vector<Size>& new_to_old, std::vector<Size>& new_hit_begin);
+
+    /// Returns the stable order of the hits of identification @p id_index, best hit first
+    void sortedHitOrder_(Size id_index, std::vector<Size>& order) const;
+
+    /// Returns the registry index of @p name, or UInt(-1) if the name is unknown
+    static UInt metaIndex_(const String& name);
+
+    /// Hash of a sequence, based on the residue and terminal modification pointers
+    static std::size_t sequenceHash_(const AASequence& seq);
+
+    /**
+      @name String and sequence tables
+
+      Strings and sequences are stored only once, in the tables. The lookup indices map a hash value to the
+      table positions with that hash; lookups compare the candidates against the table entries.
+    */
+    //@{
+    std::vector<String> strings_;
+    std::unordered_multimap<std::size_t, StringRef> string_index_;
+    std::vector<InternedAASequence> sequences_;
+    std::unordered_multimap<std::size_t, UInt> sequence_index_;
+    //@}
+
+    /// @name Identification columns
+    //@{
+    std::vector<Size> hit_begin_; ///< size() + 1 entries; hits of identification i are [hit_begin_[i], hit_begin_[i + 1])
+    std::vector<double> rt_;
+    std::vector<double> mz_;
+    std::vector<StringRef> identifier_;
+    std::vector<StringRef> score_type_;
+    std::vector<bool> higher_score_better_;
+    std::vector<double> significance_threshold_;
+    std::vector<StringRef> base_name_;
+    std::map<UInt, MetaColumn_> id_meta_;
+    //@}
+
+    /// @name Hit columns
+    //@{
+    std::vector<UInt> sequence_;
+    std::vector<double> score_;
+    std::vector<UInt> rank_;
+    std::vector<Int> charge_;
+    std::vector<Size> evidence_begin_; ///< getNumberOfHits() + 1 entries
+    std::map<UInt, MetaColumn_> hit_meta_;
+    std::map<Size, std::vector<PeptideHit::PepXMLAnalysisResult> > analysis_results_; ///< sparse, keyed by hit index
+    std::map<Size, std::vector<PeptideHit::PeakAnnotation> > peak_annotations_; ///< sparse, keyed by hit index
+    //@}
+
+    /// @name Peptide evidence columns
+    //@{
+    std::vector<StringRef> evidence_accession_;
+    std::vector<Int> evidence_start_;
+    std::vector<Int> evidence_end_;
+    std::vector<char> evidence_aa_before_;
+    std::vector<char> evidence_aa_after_;
+    //@}
+  };
+
+} // namespace OpenMS
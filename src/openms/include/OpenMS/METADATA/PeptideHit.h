@@ -40,6 +40,7 @@
 #include <OpenMS/DATASTRUCTURES/String.h>
 #include <OpenMS/METADATA/MetaInfoInterface.h>
 #include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/CHEMISTRY/InternedAASequence.h>
 #include <OpenMS/METADATA/PeptideEvidence.h>
 
 namespace OpenMS
@@ -239,6 +240,11 @@ public:
                UInt rank,
                Int charge,
                AASequence&& sequence);
+    /// Values constructor that shares an interned sequence
+    PeptideHit(double score,
+               UInt rank,
+               Int charge,
+               const InternedAASequence& sequence);
     /// Copy constructor
     PeptideHit(const PeptideHit& source);
     /// Move constructor
@@ -270,6 +276,17 @@ public:
     /// sets the peptide sequence
     void setSequence(AASequence&& sequence);
 
+    /**
+      @brief returns the peptide sequence as shared handle
+
+      Use this to access cached masses (see InternedAASequence) or to let
+      other hits share the same sequence object.
+    */
+    const InternedAASequence& getInternedSequence() const;
+
+    /// sets the peptide sequence (sharing the sequence object, e.g. one obtained from AASequencePool)
+    void setSequence(const InternedAASequence& sequence);
+
     /// returns the charge of the peptide
     Int getCharge() const;
 
@@ -320,7 +337,8 @@ public:
     std::set<String> extractProteinAccessionsSet() const;
 
 protected:
-    AASequence sequence_;
+    /// the (immutable, possibly shared) peptide sequence
+    InternedAASequence sequence_;
 
     /// the score of the peptide hit
     double score_;
@@ -10,6 +10,7 @@ CVTerm.h
 CVTermList.h
 CVTermListInterface.h
 ChromatogramSettings.h
+ColumnarPSMStore.h
 ContactPerson.h
 DataArrays.h
 DataProcessing.h
@@ -0,0 +1,202 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <atomic>
+#include <chrono>
+#include <iosfwd>
+#include <mutex>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Lightweight, process-wide tracing of nested processing stages
+
+    The profiler records named spans (wall time, CPU time, change of the resident and peak
+    resident memory, number of processed items, thread and nesting depth) and writes them either
+    as Chrome trace-event JSON (viewable in chrome://tracing or https://ui.perfetto.dev) or as a
+    flat tab-separated table.
+
+    Profiling is disabled by default. While disabled, opening a span costs a single relaxed
+    atomic load and does not allocate. TOPP tools enable it via the @p -profile command line
+    option; library code marks interesting stages with @ref OPENMS_PROFILE_SCOPE or a
+    Profiler::Scope object. ProgressLogger::startProgress() / endProgress() open and close a
+    span automatically, so every stage that reports progress also shows up in the trace.
+
+    @code
+    void MyAlgorithm::run(const PeakMap& exp)
+    {
+      OPENMS_PROFILE_SCOPE("MyAlgorithm::run");
+      ...
+    }
+    @endcode
+
+    All methods are thread-safe. Spans may be opened from within OpenMP regions; each thread
+    keeps its own nesting depth.
+
+    @ingroup System
+  */
+  class OPENMS_DLLAPI Profiler
+  {
+public:
+    /// A single recorded (closed) stage
+    struct OPENMS_DLLAPI Span
+    {
+      String name; ///< name of the stage
+      String category; ///< category of the stage (e.g. "tool", "progress", "algorithm")
+      Size thread = 0; ///< small, process-unique id of the recording thread (0 = first thread seen)
+      Size depth = 0; ///< nesting depth within its thread (0 = outermost)
+      double start = 0.0; ///< start time (in seconds) relative to the last @ref clear() / @ref enable()
+      double wall_time = 0.0; ///< wall clock time (in seconds)
+      double cpu_time = 0.0; ///< CPU time (in seconds) of the thread that opened the span, spent while the span was open (0 if it was closed on another thread)
+      Int64 rss_delta = 0; ///< change in resident memory (in KB)
+      Int64 peak_rss_delta = 0; ///< change in peak resident memory (in KB); 0 if not supported by the OS
+      Int64 items = -1; ///< number of processed items; -1 if unknown
+    };
+
+    /// Handle to a span which is still open; returned by @ref beginSpan()
+    typedef Size SpanId;
+
+    /// Returned by @ref beginSpan() if the profiler is disabled. Ending it is a no-op.
+    static const SpanId INVALID_SPAN;
+
+    /**
+      @brief RAII helper which records a span for its lifetime
+
+      Does nothing (and allocates nothing) if the profiler is disabled on construction.
+    */
+    class OPENMS_DLLAPI Scope
+    {
+public:
+      /// Opens a span with the given @p name and @p category (@p name and @p category must outlive the Scope if passed as literals)
+      explicit Scope(const char* name, const char* category = "algorithm");
+      /// Closes the span
+      ~Scope();
+
+      /// Sets the number of items processed in this span (reported on close)
+      void setItems(Int64 items);
+
+      Scope(const Scope&) = delete;
+      Scope& operator=(const Scope&) = delete;
+
+private:
+      SpanId id_;
+      Int64 items_;
+    };
+
+    /// Returns true if spans are currently being recorded
+    static bool isEnabled()
+    {
+      return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /// Starts recording; also resets the time origin if nothing was recorded yet
+    static void enable();
+
+    /// Stops recording (spans which are open are still closed and recorded)
+    static void disable();
+
+    /// Discards all recorded and open spans and resets the time origin
+    static void clear();
+
+    /**
+      @brief Opens a new span on the calling thread
+
+      @return A handle to pass to @ref endSpan(), or @ref INVALID_SPAN if profiling is disabled
+    */
+    static SpanId beginSpan(const String& name, const String& category = "algorithm");
+
+    /**
+      @brief Closes a span opened by @ref beginSpan()
+
+      @param id The handle returned by @ref beginSpan(); invalid or already closed handles are ignored
+      @param items Number of items processed in the span (-1 = unknown)
+    */
+    static void endSpan(SpanId id, Int64 items = -1);
+
+    /// Returns a copy of all closed spans, ordered by the time they were closed
+    static std::vector<Span> getSpans();
+
+    /// Writes all closed spans as Chrome trace-event JSON ("X" complete events with timing in microseconds)
+    static void writeChromeTrace(std::ostream& os);
+
+    /// Writes all closed spans as a tab-separated table with a header line
+    static void writeTSV(std::ostream& os);
+
+    /**
+      @brief Writes all closed spans to @p filename
+
+      The format is chosen by extension: '.tsv' or '.txt' produce a flat table, everything else
+      Chrome trace-event JSON.
+
+      @exception Exception::UnableToCreateFile if the file cannot be written
+    */
+    static void write(const String& filename);
+
+private:
+    /// A span which has been opened but not closed yet
+    struct OpenSpan_
+    {
+      Span span;
+      std::chrono::steady_clock::time_point wall_start;
+      double cpu_start = 0.0;
+      size_t rss_start = 0;
+      size_t peak_rss_start = 0;
+      bool used = false;
+    };
+
+    /// CPU time of the calling thread in seconds (process CPU time on platforms without a per-thread clock)
+    static double cpuTime_();
+
+    static std::atomic<bool> enabled_;
+    static std::mutex mutex_;
+    static std::chrono::steady_clock::time_point origin_;
+    static std::vector<OpenSpan_> open_;
+    static std::vector<SpanId> free_;
+    static std::vector<Span> spans_;
+    static Size thread_count_;
+  };
+
+} // namespace OpenMS
+
+/// Records a Profiler span (category "algorithm") until the end of the enclosing scope; @p name must be a string literal
+#define OPENMS_PROFILE_SCOPE(name) \
+  OpenMS::Profiler::Scope OPENMS_PROFILE_CONCAT_(openms_profile_scope_, __LINE__)(name)
+
+#define OPENMS_PROFILE_CONCAT_(a, b) OPENMS_PROFILE_CONCAT2_(a, b)
+#define OPENMS_PROFILE_CONCAT2_(a, b) a##b
@@ -58,8 +58,8 @@ namespace OpenMS
 			static bool getProcessMemoryConsumption(size_t& mem_virtual);
   
       /// Get peak memory consumption in KiloBytes (KB)
-      /// On Windows, this is equivalent to 'Working Set (Memory)' in Task Manager.
-      /// On other OS this might be very unreliable, depending on operating system and kernel version.
+      /// On Windows, this is equivalent to 'Peak Working Set (Memory)' in Task Manager.
+      /// On Linux and macOS, this is the maximum resident set size as reported by getrusage().
       ///
       /// @param mem_virtual Total virtual memory allocated by this process
       /// @return True on success, false otherwise. If false is returned, then @p mem_virtual is set to 0.
@@ -69,7 +69,7 @@ namespace OpenMS
         @brief A convenience class to report either absolute or delta (between two timepoints) RAM usage
 
         Working RAM and Peak RAM usage are recorded at two time points ('before' and 'after').
-        @note Peak RAM is only supported on WindowsOS; other OS will only report Working RAM usage
+        @note Peak RAM is reported if supported by the OS (see @ref getProcessPeakMemoryConsumption()); otherwise only Working RAM usage is reported
         
         When constructed, MemUsage automatically queries the present RAM usage (first timepoint), i.e. calls @ref before().
         Data for the second timepoint can be recorded using @ref after().
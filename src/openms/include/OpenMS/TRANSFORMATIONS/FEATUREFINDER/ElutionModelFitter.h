@@ -67,6 +67,9 @@ namespace OpenMS
        - each subordinate has one convex hull
        - all convex hulls in one feature contain the same number (> 0) of points
        - the y coordinates of the hull points store the intensities
+
+       Features are fitted in parallel (if OpenMP is available); the results do
+       not depend on the number of threads.
     */
     void fitElutionModels(FeatureMap& features);
 
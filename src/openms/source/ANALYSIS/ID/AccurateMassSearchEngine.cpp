@@ -37,6 +37,7 @@
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopeDistribution.h>
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
 #include <OpenMS/CONCEPT/Constants.h>
+#include <OpenMS/CONCEPT/ParallelExceptionCollector.h>
 #include <OpenMS/FORMAT/TextFile.h>
 #include <OpenMS/MATH/MISC/MathFunctions.h>
 #include <OpenMS/METADATA/ProteinIdentification.h>
@@ -99,7 +100,7 @@ namespace OpenMS
 
   /// checks if an adduct (e.g.a 'M+2K-H;1+') is valid, i.e. if the losses (==negative amounts) can actually be lost by the compound given in @p db_entry.
   /// If the negative parts are present in @p db_entry, true is returned.
-  bool AdductInfo::isCompatible(EmpiricalFormula db_entry) const
+  bool AdductInfo::isCompatible(const EmpiricalFormula& db_entry) const
   {
     return db_entry.contains(ef_ * -1);
   }
@@ -566,15 +567,18 @@ namespace OpenMS
 
     // Depending on ion_mode_internal_, either positive or negative adducts are used
     std::vector<AdductInfo>::const_iterator it_s, it_e;
+    const AdductCompatibilityTable* compatible = nullptr;
     if (ion_mode == "positive")
     {
       it_s = pos_adducts_.begin();
       it_e = pos_adducts_.end();
+      compatible = &pos_adducts_compatible_;
     }
     else if (ion_mode == "negative")
     {
       it_s = neg_adducts_.begin();
       it_e = neg_adducts_.end();
+      compatible = &neg_adducts_compatible_;
     }
     else
     {
@@ -623,15 +627,20 @@ namespace OpenMS
 
       searchMass_(neutral_mass, diff_mass, hit_idx);
 
+      const std::vector<bool>& adduct_compatible = (*compatible)[it - it_s];
+
       //std::cerr << ion_mode_internal_ << " adduct: " << adduct_name << ", " << adduct_mass << " Da, " << query_mass << " qm(against DB), " << charge << " q\n";
 
       // store information from query hits in AccurateMassSearchResult objects
       for (Size i = hit_idx.first; i < hit_idx.second; ++i)
       {
-        // check if DB entry is compatible to the adduct
-        if (!it->isCompatible(EmpiricalFormula(mass_mappings_[i].formula)))
+        // check if DB entry is compatible to the adduct (precomputed in init())
+        if (!adduct_compatible[i])
         {
           // only written if TOPP tool has --debug
+#ifdef _OPENMP
+#pragma omp critical (LOG_DEBUG_access)
+#endif
           OPENMS_LOG_DEBUG << "'" << mass_mappings_[i].formula << "' cannot have adduct '" << it->getName() << "'. Omitting.\n";
           continue;
         }
@@ -771,6 +780,9 @@ namespace OpenMS
     parseAdductsFile_(pos_adducts_fname_, pos_adducts_);
     parseAdductsFile_(neg_adducts_fname_, neg_adducts_);
 
+    computeAdductCompatibility_(pos_adducts_, pos_adducts_compatible_);
+    computeAdductCompatibility_(neg_adducts_, neg_adducts_compatible_);
+
     is_initialized_ = true;
   }
 
@@ -787,48 +799,67 @@ namespace OpenMS
       ion_mode_internal = resolveAutoMode_(fmap);
     }
 
-    // map for storing overall results
-    QueryResultsTable overall_results;
+    // results for each feature; filled in parallel, but each slot is written by exactly one thread,
+    // so the final order is identical to a serial run
+    QueryResultsTable feature_results(fmap.size());
     Size dummy_count(0);
-    for (Size i = 0; i < fmap.size(); ++i)
+    // the first exception (by feature index) thrown inside the parallel region; rethrown afterwards
+    ParallelExceptionCollector errors;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100) reduction(+: dummy_count)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)fmap.size(); ++i)
     {
-      std::vector<AccurateMassSearchResult> query_results;
+      try
+      {
+        std::vector<AccurateMassSearchResult>& query_results = feature_results[i];
 
-      // std::cout << i << ": " << fmap[i].getMetaValue(3) << " mass: " << fmap[i].getMZ() << " num_traces: " << fmap[i].getMetaValue("num_of_masstraces") << " charge: " << fmap[i].getCharge() << std::endl;
-      queryByFeature(fmap[i], i, ion_mode_internal, query_results);
+        // std::cout << i << ": " << fmap[i].getMetaValue(3) << " mass: " << fmap[i].getMZ() << " num_traces: " << fmap[i].getMetaValue("num_of_masstraces") << " charge: " << fmap[i].getCharge() << std::endl;
+        queryByFeature(fmap[i], i, ion_mode_internal, query_results);
 
-      if (query_results.size() == 0) continue; // cannot happen if a 'not-found' dummy was added
+        if (query_results.size() == 0) continue; // cannot happen if a 'not-found' dummy was added
 
-      bool is_dummy = (query_results[0].getMatchingIndex() == (Size)-1);
-      if (is_dummy) ++dummy_count;
+        bool is_dummy = (query_results[0].getMatchingIndex() == (Size)-1);
+        if (is_dummy) ++dummy_count;
 
-      if (iso_similarity_ && !is_dummy)
-      {
-        if (!fmap[i].metaValueExists("num_of_masstraces"))
+        if (iso_similarity_ && !is_dummy)
         {
-          OPENMS_LOG_WARN << "Feature does not contain meta value 'num_of_masstraces'. Cannot compute isotope similarity.";
-        }
-        else if ((Size)fmap[i].getMetaValue("num_of_masstraces") > 1)
-        { // compute isotope pattern similarities (do not take the best-scoring one, since it might have really bad ppm or other properties --
-          // it is impossible to decide here which one is best
-          for (Size hit_idx = 0; hit_idx < query_results.size(); ++hit_idx)
+          if (!fmap[i].metaValueExists("num_of_masstraces"))
           {
-            String emp_formula(query_results[hit_idx].getFormulaString());
-            double iso_sim(computeIsotopePatternSimilarity_(fmap[i], EmpiricalFormula(emp_formula)));
-            query_results[hit_idx].setIsotopesSimScore(iso_sim);
+#ifdef _OPENMP
+#pragma omp critical (LOG_WARN_access)
+#endif
+            OPENMS_LOG_WARN << "Feature does not contain meta value 'num_of_masstraces'. Cannot compute isotope similarity.";
+          }
+          else if ((Size)fmap[i].getMetaValue("num_of_masstraces") > 1)
+          { // compute isotope pattern similarities (do not take the best-scoring one, since it might have really bad ppm or other properties --
+            // it is impossible to decide here which one is best
+            for (Size hit_idx = 0; hit_idx < query_results.size(); ++hit_idx)
+            {
+              String emp_formula(query_results[hit_idx].getFormulaString());
+              double iso_sim(computeIsotopePatternSimilarity_(fmap[i], EmpiricalFormula(emp_formula)));
+              query_results[hit_idx].setIsotopesSimScore(iso_sim);
+            }
           }
         }
-      }
 
-      // debug output
-      //        for (Size hit_idx = 0; hit_idx < query_results.size(); ++hit_idx)
-      //        {
-      //            query_results[hit_idx].outputResults();
-      //        }
+        annotate_(query_results, fmap[i]);
+      }
+      catch (...)
+      {
+        errors.capture(i);
+      }
+    }
+    errors.rethrowFirst();
 
-      // String feat_label(fmap[i].getMetaValue(3));
-      overall_results.push_back(query_results);
-      annotate_(query_results, fmap[i]);
+    // map for storing overall results (features without any result are skipped)
+    QueryResultsTable overall_results;
+    overall_results.reserve(feature_results.size());
+    for (Size i = 0; i < feature_results.size(); ++i)
+    {
+      if (feature_results[i].empty()) continue;
+      overall_results.push_back(std::vector<AccurateMassSearchResult>());
+      overall_results.back().swap(feature_results[i]);
     }
     // add dummy protein identification which is required to keep peptidehits alive during store()
     fmap.getProteinIdentifications().resize(fmap.getProteinIdentifications().size() + 1);
@@ -901,17 +932,27 @@ namespace OpenMS
     ConsensusMap::ColumnHeaders fd_map = cmap.getColumnHeaders();
     Size num_of_maps = fd_map.size();
 
-    // map for storing overall results
-    QueryResultsTable overall_results;
-
-    for (Size i = 0; i < cmap.size(); ++i)
+    // map for storing overall results (one slot per consensus feature, filled in parallel)
+    QueryResultsTable overall_results(cmap.size());
+    // the first exception (by consensus feature index) thrown inside the parallel region; rethrown afterwards
+    ParallelExceptionCollector errors;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)cmap.size(); ++i)
     {
-      std::vector<AccurateMassSearchResult> query_results;
-      // std::cout << i << ": " << cmap[i].getMetaValue(3) << " mass: " << cmap[i].getMZ() << " num_traces: " << cmap[i].getMetaValue("num_of_masstraces") << " charge: " << cmap[i].getCharge() << std::endl;
-      queryByConsensusFeature(cmap[i], i, num_of_maps, ion_mode_internal, query_results);
-      annotate_(query_results, cmap[i]);
-      overall_results.push_back(query_results);
+      try
+      {
+        // std::cout << i << ": " << cmap[i].getMetaValue(3) << " mass: " << cmap[i].getMZ() << " num_traces: " << cmap[i].getMetaValue("num_of_masstraces") << " charge: " << cmap[i].getCharge() << std::endl;
+        queryByConsensusFeature(cmap[i], i, num_of_maps, ion_mode_internal, overall_results[i]);
+        annotate_(overall_results[i], cmap[i]);
+      }
+      catch (...)
+      {
+        errors.capture(i);
+      }
     }
+    errors.rethrowFirst();
     // add dummy protein identification which is required to keep peptidehits alive during store()
     cmap.getProteinIdentifications().resize(cmap.getProteinIdentifications().size() + 1);
     cmap.getProteinIdentifications().back().setIdentifier("AccurateMassSearch");
@@ -1483,6 +1524,22 @@ namespace OpenMS
     return;
   }
 
+  void AccurateMassSearchEngine::computeAdductCompatibility_(const std::vector<AdductInfo>& adducts, AdductCompatibilityTable& compatible) const
+  {
+    compatible.assign(adducts.size(), std::vector<bool>(mass_mappings_.size(), false));
+    if (adducts.empty()) return;
+
+    // parse each DB formula only once (instead of once per adduct and query)
+    for (Size i = 0; i < mass_mappings_.size(); ++i)
+    {
+      const EmpiricalFormula db_entry(mass_mappings_[i].formula);
+      for (Size a = 0; a < adducts.size(); ++a)
+      {
+        compatible[a][i] = adducts[a].isCompatible(db_entry);
+      }
+    }
+  }
+
   double AccurateMassSearchEngine::computeCosineSim_( const std::vector<double>& x, const std::vector<double>& y ) const
   {
     if (x.size() != y.size())
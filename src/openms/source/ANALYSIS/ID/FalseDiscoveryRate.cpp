@@ -35,6 +35,7 @@
 #include <OpenMS/ANALYSIS/ID/FalseDiscoveryRate.h>
 #include <OpenMS/ANALYSIS/ID/IDScoreGetterSetter.h>
 #include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/SYSTEM/Profiler.h>
 
 #include <algorithm>
 #include <numeric>
@@ -67,67 +68,106 @@ namespace OpenMS
 
   }
 
-  void FalseDiscoveryRate::apply(vector<PeptideIdentification>& ids) const
+  namespace
+  {
+    /**
+      @brief Hit-level access to peptide identifications, with the interface of ColumnarPSMStore used by FalseDiscoveryRate::applyToHits_()
+
+      Hits are addressed by a global index (in the order of the identifications); the index is updated by filterHits().
+    */
+    class PeptideIdentificationHits
+    {
+public:
+      explicit PeptideIdentificationHits(vector<PeptideIdentification>& ids) :
+        ids_(ids)
+      {
+        updateIndex_();
+      }
+
+      Size size() const { return ids_.size(); }
+      Size getNumberOfHits() const { return hit_pos_.size(); }
+      Size getHitBegin(Size id_index) const { return hit_begin_[id_index]; }
+      Size getHitEnd(Size id_index) const { return hit_begin_[id_index + 1]; }
+      const String& getIdentifier(Size id_index) const { return ids_[id_index].getIdentifier(); }
+      const String& getScoreType(Size id_index) const { return ids_[id_index].getScoreType(); }
+      bool isHigherScoreBetter(Size id_index) const { return ids_[id_index].isHigherScoreBetter(); }
+
+      Int getCharge(Size hit_index) const { return hit_(hit_index).getCharge(); }
+      double getScore(Size hit_index) const { return hit_(hit_index).getScore(); }
+      void setScore(Size hit_index, double score) { hit_(hit_index).setScore(score); }
+      bool hitMetaValueExists(Size hit_index, UInt key) const { return hit_(hit_index).metaValueExists(key); }
+      DataValue getHitMetaValue(Size hit_index, UInt key) const { return hit_(hit_index).getMetaValue(key); }
+      void setHitMetaValue(Size hit_index, UInt key, const DataValue& value) { hit_(hit_index).setMetaValue(key, value); }
+
+      void filterHits(const vector<bool>& keep)
+      {
+        for (Size i = 0; i < ids_.size(); ++i)
+        {
+          vector<PeptideHit>& hits = ids_[i].getHits();
+          Size kept = 0;
+          for (Size h = getHitBegin(i); h < getHitEnd(i); ++h)
+          {
+            if (keep[h]) swap(hits[kept++], hits[h - getHitBegin(i)]);
+          }
+          hits.resize(kept);
+        }
+        updateIndex_();
+      }
+
+private:
+      const PeptideHit& hit_(Size hit_index) const { return ids_[hit_pos_[hit_index].first].getHits()[hit_pos_[hit_index].second]; }
+      PeptideHit& hit_(Size hit_index) { return ids_[hit_pos_[hit_index].first].getHits()[hit_pos_[hit_index].second]; }
+
+      void updateIndex_()
+      {
+        hit_begin_.assign(1, 0);
+        hit_pos_.clear();
+        for (Size i = 0; i < ids_.size(); ++i)
+        {
+          for (Size h = 0; h < ids_[i].getHits().size(); ++h)
+          {
+            hit_pos_.push_back(make_pair(i, h));
+          }
+          hit_begin_.push_back(hit_pos_.size());
+        }
+      }
+
+      vector<PeptideIdentification>& ids_;
+      vector<Size> hit_begin_; ///< size() + 1 entries
+      vector<pair<Size, Size> > hit_pos_; ///< (identification, hit) of each global hit index
+    };
+  }
+
+  template <typename PSMContainer>
+  void FalseDiscoveryRate::applyToHits_(PSMContainer& ids) const
   {
     bool q_value = !param_.getValue("no_qvalues").toBool();
-    bool use_all_hits = param_.getValue("use_all_hits").toBool();
     bool treat_runs_separately = param_.getValue("treat_runs_separately").toBool();
     bool split_charge_variants = param_.getValue("split_charge_variants").toBool();
     bool add_decoy_peptides = param_.getValue("add_decoy_peptides").toBool();
-#ifdef FALSE_DISCOVERY_RATE_DEBUG
-    cerr << "Parameters: no_qvalues=" << !q_value << ", use_all_hits=" << use_all_hits << ", treat_runs_separately=" << treat_runs_separately << ", split_charge_variants=" << split_charge_variants << endl;
-#endif
-
-    if (ids.empty())
-    {
-      OPENMS_LOG_WARN << "No peptide identifications given to FalseDiscoveryRate! No calculation performed.\n";
-      return;
-    }
 
-    bool higher_score_better = ids.begin()->isHigherScoreBetter();
+    bool higher_score_better = ids.isHigherScoreBetter(0);
 
     // first search for all identifiers and charge variants
     set<String> identifiers;
     set<SignedSize> charge_variants;
-    for (auto it = ids.begin(); it != ids.end(); ++it)
+    for (Size i = 0; i < ids.size(); ++i)
     {
-      identifiers.insert(it->getIdentifier());
-      it->sort();
-
-      if (!use_all_hits)
+      identifiers.insert(ids.getIdentifier(i));
+      for (Size h = ids.getHitBegin(i); h < ids.getHitEnd(i); ++h)
       {
-        it->getHits().resize(1);
-      }
-
-      for (auto pit = it->getHits().begin(); pit != it->getHits().end(); ++pit)
-      {
-        charge_variants.insert(pit->getCharge());
+        charge_variants.insert(ids.getCharge(h));
       }
     }
 
 #ifdef FALSE_DISCOVERY_RATE_DEBUG
-    cerr << "#id-runs: " << identifiers.size() << " ";
-    for (auto it = identifiers.begin(); it != identifiers.end(); ++it)
-    {
-      cerr << "," << *it;
-    }
-    cerr << endl;
-
-
-    cerr << "#of charge states: " << charge_variants.size() << " ";
-    for (auto it = charge_variants.begin(); it != charge_variants.end(); ++it)
-    {
-      cerr << "," << *it;
-    }
-    cerr << endl;
+    cerr << "#id-runs: " << identifiers.size() << ", #of charge states: " << charge_variants.size() << endl;
 #endif
 
+    const UInt target_decoy_key = MetaInfoInterface::metaRegistry().registerName("target_decoy");
+
     for (auto zit = charge_variants.begin(); zit != charge_variants.end(); ++zit)
     {
-#ifdef FALSE_DISCOVERY_RATE_DEBUG
-      cerr << "Charge variant=" << *zit << endl;
-#endif
-
       // for all identifiers
       for (auto iit = identifiers.begin(); iit != identifiers.end(); ++iit)
       {
@@ -136,50 +176,41 @@ namespace OpenMS
           continue; //only take the first run
         }
 
-#ifdef FALSE_DISCOVERY_RATE_DEBUG
-        cerr << "Id-run: " << *iit << endl;
-#endif
         // get the scores of all peptide hits
         vector<double> target_scores, decoy_scores;
-        for (auto it = ids.begin(); it != ids.end(); ++it)
+        for (Size i = 0; i < ids.size(); ++i)
         {
           // if runs should be treated separately, the identifiers must be the same
-          if (treat_runs_separately && it->getIdentifier() != *iit)
+          if (treat_runs_separately && ids.getIdentifier(i) != *iit)
           {
             continue;
           }
 
-          for (Size i = 0; i < it->getHits().size(); ++i)
+          for (Size h = ids.getHitBegin(i); h < ids.getHitEnd(i); ++h)
           {
-            if (split_charge_variants && it->getHits()[i].getCharge() != *zit)
+            if (split_charge_variants && ids.getCharge(h) != *zit)
             {
               continue;
             }
 
-            if (!it->getHits()[i].metaValueExists("target_decoy"))
+            if (!ids.hitMetaValueExists(h, target_decoy_key))
             {
-              OPENMS_LOG_FATAL_ERROR << "Meta value 'target_decoy' does not exists, reindex the idXML file with 'PeptideIndexer' first (run-id='" << it->getIdentifier() << ", rank=" << i + 1 << " of " << it->getHits().size() << ")!" << endl;
+              OPENMS_LOG_FATAL_ERROR << "Meta value 'target_decoy' does not exists, reindex the idXML file with 'PeptideIndexer' first (run-id='" << ids.getIdentifier(i) << ", rank=" << h - ids.getHitBegin(i) + 1 << " of " << ids.getHitEnd(i) - ids.getHitBegin(i) << ")!" << endl;
               throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Meta value 'target_decoy' does not exist!");
             }
 
-            String target_decoy(it->getHits()[i].getMetaValue("target_decoy"));
+            String target_decoy = ids.getHitMetaValue(h, target_decoy_key).toString();
             if (target_decoy == "target" || target_decoy == "target+decoy")
             {
-              target_scores.push_back(it->getHits()[i].getScore());
+              target_scores.push_back(ids.getScore(h));
             }
-            else
+            else if (target_decoy == "decoy")
             {
-              if (target_decoy == "decoy")
-              {
-                decoy_scores.push_back(it->getHits()[i].getScore());
-              }
-              else
-              {
-                if (target_decoy != "")
-                {
-                  throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unknown value of meta value 'target_decoy'", target_decoy);
-                }
-              }
+              decoy_scores.push_back(ids.getScore(h));
+            }
+            else if (target_decoy != "")
+            {
+              throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unknown value of meta value 'target_decoy'", target_decoy);
             }
           }
         }
@@ -188,91 +219,66 @@ namespace OpenMS
         cerr << "#target-scores=" << target_scores.size() << ", #decoy-scores=" << decoy_scores.size() << endl;
 #endif
 
-        // check decoy scores
-        if (decoy_scores.empty())
+        String error_context;
+        if (split_charge_variants || treat_runs_separately)
         {
-          String error_string = "FalseDiscoveryRate: #decoy sequences is zero! Setting all target sequences to q-value/FDR 0! ";
-          if (split_charge_variants || treat_runs_separately)
+          error_context += "(";
+          if (split_charge_variants)
           {
-            error_string += "(";
-            if (split_charge_variants)
-            {
-              error_string += "charge_variant=" + String(*zit) + " ";
-            }
-            if (treat_runs_separately)
-            {
-              error_string += "run-id=" + *iit;
-            }
-            error_string += ")";
+            error_context += "charge_variant=" + String(*zit) + " ";
+          }
+          if (treat_runs_separately)
+          {
+            error_context += "run-id=" + *iit;
           }
-          OPENMS_LOG_ERROR << error_string << std::endl;
+          error_context += ")";
+        }
+        if (decoy_scores.empty())
+        {
+          OPENMS_LOG_ERROR << "FalseDiscoveryRate: #decoy sequences is zero! Setting all target sequences to q-value/FDR 0! " << error_context << std::endl;
         }
-
-        // check target scores
         if (target_scores.empty())
         {
-          String error_string = "FalseDiscoveryRate: #target sequences is zero! Ignoring. ";
-          if (split_charge_variants || treat_runs_separately)
-          {
-            error_string += "(";
-            if (split_charge_variants)
-            {
-              error_string += "charge_variant=" + String(*zit) + " ";
-            }
-            if (treat_runs_separately)
-            {
-              error_string += "run-id=" + *iit;
-            }
-            error_string += ")";
-          }
-          OPENMS_LOG_ERROR << error_string << std::endl;
+          OPENMS_LOG_ERROR << "FalseDiscoveryRate: #target sequences is zero! Ignoring. " << error_context << std::endl;
         }
 
+        vector<bool> keep(ids.getNumberOfHits(), true);
         if (target_scores.empty() || decoy_scores.empty())
         {
-          // no remove the the relevant entries, or put 'pseudo-scores' in
-          for (auto it = ids.begin(); it != ids.end(); ++it)
+          // remove the relevant decoy entries, and set target scores to zero
+          for (Size i = 0; i < ids.size(); ++i)
           {
-            // if runs should be treated separately, the identifiers must be the same
-            if (treat_runs_separately && it->getIdentifier() != *iit)
+            if (treat_runs_separately && ids.getIdentifier(i) != *iit)
             {
               continue;
             }
 
-            vector<PeptideHit> hits(it->getHits()), new_hits;
-            for (Size i = 0; i < hits.size(); ++i)
+            UInt score_key = MetaInfoInterface::metaRegistry().registerName(ids.getScoreType(i) + "_score");
+            for (Size h = ids.getHitBegin(i); h < ids.getHitEnd(i); ++h)
             {
-              if (split_charge_variants && hits[i].getCharge() != *zit)
+              if (split_charge_variants && ids.getCharge(h) != *zit)
               {
-                new_hits.push_back(hits[i]);
                 continue;
               }
 
-              if (!hits[i].metaValueExists("target_decoy"))
+              String target_decoy = ids.getHitMetaValue(h, target_decoy_key).toString();
+              if (target_decoy == "target" || target_decoy == "target+decoy")
               {
-                OPENMS_LOG_FATAL_ERROR << "Meta value 'target_decoy' does not exists, reindex the idXML file with 'PeptideIndexer' (run-id='" << it->getIdentifier() << ", rank=" << i + 1 << " of " << hits.size() << ")!" << endl;
-                throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Meta value 'target_decoy' does not exist!");
+                // if it is a target hit, there are no decoys, fdr/q-value should be zero then
+                ids.setHitMetaValue(h, score_key, ids.getScore(h));
+                ids.setScore(h, 0);
               }
-
-              String target_decoy(hits[i].getMetaValue("target_decoy"));
-              if (target_decoy == "target" || target_decoy == "target+decoy")
+              else if (target_decoy == "decoy")
               {
-                // if it is a target hit, there are now decoys, fdr/q-value should be zero then
-                new_hits.push_back(hits[i]);
-                String score_type = it->getScoreType() + "_score";
-                new_hits.back().setMetaValue(score_type, new_hits.back().getScore());
-                new_hits.back().setScore(0);
+                keep[h] = false;
               }
               else
               {
-                if (target_decoy != "decoy")
-                {
-                  throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unknown value of meta value 'target_decoy'", target_decoy);
-                }
+                throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unknown value of meta value 'target_decoy'", target_decoy);
               }
             }
-            it->setHits(new_hits);
           }
+          ids.filterHits(keep);
           continue;
         }
 
@@ -281,45 +287,62 @@ namespace OpenMS
         calculateFDRs_(score_to_fdr, target_scores, decoy_scores, q_value, higher_score_better);
 
         // annotate fdr
-        for (auto it = ids.begin(); it != ids.end(); ++it)
+        for (Size i = 0; i < ids.size(); ++i)
         {
-          // if runs should be treated separately, the identifiers must be the same
-          if (treat_runs_separately && it->getIdentifier() != *iit)
+          if (treat_runs_separately && ids.getIdentifier(i) != *iit)
           {
             continue;
           }
 
-          String score_type = it->getScoreType() + "_score";
-          vector<PeptideHit> hits;
-          for (vector<PeptideHit>::const_iterator pit = it->getHits().begin(); pit != it->getHits().end(); ++pit)
+          UInt score_key = MetaInfoInterface::metaRegistry().registerName(ids.getScoreType(i) + "_score");
+          for (Size h = ids.getHitBegin(i); h < ids.getHitEnd(i); ++h)
           {
-            PeptideHit hit = *pit;
-
-            if (split_charge_variants && pit->getCharge() != *zit)
+            if (split_charge_variants && ids.getCharge(h) != *zit)
             {
-              hits.push_back(*pit);
               continue;
             }
-            if (hit.metaValueExists("target_decoy"))
+            if (!add_decoy_peptides && ids.getHitMetaValue(h, target_decoy_key) == DataValue("decoy"))
             {
-              String meta_value = (String)hit.getMetaValue("target_decoy");
-              if (meta_value == "decoy" && !add_decoy_peptides)
-              {
-                continue;
-              }
+              keep[h] = false;
+              continue;
             }
-            hit.setMetaValue(score_type, pit->getScore());
-            hit.setScore(score_to_fdr[pit->getScore()]);
-            hits.push_back(hit);
+            ids.setHitMetaValue(h, score_key, ids.getScore(h));
+            ids.setScore(h, score_to_fdr[ids.getScore(h)]);
           }
-          it->getHits().swap(hits);
         }
+        ids.filterHits(keep);
       }
       if (!split_charge_variants)
       {
         break;
       }
     }
+  }
+
+  void FalseDiscoveryRate::apply(vector<PeptideIdentification>& ids) const
+  {
+    OPENMS_PROFILE_SCOPE("FalseDiscoveryRate::apply");
+    bool q_value = !param_.getValue("no_qvalues").toBool();
+    bool use_all_hits = param_.getValue("use_all_hits").toBool();
+
+    if (ids.empty())
+    {
+      OPENMS_LOG_WARN << "No peptide identifications given to FalseDiscoveryRate! No calculation performed.\n";
+      return;
+    }
+
+    for (auto it = ids.begin(); it != ids.end(); ++it)
+    {
+      it->sort();
+
+      if (!use_all_hits)
+      {
+        it->getHits().resize(1);
+      }
+    }
+
+    PeptideIdentificationHits hits(ids);
+    applyToHits_(hits);
 
     // higher-score-better can be set now, calculations are finished
     for (vector<PeptideIdentification>::iterator it = ids.begin(); it != ids.end(); ++it)
@@ -345,6 +368,41 @@ namespace OpenMS
     return;
   }
 
+  void FalseDiscoveryRate::apply(ColumnarPSMStore& ids) const
+  {
+    OPENMS_PROFILE_SCOPE("FalseDiscoveryRate::apply");
+    bool q_value = !param_.getValue("no_qvalues").toBool();
+    bool use_all_hits = param_.getValue("use_all_hits").toBool();
+
+    if (ids.empty())
+    {
+      OPENMS_LOG_WARN << "No peptide identifications given to FalseDiscoveryRate! No calculation performed.\n";
+      return;
+    }
+
+    // sort hits and (optionally) keep only the best one per identification
+    ids.sortHits();
+    if (!use_all_hits)
+    {
+      vector<bool> keep(ids.getNumberOfHits(), false);
+      for (Size i = 0; i < ids.size(); ++i)
+      {
+        if (ids.getHitBegin(i) != ids.getHitEnd(i)) keep[ids.getHitBegin(i)] = true;
+      }
+      ids.filterHits(keep);
+    }
+
+    applyToHits_(ids);
+
+    // higher-score-better can be set now, calculations are finished
+    for (Size i = 0; i < ids.size(); ++i)
+    {
+      ids.setScoreType(i, q_value ? "q-value" : "FDR");
+      ids.setHigherScoreBetter(i, false);
+    }
+    ids.assignRanks();
+  }
+
   void FalseDiscoveryRate::apply(vector<PeptideIdentification>& fwd_ids, vector<PeptideIdentification>& rev_ids) const
   {
     if (fwd_ids.empty() || rev_ids.empty())
@@ -435,6 +493,7 @@ namespace OpenMS
 
   void FalseDiscoveryRate::apply(vector<ProteinIdentification>& ids) const
   {
+    OPENMS_PROFILE_SCOPE("FalseDiscoveryRate::apply");
     bool q_value = !param_.getValue("no_qvalues").toBool();
     bool higher_score_better = ids.begin()->isHigherScoreBetter();
     bool add_decoy_proteins = param_.getValue("add_decoy_proteins").toBool();
@@ -905,7 +905,7 @@ namespace OpenMS
       {
         double mass = use_avg_mass ?
                       hit_it->getSequence().getAverageWeight(Residue::Full, charge) :
-                      hit_it->getSequence().getMonoWeight(Residue::Full, charge);
+                      hit_it->getInternedSequence().getMonoWeight(charge);
 
         mz_values.push_back(mass / (double) charge);
       }
@@ -40,6 +40,7 @@
 
 #include <boost/dynamic_bitset.hpp>
 
+#include <OpenMS/CONCEPT/ParallelExceptionCollector.h>
 #include <OpenMS/FILTERING/TRANSFORMERS/SpectraMerger.h>
 #include <OpenMS/FILTERING/TRANSFORMERS/WindowMower.h>
 
@@ -466,119 +467,140 @@ namespace OpenMS
     wm.filterPeakMap(msexp);
 
 
-    // container storing results
-    vector<SpectralMatch> matching_results;
+    // container storing results (per spectrum, to keep the order independent
+    // of the number of threads)
+    vector<vector<SpectralMatch> > spectrum_results(msexp.size());
 
     bool fragment_error_unit_ppm(true);
     if (mz_error_unit_ == "Da") { fragment_error_unit_ppm = false; }
 
-    for (Size spec_idx = 0; spec_idx < msexp.size(); ++spec_idx)
+    // spectra are matched independently of each other:
+    ParallelExceptionCollector errors;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 10)
+#endif
+    for (SignedSize spec_idx = 0; spec_idx < SignedSize(msexp.size()); ++spec_idx)
     {
-      // cout << "merged spectrum no. " << spec_idx << " with #fragment ions: " << msexp[spec_idx].size() << endl;
-
-      // iterate over all precursor masses
-      for (Size prec_idx = 0; prec_idx < msexp[spec_idx].getPrecursors().size(); ++prec_idx)
+      try
       {
-        // get precursor m/z
-        double precursor_mz(msexp[spec_idx].getPrecursors()[prec_idx].getMZ());
-
-        // cout << "precursor no. " << prec_idx << ": mz " << precursor_mz << " ";
-
-        double prec_mz_lowerbound, prec_mz_upperbound;
+        vector<SpectralMatch>& matching_results = spectrum_results[spec_idx];
+        // cout << "merged spectrum no. " << spec_idx << " with #fragment ions: " << msexp[spec_idx].size() << endl;
 
-        if (!fragment_error_unit_ppm) // Da
+        // iterate over all precursor masses
+        for (Size prec_idx = 0; prec_idx < msexp[spec_idx].getPrecursors().size(); ++prec_idx)
         {
-          prec_mz_lowerbound = precursor_mz - precursor_mz_error_;
-          prec_mz_upperbound = precursor_mz + precursor_mz_error_;
-        }
-        else // ppm
-        {
-          double ppm_offset(precursor_mz * 1e-6 * precursor_mz_error_);
-          prec_mz_lowerbound = precursor_mz - ppm_offset;
-          prec_mz_upperbound = precursor_mz + ppm_offset;
-        }
+          // get precursor m/z
+          double precursor_mz(msexp[spec_idx].getPrecursors()[prec_idx].getMZ());
 
-        // cout << "lower mz: " << prec_mz_lowerbound << " ";
-        // cout << "upper mz: " << prec_mz_upperbound << endl;
+          // cout << "precursor no. " << prec_idx << ": mz " << precursor_mz << " ";
 
-        vector<double>::const_iterator lower_it = lower_bound(mz_keys.begin(), mz_keys.end(), prec_mz_lowerbound);
-        vector<double>::const_iterator upper_it = upper_bound(mz_keys.begin(), mz_keys.end(), prec_mz_upperbound);
+          double prec_mz_lowerbound, prec_mz_upperbound;
 
-        Size start_idx(lower_it - mz_keys.begin());
-        Size end_idx(upper_it - mz_keys.begin());
+          if (!fragment_error_unit_ppm) // Da
+          {
+            prec_mz_lowerbound = precursor_mz - precursor_mz_error_;
+            prec_mz_upperbound = precursor_mz + precursor_mz_error_;
+          }
+          else // ppm
+          {
+            double ppm_offset(precursor_mz * 1e-6 * precursor_mz_error_);
+            prec_mz_lowerbound = precursor_mz - ppm_offset;
+            prec_mz_upperbound = precursor_mz + ppm_offset;
+          }
 
-        //cout << "identifying " << msexp[spec_idx].getMetaValue("Massbank_Accession_ID") << endl;
+          // cout << "lower mz: " << prec_mz_lowerbound << " ";
+          // cout << "upper mz: " << prec_mz_upperbound << endl;
 
-        vector<SpectralMatch> partial_results;
+          vector<double>::const_iterator lower_it = lower_bound(mz_keys.begin(), mz_keys.end(), prec_mz_lowerbound);
+          vector<double>::const_iterator upper_it = upper_bound(mz_keys.begin(), mz_keys.end(), prec_mz_upperbound);
 
-        for (Size search_idx = start_idx; search_idx < end_idx; ++search_idx)
-        {
-          // do spectral matching
-          // cout << "scanning " << spec_db[search_idx].getPrecursors()[0].getMZ() << " " << spec_db[search_idx].getMetaValue("Metabolite_Name") << endl;
+          Size start_idx(lower_it - mz_keys.begin());
+          Size end_idx(upper_it - mz_keys.begin());
 
-          // check for charge state of precursor ions: do they match?
-          if ( (ion_mode_ == "positive" && spec_db[search_idx].getPrecursors()[0].getCharge() < 0) || (ion_mode_ == "negative" && spec_db[search_idx].getPrecursors()[0].getCharge() > 0))
-          {
-            continue;
-          }
+          //cout << "identifying " << msexp[spec_idx].getMetaValue("Massbank_Accession_ID") << endl;
 
-          double hyperscore(computeHyperScore(fragment_mz_error_, fragment_error_unit_ppm, msexp[spec_idx], spec_db[search_idx], 0.0));
+          vector<SpectralMatch> partial_results;
 
-          // cout << " scored with " << hyperScore << endl;
-          if (hyperscore > 0)
+          for (Size search_idx = start_idx; search_idx < end_idx; ++search_idx)
           {
-            // cout << "  ** detected " << spec_db[search_idx].getMetaValue("Massbank_Accession_ID") << " " << spec_db[search_idx].getMetaValue("Metabolite_Name") << " scored with " << hyperscore << endl;
-
-            // score result temporarily
-            SpectralMatch tmp_match;
-            tmp_match.setObservedPrecursorMass(precursor_mz);
-            tmp_match.setFoundPrecursorMass(spec_db[search_idx].getPrecursors()[0].getMZ());
-            double obs_rt = floor(msexp[spec_idx].getRT() * 10)/10.0;
-            tmp_match.setObservedPrecursorRT(obs_rt);
-            tmp_match.setFoundPrecursorCharge(spec_db[search_idx].getPrecursors()[0].getCharge());
-            tmp_match.setMatchingScore(hyperscore);
-            tmp_match.setObservedSpectrumIndex(spec_idx);
-            tmp_match.setMatchingSpectrumIndex(search_idx);
-
-            tmp_match.setPrimaryIdentifier(spec_db[search_idx].getMetaValue("Massbank_Accession_ID"));
-            tmp_match.setSecondaryIdentifier(spec_db[search_idx].getMetaValue("HMDB_ID"));
-            tmp_match.setSumFormula(spec_db[search_idx].getMetaValue("Sum_Formula"));
-            tmp_match.setCommonName(spec_db[search_idx].getMetaValue("Metabolite_Name"));
-            tmp_match.setInchiString(spec_db[search_idx].getMetaValue("Inchi_String"));
-            tmp_match.setSMILESString(spec_db[search_idx].getMetaValue("SMILES_String"));
-            tmp_match.setPrecursorAdduct(spec_db[search_idx].getMetaValue("Precursor_Ion"));
-
-            partial_results.push_back(tmp_match);
+            // do spectral matching
+            // cout << "scanning " << spec_db[search_idx].getPrecursors()[0].getMZ() << " " << spec_db[search_idx].getMetaValue("Metabolite_Name") << endl;
+
+            // check for charge state of precursor ions: do they match?
+            if ( (ion_mode_ == "positive" && spec_db[search_idx].getPrecursors()[0].getCharge() < 0) || (ion_mode_ == "negative" && spec_db[search_idx].getPrecursors()[0].getCharge() > 0))
+            {
+              continue;
+            }
+
+            double hyperscore(computeHyperScore(fragment_mz_error_, fragment_error_unit_ppm, msexp[spec_idx], spec_db[search_idx], 0.0));
+
+            // cout << " scored with " << hyperScore << endl;
+            if (hyperscore > 0)
+            {
+              // cout << "  ** detected " << spec_db[search_idx].getMetaValue("Massbank_Accession_ID") << " " << spec_db[search_idx].getMetaValue("Metabolite_Name") << " scored with " << hyperscore << endl;
+
+              // score result temporarily
+              SpectralMatch tmp_match;
+              tmp_match.setObservedPrecursorMass(precursor_mz);
+              tmp_match.setFoundPrecursorMass(spec_db[search_idx].getPrecursors()[0].getMZ());
+              double obs_rt = floor(msexp[spec_idx].getRT() * 10)/10.0;
+              tmp_match.setObservedPrecursorRT(obs_rt);
+              tmp_match.setFoundPrecursorCharge(spec_db[search_idx].getPrecursors()[0].getCharge());
+              tmp_match.setMatchingScore(hyperscore);
+              tmp_match.setObservedSpectrumIndex(spec_idx);
+              tmp_match.setMatchingSpectrumIndex(search_idx);
+
+              tmp_match.setPrimaryIdentifier(spec_db[search_idx].getMetaValue("Massbank_Accession_ID"));
+              tmp_match.setSecondaryIdentifier(spec_db[search_idx].getMetaValue("HMDB_ID"));
+              tmp_match.setSumFormula(spec_db[search_idx].getMetaValue("Sum_Formula"));
+              tmp_match.setCommonName(spec_db[search_idx].getMetaValue("Metabolite_Name"));
+              tmp_match.setInchiString(spec_db[search_idx].getMetaValue("Inchi_String"));
+              tmp_match.setSMILESString(spec_db[search_idx].getMetaValue("SMILES_String"));
+              tmp_match.setPrecursorAdduct(spec_db[search_idx].getMetaValue("Precursor_Ion"));
+
+              partial_results.push_back(tmp_match);
+            }
           }
-        }
 
-        // sort results by decreasing store
-        sort(partial_results.begin(), partial_results.end(), SpectralMatchScoreGreater);
+          // sort results by decreasing store
+          sort(partial_results.begin(), partial_results.end(), SpectralMatchScoreGreater);
 
-        // report mode: top3 or best?
-        if (report_mode_ == "top3")
-        {
-          Size num_results(partial_results.size());
+          // report mode: top3 or best?
+          if (report_mode_ == "top3")
+          {
+            Size num_results(partial_results.size());
 
-          Size last_result_idx = (num_results >= 3) ? 3 : num_results;
+            Size last_result_idx = (num_results >= 3) ? 3 : num_results;
 
-          for (Size result_idx = 0; result_idx < last_result_idx; ++result_idx)
-          {
-            // cout << "score: " << partial_results[result_idx].getMatchingScore() << " " << partial_results[result_idx].getMatchingSpectrumIndex() << endl;
-            matching_results.push_back(partial_results[result_idx]);
+            for (Size result_idx = 0; result_idx < last_result_idx; ++result_idx)
+            {
+              // cout << "score: " << partial_results[result_idx].getMatchingScore() << " " << partial_results[result_idx].getMatchingSpectrumIndex() << endl;
+              matching_results.push_back(partial_results[result_idx]);
+            }
           }
-        }
 
-        if (report_mode_ == "best")
-        {
-          if (partial_results.size() > 0)
+          if (report_mode_ == "best")
           {
-            matching_results.push_back(partial_results[0]);
+            if (partial_results.size() > 0)
+            {
+              matching_results.push_back(partial_results[0]);
+            }
           }
-        }
 
-      } // end precursor loop
+        } // end precursor loop
+      }
+      catch (...)
+      {
+        errors.capture(spec_idx);
+      }
     } // end spectra loop
+    errors.rethrowFirst();
+
+    vector<SpectralMatch> matching_results;
+    for (const vector<SpectralMatch>& results : spectrum_results)
+    {
+      matching_results.insert(matching_results.end(), results.begin(), results.end());
+    }
 
     // write final results to MzTab
     exportMzTab_(matching_results, mztab_out);
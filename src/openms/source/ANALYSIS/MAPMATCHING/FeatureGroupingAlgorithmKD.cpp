@@ -37,6 +37,7 @@
 #include <OpenMS/METADATA/ProteinIdentification.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
 #include <OpenMS/FORMAT/FeatureXMLFile.h>
+#include <OpenMS/SYSTEM/Profiler.h>
 
 using namespace std;
 
@@ -112,6 +113,7 @@ namespace OpenMS
   void FeatureGroupingAlgorithmKD::group_(const vector<MapType>& input_maps,
                                           ConsensusMap& out)
   {
+    OPENMS_PROFILE_SCOPE("FeatureGroupingAlgorithmKD::group");
     // set parameters
     String mz_unit(param_.getValue("mz_unit").toString());
     mz_ppm_ = mz_unit == "ppm";
@@ -46,10 +46,17 @@
 // Helpers
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathHelper.h>
 #include <OpenMS/CHEMISTRY/ProteaseDigestion.h>
+#include <OpenMS/CONCEPT/ParallelExceptionCollector.h>
 
 #include <boost/range/adaptor/map.hpp>
 #include <boost/foreach.hpp>
 
+#include <memory>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #define run_identifier "unique_run_identifier"
 
 bool SortDoubleDoublePairFirst(const std::pair<double, double>& left, const std::pair<double, double>& right)
@@ -223,31 +230,106 @@ namespace OpenMS
     // Step 3
     //
     // Go through all transition groups: first create consensus features, then score them
-    MRMTransitionGroupPicker trgroup_picker;
     Param trgroup_picker_param = param_.copy("TransitionGroupPicker:", true);
     // If use_total_mi_score is defined, we need to instruct MRMTransitionGroupPicker to compute the score
     if (su_.use_total_mi_score_)
     {
       trgroup_picker_param.setValue("compute_total_mi", "true");
     }
-    trgroup_picker.setParameters(trgroup_picker_param);
 
-    Size progress = 0;
-    startProgress(0, transition_group_map.size(), "picking peaks");
+    // Transition groups are processed in parallel. The scoring members
+    // (DIAScoring etc.) and the spectrum access objects are not thread-safe,
+    // so each additional thread uses its own picker, its own scoring instance
+    // and its own (light) copies of the spectrum access pointers; the first
+    // thread uses this instance and the given maps. Features are collected
+    // per group and appended in the order of the group map.
+    std::vector<MRMTransitionGroupType*> transition_groups;
+    transition_groups.reserve(transition_group_map.size());
     for (TransitionGroupMapType::iterator trgroup_it = transition_group_map.begin(); trgroup_it != transition_group_map.end(); ++trgroup_it)
     {
+      transition_groups.push_back(&trgroup_it->second);
+    }
+    std::vector<FeatureMap> group_features(transition_groups.size());
+
+    // Called from within a parallel region (e.g. the outer loop over SWATH
+    // windows in OpenSwathWorkflow), the groups are processed serially and no
+    // per-thread copies are made. Otherwise the copies are set up before the
+    // parallel region, so that errors in the setup propagate normally.
+#ifdef _OPENMP
+    const int n_threads = omp_in_parallel() ? 1 : std::min<int>(omp_get_max_threads(), std::max<int>(1, transition_groups.size()));
+#else
+    const int n_threads = 1;
+#endif
+    std::vector<std::unique_ptr<MRMTransitionGroupPicker> > thread_pickers;
+    std::vector<std::unique_ptr<MRMFeatureFinderScoring> > thread_scoring_copies;
+    std::vector<MRMFeatureFinderScoring*> thread_scorings(1, this);
+    std::vector<std::vector<OpenSwath::SwathMap> > thread_swath_maps(1, swath_maps);
+    for (int t = 0; t < n_threads; ++t)
+    {
+      thread_pickers.emplace_back(new MRMTransitionGroupPicker());
+      thread_pickers.back()->setParameters(trgroup_picker_param);
+      if (t == 0) continue;
+
+      thread_scoring_copies.emplace_back(new MRMFeatureFinderScoring());
+      MRMFeatureFinderScoring& thread_scoring = *thread_scoring_copies.back();
+      thread_scoring.setParameters(param_);
+      thread_scoring.setStrictFlag(strict_);
+      thread_scoring.PeptideRefMap_ = PeptideRefMap_;
+      if (ms1_map_) thread_scoring.setMS1Map(ms1_map_->lightClone());
+      thread_scorings.push_back(&thread_scoring);
+
+      thread_swath_maps.push_back(swath_maps);
+      for (OpenSwath::SwathMap& swath_map : thread_swath_maps.back())
+      {
+        if (swath_map.sptr) swath_map.sptr = swath_map.sptr->lightClone();
+      }
+    }
 
+    // the first exception (by group index) thrown inside the parallel region; rethrown afterwards
+    ParallelExceptionCollector errors;
+    Size progress = 0;
+    startProgress(0, transition_groups.size(), "picking peaks");
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1) num_threads(n_threads)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)transition_groups.size(); ++i)
+    {
+#ifdef _OPENMP
+#pragma omp critical (MRMFeatureFinderScoring_progress)
+#endif
       setProgress(++progress);
-      MRMTransitionGroupType& transition_group = trgroup_it->second;
-      if (transition_group.getChromatograms().empty() || transition_group.getTransitions().empty())
+
+      try
       {
-        continue;
-      }
+#ifdef _OPENMP
+        const Size t = omp_get_thread_num();
+#else
+        const Size t = 0;
+#endif
+        MRMTransitionGroupType& transition_group = *transition_groups[i];
+        if (transition_group.getChromatograms().empty() || transition_group.getTransitions().empty())
+        {
+          continue;
+        }
 
-      trgroup_picker.pickTransitionGroup(transition_group);
-      scorePeakgroups(trgroup_it->second, trafo, swath_maps, output);
+        thread_pickers[t]->pickTransitionGroup(transition_group);
+        thread_scorings[t]->scorePeakgroups(transition_group, trafo, thread_swath_maps[t], group_features[i]);
+      }
+      catch (...)
+      {
+        errors.capture(i);
+      }
     }
     endProgress();
+    errors.rethrowFirst();
+
+    for (FeatureMap& features : group_features)
+    {
+      for (Feature& feature : features)
+      {
+        output.push_back(std::move(feature));
+      }
+    }
 
     //output.sortByPosition(); // if the exact same order is needed
     return;
@@ -38,11 +38,20 @@
 #include <OpenMS/ANALYSIS/QUANTITATION/TMTTenPlexQuantitationMethod.h>
 #include <OpenMS/ANALYSIS/QUANTITATION/TMTElevenPlexQuantitationMethod.h>
 #include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/CONCEPT/ParallelExceptionCollector.h>
 #include <OpenMS/KERNEL/RangeUtils.h>
 #include <OpenMS/KERNEL/ConsensusFeature.h>
 #include <OpenMS/KERNEL/ConsensusMap.h>
+#include <OpenMS/KERNEL/OnDiscMSExperiment.h>
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
 
+#include <cmath>
+#include <limits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 // #define ISOBARIC_CHANNEL_EXTRACTOR_DEBUG
 // #undef ISOBARIC_CHANNEL_EXTRACTOR_DEBUG
 
@@ -68,47 +77,6 @@ namespace OpenMS
   };
 
 
-  IsobaricChannelExtractor::PuritySate_::PuritySate_(const PeakMap& targetExp) :
-    baseExperiment(targetExp)
-  {
-    // initialize precursorScan with end(), it will be updated later on
-    // from the calling method
-    precursorScan = baseExperiment.end();
-
-    // find the first ms1 scan in the experiment
-    followUpScan = baseExperiment.begin();
-    while (followUpScan != baseExperiment.end() && followUpScan->getMSLevel() != 1)
-    {
-      ++followUpScan;
-    }
-
-    // check if we found one
-    hasFollowUpScan = followUpScan != baseExperiment.end();
-  }
-
-
-  void IsobaricChannelExtractor::PuritySate_::advanceFollowUp(const double rt)
-  {
-    // advance follow up scan until we found a ms1 scan with a bigger RT
-    if (followUpScan != baseExperiment.end()) ++followUpScan;
-    while (followUpScan != baseExperiment.end())
-    {
-      if (followUpScan->getMSLevel() == 1 && followUpScan->getRT() > rt)
-      {
-        break;
-      }
-      ++followUpScan;
-    }
-
-    // check if we found one
-    hasFollowUpScan = followUpScan != baseExperiment.end();
-  }
-
-  bool IsobaricChannelExtractor::PuritySate_::followUpValid(const double rt)
-  {
-    return hasFollowUpScan ? rt < followUpScan->getRT() : true;
-  }
-
   IsobaricChannelExtractor::IsobaricChannelExtractor(const IsobaricQuantitationMethod* const quant_method) :
     DefaultParamHandler("IsobaricChannelExtractor"),
     quant_method_(quant_method),
@@ -241,28 +209,28 @@ namespace OpenMS
     return false;
   }
 
-  double IsobaricChannelExtractor::computeSingleScanPrecursorPurity_(const PeakMap::ConstIterator& ms2_spec, const PeakMap::SpectrumType& precursor_spec) const
+  double IsobaricChannelExtractor::computeSingleScanPrecursorPurity_(const PeakMap::SpectrumType& ms2_spec, const PeakMap::SpectrumType& precursor_spec) const
   {
 
     typedef PeakMap::SpectrumType::ConstIterator const_spec_iterator;
 
     // compute distance between isotopic peaks based on the precursor charge.
-    const double charge_dist = Constants::NEUTRON_MASS_U / static_cast<double>(ms2_spec->getPrecursors()[0].getCharge());
+    const double charge_dist = Constants::NEUTRON_MASS_U / static_cast<double>(ms2_spec.getPrecursors()[0].getCharge());
 
     // the actual boundary values
-    const double strict_lower_mz = ms2_spec->getPrecursors()[0].getMZ() - ms2_spec->getPrecursors()[0].getIsolationWindowLowerOffset();
-    const double strict_upper_mz = ms2_spec->getPrecursors()[0].getMZ() + ms2_spec->getPrecursors()[0].getIsolationWindowUpperOffset();
+    const double strict_lower_mz = ms2_spec.getPrecursors()[0].getMZ() - ms2_spec.getPrecursors()[0].getIsolationWindowLowerOffset();
+    const double strict_upper_mz = ms2_spec.getPrecursors()[0].getMZ() + ms2_spec.getPrecursors()[0].getIsolationWindowUpperOffset();
 
     const double fuzzy_lower_mz = strict_lower_mz - (strict_lower_mz * max_precursor_isotope_deviation_ / 1000000);
     const double fuzzy_upper_mz = strict_upper_mz + (strict_upper_mz * max_precursor_isotope_deviation_ / 1000000);
 
     // first find the actual precursor peak
-    Size precursor_peak_idx = precursor_spec.findNearest(ms2_spec->getPrecursors()[0].getMZ());
+    Size precursor_peak_idx = precursor_spec.findNearest(ms2_spec.getPrecursors()[0].getMZ());
     const Peak1D& precursor_peak = precursor_spec[precursor_peak_idx];
 
     // now we get ourselves some border iterators
     const_spec_iterator lower_bound = precursor_spec.MZBegin(fuzzy_lower_mz);
-    const_spec_iterator upper_bound = precursor_spec.MZEnd(ms2_spec->getPrecursors()[0].getMZ());
+    const_spec_iterator upper_bound = precursor_spec.MZEnd(ms2_spec.getPrecursors()[0].getMZ());
 
     Peak1D::IntensityType precursor_intensity = precursor_peak.getIntensity();
     Peak1D::IntensityType total_intensity = precursor_peak.getIntensity();
@@ -325,7 +293,7 @@ namespace OpenMS
     // try to find a match for our isotopic peak on the right
 
     // redefine bounds
-    lower_bound = precursor_spec.MZBegin(ms2_spec->getPrecursors()[0].getMZ());
+    lower_bound = precursor_spec.MZBegin(ms2_spec.getPrecursors()[0].getMZ());
     upper_bound = precursor_spec.MZEnd(fuzzy_upper_mz);
 
     expected_next_mz = precursor_peak.getMZ() + charge_dist;
@@ -416,32 +384,32 @@ namespace OpenMS
     return precursor_intensity / total_intensity;
   }
 
-  double IsobaricChannelExtractor::computePrecursorPurity_(const PeakMap::ConstIterator& ms2_spec, const PuritySate_& pState) const
+  double IsobaricChannelExtractor::computePrecursorPurity_(const PeakMap::SpectrumType& ms2_spec, const PeakMap::SpectrumType& precursor_spec, const PeakMap::SpectrumType* follow_up_spec) const
   {
     // we cannot analyze precursors without a charge
-    if (ms2_spec->getPrecursors()[0].getCharge() == 0)
+    if (ms2_spec.getPrecursors()[0].getCharge() == 0)
     {
       return 1.0;
     }
     else
     {
 #ifdef ISOBARIC_CHANNEL_EXTRACTOR_DEBUG
-      std::cerr << "------------------ analyzing " << ms2_spec->getNativeID() << std::endl;
+      std::cerr << "------------------ analyzing " << ms2_spec.getNativeID() << std::endl;
 #endif
 
       // compute purity of preceding ms1 scan
-      double early_scan_purity = computeSingleScanPrecursorPurity_(ms2_spec, *(pState.precursorScan));
+      double early_scan_purity = computeSingleScanPrecursorPurity_(ms2_spec, precursor_spec);
 
-      if (pState.hasFollowUpScan && interpolate_precursor_purity_)
+      if (follow_up_spec != nullptr && interpolate_precursor_purity_)
       {
-        double late_scan_purity = computeSingleScanPrecursorPurity_(ms2_spec, *(pState.followUpScan));
+        double late_scan_purity = computeSingleScanPrecursorPurity_(ms2_spec, *follow_up_spec);
 
         // calculating the extrapolated, S2I value as a time weighted linear combination of the two scans
         // see: Savitski MM, Sweetman G, Askenazi M, Marto JA, Lang M, Zinn N, et al. (2011).
         // Analytical chemistry 83: 8959–67. http://www.ncbi.nlm.nih.gov/pubmed/22017476
         // std::fabs is applied to compensate for potentially negative RTs
-        return std::fabs(ms2_spec->getRT() - pState.precursorScan->getRT()) *
-               ((late_scan_purity - early_scan_purity) / std::fabs(pState.followUpScan->getRT() - pState.precursorScan->getRT()))
+        return std::fabs(ms2_spec.getRT() - precursor_spec.getRT()) *
+               ((late_scan_purity - early_scan_purity) / std::fabs(follow_up_spec->getRT() - precursor_spec.getRT()))
                + early_scan_purity;
       }
       else
@@ -451,24 +419,9 @@ namespace OpenMS
     }
   }
 
-  void IsobaricChannelExtractor::extractChannels(const PeakMap& ms_exp_data, ConsensusMap& consensus_map)
+  bool IsobaricChannelExtractor::selectQuantScans_(const PeakMap& ms_exp_data, std::vector<QuantScan_>& scans) const
   {
-    if (ms_exp_data.empty())
-    {
-      OPENMS_LOG_WARN << "The given file does not contain any conventional peak data, but might"
-                  " contain chromatograms. This tool currently cannot handle them, sorry.\n";
-      throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Experiment has no scans!");
-    }
-
-    // check if RT is sorted (we rely on it)
-    if (!ms_exp_data.isSorted(false))
-    {
-      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Spectra are not sorted in RT! Please sort them first!");
-    }
-
-    // clear the output map
-    consensus_map.clear(false);
-    consensus_map.setExperimentType("labeled_MS2");
+    scans.clear();
 
     // create predicate for spectrum checking
     OPENMS_LOG_INFO << "Selecting scans with activation mode: " << (selected_activation_ == "" ? "any" : selected_activation_) << std::endl;
@@ -496,7 +449,7 @@ namespace OpenMS
         OPENMS_LOG_WARN << "  mode " << (it->first.empty() ? "<none>" : it->first) << ": " << it->second << " scans\n";
       }
       OPENMS_LOG_WARN << "Result will be empty!" << std::endl;
-      return;
+      return false;
     }
     OPENMS_LOG_INFO << "Filtering by MS/MS(/MS) and activation mode:\n";
     for (std::map<UInt, UInt>::const_iterator it = ms_level.begin(); it != ms_level.end(); ++it)
@@ -506,184 +459,376 @@ namespace OpenMS
     UInt quant_ms_level = ms_level.rbegin()->first;
     OPENMS_LOG_INFO << "Using MS-level " << quant_ms_level << " for quantification." << std::endl;
 
-    // now we have picked data
-    // --> assign peaks to channels
-    UInt64 element_index(0);
-
-    // remember the current precursor spectrum
-    PuritySate_ pState(ms_exp_data);
-
-    typedef std::map<String, ChannelQC > ChannelQCSet;
-    ChannelQCSet channel_mz_delta;
-    const double qc_dist_mz = 0.5; // fixed! Do not change!
-
-    Size number_of_channels = quant_method_->getNumberOfChannels();
-
-    PeakMap::ConstIterator it_last_MS2 = ms_exp_data.end(); // remember last MS2 spec, to get precursor in MS1 (also if quant is in MS3)
-
-    for (PeakMap::ConstIterator it = ms_exp_data.begin(); it != ms_exp_data.end(); ++it)
+    const Size none = std::numeric_limits<Size>::max();
+    Size precursor_scan = none; // last MS1 scan, assumed to be the precursor spectrum
+    Size follow_up_scan = 0; // candidate for the first MS1 scan after the current MSn scan
+    for (Size i = 0; i < ms_exp_data.size(); ++i)
     {
-      // remember the last MS1 spectra as we assume it to be the precursor spectrum
-      if (it->getMSLevel() ==  1)
+      const PeakMap::SpectrumType& spec = ms_exp_data[i];
+      if (spec.getMSLevel() == 1)
       {
-        // remember potential precursor and continue
-        pState.precursorScan = it;
-        // reset last MS2 -- we expect to see a new one soon and the old one should not be used for the following MS3 (if any)
-        it_last_MS2 = ms_exp_data.end();
+        precursor_scan = i;
         continue;
       }
 
-      if (it->getMSLevel() != quant_ms_level) continue;
-      if ((*it).empty()) continue; // skip empty spectra
-      if (!(selected_activation_.empty() || isValidActivation(*it))) continue;
+      if (spec.getMSLevel() != quant_ms_level) continue;
+      if (!(selected_activation_.empty() || isValidActivation(spec))) continue;
+
+      QuantScan_ scan;
+      scan.msn = i;
+      scan.precursor_scan = precursor_scan;
 
-      // find following ms1 scan (needed for purity computation)
-      if (!pState.followUpValid(it->getRT()))
+      // find following ms1 scan (needed for purity computation); RT is sorted, so we never need to go back
+      while (follow_up_scan < ms_exp_data.size() &&
+             (ms_exp_data[follow_up_scan].getMSLevel() != 1 || !(spec.getRT() < ms_exp_data[follow_up_scan].getRT())))
       {
-        // advance iterator
-        pState.advanceFollowUp(it->getRT());
+        ++follow_up_scan;
       }
+      scan.follow_up_scan = (follow_up_scan < ms_exp_data.size()) ? follow_up_scan : none;
 
-      // check precursor constraints
-      if (!isValidPrecursor_(it->getPrecursors()[0]))
+      if (spec.getMSLevel() == 3)
       {
-        OPENMS_LOG_DEBUG << "Skip spectrum " << it->getNativeID() << ": Precursor doesn't fulfill all constraints." << std::endl;
-        continue;
+        // we cannot save just the last MS2 but need to compare to the precursor info stored in the (potential MS3 spectrum)
+        PeakMap::ConstIterator it_ms2 = ms_exp_data.getPrecursorSpectrum(ms_exp_data.begin() + i);
+        scan.ms2 = (it_ms2 != ms_exp_data.end()) ? static_cast<Size>(it_ms2 - ms_exp_data.begin()) : none;
       }
+      else
+      {
+        scan.ms2 = i;
+      }
+
+      scans.push_back(scan);
+    }
+
+    return true;
+  }
+
+  void IsobaricChannelExtractor::quantifyScan_(const PeakMap::SpectrumType& msn, const PeakMap::SpectrumType* precursor_scan, const PeakMap::SpectrumType* follow_up_scan, ScanQuantification_& result) const
+  {
+    if (msn.empty())
+    {
+      result.empty_scan = true;
+      return;
+    }
+
+    // check precursor constraints
+    if (!isValidPrecursor_(msn.getPrecursors()[0])) return;
 
-      // check precursor purity if we have a valid precursor ..
-      double precursor_purity = -1.0;
-      if (pState.precursorScan != ms_exp_data.end())
+    // check precursor purity if we have a valid precursor ..
+    if (precursor_scan != nullptr)
+    {
+      result.precursor_purity = computePrecursorPurity_(msn, *precursor_scan, follow_up_scan);
+      // check if purity is high enough
+      if (result.precursor_purity < min_precursor_purity_) return;
+    }
+
+    const double qc_dist_mz = 0.5; // fixed! Do not change!
+    const IsobaricQuantitationMethod::IsobaricChannelList& channels = quant_method_->getChannelInformation();
+    result.intensities.resize(channels.size(), 0);
+    result.mz_deltas.resize(channels.size(), std::numeric_limits<double>::quiet_NaN());
+    result.not_unique.resize(channels.size(), false);
+
+    for (Size c = 0; c < channels.size(); ++c)
+    {
+      const double center = channels[c].center;
+
+      // as every evaluation requires time, we cache the MZEnd iterator
+      const PeakMap::SpectrumType::ConstIterator mz_end = msn.MZEnd(center + qc_dist_mz);
+
+      // search for the non-zero signal closest to theoretical position
+      // & check for closest signal within reasonable distance (0.5 Da) -- might find neighbouring TMT channel, but that should not confuse anyone
+      int peak_count(0); // count peaks in user window -- should be only one, otherwise Window is too large
+      PeakMap::SpectrumType::ConstIterator idx_nearest(mz_end);
+      for (PeakMap::SpectrumType::ConstIterator mz_it = msn.MZBegin(center - qc_dist_mz);
+            mz_it != mz_end;
+            ++mz_it)
       {
-        precursor_purity = computePrecursorPurity_(it, pState);
-        // check if purity is high enough
-        if (precursor_purity < min_precursor_purity_)
+        if (mz_it->getIntensity() == 0) continue; // ignore 0-intensity shoulder peaks -- could be detrimental when de-calibrated
+        double dist_mz = fabs(mz_it->getMZ() - center);
+        if (dist_mz < reporter_mass_shift_) ++peak_count;
+        if (idx_nearest == mz_end // first peak
+            || ((dist_mz < fabs(idx_nearest->getMZ() - center)))) // closer to best candidate
         {
-          OPENMS_LOG_DEBUG << "Skip spectrum " << it->getNativeID() << ": Precursor purity is below the threshold. [purity = " << precursor_purity << "]" << std::endl;
-          continue;
+          idx_nearest = mz_it;
         }
       }
-      else
+      if (idx_nearest != mz_end)
       {
-        OPENMS_LOG_INFO << "No precursor available for spectrum: " << it->getNativeID() << std::endl;
+        double mz_delta = center - idx_nearest->getMZ();
+        // stats: we don't care what shift the user specified
+        result.mz_deltas[c] = mz_delta;
+        result.not_unique[c] = peak_count > 1;
+        // pass user threshold
+        if (std::fabs(mz_delta) < reporter_mass_shift_)
+        {
+          result.intensities[c] = idx_nearest->getIntensity();
+        }
       }
 
-      if (it->getMSLevel() == 3)
+      // discard contribution of this channel as it is below the required intensity threshold
+      if (result.intensities[c] < min_reporter_intensity_)
       {
-        // we cannot save just the last MS2 but need to compare to the precursor info stored in the (potential MS3 spectrum)
-        it_last_MS2 = ms_exp_data.getPrecursorSpectrum(it);
+        result.intensities[c] = 0;
+      }
+    }
+  }
 
-        if (it_last_MS2 == ms_exp_data.end())
-        { // this only happens if an MS3 spec does not have a preceding MS2
-          throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("No MS2 precursor information given for MS3 scan native ID ") + it->getNativeID() + " with RT " + String(it->getRT()));
+  void IsobaricChannelExtractor::extractChannels(const PeakMap& ms_exp_data, ConsensusMap& consensus_map)
+  {
+    extractChannels_(ms_exp_data, nullptr, consensus_map);
+  }
+
+  void IsobaricChannelExtractor::extractChannels(OnDiscMSExperiment& ms_exp_data, ConsensusMap& consensus_map)
+  {
+    extractChannels_(*ms_exp_data.getMetaData(), &ms_exp_data, consensus_map);
+  }
+
+  void IsobaricChannelExtractor::extractChannels_(const PeakMap& ms_exp_data, OnDiscMSExperiment* on_disc, ConsensusMap& consensus_map)
+  {
+    if (ms_exp_data.empty())
+    {
+      OPENMS_LOG_WARN << "The given file does not contain any conventional peak data, but might"
+                  " contain chromatograms. This tool currently cannot handle them, sorry.\n";
+      throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Experiment has no scans!");
+    }
+
+    // check if RT is sorted (we rely on it)
+    if (!ms_exp_data.isSorted(false))
+    {
+      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Spectra are not sorted in RT! Please sort them first!");
+    }
+
+    // clear the output map
+    consensus_map.clear(false);
+    consensus_map.setExperimentType("labeled_MS2");
+
+    // first pass: select MSn scans and their MS1 neighbours
+    std::vector<QuantScan_> scans;
+    if (!selectQuantScans_(ms_exp_data, scans))
+    {
+      return;
+    }
+
+    // now we have picked data
+    // --> assign peaks to channels
+    UInt64 element_index(0);
+
+    typedef std::map<String, ChannelQC > ChannelQCSet;
+    ChannelQCSet channel_mz_delta;
+    const double qc_dist_mz = 0.5; // fixed! Do not change!
+
+    Size number_of_channels = quant_method_->getNumberOfChannels();
+    const IsobaricQuantitationMethod::IsobaricChannelList& channels = quant_method_->getChannelInformation();
+
+    const Size none = std::numeric_limits<Size>::max();
+
+    // data on disc is processed in chunks, which limits the number of spectra held in memory
+    const Size chunk_size = (on_disc == nullptr) ? scans.size() : 2000;
+    std::vector<ScanQuantification_> quantifications;
+    for (Size chunk_begin = 0; chunk_begin < scans.size(); chunk_begin += chunk_size)
+    {
+      const Size chunk_end = std::min(scans.size(), chunk_begin + chunk_size);
+      quantifications.assign(chunk_end - chunk_begin, ScanQuantification_());
+
+      // second pass: compute purities and extract reporter intensities in parallel;
+      // errors are reported for the lowest spectrum index, independent of the threads
+      ParallelExceptionCollector errors;
+      if (on_disc == nullptr)
+      {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+        for (SignedSize i = chunk_begin; i < (SignedSize)chunk_end; ++i)
+        {
+          const QuantScan_& scan = scans[i];
+          try
+          {
+            quantifyScan_(ms_exp_data[scan.msn],
+                          scan.precursor_scan != none ? &ms_exp_data[scan.precursor_scan] : nullptr,
+                          scan.follow_up_scan != none ? &ms_exp_data[scan.follow_up_scan] : nullptr,
+                          quantifications[i - chunk_begin]);
+          }
+          catch (...)
+          {
+            errors.capture(scan.msn);
+          }
         }
       }
       else
       {
-        it_last_MS2 = it;
-      }
+        // MS1 scans are shared between many MSn scans, so we load them only once per chunk
+        std::vector<Size> ms1_indices;
+        for (Size i = chunk_begin; i < chunk_end; ++i)
+        {
+          if (scans[i].precursor_scan != none) ms1_indices.push_back(scans[i].precursor_scan);
+          if (scans[i].follow_up_scan != none && interpolate_precursor_purity_) ms1_indices.push_back(scans[i].follow_up_scan);
+        }
+        std::sort(ms1_indices.begin(), ms1_indices.end());
+        ms1_indices.erase(std::unique(ms1_indices.begin(), ms1_indices.end()), ms1_indices.end());
+        std::vector<PeakMap::SpectrumType> ms1_scans(ms1_indices.size());
+
+        // every thread needs its own file stream
+#ifdef _OPENMP
+        std::vector<OnDiscMSExperiment> thread_data_list(omp_get_max_threads(), *on_disc);
+#else
+        std::vector<OnDiscMSExperiment> thread_data_list(1, *on_disc);
+#endif
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+#ifdef _OPENMP
+          OnDiscMSExperiment& thread_data = thread_data_list[omp_get_thread_num()];
+#else
+          OnDiscMSExperiment& thread_data = thread_data_list[0];
+#endif
 
-      // check if MS1 precursor info is available
-      if (it_last_MS2->getPrecursors().empty())
-      {
-        throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("No precursor information given for scan native ID ") + it->getNativeID() + " with RT " + String(it->getRT()));
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 10)
+#endif
+          for (SignedSize k = 0; k < (SignedSize)ms1_indices.size(); ++k)
+          {
+            try
+            {
+              ms1_scans[k] = thread_data.getSpectrum(ms1_indices[k]);
+              if (!ms1_scans[k].isSorted()) ms1_scans[k].sortByPosition();
+            }
+            catch (...)
+            {
+              errors.capture(ms1_indices[k]);
+            }
+          }
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 10)
+#endif
+          for (SignedSize i = chunk_begin; i < (SignedSize)chunk_end; ++i)
+          {
+            try
+            {
+              const QuantScan_& scan = scans[i];
+              const PeakMap::SpectrumType* precursor_scan(nullptr);
+              const PeakMap::SpectrumType* follow_up_scan(nullptr);
+              if (scan.precursor_scan != none)
+              {
+                precursor_scan = &ms1_scans[std::lower_bound(ms1_indices.begin(), ms1_indices.end(), scan.precursor_scan) - ms1_indices.begin()];
+              }
+              if (scan.follow_up_scan != none && interpolate_precursor_purity_)
+              {
+                follow_up_scan = &ms1_scans[std::lower_bound(ms1_indices.begin(), ms1_indices.end(), scan.follow_up_scan) - ms1_indices.begin()];
+              }
+              PeakMap::SpectrumType msn = thread_data.getSpectrum(scan.msn);
+              if (!msn.isSorted()) msn.sortByPosition();
+              quantifyScan_(msn, precursor_scan, follow_up_scan, quantifications[i - chunk_begin]);
+            }
+            catch (...)
+            {
+              errors.capture(scans[i].msn);
+            }
+          }
+        }
       }
+      errors.rethrowFirst();
 
-      // store RT of MS2 scan and MZ of MS1 precursor ion as centroid of ConsensusFeature
-      ConsensusFeature cf;
-      cf.setUniqueId();
-      cf.setRT(it_last_MS2->getRT());
-      cf.setMZ(it_last_MS2->getPrecursors()[0].getMZ());
-
-      Peak2D channel_value;
-      channel_value.setRT(it->getRT());
-      // for each each channel
-      UInt64 map_index = 0;
-      Peak2D::IntensityType overall_intensity = 0;
-
-      for (IsobaricQuantitationMethod::IsobaricChannelList::const_iterator cl_it = quant_method_->getChannelInformation().begin();
-            cl_it != quant_method_->getChannelInformation().end();
-            ++cl_it)
+      // collect the results in the order of the experiment
+      for (Size i = chunk_begin; i < chunk_end; ++i)
       {
-        // set mz-position of channel
-        channel_value.setMZ(cl_it->center);
-        // reset intensity
-        channel_value.setIntensity(0);
-
-        // as every evaluation requires time, we cache the MZEnd iterator
-        const PeakMap::SpectrumType::ConstIterator mz_end = it->MZEnd(cl_it->center + qc_dist_mz);
-
-        // search for the non-zero signal closest to theoretical position
-        // & check for closest signal within reasonable distance (0.5 Da) -- might find neighbouring TMT channel, but that should not confuse anyone
-        int peak_count(0); // count peaks in user window -- should be only one, otherwise Window is too large
-        PeakMap::SpectrumType::ConstIterator idx_nearest(mz_end);
-        for (PeakMap::SpectrumType::ConstIterator mz_it = it->MZBegin(cl_it->center - qc_dist_mz);
-              mz_it != mz_end;
-              ++mz_it)
+        const QuantScan_& scan = scans[i];
+        const ScanQuantification_& quant = quantifications[i - chunk_begin];
+        const PeakMap::SpectrumType& msn = ms_exp_data[scan.msn];
+
+        if (quant.empty_scan) continue; // skip empty spectra
+
+        // check precursor constraints
+        if (!isValidPrecursor_(msn.getPrecursors()[0]))
         {
-          if (mz_it->getIntensity() == 0) continue; // ignore 0-intensity shoulder peaks -- could be detrimental when de-calibrated
-          double dist_mz = fabs(mz_it->getMZ() - cl_it->center);
-          if (dist_mz < reporter_mass_shift_) ++peak_count;
-          if (idx_nearest == mz_end // first peak
-              || ((dist_mz < fabs(idx_nearest->getMZ() - cl_it->center)))) // closer to best candidate
-          {
-            idx_nearest = mz_it;
-          }
+          OPENMS_LOG_DEBUG << "Skip spectrum " << msn.getNativeID() << ": Precursor doesn't fulfill all constraints." << std::endl;
+          continue;
         }
-        if (idx_nearest != mz_end)
+
+        // check precursor purity if we have a valid precursor ..
+        if (scan.precursor_scan != none)
         {
-          double mz_delta = cl_it->center - idx_nearest->getMZ();
-          // stats: we don't care what shift the user specified
-          channel_mz_delta[cl_it->name].mz_deltas.push_back(mz_delta);
-          if (peak_count > 1) ++channel_mz_delta[cl_it->name].signal_not_unique;
-          // pass user threshold
-          if (std::fabs(mz_delta) < reporter_mass_shift_)
+          // check if purity is high enough
+          if (quant.precursor_purity < min_precursor_purity_)
           {
-            channel_value.setIntensity(idx_nearest->getIntensity());
+            OPENMS_LOG_DEBUG << "Skip spectrum " << msn.getNativeID() << ": Precursor purity is below the threshold. [purity = " << quant.precursor_purity << "]" << std::endl;
+            continue;
           }
         }
+        else
+        {
+          OPENMS_LOG_INFO << "No precursor available for spectrum: " << msn.getNativeID() << std::endl;
+        }
 
-        // discard contribution of this channel as it is below the required intensity threshold
-        if (channel_value.getIntensity() < min_reporter_intensity_)
+        // this only happens if an MS3 spec does not have a preceding MS2
+        if (scan.ms2 == none)
         {
-          channel_value.setIntensity(0);
+          throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("No MS2 precursor information given for MS3 scan native ID ") + msn.getNativeID() + " with RT " + String(msn.getRT()));
         }
+        const PeakMap::SpectrumType& ms2 = ms_exp_data[scan.ms2];
 
-        overall_intensity += channel_value.getIntensity();
-        // add channel to ConsensusFeature
-        cf.insert(map_index, channel_value, element_index);
-        ++map_index;
-      } // ! channel_iterator
+        // check if MS1 precursor info is available
+        if (ms2.getPrecursors().empty())
+        {
+          throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("No precursor information given for scan native ID ") + msn.getNativeID() + " with RT " + String(msn.getRT()));
+        }
 
-      // check if we keep this feature or if it contains low-intensity quantifications
-      if (remove_low_intensity_quantifications_ && hasLowIntensityReporter_(cf))
-      {
-        continue;
-      }
+        // store RT of MS2 scan and MZ of MS1 precursor ion as centroid of ConsensusFeature
+        ConsensusFeature cf;
+        cf.setUniqueId();
+        cf.setRT(ms2.getRT());
+        cf.setMZ(ms2.getPrecursors()[0].getMZ());
+
+        Peak2D channel_value;
+        channel_value.setRT(msn.getRT());
+        // for each each channel
+        Peak2D::IntensityType overall_intensity = 0;
+        for (Size c = 0; c < channels.size(); ++c)
+        {
+          if (!std::isnan(quant.mz_deltas[c]))
+          {
+            channel_mz_delta[channels[c].name].mz_deltas.push_back(quant.mz_deltas[c]);
+            if (quant.not_unique[c]) ++channel_mz_delta[channels[c].name].signal_not_unique;
+          }
 
-      // check featureHandles are not empty
-      if (overall_intensity <= 0)
-      {
-        cf.setMetaValue("all_empty", String("true"));
-      }
-      // add purity information if we could compute it
-      if (precursor_purity > 0.0)
-      {
-        cf.setMetaValue("precursor_purity", precursor_purity);
-      }
+          channel_value.setMZ(channels[c].center);
+          channel_value.setIntensity(quant.intensities[c]);
+          overall_intensity += channel_value.getIntensity();
+          // add channel to ConsensusFeature
+          cf.insert(c, channel_value, element_index);
+        }
 
-      // embed the id of the scan from which the quantitative information was extracted
-      cf.setMetaValue("scan_id", it->getNativeID());
-      // ...as well as additional meta information
-      cf.setMetaValue("precursor_intensity", it->getPrecursors()[0].getIntensity());
+        // check if we keep this feature or if it contains low-intensity quantifications
+        if (remove_low_intensity_quantifications_ && hasLowIntensityReporter_(cf))
+        {
+          continue;
+        }
 
-      cf.setCharge(it->getPrecursors()[0].getCharge());
-      cf.setIntensity(overall_intensity);
-      consensus_map.push_back(cf);
+        // check featureHandles are not empty
+        if (overall_intensity <= 0)
+        {
+          cf.setMetaValue("all_empty", String("true"));
+        }
+        // add purity information if we could compute it
+        if (quant.precursor_purity > 0.0)
+        {
+          cf.setMetaValue("precursor_purity", quant.precursor_purity);
+        }
+
+        // embed the id of the scan from which the quantitative information was extracted
+        cf.setMetaValue("scan_id", msn.getNativeID());
+        // ...as well as additional meta information
+        cf.setMetaValue("precursor_intensity", msn.getPrecursors()[0].getIntensity());
+
+        cf.setCharge(msn.getPrecursors()[0].getCharge());
+        cf.setIntensity(overall_intensity);
+        consensus_map.push_back(cf);
 
-      // the tandem-scan in the order they appear in the experiment
-      ++element_index;
-    } // ! Experiment iterator
+        // the tandem-scan in the order they appear in the experiment
+        ++element_index;
+      }
+    }
 
     // print stats about m/z calibration / presence of signal
     OPENMS_LOG_INFO << "Calibration stats: Median distance of observed reporter ions m/z to expected position (up to " << qc_dist_mz << " Th):\n";
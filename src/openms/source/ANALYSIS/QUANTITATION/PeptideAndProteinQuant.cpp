@@ -36,6 +36,10 @@
 #include <OpenMS/ANALYSIS/QUANTITATION/PeptideAndProteinQuant.h>
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
 
+#include <boost/functional/hash.hpp>
+
+#include <cstdint>
+
 using namespace std;
 
 namespace OpenMS
@@ -75,25 +79,86 @@ namespace OpenMS
     vector<PeptideIdentification>& peptides)
   {
     // TODO FRACTION: map ids to fractions
-    const int fraction = 1; //TODO: determine from ID?
+    // (identifications are counted in the first fraction, see "finishQuantData")
     for (auto & pep : peptides)
     {
       if (!pep.getHits().empty())
       {
         pep.sort();
         const PeptideHit& hit = pep.getHits()[0]; // get best hit
-        PeptideData& data = pep_quant_[hit.getSequence()];
+        PeptideAccumulator_& data = getAccumulator_(hit.getSequence());
         data.id_count++;
-        data.abundances[fraction][hit.getCharge()]; // insert empty element for charge
+        // remember charge (inserted as empty element later):
+        if (find(data.id_charges.begin(), data.id_charges.end(), hit.getCharge()) == data.id_charges.end())
+        {
+          data.id_charges.push_back(hit.getCharge());
+        }
 
         // add protein accessions:
-        set<String> protein_accessions = hit.extractProteinAccessionsSet();
-        data.accessions.insert(protein_accessions.begin(), protein_accessions.end());
+        for (const String& acc : hit.extractProteinAccessionsSet())
+        {
+          Size acc_index = accession_index_.insert(make_pair(acc, accession_index_.size())).first->second;
+          auto acc_it = lower_bound(data.accessions.begin(), data.accessions.end(), acc_index);
+          if ((acc_it == data.accessions.end()) || (*acc_it != acc_index))
+          {
+            data.accessions.insert(acc_it, acc_index);
+          }
+        }
       }
     }
   }
 
 
+  std::size_t PeptideAndProteinQuant::SequenceHash_::operator()(const AASequence& sequence) const
+  {
+    // residues (including modified ones) are unique objects in ResidueDB, so
+    // their addresses identify them:
+    std::size_t seed = 0;
+    for (const Residue& residue : sequence)
+    {
+      boost::hash_combine(seed, &residue);
+    }
+    boost::hash_combine(seed, sequence.getNTerminalModification());
+    boost::hash_combine(seed, sequence.getCTerminalModification());
+    return seed;
+  }
+
+
+  PeptideAndProteinQuant::PeptideAccumulator_& PeptideAndProteinQuant::getAccumulator_(const AASequence& seq)
+  {
+    auto pos = peptide_index_.insert(make_pair(seq, pep_accumulators_.size()));
+    if (pos.second) pep_accumulators_.push_back(PeptideAccumulator_()); // new peptide
+    return pep_accumulators_[pos.first->second];
+  }
+
+
+  UInt64 PeptideAndProteinQuant::abundanceKey_(size_t fraction, Int charge, size_t sample)
+  {
+    if ((fraction > numeric_limits<uint16_t>::max()) ||
+        (charge < numeric_limits<int16_t>::min()) || (charge > numeric_limits<int16_t>::max()) ||
+        (sample > numeric_limits<uint32_t>::max()))
+    {
+      throw Exception::OutOfRange(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
+    }
+    return (UInt64(fraction) << 48) | (UInt64(uint16_t(int16_t(charge))) << 32) | UInt64(sample);
+  }
+
+
+  void PeptideAndProteinQuant::addAbundance_(const AASequence& seq, size_t fraction, Int charge, size_t sample, double abundance)
+  {
+    PeptideAccumulator_& data = getAccumulator_(seq);
+    const UInt64 key = abundanceKey_(fraction, charge, sample);
+    auto key_it = lower_bound(data.abundance_keys.begin(), data.abundance_keys.end(), key);
+    Size index = key_it - data.abundance_keys.begin();
+    if ((key_it == data.abundance_keys.end()) || (*key_it != key)) // new entry
+    {
+      data.abundance_keys.insert(key_it, key);
+      data.abundances.insert(data.abundances.begin() + index, 0.0);
+    }
+    data.abundances[index] += abundance;
+  }
+
+
   PeptideHit PeptideAndProteinQuant::getAnnotation_(
     vector<PeptideIdentification>& peptides)
   {
@@ -127,8 +192,7 @@ namespace OpenMS
 
     stats_.quant_features++;
     const AASequence& seq = hit.getSequence();
-    pep_quant_[seq].abundances[fraction][hit.getCharge()][sample] +=
-      feature.getIntensity(); // new map element is initialized with 0
+    addAbundance_(seq, fraction, hit.getCharge(), sample, feature.getIntensity());
   }
 
 
@@ -393,11 +457,24 @@ namespace OpenMS
     bool include_all = param_.getValue("include_all") == "true";
     bool fix_peptides = param_.getValue("consensus:fix_peptides") == "true";
 
-    for (auto & prot_q : prot_quant_)
+    // proteins are independent of each other, so we can roll up in parallel
+    vector<ProteinQuant::iterator> prot_its;
+    prot_its.reserve(prot_quant_.size());
+    for (ProteinQuant::iterator it = prot_quant_.begin(); it != prot_quant_.end(); ++it)
+    {
+      prot_its.push_back(it);
+    }
+
+    Size too_few_peptides(0), quant_proteins(0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100) reduction(+: too_few_peptides, quant_proteins)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)prot_its.size(); ++i)
     {
+      ProteinQuant::value_type& prot_q = *prot_its[i];
       if ((top > 0) && (prot_q.second.abundances.size() < top))
       {
-        stats_.too_few_peptides++;
+        too_few_peptides++;
         if (!include_all) { continue; } // not enough proteotypic peptides
       }
 
@@ -485,13 +562,15 @@ namespace OpenMS
       // update statistics:
       if (prot_q.second.total_abundances.empty()) 
       { 
-        stats_.too_few_peptides++; 
+        too_few_peptides++; 
       }
       else 
       {
-        stats_.quant_proteins++;
+        quant_proteins++;
       }
     }
+    stats_.too_few_peptides += too_few_peptides;
+    stats_.quant_proteins += quant_proteins;
   }
 
 
@@ -499,14 +578,63 @@ namespace OpenMS
   void PeptideAndProteinQuant::readQuantData(
     FeatureMap& features,
     const ExperimentalDesign& ed)
+  {
+    startQuantData(ed);
+    stats_.n_fractions = 1;
+
+    const size_t fraction(1), sample(1);
+    addFeatures_(features, fraction, sample);
+    finishQuantData();
+  }
+
+
+  void PeptideAndProteinQuant::readQuantData(
+    ConsensusMap& consensus, 
+    const ExperimentalDesign& ed)
+  {
+    if (consensus.empty())
+    {
+      updateMembers_(); // clear data
+      OPENMS_LOG_ERROR << "Empty consensus map passed to readQuantData." << endl;
+      return;
+    }
+
+    startQuantData(ed);
+    addQuantData(consensus);
+    finishQuantData();
+  }
+
+
+  void PeptideAndProteinQuant::startQuantData(const ExperimentalDesign& ed)
   {
     updateMembers_(); // clear data
 
+    design_ = ed;
     stats_.n_samples = ed.getNumberOfSamples();
-    stats_.n_fractions = 1;
+    stats_.n_fractions = ed.getNumberOfFractions();
     stats_.n_ms_files = ed.getNumberOfMSFiles();
 
-    stats_.total_features = features.size();
+    OPENMS_LOG_DEBUG << "Reading quant data: " << endl;
+    OPENMS_LOG_DEBUG << "  MS files        : " << stats_.n_ms_files << endl;
+    OPENMS_LOG_DEBUG << "  Fractions       : " << stats_.n_fractions << endl;
+    OPENMS_LOG_DEBUG << "  Samples (Assays): " << stats_.n_samples << endl;
+  }
+
+
+  void PeptideAndProteinQuant::addQuantData(FeatureMap& features, Size ms_file_row)
+  {
+    const ExperimentalDesign::MSFileSection& run_section = design_.getMSFileSection();
+    if (ms_file_row >= run_section.size())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, ms_file_row, run_section.size());
+    }
+    addFeatures_(features, run_section[ms_file_row].fraction, run_section[ms_file_row].sample);
+  }
+
+
+  void PeptideAndProteinQuant::addFeatures_(FeatureMap& features, size_t fraction, size_t sample)
+  {
+    stats_.total_features += features.size();
 
     for (auto & f : features)
     {
@@ -518,37 +646,17 @@ namespace OpenMS
       countPeptides_(f.getPeptideIdentifications());
       PeptideHit hit = getAnnotation_(f.getPeptideIdentifications());
       FeatureHandle handle(0, f);
-      const size_t fraction(1), sample(1);
       quantifyFeature_(handle, fraction, sample, hit); // updates "stats_.quant_features"
     }
     countPeptides_(features.getUnassignedPeptideIdentifications());
-    stats_.total_peptides = pep_quant_.size();
     stats_.ambig_features = stats_.total_features - stats_.blank_features -
                             stats_.quant_features;
   }
 
 
-  void PeptideAndProteinQuant::readQuantData(
-    ConsensusMap& consensus, 
-    const ExperimentalDesign& ed)
+  void PeptideAndProteinQuant::addQuantData(ConsensusMap& consensus, Size first_ms_file_row)
   {
-    updateMembers_(); // clear data
-
-    if (consensus.empty())
-    {
-      OPENMS_LOG_ERROR << "Empty consensus map passed to readQuantData." << endl;
-      return;
-    }
-
-    stats_.n_samples = ed.getNumberOfSamples();
-    stats_.n_fractions = ed.getNumberOfFractions();
-    stats_.n_ms_files = ed.getNumberOfMSFiles();
-
-    OPENMS_LOG_DEBUG << "Reading quant data: " << endl;
-    OPENMS_LOG_DEBUG << "  MS files        : " << stats_.n_ms_files << endl;
-    OPENMS_LOG_DEBUG << "  Fractions       : " << stats_.n_fractions << endl;
-    OPENMS_LOG_DEBUG << "  Samples (Assays): " << stats_.n_samples << endl;
-
+    const ExperimentalDesign::MSFileSection& run_section = design_.getMSFileSection();
     for (auto & c : consensus)
     {
       stats_.total_features += c.getFeatures().size();
@@ -567,29 +675,68 @@ namespace OpenMS
         // indices in experimental design are 1-based (as in text file)
         // so we need to convert between them
         //TODO MULTIPLEXED: needs to be adapted for multiplexed experiments
-        size_t row = f.getMapIndex();
-        size_t fraction = ed.getMSFileSection()[row].fraction;
-        size_t sample = ed.getMSFileSection()[row].sample;
+        size_t row = first_ms_file_row + f.getMapIndex();
+        if (row >= run_section.size())
+        {
+          throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, row, run_section.size());
+        }
+        size_t fraction = run_section[row].fraction;
+        size_t sample = run_section[row].sample;
         quantifyFeature_(f, fraction, sample, hit); // updates "stats_.quant_features"
       }
     }
     countPeptides_(consensus.getUnassignedPeptideIdentifications());
-    stats_.total_peptides = pep_quant_.size();
     stats_.ambig_features = stats_.total_features - stats_.blank_features -
                             stats_.quant_features;
   }
 
 
+  void PeptideAndProteinQuant::finishQuantData()
+  {
+    // accessions by index (pointing to the keys of "accession_index_"):
+    vector<const String*> accessions(accession_index_.size());
+    for (const auto& acc : accession_index_)
+    {
+      accessions[acc.second] = &acc.first;
+    }
+
+    // fold the accumulators into the results, releasing them as we go:
+    for (auto pep_it = peptide_index_.begin(); pep_it != peptide_index_.end(); pep_it = peptide_index_.erase(pep_it))
+    {
+      PeptideAccumulator_& acc = pep_accumulators_[pep_it->second];
+      PeptideData& data = pep_quant_[pep_it->first];
+      data.id_count += acc.id_count;
+      for (Int charge : acc.id_charges)
+      {
+        data.abundances[1][charge]; // insert empty element for charge
+      }
+      for (Size i = 0; i < acc.abundance_keys.size(); ++i)
+      {
+        const UInt64 key = acc.abundance_keys[i];
+        Int fraction = Int(key >> 48);
+        Int charge = int16_t(uint16_t(key >> 32));
+        UInt64 sample = key & numeric_limits<uint32_t>::max();
+        data.abundances[fraction][charge][sample] += acc.abundances[i];
+      }
+      for (Size acc_index : acc.accessions)
+      {
+        data.accessions.insert(*accessions[acc_index]);
+      }
+      acc = PeptideAccumulator_();
+    }
+    vector<PeptideAccumulator_>().swap(pep_accumulators_);
+    unordered_map<String, Size>().swap(accession_index_);
+
+    stats_.total_peptides = pep_quant_.size();
+  }
+
+
   void PeptideAndProteinQuant::readQuantData(
     vector<ProteinIdentification>& proteins,
     vector<PeptideIdentification>& peptides,
     const ExperimentalDesign& ed)
   {
-    updateMembers_(); // clear data
-
-    stats_.n_samples = ed.getNumberOfSamples();
-    stats_.n_fractions = ed.getNumberOfFractions();
-    stats_.n_ms_files = ed.getNumberOfMSFiles();
+    startQuantData(ed);
 
     stats_.total_features = peptides.size();
 
@@ -641,9 +788,9 @@ namespace OpenMS
 
       // TODO MULTIPLEXING: think about how id-based quant is done for SILAC, TMT, etc.
       // count peptides in the different fractions, charge states, and samples
-      pep_quant_[seq].abundances[fraction][hit.getCharge()][sample] += 1;
+      addAbundance_(seq, fraction, hit.getCharge(), sample, 1);
     }
-    stats_.total_peptides = pep_quant_.size();
+    finishQuantData();
   }
 
 
@@ -653,6 +800,10 @@ namespace OpenMS
     stats_ = Statistics();
     pep_quant_.clear();
     prot_quant_.clear();
+    design_ = ExperimentalDesign();
+    peptide_index_.clear();
+    pep_accumulators_.clear();
+    accession_index_.clear();
   }
 
 
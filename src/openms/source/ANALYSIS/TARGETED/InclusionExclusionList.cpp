@@ -83,8 +83,9 @@ namespace OpenMS
       bool mz_as_ppm = (param_.getValue("merge:mz_tol_unit") == "ppm");
 
       WindowDistance_ llc(double(param_.getValue("merge:rt_tol")) * min_to_s_factor, double(param_.getValue("merge:mz_tol")), mz_as_ppm);
+      llc.setWindowBounds(list); // only windows close in RT and m/z are compared
       SingleLinkage sl;
-      DistanceMatrix<float> dist; // will be filled
+      SparseDistanceMatrix dist; // will be filled, only overlapping windows are stored
       ClusterHierarchical ch;
 
       //ch.setThreshold(0.99);
@@ -40,6 +40,8 @@
 #include <OpenMS/CONCEPT/Constants.h>
 #include <OpenMS/DATASTRUCTURES/ListUtilsIO.h>
 
+#include <cmath>
+
 // turn on additional debug output
 // #define DEBUG_OPXLHELPER
 
@@ -53,124 +55,251 @@ namespace OpenMS
   {
     // initialize empty vector for the results
     vector<OPXLDataStructs::XLPrecursor> mass_to_candidates;
+    if (peptides.empty() || spectrum_precursors.empty())
+    {
+      return mass_to_candidates;
+    }
+
+    // peptide masses (sorted) for binary searches and the candidate mass ranges that can match any spectrum precursor
+    vector<double> masses(peptides.size());
+    for (Size i = 0; i < peptides.size(); ++i)
+    {
+      masses[i] = peptides[i].peptide_mass;
+    }
+    const vector<pair<double, double> > windows = precursor_mass_windows(spectrum_precursors, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm);
 
-    double min_precursor = spectrum_precursors[0];
-    double max_precursor = spectrum_precursors[spectrum_precursors.size()-1];
+    // candidates are collected per block of first peptides and concatenated in order afterwards,
+    // so the result does not depend on the number of threads
+    const Size block_size = 1024;
+    const SignedSize block_count = static_cast<SignedSize>((peptides.size() + block_size - 1) / block_size);
+    vector< vector<OPXLDataStructs::XLPrecursor> > block_candidates(block_count);
+    vector< vector<int> > block_correction_positions(block_count);
 
 #ifdef _OPENMP
-#pragma omp parallel for schedule(guided)
+#pragma omp parallel for schedule(dynamic, 1)
 #endif
-    for (SignedSize p1 = 0; p1 < static_cast<SignedSize>(peptides.size()); ++p1)
+    for (SignedSize block = 0; block < block_count; ++block)
     {
-      // get the amino acid sequence of this peptide as a character string
-      String seq_first = peptides[p1].peptide_seq.toUnmodifiedString();
+      vector<OPXLDataStructs::XLPrecursor>& candidates = block_candidates[block];
+      vector<int>& correction_positions = block_correction_positions[block];
+      const Size block_end = min(peptides.size(), (block + 1) * block_size);
 
-      // generate mono-links: one cross-linker with one peptide attached to one side
-      for (Size i = 0; i < cross_link_mass_mono_link.size(); i++)
+      for (Size p1 = block * block_size; p1 < block_end; ++p1)
       {
-        // Monoisotopic weight of the peptide + cross-linker
-        double cross_linked_pair_mass = peptides[p1].peptide_mass + cross_link_mass_mono_link[i];
-
-        // Make sure it is clear only one peptide is considered here. Use an out-of-range value for the second peptide.
-        // to check: if(precursor.beta_index < peptides.size()) returns "false" for a mono-link
-        OPXLDataStructs::XLPrecursor precursor;
-        precursor.precursor_mass = cross_linked_pair_mass;
-        precursor.alpha_index = p1;
-        precursor.beta_index = peptides.size() + 1; // an out-of-range index to represent an empty index
-
-        // call function to compare with spectrum precursor masses
-        // will only add this candidate, if the mass is within the given tolerance to any precursor in the spectra data
-        // after the first monolink is added, stop enumerating masses (if other candidates fit within the same precursor, they will have exactly the same fragment matching)
-        if (filter_and_add_candidate(mass_to_candidates, spectrum_precursors, precursor_correction_positions, precursor_mass_tolerance_unit_ppm, precursor_mass_tolerance, precursor))
+        // generate mono-links: one cross-linker with one peptide attached to one side
+        for (Size i = 0; i < cross_link_mass_mono_link.size(); i++)
         {
-          break;
+          // Monoisotopic weight of the peptide + cross-linker
+          double cross_linked_pair_mass = masses[p1] + cross_link_mass_mono_link[i];
+          if (!in_mass_windows(windows, cross_linked_pair_mass))
+          {
+            continue;
+          }
+
+          // Make sure it is clear only one peptide is considered here. Use an out-of-range value for the second peptide.
+          // to check: if(precursor.beta_index < peptides.size()) returns "false" for a mono-link
+          OPXLDataStructs::XLPrecursor precursor;
+          precursor.precursor_mass = cross_linked_pair_mass;
+          precursor.alpha_index = p1;
+          precursor.beta_index = peptides.size() + 1; // an out-of-range index to represent an empty index
+
+          // call function to compare with spectrum precursor masses
+          // will only add this candidate, if the mass is within the given tolerance to any precursor in the spectra data
+          // after the first monolink is added, stop enumerating masses (if other candidates fit within the same precursor, they will have exactly the same fragment matching)
+          if (filter_and_add_candidate(candidates, spectrum_precursors, correction_positions, precursor_mass_tolerance_unit_ppm, precursor_mass_tolerance, precursor))
+          {
+            break;
+          }
         }
-      }
 
-       // test if this peptide could have loop-links: one cross-link with both sides attached to the same peptide
-       // TODO check for distance between the two linked residues
-      bool first_res = false; // is there a residue the first side of the linker can attach to?
-      bool second_res = false; // is there a residue the second side of the linker can attach to?
-      for (Size k = 0; k < seq_first.size()-1; ++k)
-      {
-        for (Size i = 0; i < cross_link_residue1.size(); ++i)
+        // test if this peptide could have loop-links: one cross-link with both sides attached to the same peptide
+        // TODO check for distance between the two linked residues
+        if (in_mass_windows(windows, masses[p1] + cross_link_mass))
         {
-          if (cross_link_residue1[i].size() == 1 && seq_first.substr(k, 1) == cross_link_residue1[i])
+          String seq_first = peptides[p1].peptide_seq.toUnmodifiedString();
+          bool first_res = false; // is there a residue the first side of the linker can attach to?
+          bool second_res = false; // is there a residue the second side of the linker can attach to?
+          for (Size k = 0; k < seq_first.size()-1; ++k)
+          {
+            for (Size i = 0; i < cross_link_residue1.size(); ++i)
+            {
+              if (cross_link_residue1[i].size() == 1 && seq_first.substr(k, 1) == cross_link_residue1[i])
+              {
+                first_res = true;
+              }
+            }
+            for (Size i = 0; i < cross_link_residue2.size(); ++i)
+            {
+              if (cross_link_residue2[i].size() == 1 && seq_first.substr(k, 1) == cross_link_residue2[i])
+              {
+                second_res = true;
+              }
+            }
+          }
+
+          // If both sides of a cross-linker can link to this peptide, generate the loop-link
+          if (first_res && second_res)
           {
-            first_res = true;
+            // also only one peptide
+            OPXLDataStructs::XLPrecursor precursor;
+            precursor.precursor_mass = masses[p1] + cross_link_mass;
+            precursor.alpha_index = p1;
+            precursor.beta_index = peptides.size() + 1; // an out-of-range index to represent an empty index
+
+            // call function to compare with spectrum precursor masses
+            filter_and_add_candidate(candidates, spectrum_precursors, correction_positions, precursor_mass_tolerance_unit_ppm, precursor_mass_tolerance, precursor);
           }
         }
-        for (Size i = 0; i < cross_link_residue2.size(); ++i)
+
+        // Generate cross-links: one cross-linker linking two separate peptides, the most important case
+        // The second peptide comes after p1 in the list, so only windows above twice the mass of p1 are relevant.
+        // For each window, the second peptides are looked up by binary search instead of scanning the list.
+        vector<pair<double, double> >::const_iterator window = lower_bound(windows.begin(), windows.end(), 2 * masses[p1] + cross_link_mass,
+          [](const pair<double, double>& w, double mass) { return w.second < mass; });
+        for (; window != windows.end(); ++window)
         {
-          if (cross_link_residue2[i].size() == 1 && seq_first.substr(k, 1) == cross_link_residue2[i])
+          vector<double>::const_iterator first = lower_bound(masses.begin() + p1, masses.end(), window->first - cross_link_mass - masses[p1]);
+          vector<double>::const_iterator last = upper_bound(first, masses.cend(), window->second - cross_link_mass - masses[p1]);
+          for (; first != last; ++first)
           {
-            second_res = true;
+            const Size p2 = first - masses.begin();
+
+            // this time both peptides have valid indices
+            OPXLDataStructs::XLPrecursor precursor;
+            precursor.precursor_mass = masses[p1] + masses[p2] + cross_link_mass;
+            precursor.alpha_index = p1;
+            precursor.beta_index = p2;
+
+            // call function to compare with spectrum precursor masses
+            filter_and_add_candidate(candidates, spectrum_precursors, correction_positions, precursor_mass_tolerance_unit_ppm, precursor_mass_tolerance, precursor);
           }
         }
       }
+    } // end of parallelized for-loop
 
-      // If both sides of a cross-linker can link to this peptide, generate the loop-link
-      if (first_res && second_res)
-      {
-        // Monoisotopic weight of the peptide + cross-linker
-        double cross_linked_pair_mass = peptides[p1].peptide_mass + cross_link_mass;
+    for (SignedSize block = 0; block < block_count; ++block)
+    {
+      mass_to_candidates.insert(mass_to_candidates.end(), block_candidates[block].begin(), block_candidates[block].end());
+      precursor_correction_positions.insert(precursor_correction_positions.end(), block_correction_positions[block].begin(), block_correction_positions[block].end());
+    }
+    return mass_to_candidates;
+  }
 
-        // also only one peptide
-        OPXLDataStructs::XLPrecursor precursor;
-        precursor.precursor_mass = cross_linked_pair_mass;
-        precursor.alpha_index = p1;
-        precursor.beta_index = peptides.size() + 1; // an out-of-range index to represent an empty index
+  vector<OPXLDataStructs::XLPrecursor> OPXLHelper::enumerateCrossLinksAlphaFirst(const vector<OPXLDataStructs::AASeqWithMass>& peptides, double cross_link_mass, const vector< double >& alpha_masses, double alpha_mass_tolerance, bool alpha_mass_tolerance_unit_ppm, const vector< double >& spectrum_precursors, vector< int >& precursor_correction_positions, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm)
+  {
+    vector<OPXLDataStructs::XLPrecursor> mass_to_candidates;
+    if (peptides.empty() || spectrum_precursors.empty())
+    {
+      return mass_to_candidates;
+    }
 
-        // call function to compare with spectrum precursor masses
-        filter_and_add_candidate(mass_to_candidates, spectrum_precursors, precursor_correction_positions, precursor_mass_tolerance_unit_ppm, precursor_mass_tolerance, precursor);
-      }
+    vector<double> masses(peptides.size());
+    for (Size i = 0; i < peptides.size(); ++i)
+    {
+      masses[i] = peptides[i].peptide_mass;
+    }
+    const vector<pair<double, double> > windows = precursor_mass_windows(spectrum_precursors, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm);
 
-      // check for minimal mass of second peptide, jump farther than current peptide if possible
-      double allowed_error = 0;
-      if (precursor_mass_tolerance_unit_ppm) // ppm
-      {
-        allowed_error = min_precursor * precursor_mass_tolerance * 1e-6;
-      }
-      else // Dalton
+    // peptide pairs (smaller index first), one of them matching an observed alpha mass, the other one the remaining precursor mass
+    vector< pair<Size, Size> > pairs;
+    for (double alpha_mass : alpha_masses)
+    {
+      const double allowed_error = alpha_mass_tolerance_unit_ppm ? alpha_mass * alpha_mass_tolerance * 1e-6 : alpha_mass_tolerance;
+      Size alpha_begin = lower_bound(masses.begin(), masses.end(), alpha_mass - allowed_error) - masses.begin();
+      Size alpha_end = upper_bound(masses.begin(), masses.end(), alpha_mass + allowed_error) - masses.begin();
+      for (Size alpha = alpha_begin; alpha < alpha_end; ++alpha)
       {
-        allowed_error = precursor_mass_tolerance;
+        for (const pair<double, double>& window : windows)
+        {
+          vector<double>::const_iterator first = lower_bound(masses.begin(), masses.end(), window.first - cross_link_mass - masses[alpha]);
+          vector<double>::const_iterator last = upper_bound(first, masses.cend(), window.second - cross_link_mass - masses[alpha]);
+          for (; first != last; ++first)
+          {
+            const Size beta = first - masses.begin();
+            pairs.push_back(make_pair(min(alpha, beta), max(alpha, beta)));
+          }
+        }
       }
-      double min_second_peptide_mass = min_precursor - cross_link_mass - peptides[p1].peptide_mass - allowed_error;
+    }
+    sort(pairs.begin(), pairs.end());
+    pairs.erase(unique(pairs.begin(), pairs.end()), pairs.end());
 
-      if (precursor_mass_tolerance_unit_ppm) // ppm
-      {
-        allowed_error = max_precursor * precursor_mass_tolerance * 1e-6;
-      }
-      double max_second_peptide_mass = max_precursor - cross_link_mass - peptides[p1].peptide_mass + allowed_error;
+    for (const pair<Size, Size>& candidate : pairs)
+    {
+      OPXLDataStructs::XLPrecursor precursor;
+      precursor.precursor_mass = masses[candidate.first] + masses[candidate.second] + cross_link_mass;
+      precursor.alpha_index = candidate.first;
+      precursor.beta_index = candidate.second;
+      filter_and_add_candidate(mass_to_candidates, spectrum_precursors, precursor_correction_positions, precursor_mass_tolerance_unit_ppm, precursor_mass_tolerance, precursor);
+    }
+    return mass_to_candidates;
+  }
+
+  vector< double > OPXLHelper::findSignatureDoubletMasses(const PeakSpectrum& spectrum, const DoubleList& stub_masses, Int max_charge, double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm)
+  {
+    vector< double > peptide_masses;
+    if ((stub_masses.size() != 2) || (stub_masses[0] == stub_masses[1]))
+    {
+      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Exactly two different stub masses are required.");
+    }
+    const double stub_light = std::min(stub_masses[0], stub_masses[1]);
+    const double stub_delta = std::fabs(stub_masses[1] - stub_masses[0]);
 
-      // Generate cross-links: one cross-linker linking two separate peptides, the most important case
-      // Loop over all p2 peptide candidates, that come after p1 in the list
-      for (Size p2 = p1; p2 < peptides.size(); ++p2)
+    for (Int charge = 1; charge <= max_charge; ++charge)
+    {
+      for (PeakSpectrum::ConstIterator peak = spectrum.begin(); peak != spectrum.end(); ++peak)
       {
-        // skip peptides, that are too small in any case
-        if (peptides[p2].peptide_mass < min_second_peptide_mass)
-        {
-          continue;
-        }
-        else if (peptides[p2].peptide_mass > max_second_peptide_mass)
+        const double partner_mz = peak->getMZ() + stub_delta / static_cast<double>(charge);
+        const double allowed_error = fragment_mass_tolerance_unit_ppm ? partner_mz * fragment_mass_tolerance * 1e-6 : fragment_mass_tolerance;
+        PeakSpectrum::ConstIterator partner = spectrum.MZBegin(peak, partner_mz - allowed_error, spectrum.end());
+        if (partner != spectrum.end() && partner->getMZ() <= partner_mz + allowed_error)
         {
-          break;
+          peptide_masses.push_back((peak->getMZ() - Constants::PROTON_MASS_U) * static_cast<double>(charge) - stub_light);
         }
+      }
+    }
+    sort(peptide_masses.begin(), peptide_masses.end());
+    peptide_masses.erase(unique(peptide_masses.begin(), peptide_masses.end()), peptide_masses.end());
+    return peptide_masses;
+  }
 
-        // Monoisotopic weight of the first peptide + the second peptide + cross-linker
-        double cross_linked_pair_mass = peptides[p1].peptide_mass + peptides[p2].peptide_mass + cross_link_mass;
+  vector< pair<double, double> > OPXLHelper::precursor_mass_windows(const vector< double >& spectrum_precursors, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm)
+  {
+    vector<double> sorted_precursors(spectrum_precursors);
+    sort(sorted_precursors.begin(), sorted_precursors.end());
 
-        // this time both peptides have valid indices
-        OPXLDataStructs::XLPrecursor precursor;
-        precursor.precursor_mass = cross_linked_pair_mass;
-        precursor.alpha_index = p1;
-        precursor.beta_index = p2;
+    vector< pair<double, double> > windows;
+    for (double precursor_mass : sorted_precursors)
+    {
+      // a candidate mass m matches, if |m - precursor_mass| <= allowed error, where a relative error refers to m
+      double low = precursor_mass - precursor_mass_tolerance;
+      double high = precursor_mass + precursor_mass_tolerance;
+      if (precursor_mass_tolerance_unit_ppm) // ppm
+      {
+        low = precursor_mass / (1 + precursor_mass_tolerance * 1e-6);
+        high = precursor_mass / (1 - precursor_mass_tolerance * 1e-6);
+      }
+      // widen by 1 ppm, candidate masses are stored as float and filter_and_add_candidate does the exact comparison
+      low -= std::fabs(low) * 1e-6;
+      high += std::fabs(high) * 1e-6;
 
-        // call function to compare with spectrum precursor masses
-        filter_and_add_candidate(mass_to_candidates, spectrum_precursors, precursor_correction_positions, precursor_mass_tolerance_unit_ppm, precursor_mass_tolerance, precursor);
+      if (!windows.empty() && low <= windows.back().second)
+      {
+        windows.back().second = max(windows.back().second, high);
       }
-    } // end of parallelized for-loop
-    return mass_to_candidates;
+      else
+      {
+        windows.push_back(make_pair(low, high));
+      }
+    }
+    return windows;
+  }
+
+  bool OPXLHelper::in_mass_windows(const vector< pair<double, double> >& windows, double mass)
+  {
+    vector<pair<double, double> >::const_iterator window = lower_bound(windows.begin(), windows.end(), mass,
+      [](const pair<double, double>& w, double m) { return w.second < m; });
+    return window != windows.end() && window->first <= mass;
   }
 
   bool OPXLHelper::filter_and_add_candidate(vector<OPXLDataStructs::XLPrecursor>& mass_to_candidates, const vector< double >& spectrum_precursors, vector< int >& precursor_correction_positions, bool precursor_mass_tolerance_unit_ppm, double precursor_mass_tolerance, OPXLDataStructs::XLPrecursor precursor)
@@ -197,12 +326,10 @@ namespace OpenMS
 
     if (low_it != up_it) // if they are not equal, there are matching precursors in the data
     {
-#pragma omp critical (mass_to_candidates_access)
-      {
-        mass_to_candidates.push_back(precursor);
-        // take the position of the highest matching precursor mass in the vector (prioritize smallest correction)
-        precursor_correction_positions.push_back(std::distance(spectrum_precursors.begin(), std::prev(up_it, 1)));
-      }
+      // the result vectors are local to the calling thread
+      mass_to_candidates.push_back(precursor);
+      // take the position of the highest matching precursor mass in the vector (prioritize smallest correction)
+      precursor_correction_positions.push_back(std::distance(spectrum_precursors.begin(), std::prev(up_it, 1)));
       return true;
     }
     else
@@ -1262,7 +1389,7 @@ namespace OpenMS
     return new_peptide_ids;
   }
 
-  std::vector <OPXLDataStructs::ProteinProteinCrossLink> OPXLHelper::collectPrecursorCandidates(const IntList& precursor_correction_steps, double precursor_mass, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm, const vector<OPXLDataStructs::AASeqWithMass>& filtered_peptide_masses, double cross_link_mass, DoubleList cross_link_mass_mono_link, StringList cross_link_residue1, StringList cross_link_residue2, String cross_link_name)
+  std::vector <OPXLDataStructs::ProteinProteinCrossLink> OPXLHelper::collectPrecursorCandidates(const IntList& precursor_correction_steps, double precursor_mass, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm, const vector<OPXLDataStructs::AASeqWithMass>& filtered_peptide_masses, double cross_link_mass, DoubleList cross_link_mass_mono_link, StringList cross_link_residue1, StringList cross_link_residue2, String cross_link_name, const vector< double >& alpha_masses, double alpha_mass_tolerance, bool alpha_mass_tolerance_unit_ppm)
   {
     // determine candidates
     std::vector< OPXLDataStructs::XLPrecursor > candidates;
@@ -1291,7 +1418,14 @@ namespace OpenMS
     } // end correction mass loop
 
     std::vector< int > precursor_correction_positions;
-    candidates = OPXLHelper::enumerateCrossLinksAndMasses(filtered_peptide_masses, cross_link_mass, cross_link_mass_mono_link, cross_link_residue1, cross_link_residue2, spectrum_precursor_vector, precursor_correction_positions, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm);
+    if (alpha_masses.empty())
+    {
+      candidates = OPXLHelper::enumerateCrossLinksAndMasses(filtered_peptide_masses, cross_link_mass, cross_link_mass_mono_link, cross_link_residue1, cross_link_residue2, spectrum_precursor_vector, precursor_correction_positions, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm);
+    }
+    else // pre-filter: one of the peptides has to match an observed mass
+    {
+      candidates = OPXLHelper::enumerateCrossLinksAlphaFirst(filtered_peptide_masses, cross_link_mass, alpha_masses, alpha_mass_tolerance, alpha_mass_tolerance_unit_ppm, spectrum_precursor_vector, precursor_correction_positions, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm);
+    }
 
     vector< int > precursor_corrections;
     for (Size pc = 0; pc < precursor_correction_positions.size(); ++pc)
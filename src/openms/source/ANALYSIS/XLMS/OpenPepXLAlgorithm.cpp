@@ -114,6 +114,7 @@ using namespace OpenMS;
     defaults_.setValue("cross_linker:mass_iso_shift", 12.075321, "Mass of the isotopic shift between the light and heavy linkers");
     defaults_.setValue("cross_linker:mass_mono_link", ListUtils::create<double>("156.07864431, 155.094628715"), "Possible masses of the linker, when attached to only one peptide");
     defaults_.setValue("cross_linker:name", "DSS", "Name of the searched cross-link, used to resolve ambiguity of equal masses (e.g. DSS or BS3)");
+    defaults_.setValue("cross_linker:ms_cleavable_stub_masses", DoubleList(), "For MS-cleavable cross-linkers: masses of the two remnants (stubs) of the linker on a peptide after cleavage in MS/MS (e.g. '54.01056, 85.98264' for DSSO). If set, only cross-links with one peptide matching a signature ion doublet in the MS/MS spectrum are considered (alpha first pre-filter, no mono-links or loop-links). Spectra without doublets are searched without the pre-filter.", ListUtils::create<String>("advanced"));
     defaults_.setSectionDescription("cross_linker", "Description of the cross-linker reagent");
 
     defaults_.setValue("algorithm:number_top_hits", 5, "Number of top hits reported for each spectrum pair");
@@ -166,6 +167,7 @@ using namespace OpenMS;
     cross_link_mass_iso_shift_ = static_cast<double>(param_.getValue("cross_linker:mass_iso_shift"));
     cross_link_mass_mono_link_ = param_.getValue("cross_linker:mass_mono_link");
     cross_link_name_ = static_cast<String>(param_.getValue("cross_linker:name"));
+    cross_link_stub_masses_ = param_.getValue("cross_linker:ms_cleavable_stub_masses");
 
     fixedModNames_ = param_.getValue("modifications:fixed");
     varModNames_ = param_.getValue("modifications:variable");
@@ -217,6 +219,12 @@ using namespace OpenMS;
       return ExitCodes::ILLEGAL_PARAMETERS;
     }
 
+    if (!cross_link_stub_masses_.empty() && ((cross_link_stub_masses_.size() != 2) || (cross_link_stub_masses_[0] == cross_link_stub_masses_[1])))
+    {
+      OPENMS_LOG_ERROR << "Exactly two different masses are required for 'cross_linker:ms_cleavable_stub_masses'." << endl;
+      return ExitCodes::ILLEGAL_PARAMETERS;
+    }
+
     set<String> var_unique(varModNames_.begin(), varModNames_.end());
     if (var_unique.size() != varModNames_.size())
     {
@@ -457,7 +465,15 @@ using namespace OpenMS;
         continue;
       }
 
-      vector <OPXLDataStructs::ProteinProteinCrossLink> cross_link_candidates = OPXLHelper::collectPrecursorCandidates(precursor_correction_steps_, precursor_mass, precursor_mass_tolerance_, precursor_mass_tolerance_unit_ppm_, filtered_peptide_masses, cross_link_mass_light_, cross_link_mass_mono_link_, cross_link_residue1_, cross_link_residue2_, cross_link_name_);
+      // alpha first pre-filter for MS-cleavable cross-linkers
+      vector< double > alpha_masses;
+      if (!cross_link_stub_masses_.empty())
+      {
+        alpha_masses = OPXLHelper::findSignatureDoubletMasses(spectrum_light, cross_link_stub_masses_, static_cast<Int>(precursor_charge), fragment_mass_tolerance_xlinks_, fragment_mass_tolerance_unit_ppm_);
+      }
+      // the mass error of a peptide (in Da) grows with the charge of its signature ions
+      const double alpha_mass_tolerance = fragment_mass_tolerance_unit_ppm_ ? fragment_mass_tolerance_xlinks_ : fragment_mass_tolerance_xlinks_ * precursor_charge;
+      vector <OPXLDataStructs::ProteinProteinCrossLink> cross_link_candidates = OPXLHelper::collectPrecursorCandidates(precursor_correction_steps_, precursor_mass, precursor_mass_tolerance_, precursor_mass_tolerance_unit_ppm_, filtered_peptide_masses, cross_link_mass_light_, cross_link_mass_mono_link_, cross_link_residue1_, cross_link_residue2_, cross_link_name_, alpha_masses, alpha_mass_tolerance, fragment_mass_tolerance_unit_ppm_);
 
 
 #ifdef _OPENMP
@@ -35,6 +35,7 @@
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
 
 #include <OpenMS/SYSTEM/File.h>
+#include <OpenMS/SYSTEM/Profiler.h>
 #include <OpenMS/SYSTEM/StopWatch.h>
 #include <OpenMS/SYSTEM/SysInfo.h>
 #include <OpenMS/SYSTEM/UpdateCheck.h>
@@ -170,6 +171,7 @@ namespace OpenMS
       addText_("Common UTIL options:");
     registerStringOption_("ini", "<file>", "", "Use the given TOPP INI file", false);
     registerStringOption_("log", "<file>", "", "Name of log file (created only when specified)", false, true);
+    registerStringOption_("profile", "<file>", "", "Records timing and memory usage of the processing stages and writes them to the given file (Chrome trace-event JSON for chrome://tracing; flat table if the file ends in '.tsv')", false, true);
     registerIntOption_("instance", "<n>", 1, "Instance number for the TOPP INI file", false, true);
     registerIntOption_("debug", "<n>", 0, "Sets the debug level", false, true);
     registerIntOption_("threads", "<n>", 1, "Sets the number of threads allowed to be used by the TOPP tool", false);
@@ -444,12 +446,34 @@ namespace OpenMS
     //----------------------------------------------------------
     //main
     //----------------------------------------------------------
+    String profile_file;
+    if (param_cmdline_.exists("profile"))
+    {
+      profile_file = param_cmdline_.getValue("profile").toString();
+    }
+    if (!profile_file.empty())
+    {
+      outputFileWritable_(profile_file, "profile");
+      Profiler::clear();
+      Profiler::enable();
+    }
+
     StopWatch sw;
     sw.start();
-    result = main_(argc, argv);
+    {
+      Profiler::Scope tool_span(tool_name_.c_str(), "tool");
+      result = main_(argc, argv);
+    }
     sw.stop();
     OPENMS_LOG_INFO << this->tool_name_ << " took " << sw.toString() << "." << std::endl;
 
+    if (!profile_file.empty())
+    {
+      Profiler::disable();
+      Profiler::write(profile_file);
+      writeDebug_(String("Wrote profile to '") + profile_file + "'", 1);
+    }
+
     // useful for benchmarking
     if (debug_level_ >= 1)
     {
@@ -2077,7 +2101,7 @@ namespace OpenMS
     //parameters
     for (vector<ParameterInformation>::const_iterator it = parameters_.begin(); it != parameters_.end(); ++it)
     {
-      if (it->name == "ini" || it->name == "-help" || it->name == "-helphelp" || it->name == "instance" || it->name == "write_ini" || it->name == "write_ctd") // do not store those params in ini file
+      if (it->name == "ini" || it->name == "-help" || it->name == "-helphelp" || it->name == "instance" || it->name == "write_ini" || it->name == "write_ctd" || it->name == "profile") // do not store those params in ini file
       {
         continue;
       }
@@ -0,0 +1,122 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CHEMISTRY/AASequencePool.h>
+
+#include <algorithm>
+#include <mutex>
+
+namespace OpenMS
+{
+  AASequencePool* AASequencePool::getInstance()
+  {
+    static AASequencePool* pool_ = new AASequencePool;
+    return pool_;
+  }
+
+  AASequencePool::AASequencePool() :
+    purge_threshold_(1024)
+  {
+  }
+
+  AASequencePool::~AASequencePool()
+  {
+  }
+
+  InternedAASequence AASequencePool::intern(const AASequence& sequence)
+  {
+    const String key = sequence.toString();
+    std::lock_guard<std::mutex> lock(mutex_);
+    WeakData_& entry = by_sequence_[key];
+    std::shared_ptr<InternedAASequence::Data_> data = entry.lock();
+    if (data) return InternedAASequence(data);
+
+    InternedAASequence interned = InternedAASequence::createPooled_(sequence);
+    entry = interned.data_;
+    purge_();
+    return interned;
+  }
+
+  InternedAASequence AASequencePool::intern(const String& sequence)
+  {
+    std::shared_ptr<InternedAASequence::Data_> data;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::unordered_map<String, WeakData_>::const_iterator it = by_string_.find(sequence);
+      if (it != by_string_.end())
+      {
+        data = it->second.lock();
+      }
+    }
+    if (data) return InternedAASequence(data);
+
+    // parse without holding the lock:
+    InternedAASequence interned = intern(AASequence::fromString(sequence));
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      by_string_[sequence] = interned.data_;
+    }
+    return interned;
+  }
+
+  Size AASequencePool::size() const
+  {
+    Size count = 0;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : by_sequence_)
+    {
+      if (!entry.second.expired()) ++count;
+    }
+    return count;
+  }
+
+  void AASequencePool::purge_()
+  {
+    // amortized: only sweep when the tables have doubled since the last sweep
+    if (by_sequence_.size() + by_string_.size() < purge_threshold_) return;
+
+    for (auto it = by_sequence_.begin(); it != by_sequence_.end(); )
+    {
+      if (it->second.expired()) it = by_sequence_.erase(it);
+      else ++it;
+    }
+    for (auto it = by_string_.begin(); it != by_string_.end(); )
+    {
+      if (it->second.expired()) it = by_string_.erase(it);
+      else ++it;
+    }
+    purge_threshold_ = std::max(Size(1024), 2 * (by_sequence_.size() + by_string_.size()));
+  }
+
+} // namespace OpenMS
@@ -0,0 +1,227 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CHEMISTRY/InternedAASequence.h>
+
+#include <OpenMS/CHEMISTRY/ResidueDB.h>
+#include <OpenMS/CHEMISTRY/ResidueModification.h>
+#include <OpenMS/CONCEPT/Constants.h>
+
+#include <mutex>
+
+namespace OpenMS
+{
+  struct InternedAASequence::Data_
+  {
+    /// Masses, allocated on first use (most sequences never need them)
+    struct Masses_
+    {
+      explicit Masses_(const AASequence& seq) :
+        unknown_mass(hasUnknownMass(seq)), mono_weight(0.0), average_weight(0.0)
+      {
+      }
+
+      const bool unknown_mass;
+
+      // each computed on first use
+      std::once_flag mono_weight_computed;
+      std::once_flag average_weight_computed;
+      std::once_flag prefix_mono_weights_computed;
+      double mono_weight;
+      double average_weight;
+      std::vector<double> prefix_mono_weights;
+    };
+
+    Data_(const AASequence& seq, bool is_pooled) :
+      sequence(seq), pooled(is_pooled)
+    {
+    }
+
+    Data_(AASequence&& seq, bool is_pooled) :
+      sequence(std::move(seq)), pooled(is_pooled)
+    {
+    }
+
+    /// Checks for unknown residues ('X'), which have no mass
+    static bool hasUnknownMass(const AASequence& seq)
+    {
+      static const Residue* const unknown = ResidueDB::getInstance()->getResidue("X");
+      for (const Residue& residue : seq)
+      {
+        if (&residue == unknown) return true;
+      }
+      return false;
+    }
+
+    /// Returns the masses (allocated if necessary); throws if they are not defined, so the computations in call_once cannot throw
+    Masses_& getMasses() const
+    {
+      std::call_once(masses_allocated, [this]()
+      {
+        masses.reset(new Masses_(sequence));
+      });
+      if (masses->unknown_mass)
+      {
+        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Cannot get weight of sequence with unknown AA 'X' with unknown mass.", sequence.toString());
+      }
+      return *masses;
+    }
+
+    const AASequence sequence;
+    const bool pooled;
+
+    mutable std::once_flag masses_allocated;
+    mutable std::unique_ptr<Masses_> masses;
+  };
+
+  InternedAASequence::InternedAASequence() :
+    data_(emptyData_())
+  {
+  }
+
+  InternedAASequence::InternedAASequence(const AASequence& sequence) :
+    data_(std::make_shared<Data_>(sequence, false))
+  {
+  }
+
+  InternedAASequence::InternedAASequence(AASequence&& sequence) :
+    data_(std::make_shared<Data_>(std::move(sequence), false))
+  {
+  }
+
+  InternedAASequence::InternedAASequence(InternedAASequence&& rhs) noexcept :
+    data_(std::move(rhs.data_))
+  {
+    rhs.data_ = emptyData_();
+  }
+
+  InternedAASequence& InternedAASequence::operator=(InternedAASequence&& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      data_ = std::move(rhs.data_);
+      rhs.data_ = emptyData_();
+    }
+    return *this;
+  }
+
+  InternedAASequence::InternedAASequence(const std::shared_ptr<Data_>& data) :
+    data_(data)
+  {
+  }
+
+  const std::shared_ptr<InternedAASequence::Data_>& InternedAASequence::emptyData_()
+  {
+    static const std::shared_ptr<Data_> empty = std::make_shared<Data_>(AASequence(), false);
+    return empty;
+  }
+
+  InternedAASequence InternedAASequence::createPooled_(const AASequence& sequence)
+  {
+    return InternedAASequence(std::make_shared<Data_>(sequence, true));
+  }
+
+  InternedAASequence::~InternedAASequence()
+  {
+  }
+
+  const AASequence& InternedAASequence::getSequence() const
+  {
+    return data_->sequence;
+  }
+
+  double InternedAASequence::getMonoWeight(Int charge) const
+  {
+    const AASequence& sequence = data_->sequence;
+    if (sequence.empty()) return 0.0;
+    Data_::Masses_& masses = data_->getMasses();
+    std::call_once(masses.mono_weight_computed, [&masses, &sequence]()
+    {
+      masses.mono_weight = sequence.getMonoWeight();
+    });
+    return masses.mono_weight + Constants::PROTON_MASS_U * charge;
+  }
+
+  double InternedAASequence::getAverageWeight() const
+  {
+    const AASequence& sequence = data_->sequence;
+    if (sequence.empty()) return 0.0;
+    Data_::Masses_& masses = data_->getMasses();
+    std::call_once(masses.average_weight_computed, [&masses, &sequence]()
+    {
+      masses.average_weight = sequence.getAverageWeight();
+    });
+    return masses.average_weight;
+  }
+
+  const std::vector<double>& InternedAASequence::getPrefixMonoWeights() const
+  {
+    const AASequence& sequence = data_->sequence;
+    Data_::Masses_& masses = data_->getMasses();
+    std::call_once(masses.prefix_mono_weights_computed, [&masses, &sequence]()
+    {
+      std::vector<double> prefix(1, 0.0);
+      prefix.reserve(sequence.size() + 1);
+      if (sequence.hasNTerminalModification())
+      {
+        prefix[0] = sequence.getNTerminalModification()->getDiffMonoMass();
+      }
+      for (const Residue& residue : sequence)
+      {
+        prefix.push_back(prefix.back() + residue.getMonoWeight(Residue::Internal));
+      }
+      masses.prefix_mono_weights.swap(prefix);
+    });
+    return masses.prefix_mono_weights;
+  }
+
+  bool InternedAASequence::isPooled() const
+  {
+    return data_->pooled;
+  }
+
+  bool InternedAASequence::operator==(const InternedAASequence& rhs) const
+  {
+    if (data_ == rhs.data_) return true;
+    // two different pooled objects never hold the same sequence
+    if (data_->pooled && rhs.data_->pooled) return false;
+    return data_->sequence == rhs.data_->sequence;
+  }
+
+  bool InternedAASequence::operator!=(const InternedAASequence& rhs) const
+  {
+    return !(*this == rhs);
+  }
+
+} // namespace OpenMS
@@ -165,4 +165,15 @@ namespace OpenMS
     endProgress();
   }
 
+  void AverageLinkage::operator()(const SparseDistanceMatrix & distance, std::vector<BinaryTreeNode> & cluster_tree, const float threshold /*=1*/) const
+  {
+    // average linkage: new distance is the average of the old distances weighted by cluster size (lance-williams)
+    clusterSparse_(distance, cluster_tree, threshold, [](float d_a, Size n_a, float d_b, Size n_b)
+    {
+      float alpha_a = (float)(n_a / (float)(n_a + n_b));
+      float alpha_b = (float)(n_b / (float)(n_a + n_b));
+      return alpha_a * d_a + alpha_b * d_b;
+    });
+  }
+
 }
@@ -39,6 +39,11 @@
 #include <OpenMS/COMPARISON/CLUSTERING/AverageLinkage.h>
 #include <OpenMS/CONCEPT/Factory.h>
 
+#include <functional>
+#include <map>
+#include <queue>
+#include <tuple>
+
 using namespace std;
 
 namespace OpenMS
@@ -60,6 +65,121 @@ namespace OpenMS
     return *this;
   }
 
+  void ClusterFunctor::operator()(const SparseDistanceMatrix & /*distance*/, std::vector<BinaryTreeNode> & /*cluster_tree*/, const float /*threshold*/) const
+  {
+    throw Exception::NotImplemented(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
+  }
+
+  void ClusterFunctor::clusterSparse_(const SparseDistanceMatrix & distance, std::vector<BinaryTreeNode> & cluster_tree, const float threshold,
+                                      const std::function<float(float, Size, float, Size)> & update)
+  {
+    // input MUST have >= 2 elements!
+    const Size n = distance.dimensionsize();
+    if (n < 2)
+    {
+      throw ClusterFunctor::InsufficientInput(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Distance matrix to start from only contains one element");
+    }
+
+    const float missing = distance.getMissingValue();
+    const vector<Size> & offsets = distance.getRowOffsets();
+    const vector<Size> & columns = distance.getColumns();
+    const vector<float> & values = distance.getValues();
+
+    // candidate merges (distance, smaller cluster, larger cluster), smallest first
+    typedef tuple<float, Size, Size> Candidate;
+    priority_queue<Candidate, vector<Candidate>, greater<Candidate> > candidates;
+
+    // stored distances of each cluster to its neighbours, clusters are identified by their smallest element
+    vector<map<Size, float> > neighbours(n);
+    for (Size i = 0; i < n; ++i)
+    {
+      for (Size k = offsets[i]; k < offsets[i + 1]; ++k)
+      {
+        neighbours[i].insert(neighbours[i].end(), make_pair(columns[k], values[k]));
+        if (i < columns[k] && values[k] < threshold)
+        {
+          candidates.push(Candidate(values[k], i, columns[k]));
+        }
+      }
+    }
+
+    vector<Size> cluster_size(n, 1);
+    vector<bool> active(n, true);
+
+    cluster_tree.clear();
+    cluster_tree.reserve(n - 1);
+
+    while (!candidates.empty())
+    {
+      const Candidate top = candidates.top();
+      candidates.pop();
+      const float d = get<0>(top);
+      const Size a = get<1>(top);
+      const Size b = get<2>(top);
+
+      // skip outdated candidates
+      if (!active[a] || !active[b]) continue;
+      map<Size, float>::const_iterator current = neighbours[a].find(b);
+      if (current == neighbours[a].end() || current->second != d) continue;
+
+      // merge b into a (a < b, so a stays the smallest element)
+      cluster_tree.push_back(BinaryTreeNode(a, b, d));
+
+      map<Size, float> merged;
+      for (map<Size, float>::const_iterator it = neighbours[a].begin(); it != neighbours[a].end(); ++it)
+      {
+        if (it->first == b) continue;
+        map<Size, float>::const_iterator other = neighbours[b].find(it->first);
+        const float d_b = (other == neighbours[b].end()) ? missing : other->second;
+        merged[it->first] = update(it->second, cluster_size[a], d_b, cluster_size[b]);
+      }
+      for (map<Size, float>::const_iterator it = neighbours[b].begin(); it != neighbours[b].end(); ++it)
+      {
+        if (it->first == a || neighbours[a].count(it->first) > 0) continue;
+        merged[it->first] = update(missing, cluster_size[a], it->second, cluster_size[b]);
+      }
+
+      // update neighbour lists, pairs at the missing value need not be stored
+      for (map<Size, float>::iterator it = merged.begin(); it != merged.end(); )
+      {
+        const Size k = it->first;
+        neighbours[k].erase(b);
+        if (it->second == missing)
+        {
+          neighbours[k].erase(a);
+          merged.erase(it++);
+          continue;
+        }
+        neighbours[k][a] = it->second;
+        if (it->second < threshold)
+        {
+          candidates.push(Candidate(it->second, min(a, k), max(a, k)));
+        }
+        ++it;
+      }
+      neighbours[a].swap(merged);
+      map<Size, float>().swap(neighbours[b]);
+      active[b] = false;
+      cluster_size[a] += cluster_size[b];
+    }
+
+    // fill tree with dummy nodes
+    vector<Size> roots;
+    for (Size i = 0; i < n; ++i)
+    {
+      if (active[i]) roots.push_back(i);
+    }
+    fillDummyNodes_(roots, n, cluster_tree);
+  }
+
+  void ClusterFunctor::fillDummyNodes_(const std::vector<Size> & roots, Size size, std::vector<BinaryTreeNode> & cluster_tree)
+  {
+    for (Size i = 1; (i < roots.size()) && (cluster_tree.size() + 1 < size); ++i)
+    {
+      cluster_tree.push_back(BinaryTreeNode(roots.front(), roots[i], -1.0));
+    }
+  }
+
   void ClusterFunctor::registerChildren()
   {
     Factory<ClusterFunctor>::registerProduct(SingleLinkage::getProductName(), &SingleLinkage::create);
@@ -165,4 +165,13 @@ namespace OpenMS
     endProgress();
   }
 
+  void CompleteLinkage::operator()(const SparseDistanceMatrix & distance, std::vector<BinaryTreeNode> & cluster_tree, const float threshold /*=1*/) const
+  {
+    // complete linkage: new distance between clusters is the maximum distance between elements of each cluster
+    clusterSparse_(distance, cluster_tree, threshold, [](float d_a, Size /*n_a*/, float d_b, Size /*n_b*/)
+    {
+      return std::max(d_a, d_b);
+    });
+  }
+
 }
@@ -201,4 +201,80 @@ namespace OpenMS
     endProgress();
   }
 
+  void SingleLinkage::operator()(const SparseDistanceMatrix & distance, std::vector<BinaryTreeNode> & cluster_tree, const float threshold /*=1*/) const
+  {
+    // input MUST have >= 2 elements!
+    const Size n = distance.dimensionsize();
+    if (n < 2)
+    {
+      throw ClusterFunctor::InsufficientInput(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Distance matrix to start from only contains one element");
+    }
+
+    // collect each stored pair once, ordered by distance (ties by element indices)
+    const std::vector<Size> & offsets = distance.getRowOffsets();
+    const std::vector<Size> & columns = distance.getColumns();
+    const std::vector<float> & values = distance.getValues();
+    std::vector<SparseDistanceMatrix::Entry> edges;
+    for (Size i = 0; i < n; ++i)
+    {
+      for (Size k = offsets[i]; k < offsets[i + 1]; ++k)
+      {
+        if (i < columns[k] && values[k] < threshold)
+        {
+          edges.push_back(SparseDistanceMatrix::Entry(i, columns[k], values[k]));
+        }
+      }
+    }
+    std::sort(edges.begin(), edges.end(), [](const SparseDistanceMatrix::Entry & a, const SparseDistanceMatrix::Entry & b)
+    {
+      if (a.value != b.value) return a.value < b.value;
+      if (a.row != b.row) return a.row < b.row;
+      return a.column < b.column;
+    });
+
+    startProgress(0, edges.size(), "clustering data");
+
+    // Kruskal: union-find whose roots are the smallest element of each cluster
+    std::vector<Size> parent(n);
+    for (Size i = 0; i < n; ++i)
+    {
+      parent[i] = i;
+    }
+    auto find_root = [&parent](Size i)
+    {
+      while (parent[i] != i)
+      {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+      }
+      return i;
+    };
+
+    cluster_tree.clear();
+    cluster_tree.reserve(n - 1);
+    for (Size e = 0; e < edges.size() && cluster_tree.size() + 1 < n; ++e)
+    {
+      Size left = find_root(edges[e].row);
+      Size right = find_root(edges[e].column);
+      if (left == right) continue;
+      if (left > right)
+      {
+        std::swap(left, right);
+      }
+      cluster_tree.push_back(BinaryTreeNode(left, right, edges[e].value));
+      parent[right] = left;
+      setProgress(e);
+    }
+
+    // fill tree with dummy nodes
+    std::vector<Size> roots;
+    for (Size i = 0; i < n; ++i)
+    {
+      if (parent[i] == i) roots.push_back(i);
+    }
+    fillDummyNodes_(roots, n, cluster_tree);
+
+    endProgress();
+  }
+
 }
@@ -69,6 +69,37 @@ namespace OpenMS
     return operator()(spec, spec);
   }
 
+  void BinnedSharedPeakCount::operator()(const BinnedSpectrum& query, const BinnedSpectrumBlock& block, vector<double>& scores) const
+  {
+    prepareBatch_(query, block, scores);
+    if (block.empty()) return;
+
+    const size_t query_peaks = query.getBins().nonZeros();
+    const vector<Size>& offsets = block.getRowOffsets();
+
+    // mark bins of the query (also those with zero intensity)
+    const BinnedSpectrumBlock::BinIndex first = block.getFirstBin(), last = block.getLastBin();
+    vector<Byte> query_bins(last - first + 1, 0);
+    for (BinnedSpectrum::SparseVectorIteratorType it(query.getBins()); it; ++it)
+    {
+      if ((it.index() >= first) && (it.index() <= last))
+      {
+        query_bins[it.index() - first] = 1;
+      }
+    }
+
+    const vector<BinnedSpectrumBlock::BinIndex>& bins = block.getBinIndices();
+    for (Size i = 0; i < block.size(); ++i)
+    {
+      size_t shared = 0;
+      for (Size pos = offsets[i]; pos < offsets[i + 1]; ++pos)
+      {
+        shared += query_bins[bins[pos] - first];
+      }
+      scores[i] = static_cast<double>(shared) / max(query_peaks, offsets[i + 1] - offsets[i]);
+    }
+  }
+
   void BinnedSharedPeakCount::updateMembers_()
   {
   }
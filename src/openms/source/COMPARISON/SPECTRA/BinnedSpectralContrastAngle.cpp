@@ -69,6 +69,39 @@ namespace OpenMS
     return operator()(spec, spec);
   }
 
+  void BinnedSpectralContrastAngle::operator()(const BinnedSpectrum& query, const BinnedSpectrumBlock& block, vector<double>& scores) const
+  {
+    prepareBatch_(query, block, scores);
+    if (block.empty()) return;
+
+    const double sum1 = query.getBins().dot(query.getBins());
+    Eigen::RowVectorXf dense_query = denseQuery_(query, block);
+    if (block.hasDenseWindow())
+    {
+      // vectorized: all dot products as one matrix-vector product
+      Eigen::VectorXf numerators = block.getDenseWindow() * dense_query.transpose();
+      for (Size i = 0; i < block.size(); ++i)
+      {
+        scores[i] = numerators[i] / sqrt(sum1 * block.getSquaredNorm(i));
+      }
+      return;
+    }
+
+    const vector<Size>& offsets = block.getRowOffsets();
+    const vector<BinnedSpectrumBlock::BinIndex>& bins = block.getBinIndices();
+    const vector<float>& intensities = block.getIntensities();
+    const BinnedSpectrumBlock::BinIndex first = block.getFirstBin();
+    for (Size i = 0; i < block.size(); ++i)
+    {
+      float numerator = 0;
+      for (Size pos = offsets[i]; pos < offsets[i + 1]; ++pos)
+      {
+        numerator += intensities[pos] * dense_query[bins[pos] - first];
+      }
+      scores[i] = numerator / sqrt(sum1 * block.getSquaredNorm(i));
+    }
+  }
+
   void BinnedSpectralContrastAngle::updateMembers_()
   {
   }
@@ -0,0 +1,204 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+//
+
+#include <OpenMS/COMPARISON/SPECTRA/BinnedSpectrumBlock.h>
+
+using namespace std;
+
+namespace OpenMS
+{
+  BinnedSpectrumBlock::BinnedSpectrumBlock() :
+    layout_(PeakSpectrum(), BinnedSpectrum::DEFAULT_BIN_WIDTH_LOWRES, false, 0, BinnedSpectrum::DEFAULT_BIN_OFFSET_LOWRES),
+    row_offsets_(1, 0),
+    first_bin_(0),
+    last_bin_(-1),
+    has_dense_(false)
+  {
+  }
+
+  BinnedSpectrumBlock::BinnedSpectrumBlock(const vector<BinnedSpectrum>& spectra) :
+    BinnedSpectrumBlock()
+  {
+    if (spectra.empty()) return;
+
+    layout_ = spectra[0];
+    layout_.getBins() = BinnedSpectrum::SparseVectorType();
+    layout_.getPrecursors().clear();
+
+    Size total = 0;
+    for (const BinnedSpectrum& spec : spectra)
+    {
+      if (!BinnedSpectrum::isCompatible(layout_, spec))
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Binned spectra have different bin layouts");
+      }
+      total += spec.getBins().nonZeros();
+    }
+
+    row_offsets_.reserve(spectra.size() + 1);
+    bins_.reserve(total);
+    intensities_.reserve(total);
+    sums_.reserve(spectra.size());
+    squared_norms_.reserve(spectra.size());
+    first_bin_ = numeric_limits<BinIndex>::max();
+    for (const BinnedSpectrum& spec : spectra)
+    {
+      // accumulate in the same order as the sparse vector operations:
+      float sum = 0, squared_norm = 0;
+      for (BinnedSpectrum::SparseVectorIteratorType it(spec.getBins()); it; ++it)
+      {
+        bins_.push_back(it.index());
+        intensities_.push_back(it.value());
+        sum += it.value();
+        squared_norm += it.value() * it.value();
+      }
+      if (spec.getBins().nonZeros() > 0)
+      {
+        first_bin_ = min(first_bin_, bins_[row_offsets_.back()]);
+        last_bin_ = max(last_bin_, bins_.back());
+      }
+      row_offsets_.push_back(bins_.size());
+      sums_.push_back(sum);
+      squared_norms_.push_back(squared_norm);
+    }
+    if (bins_.empty()) first_bin_ = 0;
+  }
+
+  BinnedSpectrumBlock::~BinnedSpectrumBlock()
+  {
+  }
+
+  Size BinnedSpectrumBlock::size() const
+  {
+    return row_offsets_.size() - 1;
+  }
+
+  bool BinnedSpectrumBlock::empty() const
+  {
+    return size() == 0;
+  }
+
+  Size BinnedSpectrumBlock::nonZeros() const
+  {
+    return bins_.size();
+  }
+
+  bool BinnedSpectrumBlock::isCompatible(const BinnedSpectrum& spec) const
+  {
+    return empty() || BinnedSpectrum::isCompatible(layout_, spec);
+  }
+
+  const vector<Size>& BinnedSpectrumBlock::getRowOffsets() const
+  {
+    return row_offsets_;
+  }
+
+  const vector<BinnedSpectrumBlock::BinIndex>& BinnedSpectrumBlock::getBinIndices() const
+  {
+    return bins_;
+  }
+
+  const vector<float>& BinnedSpectrumBlock::getIntensities() const
+  {
+    return intensities_;
+  }
+
+  BinnedSpectrumBlock::BinIndex BinnedSpectrumBlock::getFirstBin() const
+  {
+    return first_bin_;
+  }
+
+  BinnedSpectrumBlock::BinIndex BinnedSpectrumBlock::getLastBin() const
+  {
+    return last_bin_;
+  }
+
+  float BinnedSpectrumBlock::getSum(Size index) const
+  {
+    return sums_[index];
+  }
+
+  float BinnedSpectrumBlock::getSquaredNorm(Size index) const
+  {
+    return squared_norms_[index];
+  }
+
+  BinnedSpectrum BinnedSpectrumBlock::getSpectrum(Size index) const
+  {
+    if (index >= size())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, index, size());
+    }
+    BinnedSpectrum spec(layout_);
+    BinnedSpectrum::SparseVectorType& bins = spec.getBins();
+    bins = BinnedSpectrum::EmptySparseVector;
+    bins.reserve(row_offsets_[index + 1] - row_offsets_[index]);
+    for (Size pos = row_offsets_[index]; pos < row_offsets_[index + 1]; ++pos)
+    {
+      bins.insertBack(bins_[pos]) = intensities_[pos];
+    }
+    return spec;
+  }
+
+  void BinnedSpectrumBlock::createDenseWindow()
+  {
+    dense_ = DenseMatrixType::Zero(size(), last_bin_ - first_bin_ + 1);
+    for (Size row = 0; row < size(); ++row)
+    {
+      for (Size pos = row_offsets_[row]; pos < row_offsets_[row + 1]; ++pos)
+      {
+        dense_(row, bins_[pos] - first_bin_) = intensities_[pos];
+      }
+    }
+    has_dense_ = true;
+  }
+
+  void BinnedSpectrumBlock::clearDenseWindow()
+  {
+    dense_ = DenseMatrixType();
+    has_dense_ = false;
+  }
+
+  bool BinnedSpectrumBlock::hasDenseWindow() const
+  {
+    return has_dense_;
+  }
+
+  const BinnedSpectrumBlock::DenseMatrixType& BinnedSpectrumBlock::getDenseWindow() const
+  {
+    return dense_;
+  }
+
+}
@@ -67,6 +67,38 @@ namespace OpenMS
     return *this;
   }
 
+  void BinnedSpectrumCompareFunctor::operator()(const BinnedSpectrum& query, const BinnedSpectrumBlock& block, vector<double>& scores) const
+  {
+    prepareBatch_(query, block, scores);
+    for (Size i = 0; i < block.size(); ++i)
+    {
+      scores[i] = operator()(query, block.getSpectrum(i));
+    }
+  }
+
+  void BinnedSpectrumCompareFunctor::prepareBatch_(const BinnedSpectrum& query, const BinnedSpectrumBlock& block, vector<double>& scores)
+  {
+    if (!block.isCompatible(query))
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Binned spectra have different bin layouts");
+    }
+    scores.assign(block.size(), 0.0);
+  }
+
+  Eigen::RowVectorXf BinnedSpectrumCompareFunctor::denseQuery_(const BinnedSpectrum& query, const BinnedSpectrumBlock& block)
+  {
+    const BinnedSpectrumBlock::BinIndex first = block.getFirstBin(), last = block.getLastBin();
+    Eigen::RowVectorXf dense = Eigen::RowVectorXf::Zero(last - first + 1);
+    for (BinnedSpectrum::SparseVectorIteratorType it(query.getBins()); it; ++it)
+    {
+      if ((it.index() >= first) && (it.index() <= last))
+      {
+        dense[it.index() - first] = it.value();
+      }
+    }
+    return dense;
+  }
+
   void BinnedSpectrumCompareFunctor::registerChildren()
   {
     Factory<BinnedSpectrumCompareFunctor>::registerProduct(BinnedSharedPeakCount::getProductName(), &BinnedSharedPeakCount::create);
@@ -69,6 +69,43 @@ namespace OpenMS
     return operator()(spec, spec);
   }
 
+  void BinnedSumAgreeingIntensities::operator()(const BinnedSpectrum& query, const BinnedSpectrumBlock& block, vector<double>& scores) const
+  {
+    prepareBatch_(query, block, scores);
+    if (block.empty()) return;
+
+    // bins that are only occupied in one spectrum don't contribute (negative
+    // values are truncated), so only the bin range of the block is relevant:
+    const double sum1 = query.getBins().sum();
+    Eigen::RowVectorXf dense_query = denseQuery_(query, block);
+    if (block.hasDenseWindow())
+    {
+      // vectorized over the bins of every spectrum
+      const BinnedSpectrumBlock::DenseMatrixType& dense = block.getDenseWindow();
+      for (Size i = 0; i < block.size(); ++i)
+      {
+        double sum_nn = (((dense.row(i).array() + dense_query.array()) * 0.5f) - (dense.row(i).array() - dense_query.array()).abs()).max(0.0f).sum();
+        scores[i] = min(sum_nn / ((sum1 + block.getSum(i)) / 2.0), 1.0);
+      }
+      return;
+    }
+
+    const vector<Size>& offsets = block.getRowOffsets();
+    const vector<BinnedSpectrumBlock::BinIndex>& bins = block.getBinIndices();
+    const vector<float>& intensities = block.getIntensities();
+    const BinnedSpectrumBlock::BinIndex first = block.getFirstBin();
+    for (Size i = 0; i < block.size(); ++i)
+    {
+      double sum_nn = 0;
+      for (Size pos = offsets[i]; pos < offsets[i + 1]; ++pos)
+      {
+        const float a = intensities[pos], b = dense_query[bins[pos] - first];
+        sum_nn += max(0.0f, ((a + b) * 0.5f) - fabs(a - b));
+      }
+      scores[i] = min(sum_nn / ((sum1 + block.getSum(i)) / 2.0), 1.0);
+    }
+  }
+
   void BinnedSumAgreeingIntensities::updateMembers_()
   {
   }
@@ -0,0 +1,230 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+//
+
+#include <OpenMS/COMPARISON/SPECTRA/SpectralLibraryIndex.h>
+
+#include <OpenMS/CONCEPT/ParallelExceptionCollector.h>
+
+#include <algorithm>
+
+using namespace std;
+
+namespace OpenMS
+{
+  SpectralLibraryIndex::SpectralLibraryIndex(float bin_size, UInt bin_spread, float offset, Size top_bins) :
+    bin_size_(bin_size),
+    bin_spread_(bin_spread),
+    offset_(offset),
+    top_bins_(top_bins)
+  {
+  }
+
+  SpectralLibraryIndex::~SpectralLibraryIndex()
+  {
+  }
+
+  void SpectralLibraryIndex::build(const vector<PeakSpectrum>& library)
+  {
+    precursors_.clear();
+    postings_.clear();
+    binned_.clear();
+
+    precursors_.reserve(library.size());
+    for (Size i = 0; i < library.size(); ++i)
+    {
+      if (library[i].getPrecursors().empty())
+      {
+        throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Library spectrum " + String(i) + " has no precursor.");
+      }
+      precursors_.push_back(make_pair(library[i].getPrecursors()[0].getMZ(), i));
+    }
+    // stable: spectra with equal precursor m/z stay in library order
+    stable_sort(precursors_.begin(), precursors_.end(),
+                [](const pair<double, Size>& a, const pair<double, Size>& b)
+                {
+                  return a.first < b.first;
+                });
+
+    // binning is independent for every spectrum:
+    binned_.resize(library.size());
+    vector<vector<BinIndex> > top(library.size());
+    ParallelExceptionCollector errors;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+    for (SignedSize i = 0; i < SignedSize(library.size()); ++i)
+    {
+      try
+      {
+        binned_[i] = binSpectrum(library[i]);
+        top[i] = getTopBins(binned_[i]);
+      }
+      catch (...)
+      {
+        errors.capture(i);
+      }
+    }
+    errors.rethrowFirst();
+
+    // postings are filled in rank order, so they are sorted:
+    for (Size rank = 0; rank < precursors_.size(); ++rank)
+    {
+      for (BinIndex bin : top[precursors_[rank].second])
+      {
+        postings_[bin].push_back(rank);
+      }
+    }
+  }
+
+  Size SpectralLibraryIndex::size() const
+  {
+    return precursors_.size();
+  }
+
+  Size SpectralLibraryIndex::getNumberOfTopBins() const
+  {
+    return top_bins_;
+  }
+
+  pair<Size, Size> SpectralLibraryIndex::precursorRange_(double min_mz, double max_mz) const
+  {
+    auto low = lower_bound(precursors_.begin(), precursors_.end(), min_mz,
+                           [](const pair<double, Size>& a, double mz)
+                           {
+                             return a.first < mz;
+                           });
+    auto up = upper_bound(low, precursors_.end(), max_mz,
+                          [](double mz, const pair<double, Size>& a)
+                          {
+                            return mz < a.first;
+                          });
+    return make_pair(Size(low - precursors_.begin()), Size(up - precursors_.begin()));
+  }
+
+  vector<Size> SpectralLibraryIndex::findByPrecursor(double min_mz, double max_mz) const
+  {
+    pair<Size, Size> range = precursorRange_(min_mz, max_mz);
+    vector<Size> result;
+    if (range.first >= range.second) return result;
+    result.reserve(range.second - range.first);
+    for (Size rank = range.first; rank < range.second; ++rank)
+    {
+      result.push_back(precursors_[rank].second);
+    }
+    return result;
+  }
+
+  vector<Size> SpectralLibraryIndex::findCandidates(const BinnedSpectrum& query, double min_mz, double max_mz, Size min_shared_bins) const
+  {
+    if (min_shared_bins == 0) return findByPrecursor(min_mz, max_mz);
+
+    pair<Size, Size> range = precursorRange_(min_mz, max_mz);
+    vector<Size> result;
+    if (range.first >= range.second) return result;
+
+    // count shared top bins for all spectra in the precursor window:
+    vector<Size> shared(range.second - range.first, 0);
+    for (BinIndex bin : getTopBins(query))
+    {
+      auto pos = postings_.find(bin);
+      if (pos == postings_.end()) continue;
+      const vector<Size>& ranks = pos->second;
+      for (auto it = lower_bound(ranks.begin(), ranks.end(), range.first);
+           (it != ranks.end()) && (*it < range.second); ++it)
+      {
+        ++shared[*it - range.first];
+      }
+    }
+
+    for (Size rank = range.first; rank < range.second; ++rank)
+    {
+      if (shared[rank - range.first] >= min_shared_bins)
+      {
+        result.push_back(precursors_[rank].second);
+      }
+    }
+    return result;
+  }
+
+  const BinnedSpectrum& SpectralLibraryIndex::getBinnedSpectrum(Size index) const
+  {
+    if (index >= binned_.size())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, index, binned_.size());
+    }
+    return binned_[index];
+  }
+
+  BinnedSpectrum SpectralLibraryIndex::binSpectrum(const PeakSpectrum& spectrum) const
+  {
+    BinnedSpectrum binned(spectrum, bin_size_, false, bin_spread_, offset_);
+    if (binned.getBins().nonZeros() == 0)
+    {
+      // keep the dimension compatible with non-empty spectra (dot product: 0)
+      binned.getBins() = BinnedSpectrum::EmptySparseVector;
+    }
+    else
+    {
+      binned.getBins() /= binned.getBins().norm();
+    }
+    return binned;
+  }
+
+  vector<SpectralLibraryIndex::BinIndex> SpectralLibraryIndex::getTopBins(const BinnedSpectrum& binned) const
+  {
+    vector<pair<float, BinIndex> > bins;
+    bins.reserve(binned.getBins().nonZeros());
+    for (BinnedSpectrum::SparseVectorIteratorType it(binned.getBins()); it; ++it)
+    {
+      bins.push_back(make_pair(it.value(), it.index()));
+    }
+    auto more_intense = [](const pair<float, BinIndex>& a, const pair<float, BinIndex>& b)
+    {
+      return (a.first > b.first) || ((a.first == b.first) && (a.second < b.second));
+    };
+    Size n = min(top_bins_, bins.size());
+    partial_sort(bins.begin(), bins.begin() + n, bins.end(), more_intense);
+
+    vector<BinIndex> result;
+    result.reserve(n);
+    for (Size i = 0; i < n; ++i)
+    {
+      result.push_back(bins[i].second);
+    }
+    sort(result.begin(), result.end());
+    return result;
+  }
+
+}
@@ -6,11 +6,13 @@ set(sources_list
 BinnedSharedPeakCount.cpp
 BinnedSpectralContrastAngle.cpp
 BinnedSpectrum.cpp
+BinnedSpectrumBlock.cpp
 BinnedSpectrumCompareFunctor.cpp
 BinnedSumAgreeingIntensities.cpp
 PeakAlignment.cpp
 PeakSpectrumCompareFunctor.cpp
 SpectraSTSimilarityScore.cpp
+SpectralLibraryIndex.cpp
 SpectrumAlignment.cpp
 SpectrumAlignmentScore.cpp
 SpectrumCheapDPCorr.cpp
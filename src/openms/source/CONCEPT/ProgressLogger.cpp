@@ -36,6 +36,7 @@
 #include <OpenMS/CONCEPT/Macros.h>
 #include <OpenMS/CONCEPT/Factory.h>
 
+#include <OpenMS/SYSTEM/Profiler.h>
 #include <OpenMS/SYSTEM/StopWatch.h>
 
 #include <QtCore/QString>
@@ -244,6 +245,10 @@ public:
     last_invoke_ = time(nullptr);
     current_logger_->startProgress(begin, end, label, recursion_depth_);
     ++recursion_depth_;
+    if (Profiler::isEnabled())
+    {
+      profile_spans_.emplace_back(Profiler::beginSpan(label, "progress"), end - begin);
+    }
   }
 
   void ProgressLogger::setProgress(SignedSize value) const
@@ -271,6 +276,12 @@ public:
       --recursion_depth_;
     }
     current_logger_->endProgress(recursion_depth_);
+    if (!profile_spans_.empty())
+    {
+      const auto& span = profile_spans_.back();
+      Profiler::endSpan(span.first, span.second > 0 ? span.second : -1);
+      profile_spans_.pop_back();
+    }
   }
 
 
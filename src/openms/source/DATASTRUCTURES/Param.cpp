@@ -39,7 +39,10 @@
 #include <OpenMS/DATASTRUCTURES/Map.h>
 
 #include <QtCore/QString>
+#include <atomic>
 #include <fstream>
+#include <mutex>
+#include <unordered_map>
 
 namespace OpenMS
 {
@@ -432,11 +435,86 @@ namespace OpenMS
     return key;
   }
 
+  //********************************* ParamData **************************************
+
+  struct Param::ParamData
+  {
+    ParamData() :
+      root("ROOT", "")
+    {
+    }
+
+    explicit ParamData(const ParamNode& node) :
+      root(node)
+    {
+      root.name = "ROOT";
+      root.description = "";
+    }
+
+    /// Copies the tree only, the index of the copy is built on demand
+    ParamData(const ParamData& rhs) :
+      root(rhs.root)
+    {
+    }
+
+    /// Drops the index (only called with exclusive access to the data)
+    void invalidateIndex()
+    {
+      index.clear();
+      index_valid.store(false, std::memory_order_relaxed);
+      lookups.store(0, std::memory_order_relaxed);
+    }
+
+    /// Adds all entries below @p node to the index, using @p prefix as path of @p node
+    void indexNode(ParamNode& node, const String& prefix)
+    {
+      for (ParamEntry& entry : node.entries)
+      {
+        index.emplace(prefix + entry.name, &entry); // the first match wins, as in ParamNode::findEntry
+      }
+      for (ParamNode& child : node.nodes)
+      {
+        indexNode(child, prefix + child.name + ":");
+      }
+    }
+
+    ParamNode root;
+    /// Full key to entry, valid only if @p index_valid is set
+    std::unordered_map<String, ParamEntry*> index;
+    std::atomic<bool> index_valid{false};
+    /// Number of lookups since the last structural change
+    std::atomic<Size> lookups{0};
+    std::mutex index_mutex;
+  };
+
+  namespace
+  {
+    /// Number of lookups after a structural change which are answered by walking the tree before the index is built.
+    /// Avoids rebuilding the index over and over while a Param is filled (e.g. by alternating exists() and setValue()).
+    const Size LOOKUPS_BEFORE_INDEXING = 16;
+  }
+
   //********************************* Param **************************************
 
   Param::Param() :
-    root_("ROOT", "")
+    data_(emptyData_())
+  {
+  }
+
+  Param::Param(Param&& rhs) :
+    data_(std::move(rhs.data_))
   {
+    rhs.data_ = emptyData_();
+  }
+
+  Param& Param::operator=(Param&& rhs) &
+  {
+    if (this != &rhs)
+    {
+      data_ = std::move(rhs.data_);
+      rhs.data_ = emptyData_();
+    }
+    return *this;
   }
 
   Param::~Param()
@@ -444,25 +522,71 @@ namespace OpenMS
   }
 
   Param::Param(const ParamNode& node) :
-    root_(node)
+    data_(std::make_shared<ParamData>(node))
+  {
+  }
+
+  const std::shared_ptr<Param::ParamData>& Param::emptyData_()
+  {
+    // never modified, as it is always shared with this static copy
+    static const std::shared_ptr<ParamData> empty = std::make_shared<ParamData>();
+    return empty;
+  }
+
+  Param::ParamNode& Param::getRoot_() const
+  {
+    return data_->root;
+  }
+
+  Param::ParamNode& Param::getMutableRoot_(bool structural)
+  {
+    if (data_.use_count() > 1)
+    {
+      data_ = std::make_shared<ParamData>(*data_); // copy on write
+    }
+    else if (structural)
+    {
+      data_->invalidateIndex();
+    }
+    return data_->root;
+  }
+
+  Param::ParamEntry* Param::findEntry_(const String& key) const
   {
-    root_.name = "ROOT";
-    root_.description = "";
+    ParamData& data = *data_;
+    if (!data.index_valid.load(std::memory_order_acquire))
+    {
+      if (data.lookups.fetch_add(1, std::memory_order_relaxed) < LOOKUPS_BEFORE_INDEXING)
+      {
+        return data.root.findEntryRecursive(key);
+      }
+      // shared data may be read by several threads at once
+      std::lock_guard<std::mutex> lock(data.index_mutex);
+      if (!data.index_valid.load(std::memory_order_relaxed))
+      {
+        data.indexNode(data.root, "");
+        data.index_valid.store(true, std::memory_order_release);
+      }
+    }
+    std::unordered_map<String, ParamEntry*>::const_iterator it = data.index.find(key);
+    return it == data.index.end() ? nullptr : it->second;
   }
 
   bool Param::operator==(const Param& rhs) const
   {
-    return root_ == rhs.root_;
+    return data_ == rhs.data_ || getRoot_() == rhs.getRoot_();
   }
 
   void Param::setValue(const String& key, const DataValue& value, const String& description, const StringList& tags)
   {
-    root_.insert(ParamEntry("", value, description, tags), key);
+    // overwriting an existing entry does not move any entry, so the index stays valid
+    bool is_new = (findEntry_(key) == nullptr);
+    getMutableRoot_(is_new).insert(ParamEntry("", value, description, tags), key);
   }
 
   void Param::setValidStrings(const String& key, const std::vector<String>& strings)
   {
-    ParamEntry& entry = getEntry_(key);
+    ParamEntry& entry = getMutableEntry_(key);
     //check if correct parameter type
     if (entry.value.valueType() != DataValue::STRING_VALUE && entry.value.valueType() != DataValue::STRING_LIST)
     {
@@ -481,7 +605,7 @@ namespace OpenMS
 
   void Param::setMinInt(const String& key, Int min)
   {
-    ParamEntry& entry = getEntry_(key);
+    ParamEntry& entry = getMutableEntry_(key);
     if (entry.value.valueType() != DataValue::INT_VALUE && entry.value.valueType() != DataValue::INT_LIST)
     {
       throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, key);
@@ -491,7 +615,7 @@ namespace OpenMS
 
   void Param::setMaxInt(const String& key, Int max)
   {
-    ParamEntry& entry = getEntry_(key);
+    ParamEntry& entry = getMutableEntry_(key);
     if (entry.value.valueType() != DataValue::INT_VALUE && entry.value.valueType() != DataValue::INT_LIST)
     {
       throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, key);
@@ -501,7 +625,7 @@ namespace OpenMS
 
   void Param::setMinFloat(const String& key, double min)
   {
-    ParamEntry& entry = getEntry_(key);
+    ParamEntry& entry = getMutableEntry_(key);
     if (entry.value.valueType() != DataValue::DOUBLE_VALUE && entry.value.valueType() != DataValue::DOUBLE_LIST)
     {
       throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, key);
@@ -511,7 +635,7 @@ namespace OpenMS
 
   void Param::setMaxFloat(const String& key, double max)
   {
-    ParamEntry& entry = getEntry_(key);
+    ParamEntry& entry = getMutableEntry_(key);
     if (entry.value.valueType() != DataValue::DOUBLE_VALUE && entry.value.valueType() != DataValue::DOUBLE_LIST)
     {
       throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, key);
@@ -530,7 +654,7 @@ namespace OpenMS
     //static initialization and thus cannot rely on String::EMPTY been initialized.
     static String empty;
 
-    ParamNode* node = root_.findParentOf(key);
+    ParamNode* node = getRoot_().findParentOf(key);
     if (node == nullptr)
     {
       return empty;
@@ -548,13 +672,16 @@ namespace OpenMS
   void Param::insert(const String& prefix, const Param& param)
   {
     //std::cerr << "INSERT PARAM (" << prefix << ")" << std::endl;
-    for (Param::ParamNode::NodeIterator it = param.root_.nodes.begin(); it != param.root_.nodes.end(); ++it)
+    // the (cheap) copy keeps the source unchanged, even if it is this Param itself
+    const Param source(param);
+    ParamNode& root = getMutableRoot_();
+    for (Param::ParamNode::NodeIterator it = source.getRoot_().nodes.begin(); it != source.getRoot_().nodes.end(); ++it)
     {
-      root_.insert(*it, prefix);
+      root.insert(*it, prefix);
     }
-    for (Param::ParamNode::EntryIterator it = param.root_.entries.begin(); it != param.root_.entries.end(); ++it)
+    for (Param::ParamNode::EntryIterator it = source.getRoot_().entries.begin(); it != source.getRoot_().entries.end(); ++it)
     {
-      root_.insert(*it, prefix);
+      root.insert(*it, prefix);
     }
   }
 
@@ -574,7 +701,7 @@ namespace OpenMS
         if (showMessage)
           std::cerr << "Setting " << prefix2 + it.getName() << " to " << it->value << std::endl;
         String name = prefix2 + it.getName();
-        root_.insert(ParamEntry("", it->value, it->description), name);
+        getMutableRoot_().insert(ParamEntry("", it->value, it->description), name);
         //copy tags
         for (std::set<String>::const_iterator tag_it = it->tags.begin(); tag_it != it->tags.end(); ++tag_it)
         {
@@ -632,7 +759,7 @@ namespace OpenMS
     {
       keyname = key.chop(1);
 
-      ParamNode* node_parent = root_.findParentOf(keyname);
+      ParamNode* node_parent = getMutableRoot_().findParentOf(keyname);
       if (node_parent != nullptr)
       {
         Param::ParamNode::NodeIterator it = node_parent->findNode(node_parent->suffix(keyname));
@@ -650,7 +777,7 @@ namespace OpenMS
     }
     else
     {
-      ParamNode* node = root_.findParentOf(keyname);
+      ParamNode* node = getMutableRoot_().findParentOf(keyname);
       if (node != nullptr)
       {
         String entryname = node->suffix(keyname); // get everything beyond last ':'
@@ -672,7 +799,7 @@ namespace OpenMS
   {
     if (prefix.hasSuffix(':')) //we have to delete one node only (and its subnodes)
     {
-      ParamNode* node = root_.findParentOf(prefix.chop(1));
+      ParamNode* node = getMutableRoot_().findParentOf(prefix.chop(1));
       if (node != nullptr)
       {
         Param::ParamNode::NodeIterator it = node->findNode(node->suffix(prefix.chop(1)));
@@ -690,7 +817,7 @@ namespace OpenMS
     }
     else //we have to delete all entries and nodes starting with the prefix
     {
-      ParamNode* node = root_.findParentOf(prefix);
+      ParamNode* node = getMutableRoot_().findParentOf(prefix);
       if (node != nullptr)
       {
         String suffix = node->suffix(prefix); // name behind last ":"
@@ -731,10 +858,10 @@ namespace OpenMS
   {
     ParamNode out("ROOT", "");
 
-    for (const auto& entry : subset.root_.entries)
+    for (const auto& entry : subset.getRoot_().entries)
     {
-      const auto& n = root_.findEntry(entry.name);
-      if (n == root_.entries.end())
+      const auto& n = getRoot_().findEntry(entry.name);
+      if (n == getRoot_().entries.end())
       {
         OPENMS_LOG_WARN << "Warning: Trying to copy non-existent parameter entry " << entry.name << std::endl;
       }
@@ -744,10 +871,10 @@ namespace OpenMS
       }
     }
 
-    for (const auto& node : subset.root_.nodes)
+    for (const auto& node : subset.getRoot_().nodes)
     {
-      const auto& n = root_.findNode(node.name);
-      if (n == root_.nodes.end())
+      const auto& n = getRoot_().findNode(node.name);
+      if (n == getRoot_().nodes.end())
       {
         OPENMS_LOG_WARN << "Warning: Trying to copy non-existent parameter node " << node.name << std::endl;
       }
@@ -763,7 +890,7 @@ namespace OpenMS
   {
     ParamNode out("ROOT", "");
 
-    ParamNode* node = root_.findParentOf(prefix);
+    ParamNode* node = getRoot_().findParentOf(prefix);
     if (node == nullptr)
     {
       return Param();
@@ -854,25 +981,25 @@ namespace OpenMS
       //flag (option without text argument)
       if (arg_is_option && arg1_is_option)
       {
-        root_.insert(ParamEntry(arg, String(), ""), prefix2);
+        getMutableRoot_().insert(ParamEntry(arg, String(), ""), prefix2);
       }
       //option with argument
       else if (arg_is_option && !arg1_is_option)
       {
-        root_.insert(ParamEntry(arg, arg1, ""), prefix2);
+        getMutableRoot_().insert(ParamEntry(arg, arg1, ""), prefix2);
         ++i;
       }
       //just text arguments (not preceded by an option)
       else
       {
 
-        ParamEntry* misc_entry = root_.findEntryRecursive(prefix2 + "misc");
+        ParamEntry* misc_entry = getMutableRoot_(false).findEntryRecursive(prefix2 + "misc");
         if (misc_entry == nullptr)
         {
           StringList sl;
           sl.push_back(arg);
           // create "misc"-Node:
-          root_.insert(ParamEntry("misc", sl, ""), prefix2);
+          getMutableRoot_().insert(ParamEntry("misc", sl, ""), prefix2);
         }
         else
         {
@@ -919,7 +1046,7 @@ namespace OpenMS
         //next argument is an option
         if (arg1_is_option)
         {
-          root_.insert(ParamEntry("", StringList(), ""), options_with_multiple_argument.find(arg)->second);
+          getMutableRoot_().insert(ParamEntry("", StringList(), ""), options_with_multiple_argument.find(arg)->second);
         }
         //next argument is not an option
         else
@@ -934,14 +1061,14 @@ namespace OpenMS
               arg1 = argv[j];
           }
 
-          root_.insert(ParamEntry("", sl, ""), options_with_multiple_argument.find(arg)->second);
+          getMutableRoot_().insert(ParamEntry("", sl, ""), options_with_multiple_argument.find(arg)->second);
           i = j - 1;
         }
       }
       //without argument
       else if (options_without_argument.has(arg))
       {
-        root_.insert(ParamEntry("", String("true"), ""), options_without_argument.find(arg)->second);
+        getMutableRoot_().insert(ParamEntry("", String("true"), ""), options_without_argument.find(arg)->second);
       }
       //with one argument
       else if (options_with_one_argument.has(arg))
@@ -949,25 +1076,25 @@ namespace OpenMS
         //next argument is not an option
         if (!arg1_is_option)
         {
-          root_.insert(ParamEntry("", arg1, ""), options_with_one_argument.find(arg)->second);
+          getMutableRoot_().insert(ParamEntry("", arg1, ""), options_with_one_argument.find(arg)->second);
           ++i;
         }
         //next argument is an option
         else
         {
 
-          root_.insert(ParamEntry("", String(), ""), options_with_one_argument.find(arg)->second);
+          getMutableRoot_().insert(ParamEntry("", String(), ""), options_with_one_argument.find(arg)->second);
         }
       }
       //unknown option
       else if (arg_is_option)
       {
-        ParamEntry* unknown_entry = root_.findEntryRecursive(unknown);
+        ParamEntry* unknown_entry = getMutableRoot_(false).findEntryRecursive(unknown);
         if (unknown_entry == nullptr)
         {
           StringList sl;
           sl.push_back(arg);
-          root_.insert(ParamEntry("", sl, ""), unknown);
+          getMutableRoot_().insert(ParamEntry("", sl, ""), unknown);
         }
         else
         {
@@ -979,13 +1106,13 @@ namespace OpenMS
       //just text argument
       else
       {
-        ParamEntry* misc_entry = root_.findEntryRecursive(misc);
+        ParamEntry* misc_entry = getMutableRoot_(false).findEntryRecursive(misc);
         if (misc_entry == nullptr)
         {
           StringList sl;
           sl.push_back(arg);
           // create "misc"-Node:
-          root_.insert(ParamEntry("", sl, ""), misc);
+          getMutableRoot_().insert(ParamEntry("", sl, ""), misc);
         }
         else
         {
@@ -1018,7 +1145,7 @@ namespace OpenMS
 
   Size Param::size() const
   {
-    return root_.size();
+    return getRoot_().size();
   }
 
   bool Param::empty() const
@@ -1028,7 +1155,7 @@ namespace OpenMS
 
   void Param::clear()
   {
-    root_ = ParamNode("ROOT", "");
+    data_ = emptyData_();
   }
 
   void Param::checkDefaults(const String& name, const Param& defaults, const String& prefix) const
@@ -1054,7 +1181,7 @@ namespace OpenMS
       }
 
       //different types
-      ParamEntry* default_value = defaults.root_.findEntryRecursive(prefix2 + it.getName());
+      ParamEntry* default_value = defaults.findEntry_(prefix2 + it.getName());
       if (default_value == nullptr)
         continue;
       if (default_value->value.valueType() != it->value.valueType())
@@ -1219,7 +1346,7 @@ OPENMS_THREAD_CRITICAL(oms_log)
             {
               prefix = it.getName().substr(0, 1 + it.getName().find_last_of(':'));
             }
-            this->root_.insert(local_entry, prefix); //->setValue(it.getName(), local_entry.value, local_entry.description, local_entry.tags);
+            this->getMutableRoot_().insert(local_entry, prefix); //->setValue(it.getName(), local_entry.value, local_entry.description, local_entry.tags);
           }
           else
           {
@@ -1311,7 +1438,7 @@ OPENMS_THREAD_CRITICAL(oms_log)
       {
         Param::ParamEntry entry = *it;
         OPENMS_LOG_DEBUG << "[Param::merge] merging " << it.getName() << std::endl;
-        this->root_.insert(entry, prefix);
+        this->getMutableRoot_().insert(entry, prefix);
       }
 
       //copy section descriptions
@@ -1346,7 +1473,7 @@ OPENMS_THREAD_CRITICAL(oms_log)
 
   void Param::setSectionDescription(const String& key, const String& description)
   {
-    ParamNode* node = root_.findParentOf(key);
+    ParamNode* node = getMutableRoot_(false).findParentOf(key);
     if (node == nullptr)
     {
       throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, key);
@@ -1362,12 +1489,12 @@ OPENMS_THREAD_CRITICAL(oms_log)
 
   void Param::addSection(const String& key, const String& description)
   {
-    root_.insert(ParamNode("",description),key);
+    getMutableRoot_().insert(ParamNode("",description),key);
   }
 
   Param::ParamIterator Param::begin() const
   {
-    return ParamIterator(root_);
+    return ParamIterator(getRoot_());
   }
 
   Param::ParamIterator Param::end() const
@@ -1533,12 +1660,12 @@ OPENMS_THREAD_CRITICAL(oms_log)
     {
       throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Param tags may not contain comma characters", tag);
     }
-    getEntry_(key).tags.insert(tag);
+    getMutableEntry_(key).tags.insert(tag);
   }
 
   void Param::addTags(const String& key, const StringList& tags)
   {
-    ParamEntry& entry = getEntry_(key);
+    ParamEntry& entry = getMutableEntry_(key);
     for (Size i = 0; i != tags.size(); ++i)
     {
       if (tags[i].has(','))
@@ -1551,7 +1678,7 @@ OPENMS_THREAD_CRITICAL(oms_log)
 
   StringList Param::getTags(const String& key) const
   {
-    ParamEntry& entry = getEntry_(key);
+    const ParamEntry& entry = getEntry_(key);
     StringList list;
     for (std::set<String>::const_iterator it = entry.tags.begin(); it != entry.tags.end(); ++it)
     {
@@ -1562,7 +1689,7 @@ OPENMS_THREAD_CRITICAL(oms_log)
 
   void Param::clearTags(const String& key)
   {
-    getEntry_(key).tags.clear();
+    getMutableEntry_(key).tags.clear();
   }
 
   bool Param::hasTag(const String& key, const String& tag) const
@@ -1572,12 +1699,24 @@ OPENMS_THREAD_CRITICAL(oms_log)
 
   bool Param::exists(const String& key) const
   {
-    return root_.findEntryRecursive(key);
+    return findEntry_(key) != nullptr;
+  }
+
+  const Param::ParamEntry& Param::getEntry_(const String& key) const
+  {
+    const ParamEntry* entry = findEntry_(key);
+    if (entry == nullptr)
+    {
+      throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, key);
+    }
+
+    return *entry;
   }
 
-  Param::ParamEntry& Param::getEntry_(const String& key) const
+  Param::ParamEntry& Param::getMutableEntry_(const String& key)
   {
-    ParamEntry* entry = root_.findEntryRecursive(key);
+    // changing an entry does not move any entry, so the index stays valid
+    ParamEntry* entry = getMutableRoot_(false).findEntryRecursive(key);
     if (entry == nullptr)
     {
       throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, key);
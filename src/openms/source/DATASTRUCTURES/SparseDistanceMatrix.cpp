@@ -0,0 +1,163 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Mathias Walzer $
+// $Authors: $
+// --------------------------------------------------------------------------
+//
+
+#include <OpenMS/DATASTRUCTURES/SparseDistanceMatrix.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+
+#include <algorithm>
+
+using namespace std;
+
+namespace OpenMS
+{
+
+  SparseDistanceMatrix::SparseDistanceMatrix() :
+    dimensionsize_(0),
+    missing_value_(1),
+    row_offsets_(1, 0)
+  {
+  }
+
+  SparseDistanceMatrix::SparseDistanceMatrix(Size dimensionsize, const vector<Entry>& entries, float missing_value) :
+    dimensionsize_(dimensionsize),
+    missing_value_(missing_value)
+  {
+    build_(entries);
+  }
+
+  SparseDistanceMatrix::SparseDistanceMatrix(const DistanceMatrix<float>& matrix, float cutoff, float missing_value) :
+    dimensionsize_(matrix.dimensionsize()),
+    missing_value_(missing_value)
+  {
+    vector<Entry> entries;
+    for (Size i = 1; i < dimensionsize_; ++i)
+    {
+      for (Size j = 0; j < i; ++j)
+      {
+        const float value = matrix.getValue(i, j);
+        if (value < cutoff)
+        {
+          entries.push_back(Entry(i, j, value));
+        }
+      }
+    }
+    build_(entries);
+  }
+
+  bool SparseDistanceMatrix::operator==(const SparseDistanceMatrix& rhs) const
+  {
+    return dimensionsize_ == rhs.dimensionsize_ &&
+           missing_value_ == rhs.missing_value_ &&
+           row_offsets_ == rhs.row_offsets_ &&
+           columns_ == rhs.columns_ &&
+           values_ == rhs.values_;
+  }
+
+  void SparseDistanceMatrix::build_(const vector<Entry>& entries)
+  {
+    // mirror every pair so each row holds all of its neighbours
+    vector<Entry> mirrored;
+    mirrored.reserve(2 * entries.size());
+    for (const Entry& e : entries)
+    {
+      if (e.row >= dimensionsize_ || e.column >= dimensionsize_)
+      {
+        throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, max(e.row, e.column), dimensionsize_);
+      }
+      if (e.row == e.column) continue;
+      mirrored.push_back(e);
+      mirrored.push_back(Entry(e.column, e.row, e.value));
+    }
+
+    // sort by position and keep the smallest value of duplicated pairs
+    sort(mirrored.begin(), mirrored.end(), [](const Entry& a, const Entry& b)
+    {
+      if (a.row != b.row) return a.row < b.row;
+      if (a.column != b.column) return a.column < b.column;
+      return a.value < b.value;
+    });
+    mirrored.erase(unique(mirrored.begin(), mirrored.end(), [](const Entry& a, const Entry& b)
+    {
+      return a.row == b.row && a.column == b.column;
+    }), mirrored.end());
+
+    row_offsets_.assign(dimensionsize_ + 1, 0);
+    columns_.clear();
+    values_.clear();
+    columns_.reserve(mirrored.size());
+    values_.reserve(mirrored.size());
+    for (const Entry& e : mirrored)
+    {
+      ++row_offsets_[e.row + 1];
+      columns_.push_back(e.column);
+      values_.push_back(e.value);
+    }
+    for (Size i = 0; i < dimensionsize_; ++i)
+    {
+      row_offsets_[i + 1] += row_offsets_[i];
+    }
+  }
+
+  bool SparseDistanceMatrix::hasValue(Size i, Size j) const
+  {
+    if (i >= dimensionsize_ || j >= dimensionsize_)
+    {
+      return false;
+    }
+    return binary_search(columns_.begin() + row_offsets_[i], columns_.begin() + row_offsets_[i + 1], j);
+  }
+
+  float SparseDistanceMatrix::getValue(Size i, Size j) const
+  {
+    if (i >= dimensionsize_ || j >= dimensionsize_)
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, max(i, j), dimensionsize_);
+    }
+    if (i == j)
+    {
+      return 0;
+    }
+    vector<Size>::const_iterator row_begin = columns_.begin() + row_offsets_[i];
+    vector<Size>::const_iterator row_end = columns_.begin() + row_offsets_[i + 1];
+    vector<Size>::const_iterator it = lower_bound(row_begin, row_end, j);
+    if (it == row_end || *it != j)
+    {
+      return missing_value_;
+    }
+    return values_[it - columns_.begin()];
+  }
+
+} // namespace OpenMS
@@ -34,6 +34,7 @@ MatchedIterator.cpp
 Matrix.cpp
 Param.cpp
 QTCluster.cpp
+SparseDistanceMatrix.cpp
 String.cpp
 StringListUtils.cpp
 StringUtils.cpp
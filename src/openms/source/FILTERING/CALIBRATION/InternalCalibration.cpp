@@ -192,7 +192,7 @@ namespace OpenMS
 
       PeptideIdentification pid = ids[0];
       pid.sort();
-      double mz_ref = pid.getHits()[0].getSequence().getMonoWeight(OpenMS::Residue::Full, pid.getHits()[0].getCharge());
+      double mz_ref = pid.getHits()[0].getInternedSequence().getMonoWeight(pid.getHits()[0].getCharge());
       if (tol_ppm < Math::getPPMAbs(it->getMZ(), mz_ref)) continue;
       cal_data_.insertCalibrationPoint(it->getRT(), it->getMZ(), it->getIntensity(), mz_ref, log(it->getIntensity()));
     }
@@ -229,7 +229,7 @@ namespace OpenMS
       PeptideIdentification pid = *it;
       pid.sort();
       int q = pid.getHits()[0].getCharge();
-      double mz_ref = pid.getHits()[0].getSequence().getMonoWeight(OpenMS::Residue::Full, q) / q;
+      double mz_ref = pid.getHits()[0].getInternedSequence().getMonoWeight(q) / q;
 
       // Only use ID if precursor m/z and theoretical mass don't deviate too much.
       // as they may occur due to isotopic peak misassignments
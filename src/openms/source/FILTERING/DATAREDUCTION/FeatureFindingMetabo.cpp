@@ -36,6 +36,7 @@
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
 #include <OpenMS/SYSTEM/File.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathHelper.h>
+#include <OpenMS/SYSTEM/Profiler.h>
 
 #include <fstream>
 
@@ -762,6 +763,7 @@ namespace OpenMS
 
   void FeatureFindingMetabo::run(std::vector<MassTrace>& input_mtraces, FeatureMap& output_featmap, std::vector<std::vector< OpenMS::MSChromatogram > >& output_chromatograms)
   {
+    OPENMS_PROFILE_SCOPE("FeatureFindingMetabo::run");
     output_featmap.clear();
     output_chromatograms.clear();
 
@@ -35,6 +35,7 @@
 #include <OpenMS/FILTERING/DATAREDUCTION/MassTraceDetection.h>
 
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
+#include <OpenMS/SYSTEM/Profiler.h>
 
 #include <boost/dynamic_bitset.hpp>
 
@@ -189,6 +190,7 @@ namespace OpenMS
 
     void MassTraceDetection::run(const PeakMap& input_exp, std::vector<MassTrace>& found_masstraces, const Size max_traces)
     {
+      OPENMS_PROFILE_SCOPE("MassTraceDetection::run");
       // make sure the output vector is empty
       found_masstraces.clear();
 
@@ -98,7 +98,8 @@ namespace OpenMS
     {
       Int z = hit.getCharge();
       if (z == 0) z = 1;
-      double peptide_mz = (hit.getSequence().getMonoWeight(Residue::Full, z) /
+      // cached mass (shared by all hits with the same sequence object):
+      double peptide_mz = (hit.getInternedSequence().getMonoWeight(z) /
                            double(z));
       return fabs(precursor_mz_ - peptide_mz) <= tolerance_;
     }
@@ -734,4 +735,59 @@ namespace OpenMS
     if (id_data.getParentMolecules().size() < n_parents) id_data.cleanup();
   }
 
+
+  void IDFilter::removeEmptyIdentifications(ColumnarPSMStore& psms)
+  {
+    psms.removeEmptyIdentifications();
+  }
+
+
+  void IDFilter::filterHitsByScore(ColumnarPSMStore& psms,
+                                   double threshold_score)
+  {
+    vector<bool> keep(psms.getNumberOfHits(), true);
+    for (Size i = 0; i < psms.size(); ++i)
+    {
+      bool higher_better = psms.isHigherScoreBetter(i);
+      for (Size h = psms.getHitBegin(i); h < psms.getHitEnd(i); ++h)
+      {
+        double score = psms.getScore(h);
+        keep[h] = higher_better ? (score >= threshold_score) :
+          (score <= threshold_score);
+      }
+    }
+    psms.filterHits(keep);
+  }
+
+
+  void IDFilter::keepNBestHits(ColumnarPSMStore& psms, Size n)
+  {
+    psms.sortHits();
+    vector<bool> keep(psms.getNumberOfHits(), true);
+    for (Size i = 0; i < psms.size(); ++i)
+    {
+      for (Size h = psms.getHitBegin(i) + n; h < psms.getHitEnd(i); ++h)
+      {
+        keep[h] = false;
+      }
+    }
+    psms.filterHits(keep);
+  }
+
+
+  void IDFilter::removeDecoyHits(ColumnarPSMStore& psms)
+  {
+    const DataValue decoy("decoy"), is_decoy("true");
+    MetaInfoRegistry& registry = MetaInfoInterface::metaRegistry();
+    UInt target_decoy_key = registry.getIndex("target_decoy");
+    UInt is_decoy_key = registry.getIndex("isDecoy");
+    vector<bool> keep(psms.getNumberOfHits(), true);
+    for (Size h = 0; h < psms.getNumberOfHits(); ++h)
+    {
+      keep[h] = (psms.getHitMetaValue(h, target_decoy_key) != decoy) &&
+        (psms.getHitMetaValue(h, is_decoy_key) != is_decoy);
+    }
+    psms.filterHits(keep);
+  }
+
 } // namespace OpenMS
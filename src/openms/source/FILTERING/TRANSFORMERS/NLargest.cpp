@@ -87,10 +87,8 @@ namespace OpenMS
 
   void NLargest::filterPeakMap(PeakMap & exp)
   {
-    for (PeakMap::Iterator it = exp.begin(); it != exp.end(); ++it)
-    {
-      filterSpectrum(*it);
-    }
+    // spectra are filtered independently of each other
+    exp.forEachSpectrumParallel([this](MSSpectrum& spectrum) { filterSpectrum(spectrum); });
   }
 
   void NLargest::updateMembers_()
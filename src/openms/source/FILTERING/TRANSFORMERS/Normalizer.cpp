@@ -71,10 +71,8 @@ namespace OpenMS
 
   void Normalizer::filterPeakMap(PeakMap& exp) const
   {
-    for (PeakMap::Iterator it = exp.begin(); it != exp.end(); ++it)
-    {
-      filterSpectrum(*it);
-    }
+    // spectra are filtered independently of each other
+    exp.forEachSpectrumParallel([this](MSSpectrum& spectrum) { filterSpectrum(spectrum); });
   }
 
   void Normalizer::updateMembers_()
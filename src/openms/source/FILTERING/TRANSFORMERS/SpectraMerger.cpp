@@ -35,6 +35,11 @@
 
 #include <OpenMS/FILTERING/TRANSFORMERS/SpectraMerger.h>
 
+#include <boost/functional/hash.hpp>
+
+#include <cmath>
+#include <unordered_map>
+
 using namespace std;
 namespace OpenMS
 {
@@ -112,4 +117,79 @@ namespace OpenMS
     return *this;
   }
 
+  vector<vector<Size> > SpectraMerger::clusterPrecursors_(const vector<BaseFeature>& data) const
+  {
+    SpectraDistance_ llc;
+    llc.setParameters(param_.copy("precursor_method:", true));
+
+    // grid cells as large as the tolerances: linked spectra are in the same or adjacent cells
+    // (the cell size only affects speed, so avoid degenerate cells for zero tolerances)
+    double rt_cell = param_.getValue("precursor_method:rt_tolerance");
+    double mz_cell = param_.getValue("precursor_method:mz_tolerance");
+    if (!(rt_cell > 0)) rt_cell = 1.0;
+    if (!(mz_cell > 0)) mz_cell = 1.0;
+
+    typedef pair<Int64, Int64> CellIndex;
+    unordered_map<CellIndex, vector<Size>, boost::hash<CellIndex> > grid;
+    vector<CellIndex> cells(data.size());
+    for (Size i = 0; i < data.size(); ++i)
+    {
+      cells[i] = CellIndex(Int64(floor(data[i].getRT() / rt_cell)), Int64(floor(data[i].getMZ() / mz_cell)));
+      grid[cells[i]].push_back(i);
+    }
+
+    // union-find (with path halving); the root of a set is its smallest element
+    vector<Size> parent(data.size());
+    for (Size i = 0; i < data.size(); ++i) parent[i] = i;
+    auto find_root = [&parent](Size i)
+    {
+      while (parent[i] != i)
+      {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+      }
+      return i;
+    };
+
+    for (Size i = 0; i < data.size(); ++i)
+    {
+      for (Int64 d_rt = -1; d_rt <= 1; ++d_rt)
+      {
+        for (Int64 d_mz = -1; d_mz <= 1; ++d_mz)
+        {
+          auto cell_it = grid.find(CellIndex(cells[i].first + d_rt, cells[i].second + d_mz));
+          if (cell_it == grid.end()) continue;
+
+          for (Size j : cell_it->second)
+          {
+            if (j >= i) continue; // every pair once
+            // same criterion as the full clustering: distances are stored as float
+            // and tree nodes with distance >= 1 are disconnected
+            if (float(1 - llc(data[i], data[j])) >= 1.0f) continue;
+
+            Size root_i = find_root(i), root_j = find_root(j);
+            if (root_i == root_j) continue;
+            if (root_i < root_j) parent[root_j] = root_i;
+            else parent[root_i] = root_j;
+          }
+        }
+      }
+    }
+
+    // collect clusters (ascending indices, ordered by their smallest element)
+    vector<vector<Size> > clusters;
+    vector<Size> cluster_of_root(data.size(), 0);
+    for (Size i = 0; i < data.size(); ++i)
+    {
+      Size root = find_root(i);
+      if (root == i)
+      {
+        cluster_of_root[i] = clusters.size();
+        clusters.push_back(vector<Size>());
+      }
+      clusters[cluster_of_root[root]].push_back(i);
+    }
+    return clusters;
+  }
+
 }
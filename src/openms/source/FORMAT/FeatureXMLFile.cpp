@@ -62,6 +62,8 @@ namespace OpenMS
     disable_parsing_ = 0;
     current_feature_ = nullptr;
     map_ = nullptr;
+    consumer_ = nullptr;
+    consumed_features_ = 0;
     //options_ = FeatureFileOptions(); do NOT reset this, since we need to preserve options!
     size_only_ = false;
     expected_size_ = 0;
@@ -133,6 +135,33 @@ namespace OpenMS
     return;
   }
 
+  void FeatureXMLFile::transform(const String& filename, FeatureMap& feature_map, const std::function<void(Feature&)>& consumer)
+  {
+    //Filename for error messages in XMLHandler
+    file_ = filename;
+
+    feature_map.clear(true);
+    map_ = &feature_map;
+    consumer_ = &consumer;
+
+    //set DocumentIdentifier
+    map_->setLoadedFileType(file_);
+    map_->setLoadedFilePath(file_);
+
+    try
+    {
+      parse_(filename, this);
+    }
+    catch (...)
+    {
+      resetMembers_();
+      throw;
+    }
+
+    // reset members
+    resetMembers_();
+  }
+
   void FeatureXMLFile::store(const String& filename, const FeatureMap& feature_map)
   {
     if (!FileHandler::hasValidExtension(filename, FileTypes::FEATUREXML))
@@ -305,14 +334,18 @@ namespace OpenMS
     }
 
     // write features with their corresponding attributes
+    // (rendered in parallel, written in order)
     os << "\t<featureList count=\"" << feature_map.size() << "\">\n";
     startProgress(0, feature_map.size(), "Storing featureXML file");
-    for (Size s = 0; s < feature_map.size(); s++)
-    {
-      writeFeature_(filename, os, feature_map[s], "f_", feature_map[s].getUniqueId(), 0);
-      setProgress(s);
-      // writeFeature_(filename, os, feature_map[s], "f_", s, 0);
-    }
+    writeElementsParallel_(os, feature_map.size(),
+      [&](std::ostream& buffer, Size s)
+      {
+        writeFeature_(filename, buffer, feature_map[s], "f_", feature_map[s].getUniqueId(), 0);
+      },
+      [&](Size written)
+      {
+        setProgress(written);
+      });
     endProgress();
 
     os << "\t</featureList>\n";
@@ -400,7 +433,7 @@ namespace OpenMS
         expected_size_ = count;
         throw EndParsingSoftly(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
       }
-      map_->reserve(std::min(Size(1e5), count)); // reserve vector for faster push_back, but with upper boundary of 1e5 (as >1e5 is most likely an invalid feature count)
+      if (consumer_ == nullptr) map_->reserve(std::min(Size(1e5), count)); // reserve vector for faster push_back, but with upper boundary of 1e5 (as >1e5 is most likely an invalid feature count)
       startProgress(0, count, "Loading featureXML file");
     }
     else if (tag == "quality" || tag == "hposition" || tag == "position")
@@ -824,6 +857,10 @@ namespace OpenMS
          &&  (!options_.hasMZRange() || options_.getMZRange().encloses(current_feature_->getMZ()))
          &&  (!options_.hasIntensityRange() || options_.getIntensityRange().encloses(current_feature_->getIntensity())))
       {
+        if (subordinate_feature_level_ == 0 && consumer_ != nullptr)
+        {
+          consumeFeature_();
+        }
       }
       else
       {
@@ -965,11 +1002,26 @@ namespace OpenMS
     }
   }
 
-  void FeatureXMLFile::writeFeature_(const String& filename, ostream& os, const Feature& feat, const String& identifier_prefix, UInt64 identifier, UInt indentation_level)
+  void FeatureXMLFile::consumeFeature_()
+  {
+    Feature& feature = map_->back();
+    // see hack in load()
+    if (feature.metaValueExists("FWHM"))
+    {
+      feature.setWidth((double)feature.getMetaValue("FWHM"));
+    }
+    (*consumer_)(feature);
+    map_->pop_back();
+    ++consumed_features_;
+  }
+
+  void FeatureXMLFile::writeFeature_(const String& filename, ostream& os, const Feature& feat, const String& identifier_prefix, UInt64 identifier, UInt indentation_level) const
   {
     String indent = String(indentation_level, '\t');
+    // used for the feature and as prefix of its subordinates
+    const String id_string = identifier_prefix + String(identifier);
 
-    os << indent << "\t\t<feature id=\"" << identifier_prefix << identifier << "\">\n";
+    os << indent << "\t\t<feature id=\"" << id_string << "\">\n";
     for (Size i = 0; i < 2; i++)
     {
       os << indent << "\t\t\t<position dim=\"" << i << "\">" << precisionWrapper(feat.getPosition()[i]) << "</position>\n";
@@ -983,7 +1035,7 @@ namespace OpenMS
     os << indent << "\t\t\t<charge>" << feat.getCharge() << "</charge>\n";
 
     // write convex hull
-    vector<ConvexHull2D> hulls = feat.getConvexHulls();
+    const vector<ConvexHull2D>& hulls = feat.getConvexHulls();
 
     Size hulls_count = hulls.size();
 
@@ -993,11 +1045,12 @@ namespace OpenMS
 
       ConvexHull2D current_hull = hulls[i];
       current_hull.compress();
-      Size hull_size = current_hull.getHullPoints().size();
+      const ConvexHull2D::PointArrayType& hull_points = current_hull.getHullPoints();
+      Size hull_size = hull_points.size();
 
       for (Size j = 0; j < hull_size; j++)
       {
-        DPosition<2> pos = current_hull.getHullPoints()[j];
+        const DPosition<2>& pos = hull_points[j];
         /*Size pos_size = pos.size();
             os << indent << "\t\t\t\t<hullpoint>\n";
     for (Size k=0; k<pos_size; k++)
@@ -1019,7 +1072,7 @@ namespace OpenMS
         // These subordinate identifiers are a bit long, but who cares about subordinates anyway?  :-P
         // This way the parent stands out clearly.  However,
         // note that only the portion after the last '_' is parsed when this is read back.
-        writeFeature_(filename, os, feat.getSubordinates()[i], identifier_prefix + identifier + "_", feat.getSubordinates()[i].getUniqueId(), indentation_level + 2);
+        writeFeature_(filename, os, feat.getSubordinates()[i], id_string + "_", feat.getSubordinates()[i].getUniqueId(), indentation_level + 2);
       }
       os << indent << "\t\t\t</subordinate>\n";
     }
@@ -1035,17 +1088,21 @@ namespace OpenMS
     os << indent << "\t\t</feature>\n";
   }
 
-  void FeatureXMLFile::writePeptideIdentification_(const String& filename, std::ostream& os, const PeptideIdentification& id, const String& tag_name, UInt indentation_level)
+  void FeatureXMLFile::writePeptideIdentification_(const String& filename, std::ostream& os, const PeptideIdentification& id, const String& tag_name, UInt indentation_level) const
   {
     String indent = String(indentation_level, '\t');
 
-    if (!identifier_id_.has(id.getIdentifier()))
+    Map<String, String>::ConstIterator run_it = identifier_id_.find(id.getIdentifier());
+    if (run_it == identifier_id_.end())
     {
+#ifdef _OPENMP
+#pragma omp critical (FeatureXMLFile_warning)
+#endif
       warning(STORE, String("Omitting peptide identification because of missing ProteinIdentification with identifier '") + id.getIdentifier() + "' while writing '" + filename + "'!");
       return;
     }
     os << indent << "<" << tag_name << " ";
-    os << "identification_run_ref=\"" << identifier_id_[id.getIdentifier()] << "\" ";
+    os << "identification_run_ref=\"" << run_it->second << "\" ";
     os << "score_type=\"" << writeXMLEscape(id.getScoreType()) << "\" ";
     os << "higher_score_better=\"" << (id.isHigherScoreBetter() ? "true" : "false") << "\" ";
     os << "significance_threshold=\"" << id.getSignificanceThreshold() << "\" ";
@@ -1093,8 +1150,10 @@ namespace OpenMS
         // empty accessions are not written out (legacy code)
         if (!protein_accession.empty())
         {
+          // unknown accessions are written as "PH_0" (legacy behavior)
+          Map<String, Size>::ConstIterator acc_it = accession_to_id_.find(id.getIdentifier() + "_" + protein_accession);
           accs += "PH_";
-          accs += String(accession_to_id_[id.getIdentifier() + "_" + protein_accession]);
+          accs += String(acc_it == accession_to_id_.end() ? Size(0) : acc_it->second);
         }
       }
 
@@ -1123,7 +1182,7 @@ namespace OpenMS
     {
       if (create)
       {
-        setProgress(map_->size());
+        setProgress(map_->size() + consumed_features_);
         map_->push_back(Feature());
         current_feature_ = &map_->back();
         last_meta_ =  &map_->back();
@@ -44,11 +44,173 @@
 #include <OpenMS/INTERFACES/IMSDataConsumer.h>
 #include <OpenMS/SYSTEM/File.h>
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
 namespace OpenMS
 {
   namespace Internal
   {
 
+    /**
+        @brief Three-stage pipeline for reading mzML data
+
+        The XML parser (running on the calling thread) hands over chunks of
+        spectra and chromatograms whose binary data is still base64 encoded.
+        A decoder thread decodes one chunk at a time (in parallel, see
+        decodeSpectra_()) while a delivery thread appends the previously
+        decoded chunk to the experiment / consumer. Chunks are delivered in
+        the order in which they were handed over.
+
+        The amount of encoded data in flight is bounded by
+        PeakFileOptions::getMaxPipelineBytes(); push() blocks until enough
+        data has been delivered (a single chunk is always admitted).
+        Exceptions from the background threads are stored and rethrown on the
+        parser thread by the next call to push() or drain().
+    */
+    class MzMLHandler::DecodingPipeline_
+    {
+public:
+      /// A chunk of spectra and chromatograms travelling through the pipeline
+      struct Chunk
+      {
+        std::vector<SpectrumData> spectra;
+        std::vector<ChromatogramData> chromatograms;
+        Size bytes = 0; ///< size of the encoded binary data
+      };
+
+      DecodingPipeline_(MzMLHandler& handler, Size max_bytes) :
+        handler_(handler),
+        max_bytes_(max_bytes),
+        decoder_(&DecodingPipeline_::decode_, this),
+        deliverer_(&DecodingPipeline_::deliver_, this)
+      {
+      }
+
+      /// Stops both threads (without delivering any pending data)
+      ~DecodingPipeline_()
+      {
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          stop_ = true;
+        }
+        cond_.notify_all();
+        decoder_.join();
+        deliverer_.join();
+      }
+
+      /// Hand over a chunk (blocks while the budget of in-flight bytes is exhausted)
+      void push(Chunk&& chunk)
+      {
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+          cond_.wait(lock, [&]() { return error_ || chunks_in_flight_ == 0 || bytes_in_flight_ + chunk.bytes <= max_bytes_; });
+          if (error_) std::rethrow_exception(error_);
+          bytes_in_flight_ += chunk.bytes;
+          ++chunks_in_flight_;
+          to_decode_.push_back(std::move(chunk));
+        }
+        cond_.notify_all();
+      }
+
+      /// Wait until all chunks handed over have been delivered
+      void drain()
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [&]() { return error_ || chunks_in_flight_ == 0; });
+        if (error_) std::rethrow_exception(error_);
+      }
+
+private:
+      /// Takes the next chunk from @p queue (returns false if the pipeline was stopped)
+      bool pop_(std::deque<Chunk>& queue, Chunk& chunk)
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [&]() { return stop_ || !queue.empty(); });
+        if (stop_) return false;
+        chunk = std::move(queue.front());
+        queue.pop_front();
+        return true;
+      }
+
+      /// Stores the first error and stops the pipeline
+      void fail_(std::exception_ptr error)
+      {
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          if (!error_) error_ = error;
+          stop_ = true;
+        }
+        cond_.notify_all();
+      }
+
+      void decode_()
+      {
+        Chunk chunk;
+        while (pop_(to_decode_, chunk))
+        {
+          try
+          {
+            handler_.decodeSpectra_(chunk.spectra);
+            handler_.decodeChromatograms_(chunk.chromatograms);
+          }
+          catch (...)
+          {
+            fail_(std::current_exception());
+            return;
+          }
+          {
+            std::lock_guard<std::mutex> lock(mutex_);
+            to_deliver_.push_back(std::move(chunk));
+          }
+          cond_.notify_all();
+        }
+      }
+
+      void deliver_()
+      {
+        Chunk chunk;
+        while (pop_(to_deliver_, chunk))
+        {
+          try
+          {
+            handler_.deliverSpectra_(chunk.spectra);
+            handler_.deliverChromatograms_(chunk.chromatograms);
+          }
+          catch (...)
+          {
+            fail_(std::current_exception());
+            return;
+          }
+          {
+            std::lock_guard<std::mutex> lock(mutex_);
+            bytes_in_flight_ -= chunk.bytes;
+            --chunks_in_flight_;
+          }
+          cond_.notify_all();
+          chunk = Chunk();
+        }
+      }
+
+      MzMLHandler& handler_;
+      const Size max_bytes_;
+
+      std::mutex mutex_;
+      std::condition_variable cond_; ///< signals any change of the state below
+      std::deque<Chunk> to_decode_;
+      std::deque<Chunk> to_deliver_;
+      Size bytes_in_flight_ = 0;
+      Size chunks_in_flight_ = 0;
+      bool stop_ = false;
+      std::exception_ptr error_;
+
+      std::thread decoder_;
+      std::thread deliverer_;
+    };
+
     /// Constructor for a read-only handler
     MzMLHandler::MzMLHandler(MapType& exp, const String& filename, const String& version, const ProgressLogger& logger)
       : MzMLHandler(filename, version, logger)
@@ -87,6 +249,8 @@ namespace OpenMS
     /// Destructor
     MzMLHandler::~MzMLHandler()
     {
+      // stop the background threads before any of the data they use goes away
+      pipeline_.reset();
     }
     /// Set the peak file options
     void MzMLHandler::setOptions(const PeakFileOptions& opt)
@@ -140,7 +304,67 @@ namespace OpenMS
 
     void MzMLHandler::populateSpectraWithData_()
     {
+      if (options_.getPipelinedDecoding())
+      {
+        pipelineData_();
+        return;
+      }
+      decodeSpectra_(spectrum_data_);
+      deliverSpectra_(spectrum_data_);
+
+      // Delete batch
+      spectrum_data_.clear();
+    }
 
+    void MzMLHandler::populateChromatogramsWithData_()
+    {
+      if (options_.getPipelinedDecoding())
+      {
+        pipelineData_();
+        return;
+      }
+      decodeChromatograms_(chromatogram_data_);
+      deliverChromatograms_(chromatogram_data_);
+
+      // Delete batch
+      chromatogram_data_.clear();
+    }
+
+    void MzMLHandler::pipelineData_()
+    {
+      if (spectrum_data_.empty() && chromatogram_data_.empty()) return;
+
+      DecodingPipeline_::Chunk chunk;
+      chunk.spectra.swap(spectrum_data_);
+      chunk.chromatograms.swap(chromatogram_data_);
+      for (const SpectrumData& s : chunk.spectra)
+      {
+        for (const BinaryData& d : s.data) chunk.bytes += d.base64.size();
+      }
+      for (const ChromatogramData& c : chunk.chromatograms)
+      {
+        for (const BinaryData& d : c.data) chunk.bytes += d.base64.size();
+      }
+      spectrum_data_.reserve(options_.getMaxDataPoolSize());
+      chromatogram_data_.reserve(options_.getMaxDataPoolSize());
+
+      if (pipeline_ == nullptr)
+      {
+        pipeline_.reset(new DecodingPipeline_(*this, options_.getMaxPipelineBytes()));
+      }
+      pipeline_->push(std::move(chunk));
+    }
+
+    void MzMLHandler::drainPipeline_()
+    {
+      if (pipeline_ != nullptr)
+      {
+        pipeline_->drain();
+      }
+    }
+
+    void MzMLHandler::decodeSpectra_(std::vector<SpectrumData>& data)
+    {
       // Whether spectrum should be populated with data
       if (options_.getFillData())
       {
@@ -148,20 +372,20 @@ namespace OpenMS
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
-        for (SignedSize i = 0; i < (SignedSize)spectrum_data_.size(); i++)
+        for (SignedSize i = 0; i < (SignedSize)data.size(); i++)
         {
           // parallel exception catching and re-throwing business
           if (!errCount) // no need to parse further if already an error was encountered
           {
             try
             {
-              populateSpectraWithData_(spectrum_data_[i].data,
-                                       spectrum_data_[i].default_array_length,
+              populateSpectraWithData_(data[i].data,
+                                       data[i].default_array_length,
                                        options_,
-                                       spectrum_data_[i].spectrum);
-              if (options_.getSortSpectraByMZ() && !spectrum_data_[i].spectrum.isSorted())
+                                       data[i].spectrum);
+              if (options_.getSortSpectraByMZ() && !data[i].spectrum.isSorted())
               {
-                spectrum_data_[i].spectrum.sortByPosition();
+                data[i].spectrum.sortByPosition();
               }
             }
             catch (...)
@@ -176,29 +400,29 @@ namespace OpenMS
           throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, file_, "Error during parsing of binary data.");
         }
       }
+    }
 
+    void MzMLHandler::deliverSpectra_(std::vector<SpectrumData>& data)
+    {
       // Append all spectra to experiment / consumer
-      for (Size i = 0; i < spectrum_data_.size(); i++)
+      for (Size i = 0; i < data.size(); i++)
       {
         if (consumer_ != nullptr)
         {
-          consumer_->consumeSpectrum(spectrum_data_[i].spectrum);
+          consumer_->consumeSpectrum(data[i].spectrum);
           if (options_.getAlwaysAppendData())
           {
-            exp_->addSpectrum(std::move(spectrum_data_[i].spectrum));
+            exp_->addSpectrum(std::move(data[i].spectrum));
           }
         }
         else
         {
-          exp_->addSpectrum(std::move(spectrum_data_[i].spectrum));
+          exp_->addSpectrum(std::move(data[i].spectrum));
         }
       }
-
-      // Delete batch
-      spectrum_data_.clear();
     }
 
-    void MzMLHandler::populateChromatogramsWithData_()
+    void MzMLHandler::decodeChromatograms_(std::vector<ChromatogramData>& data)
     {
       // Whether chromatogram should be populated with data
       if (options_.getFillData())
@@ -207,22 +431,25 @@ namespace OpenMS
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
-        for (SignedSize i = 0; i < (SignedSize)chromatogram_data_.size(); i++)
+        for (SignedSize i = 0; i < (SignedSize)data.size(); i++)
         {
           // parallel exception catching and re-throwing business
           try
           {
-            populateChromatogramsWithData_(chromatogram_data_[i].data,
-                                           chromatogram_data_[i].default_array_length,
+            populateChromatogramsWithData_(data[i].data,
+                                           data[i].default_array_length,
                                            options_,
-                                           chromatogram_data_[i].chromatogram);
-            if (options_.getSortChromatogramsByRT() && !chromatogram_data_[i].chromatogram.isSorted())
+                                           data[i].chromatogram);
+            if (options_.getSortChromatogramsByRT() && !data[i].chromatogram.isSorted())
             {
-              chromatogram_data_[i].chromatogram.sortByPosition();
+              data[i].chromatogram.sortByPosition();
             }
           }
           catch (...)
-          {++errCount; }
+          {
+#pragma omp atomic
+            ++errCount;
+          }
         }
         if (errCount != 0)
         {
@@ -230,26 +457,26 @@ namespace OpenMS
         }
 
       }
+    }
 
+    void MzMLHandler::deliverChromatograms_(std::vector<ChromatogramData>& data)
+    {
       // Append all chromatograms to experiment / consumer
-      for (Size i = 0; i < chromatogram_data_.size(); i++)
+      for (Size i = 0; i < data.size(); i++)
       {
         if (consumer_ != nullptr)
         {
-          consumer_->consumeChromatogram(chromatogram_data_[i].chromatogram);
+          consumer_->consumeChromatogram(data[i].chromatogram);
           if (options_.getAlwaysAppendData())
           {
-            exp_->addChromatogram(std::move(chromatogram_data_[i].chromatogram));
+            exp_->addChromatogram(std::move(data[i].chromatogram));
           }
         }
         else
         {
-          exp_->addChromatogram(std::move(chromatogram_data_[i].chromatogram));
+          exp_->addChromatogram(std::move(data[i].chromatogram));
         }
       }
-
-      // Delete batch
-      chromatogram_data_.clear();
     }
 
     void MzMLHandler::addSpectrumMetaData_(const std::vector<MzMLHandlerHelper::BinaryData>& input_data,
@@ -797,6 +1024,7 @@ namespace OpenMS
         }
         else
         {
+          drainPipeline_();
           exp_->reserveSpaceSpectra(scan_count_total_);
         }
       }
@@ -822,6 +1050,7 @@ namespace OpenMS
         }
         else
         {
+          drainPipeline_();
           exp_->reserveSpaceChromatograms(chrom_count_total_);
         }
       }
@@ -1297,6 +1526,7 @@ namespace OpenMS
         // Flush the remaining data
         populateSpectraWithData_();
         populateChromatogramsWithData_();
+        drainPipeline_();
       }
     }
 
@@ -0,0 +1,1148 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/IdBinaryFile.h>
+
+#include <OpenMS/CHEMISTRY/AASequencePool.h>
+#include <OpenMS/CHEMISTRY/ProteaseDB.h>
+#include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/FORMAT/ZlibCompression.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <QFile>
+
+#include <cstring>
+#include <fstream>
+
+using namespace std;
+
+namespace OpenMS
+{
+  namespace
+  {
+    const char MAGIC[8] = {'O', 'M', 'S', 'I', 'D', 'B', 'I', 'N'};
+    const UInt32 BYTE_ORDER_MARK = 0x01020304;
+    const UInt32 FLAG_ZLIB = 1;
+    const UInt64 HEADER_SIZE = 24; // magic, version, byte order mark, number of sections, reserved
+    const UInt64 SECTION_ENTRY_SIZE = 32; // kind, flags, offset, stored size, raw size
+
+    /// Kinds of sections (values are part of the file format)
+    enum SectionKind
+    {
+      SECTION_STRINGS = 1,
+      SECTION_RUNS = 2,
+      SECTION_IDENTIFICATIONS = 3,
+      SECTION_HITS = 4,
+      SECTION_EVIDENCES = 5,
+      SECTION_EXTRAS = 6,
+      SIZE_OF_SECTIONKIND
+    };
+
+    /// Column offsets in the identifications section (after the count)
+    struct IdColumns
+    {
+      explicit IdColumns(UInt64 n) :
+        rt(8), mz(rt + 8 * n), threshold(mz + 8 * n), hit_begin(threshold + 8 * n),
+        identifier(hit_begin + 8 * (n + 1)), score_type(identifier + 4 * n),
+        base_name(score_type + 4 * n), higher_better(base_name + 4 * n), end(higher_better + n)
+      {
+      }
+      UInt64 rt, mz, threshold, hit_begin, identifier, score_type, base_name, higher_better, end;
+    };
+
+    /// Column offsets in the hits section (after the count)
+    struct HitColumns
+    {
+      explicit HitColumns(UInt64 n) :
+        score(8), evidence_begin(score + 8 * n), sequence(evidence_begin + 8 * (n + 1)),
+        rank(sequence + 4 * n), charge(rank + 4 * n), end(charge + 4 * n)
+      {
+      }
+      UInt64 score, evidence_begin, sequence, rank, charge, end;
+    };
+
+    /// Column offsets in the evidences section (after the count)
+    struct EvidenceColumns
+    {
+      explicit EvidenceColumns(UInt64 n) :
+        start(8), end_pos(start + 4 * n), accession(end_pos + 4 * n),
+        aa_before(accession + 4 * n), aa_after(aa_before + n), end(aa_after + n)
+      {
+      }
+      UInt64 start, end_pos, accession, aa_before, aa_after, end;
+    };
+
+    /// Column offsets in the extras section (after the two counts)
+    struct ExtraColumns
+    {
+      ExtraColumns(UInt64 n_ids, UInt64 n_hits) :
+        id_offset(16), hit_offset(id_offset + 8 * (n_ids + 1)), blob(hit_offset + 8 * (n_hits + 1))
+      {
+      }
+      UInt64 id_offset, hit_offset, blob;
+    };
+
+    /// Collects distinct strings and assigns indices to them
+    class StringTable
+    {
+public:
+      UInt32 intern(const String& s)
+      {
+        std::unordered_map<String, UInt32>::const_iterator it = index_.find(s);
+        if (it != index_.end()) return it->second;
+        UInt32 index = UInt32(strings_.size());
+        index_.emplace(s, index);
+        strings_.push_back(s);
+        return index;
+      }
+
+      const std::vector<String>& getStrings() const
+      {
+        return strings_;
+      }
+
+protected:
+      std::unordered_map<String, UInt32> index_;
+      std::vector<String> strings_;
+    };
+
+    /// Appends binary data to a buffer
+    class ByteWriter
+    {
+public:
+      explicit ByteWriter(StringTable& strings) :
+        strings_(strings)
+      {
+      }
+
+      template <typename T>
+      void put(T value)
+      {
+        data_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+      }
+
+      template <typename T>
+      void putArray(const std::vector<T>& values)
+      {
+        if (!values.empty())
+        {
+          data_.append(reinterpret_cast<const char*>(&values[0]), sizeof(T) * values.size());
+        }
+      }
+
+      void putString(const String& s)
+      {
+        put<UInt32>(strings_.intern(s));
+      }
+
+      void putStrings(const std::vector<String>& strings)
+      {
+        put<UInt32>(UInt32(strings.size()));
+        for (const String& s : strings) putString(s);
+      }
+
+      void putDataValue(const DataValue& value)
+      {
+        put<Byte>(Byte(value.valueType()));
+        put<Byte>(Byte(value.getUnitType()));
+        put<Int32>(value.hasUnit() ? Int32(value.getUnit()) : Int32(-1));
+        switch (value.valueType())
+        {
+          case DataValue::STRING_VALUE:
+            putString(value.toString());
+            break;
+
+          case DataValue::INT_VALUE:
+            put<Int64>(Int64(static_cast<long long>(value)));
+            break;
+
+          case DataValue::DOUBLE_VALUE:
+            put<double>(double(value));
+            break;
+
+          case DataValue::STRING_LIST:
+          {
+            StringList list = value.toStringList();
+            put<UInt32>(UInt32(list.size()));
+            for (const String& s : list) putString(s);
+            break;
+          }
+
+          case DataValue::INT_LIST:
+          {
+            IntList list = value.toIntList();
+            put<UInt32>(UInt32(list.size()));
+            for (Int i : list) put<Int64>(Int64(i));
+            break;
+          }
+
+          case DataValue::DOUBLE_LIST:
+          {
+            DoubleList list = value.toDoubleList();
+            put<UInt32>(UInt32(list.size()));
+            for (double d : list) put<double>(d);
+            break;
+          }
+
+          default: // EMPTY_VALUE
+            break;
+        }
+      }
+
+      void putMetaInfo(const MetaInfoInterface& meta)
+      {
+        std::vector<String> keys;
+        meta.getKeys(keys);
+        put<UInt32>(UInt32(keys.size()));
+        for (const String& key : keys)
+        {
+          putString(key);
+          putDataValue(meta.getMetaValue(key));
+        }
+      }
+
+      /// Pads the buffer with zeros to a multiple of @p alignment
+      void align(Size alignment)
+      {
+        if (data_.size() % alignment != 0)
+        {
+          data_.append(alignment - data_.size() % alignment, '\0');
+        }
+      }
+
+      std::string& data()
+      {
+        return data_;
+      }
+
+protected:
+      StringTable& strings_;
+      std::string data_;
+    };
+
+    /// Random access to the string table section
+    class StringTableView
+    {
+public:
+      StringTableView() :
+        data_(nullptr), size_(0), n_(0)
+      {
+      }
+
+      StringTableView(const char* data, UInt64 size, UInt64 n) :
+        data_(data), size_(size), n_(n)
+      {
+      }
+
+      String get(UInt32 index) const
+      {
+        if (index >= n_)
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String(index), "String index out of range in idBin file");
+        }
+        UInt64 begin, end;
+        memcpy(&begin, data_ + 8 + 8 * UInt64(index), 8);
+        memcpy(&end, data_ + 8 + 8 * (UInt64(index) + 1), 8);
+        const UInt64 chars = 8 + 8 * (n_ + 1);
+        if (begin > end || chars + end > size_)
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String(index), "Corrupt string table in idBin file");
+        }
+        return String(std::string(data_ + chars + begin, end - begin));
+      }
+
+protected:
+      const char* data_;
+      UInt64 size_;
+      UInt64 n_;
+    };
+
+    /// Sequential reading of binary data (with bounds checks)
+    class ByteReader
+    {
+public:
+      ByteReader(const char* begin, const char* end, const StringTableView& strings) :
+        pos_(begin), end_(end), strings_(strings)
+      {
+      }
+
+      template <typename T>
+      T get()
+      {
+        if (pos_ + sizeof(T) > end_)
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Unexpected end of section in idBin file");
+        }
+        T value;
+        memcpy(&value, pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return value;
+      }
+
+      String getString()
+      {
+        return strings_.get(get<UInt32>());
+      }
+
+      std::vector<String> getStrings()
+      {
+        std::vector<String> strings(get<UInt32>());
+        for (String& s : strings) s = getString();
+        return strings;
+      }
+
+      DataValue getDataValue()
+      {
+        DataValue::DataType type = DataValue::DataType(get<Byte>());
+        DataValue::UnitType unit_type = DataValue::UnitType(get<Byte>());
+        Int32 unit = get<Int32>();
+        DataValue value;
+        switch (type)
+        {
+          case DataValue::STRING_VALUE:
+            value = DataValue(getString());
+            break;
+
+          case DataValue::INT_VALUE:
+            value = DataValue(static_cast<long long>(get<Int64>()));
+            break;
+
+          case DataValue::DOUBLE_VALUE:
+            value = DataValue(get<double>());
+            break;
+
+          case DataValue::STRING_LIST:
+          {
+            StringList list(get<UInt32>());
+            for (String& s : list) s = getString();
+            value = DataValue(list);
+            break;
+          }
+
+          case DataValue::INT_LIST:
+          {
+            IntList list(get<UInt32>());
+            for (Int& i : list) i = Int(get<Int64>());
+            value = DataValue(list);
+            break;
+          }
+
+          case DataValue::DOUBLE_LIST:
+          {
+            DoubleList list(get<UInt32>());
+            for (double& d : list) d = get<double>();
+            value = DataValue(list);
+            break;
+          }
+
+          case DataValue::EMPTY_VALUE:
+            break;
+
+          default:
+            throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String(Int(type)), "Unknown meta value type in idBin file");
+        }
+        if (unit != -1)
+        {
+          value.setUnitType(unit_type);
+          value.setUnit(unit);
+        }
+        return value;
+      }
+
+      void getMetaInfo(MetaInfoInterface& meta)
+      {
+        UInt32 n = get<UInt32>();
+        for (UInt32 i = 0; i < n; ++i)
+        {
+          String key = getString();
+          meta.setMetaValue(key, getDataValue());
+        }
+      }
+
+protected:
+      const char* pos_;
+      const char* end_;
+      const StringTableView& strings_;
+    };
+
+    void writeProteinGroups(ByteWriter& writer, const std::vector<ProteinIdentification::ProteinGroup>& groups)
+    {
+      writer.put<UInt64>(groups.size());
+      for (const ProteinIdentification::ProteinGroup& group : groups)
+      {
+        writer.put<double>(group.probability);
+        writer.putStrings(group.accessions);
+      }
+    }
+
+    void readProteinGroups(ByteReader& reader, std::vector<ProteinIdentification::ProteinGroup>& groups)
+    {
+      groups.resize(reader.get<UInt64>());
+      for (ProteinIdentification::ProteinGroup& group : groups)
+      {
+        group.probability = reader.get<double>();
+        group.accessions = reader.getStrings();
+      }
+    }
+
+    void writeRun(ByteWriter& writer, const ProteinIdentification& run)
+    {
+      writer.putString(run.getIdentifier());
+      writer.putString(run.getSearchEngine());
+      writer.putString(run.getSearchEngineVersion());
+      writer.putString(run.getDateTime().isValid() ? run.getDateTime().get() : String());
+      writer.putString(run.getScoreType());
+      writer.put<Byte>(run.isHigherScoreBetter());
+      writer.put<double>(run.getSignificanceThreshold());
+
+      const ProteinIdentification::SearchParameters& params = run.getSearchParameters();
+      writer.putString(params.db);
+      writer.putString(params.db_version);
+      writer.putString(params.taxonomy);
+      writer.putString(params.charges);
+      writer.put<Byte>(Byte(params.mass_type));
+      writer.putStrings(params.fixed_modifications);
+      writer.putStrings(params.variable_modifications);
+      writer.put<UInt32>(params.missed_cleavages);
+      writer.put<double>(params.fragment_mass_tolerance);
+      writer.put<Byte>(params.fragment_mass_tolerance_ppm);
+      writer.put<double>(params.precursor_mass_tolerance);
+      writer.put<Byte>(params.precursor_mass_tolerance_ppm);
+      writer.putString(params.digestion_enzyme.getName());
+      writer.putMetaInfo(params);
+
+      writer.putMetaInfo(run);
+
+      writer.put<UInt64>(run.getHits().size());
+      for (const ProteinHit& hit : run.getHits())
+      {
+        writer.putString(hit.getAccession());
+        writer.putString(hit.getSequence());
+        writer.put<double>(hit.getScore());
+        writer.put<UInt32>(hit.getRank());
+        writer.put<double>(hit.getCoverage());
+        writer.putMetaInfo(hit);
+      }
+      writeProteinGroups(writer, run.getProteinGroups());
+      writeProteinGroups(writer, run.getIndistinguishableProteins());
+    }
+
+    void readRun(ByteReader& reader, ProteinIdentification& run)
+    {
+      run.setIdentifier(reader.getString());
+      run.setSearchEngine(reader.getString());
+      run.setSearchEngineVersion(reader.getString());
+      String date = reader.getString();
+      if (!date.empty())
+      {
+        DateTime date_time;
+        date_time.set(date);
+        run.setDateTime(date_time);
+      }
+      run.setScoreType(reader.getString());
+      run.setHigherScoreBetter(reader.get<Byte>() != 0);
+      run.setSignificanceThreshold(reader.get<double>());
+
+      ProteinIdentification::SearchParameters params;
+      params.db = reader.getString();
+      params.db_version = reader.getString();
+      params.taxonomy = reader.getString();
+      params.charges = reader.getString();
+      params.mass_type = ProteinIdentification::PeakMassType(reader.get<Byte>());
+      params.fixed_modifications = reader.getStrings();
+      params.variable_modifications = reader.getStrings();
+      params.missed_cleavages = reader.get<UInt32>();
+      params.fragment_mass_tolerance = reader.get<double>();
+      params.fragment_mass_tolerance_ppm = reader.get<Byte>() != 0;
+      params.precursor_mass_tolerance = reader.get<double>();
+      params.precursor_mass_tolerance_ppm = reader.get<Byte>() != 0;
+      String enzyme = reader.getString();
+      if (ProteaseDB::getInstance()->hasEnzyme(enzyme))
+      {
+        params.digestion_enzyme = *(ProteaseDB::getInstance()->getEnzyme(enzyme));
+      }
+      reader.getMetaInfo(params);
+      run.setSearchParameters(std::move(params));
+
+      reader.getMetaInfo(run);
+
+      std::vector<ProteinHit> hits(reader.get<UInt64>());
+      for (ProteinHit& hit : hits)
+      {
+        hit.setAccession(reader.getString());
+        hit.setSequence(reader.getString());
+        hit.setScore(reader.get<double>());
+        hit.setRank(reader.get<UInt32>());
+        hit.setCoverage(reader.get<double>());
+        reader.getMetaInfo(hit);
+      }
+      run.setHits(hits);
+      readProteinGroups(reader, run.getProteinGroups());
+      readProteinGroups(reader, run.getIndistinguishableProteins());
+    }
+  }
+
+  const UInt32 IdBinaryFile::FORMAT_VERSION = 1;
+
+  IdBinaryFile::IdBinaryFile() :
+    ProgressLogger(),
+    compress_(false)
+  {
+  }
+
+  IdBinaryFile::~IdBinaryFile()
+  {
+  }
+
+  void IdBinaryFile::setCompression(bool compress)
+  {
+    compress_ = compress;
+  }
+
+  bool IdBinaryFile::getCompression() const
+  {
+    return compress_;
+  }
+
+  bool IdBinaryFile::isIdBinaryFile(const String& filename)
+  {
+    std::ifstream is(filename.c_str(), std::ios::binary);
+    char magic[sizeof(MAGIC)];
+    if (!is.read(magic, sizeof(MAGIC))) return false;
+    return memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+  }
+
+  void IdBinaryFile::load(const String& filename, std::vector<ProteinIdentification>& protein_ids, std::vector<PeptideIdentification>& peptide_ids)
+  {
+    peptide_ids.clear();
+    load_(filename, protein_ids, [&peptide_ids](PeptideIdentification& id) { peptide_ids.push_back(std::move(id)); });
+  }
+
+  void IdBinaryFile::load(const String& filename, std::vector<ProteinIdentification>& protein_ids, ColumnarPSMStore& psms)
+  {
+    psms.clear();
+    load_(filename, protein_ids, [&psms](PeptideIdentification& id) { psms.push_back(id); });
+  }
+
+  void IdBinaryFile::load_(const String& filename, std::vector<ProteinIdentification>& protein_ids,
+                           std::function<void(PeptideIdentification&)> add_peptide_id)
+  {
+    MappedFile file(filename);
+    file.getProteinIdentifications(protein_ids);
+
+    startProgress(0, file.size(), "loading idBin file");
+    std::unordered_map<UInt32, InternedAASequence> sequence_cache;
+    for (Size i = 0; i < file.size(); ++i)
+    {
+      setProgress(i);
+      PeptideIdentification id;
+      file.fillPeptideIdentification_(i, id, &sequence_cache);
+      add_peptide_id(id);
+    }
+    endProgress();
+  }
+
+  void IdBinaryFile::store(const String& filename, const std::vector<ProteinIdentification>& protein_ids, const std::vector<PeptideIdentification>& peptide_ids)
+  {
+    store_(filename, protein_ids, peptide_ids.size(),
+           [&peptide_ids](Size i, PeptideIdentification& id) { id = peptide_ids[i]; });
+  }
+
+  void IdBinaryFile::store(const String& filename, const std::vector<ProteinIdentification>& protein_ids, const ColumnarPSMStore& psms)
+  {
+    store_(filename, protein_ids, psms.size(),
+           [&psms](Size i, PeptideIdentification& id) { id = psms.getPeptideIdentification(i); });
+  }
+
+  void IdBinaryFile::store_(const String& filename, const std::vector<ProteinIdentification>& protein_ids,
+                            Size peptide_id_count, std::function<void(Size, PeptideIdentification&)> get_peptide_id)
+  {
+    std::ofstream os(filename.c_str(), std::ios::binary);
+    if (!os)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    StringTable strings;
+
+    ByteWriter runs(strings);
+    runs.put<UInt64>(protein_ids.size());
+    for (const ProteinIdentification& run : protein_ids)
+    {
+      writeRun(runs, run);
+    }
+
+    // peptide identification columns
+    std::vector<double> rt, mz, threshold;
+    std::vector<UInt64> hit_begin(1, 0);
+    std::vector<UInt32> identifier, score_type, base_name;
+    std::vector<Byte> higher_better;
+    // peptide hit columns
+    std::vector<double> score;
+    std::vector<UInt64> evidence_begin(1, 0);
+    std::vector<UInt32> sequence, rank;
+    std::vector<Int32> charge;
+    // peptide evidence columns
+    std::vector<Int32> ev_start, ev_end;
+    std::vector<UInt32> ev_accession;
+    std::vector<char> ev_before, ev_after;
+    // variable-sized data
+    std::vector<UInt64> id_extra_begin(1, 0), hit_extra_begin(1, 0);
+    ByteWriter extras(strings);
+
+    startProgress(0, peptide_id_count, "storing idBin file");
+    PeptideIdentification id;
+    for (Size i = 0; i < peptide_id_count; ++i)
+    {
+      setProgress(i);
+      get_peptide_id(i, id);
+
+      rt.push_back(id.getRT());
+      mz.push_back(id.getMZ());
+      threshold.push_back(id.getSignificanceThreshold());
+      identifier.push_back(strings.intern(id.getIdentifier()));
+      score_type.push_back(strings.intern(id.getScoreType()));
+      base_name.push_back(strings.intern(id.getBaseName()));
+      higher_better.push_back(id.isHigherScoreBetter());
+      extras.putMetaInfo(id);
+      id_extra_begin.push_back(extras.data().size());
+
+      for (const PeptideHit& hit : id.getHits())
+      {
+        score.push_back(hit.getScore());
+        sequence.push_back(strings.intern(hit.getSequence().toString()));
+        rank.push_back(hit.getRank());
+        charge.push_back(hit.getCharge());
+
+        for (const PeptideEvidence& evidence : hit.getPeptideEvidences())
+        {
+          ev_start.push_back(evidence.getStart());
+          ev_end.push_back(evidence.getEnd());
+          ev_accession.push_back(strings.intern(evidence.getProteinAccession()));
+          ev_before.push_back(evidence.getAABefore());
+          ev_after.push_back(evidence.getAAAfter());
+        }
+        evidence_begin.push_back(ev_start.size());
+
+        extras.putMetaInfo(hit);
+        extras.put<UInt32>(UInt32(hit.getAnalysisResults().size()));
+        for (const PeptideHit::PepXMLAnalysisResult& result : hit.getAnalysisResults())
+        {
+          extras.putString(result.score_type);
+          extras.put<Byte>(result.higher_is_better);
+          extras.put<double>(result.main_score);
+          extras.put<UInt32>(UInt32(result.sub_scores.size()));
+          for (const std::pair<const String, double>& sub_score : result.sub_scores)
+          {
+            extras.putString(sub_score.first);
+            extras.put<double>(sub_score.second);
+          }
+        }
+        extras.put<UInt32>(UInt32(hit.getPeakAnnotations().size()));
+        for (const PeptideHit::PeakAnnotation& annotation : hit.getPeakAnnotations())
+        {
+          extras.putString(annotation.annotation);
+          extras.put<Int32>(annotation.charge);
+          extras.put<double>(annotation.mz);
+          extras.put<double>(annotation.intensity);
+        }
+        hit_extra_begin.push_back(extras.data().size());
+      }
+      hit_begin.push_back(score.size());
+    }
+    endProgress();
+
+    // assemble the sections (column order has to match IdColumns etc.)
+    std::vector<std::pair<UInt32, std::string> > sections;
+
+    ByteWriter ids(strings);
+    ids.put<UInt64>(rt.size());
+    ids.putArray(rt);
+    ids.putArray(mz);
+    ids.putArray(threshold);
+    ids.putArray(hit_begin);
+    ids.putArray(identifier);
+    ids.putArray(score_type);
+    ids.putArray(base_name);
+    ids.putArray(higher_better);
+
+    ByteWriter hits(strings);
+    hits.put<UInt64>(score.size());
+    hits.putArray(score);
+    hits.putArray(evidence_begin);
+    hits.putArray(sequence);
+    hits.putArray(rank);
+    hits.putArray(charge);
+
+    ByteWriter evidences(strings);
+    evidences.put<UInt64>(ev_start.size());
+    evidences.putArray(ev_start);
+    evidences.putArray(ev_end);
+    evidences.putArray(ev_accession);
+    evidences.putArray(ev_before);
+    evidences.putArray(ev_after);
+
+    ByteWriter extra_section(strings);
+    extra_section.put<UInt64>(rt.size());
+    extra_section.put<UInt64>(score.size());
+    extra_section.putArray(id_extra_begin);
+    extra_section.putArray(hit_extra_begin);
+    extra_section.data().append(extras.data());
+
+    // no more strings can be added from here on
+    ByteWriter string_section(strings);
+    const std::vector<String>& string_list = strings.getStrings();
+    string_section.put<UInt64>(string_list.size());
+    UInt64 string_offset = 0;
+    string_section.put<UInt64>(string_offset);
+    for (const String& s : string_list)
+    {
+      string_offset += s.size();
+      string_section.put<UInt64>(string_offset);
+    }
+    for (const String& s : string_list)
+    {
+      string_section.data().append(s);
+    }
+
+    sections.emplace_back(SECTION_STRINGS, std::move(string_section.data()));
+    sections.emplace_back(SECTION_RUNS, std::move(runs.data()));
+    sections.emplace_back(SECTION_IDENTIFICATIONS, std::move(ids.data()));
+    sections.emplace_back(SECTION_HITS, std::move(hits.data()));
+    sections.emplace_back(SECTION_EVIDENCES, std::move(evidences.data()));
+    sections.emplace_back(SECTION_EXTRAS, std::move(extra_section.data()));
+
+    // header and section table
+    ByteWriter header(strings);
+    header.data().append(MAGIC, sizeof(MAGIC));
+    header.put<UInt32>(FORMAT_VERSION);
+    header.put<UInt32>(BYTE_ORDER_MARK);
+    header.put<UInt32>(UInt32(sections.size()));
+    header.put<UInt32>(0);
+
+    std::vector<UInt64> raw_sizes;
+    std::vector<UInt32> flags;
+    for (std::pair<UInt32, std::string>& section : sections)
+    {
+      raw_sizes.push_back(section.second.size());
+      flags.push_back(0);
+      if (compress_ && !section.second.empty())
+      {
+        std::string compressed;
+        ZlibCompression::compressString(section.second, compressed);
+        section.second.swap(compressed);
+        flags.back() = FLAG_ZLIB;
+      }
+    }
+
+    UInt64 offset = HEADER_SIZE + SECTION_ENTRY_SIZE * sections.size();
+    for (Size i = 0; i < sections.size(); ++i)
+    {
+      offset += (8 - offset % 8) % 8; // sections start at 8 byte boundaries
+      header.put<UInt32>(sections[i].first);
+      header.put<UInt32>(flags[i]);
+      header.put<UInt64>(offset);
+      header.put<UInt64>(sections[i].second.size());
+      header.put<UInt64>(raw_sizes[i]);
+      offset += sections[i].second.size();
+    }
+
+    os.write(header.data().data(), header.data().size());
+    UInt64 written = header.data().size();
+    for (const std::pair<UInt32, std::string>& section : sections)
+    {
+      const std::string padding((8 - written % 8) % 8, '\0');
+      os.write(padding.data(), padding.size());
+      os.write(section.second.data(), section.second.size());
+      written += padding.size() + section.second.size();
+    }
+    if (!os)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "Error while writing idBin file");
+    }
+  }
+
+  IdBinaryFile::MappedFile::MappedFile(const String& filename) :
+    filename_(filename),
+    file_(nullptr),
+    data_(nullptr),
+    data_size_(0),
+    mapped_(false),
+    sections_(SIZE_OF_SECTIONKIND),
+    n_ids_(0),
+    n_hits_(0),
+    n_evidences_(0),
+    n_strings_(0)
+  {
+    if (!File::exists(filename))
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    file_ = new QFile(filename.toQString());
+    if (!file_->open(QFile::ReadOnly))
+    {
+      delete file_;
+      throw Exception::FileNotReadable(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    data_size_ = file_->size();
+    unsigned char* mapping = (data_size_ > 0) ? file_->map(0, data_size_) : nullptr;
+    if (mapping != nullptr)
+    {
+      data_ = reinterpret_cast<const char*>(mapping);
+      mapped_ = true;
+    }
+    else // e.g. file systems that do not support mapping
+    {
+      QByteArray content = file_->readAll();
+      buffer_.assign(content.constData(), content.size());
+      data_ = buffer_.data();
+      data_size_ = buffer_.size();
+    }
+
+    try
+    {
+      if (data_size_ < HEADER_SIZE || memcmp(data_, MAGIC, sizeof(MAGIC)) != 0)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "File is not an idBin file (wrong magic number): " + filename);
+      }
+      UInt32 version, byte_order, n_sections;
+      memcpy(&version, data_ + 8, 4);
+      memcpy(&byte_order, data_ + 12, 4);
+      memcpy(&n_sections, data_ + 16, 4);
+      if (version > FORMAT_VERSION)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String(version), "idBin file was written by a newer version of OpenMS: " + filename);
+      }
+      if (byte_order != BYTE_ORDER_MARK)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "idBin file was written on a machine with different byte order: " + filename);
+      }
+      if (HEADER_SIZE + SECTION_ENTRY_SIZE * UInt64(n_sections) > data_size_)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Truncated idBin file: " + filename);
+      }
+
+      decompressed_.reserve(n_sections); // pointers into the buffers must stay valid
+      for (UInt32 i = 0; i < n_sections; ++i)
+      {
+        const char* entry = data_ + HEADER_SIZE + SECTION_ENTRY_SIZE * i;
+        UInt32 kind, flags;
+        UInt64 offset, stored_size, raw_size;
+        memcpy(&kind, entry, 4);
+        memcpy(&flags, entry + 4, 4);
+        memcpy(&offset, entry + 8, 8);
+        memcpy(&stored_size, entry + 16, 8);
+        memcpy(&raw_size, entry + 24, 8);
+        if (offset > data_size_ || stored_size > data_size_ - offset)
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Truncated idBin file: " + filename);
+        }
+        if (kind >= SIZE_OF_SECTIONKIND) continue; // unknown section (written by a newer version), skip it
+
+        Section_& section = sections_[kind];
+        if ((flags & FLAG_ZLIB) && raw_size > 0)
+        {
+          decompressed_.push_back(std::string());
+          ZlibCompression::uncompressString(data_ + offset, stored_size, decompressed_.back());
+          if (decompressed_.back().size() != raw_size)
+          {
+            throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Corrupt compressed section in idBin file: " + filename);
+          }
+          section.data = decompressed_.back().data();
+          section.size = raw_size;
+        }
+        else
+        {
+          section.data = data_ + offset;
+          section.size = stored_size;
+        }
+      }
+
+      // read the counts and check that all columns are complete
+      const Section_& strings = sections_[SECTION_STRINGS];
+      if (strings.size >= 8) memcpy(&n_strings_, strings.data, 8);
+      if (strings.size < 8 + 8 * (n_strings_ + 1) && n_strings_ > 0)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Corrupt string table in idBin file: " + filename);
+      }
+      const Section_& ids = sections_[SECTION_IDENTIFICATIONS];
+      if (ids.size >= 8) memcpy(&n_ids_, ids.data, 8);
+      const Section_& hits = sections_[SECTION_HITS];
+      if (hits.size >= 8) memcpy(&n_hits_, hits.data, 8);
+      const Section_& evidences = sections_[SECTION_EVIDENCES];
+      if (evidences.size >= 8) memcpy(&n_evidences_, evidences.data, 8);
+      const Section_& extras = sections_[SECTION_EXTRAS];
+      if ((n_ids_ > 0 && ids.size < IdColumns(n_ids_).end) ||
+          (n_hits_ > 0 && hits.size < HitColumns(n_hits_).end) ||
+          (n_evidences_ > 0 && evidences.size < EvidenceColumns(n_evidences_).end) ||
+          (n_ids_ > 0 && extras.size < ExtraColumns(n_ids_, n_hits_).blob))
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Truncated section in idBin file: " + filename);
+      }
+    }
+    catch (...)
+    {
+      if (mapped_) file_->unmap(const_cast<unsigned char*>(reinterpret_cast<const unsigned char*>(data_)));
+      delete file_;
+      throw;
+    }
+  }
+
+  IdBinaryFile::MappedFile::~MappedFile()
+  {
+    if (mapped_)
+    {
+      file_->unmap(const_cast<unsigned char*>(reinterpret_cast<const unsigned char*>(data_)));
+    }
+    delete file_;
+  }
+
+  Size IdBinaryFile::MappedFile::size() const
+  {
+    return n_ids_;
+  }
+
+  Size IdBinaryFile::MappedFile::getNumberOfHits() const
+  {
+    return n_hits_;
+  }
+
+  const IdBinaryFile::MappedFile::Section_& IdBinaryFile::MappedFile::getSection_(UInt32 kind) const
+  {
+    return sections_[kind];
+  }
+
+  String IdBinaryFile::MappedFile::getString_(UInt32 index) const
+  {
+    const Section_& strings = getSection_(SECTION_STRINGS);
+    return StringTableView(strings.data, strings.size, n_strings_).get(index);
+  }
+
+  template <typename T>
+  T IdBinaryFile::MappedFile::readColumn_(const Section_& section, UInt64 column_offset, Size index) const
+  {
+    T value;
+    memcpy(&value, section.data + column_offset + sizeof(T) * index, sizeof(T));
+    return value;
+  }
+
+  void IdBinaryFile::MappedFile::getProteinIdentifications(std::vector<ProteinIdentification>& protein_ids) const
+  {
+    const Section_& strings = getSection_(SECTION_STRINGS);
+    StringTableView table(strings.data, strings.size, n_strings_);
+    const Section_& runs = getSection_(SECTION_RUNS);
+    ByteReader reader(runs.data, runs.data + runs.size, table);
+
+    protein_ids.clear();
+    if (runs.size == 0) return;
+    protein_ids.resize(reader.get<UInt64>());
+    for (ProteinIdentification& run : protein_ids)
+    {
+      readRun(reader, run);
+    }
+  }
+
+  Size IdBinaryFile::MappedFile::getHitBegin(Size id_index) const
+  {
+    return readColumn_<UInt64>(getSection_(SECTION_IDENTIFICATIONS), IdColumns(n_ids_).hit_begin, id_index);
+  }
+
+  Size IdBinaryFile::MappedFile::getHitEnd(Size id_index) const
+  {
+    return readColumn_<UInt64>(getSection_(SECTION_IDENTIFICATIONS), IdColumns(n_ids_).hit_begin, id_index + 1);
+  }
+
+  double IdBinaryFile::MappedFile::getRT(Size id_index) const
+  {
+    return readColumn_<double>(getSection_(SECTION_IDENTIFICATIONS), IdColumns(n_ids_).rt, id_index);
+  }
+
+  double IdBinaryFile::MappedFile::getMZ(Size id_index) const
+  {
+    return readColumn_<double>(getSection_(SECTION_IDENTIFICATIONS), IdColumns(n_ids_).mz, id_index);
+  }
+
+  double IdBinaryFile::MappedFile::getScore(Size hit_index) const
+  {
+    return readColumn_<double>(getSection_(SECTION_HITS), HitColumns(n_hits_).score, hit_index);
+  }
+
+  String IdBinaryFile::MappedFile::getSequenceString(Size hit_index) const
+  {
+    return getString_(readColumn_<UInt32>(getSection_(SECTION_HITS), HitColumns(n_hits_).sequence, hit_index));
+  }
+
+  PeptideIdentification IdBinaryFile::MappedFile::getPeptideIdentification(Size id_index) const
+  {
+    if (id_index >= n_ids_)
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, id_index, n_ids_);
+    }
+    PeptideIdentification id;
+    fillPeptideIdentification_(id_index, id, nullptr);
+    return id;
+  }
+
+  PeptideHit IdBinaryFile::MappedFile::getPeptideHit(Size hit_index) const
+  {
+    if (hit_index >= n_hits_)
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, hit_index, n_hits_);
+    }
+    PeptideHit hit;
+    fillPeptideHit_(hit_index, hit, nullptr);
+    return hit;
+  }
+
+  void IdBinaryFile::MappedFile::fillPeptideIdentification_(Size id_index, PeptideIdentification& id, std::unordered_map<UInt32, InternedAASequence>* sequence_cache) const
+  {
+    const Section_& ids = getSection_(SECTION_IDENTIFICATIONS);
+    const IdColumns columns(n_ids_);
+    id.setRT(readColumn_<double>(ids, columns.rt, id_index));
+    id.setMZ(readColumn_<double>(ids, columns.mz, id_index));
+    id.setSignificanceThreshold(readColumn_<double>(ids, columns.threshold, id_index));
+    id.setIdentifier(getString_(readColumn_<UInt32>(ids, columns.identifier, id_index)));
+    id.setScoreType(getString_(readColumn_<UInt32>(ids, columns.score_type, id_index)));
+    id.setBaseName(getString_(readColumn_<UInt32>(ids, columns.base_name, id_index)));
+    id.setHigherScoreBetter(readColumn_<Byte>(ids, columns.higher_better, id_index) != 0);
+
+    const Section_& strings = getSection_(SECTION_STRINGS);
+    StringTableView table(strings.data, strings.size, n_strings_);
+    const Section_& extras = getSection_(SECTION_EXTRAS);
+    const ExtraColumns extra_columns(n_ids_, n_hits_);
+    UInt64 begin = readColumn_<UInt64>(extras, extra_columns.id_offset, id_index);
+    UInt64 end = readColumn_<UInt64>(extras, extra_columns.id_offset, id_index + 1);
+    if (begin > end || extra_columns.blob + end > extras.size)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String(id_index), "Corrupt offsets in idBin file: " + filename_);
+    }
+    ByteReader reader(extras.data + extra_columns.blob + begin, extras.data + extra_columns.blob + end, table);
+    reader.getMetaInfo(id);
+
+    Size hit_begin = getHitBegin(id_index), hit_end = getHitEnd(id_index);
+    if (hit_begin > hit_end || hit_end > n_hits_)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String(id_index), "Corrupt offsets in idBin file: " + filename_);
+    }
+    std::vector<PeptideHit> hits(hit_end - hit_begin);
+    for (Size h = hit_begin; h < hit_end; ++h)
+    {
+      fillPeptideHit_(h, hits[h - hit_begin], sequence_cache);
+    }
+    id.setHits(hits);
+  }
+
+  void IdBinaryFile::MappedFile::fillPeptideHit_(Size hit_index, PeptideHit& hit, std::unordered_map<UInt32, InternedAASequence>* sequence_cache) const
+  {
+    const Section_& hits = getSection_(SECTION_HITS);
+    const HitColumns columns(n_hits_);
+    hit.setScore(readColumn_<double>(hits, columns.score, hit_index));
+    hit.setRank(readColumn_<UInt32>(hits, columns.rank, hit_index));
+    hit.setCharge(readColumn_<Int32>(hits, columns.charge, hit_index));
+
+    UInt32 sequence = readColumn_<UInt32>(hits, columns.sequence, hit_index);
+    if (sequence_cache == nullptr)
+    {
+      hit.setSequence(AASequencePool::getInstance()->intern(getString_(sequence)));
+    }
+    else
+    {
+      std::unordered_map<UInt32, InternedAASequence>::const_iterator it = sequence_cache->find(sequence);
+      if (it == sequence_cache->end())
+      {
+        it = sequence_cache->emplace(sequence, AASequencePool::getInstance()->intern(getString_(sequence))).first;
+      }
+      hit.setSequence(it->second);
+    }
+
+    const Section_& evidences = getSection_(SECTION_EVIDENCES);
+    const EvidenceColumns ev_columns(n_evidences_);
+    UInt64 ev_begin = readColumn_<UInt64>(hits, columns.evidence_begin, hit_index);
+    UInt64 ev_end = readColumn_<UInt64>(hits, columns.evidence_begin, hit_index + 1);
+    if (ev_begin > ev_end || ev_end > n_evidences_)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String(hit_index), "Corrupt offsets in idBin file: " + filename_);
+    }
+    std::vector<PeptideEvidence> peptide_evidences;
+    peptide_evidences.reserve(ev_end - ev_begin);
+    for (UInt64 e = ev_begin; e < ev_end; ++e)
+    {
+      peptide_evidences.emplace_back(getString_(readColumn_<UInt32>(evidences, ev_columns.accession, e)),
+                                     readColumn_<Int32>(evidences, ev_columns.start, e),
+                                     readColumn_<Int32>(evidences, ev_columns.end_pos, e),
+                                     readColumn_<char>(evidences, ev_columns.aa_before, e),
+                                     readColumn_<char>(evidences, ev_columns.aa_after, e));
+    }
+    hit.setPeptideEvidences(std::move(peptide_evidences));
+
+    const Section_& strings = getSection_(SECTION_STRINGS);
+    StringTableView table(strings.data, strings.size, n_strings_);
+    const Section_& extras = getSection_(SECTION_EXTRAS);
+    const ExtraColumns extra_columns(n_ids_, n_hits_);
+    UInt64 begin = readColumn_<UInt64>(extras, extra_columns.hit_offset, hit_index);
+    UInt64 end = readColumn_<UInt64>(extras, extra_columns.hit_offset, hit_index + 1);
+    if (begin > end || extra_columns.blob + end > extras.size)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String(hit_index), "Corrupt offsets in idBin file: " + filename_);
+    }
+    ByteReader reader(extras.data + extra_columns.blob + begin, extras.data + extra_columns.blob + end, table);
+    reader.getMetaInfo(hit);
+
+    std::vector<PeptideHit::PepXMLAnalysisResult> results(reader.get<UInt32>());
+    for (PeptideHit::PepXMLAnalysisResult& result : results)
+    {
+      result.score_type = reader.getString();
+      result.higher_is_better = reader.get<Byte>() != 0;
+      result.main_score = reader.get<double>();
+      UInt32 n_sub_scores = reader.get<UInt32>();
+      for (UInt32 s = 0; s < n_sub_scores; ++s)
+      {
+        String name = reader.getString();
+        result.sub_scores[name] = reader.get<double>();
+      }
+    }
+    if (!results.empty()) hit.setAnalysisResults(results);
+
+    std::vector<PeptideHit::PeakAnnotation> annotations(reader.get<UInt32>());
+    for (PeptideHit::PeakAnnotation& annotation : annotations)
+    {
+      annotation.annotation = reader.getString();
+      annotation.charge = reader.get<Int32>();
+      annotation.mz = reader.get<double>();
+      annotation.intensity = reader.get<double>();
+    }
+    if (!annotations.empty()) hit.setPeakAnnotations(annotations);
+  }
+
+} // namespace OpenMS
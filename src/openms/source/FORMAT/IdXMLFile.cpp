@@ -38,6 +38,7 @@
 #include <OpenMS/CONCEPT/LogStream.h>
 #include <OpenMS/CONCEPT/PrecisionWrapper.h>
 #include <OpenMS/CONCEPT/UniqueIdGenerator.h>
+#include <OpenMS/CHEMISTRY/AASequencePool.h>
 #include <OpenMS/CHEMISTRY/ProteaseDB.h>
 #include <OpenMS/FORMAT/FileHandler.h>
 #include <OpenMS/SYSTEM/File.h>
@@ -53,6 +54,8 @@ namespace OpenMS
   IdXMLFile::IdXMLFile() :
     XMLHandler("", "1.5"),
     XMLFile("/SCHEMAS/IdXML_1_5.xsd", "1.5"),
+    pep_ids_(nullptr),
+    psm_store_(nullptr),
     last_meta_(nullptr),
     document_id_(),
     prot_id_in_run_(false)
@@ -97,7 +100,44 @@ namespace OpenMS
     endProgress();
   }
 
+  void IdXMLFile::load(const String& filename, std::vector<ProteinIdentification>& protein_ids, ColumnarPSMStore& psms)
+  {
+    std::vector<PeptideIdentification> peptide_ids; // stays empty, hits are appended to 'psms'
+    psms.clear();
+    psm_store_ = &psms;
+    try
+    {
+      load(filename, protein_ids, peptide_ids);
+    }
+    catch (...)
+    {
+      psm_store_ = nullptr;
+      throw;
+    }
+    psm_store_ = nullptr;
+  }
+
   void IdXMLFile::store(const String& filename, const std::vector<ProteinIdentification>& protein_ids, const std::vector<PeptideIdentification>& peptide_ids, const String& document_id)
+  {
+    store_(filename, protein_ids, peptide_ids.size(),
+           [&peptide_ids](Size index) -> const String& { return peptide_ids[index].getIdentifier(); },
+           [&peptide_ids](Size index, PeptideIdentification& pep_id) { pep_id = peptide_ids[index]; },
+           document_id);
+  }
+
+  void IdXMLFile::store(const String& filename, const std::vector<ProteinIdentification>& protein_ids, const ColumnarPSMStore& psms, const String& document_id)
+  {
+    // identifications are reconstructed one at a time while writing
+    store_(filename, protein_ids, psms.size(),
+           [&psms](Size index) -> const String& { return psms.getIdentifier(index); },
+           [&psms](Size index, PeptideIdentification& pep_id) { pep_id = psms.getPeptideIdentification(index); },
+           document_id);
+  }
+
+  void IdXMLFile::store_(const String& filename, const std::vector<ProteinIdentification>& protein_ids, Size peptide_id_count,
+                         const std::function<const String&(Size)>& peptide_id_identifier,
+                         const std::function<void(Size, PeptideIdentification&)>& get_peptide_id,
+                         const String& document_id)
   {
     if (!FileHandler::hasValidExtension(filename, FileTypes::IDXML))
     {
@@ -119,7 +159,7 @@ namespace OpenMS
       throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
     }
 
-    startProgress(0, peptide_ids.size(), "Storing idXML");
+    startProgress(0, peptide_id_count, "Storing idXML");
 
     os.precision(writtenDigits<double>(0.0));
 
@@ -278,24 +318,27 @@ namespace OpenMS
       Size count_wrong_id(0);
       Size count_empty(0);
 
-      for (Size l = 0; l < peptide_ids.size(); ++l)
+      // current peptide identification (a copy, since hits are sorted below)
+      PeptideIdentification pep_id;
+      for (Size l = 0; l < peptide_id_count; ++l)
       {
         setProgress(l);
 
-        if (peptide_ids[l].getIdentifier() != protein_ids[i].getIdentifier())
+        if (peptide_id_identifier(l) != protein_ids[i].getIdentifier())
         {
           ++count_wrong_id;
           continue;
         }
-        else if (peptide_ids[l].getHits().empty())
+        get_peptide_id(l, pep_id);
+        if (pep_id.getHits().empty())
         {
           ++count_empty;
           continue;
         }
 
         os << "\t\t<PeptideIdentification "
-           << "score_type=\"" << writeXMLEscape(peptide_ids[l].getScoreType()) << "\" ";
-        if (peptide_ids[l].isHigherScoreBetter())
+           << "score_type=\"" << writeXMLEscape(pep_id.getScoreType()) << "\" ";
+        if (pep_id.isHigherScoreBetter())
         {
           os << "higher_score_better=\"true\" ";
         }
@@ -303,19 +346,19 @@ namespace OpenMS
         {
           os << "higher_score_better=\"false\" ";
         }
-        os << "significance_threshold=\"" << String(peptide_ids[l].getSignificanceThreshold()) << "\" ";
+        os << "significance_threshold=\"" << String(pep_id.getSignificanceThreshold()) << "\" ";
         // mz
-        if (peptide_ids[l].hasMZ())
+        if (pep_id.hasMZ())
         {
-          os << "MZ=\"" << String(peptide_ids[l].getMZ()) << "\" ";
+          os << "MZ=\"" << String(pep_id.getMZ()) << "\" ";
         }
         // rt
-        if (peptide_ids[l].hasRT())
+        if (pep_id.hasRT())
         {
-          os << "RT=\"" << String(peptide_ids[l].getRT()) << "\" ";
+          os << "RT=\"" << String(pep_id.getRT()) << "\" ";
         }
         // spectrum_reference
-        const DataValue& dv = peptide_ids[l].getMetaValue("spectrum_reference");
+        const DataValue& dv = pep_id.getMetaValue("spectrum_reference");
         if (dv != DataValue::EMPTY)
         {
           os << "spectrum_reference=\"" << writeXMLEscape(dv.toString()) << "\" ";
@@ -325,9 +368,6 @@ namespace OpenMS
         // write peptide hits
         std::vector<String> protein_accessions;
 
-        // copy current hit
-        PeptideIdentification pep_id = peptide_ids[l];
-
         // sort by score
         pep_id.sort();
         const vector<PeptideHit>& pep_hits = pep_id.getHits();
@@ -411,11 +451,11 @@ namespace OpenMS
       os << "<IdentificationRun date=\"1900-01-01T01:01:01.0Z\" search_engine=\"Unknown\" search_parameters_ref=\"ID_1\" search_engine_version=\"0\"/>\n";
     }
 
-    for (Size i = 0; i < peptide_ids.size(); ++i)
+    for (Size i = 0; i < peptide_id_count; ++i)
     {
-      if (find(done_identifiers.begin(), done_identifiers.end(), peptide_ids[i].getIdentifier()) == done_identifiers.end())
+      if (find(done_identifiers.begin(), done_identifiers.end(), peptide_id_identifier(i)) == done_identifiers.end())
       {
-        warning(STORE, String("Omitting peptide identification because of missing ProteinIdentification with identifier '") + peptide_ids[i].getIdentifier() + "' while writing '" + filename + "'!");
+        warning(STORE, String("Omitting peptide identification because of missing ProteinIdentification with identifier '") + peptide_id_identifier(i) + "' while writing '" + filename + "'!");
       }
     }
     // write footer
@@ -645,7 +685,8 @@ namespace OpenMS
 
       pep_hit_.setCharge(attributeAsInt_(attributes, "charge"));
       pep_hit_.setScore(attributeAsDouble_(attributes, "score"));
-      pep_hit_.setSequence(AASequence::fromString(String(attributeAsString_(attributes, "sequence"))));
+      // equal sequences are parsed only once and shared between hits:
+      pep_hit_.setSequence(AASequencePool::getInstance()->intern(String(attributeAsString_(attributes, "sequence"))));
 
       //parse optional protein ids to determine accessions
       const XMLCh* refs = attributes.getValue(sm_.convert("protein_refs").c_str());
@@ -885,7 +926,14 @@ namespace OpenMS
     //PEPTIDES
     else if (tag == "PeptideIdentification")
     {
-      pep_ids_->push_back(pep_id_);
+      if (psm_store_ != nullptr)
+      {
+        psm_store_->push_back(pep_id_);
+      }
+      else
+      {
+        pep_ids_->push_back(pep_id_);
+      }
       pep_id_ = PeptideIdentification();
       last_meta_  = nullptr;
     }
@@ -40,6 +40,7 @@
 #include <OpenMS/FORMAT/VALIDATORS/MzMLValidator.h>
 #include <OpenMS/FORMAT/TextFile.h>
 #include <OpenMS/SYSTEM/File.h>
+#include <OpenMS/SYSTEM/Profiler.h>
 
 namespace OpenMS
 {
@@ -167,6 +168,7 @@ namespace OpenMS
 
   void MzMLFile::load(const String& filename, PeakMap& map)
   {
+    OPENMS_PROFILE_SCOPE("MzMLFile::load");
     map.reset();
 
     //set DocumentIdentifier
@@ -180,6 +182,7 @@ namespace OpenMS
 
   void MzMLFile::store(const String& filename, const PeakMap& map) const
   {
+    OPENMS_PROFILE_SCOPE("MzMLFile::store");
     Internal::MzMLHandler handler(map, filename, getVersion(), *this);
     handler.setOptions(options_);
     save_(filename, &handler);
@@ -203,6 +206,7 @@ namespace OpenMS
 
   void MzMLFile::transform(const String& filename_in, Interfaces::IMSDataConsumer* consumer, bool skip_full_count, bool skip_first_pass)
   {
+    OPENMS_PROFILE_SCOPE("MzMLFile::transform");
     // First pass through the file -> get the meta-data and hand it to the consumer
     if (!skip_first_pass) transformFirstPass_(filename_in, consumer, skip_full_count);
 
@@ -218,6 +222,7 @@ namespace OpenMS
 
   void MzMLFile::transform(const String& filename_in, Interfaces::IMSDataConsumer* consumer, PeakMap& map, bool skip_full_count, bool skip_first_pass)
   {
+    OPENMS_PROFILE_SCOPE("MzMLFile::transform");
     // First pass through the file -> get the meta-data and hand it to the consumer
     if (!skip_first_pass) transformFirstPass_(filename_in, consumer, skip_full_count);
 
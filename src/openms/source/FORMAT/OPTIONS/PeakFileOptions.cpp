@@ -63,6 +63,8 @@ namespace OpenMS
     np_config_int_(),
     np_config_fda_(),
     maximal_data_pool_size_(100),
+    pipelined_decoding_(false),
+    max_pipeline_bytes_(256 * 1024 * 1024),
     precursor_mz_selected_ion_(true)
   {
   }
@@ -92,6 +94,8 @@ namespace OpenMS
     np_config_int_(options.np_config_int_),
     np_config_fda_(options.np_config_fda_),
     maximal_data_pool_size_(options.maximal_data_pool_size_),
+    pipelined_decoding_(options.pipelined_decoding_),
+    max_pipeline_bytes_(options.max_pipeline_bytes_),
     precursor_mz_selected_ion_(options.precursor_mz_selected_ion_)
   {
   }
@@ -352,6 +356,26 @@ namespace OpenMS
     maximal_data_pool_size_ = size;
   }
 
+  bool PeakFileOptions::getPipelinedDecoding() const
+  {
+    return pipelined_decoding_;
+  }
+
+  void PeakFileOptions::setPipelinedDecoding(bool pipelined)
+  {
+    pipelined_decoding_ = pipelined;
+  }
+
+  Size PeakFileOptions::getMaxPipelineBytes() const
+  {
+    return max_pipeline_bytes_;
+  }
+
+  void PeakFileOptions::setMaxPipelineBytes(Size bytes)
+  {
+    max_pipeline_bytes_ = bytes;
+  }
+
   bool PeakFileOptions::getPrecursorMZSelectedIon() const
   {
     return precursor_mz_selected_ion_;
@@ -27,6 +27,7 @@ GzipIfstream.cpp
 GzipInputStream.cpp
 HDF5Connector.cpp
 IBSpectraFile.cpp
+IdBinaryFile.cpp
 IdXMLFile.cpp
 IndexedMzMLFileLoader.cpp
 InspectInfile.cpp
@@ -43,6 +43,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <set>
 
 namespace OpenMS
 {
@@ -116,6 +117,65 @@ namespace OpenMS
     return !(operator==(rhs));
   }
 
+  Size MSExperiment::countPeaks(Int ms_level, CoordinateType min_rt, CoordinateType max_rt, CoordinateType min_mz, CoordinateType max_mz) const
+  {
+    Size count(0);
+    const ConstIterator last = RTBegin(max_rt);
+    for (ConstIterator it = RTBegin(min_rt); it < last; ++it)
+    {
+      if (ms_level >= 0 && Int(it->getMSLevel()) != ms_level) continue;
+      SpectrumType::ConstIterator mz_begin = it->MZBegin(min_mz);
+      SpectrumType::ConstIterator mz_end = it->MZBegin(max_mz);
+      if (mz_begin < mz_end) count += mz_end - mz_begin;
+    }
+    return count;
+  }
+
+  Size MSExperiment::exportPeaks(double* rt, double* mz, float* intensity, double* ion_mobility, Size* spectrum_index,
+                                 Int ms_level, CoordinateType min_rt, CoordinateType max_rt, CoordinateType min_mz, CoordinateType max_mz) const
+  {
+    const ConstIterator first = RTBegin(min_rt);
+    const ConstIterator last = RTBegin(max_rt);
+    if (!(first < last)) return 0;
+    const SignedSize n = last - first;
+
+    // output position of the peaks of each spectrum
+    std::vector<Size> offsets(n + 1, 0);
+    for (SignedSize i = 0; i < n; ++i)
+    {
+      const SpectrumType& spec = *(first + i);
+      Size count(0);
+      if (ms_level < 0 || Int(spec.getMSLevel()) == ms_level)
+      {
+        SpectrumType::ConstIterator mz_begin = spec.MZBegin(min_mz);
+        SpectrumType::ConstIterator mz_end = spec.MZBegin(max_mz);
+        if (mz_begin < mz_end) count = mz_end - mz_begin;
+      }
+      offsets[i + 1] = offsets[i] + count;
+    }
+
+    // spectra write to disjoint parts of the columns
+    const Size first_index = first - spectra_.begin();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (SignedSize i = 0; i < n; ++i)
+    {
+      const Size offset = offsets[i];
+      const Size count = offsets[i + 1] - offset;
+      if (count == 0) continue;
+
+      const SpectrumType& spec = *(first + i);
+      spec.exportPeaks(mz == nullptr ? nullptr : mz + offset,
+                       intensity == nullptr ? nullptr : intensity + offset,
+                       ion_mobility == nullptr ? nullptr : ion_mobility + offset,
+                       min_mz, max_mz);
+      if (rt != nullptr) std::fill(rt + offset, rt + offset + count, spec.getRT());
+      if (spectrum_index != nullptr) std::fill(spectrum_index + offset, spectrum_index + offset + count, first_index + i);
+    }
+    return offsets[n];
+  }
+
 
   ///@name Iterating ranges and areas
   //@{
@@ -238,16 +298,38 @@ namespace OpenMS
       return;
     }
 
+    // the ranges of the individual spectra and chromatograms are independent of each other and updated in parallel
+    const SignedSize n_spectra = static_cast<SignedSize>(spectra_.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+    for (SignedSize i = 0; i < n_spectra; ++i)
+    {
+      if ((ms_level < Int(0) || Int(spectra_[i].getMSLevel()) == ms_level) && !spectra_[i].empty())
+      {
+        spectra_[i].updateRanges();
+      }
+    }
+    const SignedSize n_chromatograms = static_cast<SignedSize>(chromatograms_.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+    for (SignedSize i = 0; i < n_chromatograms; ++i)
+    {
+      if (!chromatograms_[i].empty())
+      {
+        chromatograms_[i].updateRanges();
+      }
+    }
+
     //update
+    std::set<UInt> ms_levels;
     for (Base::iterator it = spectra_.begin(); it != spectra_.end(); ++it)
     {
       if (ms_level < Int(0) || Int(it->getMSLevel()) == ms_level)
       {
         //ms levels
-        if (std::find(ms_levels_.begin(), ms_levels_.end(), it->getMSLevel()) == ms_levels_.end())
-        {
-          ms_levels_.push_back(it->getMSLevel());
-        }
+        ms_levels.insert(it->getMSLevel());
 
         // calculate size
         total_size_ += it->size();
@@ -259,8 +341,6 @@ namespace OpenMS
         //do not update mz and int when the spectrum is empty
         if (it->size() == 0) continue;
 
-        it->updateRanges();
-
         //mz
         if (it->getMin()[0] < RangeManagerType::pos_range_.minY()) RangeManagerType::pos_range_.setMinY(it->getMin()[0]);
         if (it->getMax()[0] > RangeManagerType::pos_range_.maxY()) RangeManagerType::pos_range_.setMaxY(it->getMax()[0]);
@@ -286,7 +366,7 @@ namespace OpenMS
       }
 
     }
-    std::sort(ms_levels_.begin(), ms_levels_.end());
+    ms_levels_.assign(ms_levels.begin(), ms_levels.end());
 
     if (this->chromatograms_.empty())
     {
@@ -313,8 +393,6 @@ namespace OpenMS
 
       total_size_ += it->size();
 
-      it->updateRanges();
-
       // RT
       if (it->getMin()[0] < RangeManagerType::pos_range_.minX()) RangeManagerType::pos_range_.setMinX(it->getMin()[0]);
       if (it->getMax()[0] > RangeManagerType::pos_range_.maxX()) RangeManagerType::pos_range_.setMaxX(it->getMax()[0]);
@@ -387,9 +465,13 @@ namespace OpenMS
     if (sort_mz)
     {
       // sort each spectrum by m/z
-      for (Iterator iter = spectra_.begin(); iter != spectra_.end(); ++iter)
+      const SignedSize n = static_cast<SignedSize>(spectra_.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+      for (SignedSize i = 0; i < n; ++i)
       {
-        iter->sortByPosition();
+        spectra_[i].sortByPosition();
       }
     }
   }
@@ -406,9 +488,13 @@ namespace OpenMS
 
     if (sort_rt)
     {
-      for (std::vector<ChromatogramType>::iterator it = chromatograms_.begin(); it != chromatograms_.end(); ++it)
+      const SignedSize n = static_cast<SignedSize>(chromatograms_.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+      for (SignedSize i = 0; i < n; ++i)
       {
-        it->sortByPosition();
+        chromatograms_[i].sortByPosition();
       }
     }
   }
@@ -0,0 +1,445 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/KERNEL/MSExperimentAreaIndex.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace OpenMS
+{
+  namespace
+  {
+    struct CountVisitor
+    {
+      const std::vector<Size>& offset;
+      Size count;
+
+      void cell(Size c) { count += offset[c + 1] - offset[c]; }
+      void peak(Size) { ++count; }
+    };
+
+    struct SumVisitor
+    {
+      const std::vector<double>& cell_sum;
+      const std::vector<float>& intensity;
+      double sum;
+
+      void cell(Size c) { sum += cell_sum[c]; }
+      void peak(Size p) { sum += intensity[p]; }
+    };
+
+    struct MaxVisitor
+    {
+      const std::vector<Size>& cell_max;
+      const std::vector<float>& intensity;
+      const std::vector<UInt>& spectrum_pos;
+      const std::vector<UInt>& peak_pos;
+      Size best;
+
+      void cell(Size c) { peak(cell_max[c]); }
+
+      void peak(Size p)
+      {
+        if (best == std::numeric_limits<Size>::max() || intensity[p] > intensity[best])
+        {
+          best = p;
+        }
+        else if (intensity[p] == intensity[best])
+        {
+          // ties are resolved in area iterator order
+          if (spectrum_pos[p] < spectrum_pos[best] ||
+              (spectrum_pos[p] == spectrum_pos[best] && peak_pos[p] < peak_pos[best]))
+          {
+            best = p;
+          }
+        }
+      }
+    };
+
+    struct ExtractVisitor
+    {
+      const std::vector<Size>& offset;
+      std::vector<Size> positions;
+
+      void cell(Size c)
+      {
+        for (Size p = offset[c]; p < offset[c + 1]; ++p) positions.push_back(p);
+      }
+      void peak(Size p) { positions.push_back(p); }
+    };
+  }
+
+  MSExperimentAreaIndex::Area::Area() :
+    min_rt(0.0),
+    max_rt(0.0),
+    min_mz(0.0),
+    max_mz(0.0)
+  {
+  }
+
+  MSExperimentAreaIndex::Area::Area(CoordinateType min_rt_, CoordinateType max_rt_, CoordinateType min_mz_, CoordinateType max_mz_) :
+    min_rt(min_rt_),
+    max_rt(max_rt_),
+    min_mz(min_mz_),
+    max_mz(max_mz_)
+  {
+  }
+
+  MSExperimentAreaIndex::MSExperimentAreaIndex() :
+    ms_level_(1),
+    spectra_per_block_(8),
+    mz_bin_width_(1.0),
+    mz_origin_(0.0),
+    mz_bins_(0),
+    rt_blocks_(0),
+    block_cells_(1, 0),
+    cell_offset_(1, 0)
+  {
+  }
+
+  MSExperimentAreaIndex::MSExperimentAreaIndex(const MSExperiment& exp, UInt ms_level, Size spectra_per_block, CoordinateType mz_bin_width) :
+    ms_level_(ms_level),
+    spectra_per_block_(spectra_per_block),
+    mz_bin_width_(mz_bin_width),
+    mz_origin_(0.0),
+    mz_bins_(0),
+    rt_blocks_(0)
+  {
+    if (spectra_per_block == 0)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "The number of spectra per RT block must be positive.");
+    }
+    if (!(mz_bin_width > 0.0))
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "The m/z bin width must be positive.");
+    }
+
+    // collect the spectra to index and the m/z range of their peaks
+    CoordinateType min_mz = std::numeric_limits<CoordinateType>::max();
+    CoordinateType max_mz = -std::numeric_limits<CoordinateType>::max();
+    Size nr_peaks = 0;
+    for (Size s = 0; s < exp.size(); ++s)
+    {
+      const MSSpectrum& spec = exp[s];
+      if (spec.getMSLevel() != ms_level_) continue;
+      if (!spectrum_rt_.empty() && spec.getRT() < spectrum_rt_.back())
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Spectra are not sorted in RT! Please sort them first!");
+      }
+      spectrum_rt_.push_back(spec.getRT());
+      spectrum_index_.push_back(s);
+      for (MSSpectrum::ConstIterator it = spec.begin(); it != spec.end(); ++it)
+      {
+        min_mz = std::min(min_mz, it->getMZ());
+        max_mz = std::max(max_mz, it->getMZ());
+      }
+      nr_peaks += spec.size();
+    }
+
+    rt_blocks_ = (spectrum_rt_.size() + spectra_per_block_ - 1) / spectra_per_block_;
+    if (nr_peaks == 0)
+    {
+      mz_bins_ = 1;
+      block_cells_.assign(rt_blocks_ + 1, 0);
+      cell_offset_.assign(1, 0);
+      return;
+    }
+    mz_origin_ = min_mz;
+    mz_bins_ = static_cast<Size>(mzBin_(max_mz)) + 1;
+
+    // only occupied cells are stored: count them (and the peaks) per RT block first, each RT block only writes to its own entries
+    const SignedSize nr_blocks = static_cast<SignedSize>(rt_blocks_);
+    std::vector<Size> block_cells(rt_blocks_, 0), block_peaks(rt_blocks_, 0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (SignedSize b = 0; b < nr_blocks; ++b)
+    {
+      std::vector<BinnedPeak_> peaks;
+      binBlock_(exp, b, peaks);
+      for (Size i = 0; i < peaks.size(); ++i)
+      {
+        if (i == 0 || peaks[i].bin != peaks[i - 1].bin) ++block_cells[b];
+      }
+      block_peaks[b] = peaks.size();
+    }
+    block_cells_.assign(rt_blocks_ + 1, 0);
+    std::partial_sum(block_cells.begin(), block_cells.end(), block_cells_.begin() + 1);
+    std::vector<Size> block_peak_offset(rt_blocks_ + 1, 0);
+    std::partial_sum(block_peaks.begin(), block_peaks.end(), block_peak_offset.begin() + 1);
+    const Size nr_cells = block_cells_.back();
+
+    // copy the peaks into the store, ordered by cell, spectrum and position in the spectrum
+    mz_.resize(nr_peaks);
+    intensity_.resize(nr_peaks);
+    spectrum_pos_.resize(nr_peaks);
+    peak_pos_.resize(nr_peaks);
+    cell_bin_.resize(nr_cells);
+    cell_offset_.resize(nr_cells + 1);
+    cell_offset_.back() = nr_peaks;
+    cell_sum_.assign(nr_cells, 0.0);
+    cell_max_.assign(nr_cells, 0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (SignedSize b = 0; b < nr_blocks; ++b)
+    {
+      std::vector<BinnedPeak_> peaks;
+      binBlock_(exp, b, peaks);
+      Size c = block_cells_[b];
+      Size p = block_peak_offset[b];
+      for (Size i = 0; i < peaks.size(); ++i, ++p)
+      {
+        if (i == 0 || peaks[i].bin != peaks[i - 1].bin) // first peak of a cell
+        {
+          if (i > 0) ++c;
+          cell_bin_[c] = peaks[i].bin;
+          cell_offset_[c] = p;
+          cell_max_[c] = p;
+        }
+        const Peak1D& peak = exp[spectrum_index_[peaks[i].spectrum]][peaks[i].peak];
+        mz_[p] = peak.getMZ();
+        intensity_[p] = peak.getIntensity();
+        spectrum_pos_[p] = peaks[i].spectrum;
+        peak_pos_[p] = peaks[i].peak;
+        cell_sum_[c] += peak.getIntensity();
+        if (intensity_[p] > intensity_[cell_max_[c]])
+        {
+          cell_max_[c] = p;
+        }
+      }
+    }
+  }
+
+  void MSExperimentAreaIndex::binBlock_(const MSExperiment& exp, Size block, std::vector<BinnedPeak_>& peaks) const
+  {
+    const Size first_spec = block * spectra_per_block_;
+    const Size last_spec = std::min(first_spec + spectra_per_block_, spectrum_rt_.size());
+    peaks.clear();
+    for (Size s = first_spec; s < last_spec; ++s)
+    {
+      const MSSpectrum& spec = exp[spectrum_index_[s]];
+      for (Size i = 0; i < spec.size(); ++i)
+      {
+        BinnedPeak_ binned = {static_cast<Size>(mzBin_(spec[i].getMZ())), static_cast<UInt>(s), static_cast<UInt>(i)};
+        peaks.push_back(binned);
+      }
+    }
+    // stable, so that the peaks of a cell stay ordered by spectrum and position
+    std::stable_sort(peaks.begin(), peaks.end(), [](const BinnedPeak_& lhs, const BinnedPeak_& rhs) { return lhs.bin < rhs.bin; });
+  }
+
+  UInt MSExperimentAreaIndex::getMSLevel() const
+  {
+    return ms_level_;
+  }
+
+  Size MSExperimentAreaIndex::getNrSpectra() const
+  {
+    return spectrum_rt_.size();
+  }
+
+  Size MSExperimentAreaIndex::getNrPeaks() const
+  {
+    return mz_.size();
+  }
+
+  SignedSize MSExperimentAreaIndex::mzBin_(CoordinateType mz) const
+  {
+    return static_cast<SignedSize>(std::floor((mz - mz_origin_) / mz_bin_width_));
+  }
+
+  PeakIndex MSExperimentAreaIndex::peakIndex_(Size p) const
+  {
+    return PeakIndex(spectrum_index_[spectrum_pos_[p]], peak_pos_[p]);
+  }
+
+  template <typename VisitorType>
+  void MSExperimentAreaIndex::visit_(const Area& area, VisitorType& visitor) const
+  {
+    if (mz_.empty() || area.min_rt > area.max_rt || area.min_mz > area.max_mz) return;
+
+    // indexed spectra [spec_begin, spec_end) inside of the RT range
+    const Size spec_begin = std::lower_bound(spectrum_rt_.begin(), spectrum_rt_.end(), area.min_rt) - spectrum_rt_.begin();
+    const Size spec_end = std::upper_bound(spectrum_rt_.begin(), spectrum_rt_.end(), area.max_rt) - spectrum_rt_.begin();
+    if (spec_begin >= spec_end) return;
+
+    // m/z bins [bin_first, bin_last] overlapping the m/z range
+    const SignedSize low_bin = mzBin_(area.min_mz);
+    const SignedSize high_bin = mzBin_(area.max_mz);
+    if (high_bin < 0 || low_bin >= static_cast<SignedSize>(mz_bins_)) return;
+    const Size bin_first = static_cast<Size>(std::max(low_bin, SignedSize(0)));
+    const Size bin_last = static_cast<Size>(std::min(high_bin, static_cast<SignedSize>(mz_bins_) - 1));
+
+    const Size block_first = spec_begin / spectra_per_block_;
+    const Size block_last = (spec_end - 1) / spectra_per_block_;
+    for (Size b = block_first; b <= block_last; ++b)
+    {
+      const bool inner_rt = b * spectra_per_block_ >= spec_begin &&
+                            std::min((b + 1) * spectra_per_block_, spectrum_rt_.size()) <= spec_end;
+      // occupied cells of the block are sorted by m/z bin
+      const std::vector<Size>::const_iterator cells_end = cell_bin_.begin() + block_cells_[b + 1];
+      for (std::vector<Size>::const_iterator cell_it = std::lower_bound(cell_bin_.begin() + block_cells_[b], cells_end, bin_first);
+           cell_it != cells_end && *cell_it <= bin_last; ++cell_it)
+      {
+        const Size c = cell_it - cell_bin_.begin();
+        const Size bin = *cell_it;
+        // binning is monotonic in m/z, so all peaks of a bin strictly between the bins of both boundaries are inside
+        const bool inner_mz = static_cast<SignedSize>(bin) > low_bin && static_cast<SignedSize>(bin) < high_bin;
+        if (inner_rt && inner_mz)
+        {
+          visitor.cell(c);
+          continue;
+        }
+        for (Size p = cell_offset_[c]; p < cell_offset_[c + 1]; ++p)
+        {
+          if (spectrum_pos_[p] >= spec_begin && spectrum_pos_[p] < spec_end &&
+              mz_[p] >= area.min_mz && mz_[p] <= area.max_mz)
+          {
+            visitor.peak(p);
+          }
+        }
+      }
+    }
+  }
+
+  Size MSExperimentAreaIndex::countPeaks(const Area& area) const
+  {
+    CountVisitor visitor = {cell_offset_, 0};
+    visit_(area, visitor);
+    return visitor.count;
+  }
+
+  double MSExperimentAreaIndex::sumIntensity(const Area& area) const
+  {
+    SumVisitor visitor = {cell_sum_, intensity_, 0.0};
+    visit_(area, visitor);
+    return visitor.sum;
+  }
+
+  PeakIndex MSExperimentAreaIndex::findHighestPeak(const Area& area) const
+  {
+    MaxVisitor visitor = {cell_max_, intensity_, spectrum_pos_, peak_pos_, std::numeric_limits<Size>::max()};
+    visit_(area, visitor);
+    if (visitor.best == std::numeric_limits<Size>::max()) return PeakIndex();
+    return peakIndex_(visitor.best);
+  }
+
+  void MSExperimentAreaIndex::extract(const Area& area, std::vector<PeakIndex>& peaks) const
+  {
+    ExtractVisitor visitor = {cell_offset_, std::vector<Size>()};
+    visit_(area, visitor);
+
+    // restore area iterator order (spectrum by spectrum, ascending m/z)
+    std::sort(visitor.positions.begin(), visitor.positions.end(), [this](Size a, Size b)
+    {
+      return spectrum_pos_[a] < spectrum_pos_[b] || (spectrum_pos_[a] == spectrum_pos_[b] && peak_pos_[a] < peak_pos_[b]);
+    });
+
+    peaks.clear();
+    peaks.reserve(visitor.positions.size());
+    for (Size p : visitor.positions)
+    {
+      peaks.push_back(peakIndex_(p));
+    }
+  }
+
+  std::vector<Size> MSExperimentAreaIndex::batchOrder_(const std::vector<Area>& areas) const
+  {
+    // sort by the first cell touched (RT block, then m/z bin)
+    std::vector<std::pair<std::pair<Size, SignedSize>, Size> > keys(areas.size());
+    for (Size i = 0; i < areas.size(); ++i)
+    {
+      const Size spec = std::lower_bound(spectrum_rt_.begin(), spectrum_rt_.end(), areas[i].min_rt) - spectrum_rt_.begin();
+      const SignedSize bin = mz_bins_ == 0 ? 0 : std::min(std::max(mzBin_(areas[i].min_mz), SignedSize(0)), static_cast<SignedSize>(mz_bins_) - 1);
+      keys[i] = std::make_pair(std::make_pair(spec / spectra_per_block_, bin), i);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<Size> order(areas.size());
+    for (Size i = 0; i < keys.size(); ++i) order[i] = keys[i].second;
+    return order;
+  }
+
+  std::vector<double> MSExperimentAreaIndex::sumIntensity(const std::vector<Area>& areas) const
+  {
+    const std::vector<Size> order = batchOrder_(areas);
+    std::vector<double> result(areas.size(), 0.0);
+    const SignedSize n = static_cast<SignedSize>(order.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (SignedSize i = 0; i < n; ++i)
+    {
+      result[order[i]] = sumIntensity(areas[order[i]]);
+    }
+    return result;
+  }
+
+  std::vector<PeakIndex> MSExperimentAreaIndex::findHighestPeak(const std::vector<Area>& areas) const
+  {
+    const std::vector<Size> order = batchOrder_(areas);
+    std::vector<PeakIndex> result(areas.size());
+    const SignedSize n = static_cast<SignedSize>(order.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (SignedSize i = 0; i < n; ++i)
+    {
+      result[order[i]] = findHighestPeak(areas[order[i]]);
+    }
+    return result;
+  }
+
+  std::vector<std::vector<PeakIndex> > MSExperimentAreaIndex::extract(const std::vector<Area>& areas) const
+  {
+    const std::vector<Size> order = batchOrder_(areas);
+    std::vector<std::vector<PeakIndex> > result(areas.size());
+    const SignedSize n = static_cast<SignedSize>(order.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (SignedSize i = 0; i < n; ++i)
+    {
+      extract(areas[order[i]], result[order[i]]);
+    }
+    return result;
+  }
+
+} // namespace OpenMS
+
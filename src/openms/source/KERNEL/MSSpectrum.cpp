@@ -107,6 +107,55 @@ namespace OpenMS
     return *this;
   }
 
+  Int MSSpectrum::getIonMobilityArrayIndex() const
+  {
+    for (Size i = 0; i < float_data_arrays_.size(); ++i)
+    {
+      const String& name = float_data_arrays_[i].getName();
+      if (float_data_arrays_[i].size() == size() &&
+          (name.hasPrefix("Ion Mobility") ||
+           name == "ion mobility array" ||
+           name == "mean inverse reduced ion mobility array" ||
+           name == "ion mobility drift time"))
+      {
+        return Int(i);
+      }
+    }
+    return -1;
+  }
+
+  Size MSSpectrum::exportPeaks(double* mz, float* intensity, double* ion_mobility, CoordinateType min_mz, CoordinateType max_mz) const
+  {
+    const Size first = MZBegin(min_mz) - ContainerType::begin();
+    const Size last = MZBegin(max_mz) - ContainerType::begin();
+    if (last <= first) return 0;
+
+    const Peak1D* peaks = &ContainerType::operator[](first);
+    const Size n = last - first;
+    if (mz != nullptr)
+    {
+      for (Size i = 0; i < n; ++i) mz[i] = peaks[i].getMZ();
+    }
+    if (intensity != nullptr)
+    {
+      for (Size i = 0; i < n; ++i) intensity[i] = peaks[i].getIntensity();
+    }
+    if (ion_mobility != nullptr)
+    {
+      Int im_index = getIonMobilityArrayIndex();
+      if (im_index >= 0)
+      {
+        const FloatDataArray& im = float_data_arrays_[im_index];
+        for (Size i = 0; i < n; ++i) ion_mobility[i] = im[first + i];
+      }
+      else
+      {
+        std::fill(ion_mobility, ion_mobility + n, getDriftTime());
+      }
+    }
+    return n;
+  }
+
   SpectrumSettings::SpectrumType MSSpectrum::getType(const bool query_data) const
   {
     SpectrumSettings::SpectrumType t = SpectrumSettings::getType();
@@ -0,0 +1,368 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/KERNEL/OnDiscSpectrumCache.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/CONCEPT/LogStream.h>
+
+#include <limits>
+
+using namespace std;
+
+namespace OpenMS
+{
+  namespace
+  {
+    // fills the values of an overview point which are not known yet from the peaks of a spectrum
+    void completeOverviewPoint(const MSSpectrum& spectrum, OnDiscSpectrumCache::OverviewPoint& point)
+    {
+      double tic = 0.0, bpi = 0.0;
+      for (MSSpectrum::ConstIterator it = spectrum.begin(); it != spectrum.end(); ++it)
+      {
+        tic += it->getIntensity();
+        if (it->getIntensity() > bpi) bpi = it->getIntensity();
+      }
+      if (point.tic < 0.0) point.tic = tic;
+      if (point.base_peak_intensity < 0.0) point.base_peak_intensity = bpi;
+      if (point.mz_min < 0.0 || point.mz_max < 0.0)
+      {
+        double mz_min = spectrum.empty() ? 0.0 : spectrum.front().getMZ();
+        double mz_max = mz_min;
+        for (MSSpectrum::ConstIterator it = spectrum.begin(); it != spectrum.end(); ++it)
+        {
+          mz_min = std::min(mz_min, it->getMZ());
+          mz_max = std::max(mz_max, it->getMZ());
+        }
+        point.mz_min = mz_min;
+        point.mz_max = mz_max;
+      }
+    }
+  }
+
+  OnDiscSpectrumCache::OnDiscSpectrumCache(const OnDiscMSExperiment& experiment, Size max_peaks) :
+    experiment_(experiment),
+    meta_data_(experiment.getMetaData()),
+    cache_(),
+    lru_(),
+    cached_peaks_(0),
+    max_peaks_(max_peaks),
+    queue_(),
+    prefetch_busy_(false),
+    overview_(),
+    overview_pending_(),
+    stop_(false),
+    worker_()
+  {
+    if (!meta_data_)
+    {
+      throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "The on-disc experiment was not opened including its meta data.");
+    }
+
+    // take as much of the overview as possible from the meta data
+    for (Size i = 0; i < meta_data_->size(); ++i)
+    {
+      const MSSpectrum& spectrum = (*meta_data_)[i];
+      if (spectrum.getMSLevel() != 1) continue;
+
+      OverviewPoint point;
+      point.index = i;
+      point.rt = spectrum.getRT();
+      point.tic = spectrum.metaValueExists("total ion current") ? double(spectrum.getMetaValue("total ion current")) : -1.0;
+      point.base_peak_intensity = spectrum.metaValueExists("base peak intensity") ? double(spectrum.getMetaValue("base peak intensity")) : -1.0;
+      point.mz_min = -1.0;
+      point.mz_max = -1.0;
+      if (spectrum.metaValueExists("lowest observed m/z") && spectrum.metaValueExists("highest observed m/z"))
+      {
+        point.mz_min = spectrum.getMetaValue("lowest observed m/z");
+        point.mz_max = spectrum.getMetaValue("highest observed m/z");
+      }
+      else
+      {
+        const vector<ScanWindow>& windows = spectrum.getInstrumentSettings().getScanWindows();
+        if (!windows.empty() && windows.back().end > windows.front().begin)
+        {
+          point.mz_min = windows.front().begin;
+          point.mz_max = windows.back().end;
+        }
+      }
+      if (!point.isComplete())
+      {
+        overview_pending_.push_back(overview_.size());
+      }
+      overview_.push_back(point);
+    }
+
+    worker_ = std::thread(&OnDiscSpectrumCache::run_, this);
+  }
+
+  OnDiscSpectrumCache::~OnDiscSpectrumCache()
+  {
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      stop_ = true;
+    }
+    queue_cv_.notify_all();
+    worker_.join();
+  }
+
+  Size OnDiscSpectrumCache::size() const
+  {
+    return meta_data_->size();
+  }
+
+  boost::shared_ptr<const PeakMap> OnDiscSpectrumCache::getMetaData() const
+  {
+    return meta_data_;
+  }
+
+  OnDiscSpectrumCache::SpectrumPtr OnDiscSpectrumCache::getSpectrum(Size index)
+  {
+    if (index >= size())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, index, size());
+    }
+    SpectrumPtr spectrum = getCachedSpectrum(index);
+    if (spectrum) return spectrum;
+
+    spectrum = load_(index);
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    // the background thread might have been faster
+    std::unordered_map<Size, Entry>::iterator it = cache_.find(index);
+    if (it != cache_.end()) return it->second.spectrum;
+    insert_(index, spectrum);
+    return spectrum;
+  }
+
+  OnDiscSpectrumCache::SpectrumPtr OnDiscSpectrumCache::getCachedSpectrum(Size index)
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    std::unordered_map<Size, Entry>::iterator it = cache_.find(index);
+    if (it == cache_.end()) return SpectrumPtr();
+    // mark as most recently used
+    lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+    return it->second.spectrum;
+  }
+
+  bool OnDiscSpectrumCache::isCached(Size index) const
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    return cache_.find(index) != cache_.end();
+  }
+
+  void OnDiscSpectrumCache::prefetch(const vector<Size>& indices)
+  {
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      queue_.clear();
+      for (Size i = 0; i < indices.size(); ++i)
+      {
+        if (indices[i] < size() && !isCached(indices[i])) queue_.push_back(indices[i]);
+      }
+    }
+    queue_cv_.notify_all();
+  }
+
+  void OnDiscSpectrumCache::cancelPrefetch()
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    queue_.clear();
+  }
+
+  bool OnDiscSpectrumCache::isPrefetching() const
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    return prefetch_busy_ || !queue_.empty();
+  }
+
+  Size OnDiscSpectrumCache::getMaxPeaks() const
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    return max_peaks_;
+  }
+
+  void OnDiscSpectrumCache::setMaxPeaks(Size max_peaks)
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    max_peaks_ = max_peaks;
+    evict_();
+  }
+
+  Size OnDiscSpectrumCache::getCachedSpectrumCount() const
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    return cache_.size();
+  }
+
+  Size OnDiscSpectrumCache::getCachedPeakCount() const
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    return cached_peaks_;
+  }
+
+  void OnDiscSpectrumCache::clear()
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    cache_.clear();
+    lru_.clear();
+    cached_peaks_ = 0;
+  }
+
+  vector<OnDiscSpectrumCache::OverviewPoint> OnDiscSpectrumCache::getOverview() const
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    return overview_;
+  }
+
+  bool OnDiscSpectrumCache::isOverviewComplete() const
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    for (Size i = 0; i < overview_.size(); ++i)
+    {
+      if (!overview_[i].isComplete()) return false;
+    }
+    return true;
+  }
+
+  bool OnDiscSpectrumCache::getOverviewRanges(double& mz_min, double& mz_max, double& max_intensity) const
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    mz_min = numeric_limits<double>::max();
+    mz_max = -numeric_limits<double>::max();
+    max_intensity = 0.0;
+    for (Size i = 0; i < overview_.size(); ++i)
+    {
+      const OverviewPoint& point = overview_[i];
+      max_intensity = std::max(max_intensity, point.base_peak_intensity);
+      // skip unknown ranges and empty spectra
+      if (point.mz_min < 0.0 || point.mz_max <= 0.0) continue;
+      mz_min = std::min(mz_min, point.mz_min);
+      mz_max = std::max(mz_max, point.mz_max);
+    }
+    return mz_min <= mz_max;
+  }
+
+  OnDiscSpectrumCache::SpectrumPtr OnDiscSpectrumCache::load_(Size index)
+  {
+    // the meta data may already contain the peaks of some spectra (reading them again would append the peaks twice)
+    if (!(*meta_data_)[index].empty())
+    {
+      return SpectrumPtr(new MSSpectrum((*meta_data_)[index]));
+    }
+    std::lock_guard<std::mutex> lock(io_mutex_);
+    return SpectrumPtr(new MSSpectrum(experiment_.getSpectrum(index)));
+  }
+
+  void OnDiscSpectrumCache::insert_(Size index, const SpectrumPtr& spectrum)
+  {
+    lru_.push_front(index);
+    Entry entry;
+    entry.spectrum = spectrum;
+    entry.lru_position = lru_.begin();
+    cache_[index] = entry;
+    cached_peaks_ += spectrum->size();
+    evict_();
+  }
+
+  void OnDiscSpectrumCache::evict_()
+  {
+    // always keep the most recently used spectrum
+    while (cached_peaks_ > max_peaks_ && lru_.size() > 1)
+    {
+      std::unordered_map<Size, Entry>::iterator it = cache_.find(lru_.back());
+      cached_peaks_ -= it->second.spectrum->size();
+      cache_.erase(it);
+      lru_.pop_back();
+    }
+  }
+
+  void OnDiscSpectrumCache::run_()
+  {
+    while (true)
+    {
+      Size index(0), overview_position(0);
+      bool is_prefetch(false);
+      {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        prefetch_busy_ = false;
+        queue_cv_.wait(lock, [this] { return stop_ || !queue_.empty() || !overview_pending_.empty(); });
+        if (stop_) return;
+
+        // prefetching (i.e. what is currently looked at) takes precedence over the overview
+        if (!queue_.empty())
+        {
+          index = queue_.front();
+          queue_.pop_front();
+          is_prefetch = true;
+          prefetch_busy_ = true;
+        }
+        else
+        {
+          overview_position = overview_pending_.front();
+          overview_pending_.pop_front();
+          index = overview_[overview_position].index;
+        }
+      }
+
+      try
+      {
+        if (is_prefetch)
+        {
+          if (isCached(index)) continue;
+          SpectrumPtr spectrum = load_(index);
+          std::lock_guard<std::mutex> lock(cache_mutex_);
+          if (cache_.find(index) == cache_.end()) insert_(index, spectrum);
+        }
+        else
+        {
+          // use a cached copy if there is one but do not add the spectrum to the cache
+          SpectrumPtr spectrum = getCachedSpectrum(index);
+          if (!spectrum) spectrum = load_(index);
+          std::lock_guard<std::mutex> lock(queue_mutex_);
+          completeOverviewPoint(*spectrum, overview_[overview_position]);
+        }
+      }
+      catch (std::exception& e)
+      {
+        OPENMS_LOG_WARN << "OnDiscSpectrumCache: could not read spectrum " << index << ": " << e.what() << std::endl;
+        if (!is_prefetch)
+        {
+          // do not retry, treat the spectrum as empty
+          std::lock_guard<std::mutex> lock(queue_mutex_);
+          completeOverviewPoint(MSSpectrum(), overview_[overview_position]);
+        }
+      }
+    }
+  }
+
+} // namespace OpenMS
@@ -16,8 +16,10 @@ MassTrace.cpp
 MRMFeature.cpp
 MRMTransitionGroup.cpp
 MSExperiment.cpp
+MSExperimentAreaIndex.cpp
 MSSpectrum.cpp
 OnDiscMSExperiment.cpp
+OnDiscSpectrumCache.cpp
 Peak1D.cpp
 Peak2D.cpp
 PeakIndex.cpp
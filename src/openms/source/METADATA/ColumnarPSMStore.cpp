@@ -0,0 +1,842 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/METADATA/ColumnarPSMStore.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/METADATA/MetaInfoInterface.h>
+#include <OpenMS/METADATA/MetaInfoRegistry.h>
+
+#include <boost/functional/hash.hpp>
+
+#include <algorithm>
+#include <functional>
+
+using namespace std;
+
+namespace OpenMS
+{
+
+  // ColumnarPSMStore::MetaColumn_
+
+  ColumnarPSMStore::MetaColumn_::MetaColumn_() :
+    type_(DataValue::EMPTY_VALUE),
+    generic_(false)
+  {
+  }
+
+  void ColumnarPSMStore::MetaColumn_::resize(Size n)
+  {
+    present_.resize(n, false);
+    if (generic_)
+    {
+      values_.resize(n);
+      return;
+    }
+    switch (type_)
+    {
+      case DataValue::DOUBLE_VALUE: doubles_.resize(n); break;
+      case DataValue::INT_VALUE: ints_.resize(n); break;
+      case DataValue::STRING_VALUE: strings_.resize(n); break;
+      default: break;
+    }
+  }
+
+  bool ColumnarPSMStore::MetaColumn_::exists(Size row) const
+  {
+    return present_[row];
+  }
+
+  bool ColumnarPSMStore::MetaColumn_::hasValues() const
+  {
+    return std::find(present_.begin(), present_.end(), true) != present_.end();
+  }
+
+  DataValue ColumnarPSMStore::MetaColumn_::get(Size row, const std::vector<String>& strings) const
+  {
+    if (!present_[row]) return DataValue::EMPTY;
+    if (generic_) return values_[row];
+    switch (type_)
+    {
+      case DataValue::DOUBLE_VALUE: return DataValue(doubles_[row]);
+      case DataValue::INT_VALUE: return DataValue(ints_[row]);
+      case DataValue::STRING_VALUE: return DataValue(strings[strings_[row]]);
+      default: return DataValue::EMPTY;
+    }
+  }
+
+  void ColumnarPSMStore::MetaColumn_::set(Size row, const DataValue& value, ColumnarPSMStore& store)
+  {
+    if (value.isEmpty())
+    {
+      present_[row] = false;
+      if (generic_) values_[row] = DataValue::EMPTY;
+      return;
+    }
+
+    if (!generic_)
+    {
+      DataValue::DataType type = value.valueType();
+      bool simple = !value.hasUnit() && (type == DataValue::DOUBLE_VALUE || type == DataValue::INT_VALUE || type == DataValue::STRING_VALUE);
+      if (type_ == DataValue::EMPTY_VALUE && simple)
+      { // first value determines the storage type
+        type_ = type;
+        resize(present_.size());
+      }
+      else if (!simple || type != type_)
+      {
+        toGeneric_(store.strings_);
+      }
+    }
+
+    present_[row] = true;
+    if (generic_)
+    {
+      values_[row] = value;
+      return;
+    }
+    switch (type_)
+    {
+      case DataValue::DOUBLE_VALUE: doubles_[row] = double(value); break;
+      case DataValue::INT_VALUE: ints_[row] = SignedSize(value); break;
+      case DataValue::STRING_VALUE: strings_[row] = store.internString_(value.toString()); break;
+      default: break;
+    }
+  }
+
+  void ColumnarPSMStore::MetaColumn_::toGeneric_(const std::vector<String>& strings)
+  {
+    std::vector<DataValue> values(present_.size());
+    for (Size row = 0; row < present_.size(); ++row)
+    {
+      values[row] = get(row, strings);
+    }
+    values_.swap(values);
+    generic_ = true;
+    std::vector<double>().swap(doubles_);
+    std::vector<SignedSize>().swap(ints_);
+    std::vector<StringRef>().swap(strings_);
+  }
+
+  namespace
+  {
+    /// replaces @p v by the elements at positions @p new_to_old
+    template <typename T>
+    void gatherVector(std::vector<T>& v, const std::vector<Size>& new_to_old)
+    {
+      if (v.empty()) return;
+      std::vector<T> result;
+      result.reserve(new_to_old.size());
+      for (Size i : new_to_old)
+      {
+        result.push_back(v[i]);
+      }
+      v.swap(result);
+    }
+
+    /// replaces the keys of the sparse map @p m (old hit index) by the new hit index
+    template <typename T>
+    void gatherMap(std::map<Size, T>& m, const std::vector<Size>& new_to_old)
+    {
+      if (m.empty()) return;
+      std::map<Size, T> result;
+      for (Size i = 0; i < new_to_old.size(); ++i)
+      {
+        typename std::map<Size, T>::iterator it = m.find(new_to_old[i]);
+        if (it != m.end()) result[i] = it->second;
+      }
+      m.swap(result);
+    }
+  }
+
+  void ColumnarPSMStore::MetaColumn_::gather(const std::vector<Size>& new_to_old)
+  {
+    gatherVector(present_, new_to_old);
+    gatherVector(doubles_, new_to_old);
+    gatherVector(ints_, new_to_old);
+    gatherVector(strings_, new_to_old);
+    gatherVector(values_, new_to_old);
+    // columns without any value yet, but with rows
+    present_.resize(new_to_old.size(), false);
+  }
+
+
+  // ColumnarPSMStore
+
+  ColumnarPSMStore::ColumnarPSMStore()
+  {
+    clear();
+  }
+
+  ColumnarPSMStore::ColumnarPSMStore(const std::vector<PeptideIdentification>& peptide_ids)
+  {
+    assign(peptide_ids);
+  }
+
+  void ColumnarPSMStore::clear()
+  {
+    strings_.clear();
+    string_index_.clear();
+    sequences_.clear();
+    sequence_index_.clear();
+
+    hit_begin_.assign(1, 0);
+    rt_.clear();
+    mz_.clear();
+    identifier_.clear();
+    score_type_.clear();
+    higher_score_better_.clear();
+    significance_threshold_.clear();
+    base_name_.clear();
+    id_meta_.clear();
+
+    sequence_.clear();
+    score_.clear();
+    rank_.clear();
+    charge_.clear();
+    evidence_begin_.assign(1, 0);
+    hit_meta_.clear();
+    analysis_results_.clear();
+    peak_annotations_.clear();
+
+    evidence_accession_.clear();
+    evidence_start_.clear();
+    evidence_end_.clear();
+    evidence_aa_before_.clear();
+    evidence_aa_after_.clear();
+
+    // the empty string is always present (most string columns default to it)
+    internString_("");
+  }
+
+  void ColumnarPSMStore::assign(const std::vector<PeptideIdentification>& peptide_ids)
+  {
+    clear();
+    Size n_hits(0);
+    for (const PeptideIdentification& pep_id : peptide_ids)
+    {
+      n_hits += pep_id.getHits().size();
+    }
+    hit_begin_.reserve(peptide_ids.size() + 1);
+    sequence_.reserve(n_hits);
+    score_.reserve(n_hits);
+    rank_.reserve(n_hits);
+    charge_.reserve(n_hits);
+    evidence_begin_.reserve(n_hits + 1);
+
+    for (const PeptideIdentification& pep_id : peptide_ids)
+    {
+      push_back(pep_id);
+    }
+  }
+
+  void ColumnarPSMStore::push_back(const PeptideIdentification& peptide_id)
+  {
+    // identification columns
+    Size id_index = size();
+    rt_.push_back(peptide_id.getRT());
+    mz_.push_back(peptide_id.getMZ());
+    identifier_.push_back(internString_(peptide_id.getIdentifier()));
+    score_type_.push_back(internString_(peptide_id.getScoreType()));
+    higher_score_better_.push_back(peptide_id.isHigherScoreBetter());
+    significance_threshold_.push_back(peptide_id.getSignificanceThreshold());
+    base_name_.push_back(internString_(peptide_id.getBaseName()));
+
+    std::vector<UInt> keys;
+    peptide_id.getKeys(keys);
+    for (auto& col : id_meta_)
+    {
+      col.second.resize(id_index + 1);
+    }
+    for (UInt key : keys)
+    {
+      MetaColumn_& col = id_meta_[key];
+      col.resize(id_index + 1);
+      col.set(id_index, peptide_id.getMetaValue(key), *this);
+    }
+
+    // hit columns
+    const std::vector<PeptideHit>& hits = peptide_id.getHits();
+    Size first_hit = getNumberOfHits();
+    for (const PeptideHit& hit : hits)
+    {
+      Size hit_index = getNumberOfHits();
+      sequence_.push_back(internSequence_(hit.getInternedSequence()));
+      score_.push_back(hit.getScore());
+      rank_.push_back(hit.getRank());
+      charge_.push_back(hit.getCharge());
+
+      for (const PeptideEvidence& pe : hit.getPeptideEvidences())
+      {
+        evidence_accession_.push_back(internString_(pe.getProteinAccession()));
+        evidence_start_.push_back(pe.getStart());
+        evidence_end_.push_back(pe.getEnd());
+        evidence_aa_before_.push_back(pe.getAABefore());
+        evidence_aa_after_.push_back(pe.getAAAfter());
+      }
+      evidence_begin_.push_back(evidence_accession_.size());
+
+      if (!hit.getAnalysisResults().empty())
+      {
+        analysis_results_[hit_index] = hit.getAnalysisResults();
+      }
+      std::vector<PeptideHit::PeakAnnotation> annotations = hit.getPeakAnnotations();
+      if (!annotations.empty())
+      {
+        peak_annotations_[hit_index].swap(annotations);
+      }
+    }
+    hit_begin_.push_back(getNumberOfHits());
+
+    // hit meta values (resize all columns once, then fill)
+    for (Size h = 0; h < hits.size(); ++h)
+    {
+      hits[h].getKeys(keys);
+      for (UInt key : keys)
+      {
+        hit_meta_[key]; // create column if necessary
+      }
+    }
+    for (auto& col : hit_meta_)
+    {
+      col.second.resize(getNumberOfHits());
+    }
+    for (Size h = 0; h < hits.size(); ++h)
+    {
+      hits[h].getKeys(keys);
+      for (UInt key : keys)
+      {
+        hit_meta_[key].set(first_hit + h, hits[h].getMetaValue(key), *this);
+      }
+    }
+  }
+
+  void ColumnarPSMStore::toPeptideIdentifications(std::vector<PeptideIdentification>& peptide_ids) const
+  {
+    peptide_ids.clear();
+    peptide_ids.reserve(size());
+    for (Size i = 0; i < size(); ++i)
+    {
+      peptide_ids.push_back(getPeptideIdentification(i));
+    }
+  }
+
+  PeptideIdentification ColumnarPSMStore::getPeptideIdentification(Size id_index) const
+  {
+    PeptideIdentification pep_id;
+    pep_id.setRT(rt_[id_index]);
+    pep_id.setMZ(mz_[id_index]);
+    pep_id.setIdentifier(strings_[identifier_[id_index]]);
+    pep_id.setScoreType(strings_[score_type_[id_index]]);
+    pep_id.setHigherScoreBetter(higher_score_better_[id_index]);
+    pep_id.setSignificanceThreshold(significance_threshold_[id_index]);
+    pep_id.setBaseName(strings_[base_name_[id_index]]);
+    for (const auto& col : id_meta_)
+    {
+      if (col.second.exists(id_index))
+      {
+        pep_id.setMetaValue(col.first, col.second.get(id_index, strings_));
+      }
+    }
+
+    std::vector<PeptideHit> hits;
+    hits.reserve(getHitEnd(id_index) - getHitBegin(id_index));
+    for (Size h = getHitBegin(id_index); h < getHitEnd(id_index); ++h)
+    {
+      hits.push_back(getPeptideHit(h));
+    }
+    pep_id.getHits().swap(hits);
+    return pep_id;
+  }
+
+  PeptideHit ColumnarPSMStore::getPeptideHit(Size hit_index) const
+  {
+    PeptideHit hit(score_[hit_index], rank_[hit_index], charge_[hit_index], sequences_[sequence_[hit_index]]);
+    hit.setPeptideEvidences(getPeptideEvidences(hit_index));
+    for (const auto& col : hit_meta_)
+    {
+      if (col.second.exists(hit_index))
+      {
+        hit.setMetaValue(col.first, col.second.get(hit_index, strings_));
+      }
+    }
+    std::map<Size, std::vector<PeptideHit::PepXMLAnalysisResult> >::const_iterator ar_it = analysis_results_.find(hit_index);
+    if (ar_it != analysis_results_.end())
+    {
+      hit.setAnalysisResults(ar_it->second);
+    }
+    std::map<Size, std::vector<PeptideHit::PeakAnnotation> >::const_iterator pa_it = peak_annotations_.find(hit_index);
+    if (pa_it != peak_annotations_.end())
+    {
+      hit.setPeakAnnotations(pa_it->second);
+    }
+    return hit;
+  }
+
+  Size ColumnarPSMStore::size() const
+  {
+    return rt_.size();
+  }
+
+  Size ColumnarPSMStore::getNumberOfHits() const
+  {
+    return score_.size();
+  }
+
+  Size ColumnarPSMStore::getNumberOfSequences() const
+  {
+    return sequences_.size();
+  }
+
+  bool ColumnarPSMStore::empty() const
+  {
+    return rt_.empty();
+  }
+
+  Size ColumnarPSMStore::getHitBegin(Size id_index) const
+  {
+    return hit_begin_[id_index];
+  }
+
+  Size ColumnarPSMStore::getHitEnd(Size id_index) const
+  {
+    return hit_begin_[id_index + 1];
+  }
+
+  Size ColumnarPSMStore::getIdentificationIndex(Size hit_index) const
+  {
+    // first identification whose hits start after 'hit_index', minus one
+    return std::upper_bound(hit_begin_.begin(), hit_begin_.end() - 1, hit_index) - hit_begin_.begin() - 1;
+  }
+
+  double ColumnarPSMStore::getRT(Size id_index) const
+  {
+    return rt_[id_index];
+  }
+
+  void ColumnarPSMStore::setRT(Size id_index, double rt)
+  {
+    rt_[id_index] = rt;
+  }
+
+  double ColumnarPSMStore::getMZ(Size id_index) const
+  {
+    return mz_[id_index];
+  }
+
+  void ColumnarPSMStore::setMZ(Size id_index, double mz)
+  {
+    mz_[id_index] = mz;
+  }
+
+  const String& ColumnarPSMStore::getIdentifier(Size id_index) const
+  {
+    return strings_[identifier_[id_index]];
+  }
+
+  void ColumnarPSMStore::setIdentifier(Size id_index, const String& identifier)
+  {
+    identifier_[id_index] = internString_(identifier);
+  }
+
+  const String& ColumnarPSMStore::getScoreType(Size id_index) const
+  {
+    return strings_[score_type_[id_index]];
+  }
+
+  void ColumnarPSMStore::setScoreType(Size id_index, const String& score_type)
+  {
+    score_type_[id_index] = internString_(score_type);
+  }
+
+  bool ColumnarPSMStore::isHigherScoreBetter(Size id_index) const
+  {
+    return higher_score_better_[id_index];
+  }
+
+  void ColumnarPSMStore::setHigherScoreBetter(Size id_index, bool higher_score_better)
+  {
+    higher_score_better_[id_index] = higher_score_better;
+  }
+
+  double ColumnarPSMStore::getSignificanceThreshold(Size id_index) const
+  {
+    return significance_threshold_[id_index];
+  }
+
+  void ColumnarPSMStore::setSignificanceThreshold(Size id_index, double threshold)
+  {
+    significance_threshold_[id_index] = threshold;
+  }
+
+  const String& ColumnarPSMStore::getBaseName(Size id_index) const
+  {
+    return strings_[base_name_[id_index]];
+  }
+
+  void ColumnarPSMStore::setBaseName(Size id_index, const String& base_name)
+  {
+    base_name_[id_index] = internString_(base_name);
+  }
+
+  const AASequence& ColumnarPSMStore::getSequence(Size hit_index) const
+  {
+    return sequences_[sequence_[hit_index]].getSequence();
+  }
+
+  const InternedAASequence& ColumnarPSMStore::getInternedSequence(Size hit_index) const
+  {
+    return sequences_[sequence_[hit_index]];
+  }
+
+  double ColumnarPSMStore::getScore(Size hit_index) const
+  {
+    return score_[hit_index];
+  }
+
+  void ColumnarPSMStore::setScore(Size hit_index, double score)
+  {
+    score_[hit_index] = score;
+  }
+
+  UInt ColumnarPSMStore::getRank(Size hit_index) const
+  {
+    return rank_[hit_index];
+  }
+
+  void ColumnarPSMStore::setRank(Size hit_index, UInt rank)
+  {
+    rank_[hit_index] = rank;
+  }
+
+  Int ColumnarPSMStore::getCharge(Size hit_index) const
+  {
+    return charge_[hit_index];
+  }
+
+  void ColumnarPSMStore::setCharge(Size hit_index, Int charge)
+  {
+    charge_[hit_index] = charge;
+  }
+
+  std::vector<PeptideEvidence> ColumnarPSMStore::getPeptideEvidences(Size hit_index) const
+  {
+    std::vector<PeptideEvidence> evidences;
+    evidences.reserve(evidence_begin_[hit_index + 1] - evidence_begin_[hit_index]);
+    for (Size e = evidence_begin_[hit_index]; e < evidence_begin_[hit_index + 1]; ++e)
+    {
+      evidences.push_back(PeptideEvidence(strings_[evidence_accession_[e]], evidence_start_[e], evidence_end_[e], evidence_aa_before_[e], evidence_aa_after_[e]));
+    }
+    return evidences;
+  }
+
+  UInt ColumnarPSMStore::metaIndex_(const String& name)
+  {
+    return MetaInfoInterface::metaRegistry().getIndex(name);
+  }
+
+  bool ColumnarPSMStore::hitMetaValueExists(Size hit_index, UInt key) const
+  {
+    std::map<UInt, MetaColumn_>::const_iterator it = hit_meta_.find(key);
+    return it != hit_meta_.end() && it->second.exists(hit_index);
+  }
+
+  bool ColumnarPSMStore::hitMetaValueExists(Size hit_index, const String& name) const
+  {
+    return hitMetaValueExists(hit_index, metaIndex_(name));
+  }
+
+  DataValue ColumnarPSMStore::getHitMetaValue(Size hit_index, UInt key) const
+  {
+    std::map<UInt, MetaColumn_>::const_iterator it = hit_meta_.find(key);
+    if (it == hit_meta_.end()) return DataValue::EMPTY;
+    return it->second.get(hit_index, strings_);
+  }
+
+  DataValue ColumnarPSMStore::getHitMetaValue(Size hit_index, const String& name) const
+  {
+    return getHitMetaValue(hit_index, metaIndex_(name));
+  }
+
+  void ColumnarPSMStore::setHitMetaValue(Size hit_index, UInt key, const DataValue& value)
+  {
+    std::map<UInt, MetaColumn_>::iterator it = hit_meta_.find(key);
+    if (it == hit_meta_.end())
+    {
+      if (value.isEmpty()) return;
+      it = hit_meta_.insert(std::make_pair(key, MetaColumn_())).first;
+      it->second.resize(getNumberOfHits());
+    }
+    it->second.set(hit_index, value, *this);
+  }
+
+  void ColumnarPSMStore::setHitMetaValue(Size hit_index, const String& name, const DataValue& value)
+  {
+    setHitMetaValue(hit_index, MetaInfoInterface::metaRegistry().registerName(name), value);
+  }
+
+  void ColumnarPSMStore::removeHitMetaValue(Size hit_index, UInt key)
+  {
+    setHitMetaValue(hit_index, key, DataValue::EMPTY);
+  }
+
+  bool ColumnarPSMStore::identificationMetaValueExists(Size id_index, UInt key) const
+  {
+    std::map<UInt, MetaColumn_>::const_iterator it = id_meta_.find(key);
+    return it != id_meta_.end() && it->second.exists(id_index);
+  }
+
+  DataValue ColumnarPSMStore::getIdentificationMetaValue(Size id_index, UInt key) const
+  {
+    std::map<UInt, MetaColumn_>::const_iterator it = id_meta_.find(key);
+    if (it == id_meta_.end()) return DataValue::EMPTY;
+    return it->second.get(id_index, strings_);
+  }
+
+  DataValue ColumnarPSMStore::getIdentificationMetaValue(Size id_index, const String& name) const
+  {
+    return getIdentificationMetaValue(id_index, metaIndex_(name));
+  }
+
+  void ColumnarPSMStore::setIdentificationMetaValue(Size id_index, UInt key, const DataValue& value)
+  {
+    std::map<UInt, MetaColumn_>::iterator it = id_meta_.find(key);
+    if (it == id_meta_.end())
+    {
+      if (value.isEmpty()) return;
+      it = id_meta_.insert(std::make_pair(key, MetaColumn_())).first;
+      it->second.resize(size());
+    }
+    it->second.set(id_index, value, *this);
+  }
+
+  void ColumnarPSMStore::setIdentificationMetaValue(Size id_index, const String& name, const DataValue& value)
+  {
+    setIdentificationMetaValue(id_index, MetaInfoInterface::metaRegistry().registerName(name), value);
+  }
+
+  std::vector<UInt> ColumnarPSMStore::getHitMetaKeys() const
+  {
+    std::vector<UInt> keys;
+    for (const auto& col : hit_meta_)
+    {
+      if (col.second.hasValues()) keys.push_back(col.first);
+    }
+    return keys;
+  }
+
+  void ColumnarPSMStore::filterHits(const std::vector<bool>& keep)
+  {
+    if (keep.size() != getNumberOfHits())
+    {
+      throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, keep.size());
+    }
+    std::vector<Size> new_to_old;
+    new_to_old.reserve(getNumberOfHits());
+    std::vector<Size> new_hit_begin(1, 0);
+    new_hit_begin.reserve(size() + 1);
+    for (Size i = 0; i < size(); ++i)
+    {
+      for (Size h = getHitBegin(i); h < getHitEnd(i); ++h)
+      {
+        if (keep[h]) new_to_old.push_back(h);
+      }
+      new_hit_begin.push_back(new_to_old.size());
+    }
+    if (new_to_old.size() == getNumberOfHits()) return; // nothing removed
+    gatherHits_(new_to_old, new_hit_begin);
+  }
+
+  void ColumnarPSMStore::sortedHitOrder_(Size id_index, std::vector<Size>& order) const
+  {
+    order.clear();
+    for (Size h = getHitBegin(id_index); h < getHitEnd(id_index); ++h)
+    {
+      order.push_back(h);
+    }
+    const std::vector<double>& scores = score_;
+    if (higher_score_better_[id_index])
+    {
+      std::stable_sort(order.begin(), order.end(), [&scores](Size a, Size b) { return scores[a] > scores[b]; });
+    }
+    else
+    {
+      std::stable_sort(order.begin(), order.end(), [&scores](Size a, Size b) { return scores[a] < scores[b]; });
+    }
+  }
+
+  void ColumnarPSMStore::sortHits()
+  {
+    std::vector<Size> new_to_old;
+    new_to_old.reserve(getNumberOfHits());
+    std::vector<Size> order;
+    bool changed(false);
+    for (Size i = 0; i < size(); ++i)
+    {
+      sortedHitOrder_(i, order);
+      for (Size h : order)
+      {
+        changed |= (h != new_to_old.size());
+        new_to_old.push_back(h);
+      }
+    }
+    if (!changed) return; // already sorted
+    std::vector<Size> new_hit_begin(hit_begin_);
+    gatherHits_(new_to_old, new_hit_begin);
+  }
+
+  void ColumnarPSMStore::assignRanks()
+  {
+    sortHits();
+    for (Size i = 0; i < size(); ++i)
+    {
+      UInt rank = 1;
+      for (Size h = getHitBegin(i); h < getHitEnd(i); ++h)
+      {
+        if (h != getHitBegin(i) && score_[h] != score_[h - 1]) ++rank;
+        rank_[h] = rank;
+      }
+    }
+  }
+
+  void ColumnarPSMStore::removeEmptyIdentifications()
+  {
+    std::vector<Size> new_to_old;
+    new_to_old.reserve(size());
+    for (Size i = 0; i < size(); ++i)
+    {
+      if (getHitBegin(i) != getHitEnd(i)) new_to_old.push_back(i);
+    }
+    if (new_to_old.size() == size()) return;
+
+    std::vector<Size> new_hit_begin;
+    new_hit_begin.reserve(new_to_old.size() + 1);
+    for (Size i : new_to_old)
+    {
+      new_hit_begin.push_back(hit_begin_[i]);
+    }
+    new_hit_begin.push_back(getNumberOfHits());
+    hit_begin_.swap(new_hit_begin);
+
+    gatherVector(rt_, new_to_old);
+    gatherVector(mz_, new_to_old);
+    gatherVector(identifier_, new_to_old);
+    gatherVector(score_type_, new_to_old);
+    gatherVector(higher_score_better_, new_to_old);
+    gatherVector(significance_threshold_, new_to_old);
+    gatherVector(base_name_, new_to_old);
+    for (auto& col : id_meta_)
+    {
+      col.second.gather(new_to_old);
+    }
+  }
+
+  void ColumnarPSMStore::gatherHits_(const std::vector<Size>& new_to_old, std::vector<Size>& new_hit_begin)
+  {
+    // evidences: gather the ranges of the selected hits
+    std::vector<Size> evidence_new_to_old;
+    std::vector<Size> new_evidence_begin(1, 0);
+    new_evidence_begin.reserve(new_to_old.size() + 1);
+    for (Size h : new_to_old)
+    {
+      for (Size e = evidence_begin_[h]; e < evidence_begin_[h + 1]; ++e)
+      {
+        evidence_new_to_old.push_back(e);
+      }
+      new_evidence_begin.push_back(evidence_new_to_old.size());
+    }
+    evidence_begin_.swap(new_evidence_begin);
+    gatherVector(evidence_accession_, evidence_new_to_old);
+    gatherVector(evidence_start_, evidence_new_to_old);
+    gatherVector(evidence_end_, evidence_new_to_old);
+    gatherVector(evidence_aa_before_, evidence_new_to_old);
+    gatherVector(evidence_aa_after_, evidence_new_to_old);
+
+    gatherVector(sequence_, new_to_old);
+    gatherVector(score_, new_to_old);
+    gatherVector(rank_, new_to_old);
+    gatherVector(charge_, new_to_old);
+    for (auto& col : hit_meta_)
+    {
+      col.second.gather(new_to_old);
+    }
+    gatherMap(analysis_results_, new_to_old);
+    gatherMap(peak_annotations_, new_to_old);
+
+    hit_begin_.swap(new_hit_begin);
+  }
+
+  ColumnarPSMStore::StringRef ColumnarPSMStore::internString_(const String& s)
+  {
+    std::size_t hash = std::hash<std::string>()(s);
+    auto range = string_index_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+      if (strings_[it->second] == s) return it->second;
+    }
+    StringRef ref = strings_.size();
+    strings_.push_back(s);
+    string_index_.insert(std::make_pair(hash, ref));
+    return ref;
+  }
+
+  std::size_t ColumnarPSMStore::sequenceHash_(const AASequence& seq)
+  {
+    // residues (including modified ones) are unique objects in ResidueDB, so
+    // their addresses identify them:
+    std::size_t seed = 0;
+    for (const Residue& residue : seq)
+    {
+      boost::hash_combine(seed, &residue);
+    }
+    boost::hash_combine(seed, seq.getNTerminalModification());
+    boost::hash_combine(seed, seq.getCTerminalModification());
+    return seed;
+  }
+
+  UInt ColumnarPSMStore::internSequence_(const InternedAASequence& seq)
+  {
+    std::size_t hash = sequenceHash_(seq.getSequence());
+    auto range = sequence_index_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+      if (sequences_[it->second].getSequence() == seq.getSequence()) return it->second;
+    }
+    UInt ref = sequences_.size();
+    sequences_.push_back(seq);
+    sequence_index_.insert(std::make_pair(hash, ref));
+    return ref;
+  }
+
+} // namespace OpenMS
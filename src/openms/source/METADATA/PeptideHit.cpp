@@ -66,6 +66,19 @@ namespace OpenMS
 
   // values constructor
   PeptideHit::PeptideHit(double score, UInt rank, Int charge, AASequence&& sequence) :
+    MetaInfoInterface(),
+    sequence_(std::move(sequence)),
+    score_(score),
+    analysis_results_(nullptr),
+    rank_(rank),
+    charge_(charge),
+    peptide_evidences_(),
+    fragment_annotations_()
+  {
+  }
+
+  // values constructor
+  PeptideHit::PeptideHit(double score, UInt rank, Int charge, const InternedAASequence& sequence) :
     MetaInfoInterface(),
     sequence_(sequence),
     score_(score),
@@ -204,17 +217,27 @@ namespace OpenMS
   // returns the peptide sequence without trailing or following spaces
   const AASequence& PeptideHit::getSequence() const
   {
-    return sequence_;
+    return sequence_.getSequence();
   }
 
   void PeptideHit::setSequence(const AASequence& sequence)
   {
-    sequence_ = sequence;
+    sequence_ = InternedAASequence(sequence);
   }
 
   void PeptideHit::setSequence(AASequence&& sequence)
   {
-    sequence_ = std::move(sequence);
+    sequence_ = InternedAASequence(std::move(sequence));
+  }
+
+  const InternedAASequence& PeptideHit::getInternedSequence() const
+  {
+    return sequence_;
+  }
+
+  void PeptideHit::setSequence(const InternedAASequence& sequence)
+  {
+    sequence_ = sequence;
   }
 
   Int PeptideHit::getCharge() const
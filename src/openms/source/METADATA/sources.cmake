@@ -10,6 +10,7 @@ CVTerm.cpp
 CVTermList.cpp
 CVTermListInterface.cpp
 ChromatogramSettings.cpp
+ColumnarPSMStore.cpp
 ContactPerson.cpp
 DataArrays.cpp
 DataProcessing.cpp
@@ -0,0 +1,307 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/SYSTEM/Profiler.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/SYSTEM/SysInfo.h>
+
+#ifdef OPENMS_WINDOWSPLATFORM
+#include <windows.h>
+#endif
+
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+
+using namespace std;
+
+namespace OpenMS
+{
+  const Profiler::SpanId Profiler::INVALID_SPAN = numeric_limits<Profiler::SpanId>::max();
+
+  std::atomic<bool> Profiler::enabled_(false);
+  std::mutex Profiler::mutex_;
+  std::chrono::steady_clock::time_point Profiler::origin_ = std::chrono::steady_clock::now();
+  std::vector<Profiler::OpenSpan_> Profiler::open_;
+  std::vector<Profiler::SpanId> Profiler::free_;
+  std::vector<Profiler::Span> Profiler::spans_;
+  Size Profiler::thread_count_ = 0;
+
+  namespace
+  {
+    // per-thread state: small thread id (assigned on first use) and current nesting depth
+    thread_local Size profiler_thread_id = numeric_limits<Size>::max();
+    thread_local Size profiler_depth = 0;
+
+    String escapeJSON(const String& s)
+    {
+      String r;
+      r.reserve(s.size());
+      for (char c : s)
+      {
+        switch (c)
+        {
+          case '"': r += "\\\""; break;
+          case '\\': r += "\\\\"; break;
+          case '\n': r += "\\n"; break;
+          case '\t': r += "\\t"; break;
+          case '\r': r += "\\r"; break;
+          default:
+            if ((unsigned char)c < 0x20)
+            {
+              r += ' ';
+            }
+            else
+            {
+              r += c;
+            }
+        }
+      }
+      return r;
+    }
+
+    // TSV cells must not contain tabs or line breaks
+    String escapeTSV(String s)
+    {
+      for (char& c : s)
+      {
+        if (c == '\t' || c == '\n' || c == '\r') c = ' ';
+      }
+      return s;
+    }
+  }
+
+  Profiler::Scope::Scope(const char* name, const char* category) :
+    id_(INVALID_SPAN),
+    items_(-1)
+  {
+    if (Profiler::isEnabled())
+    {
+      id_ = Profiler::beginSpan(name, category);
+    }
+  }
+
+  Profiler::Scope::~Scope()
+  {
+    if (id_ != INVALID_SPAN)
+    {
+      Profiler::endSpan(id_, items_);
+    }
+  }
+
+  void Profiler::Scope::setItems(Int64 items)
+  {
+    items_ = items;
+  }
+
+  double Profiler::cpuTime_()
+  {
+#if defined(OPENMS_WINDOWSPLATFORM)
+    FILETIME creation_time, exit_time, kernel_time, user_time;
+    if (GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time, &kernel_time, &user_time))
+    {
+      // 100 ns units
+      ULARGE_INTEGER kernel, user;
+      kernel.LowPart = kernel_time.dwLowDateTime;
+      kernel.HighPart = kernel_time.dwHighDateTime;
+      user.LowPart = user_time.dwLowDateTime;
+      user.HighPart = user_time.dwHighDateTime;
+      return double(kernel.QuadPart + user.QuadPart) * 1e-7;
+    }
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+    {
+      return double(ts.tv_sec) + double(ts.tv_nsec) * 1e-9;
+    }
+#endif
+    // no per-thread clock available: process CPU time
+    return double(std::clock()) / CLOCKS_PER_SEC;
+  }
+
+  void Profiler::enable()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (spans_.empty() && open_.size() == free_.size())
+    {
+      origin_ = std::chrono::steady_clock::now();
+    }
+    enabled_.store(true);
+  }
+
+  void Profiler::disable()
+  {
+    enabled_.store(false);
+  }
+
+  void Profiler::clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    open_.clear();
+    free_.clear();
+    spans_.clear();
+    origin_ = std::chrono::steady_clock::now();
+  }
+
+  Profiler::SpanId Profiler::beginSpan(const String& name, const String& category)
+  {
+    if (!isEnabled()) return INVALID_SPAN;
+
+    OpenSpan_ open;
+    open.span.name = name;
+    open.span.category = category;
+    open.span.depth = profiler_depth++;
+    SysInfo::getProcessMemoryConsumption(open.rss_start);
+    SysInfo::getProcessPeakMemoryConsumption(open.peak_rss_start);
+    open.cpu_start = cpuTime_();
+    open.used = true;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (profiler_thread_id == numeric_limits<Size>::max())
+    {
+      profiler_thread_id = thread_count_++;
+    }
+    open.span.thread = profiler_thread_id;
+    open.wall_start = std::chrono::steady_clock::now();
+    open.span.start = std::chrono::duration<double>(open.wall_start - origin_).count();
+
+    SpanId id;
+    if (!free_.empty())
+    {
+      id = free_.back();
+      free_.pop_back();
+      open_[id] = std::move(open);
+    }
+    else
+    {
+      id = open_.size();
+      open_.push_back(std::move(open));
+    }
+    return id;
+  }
+
+  void Profiler::endSpan(SpanId id, Int64 items)
+  {
+    if (id == INVALID_SPAN) return;
+
+    auto wall_end = std::chrono::steady_clock::now();
+    double cpu_end = cpuTime_();
+    size_t rss_end(0), peak_rss_end(0);
+    SysInfo::getProcessMemoryConsumption(rss_end);
+    bool has_peak = SysInfo::getProcessPeakMemoryConsumption(peak_rss_end);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (id >= open_.size() || !open_[id].used) return; // cleared in the meantime or closed twice
+
+    if (profiler_depth > 0) --profiler_depth;
+
+    OpenSpan_& open = open_[id];
+    Span span = std::move(open.span);
+    span.wall_time = std::chrono::duration<double>(wall_end - open.wall_start).count();
+    // CPU time is measured per thread, so it is only meaningful if the span is closed on the thread that opened it
+    span.cpu_time = (profiler_thread_id == span.thread) ? cpu_end - open.cpu_start : 0.0;
+    span.rss_delta = Int64(rss_end) - Int64(open.rss_start);
+    span.peak_rss_delta = has_peak ? Int64(peak_rss_end) - Int64(open.peak_rss_start) : 0;
+    span.items = items;
+    spans_.push_back(std::move(span));
+
+    open.used = false;
+    free_.push_back(id);
+  }
+
+  std::vector<Profiler::Span> Profiler::getSpans()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return spans_;
+  }
+
+  void Profiler::writeChromeTrace(std::ostream& os)
+  {
+    std::vector<Span> spans = getSpans();
+    os << "{\n\"displayTimeUnit\": \"ms\",\n\"traceEvents\": [";
+    os << std::fixed << std::setprecision(3);
+    for (Size i = 0; i < spans.size(); ++i)
+    {
+      const Span& s = spans[i];
+      os << (i == 0 ? "\n" : ",\n")
+         << "{\"name\": \"" << escapeJSON(s.name) << "\", \"cat\": \"" << escapeJSON(s.category)
+         << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << s.thread
+         << ", \"ts\": " << s.start * 1e6 << ", \"dur\": " << s.wall_time * 1e6
+         << ", \"args\": {\"cpu_ms\": " << s.cpu_time * 1e3
+         << ", \"rss_delta_kb\": " << s.rss_delta
+         << ", \"peak_rss_delta_kb\": " << s.peak_rss_delta
+         << ", \"depth\": " << s.depth;
+      if (s.items >= 0)
+      {
+        os << ", \"items\": " << s.items;
+      }
+      os << "}}";
+    }
+    os << "\n]\n}\n";
+  }
+
+  void Profiler::writeTSV(std::ostream& os)
+  {
+    std::vector<Span> spans = getSpans();
+    os << "name\tcategory\tthread\tdepth\tstart_s\twall_s\tcpu_s\trss_delta_kb\tpeak_rss_delta_kb\titems\n";
+    os << std::fixed << std::setprecision(6);
+    for (const Span& s : spans)
+    {
+      os << escapeTSV(s.name) << '\t' << escapeTSV(s.category) << '\t' << s.thread << '\t' << s.depth << '\t'
+         << s.start << '\t' << s.wall_time << '\t' << s.cpu_time << '\t'
+         << s.rss_delta << '\t' << s.peak_rss_delta << '\t' << s.items << '\n';
+    }
+  }
+
+  void Profiler::write(const String& filename)
+  {
+    std::ofstream os(filename.c_str());
+    if (!os)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    String lower = filename;
+    lower.toLower();
+    if (lower.hasSuffix(".tsv") || lower.hasSuffix(".txt"))
+    {
+      writeTSV(os);
+    }
+    else
+    {
+      writeChromeTrace(os);
+    }
+  }
+
+} // namespace OpenMS
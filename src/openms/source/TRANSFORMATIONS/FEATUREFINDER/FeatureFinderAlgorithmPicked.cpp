@@ -46,6 +46,7 @@
 #include <OpenMS/CHEMISTRY/ElementDB.h>
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopeDistribution.h>
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+#include <OpenMS/SYSTEM/Profiler.h>
 
 #include <QtCore/QDir>
 
@@ -157,6 +158,7 @@ namespace OpenMS
 
   void FeatureFinderAlgorithmPicked::run()
   {
+    OPENMS_PROFILE_SCOPE("FeatureFinderAlgorithmPicked::run");
     //-------------------------------------------------------------------------
     //General initialization
     //---------------------------------------------------------------------------
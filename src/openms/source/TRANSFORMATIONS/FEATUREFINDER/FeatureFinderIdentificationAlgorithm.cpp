@@ -47,11 +47,13 @@
 #include <OpenMS/FORMAT/FeatureXMLFile.h>
 #include <OpenMS/FORMAT/TraMLFile.h>
 #include <OpenMS/CHEMISTRY/ModificationsDB.h>
+#include <OpenMS/CONCEPT/ParallelExceptionCollector.h>
 
 #include <vector>
 #include <numeric>
 #include <fstream>
 #include <algorithm>
+#include <exception>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -366,10 +368,73 @@ namespace OpenMS
     boost::shared_ptr<PeakMap> shared = boost::make_shared<PeakMap>(ms_data_);
     OpenSwath::SpectrumAccessPtr spec_temp =
       SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(shared);
-    extractor.extractChromatograms(spec_temp, chrom_temp, coords, mz_window_,
-                                   mz_window_ppm_, "tophat");
-    extractor.return_chromatogram(chrom_temp, coords, library_, (*shared)[0],
-                                  chrom_data_.getChromatograms(), false);
+
+    // the coordinates are sorted by m/z and extracted independently of each
+    // other, so split them into contiguous blocks that are extracted in
+    // parallel; the blocks are converted in order (the conversion accesses the
+    // assay library) and the intermediate chromatograms of a block are freed
+    // right after its conversion, so only a few blocks are held in memory
+    // (the number of blocks is limited because every conversion call sets up
+    // a lookup table for the whole library):
+    SignedSize block_size = max(SignedSize(1000), SignedSize(coords.size()) / 64);
+    SignedSize n_blocks = (SignedSize(coords.size()) + block_size - 1) /
+      block_size;
+    ParallelExceptionCollector errors;
+#ifdef _OPENMP
+#pragma omp parallel for ordered schedule(dynamic, 1)
+#endif
+    for (SignedSize block = 0; block < n_blocks; ++block)
+    {
+      vector<OpenSwath::ChromatogramPtr> block_chroms;
+      vector<ChromatogramExtractor::ExtractionCoordinates> block_coords;
+      std::exception_ptr block_error;
+      try
+      {
+        Size block_start = block * block_size;
+        Size block_end = min(Size(block_start + block_size), coords.size());
+        block_chroms.assign(chrom_temp.begin() + block_start,
+                            chrom_temp.begin() + block_end);
+        block_coords.assign(coords.begin() + block_start,
+                            coords.begin() + block_end);
+        // spectrum access and progress logging are not thread-safe:
+        ChromatogramExtractor block_extractor;
+        block_extractor.setLogType(ProgressLogger::NONE);
+        block_extractor.extractChromatograms(spec_temp->lightClone(),
+                                             block_chroms, block_coords,
+                                             mz_window_, mz_window_ppm_,
+                                             "tophat");
+      }
+      catch (...)
+      {
+        block_error = std::current_exception();
+      }
+#ifdef _OPENMP
+#pragma omp ordered
+#endif
+      {
+        if (!block_error)
+        {
+          try
+          {
+            extractor.return_chromatogram(block_chroms, block_coords, library_,
+                                          (*shared)[0],
+                                          chrom_data_.getChromatograms(), false);
+          }
+          catch (...)
+          {
+            block_error = std::current_exception();
+          }
+        }
+        block_chroms.clear();
+        for (Size i = block * block_size;
+             i < min(Size((block + 1) * block_size), chrom_temp.size()); ++i)
+        {
+          chrom_temp[i].reset();
+        }
+      }
+      errors.capture(block, block_error);
+    }
+    errors.rethrowFirst();
 
     OPENMS_LOG_DEBUG << "Extracted " << chrom_data_.getNrChromatograms()
               << " chromatogram(s)." << endl;
@@ -40,6 +40,7 @@
 #include <OpenMS/KERNEL/MSChromatogram.h>
 #include <OpenMS/MATH/MISC/SplineBisection.h>
 #include <OpenMS/MATH/MISC/CubicSpline2d.h>
+#include <OpenMS/SYSTEM/Profiler.h>
 
 
 using namespace std;
@@ -446,6 +447,7 @@ namespace OpenMS
                                        std::vector<std::vector<PeakBoundary> >& boundaries_chrom,
                                        const bool check_spectrum_type) const
   {
+    OPENMS_PROFILE_SCOPE("PeakPickerHiRes::pickExperiment");
     // make sure that output is clear
     output.clear(true);
 
@@ -524,6 +526,7 @@ namespace OpenMS
   */
   void PeakPickerHiRes::pickExperiment(/* const */ OnDiscMSExperiment& input, PeakMap& output, const bool check_spectrum_type) const
   {
+    OPENMS_PROFILE_SCOPE("PeakPickerHiRes::pickExperiment");
     // make sure that output is clear
     output.clear(true);
 
@@ -40,6 +40,7 @@
 #include <OpenMS/KERNEL/StandardTypes.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/KERNEL/OnDiscMSExperiment.h>
+#include <OpenMS/KERNEL/OnDiscSpectrumCache.h>
 #include <OpenMS/KERNEL/FeatureMap.h>
 #include <OpenMS/KERNEL/ConsensusMap.h>
 #include <OpenMS/DATASTRUCTURES/String.h>
@@ -54,6 +55,8 @@
 
 namespace OpenMS
 {
+  class PeakMapTileCache;
+
   /**
   @brief Class that stores the data for one layer
 
@@ -153,6 +156,12 @@ public:
     /// SharedPtr on On-Disc MSExperiment
     typedef boost::shared_ptr<OnDiscMSExperiment> ODExperimentSharedPtrType;
 
+    /// SharedPtr on the intensity pyramid used for painting peak data in 2D
+    typedef boost::shared_ptr<PeakMapTileCache> TileCacheSharedPtrType;
+
+    /// SharedPtr on the cache of spectra read on demand from the on-disc data
+    typedef boost::shared_ptr<OnDiscSpectrumCache> SpectrumCacheSharedPtrType;
+
     //@}
 
     /// Default constructor
@@ -179,6 +188,8 @@ public:
       peaks(new ExperimentType()),
       on_disc_peaks(new OnDiscMSExperiment()),
       chromatograms(new ExperimentType()),
+      tile_cache(),
+      spectrum_cache(),
       current_spectrum_(0),
       cached_spectrum_()
     {
@@ -237,6 +248,8 @@ public:
     void setPeakData(ExperimentSharedPtrType p)
     {
       peaks = p;
+      tile_cache.reset();
+      spectrum_cache.reset();
       updateCache_();
     }
 
@@ -252,6 +265,42 @@ public:
       return on_disc_peaks;
     }
 
+    /**
+    @brief Returns the intensity pyramid of the peak data (null if none was computed)
+
+    The pyramid is discarded whenever the peak data is replaced (see setPeakData()).
+    */
+    const TileCacheSharedPtrType & getTileCache() const
+    {
+      return tile_cache;
+    }
+
+    /// Sets the intensity pyramid of the peak data
+    void setTileCache(TileCacheSharedPtrType cache)
+    {
+      tile_cache = cache;
+    }
+
+    /**
+    @brief Returns the cache of spectra read on demand (null if the peak data is held in memory)
+
+    If set, the in-memory peak data contains only the meta data of the
+    spectra (see getPeakData()) and all peaks are read from the on-disc data
+    when needed. The cache is discarded whenever the peak data is replaced
+    (see setPeakData()).
+    */
+    const SpectrumCacheSharedPtrType & getSpectrumCache() const
+    {
+      return spectrum_cache;
+    }
+
+    /// Sets the cache of spectra read on demand
+    void setSpectrumCache(SpectrumCacheSharedPtrType cache)
+    {
+      spectrum_cache = cache;
+      updateCache_();
+    }
+
     /// Returns a mutable reference to the current chromatogram data
     const ExperimentSharedPtrType & getChromatogramData() const
     {
@@ -309,6 +358,10 @@ public:
       {
         return (*peaks)[spectrum_idx];
       }
+      else if (spectrum_cache)
+      {
+        return *spectrum_cache->getSpectrum(spectrum_idx);
+      }
       else if (!on_disc_peaks->empty())
       {
         return on_disc_peaks->getSpectrum(spectrum_idx);
@@ -470,6 +523,12 @@ private:
     /// chromatogram data
     ExperimentSharedPtrType chromatograms;
 
+    /// intensity pyramid of the peak data (2D view)
+    TileCacheSharedPtrType tile_cache;
+
+    /// spectra read on demand from the on-disc data
+    SpectrumCacheSharedPtrType spectrum_cache;
+
     /// Index of the current spectrum
     Size current_spectrum_;
 
@@ -0,0 +1,225 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+// OpenMS_GUI config
+#include <OpenMS/VISUAL/OpenMS_GUIConfig.h>
+
+#include <OpenMS/KERNEL/StandardTypes.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Multi-resolution intensity pyramid of the MS1 peaks of a peak map
+
+    Zoomed-out 2D views of large peak maps show (many) more peaks than pixels. Instead of walking
+    all raw peaks of the visible area on each repaint, the 2D canvas samples this pyramid, which
+    stores the maximum and the sum of the intensities of all MS1 peaks per RT x m/z tile.
+
+    The finest level (level 0) has at most one RT bin per MS1 spectrum and @p mz_bins m/z bins
+    (see constructor). Each further level halves the number of bins in both dimensions until a
+    single tile remains. @ref selectLevel() picks the coarsest level whose tiles are not larger than
+    a pixel of the current view; if there is none (i.e. the view is zoomed in further than the
+    resolution of level 0), the raw peaks have to be painted.
+
+    The pyramid can be computed in a background thread (@ref buildAsync()) and persisted next
+    to the data file (@ref store(), @ref load()), so it is available immediately when the same
+    file is opened again.
+
+    @note The pyramid does not know about data filters. It must not be used if peaks are filtered.
+
+    @ingroup Visual
+  */
+  class OPENMS_GUI_DLLAPI PeakMapTileCache
+  {
+public:
+    /// One level of the pyramid; tiles are stored row-wise (RT-major)
+    struct OPENMS_GUI_DLLAPI Level
+    {
+      Size rt_bins = 0; ///< number of tiles in RT dimension
+      Size mz_bins = 0; ///< number of tiles in m/z dimension
+      std::vector<float> max; ///< maximum intensity per tile (-1 if the tile is empty)
+      std::vector<float> sum; ///< intensity sum per tile
+
+      /// Maximum intensity of tile (@p rt, @p mz); -1 if the tile contains no peaks
+      float maxAt(Size rt, Size mz) const
+      {
+        return max[rt * mz_bins + mz];
+      }
+
+      /// Intensity sum of tile (@p rt, @p mz)
+      float sumAt(Size rt, Size mz) const
+      {
+        return sum[rt * mz_bins + mz];
+      }
+    };
+
+    /// Shared pointer to a constant peak map (keeps the data alive during background computation)
+    typedef boost::shared_ptr<const PeakMap> ConstExperimentSharedPtrType;
+
+    /**
+      @brief Constructor
+
+      @param rt_bins Maximum number of tiles of the finest level in RT dimension (limited by the number of MS1 spectra)
+      @param mz_bins Number of tiles of the finest level in m/z dimension
+    */
+    explicit PeakMapTileCache(Size rt_bins = 2048, Size mz_bins = 2048);
+
+    /// Destructor; cancels and waits for a running background computation
+    ~PeakMapTileCache();
+
+    PeakMapTileCache(const PeakMapTileCache&) = delete;
+    PeakMapTileCache& operator=(const PeakMapTileCache&) = delete;
+
+    /// Computes the pyramid from the MS1 spectra of @p map (blocking)
+    void build(const PeakMap& map);
+
+    /**
+      @brief Computes the pyramid in a background thread
+
+      Returns immediately. Use @ref isReady() to check whether the pyramid can be used.
+      @p map must not be modified while the computation is running.
+
+      If @p store_filename is given, the pyramid is stored there (see @ref store()) once it is complete.
+    */
+    void buildAsync(ConstExperimentSharedPtrType map, const String& store_filename = "", const String& data_filename = "");
+
+    /// Cancels a running background computation and waits for it to finish
+    void cancel();
+
+    /// Returns true if the pyramid is complete and can be used
+    bool isReady() const
+    {
+      return ready_.load(std::memory_order_acquire);
+    }
+
+    /// Returns true while a background computation is running
+    bool isBuilding() const
+    {
+      return building_.load(std::memory_order_acquire);
+    }
+
+    /// Returns the number of levels (0 if not ready)
+    Size getLevelCount() const;
+
+    /// Returns the level @p index (0 = finest)
+    const Level& getLevel(Size index) const;
+
+    /**
+      @brief Returns the index of the coarsest level whose tiles are not larger than a pixel
+
+      @param rt_pixel_size Size of one pixel in RT dimension (in seconds)
+      @param mz_pixel_size Size of one pixel in m/z dimension (in Th)
+      @return The level index, or -1 if the pyramid is not ready or too coarse for this view
+    */
+    Int selectLevel(double rt_pixel_size, double mz_pixel_size) const;
+
+    /**
+      @brief Computes the maximum intensity per pixel of a view from level @p level_index
+
+      Each tile is assigned to the pixel containing its center.
+
+      @param level_index The level to sample (see @ref selectLevel())
+      @param rt_min Lower RT bound of the view
+      @param rt_max Upper RT bound of the view
+      @param mz_min Lower m/z bound of the view
+      @param mz_max Upper m/z bound of the view
+      @param rt_pixel_count Number of pixels in RT dimension
+      @param mz_pixel_count Number of pixels in m/z dimension
+      @param pixels Row-wise (RT-major) maximum intensity per pixel; -1 for pixels without peaks
+    */
+    void sampleMaxima(Size level_index, double rt_min, double rt_max, double mz_min, double mz_max,
+                      Size rt_pixel_count, Size mz_pixel_count, std::vector<float>& pixels) const;
+
+    /// Lower RT bound of the tile grid (RT of the first MS1 spectrum)
+    double getRTMin() const { return rt_min_; }
+    /// Upper RT bound of the tile grid
+    double getRTMax() const { return rt_max_; }
+    /// Lower m/z bound of the tile grid
+    double getMZMin() const { return mz_min_; }
+    /// Upper m/z bound of the tile grid
+    double getMZMax() const { return mz_max_; }
+
+    /**
+      @brief Stores the pyramid in a binary file
+
+      @p data_filename is the file the peak map was loaded from; its size and modification time
+      are stored so that @ref load() can detect stale caches.
+
+      @return false if the pyramid is not ready or the file cannot be written
+    */
+    bool store(const String& filename, const String& data_filename) const;
+
+    /**
+      @brief Loads a pyramid stored by @ref store()
+
+      @return false (and leaves the cache empty) if the file does not exist, is invalid, was created
+      with a different resolution or does not match @p data_filename or @p map
+    */
+    bool load(const String& filename, const String& data_filename, const PeakMap& map);
+
+    /// Returns the name of the file the pyramid of @p data_filename is persisted in
+    static String cacheFilename(const String& data_filename);
+
+protected:
+    /// Computes the pyramid; returns false if cancelled
+    bool compute_(const PeakMap& map);
+
+    /// Computes the coarser levels from level 0
+    void buildCoarserLevels_();
+
+    /// Signature of the data (resolution, spectra and MS1 peak count, file size and time stamp) used to validate persisted caches
+    std::vector<UInt64> signature_(UInt64 spectra_count, UInt64 ms1_peak_count, const String& data_filename) const;
+
+    Size max_rt_bins_;
+    Size mz_bins_;
+    double rt_min_, rt_max_, mz_min_, mz_max_;
+    UInt64 spectra_count_;
+    UInt64 ms1_peak_count_;
+    std::vector<Level> levels_;
+
+    std::thread worker_;
+    std::atomic<bool> ready_;
+    std::atomic<bool> building_;
+    std::atomic<bool> cancel_;
+  };
+
+} // namespace OpenMS
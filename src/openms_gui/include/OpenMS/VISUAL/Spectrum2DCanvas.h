@@ -140,6 +140,12 @@ protected slots:
     /// Reacts on changed layer parameters
     void currentLayerParametersChanged_();
 
+    /// Repaints once all intensity pyramids computed in the background are complete (polled by a timer)
+    void checkTileCaches_();
+
+    /// Repaints while spectra of on-disc layers are read in the background (polled by a timer)
+    void checkSpectrumCaches_();
+
 protected:
     // Docu in base class
     bool finishAdding_() override;
@@ -192,6 +198,39 @@ protected:
     */
     void paintMaximumIntensities_(Size layer_index, Size rt_pixel_count, Size mz_pixel_count, QPainter& p);
 
+    /**
+      @brief Paints maximum intensities from the intensity pyramid of the layer (see PeakMapTileCache)
+
+      @param layer_index The index of the layer.
+      @param rt_pixel_count
+      @param mz_pixel_count
+      @return false (without painting anything) if the pyramid is not available, not fine enough for the current zoom level or data filters are active
+    */
+    bool paintTileIntensities_(Size layer_index, Size rt_pixel_count, Size mz_pixel_count);
+
+    /**
+      @brief Loads or (asynchronously) computes the intensity pyramid of a peak layer
+
+      Depending on the parameters 'dot:tile_cache' and 'dot:tile_cache_on_disk'.
+
+      @param layer_index The index of the layer.
+    */
+    void initTileCache_(Size layer_index);
+
+    /**
+      @brief Paints the visible MS1 spectra of a layer whose peaks are read on demand (see LayerData::getSpectrumCache())
+
+      At most one spectrum per RT pixel is painted. Spectra which are not
+      cached yet are skipped and read in the background, the canvas is
+      repainted as they arrive (see checkSpectrumCaches_()).
+
+      @param layer_index The index of the layer.
+      @param rt_pixel_count
+      @param mz_pixel_count
+      @param p The QPainter to paint on.
+    */
+    void paintOnDiscIntensities_(Size layer_index, Size rt_pixel_count, Size mz_pixel_count, QPainter& p);
+
     /**
       @brief Paints the precursor peaks.
 
@@ -389,6 +428,9 @@ protected:
     double pen_size_max_; ///< maximum number of pixels for one data point
     double canvas_coverage_min_; ///< minimum coverage of the canvas required; if lower, points are upscaled in size
 
+    AreaType spectrum_prefetch_area_; ///< visible area for which spectra of on-disc layers were last requested
+    bool spectrum_prefetch_polling_; ///< true while checkSpectrumCaches_() is scheduled
+
   private:
     /// Default C'tor hidden
     Spectrum2DCanvas();
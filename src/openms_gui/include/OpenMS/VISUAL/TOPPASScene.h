@@ -43,6 +43,7 @@
 
 #include <QtWidgets/QGraphicsScene>
 #include <QtCore/QProcess>
+#include <QtCore/QTimer>
 
 namespace OpenMS
 {
@@ -93,11 +94,14 @@ public:
     struct TOPPProcess
     {
       /// Constructor
-      TOPPProcess(QProcess * p, const QString & cmd, const QStringList & arg, TOPPASToolVertex * const tool) :
+      TOPPProcess(QProcess * p, const QString & cmd, const QStringList & arg, TOPPASToolVertex * const tool, int num_threads = 1, UInt mem_mb = 0) :
         proc(p),
         command(cmd),
         args(arg),
-        tv(tool)
+        tv(tool),
+        threads(num_threads),
+        memory_mb(mem_mb),
+        peak_memory_mb(0)
       {
       }
 
@@ -109,6 +113,12 @@ public:
       QStringList args;
       /// The tool which is started (used to call its slots)
       TOPPASToolVertex * tv;
+      /// Number of threads reserved for the process
+      int threads;
+      /// Memory (in MB) reserved for the process (0 if unknown)
+      UInt memory_mb;
+      /// Highest resident memory (in MB) observed while the process was running
+      UInt peak_memory_mb;
     };
 
     /// The current action mode (creation of a new edge, or panning of the widget)
@@ -204,9 +214,17 @@ public:
     bool isPipelineRunning();
     /// Shows a dialog that allows to specify the output directory. If @p always_ask == false, the dialog won't be shown if a directory has been set, already.
     bool askForOutputDir(bool always_ask = true);
-    /// Enqueues the process, it will be run when the currently pending processes have finished
+    /// Enqueues the process, it will be run as soon as its threads and memory are available
     void enqueueProcess(const TOPPProcess & process);
-    /// Runs the next process in the queue, if any
+    /**
+      @brief Starts queued processes as long as their reservations fit into the thread and memory budget
+
+      Processes are considered in the order they were enqueued, but a process that does
+      not fit does not block smaller ones behind it. A process that needs more than the
+      whole budget is started as soon as nothing else is running; while it waits at the
+      head of the queue, no later processes are started (no backfilling), so it cannot
+      be starved by a stream of smaller ones.
+    */
     void runNextProcess();
     /// Resets the processes queue
     void resetProcessesQueue();
@@ -240,8 +258,24 @@ public:
     QString getDescription() const;
     /// when description is updated by user, use this to update the description for later storage in file
     void setDescription(const QString & desc);
-    /// sets the maximum number of jobs
+    /// sets the maximum number of threads used by all running tools together (each tool counts with its 'threads' parameter)
     void setAllowedThreads(int num_threads);
+    /// sets the maximum memory (in MB) reserved by all running tools together (0 for no limit)
+    void setAllowedMemory(UInt memory_mb);
+    /**
+      @brief Enables or disables resuming from the results of a previous run
+
+      If enabled, intermediate files in the temporary directory are kept when the pipeline
+      is started, and tool runs whose output files are newer than their input files (and
+      whose parameters did not change) are not repeated.
+    */
+    void setResumeEnabled(bool enabled);
+    /// is resuming from the results of a previous run enabled?
+    bool isResumeEnabled() const;
+    /// Loads the peak memory usage of the tools recorded by a previous run from @p file (see storeResourceUsage())
+    void loadResourceUsage(const String & file);
+    /// Stores the peak memory usage of the tools recorded while running the pipeline to @p file
+    void storeResourceUsage(const String & file) const;
     /// returns the hovering edge
     TOPPASEdge* getHoveringEdge();
     /// Checks whether all output vertices are finished, and if yes, emits entirePipelineFinished() (called by finished output vertices)
@@ -275,8 +309,10 @@ public slots:
     void changedParameter(const bool invalidates_running_pipeline);
     /// Invoked by OutfilelistVertex of user changed the folder name
     void changedOutputFolder();
-    /// Called by a finished QProcess to indicate that we are free to start a new one
-    void processFinished();
+    /// Called by a finished QProcess @p p to release its reservation and start the next processes
+    void processFinished(QProcess * p);
+    /// Updates the peak memory usage of all running processes (called periodically while processes are running)
+    void updateProcessMemoryUsage();
     /// dirty solution: when using ExecutePipeline this slot is called when the pipeline crashes. This will quit the app
     void quitWithError();
 
@@ -355,12 +391,22 @@ protected:
     TOPPASScene * clipboard_;
     /// dry run mode (no tools are actually called)
     bool dry_run_;
-    /// currently running processes...
+    /// currently running processes
+    QList<TOPPProcess> running_processes_;
+    /// number of threads reserved by the currently running processes
     int threads_active_;
+    /// memory (in MB) reserved by the currently running processes
+    UInt memory_active_;
     /// description text
     QString description_text_;
     /// maximum number of allowed threads
     int allowed_threads_;
+    /// maximum memory (in MB) reserved by running processes (0 for no limit)
+    UInt allowed_memory_;
+    /// keep intermediate files and skip up-to-date tool runs?
+    bool resume_enabled_;
+    /// polls the memory usage of running processes
+    QTimer * memory_timer_;
     /// last node where 'resume' was started
     TOPPASToolVertex* resume_source_;
 
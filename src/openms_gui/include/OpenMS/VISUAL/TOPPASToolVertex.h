@@ -198,6 +198,18 @@ public:
     virtual void emitToolStarted();
     /// invert status of recycling (overriding base class)
     bool invertRecylingMode() override;
+    /// Sets the memory (in MB) to reserve for each run of this tool (0: use the recorded peak memory)
+    void setMemoryReservation(UInt memory_mb);
+    /// Returns the memory (in MB) declared for each run of this tool (0 if none was declared)
+    UInt getMemoryReservation() const;
+    /// Records the peak memory (in MB) observed for a run of this tool (the maximum of all recorded values is kept)
+    void recordPeakMemory(UInt memory_mb);
+    /// Returns the highest peak memory (in MB) recorded for a run of this tool (0 if unknown)
+    UInt getRecordedPeakMemory() const;
+    /// Returns the memory (in MB) to reserve for a run: the declared reservation or, if none was declared, the recorded peak memory
+    UInt getRequiredMemory() const;
+    /// Returns the number of threads used by a run of this tool (its 'threads' parameter or 1 if it has none)
+    int getRequiredThreads() const;
 
 public slots:
 
@@ -254,6 +266,15 @@ protected:
     void getParameters_(QVector<IOInfo>& io_infos, bool input_params) const;
     /// Writes @p param to the @p ini_file
     void writeParam_(const Param& param, const QString& ini_file);
+    /**
+      @brief Checks whether round @p round was already run successfully with the same arguments and INI file (see TOPPASScene::setResumeEnabled())
+
+      This is the case if the stamp file @p stamp_file written after the last successful run starts with
+      @p stamp_content, all output files listed in the stamp exist and none of them is older than any input file.
+      The stamp lists the final output names (after renameOutput_()); if the round is up-to-date, the output
+      files of the round are set to these names.
+    */
+    bool isRoundUpToDate_(int round, const RoundPackages& pkg, const QString& stamp_file, const QByteArray& stamp_content);
     /// Helper method for finding good boundaries for wrapping the tool name. Returns a string with whitespaces at the preferred boundaries.
     QString toolnameWithWhitespacesForFancyWordWrapping_(QPainter* painter, const QString& str);
 
@@ -272,6 +293,12 @@ protected:
 
     /// Breakpoint set?
     bool breakpoint_set_;
+    /// memory (in MB) to reserve for a run (0 if not declared)
+    UInt memory_reservation_;
+    /// highest memory (in MB) recorded for a run (0 if unknown)
+    UInt peak_memory_;
+    /// stamp file and content of each successfully finished round; written once the outputs are renamed
+    std::vector<std::pair<QString, QByteArray> > finished_stamps_;
 
     /// smart naming of round-based filenames
     /// when basename is not unique we take the preceding directory name
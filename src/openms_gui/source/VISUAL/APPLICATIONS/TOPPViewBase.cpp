@@ -621,7 +621,7 @@ namespace OpenMS
     defaults_.setValidStrings("preferences:topp_cleanup", ListUtils::create<String>("true,false"));
     defaults_.setValue("preferences:use_cached_ms2", "false", "If possible, only load MS1 spectra into memory and keep MS2 spectra on disk (using indexed mzML).");
     defaults_.setValidStrings("preferences:use_cached_ms2", ListUtils::create<String>("true,false"));
-    defaults_.setValue("preferences:use_cached_ms1", "false", "If possible, do not load MS1 spectra into memory spectra into memory and keep MS2 spectra on disk (using indexed mzML).");
+    defaults_.setValue("preferences:use_cached_ms1", "false", "If possible, only load the meta data of all spectra into memory and read spectra on demand from disk while browsing (using indexed mzML).");
     defaults_.setValidStrings("preferences:use_cached_ms1", ListUtils::create<String>("true,false"));
     // 1d view
     Spectrum1DCanvas* def1 = new Spectrum1DCanvas(Param(), nullptr);
@@ -1244,7 +1244,8 @@ namespace OpenMS
           MzMLFile f;
           Internal::IndexedMzMLHandler indexed_mzml_file_;
           indexed_mzml_file_.openFile(filename);
-          if ( indexed_mzml_file_.getParsingSuccess() && cache_ms2_on_disc)
+          // keeping MS1 spectra on disc implies keeping MS2 spectra on disc
+          if ( indexed_mzml_file_.getParsingSuccess() && (cache_ms2_on_disc || cache_ms1_on_disc))
           {
             // If it has an index, now load index and meta data
             on_disc_peaks->openFile(filename, false);
@@ -1263,6 +1264,9 @@ namespace OpenMS
             // In a second step (see below), we populate some of these maps
             // with actual spectra including raw data (allowing us to only
             // populate MS1 spectra with actual data).
+            //
+            // If MS1 spectra are kept on disc as well, the layer reads them
+            // on demand for display (see LayerData::getSpectrumCache()).
 
             // peak_map_sptr = boost::static_pointer_cast<ExperimentSharedPtrType>(on_disc_peaks->getMetaData());
             peak_map_sptr = on_disc_peaks->getMetaData();
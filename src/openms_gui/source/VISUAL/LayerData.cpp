@@ -75,6 +75,10 @@ namespace OpenMS
     {
       cached_spectrum_ = (*peaks)[current_spectrum_];
     }
+    else if (spectrum_cache && spectrum_cache->size() > current_spectrum_)
+    {
+      cached_spectrum_ = *spectrum_cache->getSpectrum(current_spectrum_);
+    }
     else if (on_disc_peaks->getNrSpectra() > current_spectrum_)
     {
       cached_spectrum_ = on_disc_peaks->getSpectrum(current_spectrum_);
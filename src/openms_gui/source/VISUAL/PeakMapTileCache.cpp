@@ -0,0 +1,397 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/VISUAL/PeakMapTileCache.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+#include <QtCore/QDateTime>
+#include <QtCore/QFileInfo>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+using namespace std;
+
+namespace OpenMS
+{
+  namespace
+  {
+    const char TILE_CACHE_MAGIC[8] = {'O', 'M', 'S', 'T', 'I', 'L', 'E', '1'};
+
+    template <typename T>
+    void writeValue(ostream& os, const T& value)
+    {
+      os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    bool readValue(istream& is, T& value)
+    {
+      is.read(reinterpret_cast<char*>(&value), sizeof(T));
+      return bool(is);
+    }
+
+    // index of the bin containing @p pos, clamped to [0, bins)
+    inline Size binIndex(double pos, double min, double width, Size bins)
+    {
+      double idx = (pos - min) / width;
+      if (idx <= 0.0) return 0;
+      Size i = Size(idx);
+      return i < bins ? i : bins - 1;
+    }
+  }
+
+  PeakMapTileCache::PeakMapTileCache(Size rt_bins, Size mz_bins) :
+    max_rt_bins_(std::max(rt_bins, Size(1))),
+    mz_bins_(std::max(mz_bins, Size(1))),
+    rt_min_(0.0),
+    rt_max_(0.0),
+    mz_min_(0.0),
+    mz_max_(0.0),
+    spectra_count_(0),
+    ms1_peak_count_(0),
+    levels_(),
+    worker_(),
+    ready_(false),
+    building_(false),
+    cancel_(false)
+  {
+  }
+
+  PeakMapTileCache::~PeakMapTileCache()
+  {
+    cancel();
+  }
+
+  void PeakMapTileCache::cancel()
+  {
+    cancel_ = true;
+    if (worker_.joinable())
+    {
+      worker_.join();
+    }
+    cancel_ = false;
+  }
+
+  void PeakMapTileCache::build(const PeakMap& map)
+  {
+    cancel();
+    ready_ = false;
+    if (compute_(map))
+    {
+      ready_.store(true, std::memory_order_release);
+    }
+  }
+
+  void PeakMapTileCache::buildAsync(ConstExperimentSharedPtrType map, const String& store_filename, const String& data_filename)
+  {
+    cancel();
+    ready_ = false;
+    building_ = true;
+    // the thread owns a reference to the data, so it stays alive even if the layer is closed
+    worker_ = std::thread([this, map, store_filename, data_filename]()
+    {
+      if (compute_(*map))
+      {
+        ready_.store(true, std::memory_order_release);
+        if (!store_filename.empty())
+        {
+          store(store_filename, data_filename);
+        }
+      }
+      building_.store(false, std::memory_order_release);
+    });
+  }
+
+  bool PeakMapTileCache::compute_(const PeakMap& map)
+  {
+    levels_.clear();
+    spectra_count_ = map.size();
+    ms1_peak_count_ = 0;
+
+    // grid bounds and number of MS1 spectra (m/z bounds from the first/last peak of sorted spectra)
+    Size ms1_count(0);
+    rt_min_ = mz_min_ = std::numeric_limits<double>::max();
+    rt_max_ = mz_max_ = -std::numeric_limits<double>::max();
+    for (PeakMap::ConstIterator it = map.begin(); it != map.end(); ++it)
+    {
+      if (it->getMSLevel() != 1 || it->empty()) continue;
+      ++ms1_count;
+      rt_min_ = std::min(rt_min_, it->getRT());
+      rt_max_ = std::max(rt_max_, it->getRT());
+      mz_min_ = std::min(mz_min_, it->front().getMZ());
+      mz_max_ = std::max(mz_max_, it->back().getMZ());
+    }
+    if (ms1_count == 0)
+    {
+      rt_min_ = rt_max_ = mz_min_ = mz_max_ = 0.0;
+      return false;
+    }
+
+    Level base;
+    base.rt_bins = std::min(max_rt_bins_, ms1_count);
+    base.mz_bins = mz_bins_;
+    base.max.assign(base.rt_bins * base.mz_bins, -1.0f);
+    base.sum.assign(base.rt_bins * base.mz_bins, 0.0f);
+
+    // the last spectrum / peak lies on the upper bound and goes into the last bin
+    const double rt_width = (rt_max_ > rt_min_ ? rt_max_ - rt_min_ : 1.0) / base.rt_bins;
+    const double mz_width = (mz_max_ > mz_min_ ? mz_max_ - mz_min_ : 1.0) / base.mz_bins;
+
+    for (PeakMap::ConstIterator it = map.begin(); it != map.end(); ++it)
+    {
+      if (cancel_) return false;
+      if (it->getMSLevel() != 1) continue;
+
+      ms1_peak_count_ += it->size();
+      const Size row = binIndex(it->getRT(), rt_min_, rt_width, base.rt_bins) * base.mz_bins;
+      for (PeakMap::SpectrumType::ConstIterator p = it->begin(); p != it->end(); ++p)
+      {
+        const Size idx = row + binIndex(p->getMZ(), mz_min_, mz_width, base.mz_bins);
+        const float intensity = p->getIntensity();
+        base.sum[idx] += intensity;
+        if (intensity > base.max[idx]) base.max[idx] = intensity;
+      }
+    }
+    levels_.push_back(std::move(base));
+
+    buildCoarserLevels_();
+    return !cancel_;
+  }
+
+  void PeakMapTileCache::buildCoarserLevels_()
+  {
+    while (levels_.back().rt_bins > 1 || levels_.back().mz_bins > 1)
+    {
+      if (cancel_) return;
+
+      const Level& fine = levels_.back();
+      Level coarse;
+      coarse.rt_bins = (fine.rt_bins + 1) / 2;
+      coarse.mz_bins = (fine.mz_bins + 1) / 2;
+      coarse.max.assign(coarse.rt_bins * coarse.mz_bins, -1.0f);
+      coarse.sum.assign(coarse.rt_bins * coarse.mz_bins, 0.0f);
+      // a dimension with a single bin is not halved any further
+      const Size rt_factor = fine.rt_bins > 1 ? 2 : 1;
+      const Size mz_factor = fine.mz_bins > 1 ? 2 : 1;
+      for (Size rt = 0; rt < fine.rt_bins; ++rt)
+      {
+        const Size fine_row = rt * fine.mz_bins;
+        const Size coarse_row = (rt / rt_factor) * coarse.mz_bins;
+        for (Size mz = 0; mz < fine.mz_bins; ++mz)
+        {
+          const Size idx = coarse_row + mz / mz_factor;
+          coarse.sum[idx] += fine.sum[fine_row + mz];
+          coarse.max[idx] = std::max(coarse.max[idx], fine.max[fine_row + mz]);
+        }
+      }
+      levels_.push_back(std::move(coarse));
+    }
+  }
+
+  Size PeakMapTileCache::getLevelCount() const
+  {
+    return isReady() ? levels_.size() : 0;
+  }
+
+  const PeakMapTileCache::Level& PeakMapTileCache::getLevel(Size index) const
+  {
+    if (index >= getLevelCount())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, index, getLevelCount());
+    }
+    return levels_[index];
+  }
+
+  Int PeakMapTileCache::selectLevel(double rt_pixel_size, double mz_pixel_size) const
+  {
+    const Size count = getLevelCount();
+    if (count == 0) return -1;
+
+    const double rt_range = rt_max_ > rt_min_ ? rt_max_ - rt_min_ : 1.0;
+    const double mz_range = mz_max_ > mz_min_ ? mz_max_ - mz_min_ : 1.0;
+    Int selected = -1;
+    for (Size i = 0; i < count; ++i)
+    {
+      // tiles of coarser levels are larger, so we can stop at the first level that is too coarse
+      if (rt_range / levels_[i].rt_bins > rt_pixel_size || mz_range / levels_[i].mz_bins > mz_pixel_size) break;
+      selected = Int(i);
+    }
+    return selected;
+  }
+
+  void PeakMapTileCache::sampleMaxima(Size level_index, double rt_min, double rt_max, double mz_min, double mz_max,
+                                      Size rt_pixel_count, Size mz_pixel_count, std::vector<float>& pixels) const
+  {
+    pixels.assign(rt_pixel_count * mz_pixel_count, -1.0f);
+    if (rt_pixel_count == 0 || mz_pixel_count == 0 || rt_max <= rt_min || mz_max <= mz_min) return;
+
+    const Level& level = getLevel(level_index);
+    const double tile_rt = (rt_max_ > rt_min_ ? rt_max_ - rt_min_ : 1.0) / level.rt_bins;
+    const double tile_mz = (mz_max_ > mz_min_ ? mz_max_ - mz_min_ : 1.0) / level.mz_bins;
+    const double pixel_rt = (rt_max - rt_min) / rt_pixel_count;
+    const double pixel_mz = (mz_max - mz_min) / mz_pixel_count;
+
+    // tiles whose center lies within the view
+    const double rt_first = std::max(0.0, std::ceil((rt_min - rt_min_) / tile_rt - 0.5));
+    const double rt_last = std::min(double(level.rt_bins), std::ceil((rt_max - rt_min_) / tile_rt - 0.5));
+    const double mz_first = std::max(0.0, std::ceil((mz_min - mz_min_) / tile_mz - 0.5));
+    const double mz_last = std::min(double(level.mz_bins), std::ceil((mz_max - mz_min_) / tile_mz - 0.5));
+    if (rt_first >= rt_last || mz_first >= mz_last) return;
+
+    // pixel column of each visible m/z tile
+    std::vector<Size> mz_pixel(Size(mz_last) - Size(mz_first));
+    for (Size mz = Size(mz_first); mz < Size(mz_last); ++mz)
+    {
+      mz_pixel[mz - Size(mz_first)] = std::min(Size((mz_min_ + (mz + 0.5) * tile_mz - mz_min) / pixel_mz), mz_pixel_count - 1);
+    }
+
+    for (Size rt = Size(rt_first); rt < Size(rt_last); ++rt)
+    {
+      const Size rt_px = std::min(Size((rt_min_ + (rt + 0.5) * tile_rt - rt_min) / pixel_rt), rt_pixel_count - 1);
+      float* pixel_row = &pixels[rt_px * mz_pixel_count];
+      const float* tile_row = &level.max[rt * level.mz_bins];
+      for (Size mz = Size(mz_first); mz < Size(mz_last); ++mz)
+      {
+        float& px = pixel_row[mz_pixel[mz - Size(mz_first)]];
+        px = std::max(px, tile_row[mz]);
+      }
+    }
+  }
+
+  std::vector<UInt64> PeakMapTileCache::signature_(UInt64 spectra_count, UInt64 ms1_peak_count, const String& data_filename) const
+  {
+    QFileInfo info(data_filename.toQString());
+    std::vector<UInt64> sig;
+    sig.push_back(max_rt_bins_);
+    sig.push_back(mz_bins_);
+    sig.push_back(spectra_count);
+    sig.push_back(ms1_peak_count);
+    sig.push_back(UInt64(info.size()));
+    sig.push_back(UInt64(info.lastModified().toMSecsSinceEpoch()));
+    return sig;
+  }
+
+  bool PeakMapTileCache::store(const String& filename, const String& data_filename) const
+  {
+    if (!isReady()) return false;
+
+    ofstream os(filename.c_str(), ios::out | ios::binary);
+    if (!os) return false;
+
+    os.write(TILE_CACHE_MAGIC, sizeof(TILE_CACHE_MAGIC));
+    std::vector<UInt64> sig = signature_(spectra_count_, ms1_peak_count_, data_filename);
+    writeValue(os, UInt64(sig.size()));
+    for (UInt64 s : sig) writeValue(os, s);
+    writeValue(os, rt_min_);
+    writeValue(os, rt_max_);
+    writeValue(os, mz_min_);
+    writeValue(os, mz_max_);
+    writeValue(os, UInt64(levels_.size()));
+    for (const Level& level : levels_)
+    {
+      writeValue(os, UInt64(level.rt_bins));
+      writeValue(os, UInt64(level.mz_bins));
+      os.write(reinterpret_cast<const char*>(level.max.data()), level.max.size() * sizeof(float));
+      os.write(reinterpret_cast<const char*>(level.sum.data()), level.sum.size() * sizeof(float));
+    }
+    return bool(os);
+  }
+
+  bool PeakMapTileCache::load(const String& filename, const String& data_filename, const PeakMap& map)
+  {
+    cancel();
+    ready_ = false;
+    levels_.clear();
+
+    ifstream is(filename.c_str(), ios::in | ios::binary);
+    if (!is) return false;
+
+    char magic[sizeof(TILE_CACHE_MAGIC)];
+    is.read(magic, sizeof(magic));
+    if (!is || std::memcmp(magic, TILE_CACHE_MAGIC, sizeof(magic)) != 0) return false;
+
+    // compare against the signature of the current data
+    UInt64 ms1_peaks(0);
+    for (PeakMap::ConstIterator it = map.begin(); it != map.end(); ++it)
+    {
+      if (it->getMSLevel() == 1) ms1_peaks += it->size();
+    }
+    std::vector<UInt64> expected = signature_(map.size(), ms1_peaks, data_filename);
+    UInt64 sig_size(0);
+    if (!readValue(is, sig_size) || sig_size != expected.size()) return false;
+    for (UInt64 e : expected)
+    {
+      UInt64 s(0);
+      if (!readValue(is, s) || s != e) return false;
+    }
+
+    UInt64 level_count(0);
+    if (!readValue(is, rt_min_) || !readValue(is, rt_max_) || !readValue(is, mz_min_) || !readValue(is, mz_max_) ||
+        !readValue(is, level_count))
+    {
+      return false;
+    }
+    std::vector<Level> levels(level_count);
+    for (Level& level : levels)
+    {
+      UInt64 rt_bins(0), mz_bins(0);
+      if (!readValue(is, rt_bins) || !readValue(is, mz_bins) || rt_bins * mz_bins > UInt64(max_rt_bins_) * mz_bins_) return false;
+      level.rt_bins = rt_bins;
+      level.mz_bins = mz_bins;
+      level.max.resize(rt_bins * mz_bins);
+      level.sum.resize(rt_bins * mz_bins);
+      is.read(reinterpret_cast<char*>(level.max.data()), level.max.size() * sizeof(float));
+      is.read(reinterpret_cast<char*>(level.sum.data()), level.sum.size() * sizeof(float));
+      if (!is) return false;
+    }
+    if (levels.empty()) return false;
+
+    levels_.swap(levels);
+    spectra_count_ = map.size();
+    ms1_peak_count_ = ms1_peaks;
+    ready_.store(true, std::memory_order_release);
+    return true;
+  }
+
+  String PeakMapTileCache::cacheFilename(const String& data_filename)
+  {
+    return data_filename + ".tiles";
+  }
+
+} // namespace OpenMS
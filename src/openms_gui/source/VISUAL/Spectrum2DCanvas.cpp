@@ -44,7 +44,9 @@
 #include <OpenMS/VISUAL/DIALOGS/Spectrum2DPrefDialog.h>
 #include <OpenMS/VISUAL/ColorSelector.h>
 #include <OpenMS/VISUAL/MultiGradientSelector.h>
+#include <OpenMS/VISUAL/PeakMapTileCache.h>
 #include <OpenMS/VISUAL/DIALOGS/FeatureEditDialog.h>
+#include <OpenMS/SYSTEM/File.h>
 #include <OpenMS/SYSTEM/FileWatcher.h>
 #include <OpenMS/MATH/MISC/MathFunctions.h>
 //STL
@@ -57,6 +59,7 @@
 #include <QBitmap>
 #include <QPolygon>
 #include <QtCore/QTime>
+#include <QtCore/QTimer>
 #include <QtWidgets/QComboBox>
 #include <QtWidgets/QFileDialog>
 #include <QtWidgets/QMessageBox>
@@ -88,7 +91,9 @@ namespace OpenMS
     measurement_start_(),
     pen_size_min_(1),
     pen_size_max_(20),
-    canvas_coverage_min_(0.2)
+    canvas_coverage_min_(0.2),
+    spectrum_prefetch_area_(),
+    spectrum_prefetch_polling_(false)
   {
     //Parameter handling
     defaults_.setValue("background_color", "#ffffff", "Background color.");
@@ -103,6 +108,10 @@ namespace OpenMS
     defaults_.setMaxInt("dot:feature_icon_size", 999);
     defaults_.setValue("mapping_of_mz_to", "y_axis", "Determines which axis is the m/z axis.");
     defaults_.setValidStrings("mapping_of_mz_to", ListUtils::create<String>("x_axis,y_axis"));
+    defaults_.setValue("dot:tile_cache", "true", "Paint zoomed-out peak maps from a multi-resolution intensity pyramid, which is computed in the background when a peak map is opened.");
+    defaults_.setValidStrings("dot:tile_cache", ListUtils::create<String>("true,false"));
+    defaults_.setValue("dot:tile_cache_on_disk", "false", "Store the intensity pyramid next to the data file ('<file>.tiles') and reuse it when the file is opened again.");
+    defaults_.setValidStrings("dot:tile_cache_on_disk", ListUtils::create<String>("true,false"));
     defaultsToParam_();
     setName("Spectrum2DCanvas");
     setParameters(preferences);
@@ -348,6 +357,17 @@ namespace OpenMS
         swap(rt_pixel_count, mz_pixel_count);
       }
 
+      // peaks are read on demand: only the meta data is in memory
+      if (layer.getSpectrumCache())
+      {
+        paintOnDiscIntensities_(layer_index, rt_pixel_count, mz_pixel_count, painter);
+        if (getLayerFlag(layer_index, LayerData::P_PRECURSORS))
+        {
+          paintPrecursorPeaks_(layer_index, painter);
+        }
+        return;
+      }
+
       //-----------------------------------------------------------------------------------------------
       // Determine number of shown scans (MS1)
       std::vector<Size> rt_indices; // list of visible RT scans in MS1 with at least 2 points
@@ -638,6 +658,13 @@ namespace OpenMS
   {
     //set painter to black (we operate directly on the pixels for all colored data)
     painter.setPen(Qt::black);
+
+    // use the precomputed intensity pyramid if it is fine enough for the current zoom level
+    if (paintTileIntensities_(layer_index, rt_pixel_count, mz_pixel_count))
+    {
+      return;
+    }
+
     //temporary variables
     Int image_width = buffer_.width();
     Int image_height = buffer_.height();
@@ -726,6 +753,231 @@ namespace OpenMS
     }
   }
 
+  bool Spectrum2DCanvas::paintTileIntensities_(Size layer_index, Size rt_pixel_count, Size mz_pixel_count)
+  {
+    const LayerData & layer = getLayer(layer_index);
+    const LayerData::TileCacheSharedPtrType & cache = layer.getTileCache();
+    // the pyramid does not know about filtered peaks
+    if (!cache || !cache->isReady() || layer.filters.size() > 0)
+    {
+      return false;
+    }
+
+    const double rt_min = visible_area_.minPosition()[1];
+    const double rt_max = visible_area_.maxPosition()[1];
+    const double mz_min = visible_area_.minPosition()[0];
+    const double mz_max = visible_area_.maxPosition()[0];
+
+    //calculate pixel size in data coordinates
+    double rt_step_size = (rt_max - rt_min) / rt_pixel_count;
+    double mz_step_size = (mz_max - mz_min) / mz_pixel_count;
+
+    Int level = cache->selectLevel(rt_step_size, mz_step_size);
+    if (level < 0)
+    {
+      return false; // zoomed in too far: paint the raw peaks
+    }
+
+    std::vector<float> pixels;
+    cache->sampleMaxima(level, rt_min, rt_max, mz_min, mz_max, rt_pixel_count, mz_pixel_count, pixels);
+
+    Int image_width = buffer_.width();
+    Int image_height = buffer_.height();
+    double snap_factor = snap_factors_[layer_index];
+    for (Size rt = 0; rt < rt_pixel_count; ++rt)
+    {
+      double rt_center = rt_min + rt_step_size * (rt + 0.5);
+      for (Size mz = 0; mz < mz_pixel_count; ++mz)
+      {
+        float max = pixels[rt * mz_pixel_count + mz];
+        if (max < 0.0)
+        {
+          continue;
+        }
+        QPoint pos;
+        dataToWidget_(mz_min + mz_step_size * (mz + 0.5), rt_center, pos);
+        if (pos.x() >= 0 && pos.y() >= 0 && pos.y() < image_height && pos.x() < image_width)
+        {
+          buffer_.setPixel(pos.x(), pos.y(), heightColor_(max, layer.gradient, snap_factor).rgb());
+        }
+      }
+    }
+    return true;
+  }
+
+  void Spectrum2DCanvas::initTileCache_(Size layer_index)
+  {
+    LayerData & layer = getLayer_(layer_index);
+    layer.setTileCache(LayerData::TileCacheSharedPtrType());
+    // the pyramid needs all peaks in memory
+    if (layer.type != LayerData::DT_PEAK || layer.getSpectrumCache() || !param_.getValue("dot:tile_cache").toBool())
+    {
+      return;
+    }
+
+    LayerData::TileCacheSharedPtrType cache(new PeakMapTileCache());
+    layer.setTileCache(cache);
+
+    // reuse a persisted pyramid if it matches the data; otherwise compute (and store) it in the background
+    String store_filename;
+    if (param_.getValue("dot:tile_cache_on_disk").toBool() && !layer.filename.empty())
+    {
+      String cache_filename = PeakMapTileCache::cacheFilename(layer.filename);
+      if (File::exists(cache_filename) && cache->load(cache_filename, layer.filename, *layer.getPeakData()))
+      {
+        return;
+      }
+      store_filename = cache_filename;
+    }
+    cache->buildAsync(layer.getPeakData(), store_filename, layer.filename);
+    QTimer::singleShot(250, this, SLOT(checkTileCaches_()));
+  }
+
+  void Spectrum2DCanvas::checkTileCaches_()
+  {
+    for (Size i = 0; i < getLayerCount(); ++i)
+    {
+      const LayerData::TileCacheSharedPtrType & cache = getLayer(i).getTileCache();
+      if (cache && cache->isBuilding())
+      {
+        QTimer::singleShot(250, this, SLOT(checkTileCaches_()));
+        return;
+      }
+    }
+    update_buffer_ = true;
+    update_(OPENMS_PRETTY_FUNCTION);
+  }
+
+  void Spectrum2DCanvas::paintOnDiscIntensities_(Size layer_index, Size rt_pixel_count, Size mz_pixel_count, QPainter & painter)
+  {
+    const LayerData & layer = getLayer(layer_index);
+    const LayerData::SpectrumCacheSharedPtrType & cache = layer.getSpectrumCache();
+    const ExperimentType & map = *layer.getPeakData();
+    const double rt_min = visible_area_.minPosition()[1];
+    const double rt_max = visible_area_.maxPosition()[1];
+    const double mz_min = visible_area_.minPosition()[0];
+    const double mz_max = visible_area_.maxPosition()[0];
+
+    // visible MS1 scans, thinned out to at most one per RT pixel
+    vector<Size> scans;
+    for (ExperimentType::ConstIterator it = map.RTBegin(rt_min); it != map.RTEnd(rt_max); ++it)
+    {
+      if (it->getMSLevel() == 1)
+      {
+        scans.push_back(std::distance(map.begin(), it));
+      }
+    }
+    if (scans.size() > rt_pixel_count)
+    {
+      vector<Size> thinned;
+      for (Size i = 0; i < rt_pixel_count; ++i)
+      {
+        thinned.push_back(scans[i * scans.size() / rt_pixel_count]);
+      }
+      scans.swap(thinned);
+    }
+    if (scans.empty())
+    {
+      return;
+    }
+
+    // points are enlarged if only few scans are visible (see paintAllIntensities_)
+    double pen_width = std::min(std::max(rt_pixel_count / (double)scans.size(), pen_size_min_), pen_size_max_);
+
+    Int image_width = buffer_.width();
+    Int image_height = buffer_.height();
+    double snap_factor = snap_factors_[layer_index];
+    double mz_step_size = (mz_max - mz_min) / mz_pixel_count;
+    QVector<QPolygon> coloredPoints((int)layer.gradient.precalculatedSize());
+    vector<float> maxima(mz_pixel_count);
+    vector<Size> missing;
+    for (Size i = 0; i < scans.size(); ++i)
+    {
+      OnDiscSpectrumCache::SpectrumPtr spectrum = cache->getCachedSpectrum(scans[i]);
+      if (!spectrum)
+      {
+        missing.push_back(scans[i]);
+        continue;
+      }
+
+      // maximum intensity per m/z pixel
+      std::fill(maxima.begin(), maxima.end(), -1.0f);
+      for (ExperimentType::SpectrumType::ConstIterator it = spectrum->MZBegin(mz_min); it != spectrum->MZEnd(mz_max); ++it)
+      {
+        Size mz = std::min(Size((it->getMZ() - mz_min) / mz_step_size), mz_pixel_count - 1);
+        if (it->getIntensity() > maxima[mz] && layer.filters.passes(*spectrum, it - spectrum->begin()))
+        {
+          maxima[mz] = it->getIntensity();
+        }
+      }
+
+      for (Size mz = 0; mz < mz_pixel_count; ++mz)
+      {
+        if (maxima[mz] < 0.0)
+        {
+          continue;
+        }
+        QPoint pos;
+        dataToWidget_(mz_min + mz_step_size * (mz + 0.5), spectrum->getRT(), pos);
+        if (pos.x() >= 0 && pos.y() >= 0 && pos.x() < image_width && pos.y() < image_height)
+        {
+          coloredPoints[precalculatedColorIndex_(maxima[mz], layer.gradient, snap_factor)].push_back(pos);
+        }
+      }
+    }
+
+    // draw from minimum to maximum intensity
+    painter.save();
+    QPen pen;
+    pen.setWidthF(pen_width);
+    for (Int color_index = 0; color_index < coloredPoints.size(); ++color_index)
+    {
+      if (!coloredPoints[color_index].empty())
+      {
+        pen.setColor(layer.gradient.precalculatedColorByIndex(color_index));
+        painter.setPen(pen);
+        painter.drawPoints(coloredPoints[color_index]);
+      }
+    }
+    painter.restore();
+
+    // request the missing spectra, unless they were already read for this area (and did not fit into the cache)
+    if (!missing.empty() && (spectrum_prefetch_polling_ || !(spectrum_prefetch_area_ == visible_area_)))
+    {
+      cache->prefetch(missing);
+      spectrum_prefetch_area_ = visible_area_;
+      if (!spectrum_prefetch_polling_)
+      {
+        spectrum_prefetch_polling_ = true;
+        QTimer::singleShot(100, this, SLOT(checkSpectrumCaches_()));
+      }
+    }
+  }
+
+  void Spectrum2DCanvas::checkSpectrumCaches_()
+  {
+    bool busy = false;
+    for (Size i = 0; i < getLayerCount(); ++i)
+    {
+      const LayerData::SpectrumCacheSharedPtrType & cache = getLayer(i).getSpectrumCache();
+      if (cache && cache->isPrefetching())
+      {
+        busy = true;
+      }
+    }
+    if (busy)
+    {
+      QTimer::singleShot(250, this, SLOT(checkSpectrumCaches_()));
+    }
+    else
+    {
+      spectrum_prefetch_polling_ = false;
+    }
+    // show the spectra read so far
+    update_buffer_ = true;
+    update_(OPENMS_PRETTY_FUNCTION);
+  }
+
   void Spectrum2DCanvas::paintFeatureData_(Size layer_index, QPainter& painter)
   {
     const LayerData& layer = getLayer(layer_index);
@@ -1255,10 +1507,11 @@ namespace OpenMS
         QMessageBox::critical(this, "Error", "Cannot add a dataset that contains no survey scans. Aborting!");
         return false;
       }
-      if ((getCurrentLayer_().getPeakData()->getSize() == 0) && (!getCurrentLayer_().getPeakData()->getDataRange().isEmpty()))
+      if ((getCurrentLayer_().getPeakData()->getSize() == 0) && !getCurrentLayer_().getSpectrumCache() && (!getCurrentLayer_().getPeakData()->getDataRange().isEmpty()))
       {
         setLayerFlag(LayerData::P_PRECURSORS, true); // show precursors if no MS1 data is contained
       }
+      initTileCache_(current_layer_);
     }
     else if (layers_.back().type == LayerData::DT_FEATURE)  // feature data
     {
@@ -2842,6 +3095,8 @@ namespace OpenMS
 
   void Spectrum2DCanvas::updateLayer(Size i)
   {
+    // the data changed: recompute the intensity pyramid
+    initTileCache_(i);
     //update nearest peak
     selected_peak_.clear();
     recalculateRanges_(0, 1, 2);
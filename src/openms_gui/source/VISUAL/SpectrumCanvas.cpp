@@ -398,6 +398,20 @@ namespace OpenMS
     new_layer.setPeakData(map);
     new_layer.setOnDiscPeakData(od_map);
 
+    // MS1 spectra kept on disc (i.e. only their meta data is in memory): read them on demand
+    if (!od_map->empty() && od_map->getMetaData())
+    {
+      for (Size i = 1; i < map->size(); ++i)
+      {
+        if ((*map)[i].getMSLevel() != 1) continue;
+        if ((*map)[i].empty())
+        {
+          new_layer.setSpectrumCache(LayerData::SpectrumCacheSharedPtrType(new OnDiscSpectrumCache(*od_map)));
+        }
+        break;
+      }
+    }
+
     // both empty
     if (!new_layer.getPeakData()->getChromatograms().empty() 
      && !new_layer.getPeakData()->empty())
@@ -548,6 +562,16 @@ namespace OpenMS
         if (map.getMaxRT() > m_max[rt_dim]) m_max[rt_dim] = map.getMaxRT();
         if (map.getMinInt() < m_min[it_dim]) m_min[it_dim] = map.getMinInt();
         if (map.getMaxInt() > m_max[it_dim]) m_max[it_dim] = map.getMaxInt();
+
+        // peaks of spectra read on demand: use the overview of the MS1 spectra
+        const LayerData::SpectrumCacheSharedPtrType & cache = getLayer(layer_index).getSpectrumCache();
+        double mz_min(0), mz_max(0), int_max(0);
+        if (cache && cache->getOverviewRanges(mz_min, mz_max, int_max))
+        {
+          if (mz_min < m_min[mz_dim]) m_min[mz_dim] = mz_min;
+          if (mz_max > m_max[mz_dim]) m_max[mz_dim] = mz_max;
+          if (int_max > m_max[it_dim]) m_max[it_dim] = int_max;
+        }
       }
       else if (getLayer(layer_index).type == LayerData::DT_FEATURE)
       {
@@ -57,12 +57,39 @@
 #include <QtCore/QDir>
 #include <QtCore/QSet>
 #include <QtCore/QTextStream>
+#include <QtWidgets/QInputDialog>
 #include <QtWidgets/QMessageBox>
 
+#include <algorithm>
+#include <limits>
+
 namespace OpenMS
 {
 
 
+  namespace
+  {
+    /// Reads the peak resident memory (in MB) of the process @p pid (only available on Linux)
+    bool getPeakMemoryOfProcess(qint64 pid, UInt& memory_mb)
+    {
+      QFile status(QString("/proc/%1/status").arg(pid));
+      if (pid <= 0 || !status.open(QIODevice::ReadOnly | QIODevice::Text))
+      {
+        return false;
+      }
+      QTextStream in(&status);
+      for (QString line = in.readLine(); !line.isNull(); line = in.readLine())
+      {
+        if (line.startsWith("VmHWM:")) // e.g. "VmHWM:     123456 kB"
+        {
+          memory_mb = UInt(line.mid(6).trimmed().section(' ', 0, 0).toULongLong() / 1024);
+          return true;
+        }
+      }
+      return false;
+    }
+  }
+
   void FakeProcess::start(const QString& /*program*/, const QStringList& /*arguments*/, OpenMode /*mode = ReadWrite*/)
   {
     // don't do anything...
@@ -86,8 +113,13 @@ namespace OpenMS
     user_specified_out_dir_(false),
     clipboard_(nullptr),
     dry_run_(true),
+    running_processes_(),
     threads_active_(0),
+    memory_active_(0),
     allowed_threads_(1),
+    allowed_memory_(0),
+    resume_enabled_(false),
+    memory_timer_(new QTimer(this)),
     resume_source_(nullptr)
   {
     /*	ATTENTION!
@@ -99,6 +131,9 @@ namespace OpenMS
             (http://lists.trolltech.com/qt4-preview-feedback/2006-09/thread00124-0.html)
     */
     setItemIndexMethod(QGraphicsScene::NoIndex);
+
+    memory_timer_->setInterval(1000);
+    connect(memory_timer_, SIGNAL(timeout()), this, SLOT(updateProcessMemoryUsage()));
   }
 
   TOPPASScene::~TOPPASScene()
@@ -625,10 +660,10 @@ namespace OpenMS
     error_occured_ = false;
     resume_source_ = nullptr; // we are not resuming, so reset the resume node
 
-    // reset all nodes
+    // reset all nodes (keep the files of the previous run if we want to resume from them)
     for (VertexIterator it = verticesBegin(); it != verticesEnd(); ++it)
     {
-      (*it)->reset(true);
+      (*it)->reset(!resume_enabled_);
     }
     update(sceneRect());
 
@@ -662,7 +697,7 @@ namespace OpenMS
       // reset all nodes
       for (VertexIterator it = verticesBegin(); it != verticesEnd(); ++it)
       {
-        (*it)->reset(true);
+        (*it)->reset(!resume_enabled_);
       }
       update(sceneRect());
 
@@ -741,6 +776,14 @@ namespace OpenMS
         save_param.setValue("vertices:" + id + ":tool_name", DataValue(ttv->getName()));
         save_param.setValue("vertices:" + id + ":tool_type", DataValue(ttv->getType()));
         save_param.insert("vertices:" + id + ":parameters:", ttv->getParam());
+        if (ttv->getMemoryReservation() > 0)
+        {
+          save_param.setValue("vertices:" + id + ":memory_mb", DataValue(Int(ttv->getMemoryReservation())));
+        }
+        if (ttv->getRecordedPeakMemory() > 0)
+        {
+          save_param.setValue("vertices:" + id + ":peak_memory_mb", DataValue(Int(ttv->getRecordedPeakMemory())));
+        }
         save_param.setValue("vertices:" + id + ":x_pos", DataValue(tv->x()));
         save_param.setValue("vertices:" + id + ":y_pos", DataValue(tv->y()));
         continue;
@@ -962,6 +1005,15 @@ namespace OpenMS
           Param param_param = vertices_param.copy(current_id + ":parameters:", true);
           TOPPASToolVertex* tv = new TOPPASToolVertex(tool_name, tool_type);
           tv->setParam(param_param);
+          // resource usage (optional)
+          if (vertices_param.exists(current_id + ":memory_mb"))
+          {
+            tv->setMemoryReservation(UInt(Int(vertices_param.getValue(current_id + ":memory_mb"))));
+          }
+          if (vertices_param.exists(current_id + ":peak_memory_mb"))
+          {
+            tv->recordPeakMemory(UInt(Int(vertices_param.getValue(current_id + ":peak_memory_mb"))));
+          }
 
           connectToolVertexSignals(tv);
 
@@ -1664,13 +1716,42 @@ namespace OpenMS
     }
   }
 
-  void TOPPASScene::processFinished()
+  void TOPPASScene::processFinished(QProcess* p)
   {
-    --threads_active_;
+    for (int i = 0; i < running_processes_.size(); ++i)
+    {
+      if (running_processes_[i].proc != p) continue;
+
+      const TOPPProcess& tp = running_processes_[i];
+      threads_active_ -= tp.threads;
+      memory_active_ -= tp.memory_mb;
+      if (tp.peak_memory_mb > 0)
+      {
+        tp.tv->recordPeakMemory(tp.peak_memory_mb);
+      }
+      running_processes_.removeAt(i);
+      break;
+    }
+    if (running_processes_.empty())
+    {
+      memory_timer_->stop();
+    }
     // try to run next in line
     runNextProcess();
   }
 
+  void TOPPASScene::updateProcessMemoryUsage()
+  {
+    for (QList<TOPPProcess>::iterator it = running_processes_.begin(); it != running_processes_.end(); ++it)
+    {
+      UInt memory_mb(0);
+      if (getPeakMemoryOfProcess(it->proc->processId(), memory_mb))
+      {
+        it->peak_memory_mb = std::max(it->peak_memory_mb, memory_mb);
+      }
+    }
+  }
+
   bool TOPPASScene::askForOutputDir(bool always_ask)
   {
     if (gui_)
@@ -1788,6 +1869,7 @@ namespace OpenMS
       if (found_tool)
       {
         action.insert("Edit parameters");
+        action.insert("Set memory reservation");
         action.insert("Resume");
         action.insert("Open files in TOPPView");
         action.insert("Open containing folder");
@@ -1907,6 +1989,18 @@ namespace OpenMS
           {
             ttv->editParam();
           }
+          else if (text == "Set memory reservation")
+          {
+            bool ok(false);
+            int memory_mb = QInputDialog::getInt(nullptr, "Set memory reservation",
+                                                 "Memory (in MB) needed by a single run of this tool (0: use the peak memory of previous runs):",
+                                                 int(ttv->getMemoryReservation()), 0, std::numeric_limits<int>::max(), 256, &ok);
+            if (ok)
+            {
+              ttv->setMemoryReservation(UInt(memory_mb));
+              setChanged(true);
+            }
+          }
           else if (text == "Resume")
           {
             if (askForOutputDir(false))
@@ -2004,11 +2098,33 @@ namespace OpenMS
 
     used = true;
 
-    while (!topp_processes_queue_.empty() && threads_active_ < allowed_threads_)
-    {
-      ++threads_active_; // will be decreased, once the tool finishes
-      TOPPProcess tp = topp_processes_queue_.first();
-      topp_processes_queue_.pop_front();
+    int i = 0;
+    while (i < topp_processes_queue_.size() && threads_active_ < allowed_threads_)
+    {
+      TOPPProcess tp = topp_processes_queue_[i];
+      // a process which exceeds the budget on its own is run when nothing else is running
+      const bool fits = running_processes_.empty() ||
+                        (threads_active_ + tp.threads <= allowed_threads_ &&
+                         (allowed_memory_ == 0 || memory_active_ + tp.memory_mb <= allowed_memory_));
+      if (!fits)
+      {
+        // a process larger than the whole budget at the head of the queue waits until everything
+        // else has finished; starting later processes meanwhile could delay it indefinitely
+        const bool oversized = tp.threads > allowed_threads_ ||
+                               (allowed_memory_ != 0 && tp.memory_mb > allowed_memory_);
+        if (i == 0 && oversized)
+        {
+          break;
+        }
+        ++i; // maybe one of the next processes is small enough
+        continue;
+      }
+      topp_processes_queue_.removeAt(i);
+
+      // the reservation is released once the tool finishes
+      threads_active_ += tp.threads;
+      memory_active_ += tp.memory_mb;
+      running_processes_ << tp;
       FakeProcess* p = qobject_cast<FakeProcess*>(tp.proc);
       if (p)
       {
@@ -2018,7 +2134,9 @@ namespace OpenMS
       {
         tp.tv->emitToolStarted();
         tp.proc->start(tp.command, tp.args);
+        memory_timer_->start();
       }
+      i = 0; // finished fake processes might have freed resources for earlier processes
     }
     used = false;
 
@@ -2349,6 +2467,57 @@ namespace OpenMS
     allowed_threads_ = num_jobs;
   }
 
+  void TOPPASScene::setAllowedMemory(UInt memory_mb)
+  {
+    allowed_memory_ = memory_mb;
+  }
+
+  void TOPPASScene::setResumeEnabled(bool enabled)
+  {
+    resume_enabled_ = enabled;
+  }
+
+  bool TOPPASScene::isResumeEnabled() const
+  {
+    return resume_enabled_;
+  }
+
+  void TOPPASScene::loadResourceUsage(const String& file)
+  {
+    if (!File::exists(file))
+    {
+      return;
+    }
+    Param usage;
+    ParamXMLFile().load(file, usage);
+    foreach(TOPPASVertex * tv, vertices_)
+    {
+      TOPPASToolVertex* ttv = qobject_cast<TOPPASToolVertex*>(tv);
+      if (!ttv) continue;
+      // only use the values if the vertex still runs the same tool
+      String id(ttv->getTopoNr());
+      if (usage.exists(id + ":tool_name") && String(usage.getValue(id + ":tool_name")) == ttv->getName() &&
+          usage.exists(id + ":peak_memory_mb"))
+      {
+        ttv->recordPeakMemory(UInt(Int(usage.getValue(id + ":peak_memory_mb"))));
+      }
+    }
+  }
+
+  void TOPPASScene::storeResourceUsage(const String& file) const
+  {
+    Param usage;
+    foreach(TOPPASVertex * tv, vertices_)
+    {
+      TOPPASToolVertex* ttv = qobject_cast<TOPPASToolVertex*>(tv);
+      if (!ttv || ttv->getRecordedPeakMemory() == 0) continue;
+      String id(ttv->getTopoNr());
+      usage.setValue(id + ":tool_name", ttv->getName());
+      usage.setValue(id + ":peak_memory_mb", Int(ttv->getRecordedPeakMemory()), "Highest resident memory (in MB) of a single run of this tool");
+    }
+    ParamXMLFile().store(file, usage);
+  }
+
   bool TOPPASScene::isGUIMode() const
   {
     return gui_;
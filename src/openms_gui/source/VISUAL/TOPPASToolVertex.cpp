@@ -45,6 +45,7 @@
 
 #include <QtWidgets/QGraphicsScene>
 #include <QtWidgets/QMessageBox>
+#include <QtCore/QDateTime>
 #include <QtCore/QFile>
 #include <QtCore/QFileInfo>
 #include <QtCore/QDir>
@@ -52,9 +53,12 @@
 
 #include <QSvgRenderer>
 
+#include <algorithm>
+
 namespace OpenMS
 {
-
+  /// separates the arguments and parameters in a stamp file from the list of output files
+  static const char STAMP_OUTPUTS_HEADER[] = "\n[outputs]\n";
 
   struct NameComponent
   {
@@ -86,7 +90,9 @@ namespace OpenMS
     param_(),
     status_(TOOL_READY),
     tool_ready_(true),
-    breakpoint_set_(false)
+    breakpoint_set_(false),
+    memory_reservation_(0),
+    peak_memory_(0)
   {
     pen_color_ = Qt::black;
     brush_color_ = QColor(245, 245, 245);
@@ -103,7 +109,9 @@ namespace OpenMS
     type_(type),
     param_(),
     tool_ready_(true),
-    breakpoint_set_(false)
+    breakpoint_set_(false),
+    memory_reservation_(0),
+    peak_memory_(0)
   {
     pen_color_ = Qt::black;
     brush_color_ = QColor(245, 245, 245);
@@ -121,7 +129,9 @@ namespace OpenMS
     param_(rhs.param_),
     status_(rhs.status_),
     tool_ready_(rhs.tool_ready_),
-    breakpoint_set_(false)
+    breakpoint_set_(false),
+    memory_reservation_(rhs.memory_reservation_),
+    peak_memory_(rhs.peak_memory_)
   {
     pen_color_ = Qt::black;
     brush_color_ = QColor(245, 245, 245);
@@ -145,6 +155,8 @@ namespace OpenMS
     finished_ = rhs.finished_;
     status_ = rhs.status_;
     breakpoint_set_ = false;
+    memory_reservation_ = rhs.memory_reservation_;
+    peak_memory_ = rhs.peak_memory_;
 
     return *this;
   }
@@ -578,6 +590,7 @@ namespace OpenMS
     /// update round status
     round_total_ = (int) pkg.size(); // take number of rounds from previous tool(s) - should all be equal
     round_counter_ = 0; // once round_counter_ reaches round_total_, we are done
+    finished_stamps_.assign(round_total_, std::make_pair(QString(), QByteArray()));
 
     QStringList shared_args;
     if (type_ != "")
@@ -701,9 +714,20 @@ namespace OpenMS
       writeParam_(param_tmp, ini_file_iteration);
       args << "-ini" << ini_file_iteration;
 
+      // a stamp of the arguments and parameters is written after a successful run, to allow resuming
+      QString stamp_file = ini_file + "_round" + QString::number(round) + ".done";
+      QByteArray stamp_content;
+      QFile ini(ini_file_iteration);
+      if (ini.open(QIODevice::ReadOnly))
+      {
+        stamp_content = ini.readAll();
+      }
+      stamp_content += args.join("\n").toUtf8();
+      bool up_to_date = !ts->isDryRun() && ts->isResumeEnabled() && isRoundUpToDate_(round, pkg, stamp_file, stamp_content);
+
       // create process
       QProcess* p;
-      if (!ts->isDryRun())
+      if (!ts->isDryRun() && !up_to_date)
       {
         p = new QProcess();
       }
@@ -711,6 +735,13 @@ namespace OpenMS
       {
         p = new FakeProcess();
       }
+      p->setProperty("stamp_file", stamp_file);
+      p->setProperty("stamp_content", stamp_content);
+      p->setProperty("round", round);
+      if (up_to_date)
+      {
+        ts->logTOPPOutput(String("\nSkipping round " + String(round + 1) + " of " + name_ + " (output is up-to-date)\n").toQString());
+      }
 
       p->setProcessChannelMode(QProcess::MergedChannels);
       connect(p, SIGNAL(readyReadStandardOutput()), this, SLOT(forwardTOPPOutput()));
@@ -731,7 +762,14 @@ namespace OpenMS
         }
       }
       toolScheduledSlot();
-      ts->enqueueProcess(TOPPASScene::TOPPProcess(p, File::findExecutable(name_).toQString(), args, this));
+      if (qobject_cast<FakeProcess*>(p))
+      {
+        ts->enqueueProcess(TOPPASScene::TOPPProcess(p, File::findExecutable(name_).toQString(), args, this));
+      }
+      else
+      {
+        ts->enqueueProcess(TOPPASScene::TOPPProcess(p, File::findExecutable(name_).toQString(), args, this, getRequiredThreads(), getRequiredMemory()));
+      }
     }
 
     // run pending processes
@@ -763,6 +801,17 @@ namespace OpenMS
     else
     {
       //** no error ... proceed
+      QProcess* finished_process = qobject_cast<QProcess*>(QObject::sender());
+      if (finished_process && !ts->isDryRun())
+      {
+        Size round = finished_process->property("round").toUInt();
+        if (round < finished_stamps_.size())
+        {
+          finished_stamps_[round] = std::make_pair(finished_process->property("stamp_file").toString(),
+                                                   finished_process->property("stamp_content").toByteArray());
+        }
+      }
+
       ++round_counter_;
       //std::cout << (String("Increased iteration_nr_ to ") + round_counter_ + " / " + round_total_ ) << " for " << this->name_ << std::endl;
 
@@ -778,6 +827,25 @@ namespace OpenMS
         if (!ts->isDryRun())
         {
           renameOutput_(); // rename generated files by content
+          // the stamps list the renamed outputs, which are checked when resuming (see isRoundUpToDate_())
+          for (Size r = 0; r < finished_stamps_.size(); ++r)
+          {
+            QFile stamp(finished_stamps_[r].first);
+            if (finished_stamps_[r].first.isEmpty() || !stamp.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            {
+              continue;
+            }
+            QByteArray stamp_content = finished_stamps_[r].second + STAMP_OUTPUTS_HEADER;
+            for (RoundPackageConstIt it = output_files_[r].begin(); it != output_files_[r].end(); ++it)
+            {
+              foreach(const QString& file, it->second.filenames.get())
+              {
+                stamp_content += file.toUtf8() + "\n";
+              }
+            }
+            stamp.write(stamp_content);
+          }
+          finished_stamps_.clear();
           emit toolFinished();
         }
         finished_ = true;
@@ -798,13 +866,12 @@ namespace OpenMS
 
     //clean up
     QProcess* p = qobject_cast<QProcess*>(QObject::sender());
+    ts->processFinished(p);
     if (p)
     {
       delete p;
     }
 
-    ts->processFinished();
-
     __DEBUG_END_METHOD__
   }
 
@@ -1326,4 +1393,93 @@ namespace OpenMS
     breakpoint_set_ = !breakpoint_set_;
   }
 
+  void TOPPASToolVertex::setMemoryReservation(UInt memory_mb)
+  {
+    memory_reservation_ = memory_mb;
+  }
+
+  UInt TOPPASToolVertex::getMemoryReservation() const
+  {
+    return memory_reservation_;
+  }
+
+  void TOPPASToolVertex::recordPeakMemory(UInt memory_mb)
+  {
+    peak_memory_ = std::max(peak_memory_, memory_mb);
+  }
+
+  UInt TOPPASToolVertex::getRecordedPeakMemory() const
+  {
+    return peak_memory_;
+  }
+
+  UInt TOPPASToolVertex::getRequiredMemory() const
+  {
+    return memory_reservation_ > 0 ? memory_reservation_ : peak_memory_;
+  }
+
+  int TOPPASToolVertex::getRequiredThreads() const
+  {
+    if (!param_.exists("threads"))
+    {
+      return 1;
+    }
+    return std::max(1, int(param_.getValue("threads")));
+  }
+
+  bool TOPPASToolVertex::isRoundUpToDate_(int round, const RoundPackages& pkg, const QString& stamp_file, const QByteArray& stamp_content)
+  {
+    QFile stamp(stamp_file);
+    if (!stamp.open(QIODevice::ReadOnly))
+    {
+      return false; // never run successfully
+    }
+    const QByteArray stamp_prefix = stamp_content + STAMP_OUTPUTS_HEADER;
+    const QByteArray stamp_stored = stamp.readAll();
+    if (!stamp_stored.startsWith(stamp_prefix))
+    {
+      return false; // different arguments/parameters
+    }
+    // the outputs were renamed by content after the run (e.g. '.unknown' suffixes, see renameOutput_())
+    const QStringList outputs = QString::fromUtf8(stamp_stored.mid(stamp_prefix.size())).split("\n", QString::SkipEmptyParts);
+    int output_count = 0;
+    for (RoundPackage::const_iterator it = output_files_[round].begin(); it != output_files_[round].end(); ++it)
+    {
+      output_count += it->second.filenames.size();
+    }
+    if (outputs.size() != output_count)
+    {
+      return false;
+    }
+
+    // the oldest output has to be at least as new as the newest input
+    QDateTime newest_input;
+    for (RoundPackageConstIt it = pkg[round].begin(); it != pkg[round].end(); ++it)
+    {
+      foreach(const QString& file, it->second.filenames.get())
+      {
+        QFileInfo fi(file);
+        if (!fi.exists()) return false;
+        if (!newest_input.isValid() || fi.lastModified() > newest_input) newest_input = fi.lastModified();
+      }
+    }
+    foreach(const QString& file, outputs)
+    {
+      QFileInfo fi(file);
+      if (!fi.exists()) return false;
+      if (newest_input.isValid() && fi.lastModified() < newest_input) return false;
+    }
+
+    // downstream tools use the existing outputs
+    int output_index = 0;
+    for (RoundPackageIt it = output_files_[round].begin(); it != output_files_[round].end(); ++it)
+    {
+      for (int fi = 0; fi < it->second.filenames.size(); ++fi)
+      {
+        it->second.filenames.set(outputs[output_index++], fi);
+      }
+    }
+    return true;
+  }
+
 }
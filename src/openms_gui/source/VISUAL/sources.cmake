@@ -21,6 +21,8 @@ MultiGradientSelector.cpp
 ParamEditor.cpp
 ParamEditor.ui
 
+PeakMapTileCache.cpp
+
 SpectraIdentificationViewWidget.cpp
 SpectraViewWidget.cpp
 Spectrum1DCanvas.cpp
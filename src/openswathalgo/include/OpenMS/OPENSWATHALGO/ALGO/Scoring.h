@@ -123,6 +123,17 @@ public:
     OPENSWATHALGO_DLLAPI XCorrArrayType calculateCrossCorrelation(const std::vector<double>& data1,
                                                                   const std::vector<double>& data2, const int& maxdelay, const int& lag);
 
+    /** @brief Calculate crosscorrelation on arrays of length @p datasize without normalization, for all delays from -maxdelay to maxdelay (lag 1)
+
+      The correlation for delay @p d is stored in @p result[maxdelay + d], so
+      @p result must hold 2 * maxdelay + 1 values. All delays are computed in
+      a single pass over the data, with the inner loop running over the
+      delays (which the compiler can vectorize); the summation order per delay
+      is the same as in calculateCrossCorrelation(), so are the results.
+    */
+    OPENSWATHALGO_DLLAPI void calculateCrossCorrelation(const double* data1, const double* data2, int datasize,
+                                                        int maxdelay, double* result);
+
     /// Find best peak in an cross-correlation (highest apex)
     OPENSWATHALGO_DLLAPI XCorrArrayType::const_iterator xcorrArrayGetMaxPeak(const XCorrArrayType & array);
 
@@ -138,6 +149,16 @@ public:
     // Estimate rank-transformed mutual information between two vectors of data points
     OPENSWATHALGO_DLLAPI double rankedMutualInformation(std::vector<double>& data1, std::vector<double>& data2);
 
+    /** @brief Estimate mutual information between two vectors of ranks (see computeRank)
+
+      Gives the same result as rankedMutualInformation() on the original data,
+      but the ranks of each data vector only need to be computed once when
+      comparing many pairs. Only the joint states that actually occur are
+      counted (at most one per data point), instead of the full table of all
+      rank combinations.
+    */
+    OPENSWATHALGO_DLLAPI double rankedMutualInformation(const std::vector<unsigned int>& ranks1, const std::vector<unsigned int>& ranks2);
+
     //@}
 
   }
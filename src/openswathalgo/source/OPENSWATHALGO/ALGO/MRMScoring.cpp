@@ -44,6 +44,104 @@
 namespace OpenSwath
 {
 
+  namespace
+  {
+    typedef MRMScoring::FeatureType FeatureType;
+
+    /// Fetch the intensities of the transition features with the given ids
+    void getIntensities_(OpenSwath::IMRMFeature* mrmfeature, const std::vector<std::string>& native_ids,
+                         std::vector<std::vector<double> >& intensities)
+    {
+      for (std::size_t i = 0; i < native_ids.size(); i++)
+      {
+        intensities.push_back(std::vector<double>());
+        mrmfeature->getFeature(native_ids[i])->getIntensity(intensities.back());
+      }
+    }
+
+    /// Fetch the intensities of the precursor features with the given ids
+    void getPrecursorIntensities_(OpenSwath::IMRMFeature* mrmfeature, const std::vector<std::string>& precursor_ids,
+                                  std::vector<std::vector<double> >& intensities)
+    {
+      for (std::size_t i = 0; i < precursor_ids.size(); i++)
+      {
+        intensities.push_back(std::vector<double>());
+        mrmfeature->getPrecursorFeature(precursor_ids[i])->getIntensity(intensities.back());
+      }
+    }
+
+    /**
+      @brief Compute the normalized cross-correlation of every pair of traces from @p set1 and @p set2
+
+      Each trace is standardized only once. If @p upper_triangle is set (@p
+      set1 and @p set2 are the same), only the pairs (i, j) with j >= i are
+      computed, as the other half of the matrix is symmetric.
+    */
+    void computeXCorrMatrix_(std::vector<std::vector<double> > set1, std::vector<std::vector<double> > set2,
+                             bool upper_triangle, MRMScoring::XCorrMatrixType& xcorr_matrix)
+    {
+      for (std::size_t i = 0; i < set1.size(); i++)
+      {
+        Scoring::standardize_data(set1[i]);
+      }
+      for (std::size_t j = 0; j < set2.size(); j++)
+      {
+        Scoring::standardize_data(set2[j]);
+      }
+
+      xcorr_matrix.assign(set1.size(), std::vector<MRMScoring::XCorrArrayType>(set2.size()));
+      std::vector<double> sxy; // all delays of one pair
+      for (std::size_t i = 0; i < set1.size(); i++)
+      {
+        const int datasize = boost::numeric_cast<int>(set1[i].size());
+        const int maxdelay = datasize;
+        sxy.resize(2 * maxdelay + 1);
+        for (std::size_t j = (upper_triangle ? i : 0); j < set2.size(); j++)
+        {
+          OPENSWATH_PRECONDITION(set2[j].size() == set1[i].size(), "Both data vectors need to have the same length");
+
+          Scoring::calculateCrossCorrelation(set1[i].data(), set2[j].data(), datasize, maxdelay, sxy.data());
+          std::vector<Scoring::XCorrEntry>& result = xcorr_matrix[i][j].data;
+          result.reserve(sxy.size());
+          for (int delay = -maxdelay; delay <= maxdelay; ++delay)
+          {
+            result.push_back(std::make_pair(delay, sxy[maxdelay + delay] / datasize));
+          }
+        }
+      }
+    }
+
+    /**
+      @brief Compute the ranked mutual information of every pair of traces from @p set1 and @p set2
+
+      Each trace is ranked only once. If @p upper_triangle is set (@p set1
+      and @p set2 are the same), only the pairs (i, j) with j >= i are
+      computed.
+    */
+    void computeMIMatrix_(const std::vector<std::vector<double> >& set1, const std::vector<std::vector<double> >& set2,
+                          bool upper_triangle, std::vector<std::vector<double> >& mi_matrix)
+    {
+      std::vector<std::vector<unsigned int> > ranks1, ranks2;
+      for (std::size_t i = 0; i < set1.size(); i++)
+      {
+        ranks1.push_back(Scoring::computeRank(set1[i]));
+      }
+      for (std::size_t j = 0; j < set2.size(); j++)
+      {
+        ranks2.push_back(Scoring::computeRank(set2[j]));
+      }
+
+      mi_matrix.assign(set1.size(), std::vector<double>(set2.size()));
+      for (std::size_t i = 0; i < set1.size(); i++)
+      {
+        for (std::size_t j = (upper_triangle ? i : 0); j < set2.size(); j++)
+        {
+          mi_matrix[i][j] = Scoring::rankedMutualInformation(ranks1[i], ranks2[j]);
+        }
+      }
+    }
+  }
+
   const MRMScoring::XCorrMatrixType& MRMScoring::getXCorrMatrix() const
   {
     return xcorr_matrix_;
@@ -66,130 +164,40 @@ namespace OpenSwath
 
   void MRMScoring::initializeXCorrMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    xcorr_matrix_.resize(native_ids.size());
-    for (std::size_t i = 0; i < native_ids.size(); i++)
-    {
-      String native_id = native_ids[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
-      xcorr_matrix_[i].resize(native_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = i; j < native_ids.size(); j++)
-      {
-        String native_id2 = native_ids[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
-      }
-    }
+    std::vector<std::vector<double> > intensities;
+    getIntensities_(mrmfeature, native_ids, intensities);
+    computeXCorrMatrix_(intensities, intensities, true, xcorr_matrix_);
   }
 
   void MRMScoring::initializeXCorrContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& native_ids_set1, const std::vector<String>& native_ids_set2)
   {
-    std::vector<double> intensityi, intensityj;
-    xcorr_contrast_matrix_.resize(native_ids_set1.size());
-    for (std::size_t i = 0; i < native_ids_set1.size(); i++)
-    { 
-      String native_id = native_ids_set1[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
-      xcorr_contrast_matrix_[i].resize(native_ids_set2.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < native_ids_set2.size(); j++)
-      {
-        String native_id2 = native_ids_set2[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_contrast_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
-      }
-    }
+    std::vector<std::vector<double> > intensities1, intensities2;
+    getIntensities_(mrmfeature, native_ids_set1, intensities1);
+    getIntensities_(mrmfeature, native_ids_set2, intensities2);
+    computeXCorrMatrix_(intensities1, intensities2, false, xcorr_contrast_matrix_);
   }
 
   void MRMScoring::initializeXCorrPrecursorMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    xcorr_precursor_matrix_.resize(precursor_ids.size());
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    {
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      xcorr_precursor_matrix_[i].resize(precursor_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = i; j < precursor_ids.size(); j++)
-      {
-        String precursor_id2 = precursor_ids[j];
-        FeatureType fj = mrmfeature->getPrecursorFeature(precursor_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_precursor_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
-      }
-    }
+    std::vector<std::vector<double> > intensities;
+    getPrecursorIntensities_(mrmfeature, precursor_ids, intensities);
+    computeXCorrMatrix_(intensities, intensities, true, xcorr_precursor_matrix_);
   }
 
   void MRMScoring::initializeXCorrPrecursorContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    xcorr_precursor_contrast_matrix_.resize(precursor_ids.size());
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    { 
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      xcorr_precursor_contrast_matrix_[i].resize(native_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < native_ids.size(); j++)
-      {
-        String native_id = native_ids[j];
-        FeatureType fj = mrmfeature->getFeature(native_id);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_precursor_contrast_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
-      }
-    }
+    std::vector<std::vector<double> > intensities1, intensities2;
+    getPrecursorIntensities_(mrmfeature, precursor_ids, intensities1);
+    getIntensities_(mrmfeature, native_ids, intensities2);
+    computeXCorrMatrix_(intensities1, intensities2, false, xcorr_precursor_contrast_matrix_);
   }
 
   void MRMScoring::initializeXCorrPrecursorCombinedMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    std::vector<FeatureType> features;
-
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    { 
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      features.push_back(fi);
-    }
-    for (std::size_t j = 0; j < native_ids.size(); j++)
-    {
-      String native_id = native_ids[j];
-      FeatureType fj = mrmfeature->getFeature(native_id);
-      features.push_back(fj);
-    }
-
-    xcorr_precursor_combined_matrix_.resize(features.size());
-    for (std::size_t i = 0; i < features.size(); i++)
-    { 
-      FeatureType fi = features[i];
-      xcorr_precursor_combined_matrix_[i].resize(features.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < features.size(); j++)
-      {
-        FeatureType fj = features[j];
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_precursor_combined_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
-      }
-    }
+    std::vector<std::vector<double> > intensities;
+    getPrecursorIntensities_(mrmfeature, precursor_ids, intensities);
+    getIntensities_(mrmfeature, native_ids, intensities);
+    computeXCorrMatrix_(intensities, intensities, false, xcorr_precursor_combined_matrix_);
   }
 
   // see /IMSB/users/reiterl/bin/code/biognosys/trunk/libs/mrm_libs/MRM_pgroup.pm
@@ -675,130 +683,40 @@ namespace OpenSwath
 
   void MRMScoring::initializeMIMatrix(OpenSwath::IMRMFeature* mrmfeature, std::vector<String> native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    mi_matrix_.resize(native_ids.size());
-    for (std::size_t i = 0; i < native_ids.size(); i++)
-    {
-      String native_id = native_ids[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
-      mi_matrix_[i].resize(native_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = i; j < native_ids.size(); j++)
-      {
-        String native_id2 = native_ids[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute ranked mutual information
-        mi_matrix_[i][j] = Scoring::rankedMutualInformation(intensityi, intensityj);
-      }
-    }
+    std::vector<std::vector<double> > intensities;
+    getIntensities_(mrmfeature, native_ids, intensities);
+    computeMIMatrix_(intensities, intensities, true, mi_matrix_);
   }
 
   void MRMScoring::initializeMIContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, std::vector<String> native_ids_set1, std::vector<String> native_ids_set2)
-  { 
-    std::vector<double> intensityi, intensityj;
-    mi_contrast_matrix_.resize(native_ids_set1.size());
-    for (std::size_t i = 0; i < native_ids_set1.size(); i++)
-    { 
-      String native_id = native_ids_set1[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
-      mi_contrast_matrix_[i].resize(native_ids_set2.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < native_ids_set2.size(); j++)
-      {
-        String native_id2 = native_ids_set2[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute ranked mutual information
-        mi_contrast_matrix_[i][j] = Scoring::rankedMutualInformation(intensityi, intensityj);
-      }
-    }
+  {
+    std::vector<std::vector<double> > intensities1, intensities2;
+    getIntensities_(mrmfeature, native_ids_set1, intensities1);
+    getIntensities_(mrmfeature, native_ids_set2, intensities2);
+    computeMIMatrix_(intensities1, intensities2, false, mi_contrast_matrix_);
   }
 
   void MRMScoring::initializeMIPrecursorMatrix(OpenSwath::IMRMFeature* mrmfeature, std::vector<String> precursor_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    mi_precursor_matrix_.resize(precursor_ids.size());
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    {
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      mi_precursor_matrix_[i].resize(precursor_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = i; j < precursor_ids.size(); j++)
-      {
-        String precursor_id2 = precursor_ids[j];
-        FeatureType fj = mrmfeature->getPrecursorFeature(precursor_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute ranked mutual information
-        mi_precursor_matrix_[i][j] = Scoring::rankedMutualInformation(intensityi, intensityj);
-      }
-    }
+    std::vector<std::vector<double> > intensities;
+    getPrecursorIntensities_(mrmfeature, precursor_ids, intensities);
+    computeMIMatrix_(intensities, intensities, true, mi_precursor_matrix_);
   }
 
   void MRMScoring::initializeMIPrecursorContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    mi_precursor_contrast_matrix_.resize(precursor_ids.size());
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    { 
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      mi_precursor_contrast_matrix_[i].resize(native_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < native_ids.size(); j++)
-      {
-        String native_id = native_ids[j];
-        FeatureType fj = mrmfeature->getFeature(native_id);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute ranked mutual information
-        mi_precursor_contrast_matrix_[i][j] = Scoring::rankedMutualInformation(intensityi, intensityj);
-      }
-    }
+    std::vector<std::vector<double> > intensities1, intensities2;
+    getPrecursorIntensities_(mrmfeature, precursor_ids, intensities1);
+    getIntensities_(mrmfeature, native_ids, intensities2);
+    computeMIMatrix_(intensities1, intensities2, false, mi_precursor_contrast_matrix_);
   }
 
   void MRMScoring::initializeMIPrecursorCombinedMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    std::vector<FeatureType> features;
-
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    { 
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      features.push_back(fi);
-    }
-    for (std::size_t j = 0; j < native_ids.size(); j++)
-    {
-      String native_id = native_ids[j];
-      FeatureType fj = mrmfeature->getFeature(native_id);
-      features.push_back(fj);
-    }
-
-    mi_precursor_combined_matrix_.resize(features.size());
-    for (std::size_t i = 0; i < features.size(); i++)
-    { 
-      FeatureType fi = features[i];
-      mi_precursor_combined_matrix_[i].resize(features.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < features.size(); j++)
-      {
-        FeatureType fj = features[j];
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute ranked mutual information
-        mi_precursor_combined_matrix_[i][j] = Scoring::rankedMutualInformation(intensityi, intensityj);
-      }
-    }
+    std::vector<std::vector<double> > intensities;
+    getPrecursorIntensities_(mrmfeature, precursor_ids, intensities);
+    getIntensities_(mrmfeature, native_ids, intensities);
+    computeMIMatrix_(intensities, intensities, false, mi_precursor_combined_matrix_);
   }
 
   double MRMScoring::calcMIScore()
@@ -34,6 +34,7 @@
 
 #include <OpenMS/OPENSWATHALGO/ALGO/Scoring.h>
 #include <OpenMS/OPENSWATHALGO/Macros.h>
+#include <algorithm>
 #include <cmath>
 
 #include <boost/numeric/conversion/cast.hpp>
@@ -173,6 +174,17 @@ namespace OpenSwath
       int datasize = boost::numeric_cast<int>(data1.size());
       int i, j, delay;
 
+      if (lag == 1) // all delays at once
+      {
+        std::vector<double> sxy(2 * maxdelay + 1);
+        calculateCrossCorrelation(data1.data(), data2.data(), datasize, maxdelay, sxy.data());
+        for (delay = -maxdelay; delay <= maxdelay; ++delay)
+        {
+          result.data.push_back(std::make_pair(delay, sxy[maxdelay + delay]));
+        }
+        return result;
+      }
+
       for (delay = -maxdelay; delay <= maxdelay; delay = delay + lag)
       {
         double sxy = 0;
@@ -190,6 +202,25 @@ namespace OpenSwath
       return result;
     }
 
+    void calculateCrossCorrelation(const double* data1, const double* data2, int datasize,
+                                   int maxdelay, double* result)
+    {
+      std::fill(result, result + 2 * maxdelay + 1, 0.0);
+      double* result_center = result + maxdelay; // delay 0
+      for (int i = 0; i < datasize; ++i)
+      {
+        // delays for which "i + delay" lies within the data:
+        const int first_delay = std::max(-maxdelay, -i);
+        const int last_delay = std::min(maxdelay, datasize - 1 - i);
+        const double x = data1[i];
+        const double* y = data2 + i;
+        for (int delay = first_delay; delay <= last_delay; ++delay)
+        {
+          result_center[delay] += x * y[delay];
+        }
+      }
+    }
+
     XCorrArrayType calcxcorr_legacy_mquest_(std::vector<double>& data1,
                                             std::vector<double>& data2, bool normalize)
     {
@@ -295,5 +326,38 @@ namespace OpenSwath
       return result;
     }
 
+    double rankedMutualInformation(const std::vector<unsigned int>& ranks1, const std::vector<unsigned int>& ranks2)
+    {
+      OPENSWATH_PRECONDITION(ranks1.size() != 0 && ranks1.size() == ranks2.size(), "Both data vectors need to have the same length");
+
+      const double length = ranks1.size();
+      const unsigned int n_states1 = *std::max_element(ranks1.begin(), ranks1.end()) + 1;
+      const unsigned int n_states2 = *std::max_element(ranks2.begin(), ranks2.end()) + 1;
+      std::vector<unsigned int> counts1(n_states1), counts2(n_states2);
+      std::vector<unsigned long> joint_states(ranks1.size());
+      for (std::size_t i = 0; i < ranks1.size(); ++i)
+      {
+        ++counts1[ranks1[i]];
+        ++counts2[ranks2[i]];
+        joint_states[i] = (unsigned long)ranks2[i] * n_states1 + ranks1[i];
+      }
+      // sum up in order of the joint states (as in MIToolbox), so the result is identical:
+      std::sort(joint_states.begin(), joint_states.end());
+
+      // I(X;Y) = \sum_x \sum_y p(x,y) * \log (p(x,y)/p(x)p(y))
+      double result = 0.0;
+      for (std::size_t i = 0; i < joint_states.size(); )
+      {
+        std::size_t next = i + 1;
+        while ((next < joint_states.size()) && (joint_states[next] == joint_states[i])) ++next;
+        const double p_joint = (next - i) / length;
+        const double p1 = counts1[joint_states[i] % n_states1] / length;
+        const double p2 = counts2[joint_states[i] / n_states1] / length;
+        result += p_joint * log(p_joint / p1 / p2);
+        i = next;
+      }
+      return result / log(LOG_BASE);
+    }
+
   } //end namespace Scoring
 }
@@ -1,3 +1,6 @@
+cimport numpy as np
+import numpy as np
+from libc.float cimport DBL_MAX
 
 
 
@@ -33,3 +36,42 @@
         cdef MSSpectrum py_result = MSSpectrum.__new__(MSSpectrum)
         py_result.inst = shared_ptr[_MSSpectrum](_r)
         return py_result
+
+    def get_peak_arrays(self, ms_level = -1, min_rt = None, max_rt = None, min_mz = None, max_mz = None):
+        """Cython signature: numpy_vector, numpy_vector, numpy_vector, numpy_vector, numpy_vector get_peak_arrays(int ms_level, double min_rt, double max_rt, double min_mz, double max_mz)
+
+        Returns all peaks of the experiment as a tuple of five numpy arrays
+        (RT, m/z, intensity, ion mobility, spectrum index), optionally
+        restricted to an MS level (all if negative) and to an RT and m/z range
+        (the upper bounds are exclusive). The arrays are filled in C++ without
+        creating peak objects.
+
+        The ion mobility of a peak is taken from the ion mobility float data
+        array of its spectrum or, if there is none, is the drift time of the
+        spectrum. Spectra need to be sorted by RT (and m/z) if a range is given.
+        """
+
+        cdef _MSExperiment * exp_ = self.inst.get()
+        cdef int level = ms_level
+        cdef double rt_lo = -DBL_MAX if min_rt is None else min_rt
+        cdef double rt_hi = DBL_MAX if max_rt is None else max_rt
+        cdef double mz_lo = -DBL_MAX if min_mz is None else min_mz
+        cdef double mz_hi = DBL_MAX if max_mz is None else max_mz
+
+        cdef size_t n
+        with nogil:
+            n = exp_.countPeaks(level, rt_lo, rt_hi, mz_lo, mz_hi)
+
+        cdef np.ndarray rts = np.zeros( (n,), dtype=np.float64)
+        cdef np.ndarray mzs = np.zeros( (n,), dtype=np.float64)
+        cdef np.ndarray intensities = np.zeros( (n,), dtype=np.float32)
+        cdef np.ndarray ion_mobilities = np.zeros( (n,), dtype=np.float64)
+        cdef np.ndarray spectrum_indices = np.zeros( (n,), dtype=np.uintp)
+
+        if n > 0:
+            with nogil:
+                exp_.exportPeaks(<double *> rts.data, <double *> mzs.data, <float *> intensities.data,
+                                 <double *> ion_mobilities.data, <size_t *> spectrum_indices.data,
+                                 level, rt_lo, rt_hi, mz_lo, mz_hi)
+
+        return rts, mzs, intensities, ion_mobilities, spectrum_indices
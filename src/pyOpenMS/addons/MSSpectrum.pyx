@@ -1,5 +1,6 @@
 cimport numpy as np
 import numpy as np
+from libc.float cimport DBL_MAX
 
 
 
@@ -18,19 +19,13 @@ import numpy as np
         cdef _MSSpectrum * spec_ = self.inst.get()
 
         cdef unsigned int n = spec_.size()
-        cdef np.ndarray[np.float64_t, ndim=1] mzs
-        mzs = np.zeros( (n,), dtype=np.float64)
-        cdef np.ndarray[np.float32_t, ndim=1] intensities
-        intensities = np.zeros( (n,), dtype=np.float32)
-        cdef _Peak1D p
-
-        cdef libcpp_vector[_Peak1D].iterator it = spec_.begin()
-        cdef int i = 0
-        while it != spec_.end():
-            mzs[i] = deref(it).getMZ()
-            intensities[i] = deref(it).getIntensity()
-            inc(it)
-            i += 1
+        cdef np.ndarray mzs = np.zeros( (n,), dtype=np.float64)
+        cdef np.ndarray intensities = np.zeros( (n,), dtype=np.float32)
+
+        # fill the arrays directly in C++
+        if n > 0:
+            with nogil:
+                spec_.exportPeaks(<double *> mzs.data, <float *> intensities.data, NULL, -DBL_MAX, DBL_MAX)
 
         return mzs, intensities
 
@@ -18,7 +18,7 @@ cdef extern from "<OpenMS/ANALYSIS/ID/AccurateMassSearchEngine.h>" namespace "Op
 
         double getNeutralMass(double observed_mz) nogil except +
         double getMZ(double neutral_mass) nogil except +
-        bool isCompatible(EmpiricalFormula db_entry) nogil except +
+        bool isCompatible(EmpiricalFormula & db_entry) nogil except +
         int getCharge() nogil except +
         String getName() nogil except +
 
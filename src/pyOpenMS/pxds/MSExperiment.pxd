@@ -89,6 +89,11 @@ cdef extern from "<OpenMS/KERNEL/MSExperiment.h>" namespace "OpenMS":
         Size getNrChromatograms() nogil except +
         libcpp_vector[unsigned int] getMSLevels() nogil except +  # wrap-ignore
 
+        # COMMENT: Bulk peak export, see get_peak_arrays() in ../addons/MSExperiment.pyx
+        Size countPeaks(int ms_level, double min_rt, double max_rt, double min_mz, double max_mz) nogil except + # wrap-doc:Number of peaks of MS level ms_level (all if negative) in [min_rt, max_rt) x [min_mz, max_mz)
+        Size exportPeaks(double * rt, double * mz, float * intensity, double * ion_mobility, Size * spectrum_index,
+                         int ms_level, double min_rt, double max_rt, double min_mz, double max_mz) nogil except + # wrap-ignore
+
         void sortSpectra(bool sort_mz) nogil except +
         void sortSpectra() nogil except +
         void sortChromatograms(bool sort_rt) nogil except +
@@ -57,6 +57,9 @@ cdef extern from "<OpenMS/KERNEL/MSSpectrum.h>" namespace "OpenMS":
 
         MSSpectrum select(libcpp_vector[ size_t ] & indices) nogil except +
 
+        int getIonMobilityArrayIndex() nogil except + # wrap-doc:Index of the float data array holding the ion mobility of each peak (-1 if there is none)
+        Size exportPeaks(double * mz, float * intensity, double * ion_mobility, double min_mz, double max_mz) nogil except + # wrap-ignore
+
         void assign(libcpp_vector[Peak1D].iterator, libcpp_vector[Peak1D].iterator) nogil except + # wrap-ignore
         libcpp_vector[Peak1D].iterator begin() nogil except +  # wrap-iter-begin:__iter__(Peak1D)
         libcpp_vector[Peak1D].iterator end()   nogil except +  # wrap-iter-end:__iter__(Peak1D)
@@ -38,6 +38,22 @@ cdef extern from "<OpenMS/ANALYSIS/XLMS/OPXLHelper.h>" namespace "OpenMS":
                                                                   double precursor_mass_tolerance,
                                                                   bool precursor_mass_tolerance_unit_ppm)  nogil except +
 
+        libcpp_vector[ XLPrecursor ] enumerateCrossLinksAlphaFirst(libcpp_vector[ AASeqWithMass ]& peptides,
+                                                                   double cross_link_mass,
+                                                                   libcpp_vector[ double ]& alpha_masses,
+                                                                   double alpha_mass_tolerance,
+                                                                   bool alpha_mass_tolerance_unit_ppm,
+                                                                   libcpp_vector[ double ]& spectrum_precursors,
+                                                                   libcpp_vector[ int ]& precursor_correction_positions,
+                                                                   double precursor_mass_tolerance,
+                                                                   bool precursor_mass_tolerance_unit_ppm)  nogil except +
+
+        libcpp_vector[ double ] findSignatureDoubletMasses(MSSpectrum& spectrum,
+                                                           DoubleList stub_masses,
+                                                           Int max_charge,
+                                                           double fragment_mass_tolerance,
+                                                           bool fragment_mass_tolerance_unit_ppm)  nogil except +
+
         libcpp_vector[ AASeqWithMass ] digestDatabase(libcpp_vector[ FASTAEntry ] fasta_db,
                                                       EnzymaticDigestion digestor,
                                                       Size min_peptide_length,
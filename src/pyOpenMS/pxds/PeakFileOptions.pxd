@@ -45,6 +45,11 @@ cdef extern from "<OpenMS/FORMAT/OPTIONS/PeakFileOptions.h>" namespace "OpenMS":
         Size getMaxDataPoolSize() nogil except +
         void setMaxDataPoolSize(Size s) nogil except +
 
+        bool getPipelinedDecoding() nogil except +
+        void setPipelinedDecoding(bool pipelined) nogil except +
+        Size getMaxPipelineBytes() nogil except +
+        void setMaxPipelineBytes(Size bytes) nogil except +
+
         void setSortSpectraByMZ(bool doSort) nogil except +
         bool getSortSpectraByMZ() nogil except +
         void setSortChromatogramsByRT(bool doSort) nogil except +
@@ -26,6 +26,11 @@ cdef extern from "<OpenMS/ANALYSIS/QUANTITATION/PeptideAndProteinQuant.h>" names
                            libcpp_vector[PeptideIdentification] & peptides,
                            ExperimentalDesign & ed) nogil except +
 
+        void startQuantData(ExperimentalDesign & ed) nogil except +
+        void addQuantData(FeatureMap & map_in, Size ms_file_row) nogil except +
+        void addQuantData(ConsensusMap & map_in, Size first_ms_file_row) nogil except +
+        void finishQuantData() nogil except +
+
         void quantifyPeptides(libcpp_vector[PeptideIdentification] & peptides) nogil except +
         void quantifyProteins(ProteinIdentification & proteins) nogil except +
 
@@ -2808,6 +2808,7 @@ def testMSExperiment():
      MSExperiment.removeMetaValue
      MSExperiment.getSize
      MSExperiment.isSorted
+     MSExperiment.get_peak_arrays
     """
     mse = pyopenms.MSExperiment()
     mse_ = copy.copy(mse)
@@ -2835,6 +2836,52 @@ def testMSExperiment():
     mse.setLoadedFilePath("")
     assert mse.size() == 0
 
+    rts, mzs, ints, ims, idx = mse.get_peak_arrays()
+    assert len(rts) == len(mzs) == len(ints) == len(ims) == len(idx) == 0
+
+    # bulk export with real peaks: MS1 spectrum with a drift time, MS2
+    # spectrum with an ion mobility data array
+    exp = pyopenms.MSExperiment()
+    s1 = pyopenms.MSSpectrum()
+    s1.setRT(10.0)
+    s1.setMSLevel(1)
+    s1.setDriftTime(5.0)
+    s1.set_peaks(([100.0, 200.0, 300.0], [1.0, 2.0, 3.0]))
+    exp.addSpectrum(s1)
+    s2 = pyopenms.MSSpectrum()
+    s2.setRT(20.0)
+    s2.setMSLevel(2)
+    s2.set_peaks(([150.0, 250.0], [4.0, 5.0]))
+    im = pyopenms.FloatDataArray()
+    im.setName("Ion Mobility")
+    im.push_back(0.5)
+    im.push_back(0.75)
+    s2.setFloatDataArrays([im])
+    exp.addSpectrum(s2)
+
+    rts, mzs, ints, ims, idx = exp.get_peak_arrays()
+    assert list(rts) == [10.0, 10.0, 10.0, 20.0, 20.0]
+    assert list(mzs) == [100.0, 200.0, 300.0, 150.0, 250.0]
+    assert list(ints) == [1.0, 2.0, 3.0, 4.0, 5.0]
+    assert list(ims) == [5.0, 5.0, 5.0, 0.5, 0.75]
+    assert list(idx) == [0, 0, 0, 1, 1]
+
+    rts, mzs, ints, ims, idx = exp.get_peak_arrays(ms_level = 1, min_mz = 150.0, max_mz = 300.0)
+    assert list(rts) == [10.0]
+    assert list(mzs) == [200.0]
+    assert list(ints) == [2.0]
+    assert list(ims) == [5.0]
+    assert list(idx) == [0]
+
+    rts, mzs, ints, ims, idx = exp.get_peak_arrays(min_rt = 15.0)
+    assert list(mzs) == [150.0, 250.0]
+    assert list(ims) == [0.5, 0.75]
+    assert list(idx) == [1, 1]
+
+    mzs, ints = s2.get_peaks()
+    assert list(mzs) == [150.0, 250.0]
+    assert list(ints) == [4.0, 5.0]
+
     mse.getIdentifier()
     mse.getLoadedFileType()
     mse.getLoadedFilePath()
@@ -0,0 +1,164 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/COMPARISON/SPECTRA/BinnedSpectrumBlock.h>
+#include <OpenMS/COMPARISON/SPECTRA/BinnedSpectralContrastAngle.h>
+#include <OpenMS/COMPARISON/SPECTRA/BinnedSharedPeakCount.h>
+#include <OpenMS/COMPARISON/SPECTRA/BinnedSumAgreeingIntensities.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace OpenMS;
+using namespace std;
+
+/*
+  Compares BinnedSpectrumCompareFunctor scoring of N queries against N library
+  spectra (N * N comparisons, N = 1000 by default):
+
+  - pairwise:      one operator()(spec1, spec2) call per pair
+  - block sparse:  one batched call per query against a BinnedSpectrumBlock
+  - block dense:   as above, with the dense window of the block materialized
+
+  Usage: BinnedSpectrumBlock_benchmark [N]
+*/
+
+namespace
+{
+  vector<BinnedSpectrum> randomSpectra(Size n, mt19937& rng)
+  {
+    uniform_real_distribution<double> mz(100.0, 2000.0);
+    uniform_real_distribution<double> intensity(1.0, 1000.0);
+    uniform_int_distribution<Size> peaks(50, 200);
+
+    vector<BinnedSpectrum> result;
+    result.reserve(n);
+    for (Size i = 0; i < n; ++i)
+    {
+      PeakSpectrum spec;
+      Size n_peaks = peaks(rng);
+      for (Size p = 0; p < n_peaks; ++p)
+      {
+        spec.push_back(Peak1D(mz(rng), intensity(rng)));
+      }
+      spec.sortByPosition();
+      result.push_back(BinnedSpectrum(spec, BinnedSpectrum::DEFAULT_BIN_WIDTH_LOWRES, false, 0, BinnedSpectrum::DEFAULT_BIN_OFFSET_LOWRES));
+    }
+    return result;
+  }
+
+  void run(const String& name, const BinnedSpectrumCompareFunctor& functor,
+           const vector<BinnedSpectrum>& queries, const vector<BinnedSpectrum>& library)
+  {
+    BinnedSpectrumBlock block(library);
+    vector<double> pairwise(queries.size() * library.size());
+    vector<double> batched(pairwise.size());
+    vector<double> scores;
+    StopWatch sw;
+
+    sw.start();
+    for (Size q = 0; q < queries.size(); ++q)
+    {
+      for (Size l = 0; l < library.size(); ++l)
+      {
+        pairwise[q * library.size() + l] = functor(queries[q], library[l]);
+      }
+    }
+    sw.stop();
+    double t_pairwise = sw.getClockTime();
+
+    sw.reset();
+    sw.start();
+    for (Size q = 0; q < queries.size(); ++q)
+    {
+      functor(queries[q], block, scores);
+      copy(scores.begin(), scores.end(), batched.begin() + q * library.size());
+    }
+    sw.stop();
+    double t_sparse = sw.getClockTime();
+
+    double max_diff(0);
+    for (Size i = 0; i < pairwise.size(); ++i)
+    {
+      max_diff = max(max_diff, fabs(pairwise[i] - batched[i]));
+    }
+
+    sw.reset();
+    sw.start();
+    block.createDenseWindow();
+    for (Size q = 0; q < queries.size(); ++q)
+    {
+      functor(queries[q], block, scores);
+      copy(scores.begin(), scores.end(), batched.begin() + q * library.size());
+    }
+    sw.stop();
+    double t_dense = sw.getClockTime();
+
+    for (Size i = 0; i < pairwise.size(); ++i)
+    {
+      max_diff = max(max_diff, fabs(pairwise[i] - batched[i]));
+    }
+
+    cout << name << ": " << pairwise.size() << " comparisons" << "\n"
+         << "  pairwise:     " << t_pairwise << " s" << "\n"
+         << "  block sparse: " << t_sparse << " s (x" << t_pairwise / max(t_sparse, 1e-9) << ")" << "\n"
+         << "  block dense:  " << t_dense << " s (x" << t_pairwise / max(t_dense, 1e-9) << ")" << "\n"
+         << "  max. score difference: " << max_diff << endl;
+  }
+}
+
+int main(int argc, const char** argv)
+{
+  Size n = 1000;
+  if (argc > 1)
+  {
+    n = static_cast<Size>(atoi(argv[1]));
+  }
+
+  mt19937 rng(42);
+  vector<BinnedSpectrum> queries = randomSpectra(n, rng);
+  vector<BinnedSpectrum> library = randomSpectra(n, rng);
+
+  run("BinnedSpectralContrastAngle", BinnedSpectralContrastAngle(), queries, library);
+  run("BinnedSharedPeakCount", BinnedSharedPeakCount(), queries, library);
+  run("BinnedSumAgreeingIntensities", BinnedSumAgreeingIntensities(), queries, library);
+
+  return 0;
+}
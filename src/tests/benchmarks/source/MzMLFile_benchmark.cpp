@@ -0,0 +1,155 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: Hannes Roest $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/MzMLFile.h>
+#include <OpenMS/INTERFACES/IMSDataConsumer.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/SYSTEM/File.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+using namespace OpenMS;
+using namespace std;
+
+/*
+  Reads an mzML file with MzMLFile::transform, once with sequential decoding
+  (parse a data pool, decode it, consume it, continue parsing) and once with
+  pipelined decoding (PeakFileOptions::setPipelinedDecoding), and reports the
+  wall clock times. The consumer computes a per-spectrum sum of intensities
+  (plus some artificial work per peak) which is compared between both runs.
+
+  If no file is given, a synthetic file with N spectra of P peaks each
+  (N = 20000, P = 2000 by default) is written to the temporary directory
+  first.
+
+  Usage: MzMLFile_benchmark [in.mzML | N [P]]
+*/
+
+namespace
+{
+  class ChecksumConsumer :
+    public Interfaces::IMSDataConsumer
+  {
+public:
+    void consumeSpectrum(SpectrumType& s) override
+    {
+      double sum(0);
+      for (const Peak1D& p : s)
+      {
+        sum += p.getIntensity() * std::log1p(p.getMZ());
+      }
+      checksum += sum;
+      ++spectra;
+    }
+    void consumeChromatogram(ChromatogramType& c) override
+    {
+      checksum += c.size();
+      ++chromatograms;
+    }
+    void setExpectedSize(Size, Size) override {}
+    void setExperimentalSettings(const ExperimentalSettings&) override {}
+
+    double checksum = 0;
+    Size spectra = 0;
+    Size chromatograms = 0;
+  };
+
+  String writeSyntheticFile(Size n, Size n_peaks)
+  {
+    mt19937 rng(42);
+    uniform_real_distribution<double> mz(200.0, 2000.0), intensity(0.0, 1e5);
+    PeakMap exp;
+    for (Size i = 0; i < n; ++i)
+    {
+      MSSpectrum s;
+      s.setRT(i * 0.1);
+      s.setMSLevel(1 + i % 2);
+      s.setNativeID("spectrum=" + String(i));
+      s.resize(n_peaks);
+      for (Peak1D& p : s)
+      {
+        p.setMZ(mz(rng));
+        p.setIntensity(intensity(rng));
+      }
+      s.sortByPosition();
+      exp.addSpectrum(s);
+    }
+    String filename = File::getTempDirectory() + "/MzMLFile_benchmark.mzML";
+    MzMLFile().store(filename, exp);
+    return filename;
+  }
+
+  double transform(const String& filename, bool pipelined, ChecksumConsumer& consumer)
+  {
+    MzMLFile f;
+    f.getOptions().setPipelinedDecoding(pipelined);
+    StopWatch sw;
+    sw.start();
+    f.transform(filename, &consumer, true, true);
+    sw.stop();
+    return sw.getClockTime();
+  }
+}
+
+int main(int argc, const char** argv)
+{
+  String filename;
+  if (argc > 1 && File::exists(argv[1]))
+  {
+    filename = argv[1];
+  }
+  else
+  {
+    Size n = 20000, n_peaks = 2000;
+    if (argc > 1) n = static_cast<Size>(atoi(argv[1]));
+    if (argc > 2) n_peaks = static_cast<Size>(atoi(argv[2]));
+    filename = writeSyntheticFile(n, n_peaks);
+  }
+
+  ChecksumConsumer sequential, pipelined;
+  double t_sequential = transform(filename, false, sequential);
+  double t_pipelined = transform(filename, true, pipelined);
+
+  cout << filename << " (" << sequential.spectra << " spectra, " << sequential.chromatograms << " chromatograms)" << "\n"
+       << "  sequential: " << t_sequential << " s" << "\n"
+       << "  pipelined:  " << t_pipelined << " s (x" << t_sequential / max(t_pipelined, 1e-9) << ")" << "\n"
+       << "  identical result: " << (sequential.spectra == pipelined.spectra &&
+                                     sequential.chromatograms == pipelined.chromatograms &&
+                                     sequential.checksum == pipelined.checksum ? "yes" : "no") << endl;
+
+  return 0;
+}
@@ -0,0 +1,228 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/VISUAL/PeakMapTileCache.h>
+#include <OpenMS/VISUAL/MultiGradient.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/FORMAT/FileHandler.h>
+#include <OpenMS/SYSTEM/File.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
+
+#include <QtGui/QImage>
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+using namespace OpenMS;
+using namespace std;
+
+/*
+  Headless 2D rendering benchmark (no display required): paints the maximum
+  intensity per pixel of a peak map into a QImage, once by walking the raw
+  peaks of the visible area (as Spectrum2DCanvas::paintMaximumIntensities_
+  does) and once by sampling the PeakMapTileCache intensity pyramid, for the
+  full map and for views zoomed in by a factor of 4 and 16 (centered).
+  Reports the time to compute the pyramid, the time per rendered image and
+  the number of painted pixels of both methods.
+
+  If no file is given, a synthetic map with N MS1 spectra of P peaks each
+  (N = 20000, P = 5000 by default) is used.
+
+  Usage: Spectrum2DTileCache_benchmark [in.mzML | N [P]]
+*/
+
+namespace
+{
+  const Size WIDTH = 1200; // m/z
+  const Size HEIGHT = 800; // RT
+
+  struct View
+  {
+    double rt_min, rt_max, mz_min, mz_max;
+  };
+
+  PeakMap syntheticMap(Size n, Size n_peaks)
+  {
+    mt19937 rng(42);
+    uniform_real_distribution<double> mz(200.0, 2000.0);
+    exponential_distribution<double> intensity(1e-4);
+    PeakMap exp;
+    for (Size i = 0; i < n; ++i)
+    {
+      MSSpectrum s;
+      s.setRT(i * 0.2);
+      s.setMSLevel(1);
+      s.resize(n_peaks);
+      for (Peak1D& p : s)
+      {
+        p.setMZ(mz(rng));
+        p.setIntensity(intensity(rng));
+      }
+      s.sortByPosition();
+      exp.addSpectrum(s);
+    }
+    exp.updateRanges();
+    return exp;
+  }
+
+  // the raw peak walk of Spectrum2DCanvas::paintMaximumIntensities_ (without data filters)
+  void rawMaxima(const PeakMap& map, const View& v, vector<float>& pixels)
+  {
+    pixels.assign(HEIGHT * WIDTH, -1.0f);
+    double rt_step_size = (v.rt_max - v.rt_min) / HEIGHT;
+    double mz_step_size = (v.mz_max - v.mz_min) / WIDTH;
+    Size scan_index = std::distance(map.begin(), map.RTBegin(v.rt_min));
+    for (Size rt = 0; rt < HEIGHT; ++rt)
+    {
+      double rt_end = v.rt_min + rt_step_size * (rt + 1);
+      vector<Size> scan_indices, peak_indices;
+      for (Size i = scan_index; i < map.size(); ++i)
+      {
+        if (map[i].getRT() >= rt_end)
+        {
+          scan_index = i;
+          break;
+        }
+        if (map[i].getMSLevel() == 1 && map[i].size() > 0)
+        {
+          scan_indices.push_back(i);
+          peak_indices.push_back(map[i].MZBegin(v.mz_min) - map[i].begin());
+        }
+      }
+      for (Size mz = 0; mz < WIDTH; ++mz)
+      {
+        double mz_end = v.mz_min + mz_step_size * (mz + 1);
+        float max = -1.0;
+        for (Size i = 0; i < scan_indices.size(); ++i)
+        {
+          const MSSpectrum& s = map[scan_indices[i]];
+          Size p = peak_indices[i];
+          for (; p < s.size() && s[p].getMZ() < mz_end; ++p)
+          {
+            max = std::max(max, s[p].getIntensity());
+          }
+          peak_indices[i] = p;
+        }
+        pixels[rt * WIDTH + mz] = max;
+      }
+    }
+  }
+
+  Size render(const vector<float>& pixels, const MultiGradient& gradient, QImage& image)
+  {
+    image.fill(Qt::white);
+    Size painted(0);
+    for (Size rt = 0; rt < HEIGHT; ++rt)
+    {
+      for (Size mz = 0; mz < WIDTH; ++mz)
+      {
+        float max = pixels[rt * WIDTH + mz];
+        if (max < 0.0) continue;
+        image.setPixel(int(mz), int(HEIGHT - rt - 1), gradient.precalculatedColorAt(max).rgb());
+        ++painted;
+      }
+    }
+    return painted;
+  }
+}
+
+int main(int argc, const char** argv)
+{
+  PeakMap exp;
+  if (argc > 1 && File::exists(argv[1]))
+  {
+    FileHandler().loadExperiment(argv[1], exp);
+    exp.updateRanges();
+  }
+  else
+  {
+    Size n = 20000, n_peaks = 5000;
+    if (argc > 1) n = static_cast<Size>(atoi(argv[1]));
+    if (argc > 2) n_peaks = static_cast<Size>(atoi(argv[2]));
+    exp = syntheticMap(n, n_peaks);
+  }
+
+  StopWatch sw;
+  sw.start();
+  PeakMapTileCache cache;
+  cache.build(exp);
+  sw.stop();
+  cout << exp.size() << " spectra, " << exp.getSize() << " peaks" << "\n"
+       << "intensity pyramid: " << cache.getLevelCount() << " levels, computed in " << sw.getClockTime() << " s" << "\n";
+  if (!cache.isReady())
+  {
+    cerr << "No MS1 data." << endl;
+    return 1;
+  }
+
+  MultiGradient gradient = MultiGradient::getDefaultGradientLinearIntensityMode();
+  gradient.activatePrecalculationMode(0.0, exp.getMaxInt(), 1000);
+  QImage image(int(WIDTH), int(HEIGHT), QImage::Format_RGB32);
+  vector<float> pixels;
+
+  const double rt_center = (cache.getRTMin() + cache.getRTMax()) / 2, rt_width = cache.getRTMax() - cache.getRTMin();
+  const double mz_center = (cache.getMZMin() + cache.getMZMax()) / 2, mz_width = cache.getMZMax() - cache.getMZMin();
+  for (double zoom : {1.0, 4.0, 16.0})
+  {
+    View v = {rt_center - rt_width / zoom / 2, rt_center + rt_width / zoom / 2,
+              mz_center - mz_width / zoom / 2, mz_center + mz_width / zoom / 2};
+
+    sw.reset();
+    sw.start();
+    rawMaxima(exp, v, pixels);
+    Size painted_raw = render(pixels, gradient, image);
+    sw.stop();
+    double t_raw = sw.getClockTime();
+
+    Int level = cache.selectLevel((v.rt_max - v.rt_min) / HEIGHT, (v.mz_max - v.mz_min) / WIDTH);
+    cout << "zoom x" << zoom << ":\n"
+         << "  raw peaks: " << t_raw << " s (" << painted_raw << " pixels)" << "\n";
+    if (level < 0)
+    {
+      cout << "  pyramid:   not fine enough, raw peaks are painted" << "\n";
+      continue;
+    }
+    sw.reset();
+    sw.start();
+    cache.sampleMaxima(level, v.rt_min, v.rt_max, v.mz_min, v.mz_max, HEIGHT, WIDTH, pixels);
+    Size painted_tiles = render(pixels, gradient, image);
+    sw.stop();
+    double t_tiles = sw.getClockTime();
+    cout << "  pyramid:   " << t_tiles << " s (" << painted_tiles << " pixels, level " << level << ", x"
+         << t_raw / max(t_tiles, 1e-9) << ")" << "\n";
+  }
+  cout << flush;
+
+  return 0;
+}
@@ -0,0 +1,320 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include "BenchmarkSuite.h"
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/CONCEPT/VersionInfo.h>
+#include <OpenMS/DATASTRUCTURES/DateTime.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <regex>
+#include <thread>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace OpenMS;
+using namespace std;
+
+/*
+  Runs all benchmarks registered with OPENMS_BENCHMARK / OPENMS_BENCHMARK_ARGS
+  and reports the time per iteration. The command line (and the JSON output)
+  follow Google Benchmark, so its tools (e.g. compare.py) can be used on the
+  results as well as compare_benchmarks.py in this directory:
+
+  Usage: BenchmarkSuite [--benchmark_filter=<regex>] [--benchmark_min_time=<seconds>]
+                        [--benchmark_repetitions=<n>] [--benchmark_out=<file.json>]
+                        [--benchmark_list_tests]
+*/
+
+namespace OpenMS
+{
+  namespace Benchmark
+  {
+    vector<Registration>& registry()
+    {
+      static vector<Registration> benchmarks;
+      return benchmarks;
+    }
+
+    Registrar::Registrar(const String& name, const Function& function, const vector<Int>& args)
+    {
+      if (args.empty())
+      {
+        registry().push_back(Registration{name, function, -1});
+      }
+      for (Int arg : args)
+      {
+        registry().push_back(Registration{name + "/" + String(arg), function, arg});
+      }
+    }
+  }
+}
+
+namespace
+{
+  struct Result
+  {
+    String name;
+    String run_name;
+    String aggregate; ///< empty for single runs
+    Size repetition;
+    Size iterations;
+    double real_time; ///< per iteration (ms)
+    double cpu_time; ///< per iteration (ms)
+    double items_per_second;
+    double bytes_per_second;
+    String label;
+  };
+
+  Result makeResult(const String& name, const Benchmark::State& state, Size repetition)
+  {
+    Result r;
+    r.name = name;
+    r.run_name = name;
+    r.repetition = repetition;
+    r.iterations = state.iterations();
+    r.real_time = state.getClockTime() * 1e3 / state.iterations();
+    r.cpu_time = state.getCPUTime() * 1e3 / state.iterations();
+    double seconds = max(state.getClockTime(), 1e-12);
+    r.items_per_second = state.getItemsProcessed() / seconds;
+    r.bytes_per_second = state.getBytesProcessed() / seconds;
+    r.label = state.getLabel();
+    return r;
+  }
+
+  /// Runs @p benchmark with an increasing number of iterations until it takes at least @p min_time seconds
+  Benchmark::State runMinTime(const Benchmark::Registration& benchmark, double min_time)
+  {
+    Size iterations = 1;
+    while (true)
+    {
+      Benchmark::State state(iterations, benchmark.arg);
+      benchmark.function(state);
+      if (state.iterationsDone() != iterations)
+      {
+        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Benchmark did not run all iterations (missing 'while (state.keepRunning())'?)", benchmark.name);
+      }
+      double time = state.getClockTime();
+      if (time >= min_time || iterations >= 1000000000)
+      {
+        return state;
+      }
+      // aim for 40% more than needed, but grow by at most 10x per step
+      double factor = time > 0 ? min(10.0, 1.4 * min_time / time) : 10.0;
+      iterations = max(iterations + 1, static_cast<Size>(iterations * factor));
+    }
+  }
+
+  vector<Result> aggregate(const vector<Result>& runs)
+  {
+    vector<double> real, cpu;
+    for (const Result& r : runs)
+    {
+      real.push_back(r.real_time);
+      cpu.push_back(r.cpu_time);
+    }
+    auto mean = [](const vector<double>& v) { double s(0); for (double x : v) s += x; return s / v.size(); };
+    auto median = [](vector<double> v) { sort(v.begin(), v.end()); Size n = v.size(); return n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2.0; };
+    auto stddev = [&mean](const vector<double>& v) { double m = mean(v), s(0); for (double x : v) s += (x - m) * (x - m); return v.size() > 1 ? sqrt(s / (v.size() - 1)) : 0.0; };
+
+    vector<Result> out;
+    for (const String& name : {String("mean"), String("median"), String("stddev")})
+    {
+      Result r = runs.front();
+      r.name = r.run_name + "_" + name;
+      r.aggregate = name;
+      r.items_per_second = 0;
+      r.bytes_per_second = 0;
+      if (name == "mean") { r.real_time = mean(real); r.cpu_time = mean(cpu); }
+      if (name == "median") { r.real_time = median(real); r.cpu_time = median(cpu); }
+      if (name == "stddev") { r.real_time = stddev(real); r.cpu_time = stddev(cpu); }
+      out.push_back(r);
+    }
+    return out;
+  }
+
+  String jsonEscape(const String& s)
+  {
+    String out;
+    for (char c : s)
+    {
+      if (c == '"' || c == '\\') out += '\\';
+      if (c == '\n') { out += "\\n"; continue; }
+      out += c;
+    }
+    return out;
+  }
+
+  void writeJSON(const String& filename, const String& executable, Size repetitions, const vector<Result>& results)
+  {
+    ofstream os(filename.c_str());
+    if (!os)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    os.precision(10);
+    Int threads = 1;
+#ifdef _OPENMP
+    threads = omp_get_max_threads();
+#endif
+    os << "{\n"
+       << "  \"context\": {\n"
+       << "    \"date\": \"" << DateTime::now().get() << "\",\n"
+       << "    \"executable\": \"" << jsonEscape(executable) << "\",\n"
+       << "    \"num_cpus\": " << thread::hardware_concurrency() << ",\n"
+       << "    \"omp_threads\": " << threads << ",\n"
+       << "    \"openms_version\": \"" << VersionInfo::getVersion() << "\",\n"
+       << "    \"openms_revision\": \"" << jsonEscape(VersionInfo::getRevision()) << "\",\n"
+#ifdef NDEBUG
+       << "    \"library_build_type\": \"release\"\n"
+#else
+       << "    \"library_build_type\": \"debug\"\n"
+#endif
+       << "  },\n"
+       << "  \"benchmarks\": [";
+    for (Size i = 0; i < results.size(); ++i)
+    {
+      const Result& r = results[i];
+      os << (i ? "," : "") << "\n    {\n"
+         << "      \"name\": \"" << jsonEscape(r.name) << "\",\n"
+         << "      \"run_name\": \"" << jsonEscape(r.run_name) << "\",\n"
+         << "      \"run_type\": \"" << (r.aggregate.empty() ? "iteration" : "aggregate") << "\",\n";
+      if (!r.aggregate.empty())
+      {
+        os << "      \"aggregate_name\": \"" << r.aggregate << "\",\n";
+      }
+      os << "      \"repetitions\": " << repetitions << ",\n"
+         << "      \"repetition_index\": " << r.repetition << ",\n"
+         << "      \"threads\": 1,\n"
+         << "      \"iterations\": " << r.iterations << ",\n"
+         << "      \"real_time\": " << r.real_time << ",\n"
+         << "      \"cpu_time\": " << r.cpu_time << ",\n"
+         << "      \"time_unit\": \"ms\"";
+      if (r.items_per_second > 0) os << ",\n      \"items_per_second\": " << r.items_per_second;
+      if (r.bytes_per_second > 0) os << ",\n      \"bytes_per_second\": " << r.bytes_per_second;
+      if (!r.label.empty()) os << ",\n      \"label\": \"" << jsonEscape(r.label) << "\"";
+      os << "\n    }";
+    }
+    os << "\n  ]\n}\n";
+  }
+
+  void printResult(const Result& r)
+  {
+    cout << left << setw(50) << r.name << right << fixed << setprecision(r.real_time < 1.0 ? 6 : 3)
+         << setw(14) << r.real_time << setw(14) << r.cpu_time << setw(12) << r.iterations;
+    if (r.items_per_second > 0) cout << "  items/s=" << setprecision(1) << r.items_per_second;
+    if (r.bytes_per_second > 0) cout << "  MB/s=" << setprecision(1) << r.bytes_per_second / (1024 * 1024);
+    if (!r.label.empty()) cout << "  " << r.label;
+    cout << endl;
+  }
+}
+
+int main(int argc, const char** argv)
+{
+  String filter = ".*", out;
+  double min_time = 0.5;
+  Size repetitions = 1;
+  bool list_only = false;
+  auto value = [](const String& arg) { return String(arg.substr(arg.find('=') + 1)); };
+  for (int i = 1; i < argc; ++i)
+  {
+    String arg = argv[i];
+    if (arg.hasPrefix("--benchmark_filter=")) filter = value(arg);
+    else if (arg.hasPrefix("--benchmark_min_time=")) min_time = value(arg).toDouble();
+    else if (arg.hasPrefix("--benchmark_repetitions=")) repetitions = max(1, value(arg).toInt());
+    else if (arg.hasPrefix("--benchmark_out=")) out = value(arg);
+    else if (arg == "--benchmark_list_tests") list_only = true;
+    else if (arg == "--benchmark_out_format=json") continue;
+    else
+    {
+      cerr << "Unknown argument '" << arg << "'\n"
+           << "Usage: " << argv[0] << " [--benchmark_filter=<regex>] [--benchmark_min_time=<seconds>]"
+           << " [--benchmark_repetitions=<n>] [--benchmark_out=<file.json>] [--benchmark_list_tests]" << endl;
+      return 1;
+    }
+  }
+
+  // the algorithms' progress messages would drown the results
+  OpenMS_Log_info.remove(cout);
+
+  regex pattern(filter);
+  vector<Result> results;
+  if (!list_only)
+  {
+    cout << left << setw(50) << "Benchmark" << right << setw(14) << "Time (ms)" << setw(14) << "CPU (ms)" << setw(12) << "Iterations" << endl;
+  }
+  for (const Benchmark::Registration& benchmark : Benchmark::registry())
+  {
+    if (!regex_search(benchmark.name, pattern)) continue;
+    if (list_only)
+    {
+      cout << benchmark.name << endl;
+      continue;
+    }
+
+    vector<Result> runs;
+    for (Size rep = 0; rep < repetitions; ++rep)
+    {
+      // the number of iterations is determined once and then kept for all repetitions
+      Benchmark::State state = rep == 0 ? runMinTime(benchmark, min_time) : Benchmark::State(runs.front().iterations, benchmark.arg);
+      if (rep > 0) benchmark.function(state);
+      runs.push_back(makeResult(benchmark.name, state, rep));
+      printResult(runs.back());
+    }
+    results.insert(results.end(), runs.begin(), runs.end());
+    if (repetitions > 1)
+    {
+      for (const Result& r : aggregate(runs))
+      {
+        printResult(r);
+        results.push_back(r);
+      }
+    }
+  }
+
+  if (!out.empty())
+  {
+    writeJSON(out, argv[0], repetitions, results);
+  }
+  return 0;
+}
@@ -0,0 +1,216 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
+
+#include <functional>
+#include <vector>
+
+namespace OpenMS
+{
+  namespace Benchmark
+  {
+    /**
+      @brief Timing state handed to a benchmark function
+
+      A benchmark function performs its (untimed) set-up and then loops
+
+      @code
+      while (state.keepRunning())
+      {
+        // code to be timed
+      }
+      @endcode
+
+      Timing starts with the first call to keepRunning() and ends when it
+      returns false. Work inside the loop that should not be timed (e.g.
+      copying input that is modified in place) can be bracketed by
+      pauseTiming() and resumeTiming().
+    */
+    class State
+    {
+public:
+      State(Size iterations, Int arg) :
+        iterations_(iterations),
+        arg_(arg)
+      {
+      }
+
+      /// Returns true while there are iterations left (starts and stops the timer)
+      bool keepRunning()
+      {
+        if (done_ == 0 && !timer_.isRunning())
+        {
+          timer_.start();
+        }
+        if (done_ < iterations_)
+        {
+          ++done_;
+          return true;
+        }
+        timer_.stop();
+        return false;
+      }
+
+      /// Stops the timer (e.g. to exclude per-iteration set-up)
+      void pauseTiming()
+      {
+        timer_.stop();
+      }
+
+      /// Restarts the timer after pauseTiming()
+      void resumeTiming()
+      {
+        timer_.start();
+      }
+
+      /// Number of iterations of this run
+      Size iterations() const
+      {
+        return iterations_;
+      }
+
+      /// Number of iterations performed so far
+      Size iterationsDone() const
+      {
+        return done_;
+      }
+
+      /// Argument of this benchmark instance (see OPENMS_BENCHMARK_ARGS), -1 if there is none
+      Int arg() const
+      {
+        return arg_;
+      }
+
+      /// Number of items (e.g. spectra) processed over all iterations
+      void setItemsProcessed(Size items)
+      {
+        items_ = items;
+      }
+
+      /// Number of bytes processed over all iterations
+      void setBytesProcessed(Size bytes)
+      {
+        bytes_ = bytes;
+      }
+
+      /// Free text reported with the result (e.g. input sizes)
+      void setLabel(const String& label)
+      {
+        label_ = label;
+      }
+
+      Size getItemsProcessed() const
+      {
+        return items_;
+      }
+
+      Size getBytesProcessed() const
+      {
+        return bytes_;
+      }
+
+      const String& getLabel() const
+      {
+        return label_;
+      }
+
+      /// Timed wall clock seconds
+      double getClockTime() const
+      {
+        return timer_.getClockTime();
+      }
+
+      /// Timed CPU seconds (summed over all threads)
+      double getCPUTime() const
+      {
+        return timer_.getCPUTime();
+      }
+
+private:
+      Size iterations_;
+      Size done_ = 0;
+      Int arg_;
+      Size items_ = 0;
+      Size bytes_ = 0;
+      String label_;
+      StopWatch timer_;
+    };
+
+    /// A benchmark function
+    typedef std::function<void(State&)> Function;
+
+    /// A registered benchmark instance
+    struct Registration
+    {
+      String name;
+      Function function;
+      Int arg;
+    };
+
+    /// All registered benchmark instances (in order of registration)
+    std::vector<Registration>& registry();
+
+    /// Registers a benchmark on construction (see OPENMS_BENCHMARK)
+    struct Registrar
+    {
+      /// Registers @p function under @p name, once per argument in @p args ("name/arg") or once without argument
+      Registrar(const String& name, const Function& function, const std::vector<Int>& args = std::vector<Int>());
+    };
+
+    /// Prevents the compiler from optimizing away the computation of @p value
+    template <typename T>
+    inline void doNotOptimize(const T& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+      asm volatile("" : : "g"(&value) : "memory");
+#else
+      static const void* volatile sink;
+      sink = &value;
+#endif
+    }
+
+  } // namespace Benchmark
+} // namespace OpenMS
+
+/// Registers the benchmark function @p function (taking a Benchmark::State&)
+#define OPENMS_BENCHMARK(function) \
+  static OpenMS::Benchmark::Registrar function ## _registrar_(#function, function);
+
+/// Registers the benchmark function @p function once for each of the given (integer) arguments
+#define OPENMS_BENCHMARK_ARGS(function, ...) \
+  static OpenMS::Benchmark::Registrar function ## _registrar_(#function, function, {__VA_ARGS__});
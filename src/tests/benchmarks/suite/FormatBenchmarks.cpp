@@ -0,0 +1,179 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include "BenchmarkSuite.h"
+#include "SyntheticData.h"
+
+#include <OpenMS/FORMAT/Base64.h>
+#include <OpenMS/FORMAT/MSNumpressCoder.h>
+#include <OpenMS/FORMAT/MzMLFile.h>
+
+using namespace OpenMS;
+using namespace OpenMS::Benchmark;
+using namespace std;
+
+namespace
+{
+  /// 2000 spectra (500 MS1, 1500 MS2) with 500 peaks each
+  const PeakMap& experiment()
+  {
+    static SyntheticData::Random rng(42);
+    static const PeakMap exp = SyntheticData::centroidedExperiment(rng, 2000, 500);
+    return exp;
+  }
+
+  /// store options: 0 = uncompressed, 1 = zlib, 2 = numpress (linear m/z, slof intensities)
+  MzMLFile mzMLFile(Int compression)
+  {
+    MzMLFile f;
+    if (compression == 1)
+    {
+      f.getOptions().setCompression(true);
+    }
+    else if (compression == 2)
+    {
+      MSNumpressCoder::NumpressConfig mz, intensity;
+      mz.np_compression = MSNumpressCoder::LINEAR;
+      intensity.np_compression = MSNumpressCoder::SLOF;
+      f.getOptions().setNumpressConfigurationMassTime(mz);
+      f.getOptions().setNumpressConfigurationIntensity(intensity);
+    }
+    return f;
+  }
+
+  /// 1 million m/z-like values (increasing, 64 bit)
+  vector<double> mzValues()
+  {
+    SyntheticData::Random rng(42);
+    uniform_real_distribution<double> step(0.0, 0.002);
+    vector<double> values(1000000);
+    double mz = 100.0;
+    for (double& v : values)
+    {
+      mz += step(rng);
+      v = mz;
+    }
+    return values;
+  }
+}
+
+// storing a PeakMap as mzML in memory
+void MzMLFile_store(State& state)
+{
+  const PeakMap& exp = experiment();
+  MzMLFile f = mzMLFile(state.arg());
+  std::string buffer;
+  while (state.keepRunning())
+  {
+    buffer.clear();
+    f.storeBuffer(buffer, exp);
+  }
+  state.setItemsProcessed(state.iterations() * exp.size());
+  state.setBytesProcessed(state.iterations() * buffer.size());
+}
+OPENMS_BENCHMARK_ARGS(MzMLFile_store, 0, 1, 2)
+
+// loading mzML from memory
+void MzMLFile_load(State& state)
+{
+  const PeakMap& exp = experiment();
+  MzMLFile f = mzMLFile(state.arg());
+  std::string buffer;
+  f.storeBuffer(buffer, exp);
+  PeakMap loaded;
+  while (state.keepRunning())
+  {
+    f.loadBuffer(buffer, loaded);
+  }
+  state.setItemsProcessed(state.iterations() * loaded.size());
+  state.setBytesProcessed(state.iterations() * buffer.size());
+}
+OPENMS_BENCHMARK_ARGS(MzMLFile_load, 0, 1, 2)
+
+// arg: 0 = uncompressed, 1 = zlib
+void Base64_encode(State& state)
+{
+  vector<double> values = mzValues();
+  String out;
+  while (state.keepRunning())
+  {
+    Base64::encode(values, Base64::BYTEORDER_LITTLEENDIAN, out, state.arg() == 1);
+  }
+  state.setBytesProcessed(state.iterations() * values.size() * sizeof(double));
+}
+OPENMS_BENCHMARK_ARGS(Base64_encode, 0, 1)
+
+void Base64_decode(State& state)
+{
+  vector<double> values = mzValues(), decoded;
+  String in;
+  Base64::encode(values, Base64::BYTEORDER_LITTLEENDIAN, in, state.arg() == 1);
+  while (state.keepRunning())
+  {
+    Base64::decode(in, Base64::BYTEORDER_LITTLEENDIAN, decoded, state.arg() == 1);
+  }
+  state.setBytesProcessed(state.iterations() * values.size() * sizeof(double));
+}
+OPENMS_BENCHMARK_ARGS(Base64_decode, 0, 1)
+
+// arg: MSNumpressCoder::NumpressCompression (1 = linear, 2 = pic, 3 = slof)
+void MSNumpressCoder_encode(State& state)
+{
+  vector<double> values = mzValues();
+  MSNumpressCoder::NumpressConfig config;
+  config.np_compression = MSNumpressCoder::NumpressCompression(state.arg());
+  MSNumpressCoder coder;
+  String out;
+  while (state.keepRunning())
+  {
+    coder.encodeNP(values, out, false, config);
+  }
+  state.setBytesProcessed(state.iterations() * values.size() * sizeof(double));
+}
+OPENMS_BENCHMARK_ARGS(MSNumpressCoder_encode, 1, 2, 3)
+
+void MSNumpressCoder_decode(State& state)
+{
+  vector<double> values = mzValues(), decoded;
+  MSNumpressCoder::NumpressConfig config;
+  config.np_compression = MSNumpressCoder::NumpressCompression(state.arg());
+  MSNumpressCoder coder;
+  String in;
+  coder.encodeNP(values, in, false, config);
+  while (state.keepRunning())
+  {
+    coder.decodeNP(in, decoded, false, config);
+  }
+  state.setBytesProcessed(state.iterations() * values.size() * sizeof(double));
+}
+OPENMS_BENCHMARK_ARGS(MSNumpressCoder_decode, 1, 2, 3)
@@ -0,0 +1,167 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include "BenchmarkSuite.h"
+#include "SyntheticData.h"
+
+#include <OpenMS/ANALYSIS/ID/FalseDiscoveryRate.h>
+#include <OpenMS/ANALYSIS/ID/PeptideIndexing.h>
+#include <OpenMS/ANALYSIS/RNPXL/HyperScore.h>
+#include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
+#include <OpenMS/CONCEPT/Exception.h>
+
+using namespace OpenMS;
+using namespace OpenMS::Benchmark;
+using namespace std;
+
+namespace
+{
+  /// 1000 tryptic peptides of length 7 to 25
+  vector<AASequence> peptides()
+  {
+    SyntheticData::Random rng(42);
+    vector<AASequence> seqs;
+    for (Size i = 0; i < 1000; ++i)
+    {
+      seqs.push_back(AASequence::fromString(SyntheticData::peptide(rng, 7 + i % 19)));
+    }
+    return seqs;
+  }
+}
+
+// b/y ion spectra (charges 1 and 2) of 1000 peptides; arg 1 adds a-ions, neutral losses and precursor peaks
+void TheoreticalSpectrumGenerator_getSpectrum(State& state)
+{
+  vector<AASequence> seqs = peptides();
+  TheoreticalSpectrumGenerator generator;
+  if (state.arg() == 1)
+  {
+    Param p = generator.getParameters();
+    p.setValue("add_a_ions", "true");
+    p.setValue("add_losses", "true");
+    p.setValue("add_precursor_peaks", "true");
+    generator.setParameters(p);
+  }
+  PeakSpectrum spec;
+  Size n_peaks = 0;
+  while (state.keepRunning())
+  {
+    for (const AASequence& seq : seqs)
+    {
+      spec.clear(true);
+      generator.getSpectrum(spec, seq, 1, 2);
+      n_peaks += spec.size();
+    }
+  }
+  doNotOptimize(n_peaks);
+  state.setItemsProcessed(state.iterations() * seqs.size());
+}
+OPENMS_BENCHMARK_ARGS(TheoreticalSpectrumGenerator_getSpectrum, 0, 1)
+
+// scoring 1000 spectra (with 100 noise peaks) against their theoretical spectra
+void HyperScore_compute(State& state)
+{
+  SyntheticData::Random rng(42);
+  vector<AASequence> seqs = peptides();
+  TheoreticalSpectrumGenerator generator;
+  // HyperScore needs the ion annotations of the theoretical peaks
+  Param params = generator.getParameters();
+  params.setValue("add_metainfo", "true");
+  generator.setParameters(params);
+  vector<PeakSpectrum> theo(seqs.size()), exp;
+  for (Size i = 0; i < seqs.size(); ++i)
+  {
+    generator.getSpectrum(theo[i], seqs[i], 1, 2);
+    exp.push_back(SyntheticData::experimentalSpectrum(rng, seqs[i], 100));
+  }
+  double sum = 0;
+  while (state.keepRunning())
+  {
+    for (Size i = 0; i < seqs.size(); ++i)
+    {
+      sum += HyperScore::compute(10.0, true, exp[i], theo[i]);
+    }
+  }
+  doNotOptimize(sum);
+  state.setItemsProcessed(state.iterations() * seqs.size());
+}
+OPENMS_BENCHMARK(HyperScore_compute)
+
+// mapping 20000 peptides to 2000 target + 2000 decoy proteins of 500 residues
+void PeptideIndexing_run(State& state)
+{
+  SyntheticData::Random rng(42);
+  vector<FASTAFile::FASTAEntry> proteins = SyntheticData::proteins(rng, 2000, 500, true);
+  const vector<PeptideIdentification> input = SyntheticData::proteinPeptideIdentifications(rng, proteins, 20000);
+
+  PeptideIndexing indexer;
+  Param p = indexer.getParameters();
+  p.setValue("decoy_string", "DECOY_");
+  p.setValue("decoy_string_position", "prefix");
+  p.setValue("missing_decoy_action", "silent");
+  indexer.setParameters(p);
+
+  while (state.keepRunning())
+  {
+    state.pauseTiming();
+    vector<ProteinIdentification> prot_ids(1);
+    prot_ids[0].setIdentifier("run");
+    vector<PeptideIdentification> pep_ids = input;
+    state.resumeTiming();
+
+    if (indexer.run(proteins, prot_ids, pep_ids) != PeptideIndexing::EXECUTION_OK)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "PeptideIndexing failed", "");
+    }
+  }
+  state.setItemsProcessed(state.iterations() * input.size());
+}
+OPENMS_BENCHMARK(PeptideIndexing_run)
+
+// q-values of 200000 PSMs (20% decoys)
+void FalseDiscoveryRate_apply(State& state)
+{
+  SyntheticData::Random rng(42);
+  const vector<PeptideIdentification> input = SyntheticData::targetDecoyIdentifications(rng, 200000, 0.2);
+  FalseDiscoveryRate fdr;
+  while (state.keepRunning())
+  {
+    state.pauseTiming();
+    vector<PeptideIdentification> ids = input;
+    state.resumeTiming();
+
+    fdr.apply(ids);
+  }
+  state.setItemsProcessed(state.iterations() * input.size());
+}
+OPENMS_BENCHMARK(FalseDiscoveryRate_apply)
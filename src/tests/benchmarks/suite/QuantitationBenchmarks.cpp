@@ -0,0 +1,156 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include "BenchmarkSuite.h"
+#include "SyntheticData.h"
+
+#include <OpenMS/ANALYSIS/MAPMATCHING/FeatureGroupingAlgorithmKD.h>
+#include <OpenMS/FILTERING/DATAREDUCTION/ElutionPeakDetection.h>
+#include <OpenMS/FILTERING/DATAREDUCTION/FeatureFindingMetabo.h>
+#include <OpenMS/FILTERING/DATAREDUCTION/MassTraceDetection.h>
+#include <OpenMS/KERNEL/ConsensusMap.h>
+
+using namespace OpenMS;
+using namespace OpenMS::Benchmark;
+using namespace std;
+
+/*
+  The three stages of FeatureFinderMetabo (mass trace detection, elution peak
+  detection, feature assembly) on a 1200 s LC-MS run with 1000 compounds.
+*/
+
+namespace
+{
+  const PeakMap& lcmsExperiment()
+  {
+    static SyntheticData::Random rng(42);
+    static const PeakMap exp = SyntheticData::lcmsExperiment(rng, 1000, 1200, 200);
+    return exp;
+  }
+
+  const vector<MassTrace>& massTraces()
+  {
+    static vector<MassTrace> traces;
+    if (traces.empty())
+    {
+      MassTraceDetection().run(lcmsExperiment(), traces);
+    }
+    return traces;
+  }
+
+  const vector<MassTrace>& elutionPeaks()
+  {
+    static vector<MassTrace> peaks;
+    if (peaks.empty())
+    {
+      vector<MassTrace> traces = massTraces();
+      ElutionPeakDetection().detectPeaks(traces, peaks);
+    }
+    return peaks;
+  }
+}
+
+void MassTraceDetection_run(State& state)
+{
+  const PeakMap& exp = lcmsExperiment();
+  MassTraceDetection mtd;
+  vector<MassTrace> traces;
+  while (state.keepRunning())
+  {
+    traces.clear();
+    mtd.run(exp, traces);
+  }
+  state.setItemsProcessed(state.iterations() * exp.size());
+  state.setLabel(String(traces.size()) + " mass traces");
+}
+OPENMS_BENCHMARK(MassTraceDetection_run)
+
+void ElutionPeakDetection_detectPeaks(State& state)
+{
+  const vector<MassTrace>& input = massTraces();
+  ElutionPeakDetection epd;
+  vector<MassTrace> peaks;
+  while (state.keepRunning())
+  {
+    state.pauseTiming();
+    vector<MassTrace> traces = input;
+    peaks.clear();
+    state.resumeTiming();
+
+    epd.detectPeaks(traces, peaks);
+  }
+  state.setItemsProcessed(state.iterations() * input.size());
+  state.setLabel(String(peaks.size()) + " elution peaks");
+}
+OPENMS_BENCHMARK(ElutionPeakDetection_detectPeaks)
+
+void FeatureFindingMetabo_run(State& state)
+{
+  const vector<MassTrace>& input = elutionPeaks();
+  FeatureFindingMetabo ffm;
+  FeatureMap features;
+  vector<vector<MSChromatogram> > chromatograms;
+  while (state.keepRunning())
+  {
+    state.pauseTiming();
+    vector<MassTrace> traces = input;
+    features.clear(true);
+    chromatograms.clear();
+    state.resumeTiming();
+
+    ffm.run(traces, features, chromatograms);
+  }
+  state.setItemsProcessed(state.iterations() * input.size());
+  state.setLabel(String(features.size()) + " features");
+}
+OPENMS_BENCHMARK(FeatureFindingMetabo_run)
+
+// linking arg (= 2, 5 or 10) feature maps of 20000 features each
+void FeatureGroupingAlgorithmKD_group(State& state)
+{
+  SyntheticData::Random rng(42);
+  vector<FeatureMap> maps = SyntheticData::featureMaps(rng, state.arg(), 20000);
+  FeatureGroupingAlgorithmKD linker;
+  ConsensusMap out;
+  while (state.keepRunning())
+  {
+    state.pauseTiming();
+    out.clear(true);
+    state.resumeTiming();
+
+    linker.group(maps, out);
+  }
+  state.setItemsProcessed(state.iterations() * maps.size() * 20000);
+  state.setLabel(String(out.size()) + " consensus features");
+}
+OPENMS_BENCHMARK_ARGS(FeatureGroupingAlgorithmKD_group, 2, 5, 10)
@@ -0,0 +1,104 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include "BenchmarkSuite.h"
+#include "SyntheticData.h"
+
+#include <OpenMS/ANALYSIS/OPENSWATH/ChromatogramExtractorAlgorithm.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SimpleOpenMSSpectraAccessFactory.h>
+#include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
+
+#include <algorithm>
+
+using namespace OpenMS;
+using namespace OpenMS::Benchmark;
+using namespace std;
+
+// centroiding 100 profile spectra with 2000 peaks each
+void PeakPickerHiRes_pick(State& state)
+{
+  SyntheticData::Random rng(42);
+  vector<MSSpectrum> spectra;
+  for (Size i = 0; i < 100; ++i)
+  {
+    spectra.push_back(SyntheticData::profileSpectrum(rng, 2000));
+  }
+  PeakPickerHiRes picker;
+  MSSpectrum picked;
+  Size n_picked = 0;
+  while (state.keepRunning())
+  {
+    for (const MSSpectrum& s : spectra)
+    {
+      picker.pick(s, picked);
+      n_picked += picked.size();
+    }
+  }
+  doNotOptimize(n_picked);
+  state.setItemsProcessed(state.iterations() * spectra.size());
+  state.setLabel(String(n_picked / state.iterations()) + " peaks picked");
+}
+OPENMS_BENCHMARK(PeakPickerHiRes_pick)
+
+// extracting chromatograms (20 ppm, +/- 60 s) of 2000 compounds from a 1200 s LC-MS run
+void ChromatogramExtractorAlgorithm_extract(State& state)
+{
+  SyntheticData::Random rng(42);
+  vector<double> mzs, rts;
+  boost::shared_ptr<PeakMap> exp(new PeakMap(SyntheticData::lcmsExperiment(rng, 2000, 1200, 200, &mzs, &rts)));
+  OpenSwath::SpectrumAccessPtr access = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+
+  vector<ChromatogramExtractorAlgorithm::ExtractionCoordinates> coordinates(mzs.size());
+  for (Size i = 0; i < mzs.size(); ++i)
+  {
+    coordinates[i].mz = mzs[i];
+    coordinates[i].rt_start = rts[i] - 60.0;
+    coordinates[i].rt_end = rts[i] + 60.0;
+    coordinates[i].id = "compound_" + String(i);
+  }
+  sort(coordinates.begin(), coordinates.end(), ChromatogramExtractorAlgorithm::ExtractionCoordinates::SortExtractionCoordinatesByMZ);
+
+  ChromatogramExtractorAlgorithm extractor;
+  while (state.keepRunning())
+  {
+    vector<OpenSwath::ChromatogramPtr> chromatograms;
+    for (Size i = 0; i < coordinates.size(); ++i)
+    {
+      chromatograms.push_back(OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+    }
+    extractor.extractChromatograms(access, chromatograms, coordinates, 20.0, true, -1, "tophat");
+    doNotOptimize(chromatograms);
+  }
+  state.setItemsProcessed(state.iterations() * exp->size());
+}
+OPENMS_BENCHMARK(ChromatogramExtractorAlgorithm_extract)
@@ -0,0 +1,327 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include "SyntheticData.h"
+
+#include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
+#include <OpenMS/CONCEPT/Constants.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace OpenMS
+{
+  namespace Benchmark
+  {
+    namespace SyntheticData
+    {
+      String peptide(Random& rng, Size length)
+      {
+        static const String residues = "ACDEFGHILMNPQSTVWY";
+        uniform_int_distribution<Size> residue(0, residues.size() - 1);
+        String seq;
+        for (Size i = 0; i + 1 < length; ++i)
+        {
+          seq += residues[residue(rng)];
+        }
+        seq += (rng() % 2) ? 'K' : 'R';
+        return seq;
+      }
+
+      vector<FASTAFile::FASTAEntry> proteins(Random& rng, Size n, Size length, bool decoys)
+      {
+        uniform_int_distribution<Size> peptide_length(6, 25);
+        vector<FASTAFile::FASTAEntry> entries;
+        for (Size i = 0; i < n; ++i)
+        {
+          String seq = "M";
+          while (seq.size() < length)
+          {
+            seq += peptide(rng, peptide_length(rng));
+          }
+          entries.emplace_back("PROT_" + String(i), "synthetic protein", seq);
+        }
+        if (decoys)
+        {
+          for (Size i = 0; i < n; ++i)
+          {
+            String seq = entries[i].sequence;
+            reverse(seq.begin(), seq.end());
+            entries.emplace_back("DECOY_PROT_" + String(i), "synthetic decoy protein", seq);
+          }
+        }
+        return entries;
+      }
+
+      MSSpectrum profileSpectrum(Random& rng, Size n_peaks, double resolution)
+      {
+        uniform_real_distribution<double> mz(300.0, 1500.0);
+        uniform_real_distribution<double> height(1e3, 1e6);
+        normal_distribution<double> noise(0.0, 0.01);
+        vector<pair<double, double> > peaks;
+        for (Size i = 0; i < n_peaks; ++i)
+        {
+          peaks.emplace_back(mz(rng), height(rng));
+        }
+        sort(peaks.begin(), peaks.end());
+
+        MSSpectrum s;
+        s.setMSLevel(1);
+        s.setType(SpectrumSettings::PROFILE);
+        const double points = 15.0; // data points across +/- 3 sigma
+        for (const pair<double, double>& p : peaks)
+        {
+          double fwhm = p.first * sqrt(p.first / 400.0) / resolution; // Orbitrap-like resolution
+          double sigma = fwhm / 2.3548;
+          double step = 6.0 * sigma / points;
+          double start = p.first - 3.0 * sigma;
+          if (!s.empty() && start <= s.back().getMZ()) continue; // skip overlapping peaks
+          for (Size k = 0; k <= points; ++k)
+          {
+            double x = start + k * step;
+            double d = (x - p.first) / sigma;
+            s.push_back(Peak1D(x, max(0.0, p.second * (exp(-0.5 * d * d) + noise(rng)))));
+          }
+        }
+        return s;
+      }
+
+      PeakMap centroidedExperiment(Random& rng, Size n_spectra, Size n_peaks)
+      {
+        uniform_real_distribution<double> mz(100.0, 2000.0);
+        uniform_real_distribution<double> intensity(10.0, 1e6);
+        PeakMap exp;
+        for (Size i = 0; i < n_spectra; ++i)
+        {
+          MSSpectrum s;
+          s.setRT(i * 0.5);
+          s.setMSLevel(i % 4 == 0 ? 1 : 2);
+          s.setNativeID("scan=" + String(i + 1));
+          s.setType(SpectrumSettings::CENTROID);
+          if (s.getMSLevel() == 2)
+          {
+            Precursor p;
+            p.setMZ(mz(rng));
+            p.setCharge(2);
+            s.getPrecursors().push_back(p);
+          }
+          s.resize(n_peaks);
+          for (Peak1D& p : s)
+          {
+            p.setMZ(mz(rng));
+            p.setIntensity(intensity(rng));
+          }
+          s.sortByPosition();
+          exp.addSpectrum(std::move(s));
+        }
+        exp.updateRanges();
+        return exp;
+      }
+
+      PeakMap lcmsExperiment(Random& rng, Size n_compounds, Size n_spectra, Size n_noise_peaks,
+                             vector<double>* compound_mzs, vector<double>* compound_rts)
+      {
+        struct Compound
+        {
+          double mz, rt, sigma, height;
+          Int charge;
+        };
+        uniform_real_distribution<double> mz(150.0, 1200.0);
+        uniform_real_distribution<double> rt(10.0, max(20.0, n_spectra - 10.0));
+        uniform_real_distribution<double> sigma(3.0, 8.0);
+        uniform_real_distribution<double> log_height(4.0, 7.0);
+        uniform_real_distribution<double> noise_intensity(10.0, 300.0);
+        normal_distribution<double> ppm(0.0, 2.0);
+
+        vector<Compound> compounds(n_compounds);
+        for (Compound& c : compounds)
+        {
+          c = Compound{mz(rng), rt(rng), sigma(rng), pow(10.0, log_height(rng)), Int(1 + rng() % 2)};
+        }
+        if (compound_mzs) compound_mzs->clear();
+        if (compound_rts) compound_rts->clear();
+        for (const Compound& c : compounds)
+        {
+          if (compound_mzs) compound_mzs->push_back(c.mz);
+          if (compound_rts) compound_rts->push_back(c.rt);
+        }
+
+        const double isotope_ratio[3] = {1.0, 0.55, 0.2};
+        PeakMap experiment;
+        for (Size i = 0; i < n_spectra; ++i)
+        {
+          MSSpectrum s;
+          s.setRT(double(i));
+          s.setMSLevel(1);
+          s.setNativeID("scan=" + String(i + 1));
+          s.setType(SpectrumSettings::CENTROID);
+          for (const Compound& c : compounds)
+          {
+            double d = (s.getRT() - c.rt) / c.sigma;
+            if (fabs(d) > 4.0) continue;
+            double apex = c.height * exp(-0.5 * d * d);
+            for (Size iso = 0; iso < 3; ++iso)
+            {
+              double iso_mz = c.mz + iso * Constants::C13C12_MASSDIFF_U / c.charge;
+              s.push_back(Peak1D(iso_mz * (1.0 + ppm(rng) * 1e-6), apex * isotope_ratio[iso]));
+            }
+          }
+          for (Size k = 0; k < n_noise_peaks; ++k)
+          {
+            s.push_back(Peak1D(mz(rng), noise_intensity(rng)));
+          }
+          s.sortByPosition();
+          experiment.addSpectrum(std::move(s));
+        }
+        experiment.updateRanges();
+        return experiment;
+      }
+
+      vector<FeatureMap> featureMaps(Random& rng, Size n_maps, Size n_features)
+      {
+        uniform_real_distribution<double> rt(60.0, 3600.0);
+        uniform_real_distribution<double> mz(200.0, 1500.0);
+        uniform_real_distribution<double> log_intensity(4.0, 8.0);
+        uniform_real_distribution<double> keep(0.0, 1.0);
+        normal_distribution<double> rt_jitter(0.0, 2.0);
+        normal_distribution<double> ppm(0.0, 3.0);
+
+        vector<Feature> features(n_features);
+        for (Feature& f : features)
+        {
+          f.setRT(rt(rng));
+          f.setMZ(mz(rng));
+          f.setCharge(Int(1 + rng() % 3));
+          f.setIntensity(pow(10.0, log_intensity(rng)));
+          f.setOverallQuality(1.0);
+        }
+
+        vector<FeatureMap> maps(n_maps);
+        for (Size m = 0; m < n_maps; ++m)
+        {
+          double rt_shift = 5.0 * m;
+          for (const Feature& f : features)
+          {
+            if (keep(rng) > 0.9) continue;
+            Feature g(f);
+            g.setRT(f.getRT() + rt_shift + rt_jitter(rng));
+            g.setMZ(f.getMZ() * (1.0 + ppm(rng) * 1e-6));
+            g.setUniqueId();
+            maps[m].push_back(g);
+          }
+          maps[m].setUniqueId();
+          maps[m].updateRanges();
+        }
+        return maps;
+      }
+
+      vector<PeptideIdentification> targetDecoyIdentifications(Random& rng, Size n, double decoy_fraction)
+      {
+        uniform_real_distribution<double> uniform(0.0, 1.0);
+        normal_distribution<double> target_score(30.0, 10.0);
+        normal_distribution<double> decoy_score(15.0, 5.0);
+        vector<PeptideIdentification> ids(n);
+        for (Size i = 0; i < n; ++i)
+        {
+          bool decoy = uniform(rng) < decoy_fraction;
+          PeptideHit hit(decoy ? decoy_score(rng) : target_score(rng), 1, Int(2 + rng() % 3), AASequence::fromString(peptide(rng, 8 + rng() % 10)));
+          hit.setMetaValue("target_decoy", decoy ? "decoy" : "target");
+          ids[i].setIdentifier("run");
+          ids[i].setScoreType("hyperscore");
+          ids[i].setHigherScoreBetter(true);
+          ids[i].setRT(i * 0.5);
+          ids[i].setMZ(400.0 + i % 1000);
+          ids[i].insertHit(hit);
+        }
+        return ids;
+      }
+
+      vector<PeptideIdentification> proteinPeptideIdentifications(Random& rng, const vector<FASTAFile::FASTAEntry>& proteins, Size n)
+      {
+        // tryptic peptides of all target proteins
+        vector<String> peptides;
+        for (const FASTAFile::FASTAEntry& entry : proteins)
+        {
+          if (entry.identifier.hasPrefix("DECOY_")) continue;
+          Size start = 1; // skip initial M
+          for (Size i = 1; i < entry.sequence.size(); ++i)
+          {
+            if (entry.sequence[i] == 'K' || entry.sequence[i] == 'R')
+            {
+              peptides.push_back(entry.sequence.substr(start, i + 1 - start));
+              start = i + 1;
+            }
+          }
+        }
+
+        uniform_int_distribution<Size> pick(0, peptides.size() - 1);
+        uniform_real_distribution<double> score(0.0, 100.0);
+        vector<PeptideIdentification> ids(n);
+        for (Size i = 0; i < n; ++i)
+        {
+          ids[i].setIdentifier("run");
+          ids[i].setScoreType("hyperscore");
+          ids[i].setHigherScoreBetter(true);
+          ids[i].insertHit(PeptideHit(score(rng), 1, 2, AASequence::fromString(peptides[pick(rng)])));
+        }
+        return ids;
+      }
+
+      PeakSpectrum experimentalSpectrum(Random& rng, const AASequence& peptide, Size n_noise_peaks)
+      {
+        static const TheoreticalSpectrumGenerator generator;
+        PeakSpectrum theo;
+        generator.getSpectrum(theo, peptide, 1, 2);
+
+        uniform_real_distribution<double> uniform(0.0, 1.0);
+        uniform_real_distribution<double> mz(100.0, 2000.0);
+        normal_distribution<double> ppm(0.0, 3.0);
+        PeakSpectrum spec;
+        for (const Peak1D& p : theo)
+        {
+          if (uniform(rng) < 0.3) continue; // missing fragment ion
+          spec.push_back(Peak1D(p.getMZ() * (1.0 + ppm(rng) * 1e-6), 1e3 + 1e5 * uniform(rng)));
+        }
+        for (Size k = 0; k < n_noise_peaks; ++k)
+        {
+          spec.push_back(Peak1D(mz(rng), 1e3 * uniform(rng)));
+        }
+        spec.sortByPosition();
+        return spec;
+      }
+    }
+  }
+}
@@ -0,0 +1,98 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/FORMAT/FASTAFile.h>
+#include <OpenMS/KERNEL/FeatureMap.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/METADATA/PeptideIdentification.h>
+#include <OpenMS/METADATA/ProteinIdentification.h>
+
+#include <random>
+#include <vector>
+
+namespace OpenMS
+{
+  namespace Benchmark
+  {
+    /**
+      @brief Generators of synthetic input data for the benchmarks
+
+      All data is generated deterministically from the given random engine,
+      so results of different builds are computed on identical input.
+    */
+    namespace SyntheticData
+    {
+      /// Random engine used by all generators (seed it with a constant)
+      typedef std::mt19937 Random;
+
+      /// Tryptic peptide of @p length residues (no internal K/R, C-terminal K or R)
+      String peptide(Random& rng, Size length);
+
+      /// Proteins of about @p length residues made of tryptic peptides ("PROT_<i>"); with @p decoys, reversed "DECOY_PROT_<i>" entries are appended
+      std::vector<FASTAFile::FASTAEntry> proteins(Random& rng, Size n, Size length, bool decoys);
+
+      /// Profile spectrum with @p n_peaks Gaussian peaks between 300 and 1500 m/z (@p resolution at 400 m/z, ~15 points per peak)
+      MSSpectrum profileSpectrum(Random& rng, Size n_peaks, double resolution = 60000.0);
+
+      /// Centroided MS1 and MS2 spectra with @p n_peaks random peaks each (every fourth spectrum is MS1)
+      PeakMap centroidedExperiment(Random& rng, Size n_spectra, Size n_peaks);
+
+      /**
+        @brief Centroided LC-MS run (MS1 only, one spectrum per second)
+
+        Contains @p n_compounds isotope patterns (charge 1 or 2, three
+        isotopes) with Gaussian elution profiles (sigma 3-8 s) and
+        @p n_noise_peaks random low-intensity peaks per spectrum.
+
+        @param compound_mzs Optional output: monoisotopic m/z of each compound
+        @param compound_rts Optional output: apex RT of each compound
+      */
+      PeakMap lcmsExperiment(Random& rng, Size n_compounds, Size n_spectra, Size n_noise_peaks = 200,
+                             std::vector<double>* compound_mzs = nullptr, std::vector<double>* compound_rts = nullptr);
+
+      /// @p n_maps feature maps of the same @p n_features features with RT / m/z jitter (90% of the features per map, unique ids set)
+      std::vector<FeatureMap> featureMaps(Random& rng, Size n_maps, Size n_features);
+
+      /// @p n peptide identifications with one hit each; a fraction @p decoy_fraction of the hits is a decoy (meta value "target_decoy")
+      std::vector<PeptideIdentification> targetDecoyIdentifications(Random& rng, Size n, double decoy_fraction);
+
+      /// @p n peptide identifications (identifier "run") whose hits are tryptic peptides of random target proteins in @p proteins
+      std::vector<PeptideIdentification> proteinPeptideIdentifications(Random& rng, const std::vector<FASTAFile::FASTAEntry>& proteins, Size n);
+
+      /// Theoretical spectrum of @p peptide (b/y ions, charges 1 and 2) with m/z jitter, dropped ions and @p n_noise_peaks noise peaks
+      PeakSpectrum experimentalSpectrum(Random& rng, const AASequence& peptide, Size n_noise_peaks);
+    }
+  }
+}
@@ -0,0 +1,104 @@
+#!/usr/bin/env python
+# -*- coding: utf-8  -*-
+"""
+--------------------------------------------------------------------------
+                  OpenMS -- Open-Source Mass Spectrometry
+--------------------------------------------------------------------------
+Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+
+This software is released under a three-clause BSD license:
+ * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+ * Neither the name of any author or any participating institution
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+For a full list of authors, refer to the file AUTHORS.
+--------------------------------------------------------------------------
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+--------------------------------------------------------------------------
+$Maintainer: Timo Sachsenberg$
+$Authors: $
+--------------------------------------------------------------------------
+
+Compares two JSON result files of the benchmark suite (or of any Google
+Benchmark executable) and reports the relative change of the time per
+iteration. If repetitions were run, the "mean" aggregates are compared.
+
+Exits with 1 if any benchmark got slower by more than the threshold.
+
+Usage: compare_benchmarks.py baseline.json contender.json [--threshold 0.1] [--cpu]
+"""
+from __future__ import print_function
+
+import argparse
+import json
+import sys
+
+
+def load_times(filename, field):
+    with open(filename) as f:
+        benchmarks = json.load(f)["benchmarks"]
+    has_mean = any(b.get("aggregate_name") == "mean" for b in benchmarks)
+    times = {}
+    for b in benchmarks:
+        if has_mean:
+            if b.get("aggregate_name") != "mean":
+                continue
+        elif b.get("run_type", "iteration") != "iteration" or b.get("repetition_index", 0) != 0:
+            continue
+        times[b.get("run_name", b["name"])] = (b[field], b.get("time_unit", "ns"))
+    return times
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare two benchmark result files.")
+    parser.add_argument("baseline")
+    parser.add_argument("contender")
+    parser.add_argument("--threshold", type=float, default=0.1,
+                        help="relative slow-down reported as regression (default: 0.1 = 10%%)")
+    parser.add_argument("--cpu", action="store_true", help="compare CPU time instead of wall clock time")
+    args = parser.parse_args()
+
+    field = "cpu_time" if args.cpu else "real_time"
+    baseline = load_times(args.baseline, field)
+    contender = load_times(args.contender, field)
+
+    regressions = 0
+    print("%-50s %14s %14s %9s" % ("Benchmark", "Baseline", "Contender", "Change"))
+    for name in sorted(set(baseline) | set(contender)):
+        if name not in baseline or name not in contender:
+            print("%-50s %s" % (name, "only in " + (args.baseline if name in baseline else args.contender)))
+            continue
+        (old, unit), (new, new_unit) = baseline[name], contender[name]
+        if unit != new_unit:
+            print("%-50s %s" % (name, "time units differ (%s vs. %s)" % (unit, new_unit)))
+            continue
+        change = (new - old) / old if old > 0 else 0.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        print("%-50s %12.4g%-2s %12.4g%-2s %+8.1f%%%s" % (name, old, unit, new, unit, 100.0 * change, flag))
+
+    if regressions:
+        print("%d benchmark(s) slower by more than %.0f%%" % (regressions, 100.0 * args.threshold))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -11,6 +11,7 @@ set(concept_executables_list
   LogConfigHandler_test
   LogStream_test
   Multithreading_test
+  ParallelExceptionCollector_test
   UniqueIdGenerator_test
   UniqueIdIndexer_test
   UniqueIdInterface_test
@@ -65,6 +66,7 @@ set(datastructures_executables_list
   Param_test
   QTCluster_test
   RangeManager_test
+  SparseDistanceMatrix_test
   StringListUtils_test
   StringUtils_test
   String_test
@@ -78,6 +80,7 @@ set(metadata_executables_list
   CVTermListInterface_test
   CVTerm_test
   ChromatogramSettings_test
+  ColumnarPSMStore_test
   ContactPerson_test
   DataProcessing_test
   Digestion_test
@@ -127,6 +130,7 @@ set(system_executables_list
   FileWatcher_test
   JavaInfo_test
   StopWatch_test
+  Profiler_test
   SysInfo_test
 )
 
@@ -148,7 +152,9 @@ set(kernel_executables_list
   MRMTransitionGroup_test
   MSChromatogram_test
   MSExperiment_test
+  MSExperimentAreaIndex_test
   OnDiscMSExperiment_test
+  OnDiscSpectrumCache_test
   MSSpectrum_test
   Peak1D_test
   Peak2D_test
@@ -183,6 +189,7 @@ set(format_executables_list
   GzipIfstream_test
   GzipInputStream_test
   IBSpectraFile_test
+  IdBinaryFile_test
   IdXMLFile_test
   IndexedMzMLDecoder_test
   IndexedMzMLFile_test
@@ -358,6 +365,7 @@ set(comparison_executables_list
   AverageLinkage_test
   BinnedSharedPeakCount_test
   BinnedSpectralContrastAngle_test
+  BinnedSpectrumBlock_test
   BinnedSpectrumCompareFunctor_test
   BinnedSpectrum_test
   BinnedSumAgreeingIntensities_test
@@ -370,6 +378,7 @@ set(comparison_executables_list
   PeakSpectrumCompareFunctor_test
   SingleLinkage_test
   SpectraSTSimilarityScore_test
+  SpectralLibraryIndex_test
   SpectrumAlignmentScore_test
   SpectrumAlignment_test
   SpectrumCheapDPCorr_test
@@ -380,6 +389,7 @@ set(comparison_executables_list
 
 set(chemistry_executables_list
   AAIndex_test
+  AASequencePool_test
   AASequence_test
   CoarseIsotopeDistribution_test
   CrossLinksDB_test
@@ -396,6 +406,7 @@ set(chemistry_executables_list
   IMSElement_test
   IMSIsotopeDistribution_test
   IntegerMassDecomposer_test
+  InternedAASequence_test
   IsoSpec_test
   IsotopeDistribution_test
   MassDecomposer_test
@@ -0,0 +1,103 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/CHEMISTRY/AASequencePool.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(AASequencePool, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+AASequencePool* ptr = nullptr;
+AASequencePool* null_ptr = nullptr;
+START_SECTION(static AASequencePool* getInstance())
+{
+  ptr = AASequencePool::getInstance();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr, AASequencePool::getInstance())
+}
+END_SECTION
+
+START_SECTION(InternedAASequence intern(const AASequence& sequence))
+{
+  AASequence seq = AASequence::fromString("PEPM(Oxidation)TIDE");
+  InternedAASequence a = ptr->intern(seq);
+  InternedAASequence b = ptr->intern(AASequence::fromString("PEPM(Oxidation)TIDE"));
+  TEST_EQUAL(a.isPooled(), true)
+  TEST_EQUAL(a.getSequence(), seq)
+  // equal sequences share one object:
+  TEST_EQUAL(&a.getSequence(), &b.getSequence())
+  InternedAASequence c = ptr->intern(AASequence::fromString("PEPMTIDE"));
+  TEST_NOT_EQUAL(&a.getSequence(), &c.getSequence())
+  TEST_EQUAL(a == c, false)
+}
+END_SECTION
+
+START_SECTION(InternedAASequence intern(const String& sequence))
+{
+  InternedAASequence a = ptr->intern(String("PEPTIDER"));
+  InternedAASequence b = ptr->intern(String("PEPTIDER"));
+  InternedAASequence c = ptr->intern(AASequence::fromString("PEPTIDER"));
+  TEST_EQUAL(a.isPooled(), true)
+  TEST_EQUAL(&a.getSequence(), &b.getSequence())
+  TEST_EQUAL(&a.getSequence(), &c.getSequence())
+  TEST_STRING_EQUAL(a.getSequence().toString(), "PEPTIDER")
+  TEST_EXCEPTION(Exception::ParseError, ptr->intern(String("blDABCDEF")))
+}
+END_SECTION
+
+START_SECTION(Size size() const)
+{
+  Size before = ptr->size();
+  {
+    InternedAASequence a = ptr->intern(String("SIZETESTK"));
+    InternedAASequence b = ptr->intern(String("SIZETESTK"));
+    TEST_EQUAL(ptr->size(), before + 1)
+  }
+  // unused sequences are released:
+  TEST_EQUAL(ptr->size(), before)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
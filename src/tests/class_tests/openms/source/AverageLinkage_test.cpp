@@ -39,6 +39,7 @@
 #include <OpenMS/COMPARISON/CLUSTERING/AverageLinkage.h>
 #include <OpenMS/COMPARISON/CLUSTERING/ClusterAnalyzer.h>
 #include <OpenMS/DATASTRUCTURES/DistanceMatrix.h>
+#include <OpenMS/DATASTRUCTURES/SparseDistanceMatrix.h>
 #include <vector>
 //#include <iostream>
 ///////////////////////////
@@ -146,6 +147,64 @@ START_SECTION((void operator()(DistanceMatrix< float > &original_distance, std::
 }
 END_SECTION
 
+START_SECTION((void operator()(const SparseDistanceMatrix& distance, std::vector<BinaryTreeNode>& cluster_tree, const float threshold=1) const))
+{
+	DistanceMatrix<float> matrix(6,666);
+	matrix.setValue(1,0,0.5f);
+	matrix.setValue(2,0,0.8f);
+	matrix.setValue(2,1,0.3f);
+	matrix.setValue(3,0,0.6f);
+	matrix.setValue(3,1,0.8f);
+	matrix.setValue(3,2,0.8f);
+	matrix.setValue(4,0,0.8f);
+	matrix.setValue(4,1,0.8f);
+	matrix.setValue(4,2,0.8f);
+	matrix.setValue(4,3,0.4f);
+	matrix.setValue(5,0,0.7000001f);
+	matrix.setValue(5,1,0.8f);
+	matrix.setValue(5,2,0.8f);
+	matrix.setValue(5,3,0.8f);
+	matrix.setValue(5,4,0.8f);
+	SparseDistanceMatrix sparse(matrix, 1.0f);
+
+	// same trees as the DistanceMatrix version
+	vector< BinaryTreeNode > result;
+	vector< BinaryTreeNode > tree;
+	tree.push_back(BinaryTreeNode(1,2,0.3f));
+	tree.push_back(BinaryTreeNode(3,4,0.4f));
+	tree.push_back(BinaryTreeNode(0,1,0.65f));
+	tree.push_back(BinaryTreeNode(0,3,0.766667f));
+	tree.push_back(BinaryTreeNode(0,5,0.78f));
+
+	AverageLinkage al;
+	al(sparse,result);
+	TEST_EQUAL(tree.size(), result.size());
+	for (Size i = 0; i < result.size(); ++i)
+	{
+			TEST_EQUAL(tree[i].left_child, result[i].left_child);
+			TEST_EQUAL(tree[i].right_child, result[i].right_child);
+			TOLERANCE_ABSOLUTE(0.0001);
+			TEST_REAL_SIMILAR(tree[i].distance, result[i].distance);
+	}
+
+	tree.pop_back();
+	tree.pop_back();
+	tree.push_back(BinaryTreeNode(0,3,-1.0f));
+	tree.push_back(BinaryTreeNode(0,5,-1.0f));
+	result.clear();
+
+	al(sparse,result,0.7f);
+	TEST_EQUAL(tree.size(), result.size());
+	for (Size i = 0; i < result.size(); ++i)
+	{
+			TEST_EQUAL(tree[i].left_child, result[i].left_child);
+			TEST_EQUAL(tree[i].right_child, result[i].right_child);
+			TOLERANCE_ABSOLUTE(0.0001);
+			TEST_REAL_SIMILAR(tree[i].distance, result[i].distance);
+	}
+}
+END_SECTION
+
 START_SECTION((static const String getProductName()))
 {
 	AverageLinkage al5;
@@ -38,6 +38,7 @@
 ///////////////////////////
 #include <OpenMS/COMPARISON/SPECTRA/BinnedSharedPeakCount.h>
 #include <OpenMS/COMPARISON/SPECTRA/BinnedSpectrum.h>
+#include <OpenMS/COMPARISON/SPECTRA/BinnedSpectrumBlock.h>
 #include <OpenMS/FORMAT/DTAFile.h>
 ///////////////////////////
 
@@ -110,6 +111,44 @@ START_SECTION((double operator()(const BinnedSpectrum &spec) const ))
 }
 END_SECTION
 
+START_SECTION((void operator()(const BinnedSpectrum& query, const BinnedSpectrumBlock& block, std::vector<double>& scores) const))
+{
+  PeakSpectrum s1, s2, s3;
+  DTAFile().load(OPENMS_GET_TEST_DATA_PATH("PILISSequenceDB_DFPIANGER_1.dta"), s1);
+  s2 = s1;
+  s2.pop_back();
+  s3 = s1;
+  s3.resize(s3.size() / 2);
+  vector<BinnedSpectrum> spectra;
+  spectra.push_back(BinnedSpectrum(s1, 1.5, false, 2, BinnedSpectrum::DEFAULT_BIN_OFFSET_LOWRES));
+  spectra.push_back(BinnedSpectrum(s2, 1.5, false, 2, BinnedSpectrum::DEFAULT_BIN_OFFSET_LOWRES));
+  spectra.push_back(BinnedSpectrum(s3, 1.5, false, 2, BinnedSpectrum::DEFAULT_BIN_OFFSET_LOWRES));
+  BinnedSpectrumBlock block(spectra);
+
+  // same results as pairwise comparisons, with and without dense window:
+  vector<double> scores;
+  (*ptr)(spectra[2], block, scores);
+  ABORT_IF(scores.size() != 3)
+  for (Size i = 0; i < spectra.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(scores[i], (*ptr)(spectra[2], spectra[i]))
+  }
+  block.createDenseWindow();
+  (*ptr)(spectra[2], block, scores);
+  ABORT_IF(scores.size() != 3)
+  for (Size i = 0; i < spectra.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(scores[i], (*ptr)(spectra[2], spectra[i]))
+  }
+
+  (*ptr)(spectra[0], BinnedSpectrumBlock(), scores);
+  TEST_EQUAL(scores.size(), 0)
+
+  BinnedSpectrum other(s1, 1.0, false, 0, 0.0);
+  TEST_EXCEPTION(Exception::IllegalArgument, (*ptr)(other, block, scores))
+}
+END_SECTION
+
 START_SECTION((static BinnedSpectrumCompareFunctor* create()))
 {
   BinnedSpectrumCompareFunctor* bsf = BinnedSharedPeakCount::create();
@@ -0,0 +1,224 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg$
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/COMPARISON/SPECTRA/BinnedSpectrumBlock.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(BinnedSpectrumBlock, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+BinnedSpectrumBlock* ptr = nullptr;
+BinnedSpectrumBlock* null_ptr = nullptr;
+START_SECTION((BinnedSpectrumBlock()))
+{
+  ptr = new BinnedSpectrumBlock();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_EQUAL(ptr->empty(), true)
+  TEST_EQUAL(ptr->getRowOffsets().size(), 1)
+  TEST_EQUAL(ptr->getFirstBin(), 0)
+  TEST_EQUAL(ptr->getLastBin(), -1)
+}
+END_SECTION
+
+START_SECTION((virtual ~BinnedSpectrumBlock()))
+{
+  delete ptr;
+}
+END_SECTION
+
+PeakSpectrum s1, s2;
+s1.push_back(Peak1D(100.5, 2.0));
+s1.push_back(Peak1D(105.5, 1.0));
+s2.push_back(Peak1D(102.5, 3.0));
+
+// one bin per Th, no spread, no offset:
+vector<BinnedSpectrum> spectra;
+spectra.push_back(BinnedSpectrum(s1, 1.0, false, 0, 0.0));
+spectra.push_back(BinnedSpectrum(s2, 1.0, false, 0, 0.0));
+spectra.push_back(BinnedSpectrum(PeakSpectrum(), 1.0, false, 0, 0.0));
+
+BinnedSpectrumBlock block(spectra);
+
+START_SECTION((explicit BinnedSpectrumBlock(const std::vector<BinnedSpectrum>& spectra)))
+{
+  TEST_EQUAL(block.size(), 3)
+  TEST_EQUAL(block.empty(), false)
+
+  vector<BinnedSpectrum> incompatible = spectra;
+  incompatible.push_back(BinnedSpectrum(s1, 2.0, false, 0, 0.0));
+  TEST_EXCEPTION(Exception::IllegalArgument, BinnedSpectrumBlock dummy(incompatible))
+}
+END_SECTION
+
+START_SECTION((Size size() const))
+{
+  TEST_EQUAL(block.size(), 3)
+}
+END_SECTION
+
+START_SECTION((bool empty() const))
+{
+  TEST_EQUAL(block.empty(), false)
+  TEST_EQUAL(BinnedSpectrumBlock(vector<BinnedSpectrum>()).empty(), true)
+}
+END_SECTION
+
+START_SECTION((Size nonZeros() const))
+{
+  TEST_EQUAL(block.nonZeros(), 3)
+}
+END_SECTION
+
+START_SECTION((bool isCompatible(const BinnedSpectrum& spec) const))
+{
+  TEST_EQUAL(block.isCompatible(BinnedSpectrum(s2, 1.0, false, 2, 0.0)), true)
+  TEST_EQUAL(block.isCompatible(BinnedSpectrum(s2, 1.0, false, 0, 0.4)), false)
+  TEST_EQUAL(BinnedSpectrumBlock().isCompatible(BinnedSpectrum(s2, 1.0, false, 0, 0.4)), true)
+}
+END_SECTION
+
+START_SECTION((const std::vector<Size>& getRowOffsets() const))
+{
+  ABORT_IF(block.getRowOffsets().size() != 4)
+  TEST_EQUAL(block.getRowOffsets()[0], 0)
+  TEST_EQUAL(block.getRowOffsets()[1], 2)
+  TEST_EQUAL(block.getRowOffsets()[2], 3)
+  TEST_EQUAL(block.getRowOffsets()[3], 3)
+}
+END_SECTION
+
+START_SECTION((const std::vector<BinIndex>& getBinIndices() const))
+{
+  ABORT_IF(block.getBinIndices().size() != 3)
+  TEST_EQUAL(block.getBinIndices()[0], 100)
+  TEST_EQUAL(block.getBinIndices()[1], 105)
+  TEST_EQUAL(block.getBinIndices()[2], 102)
+}
+END_SECTION
+
+START_SECTION((const std::vector<float>& getIntensities() const))
+{
+  ABORT_IF(block.getIntensities().size() != 3)
+  TEST_REAL_SIMILAR(block.getIntensities()[0], 2.0)
+  TEST_REAL_SIMILAR(block.getIntensities()[1], 1.0)
+  TEST_REAL_SIMILAR(block.getIntensities()[2], 3.0)
+}
+END_SECTION
+
+START_SECTION((BinIndex getFirstBin() const))
+{
+  TEST_EQUAL(block.getFirstBin(), 100)
+}
+END_SECTION
+
+START_SECTION((BinIndex getLastBin() const))
+{
+  TEST_EQUAL(block.getLastBin(), 105)
+}
+END_SECTION
+
+START_SECTION((float getSum(Size index) const))
+{
+  TEST_REAL_SIMILAR(block.getSum(0), 3.0)
+  TEST_REAL_SIMILAR(block.getSum(1), 3.0)
+  TEST_REAL_SIMILAR(block.getSum(2), 0.0)
+}
+END_SECTION
+
+START_SECTION((float getSquaredNorm(Size index) const))
+{
+  TEST_REAL_SIMILAR(block.getSquaredNorm(0), 5.0)
+  TEST_REAL_SIMILAR(block.getSquaredNorm(1), 9.0)
+  TEST_REAL_SIMILAR(block.getSquaredNorm(2), 0.0)
+}
+END_SECTION
+
+START_SECTION((BinnedSpectrum getSpectrum(Size index) const))
+{
+  TEST_EQUAL(block.getSpectrum(0) == spectra[0], true)
+  TEST_EQUAL(block.getSpectrum(1) == spectra[1], true)
+  TEST_EQUAL(block.getSpectrum(2).getBins().nonZeros(), 0)
+  TEST_EXCEPTION(Exception::IndexOverflow, block.getSpectrum(3))
+}
+END_SECTION
+
+START_SECTION((void createDenseWindow()))
+{
+  TEST_EQUAL(block.hasDenseWindow(), false)
+  block.createDenseWindow();
+  TEST_EQUAL(block.hasDenseWindow(), true)
+  const BinnedSpectrumBlock::DenseMatrixType& dense = block.getDenseWindow();
+  TEST_EQUAL(dense.rows(), 3)
+  TEST_EQUAL(dense.cols(), 6)
+  TEST_REAL_SIMILAR(dense(0, 0), 2.0)
+  TEST_REAL_SIMILAR(dense(0, 5), 1.0)
+  TEST_REAL_SIMILAR(dense(1, 2), 3.0)
+  TEST_REAL_SIMILAR(dense.sum(), 6.0)
+}
+END_SECTION
+
+START_SECTION((bool hasDenseWindow() const))
+{
+  TEST_EQUAL(block.hasDenseWindow(), true)
+  TEST_EQUAL(BinnedSpectrumBlock().hasDenseWindow(), false)
+}
+END_SECTION
+
+START_SECTION((const DenseMatrixType& getDenseWindow() const))
+{
+  TEST_EQUAL(block.getDenseWindow().size(), 18)
+}
+END_SECTION
+
+START_SECTION((void clearDenseWindow()))
+{
+  block.clearDenseWindow();
+  TEST_EQUAL(block.hasDenseWindow(), false)
+  TEST_EQUAL(block.getDenseWindow().size(), 0)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
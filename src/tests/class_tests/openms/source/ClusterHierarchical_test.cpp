@@ -163,6 +163,31 @@ class LowlevelComparator
 
 #pragma clang diagnostic pop
 
+struct RTMZPoint
+{
+  double rt;
+  double mz;
+  double getRT() const { return rt; }
+  double getMZ() const { return mz; }
+};
+
+// similarity is 0 outside of 5 s and 0.5 Th
+class BoundedComparator
+{
+ public:
+ double operator()(const RTMZPoint& first, const RTMZPoint& second) const
+ {
+  double rt_diff = fabs(first.rt - second.rt);
+  if (rt_diff > 5.0 || fabs(first.mz - second.mz) > 0.5) return 0;
+  return 1 - rt_diff / 10.0;
+ }
+
+ DPosition<2> getBoundingTolerance() const
+ {
+  return DPosition<2>(5.0, 0.5);
+ }
+};
+
 START_TEST(ClusterHierarchical, "$Id$")
 
 /////////////////////////////////////////////////////////////
@@ -240,6 +265,76 @@ START_SECTION((template <typename Data, typename SimilarityComparator> void clus
 }
 END_SECTION
 
+START_SECTION((template <typename Data, typename SimilarityComparator> void cluster(const std::vector< Data > &data, const SimilarityComparator &comparator, const ClusterFunctor &clusterer, std::vector<BinaryTreeNode>& cluster_tree, SparseDistanceMatrix& distance)))
+{
+ vector<Size> d(6,0);
+ for (Size i = 0; i<d.size(); ++i)
+ {
+  d[i]=i;
+ }
+ ClusterHierarchical ch;
+ LowlevelComparator lc;
+ SingleLinkage sl;
+ vector< BinaryTreeNode > result;
+ vector< BinaryTreeNode > tree;
+ tree.push_back(BinaryTreeNode(1,2,0.3f));
+ tree.push_back(BinaryTreeNode(3,4,0.4f));
+ tree.push_back(BinaryTreeNode(0,1,0.5f));
+ tree.push_back(BinaryTreeNode(0,3,0.6f));
+ tree.push_back(BinaryTreeNode(0,5,0.7f));
+ SparseDistanceMatrix matrix;
+
+ ch.cluster<Size,LowlevelComparator>(d,lc,sl,result, matrix);
+
+ TEST_EQUAL(matrix.dimensionsize(), 6)
+ TEST_EQUAL(matrix.size(), 15)
+ TEST_EQUAL(tree.size(), result.size());
+ for (Size i = 0; i < tree.size(); ++i)
+ {
+   TOLERANCE_ABSOLUTE(0.0001);
+   TEST_EQUAL(tree[i].left_child, result[i].left_child);
+   TEST_EQUAL(tree[i].right_child, result[i].right_child);
+   TEST_REAL_SIMILAR(tree[i].distance, result[i].distance);
+ }
+
+ // only pairs below the threshold are stored
+ ch.setThreshold(0.55);
+ SparseDistanceMatrix thresholded;
+ result.clear();
+ ch.cluster<Size,LowlevelComparator>(d,lc,sl,result, thresholded);
+ TEST_EQUAL(thresholded.size(), 3)
+ TEST_EQUAL(result.size(), 5)
+ TEST_REAL_SIMILAR(result[2].distance, 0.5)
+ TEST_REAL_SIMILAR(result[3].distance, -1.0)
+
+ // comparator with bounding tolerance: only neighbouring pairs are compared
+ vector<RTMZPoint> points;
+ points.push_back(RTMZPoint{10.0, 100.0});
+ points.push_back(RTMZPoint{12.0, 100.2});
+ points.push_back(RTMZPoint{50.0, 100.0});
+ points.push_back(RTMZPoint{51.0, 300.0});
+ points.push_back(RTMZPoint{11.0, 100.1});
+ ClusterHierarchical ch2;
+ BoundedComparator bc;
+ SparseDistanceMatrix bounded;
+ result.clear();
+ ch2.cluster(points, bc, sl, result, bounded);
+ TEST_EQUAL(bounded.size(), 3)
+ TEST_REAL_SIMILAR(bounded.getValue(0, 1), 0.2)
+ TEST_REAL_SIMILAR(bounded.getValue(1, 4), 0.1)
+ TEST_REAL_SIMILAR(bounded.getValue(2, 3), 1.0)
+ TEST_EQUAL(result.size(), 4)
+ TEST_EQUAL(result[0].left_child, 0)
+ TEST_EQUAL(result[0].right_child, 4)
+ TEST_REAL_SIMILAR(result[0].distance, 0.1)
+ TEST_EQUAL(result[1].left_child, 0)
+ TEST_EQUAL(result[1].right_child, 1)
+ TEST_REAL_SIMILAR(result[1].distance, 0.1)
+ TEST_REAL_SIMILAR(result[2].distance, -1.0)
+ TEST_REAL_SIMILAR(result[3].distance, -1.0)
+}
+END_SECTION
+
 START_SECTION((void cluster(std::vector<PeakSpectrum>& data, const BinnedSpectrumCompareFunctor& comparator, double sz, UInt sp, const ClusterFunctor& clusterer, std::vector<BinaryTreeNode>& cluster_tree, DistanceMatrix<float>& original_distance)))
 {
 
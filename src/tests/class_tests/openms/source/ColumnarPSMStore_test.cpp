@@ -0,0 +1,264 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+
+///////////////////////////
+#include <OpenMS/METADATA/ColumnarPSMStore.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(ColumnarPSMStore, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+// test data: two spectra, the second one with two hits
+vector<PeptideIdentification> peptide_ids(3);
+peptide_ids[0].setIdentifier("run1");
+peptide_ids[0].setScoreType("XTandem");
+peptide_ids[0].setHigherScoreBetter(true);
+peptide_ids[0].setRT(100.5);
+peptide_ids[0].setMZ(500.25);
+peptide_ids[0].setMetaValue("spectrum_reference", "scan=1");
+{
+  PeptideHit hit(10.0, 1, 2, AASequence::fromString("PEPTIDER"));
+  hit.addPeptideEvidence(PeptideEvidence("PROT1", 10, 17, 'K', 'A'));
+  hit.addPeptideEvidence(PeptideEvidence("PROT2", 0, 7, '[', 'G'));
+  hit.setMetaValue("target_decoy", "target");
+  hit.setMetaValue("some_int", 5);
+  peptide_ids[0].insertHit(hit);
+}
+peptide_ids[1].setIdentifier("run1");
+peptide_ids[1].setScoreType("XTandem");
+peptide_ids[1].setHigherScoreBetter(true);
+peptide_ids[1].setRT(200.5);
+peptide_ids[1].setMZ(600.25);
+peptide_ids[1].setMetaValue("spectrum_reference", "scan=2");
+{
+  PeptideHit hit(5.0, 2, 2, AASequence::fromString("DECOYK"));
+  hit.addPeptideEvidence(PeptideEvidence("DECOY_PROT1", 3, 8, 'R', 'A'));
+  hit.setMetaValue("target_decoy", "decoy");
+  hit.setMetaValue("some_int", "not an int"); // mixed column types
+  peptide_ids[1].insertHit(hit);
+  PeptideHit hit2(20.0, 1, 3, AASequence::fromString("PEPTIDER"));
+  hit2.addPeptideEvidence(PeptideEvidence("PROT1", 10, 17, 'K', 'A'));
+  hit2.setMetaValue("target_decoy", "target");
+  hit2.setMetaValue("some_double", 1.5);
+  peptide_ids[1].insertHit(hit2);
+}
+peptide_ids[2].setIdentifier("run1"); // no hits
+
+ColumnarPSMStore* ptr = nullptr;
+ColumnarPSMStore* null_ptr = nullptr;
+START_SECTION(ColumnarPSMStore())
+{
+  ptr = new ColumnarPSMStore();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_EQUAL(ptr->getNumberOfHits(), 0)
+  TEST_EQUAL(ptr->empty(), true)
+}
+END_SECTION
+
+START_SECTION(~ColumnarPSMStore())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((explicit ColumnarPSMStore(const std::vector<PeptideIdentification>& peptide_ids)))
+{
+  ColumnarPSMStore psms(peptide_ids);
+  TEST_EQUAL(psms.size(), 3)
+  TEST_EQUAL(psms.getNumberOfHits(), 3)
+  TEST_EQUAL(psms.getNumberOfSequences(), 2) // "PEPTIDER" is stored once
+  TEST_EQUAL(psms.getHitBegin(1), 1)
+  TEST_EQUAL(psms.getHitEnd(1), 3)
+  TEST_EQUAL(psms.getHitBegin(2), psms.getHitEnd(2))
+}
+END_SECTION
+
+START_SECTION((void toPeptideIdentifications(std::vector<PeptideIdentification>& peptide_ids) const))
+{
+  ColumnarPSMStore psms(peptide_ids);
+  vector<PeptideIdentification> result;
+  psms.toPeptideIdentifications(result);
+  TEST_EQUAL(result.size(), peptide_ids.size())
+  for (Size i = 0; i < result.size(); ++i)
+  {
+    TEST_EQUAL(result[i] == peptide_ids[i], true)
+  }
+  ABORT_IF(result.size() != 3)
+  TEST_EQUAL(result[1].getHits()[0].getMetaValue("some_int"), "not an int")
+  TEST_EQUAL(result[0].getHits()[0].getPeptideEvidences().size(), 2)
+}
+END_SECTION
+
+START_SECTION((PeptideIdentification getPeptideIdentification(Size id_index) const))
+{
+  ColumnarPSMStore psms(peptide_ids);
+  TEST_EQUAL(psms.getPeptideIdentification(1) == peptide_ids[1], true)
+}
+END_SECTION
+
+START_SECTION((PeptideHit getPeptideHit(Size hit_index) const))
+{
+  ColumnarPSMStore psms(peptide_ids);
+  TEST_EQUAL(psms.getPeptideHit(2) == peptide_ids[1].getHits()[1], true)
+}
+END_SECTION
+
+START_SECTION((void push_back(const PeptideIdentification& peptide_id)))
+{
+  ColumnarPSMStore psms;
+  psms.push_back(peptide_ids[0]);
+  psms.push_back(peptide_ids[1]);
+  TEST_EQUAL(psms.size(), 2)
+  TEST_EQUAL(psms.getNumberOfHits(), 3)
+  TEST_EQUAL(psms.getHitMetaValue(0, "some_int"), 5)
+  TEST_EQUAL(psms.getHitMetaValue(2, "some_double").isEmpty(), false)
+  TEST_EQUAL(psms.getHitMetaValue(0, "some_double").isEmpty(), true)
+}
+END_SECTION
+
+START_SECTION((Size getIdentificationIndex(Size hit_index) const))
+{
+  ColumnarPSMStore psms(peptide_ids);
+  TEST_EQUAL(psms.getIdentificationIndex(0), 0)
+  TEST_EQUAL(psms.getIdentificationIndex(1), 1)
+  TEST_EQUAL(psms.getIdentificationIndex(2), 1)
+}
+END_SECTION
+
+START_SECTION((identification and hit accessors))
+{
+  ColumnarPSMStore psms(peptide_ids);
+  TEST_REAL_SIMILAR(psms.getRT(0), 100.5)
+  TEST_REAL_SIMILAR(psms.getMZ(1), 600.25)
+  TEST_EQUAL(psms.getIdentifier(1), "run1")
+  TEST_EQUAL(psms.getScoreType(0), "XTandem")
+  TEST_EQUAL(psms.isHigherScoreBetter(0), true)
+  TEST_EQUAL(psms.getIdentificationMetaValue(1, "spectrum_reference"), "scan=2")
+  TEST_EQUAL(psms.getSequence(2).toString(), "PEPTIDER")
+  TEST_REAL_SIMILAR(psms.getScore(1), 5.0)
+  TEST_EQUAL(psms.getRank(1), 2)
+  TEST_EQUAL(psms.getCharge(2), 3)
+  TEST_EQUAL(psms.getPeptideEvidences(0).size(), 2)
+  TEST_EQUAL(psms.getPeptideEvidences(0)[1].getProteinAccession(), "PROT2")
+
+  psms.setScore(1, 7.0);
+  TEST_REAL_SIMILAR(psms.getScore(1), 7.0)
+  psms.setScoreType(0, "q-value");
+  TEST_EQUAL(psms.getScoreType(0), "q-value")
+  TEST_EQUAL(psms.getScoreType(1), "XTandem")
+}
+END_SECTION
+
+START_SECTION((void setHitMetaValue(Size hit_index, const String& name, const DataValue& value)))
+{
+  ColumnarPSMStore psms(peptide_ids);
+  psms.setHitMetaValue(1, "new_value", 3.5);
+  TEST_EQUAL(psms.hitMetaValueExists(1, "new_value"), true)
+  TEST_EQUAL(psms.hitMetaValueExists(0, "new_value"), false)
+  TEST_REAL_SIMILAR(psms.getHitMetaValue(1, "new_value"), 3.5)
+  psms.setHitMetaValue(0, "new_value", "string"); // converts the column to generic storage
+  TEST_EQUAL(psms.getHitMetaValue(0, "new_value"), "string")
+  TEST_REAL_SIMILAR(psms.getHitMetaValue(1, "new_value"), 3.5)
+  psms.removeHitMetaValue(1, MetaInfoInterface::metaRegistry().getIndex("new_value"));
+  TEST_EQUAL(psms.hitMetaValueExists(1, "new_value"), false)
+}
+END_SECTION
+
+START_SECTION((void filterHits(const std::vector<bool>& keep)))
+{
+  ColumnarPSMStore psms(peptide_ids);
+  vector<bool> keep(3, true);
+  keep[1] = false;
+  psms.filterHits(keep);
+  TEST_EQUAL(psms.size(), 3)
+  TEST_EQUAL(psms.getNumberOfHits(), 2)
+  TEST_EQUAL(psms.getHitEnd(1) - psms.getHitBegin(1), 1)
+  TEST_EQUAL(psms.getHitMetaValue(1, "some_double").isEmpty(), false)
+  TEST_EQUAL(psms.getPeptideEvidences(1)[0].getProteinAccession(), "PROT1")
+  TEST_EXCEPTION(Exception::InvalidSize, psms.filterHits(vector<bool>(5, true)))
+}
+END_SECTION
+
+START_SECTION((void sortHits()))
+{
+  ColumnarPSMStore psms(peptide_ids);
+  psms.sortHits();
+  TEST_REAL_SIMILAR(psms.getScore(1), 20.0)
+  TEST_REAL_SIMILAR(psms.getScore(2), 5.0)
+  TEST_EQUAL(psms.getHitMetaValue(2, "target_decoy"), "decoy")
+  TEST_EQUAL(psms.getPeptideEvidences(2)[0].getProteinAccession(), "DECOY_PROT1")
+}
+END_SECTION
+
+START_SECTION((void assignRanks()))
+{
+  ColumnarPSMStore psms(peptide_ids);
+  psms.setRank(1, 5);
+  psms.assignRanks();
+  TEST_EQUAL(psms.getRank(0), 1)
+  TEST_EQUAL(psms.getRank(1), 1)
+  TEST_EQUAL(psms.getRank(2), 2)
+}
+END_SECTION
+
+START_SECTION((void removeEmptyIdentifications()))
+{
+  ColumnarPSMStore psms(peptide_ids);
+  psms.removeEmptyIdentifications();
+  TEST_EQUAL(psms.size(), 2)
+  TEST_EQUAL(psms.getIdentificationMetaValue(1, "spectrum_reference"), "scan=2")
+}
+END_SECTION
+
+START_SECTION((void clear()))
+{
+  ColumnarPSMStore psms(peptide_ids);
+  psms.clear();
+  TEST_EQUAL(psms.empty(), true)
+  TEST_EQUAL(psms.getNumberOfHits(), 0)
+  TEST_EQUAL(psms.getNumberOfSequences(), 0)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
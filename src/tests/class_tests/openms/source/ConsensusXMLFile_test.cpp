@@ -45,6 +45,10 @@
 
 #include <OpenMS/DATASTRUCTURES/ListUtils.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace OpenMS;
 using namespace std;
 
@@ -225,6 +229,53 @@ START_SECTION((void store(const String &filename, const ConsensusMap &consensus_
   WHITELIST("?xml-stylesheet")
   TEST_FILE_SIMILAR(OPENMS_GET_TEST_DATA_PATH("ConsensusXMLFile_1.consensusXML"), tmp_filename)
 
+  // many consensus elements (rendered in parallel blocks) give the same output as a serial run:
+  ConsensusMap large;
+  large.getColumnHeaders()[0].filename = "a.featureXML";
+  large.getColumnHeaders()[0].size = 20000;
+  large.getColumnHeaders()[1].filename = "b.featureXML";
+  large.getColumnHeaders()[1].size = 20000;
+  for (Size i = 0; i < 20000; ++i)
+  {
+    ConsensusFeature cf;
+    cf.setRT(i * 0.5);
+    cf.setMZ(400.0 + i * 0.001);
+    cf.setIntensity(100.0 + i);
+    cf.setCharge(i % 4 + 1);
+    cf.setUniqueId(i + 1);
+    FeatureHandle h0(0, Peak2D(Peak2D::PositionType(i * 0.5, 400.0 + i * 0.001), 50.0 + i), i);
+    FeatureHandle h1(1, Peak2D(Peak2D::PositionType(i * 0.5 + 0.1, 400.0 + i * 0.001), 50.0), i);
+    cf.insert(h0);
+    cf.insert(h1);
+    large.push_back(cf);
+  }
+  std::string parallel_filename, serial_filename;
+  NEW_TMP_FILE(parallel_filename);
+  f.store(parallel_filename, large);
+#ifdef _OPENMP
+  const int max_threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+  NEW_TMP_FILE(serial_filename);
+  f.store(serial_filename, large);
+#ifdef _OPENMP
+  omp_set_num_threads(max_threads);
+#endif
+  TEST_FILE_EQUAL(parallel_filename, serial_filename)
+
+  ConsensusMap large_in;
+  f.load(parallel_filename, large_in);
+  TEST_EQUAL(large_in.size(), large.size())
+  ABORT_IF(large_in.size() != large.size())
+  bool same_order = true;
+  for (Size i = 0; i < large.size(); ++i)
+  {
+    same_order &= (large_in[i].getUniqueId() == large[i].getUniqueId());
+    same_order &= (large_in[i].size() == 2);
+  }
+  TEST_EQUAL(same_order, true)
+  TEST_REAL_SIMILAR(large_in.back().getRT(), large.back().getRT())
+  TEST_REAL_SIMILAR(large_in.back().begin()->getIntensity(), 50.0 + 19999)
 
 END_SECTION
 
@@ -230,6 +230,39 @@ START_SECTION((void load(const String &filename, FeatureMap&feature_map)))
 }
 END_SECTION
 
+START_SECTION((void transform(const String& filename, FeatureMap& feature_map, const std::function<void(Feature&)>& consumer)))
+{
+  FeatureXMLFile f;
+  FeatureMap full, meta;
+  f.load(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_1.featureXML"), full);
+
+  vector<Feature> consumed;
+  f.transform(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_1.featureXML"), meta,
+              [&consumed](Feature& feature) { consumed.push_back(feature); });
+  TEST_EQUAL(meta.size(), 0)
+  TEST_EQUAL(meta.getIdentifier(), "lsid")
+  TEST_EQUAL(meta.getDataProcessing().size(), 2)
+  TEST_EQUAL(meta.getProteinIdentifications().size(), 2)
+  TEST_EQUAL(meta.getUnassignedPeptideIdentifications().size(), 2)
+  TEST_EQUAL(consumed.size(), full.size())
+  ABORT_IF(consumed.size() != full.size())
+  for (Size i = 0; i < consumed.size(); ++i)
+  {
+    TEST_EQUAL(consumed[i] == full[i], true)
+  }
+
+  // range restrictions are applied:
+  consumed.clear();
+  f.getOptions().setRTRange(makeRange(0, 10));
+  f.transform(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_1.featureXML"), meta,
+              [&consumed](Feature& feature) { consumed.push_back(feature); });
+  TEST_EQUAL(consumed.size(), 1)
+  TEST_REAL_SIMILAR(consumed[0].getMZ(), 35)
+
+  TEST_EXCEPTION(Exception::FileNotFound, f.transform("dummy/dummy.featureXML", meta, [](Feature&) {}))
+}
+END_SECTION
+
 START_SECTION((void store(const String &filename, const FeatureMap&feature_map)))
 {
   FeatureMap map;
@@ -241,6 +274,31 @@ START_SECTION((void store(const String &filename, const FeatureMap&feature_map))
   f.store(tmp_filename, map);
   WHITELIST("?xml-stylesheet")
   TEST_FILE_SIMILAR(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_1.featureXML"), tmp_filename)
+
+  // many features (rendered in parallel blocks) are written in order:
+  FeatureMap large;
+  for (Size i = 0; i < 20000; ++i)
+  {
+    Feature feature;
+    feature.setRT(i * 0.5);
+    feature.setMZ(400.0 + i * 0.001);
+    feature.setIntensity(100.0 + i);
+    feature.setUniqueId(i + 1);
+    large.push_back(feature);
+  }
+  NEW_TMP_FILE(tmp_filename);
+  f.store(tmp_filename, large);
+  FeatureMap large_in;
+  f.load(tmp_filename, large_in);
+  TEST_EQUAL(large_in.size(), large.size())
+  ABORT_IF(large_in.size() != large.size())
+  bool same_order = true;
+  for (Size i = 0; i < large.size(); ++i)
+  {
+    same_order &= (large_in[i].getUniqueId() == large[i].getUniqueId());
+  }
+  TEST_EQUAL(same_order, true)
+  TEST_REAL_SIMILAR(large_in.back().getRT(), large.back().getRT())
 }
 END_SECTION
 
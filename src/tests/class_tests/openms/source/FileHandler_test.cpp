@@ -43,6 +43,9 @@
 #include <OpenMS/KERNEL/FeatureMap.h>
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/FORMAT/IdBinaryFile.h>
+#include <OpenMS/METADATA/PeptideIdentification.h>
+#include <OpenMS/METADATA/ProteinIdentification.h>
 
 START_TEST(FileHandler, "$Id$")
 
@@ -256,6 +259,47 @@ TEST_EQUAL(fh.getTypeByContent(filename), FileTypes::MZML)
 //other types cannot be tested, because the NEW_TMP_FILE template does not support file extensions...
 END_SECTION
 
+START_SECTION((bool loadIdentifications(const String& filename, std::vector<ProteinIdentification>& protein_ids, std::vector<PeptideIdentification>& peptide_ids, FileTypes::Type force_type = FileTypes::UNKNOWN)))
+FileHandler fh;
+vector<ProteinIdentification> proteins;
+vector<PeptideIdentification> peptides;
+TEST_EQUAL(fh.loadIdentifications("test.bla", proteins, peptides), false)
+TEST_EQUAL(fh.loadIdentifications(OPENMS_GET_TEST_DATA_PATH("IdXMLFile_whole.idXML"), proteins, peptides), true)
+TEST_EQUAL(proteins.size(), 2)
+TEST_EQUAL(peptides.size(), 3)
+
+// idBin (detected by content)
+String filename;
+NEW_TMP_FILE(filename)
+IdBinaryFile().store(filename, proteins, peptides);
+TEST_EQUAL(fh.getTypeByContent(filename), FileTypes::IDBIN)
+vector<ProteinIdentification> proteins2;
+vector<PeptideIdentification> peptides2;
+TEST_EQUAL(fh.loadIdentifications(filename, proteins2, peptides2), true)
+TEST_EQUAL(proteins2 == proteins, true)
+TEST_EQUAL(peptides2 == peptides, true)
+END_SECTION
+
+START_SECTION((void storeIdentifications(const String& filename, const std::vector<ProteinIdentification>& protein_ids, const std::vector<PeptideIdentification>& peptide_ids, FileTypes::Type force_type = FileTypes::UNKNOWN)))
+FileHandler fh;
+vector<ProteinIdentification> proteins;
+vector<PeptideIdentification> peptides;
+fh.loadIdentifications(OPENMS_GET_TEST_DATA_PATH("IdXMLFile_whole.idXML"), proteins, peptides);
+
+// the type cannot be determined from the extension of a temporary file
+String filename;
+NEW_TMP_FILE(filename)
+TEST_EXCEPTION(Exception::InvalidParameter, fh.storeIdentifications(filename, proteins, peptides))
+TEST_EXCEPTION(Exception::InvalidParameter, fh.storeIdentifications(filename, proteins, peptides, FileTypes::FEATUREXML))
+
+fh.storeIdentifications(filename, proteins, peptides, FileTypes::IDXML);
+TEST_EQUAL(fh.getTypeByContent(filename), FileTypes::IDXML)
+
+NEW_TMP_FILE(filename)
+fh.storeIdentifications(filename, proteins, peptides, FileTypes::IDBIN);
+TEST_EQUAL(fh.getTypeByContent(filename), FileTypes::IDBIN)
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
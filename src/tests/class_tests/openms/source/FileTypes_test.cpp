@@ -60,6 +60,7 @@ START_SECTION((static String typeToName(Type type)))
   TEST_EQUAL(FileTypes::typeToName(FileTypes::MZML), "mzML");
   TEST_EQUAL(FileTypes::typeToName(FileTypes::FEATUREXML), "featureXML");
   TEST_EQUAL(FileTypes::typeToName(FileTypes::IDXML), "idXML");
+  TEST_EQUAL(FileTypes::typeToName(FileTypes::IDBIN), "idBin");
   TEST_EQUAL(FileTypes::typeToName(FileTypes::CONSENSUSXML), "consensusXML");
   TEST_EQUAL(FileTypes::typeToName(FileTypes::TRANSFORMATIONXML), "trafoXML");
   TEST_EQUAL(FileTypes::typeToName(FileTypes::INI), "ini");
@@ -79,6 +80,7 @@ START_SECTION((static Type nameToType(const String &name)))
   TEST_EQUAL(FileTypes::MZXML, FileTypes::nameToType("mzXML"));
   TEST_EQUAL(FileTypes::FEATUREXML, FileTypes::nameToType("featureXML"));
   TEST_EQUAL(FileTypes::IDXML, FileTypes::nameToType("idXmL")); // case-insensitivity
+  TEST_EQUAL(FileTypes::IDBIN, FileTypes::nameToType("idBin"));
   TEST_EQUAL(FileTypes::CONSENSUSXML, FileTypes::nameToType("consensusXML"));
   TEST_EQUAL(FileTypes::MGF, FileTypes::nameToType("mgf"));
   TEST_EQUAL(FileTypes::INI, FileTypes::nameToType("ini"));
@@ -1007,6 +1007,57 @@ START_SECTION((template<class PeakT> static void keepHitsMatchingProteins(MSExpe
 }
 END_SECTION
 
+START_SECTION((static void filterHitsByScore(ColumnarPSMStore& psms, double threshold_score)))
+{
+  vector<PeptideIdentification> peptides = global_peptides;
+  IDFilter::filterHitsByScore(peptides, 33);
+  ColumnarPSMStore psms(global_peptides);
+  IDFilter::filterHitsByScore(psms, 33);
+  TEST_EQUAL(psms.getNumberOfHits(), 5);
+  TEST_EQUAL(psms.getPeptideIdentification(0) == peptides[0], true);
+}
+END_SECTION
+
+START_SECTION((static void keepNBestHits(ColumnarPSMStore& psms, Size n)))
+{
+  vector<PeptideIdentification> peptides = global_peptides;
+  IDFilter::keepNBestHits(peptides, 3);
+  ColumnarPSMStore psms(global_peptides);
+  IDFilter::keepNBestHits(psms, 3);
+  TEST_EQUAL(psms.getNumberOfHits(), 3);
+  TEST_EQUAL(psms.getPeptideIdentification(0) == peptides[0], true);
+}
+END_SECTION
+
+START_SECTION((static void removeDecoyHits(ColumnarPSMStore& psms)))
+{
+  vector<PeptideIdentification> peptides(1);
+  peptides[0].getHits().resize(5);
+  peptides[0].getHits()[0].setMetaValue("target_decoy", "target");
+  peptides[0].getHits()[1].setMetaValue("target_decoy", "decoy");
+  // no meta value on hit 2
+  peptides[0].getHits()[3].setMetaValue("isDecoy", "true");
+  peptides[0].getHits()[4].setMetaValue("isDecoy", "false");
+  ColumnarPSMStore psms(peptides);
+  IDFilter::removeDecoyHits(psms);
+  TEST_EQUAL(psms.getNumberOfHits(), 3);
+  TEST_EQUAL(psms.getHitMetaValue(0, "target_decoy"), "target");
+  TEST_EQUAL(psms.hitMetaValueExists(1, "target_decoy"), false);
+  TEST_EQUAL(psms.hitMetaValueExists(1, "isDecoy"), false);
+  TEST_EQUAL(psms.getHitMetaValue(2, "isDecoy"), "false");
+}
+END_SECTION
+
+START_SECTION((static void removeEmptyIdentifications(ColumnarPSMStore& psms)))
+{
+  vector<PeptideIdentification> peptides = global_peptides;
+  peptides.resize(3); // two empty IDs
+  ColumnarPSMStore psms(peptides);
+  IDFilter::removeEmptyIdentifications(psms);
+  TEST_EQUAL(psms.size(), 1);
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 
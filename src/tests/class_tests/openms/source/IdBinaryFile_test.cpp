@@ -0,0 +1,285 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+
+#include <OpenMS/FORMAT/IdBinaryFile.h>
+#include <OpenMS/FORMAT/IdXMLFile.h>
+
+///////////////////////////
+
+START_TEST(IdBinaryFile, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+vector<ProteinIdentification> ref_proteins;
+vector<PeptideIdentification> ref_peptides;
+IdXMLFile().load(OPENMS_GET_TEST_DATA_PATH("IdXMLFile_whole.idXML"), ref_proteins, ref_peptides);
+// add some data that is not covered by the idXML test file:
+ref_peptides[0].getHits()[0].setMetaValue("int_list", IntList(3, 7));
+ref_peptides[0].getHits()[0].setMetaValue("double_list", DoubleList(2, 0.5));
+PeptideHit::PeakAnnotation annotation;
+annotation.annotation = "y3";
+annotation.charge = 1;
+annotation.mz = 375.2;
+annotation.intensity = 100.0;
+ref_peptides[1].getHits()[1].setPeakAnnotations(vector<PeptideHit::PeakAnnotation>(1, annotation));
+PeptideHit::PepXMLAnalysisResult analysis_result;
+analysis_result.score_type = "peptideprophet";
+analysis_result.higher_is_better = true;
+analysis_result.main_score = 0.95;
+analysis_result.sub_scores["fval"] = 1.25;
+ref_peptides[2].getHits()[0].addAnalysisResults(analysis_result);
+
+IdBinaryFile* ptr = nullptr;
+IdBinaryFile* null_ptr = nullptr;
+START_SECTION((IdBinaryFile()))
+{
+  ptr = new IdBinaryFile();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->getCompression(), false)
+}
+END_SECTION
+
+START_SECTION((~IdBinaryFile()))
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((void setCompression(bool compress)))
+{
+  IdBinaryFile file;
+  file.setCompression(true);
+  TEST_EQUAL(file.getCompression(), true)
+}
+END_SECTION
+
+START_SECTION((bool getCompression() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((void store(const String& filename, const std::vector<ProteinIdentification>& protein_ids, const std::vector<PeptideIdentification>& peptide_ids)))
+{
+  String filename;
+  NEW_TMP_FILE(filename);
+  IdBinaryFile().store(filename, ref_proteins, ref_peptides);
+  TEST_EQUAL(IdBinaryFile::isIdBinaryFile(filename), true)
+
+  // empty data
+  NEW_TMP_FILE(filename);
+  IdBinaryFile().store(filename, vector<ProteinIdentification>(), vector<PeptideIdentification>());
+  vector<ProteinIdentification> proteins(1);
+  vector<PeptideIdentification> peptides(1);
+  IdBinaryFile().load(filename, proteins, peptides);
+  TEST_EQUAL(proteins.size(), 0)
+  TEST_EQUAL(peptides.size(), 0)
+}
+END_SECTION
+
+START_SECTION((void load(const String& filename, std::vector<ProteinIdentification>& protein_ids, std::vector<PeptideIdentification>& peptide_ids)))
+{
+  for (Size compress = 0; compress < 2; ++compress)
+  {
+    String filename;
+    NEW_TMP_FILE(filename);
+    IdBinaryFile file;
+    file.setCompression(compress == 1);
+    file.store(filename, ref_proteins, ref_peptides);
+
+    vector<ProteinIdentification> proteins;
+    vector<PeptideIdentification> peptides;
+    file.load(filename, proteins, peptides);
+    TEST_EQUAL(proteins.size(), ref_proteins.size())
+    TEST_EQUAL(peptides.size(), ref_peptides.size())
+    ABORT_IF(peptides.size() != ref_peptides.size())
+    TEST_EQUAL(proteins == ref_proteins, true)
+    for (Size i = 0; i < peptides.size(); ++i)
+    {
+      TEST_EQUAL(peptides[i] == ref_peptides[i], true)
+    }
+    TEST_EQUAL(peptides[0].getHits()[0].getMetaValue("int_list").toIntList().size(), 3)
+    TEST_EQUAL(peptides[1].getHits()[1].getPeakAnnotations().size(), 1)
+    TEST_EQUAL(peptides[2].getHits()[0].getAnalysisResults().size(), 1)
+  }
+
+  vector<ProteinIdentification> proteins;
+  vector<PeptideIdentification> peptides;
+  TEST_EXCEPTION(Exception::FileNotFound, IdBinaryFile().load("this_file_does_not_exist.idBin", proteins, peptides))
+  TEST_EXCEPTION(Exception::ParseError, IdBinaryFile().load(OPENMS_GET_TEST_DATA_PATH("IdXMLFile_whole.idXML"), proteins, peptides))
+}
+END_SECTION
+
+START_SECTION((void store(const String& filename, const std::vector<ProteinIdentification>& protein_ids, const ColumnarPSMStore& psms)))
+{
+  String filename;
+  NEW_TMP_FILE(filename);
+  IdBinaryFile().store(filename, ref_proteins, ColumnarPSMStore(ref_peptides));
+  vector<ProteinIdentification> proteins;
+  vector<PeptideIdentification> peptides;
+  IdBinaryFile().load(filename, proteins, peptides);
+  TEST_EQUAL(peptides == ref_peptides, true)
+}
+END_SECTION
+
+START_SECTION((void load(const String& filename, std::vector<ProteinIdentification>& protein_ids, ColumnarPSMStore& psms)))
+{
+  String filename;
+  NEW_TMP_FILE(filename);
+  IdBinaryFile().store(filename, ref_proteins, ref_peptides);
+  vector<ProteinIdentification> proteins;
+  ColumnarPSMStore psms;
+  IdBinaryFile().load(filename, proteins, psms);
+  TEST_EQUAL(psms.size(), ref_peptides.size())
+  vector<PeptideIdentification> peptides;
+  psms.toPeptideIdentifications(peptides);
+  TEST_EQUAL(peptides == ref_peptides, true)
+}
+END_SECTION
+
+START_SECTION((static bool isIdBinaryFile(const String& filename)))
+{
+  TEST_EQUAL(IdBinaryFile::isIdBinaryFile(OPENMS_GET_TEST_DATA_PATH("IdXMLFile_whole.idXML")), false)
+  TEST_EQUAL(IdBinaryFile::isIdBinaryFile("this_file_does_not_exist.idBin"), false)
+}
+END_SECTION
+
+String mapped_filename;
+NEW_TMP_FILE(mapped_filename);
+IdBinaryFile().store(mapped_filename, ref_proteins, ref_peptides);
+
+START_SECTION(([IdBinaryFile::MappedFile] MappedFile(const String& filename)))
+{
+  IdBinaryFile::MappedFile file(mapped_filename);
+  TEST_EQUAL(file.size(), 3)
+  TEST_EXCEPTION(Exception::FileNotFound, IdBinaryFile::MappedFile("this_file_does_not_exist.idBin"))
+}
+END_SECTION
+
+START_SECTION(([IdBinaryFile::MappedFile] Size size() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(([IdBinaryFile::MappedFile] Size getNumberOfHits() const))
+{
+  IdBinaryFile::MappedFile file(mapped_filename);
+  TEST_EQUAL(file.getNumberOfHits(), 5)
+}
+END_SECTION
+
+START_SECTION(([IdBinaryFile::MappedFile] void getProteinIdentifications(std::vector<ProteinIdentification>& protein_ids) const))
+{
+  IdBinaryFile::MappedFile file(mapped_filename);
+  vector<ProteinIdentification> proteins;
+  file.getProteinIdentifications(proteins);
+  TEST_EQUAL(proteins == ref_proteins, true)
+}
+END_SECTION
+
+START_SECTION(([IdBinaryFile::MappedFile] PeptideIdentification getPeptideIdentification(Size id_index) const))
+{
+  IdBinaryFile::MappedFile file(mapped_filename);
+  TEST_EQUAL(file.getPeptideIdentification(2) == ref_peptides[2], true)
+  TEST_EQUAL(file.getPeptideIdentification(0) == ref_peptides[0], true)
+  TEST_EXCEPTION(Exception::IndexOverflow, file.getPeptideIdentification(3))
+}
+END_SECTION
+
+START_SECTION(([IdBinaryFile::MappedFile] PeptideHit getPeptideHit(Size hit_index) const))
+{
+  IdBinaryFile::MappedFile file(mapped_filename);
+  TEST_EQUAL(file.getPeptideHit(3) == ref_peptides[1].getHits()[1], true)
+  TEST_EXCEPTION(Exception::IndexOverflow, file.getPeptideHit(5))
+}
+END_SECTION
+
+START_SECTION(([IdBinaryFile::MappedFile] Size getHitBegin(Size id_index) const))
+{
+  IdBinaryFile::MappedFile file(mapped_filename);
+  TEST_EQUAL(file.getHitBegin(0), 0)
+  TEST_EQUAL(file.getHitBegin(1), 2)
+  TEST_EQUAL(file.getHitBegin(2), 4)
+}
+END_SECTION
+
+START_SECTION(([IdBinaryFile::MappedFile] Size getHitEnd(Size id_index) const))
+{
+  IdBinaryFile::MappedFile file(mapped_filename);
+  TEST_EQUAL(file.getHitEnd(0), 2)
+  TEST_EQUAL(file.getHitEnd(2), 5)
+}
+END_SECTION
+
+START_SECTION(([IdBinaryFile::MappedFile] double getRT(Size id_index) const))
+{
+  IdBinaryFile::MappedFile file(mapped_filename);
+  TEST_REAL_SIMILAR(file.getRT(0), 1234.5)
+}
+END_SECTION
+
+START_SECTION(([IdBinaryFile::MappedFile] double getMZ(Size id_index) const))
+{
+  IdBinaryFile::MappedFile file(mapped_filename);
+  TEST_REAL_SIMILAR(file.getMZ(0), 675.9)
+}
+END_SECTION
+
+START_SECTION(([IdBinaryFile::MappedFile] double getScore(Size hit_index) const))
+{
+  IdBinaryFile::MappedFile file(mapped_filename);
+  TEST_REAL_SIMILAR(file.getScore(2), ref_peptides[1].getHits()[0].getScore())
+}
+END_SECTION
+
+START_SECTION(([IdBinaryFile::MappedFile] String getSequenceString(Size hit_index) const))
+{
+  IdBinaryFile::MappedFile file(mapped_filename);
+  TEST_STRING_EQUAL(file.getSequenceString(4), ref_peptides[2].getHits()[0].getSequence().toString())
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -44,10 +44,41 @@
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/KERNEL/FeatureMap.h>
+#include <OpenMS/COMPARISON/CLUSTERING/ClusterHierarchical.h>
+#include <OpenMS/COMPARISON/CLUSTERING/SingleLinkage.h>
+
+#include <functional>
+#include <set>
 
 using namespace OpenMS;
 using namespace std;
 
+// exposes the window clustering types
+class InclusionExclusionListTest :
+  public InclusionExclusionList
+{
+public:
+  typedef InclusionExclusionList::IEWindow IEWindow;
+  typedef InclusionExclusionList::WindowList WindowList;
+  typedef InclusionExclusionList::WindowDistance_ WindowDistance;
+};
+
+// labels each element with the smallest element of its cluster (joined below distance 1)
+static std::vector<Size> clusterLabels(const std::vector<BinaryTreeNode>& tree, Size n)
+{
+  std::vector<Size> label(n);
+  for (Size i = 0; i < n; ++i) label[i] = i;
+  std::function<Size(Size)> find = [&](Size i) { return label[i] == i ? i : label[i] = find(label[i]); };
+  for (const BinaryTreeNode& node : tree)
+  {
+    if (node.distance >= 1 || node.distance < 0) continue;
+    Size a = find(node.left_child), b = find(node.right_child);
+    label[std::max(a, b)] = std::min(a, b);
+  }
+  for (Size i = 0; i < n; ++i) label[i] = find(i);
+  return label;
+}
+
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wshadow"
 
@@ -220,6 +251,43 @@ START_SECTION((void writeTargets(const std::vector<PeptideIdentification>& pep_i
 END_SECTION
 
 
+START_SECTION(([EXTRA] window clustering on a sparse distance matrix))
+{
+  typedef InclusionExclusionListTest::IEWindow IEWindow;
+  // windows with overlapping, adjacent and distant RT ranges at a few m/z values
+  InclusionExclusionListTest::WindowList windows;
+  for (Size i = 0; i < 300; ++i)
+  {
+    double rt = (i * 37) % 1000;
+    double width = 5 + (i * 13) % 40;
+    double mz = 400 + (i % 7) * 0.002 + (i % 11) * 150;
+    windows.push_back(IEWindow(rt, rt + width, mz));
+  }
+
+  for (int ppm = 0; ppm < 2; ++ppm)
+  {
+    InclusionExclusionListTest::WindowDistance dist(1.1, ppm ? 10.0 : 0.003, ppm == 1);
+    dist.setWindowBounds(windows);
+    TEST_EQUAL((Internal::HasBoundingTolerance<IEWindow, InclusionExclusionListTest::WindowDistance>::value), true)
+
+    ClusterHierarchical ch;
+    SingleLinkage sl;
+    std::vector<BinaryTreeNode> dense_tree, sparse_tree;
+    DistanceMatrix<float> dense;
+    ch.cluster<IEWindow, InclusionExclusionListTest::WindowDistance>(windows, dist, sl, dense_tree, dense);
+    SparseDistanceMatrix sparse;
+    ch.cluster<IEWindow, InclusionExclusionListTest::WindowDistance>(windows, dist, sl, sparse_tree, sparse);
+
+    std::vector<Size> dense_labels = clusterLabels(dense_tree, windows.size());
+    std::vector<Size> sparse_labels = clusterLabels(sparse_tree, windows.size());
+    TEST_EQUAL(dense_labels == sparse_labels, true)
+    // some windows were merged, but not all
+    std::set<Size> clusters(dense_labels.begin(), dense_labels.end());
+    TEST_EQUAL(clusters.size() > 1 && clusters.size() < windows.size(), true)
+  }
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
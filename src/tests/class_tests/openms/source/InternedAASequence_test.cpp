@@ -0,0 +1,197 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/CHEMISTRY/InternedAASequence.h>
+#include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/CONCEPT/Constants.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(InternedAASequence, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+InternedAASequence* ptr = nullptr;
+InternedAASequence* null_ptr = nullptr;
+START_SECTION(InternedAASequence())
+{
+  ptr = new InternedAASequence();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->getSequence().empty(), true)
+  TEST_EQUAL(ptr->isPooled(), false)
+}
+END_SECTION
+
+START_SECTION(~InternedAASequence())
+{
+  delete ptr;
+}
+END_SECTION
+
+const AASequence seq = AASequence::fromString("(Acetyl)PEPM(Oxidation)TIDE");
+
+START_SECTION(explicit InternedAASequence(const AASequence& sequence))
+{
+  InternedAASequence interned(seq);
+  TEST_EQUAL(interned.getSequence(), seq)
+  TEST_EQUAL(interned.isPooled(), false)
+}
+END_SECTION
+
+START_SECTION(explicit InternedAASequence(AASequence&& sequence))
+{
+  AASequence tmp = seq;
+  InternedAASequence interned(std::move(tmp));
+  TEST_EQUAL(interned.getSequence(), seq)
+}
+END_SECTION
+
+START_SECTION(InternedAASequence(const InternedAASequence&))
+{
+  InternedAASequence interned(seq);
+  InternedAASequence copy(interned);
+  TEST_EQUAL(copy == interned, true)
+  // the sequence object is shared, not copied:
+  TEST_EQUAL(&copy.getSequence(), &interned.getSequence())
+}
+END_SECTION
+
+START_SECTION(InternedAASequence& operator=(const InternedAASequence&))
+{
+  InternedAASequence interned(seq);
+  InternedAASequence copy;
+  copy = interned;
+  TEST_EQUAL(&copy.getSequence(), &interned.getSequence())
+}
+END_SECTION
+
+START_SECTION(InternedAASequence(InternedAASequence&& rhs) noexcept)
+{
+  InternedAASequence interned(seq);
+  const AASequence* address = &interned.getSequence();
+  InternedAASequence moved(std::move(interned));
+  TEST_EQUAL(&moved.getSequence(), address)
+  // moved-from object is a valid, empty sequence:
+  TEST_EQUAL(interned.getSequence().empty(), true)
+  TEST_REAL_SIMILAR(interned.getMonoWeight(), 0.0)
+  TEST_EQUAL(interned == InternedAASequence(), true)
+}
+END_SECTION
+
+START_SECTION(InternedAASequence& operator=(InternedAASequence&& rhs) noexcept)
+{
+  InternedAASequence interned(seq);
+  const AASequence* address = &interned.getSequence();
+  InternedAASequence moved;
+  moved = std::move(interned);
+  TEST_EQUAL(&moved.getSequence(), address)
+  TEST_EQUAL(interned.getSequence().empty(), true)
+  TEST_REAL_SIMILAR(interned.getMonoWeight(), 0.0)
+  TEST_EQUAL(interned == InternedAASequence(), true)
+}
+END_SECTION
+
+START_SECTION(const AASequence& getSequence() const)
+{
+  InternedAASequence interned(seq);
+  TEST_STRING_EQUAL(interned.getSequence().toString(), seq.toString())
+}
+END_SECTION
+
+START_SECTION(double getMonoWeight(Int charge = 0) const)
+{
+  InternedAASequence interned(seq);
+  TEST_REAL_SIMILAR(interned.getMonoWeight(), seq.getMonoWeight())
+  TEST_REAL_SIMILAR(interned.getMonoWeight(2), seq.getMonoWeight(Residue::Full, 2))
+  // second call uses the cached value:
+  TEST_REAL_SIMILAR(interned.getMonoWeight(), seq.getMonoWeight())
+  TEST_REAL_SIMILAR(InternedAASequence().getMonoWeight(), 0.0)
+  // unknown mass: the exception is thrown on every call
+  InternedAASequence unknown(AASequence::fromString("PEPXTIDE"));
+  TEST_EXCEPTION(Exception::InvalidValue, unknown.getMonoWeight())
+  TEST_EXCEPTION(Exception::InvalidValue, unknown.getMonoWeight())
+}
+END_SECTION
+
+START_SECTION(double getAverageWeight() const)
+{
+  InternedAASequence interned(seq);
+  TEST_REAL_SIMILAR(interned.getAverageWeight(), seq.getAverageWeight())
+}
+END_SECTION
+
+START_SECTION(const std::vector<double>& getPrefixMonoWeights() const)
+{
+  InternedAASequence interned(seq);
+  const vector<double>& prefixes = interned.getPrefixMonoWeights();
+  TEST_EQUAL(prefixes.size(), seq.size() + 1)
+  // b-ion: prefix mass plus the internal-to-b-ion formula
+  TEST_REAL_SIMILAR(prefixes[3] + Residue::getInternalToBIon().getMonoWeight(), seq.getPrefix(3).getMonoWeight(Residue::BIon))
+  // full peptide: all residues plus the terminal groups
+  TEST_REAL_SIMILAR(prefixes.back() + Residue::getInternalToFull().getMonoWeight(), seq.getMonoWeight())
+}
+END_SECTION
+
+START_SECTION(bool isPooled() const)
+{
+  NOT_TESTABLE // tested above and in AASequencePool_test
+}
+END_SECTION
+
+START_SECTION(bool operator==(const InternedAASequence& rhs) const)
+{
+  InternedAASequence a(seq), b(seq), c(AASequence::fromString("PEPTIDE"));
+  TEST_EQUAL(a == b, true)
+  TEST_EQUAL(a == c, false)
+}
+END_SECTION
+
+START_SECTION(bool operator!=(const InternedAASequence& rhs) const)
+{
+  InternedAASequence a(seq), b(seq), c(AASequence::fromString("PEPTIDE"));
+  TEST_EQUAL(a != b, false)
+  TEST_EQUAL(a != c, true)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
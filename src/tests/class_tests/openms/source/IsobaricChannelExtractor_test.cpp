@@ -44,6 +44,7 @@
 #include <OpenMS/FORMAT/ConsensusXMLFile.h>
 #include <OpenMS/FORMAT/MzDataFile.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
+#include <OpenMS/KERNEL/OnDiscMSExperiment.h>
 
 using namespace OpenMS;
 using namespace std;
@@ -515,6 +516,43 @@ START_SECTION((void extractChannels(const PeakMap&ms_exp_data, ConsensusMap & co
 }
 END_SECTION
 
+START_SECTION((void extractChannels(OnDiscMSExperiment& ms_exp_data, ConsensusMap& consensus_map)))
+{
+  // write the test data as indexed mzML, which is required for on-disc access
+  PeakMap exp;
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("IsobaricChannelExtractor_6.mzML"), exp);
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  MzMLFile().store(tmp_filename, exp);
+
+  OnDiscPeakMap on_disc;
+  TEST_EQUAL(on_disc.openFile(tmp_filename), true)
+
+  IsobaricChannelExtractor ice(q_method);
+  Param p = ice.getParameters();
+  p.setValue("select_activation", "");
+  ice.setParameters(p);
+
+  // results need to be identical to the in-memory extraction
+  ConsensusMap cm_memory, cm_disc;
+  ice.extractChannels(exp, cm_memory);
+  ice.extractChannels(on_disc, cm_disc);
+
+  TEST_EQUAL(cm_disc.size(), 5)
+  ABORT_IF(cm_disc.size() != cm_memory.size())
+  for (Size i = 0; i < cm_disc.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(cm_disc[i].getRT(), cm_memory[i].getRT())
+    TEST_REAL_SIMILAR(cm_disc[i].getMZ(), cm_memory[i].getMZ())
+    TEST_REAL_SIMILAR(cm_disc[i].getIntensity(), cm_memory[i].getIntensity())
+    TEST_REAL_SIMILAR(cm_disc[i].getMetaValue("precursor_purity"), cm_memory[i].getMetaValue("precursor_purity"))
+    TEST_EQUAL(cm_disc[i].getMetaValue("scan_id"), cm_memory[i].getMetaValue("scan_id"))
+    TEST_EQUAL(cm_disc[i].size(), cm_memory[i].size())
+  }
+  TEST_REAL_SIMILAR(cm_disc[1].getMetaValue("precursor_purity"), 0.692434)
+}
+END_SECTION
+
 START_SECTION(([EXTRA] purity computation without interpolation))
 {
   // check precursor purity computation
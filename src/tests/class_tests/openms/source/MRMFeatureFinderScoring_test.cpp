@@ -319,6 +319,57 @@ START_SECTION(void pickExperiment(OpenSwath::SpectrumAccessPtr input, FeatureMap
 }
 END_SECTION
 
+START_SECTION([EXTRA] void pickExperiment(...) called from within a parallel region)
+{
+  // inside a parallel region the transition groups are scored serially,
+  // which has to give the same features as the (possibly) parallel path
+  boost::shared_ptr<PeakMap> swath_map (new PeakMap);
+  boost::shared_ptr<PeakMap> exp (new PeakMap);
+  OpenSwath::LightTargetedExperiment transitions;
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("OpenSwath_generic_input.mzML"), *exp);
+  {
+    TargetedExperiment transition_exp_;
+    TraMLFile().load(OPENMS_GET_TEST_DATA_PATH("OpenSwath_generic_input.TraML"), transition_exp_);
+    OpenSwathDataAccessHelper::convertTargetedExp(transition_exp_, transitions);
+  }
+  OpenSwath::SpectrumAccessPtr swath_ptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(swath_map);
+  OpenSwath::SpectrumAccessPtr chromatogram_ptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+  std::vector< OpenSwath::SwathMap > swath_maps(1);
+  swath_maps[0].sptr = swath_ptr;
+
+  FeatureMap features_parallel;
+  TransitionGroupMapType transition_group_map_parallel;
+  {
+    MRMFeatureFinderScoring ff;
+    ff.pickExperiment(chromatogram_ptr, features_parallel, transitions, TransformationDescription(), swath_maps, transition_group_map_parallel);
+  }
+
+  FeatureMap features_serial;
+  TransitionGroupMapType transition_group_map_serial;
+#ifdef _OPENMP
+#pragma omp parallel num_threads(2)
+#pragma omp single
+#endif
+  {
+    MRMFeatureFinderScoring ff;
+    ff.pickExperiment(chromatogram_ptr, features_serial, transitions, TransformationDescription(), swath_maps, transition_group_map_serial);
+  }
+
+  TEST_EQUAL(features_parallel.size(), 3)
+  TEST_EQUAL(features_serial.size(), features_parallel.size())
+  ABORT_IF(features_serial.size() != features_parallel.size())
+  for (Size i = 0; i < features_parallel.size(); ++i)
+  {
+    TEST_EQUAL(features_serial[i].getMetaValue("PeptideRef"), features_parallel[i].getMetaValue("PeptideRef"))
+    TEST_REAL_SIMILAR(features_serial[i].getRT(), features_parallel[i].getRT())
+    TEST_REAL_SIMILAR(features_serial[i].getIntensity(), features_parallel[i].getIntensity())
+    TEST_REAL_SIMILAR(features_serial[i].getMetaValue("var_xcorr_shape"), features_parallel[i].getMetaValue("var_xcorr_shape"))
+    TEST_REAL_SIMILAR(features_serial[i].getMetaValue("var_library_corr"), features_parallel[i].getMetaValue("var_library_corr"))
+    TEST_REAL_SIMILAR(features_serial[i].getMetaValue("sn_ratio"), features_parallel[i].getMetaValue("sn_ratio"))
+  }
+}
+END_SECTION
+
 START_SECTION(void mapExperimentToTransitionList(OpenSwath::SpectrumAccessPtr input, OpenSwath::LightTargetedExperiment &transition_exp, TransitionGroupMapType &transition_group_map, TransformationDescription trafo, double rt_extraction_window))
 {
   MRMFeatureFinderScoring ff;
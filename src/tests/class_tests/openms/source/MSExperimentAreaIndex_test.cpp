@@ -0,0 +1,278 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/KERNEL/MSExperimentAreaIndex.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+typedef MSExperimentAreaIndex::Area Area;
+
+// all peaks of an area as reported by the area iterator
+vector<PeakIndex> areaPeaks(const PeakMap& exp, const Area& a)
+{
+  vector<PeakIndex> result;
+  if (a.min_rt > a.max_rt || a.min_mz > a.max_mz) return result; // not allowed for the area iterator
+  for (PeakMap::ConstAreaIterator it = exp.areaBeginConst(a.min_rt, a.max_rt, a.min_mz, a.max_mz); it != exp.areaEndConst(); ++it)
+  {
+    result.push_back(it.getPeakIndex());
+  }
+  return result;
+}
+
+START_TEST(MSExperimentAreaIndex, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+// 40 spectra (every fourth one MS2) with 60 peaks each
+PeakMap exp;
+for (Size s = 0; s < 40; ++s)
+{
+  MSSpectrum spec;
+  spec.setRT(10.0 + s * 1.5);
+  spec.setMSLevel(s % 4 == 3 ? 2 : 1);
+  for (Size p = 0; p < 60; ++p)
+  {
+    Peak1D peak;
+    peak.setMZ(400.0 + p * 0.37 + s * 0.01);
+    peak.setIntensity(float((s * 7 + p * 3) % 17 + 1));
+    spec.push_back(peak);
+  }
+  exp.addSpectrum(spec);
+}
+
+vector<Area> areas;
+areas.push_back(Area(0.0, 1000.0, 0.0, 1000.0));     // everything
+areas.push_back(Area(14.0, 40.0, 403.0, 411.5));     // inner cells and borders
+areas.push_back(Area(11.5, 11.5, 400.0, 430.0));     // single spectrum
+areas.push_back(Area(12.0, 12.5, 400.0, 430.0));     // between spectra
+areas.push_back(Area(20.0, 50.0, 400.0 + 10 * 0.37 + 8 * 0.01, 400.0 + 10 * 0.37 + 8 * 0.01)); // single peak
+areas.push_back(Area(20.0, 50.0, 500.0, 600.0));     // right of all peaks
+areas.push_back(Area(0.0, 5.0, 400.0, 430.0));       // left of all spectra
+areas.push_back(Area(30.0, 20.0, 400.0, 430.0));     // swapped RT
+areas.push_back(Area(10.0, 68.5, 399.0, 401.2));     // lower m/z border
+
+MSExperimentAreaIndex* ptr = nullptr;
+MSExperimentAreaIndex* null_ptr = nullptr;
+START_SECTION((MSExperimentAreaIndex()))
+{
+  ptr = new MSExperimentAreaIndex();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->getNrSpectra(), 0)
+  TEST_EQUAL(ptr->getNrPeaks(), 0)
+  TEST_EQUAL(ptr->countPeaks(areas[0]), 0)
+  TEST_EQUAL(ptr->findHighestPeak(areas[0]).isValid(), false)
+}
+END_SECTION
+
+START_SECTION((~MSExperimentAreaIndex()))
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((explicit MSExperimentAreaIndex(const MSExperiment& exp, UInt ms_level = 1, Size spectra_per_block = 8, CoordinateType mz_bin_width = 1.0)))
+{
+  MSExperimentAreaIndex index(exp);
+  TEST_EQUAL(index.getMSLevel(), 1)
+  TEST_EQUAL(index.getNrSpectra(), 30)
+  TEST_EQUAL(index.getNrPeaks(), 30 * 60)
+
+  MSExperimentAreaIndex index2(exp, 2, 3, 0.5);
+  TEST_EQUAL(index2.getMSLevel(), 2)
+  TEST_EQUAL(index2.getNrSpectra(), 10)
+  TEST_EQUAL(index2.getNrPeaks(), 10 * 60)
+
+  TEST_EXCEPTION(Exception::IllegalArgument, MSExperimentAreaIndex(exp, 1, 0))
+  TEST_EXCEPTION(Exception::IllegalArgument, MSExperimentAreaIndex(exp, 1, 8, 0.0))
+
+  PeakMap unsorted = exp;
+  std::swap(unsorted[0], unsorted[1]);
+  TEST_EXCEPTION(Exception::IllegalArgument, MSExperimentAreaIndex tmp(unsorted))
+
+  // an m/z outlier with a fine bin width: only occupied cells are stored
+  PeakMap outlier = exp;
+  Peak1D far_peak;
+  far_peak.setMZ(1.0e6);
+  far_peak.setIntensity(5.0f);
+  outlier[0].push_back(far_peak);
+  MSExperimentAreaIndex index4(outlier, 1, 8, 1.0e-4);
+  TEST_EQUAL(index4.getNrPeaks(), 30 * 60 + 1)
+  for (const Area& a : areas)
+  {
+    TEST_EQUAL(index4.countPeaks(a), areaPeaks(outlier, a).size())
+  }
+  TEST_EQUAL(index4.countPeaks(Area(0.0, 1000.0, 9.0e5, 2.0e6)), 1)
+
+  PeakMap empty;
+  MSExperimentAreaIndex index3(empty);
+  TEST_EQUAL(index3.getNrSpectra(), 0)
+  TEST_EQUAL(index3.sumIntensity(areas[0]), 0.0)
+}
+END_SECTION
+
+// different block sizes and bin widths (including a single cell) must give the same results
+vector<MSExperimentAreaIndex> indices;
+indices.push_back(MSExperimentAreaIndex(exp));
+indices.push_back(MSExperimentAreaIndex(exp, 1, 1, 0.1));
+indices.push_back(MSExperimentAreaIndex(exp, 1, 5, 2.5));
+indices.push_back(MSExperimentAreaIndex(exp, 1, 100, 1000.0));
+
+START_SECTION((void extract(const Area& area, std::vector<PeakIndex>& peaks) const))
+{
+  for (const MSExperimentAreaIndex& index : indices)
+  {
+    for (const Area& a : areas)
+    {
+      vector<PeakIndex> peaks(3);
+      index.extract(a, peaks);
+      TEST_EQUAL(peaks == areaPeaks(exp, a), true)
+    }
+  }
+  vector<PeakIndex> peaks;
+  indices[0].extract(areas[2], peaks);
+  TEST_EQUAL(peaks.size(), 60)
+  TEST_EQUAL(peaks.front().spectrum, 1)
+  TEST_EQUAL(peaks.front().peak, 0)
+}
+END_SECTION
+
+START_SECTION((Size countPeaks(const Area& area) const))
+{
+  for (const MSExperimentAreaIndex& index : indices)
+  {
+    for (const Area& a : areas)
+    {
+      TEST_EQUAL(index.countPeaks(a), areaPeaks(exp, a).size())
+    }
+  }
+  TEST_EQUAL(indices[0].countPeaks(areas[0]), 1800)
+  TEST_EQUAL(indices[0].countPeaks(areas[4]), 1)
+  TEST_EQUAL(indices[0].countPeaks(areas[5]), 0)
+  TEST_EQUAL(indices[0].countPeaks(areas[7]), 0)
+}
+END_SECTION
+
+START_SECTION((double sumIntensity(const Area& area) const))
+{
+  for (const MSExperimentAreaIndex& index : indices)
+  {
+    for (const Area& a : areas)
+    {
+      double sum = 0.0;
+      for (const PeakIndex& pi : areaPeaks(exp, a))
+      {
+        sum += pi.getPeak(exp).getIntensity();
+      }
+      TEST_REAL_SIMILAR(index.sumIntensity(a), sum)
+    }
+  }
+}
+END_SECTION
+
+START_SECTION((PeakIndex findHighestPeak(const Area& area) const))
+{
+  for (const MSExperimentAreaIndex& index : indices)
+  {
+    for (const Area& a : areas)
+    {
+      // the first of the highest peaks in area iterator order
+      PeakIndex expected;
+      for (const PeakIndex& pi : areaPeaks(exp, a))
+      {
+        if (!expected.isValid() || pi.getPeak(exp).getIntensity() > expected.getPeak(exp).getIntensity())
+        {
+          expected = pi;
+        }
+      }
+      TEST_EQUAL(index.findHighestPeak(a) == expected, true)
+    }
+  }
+}
+END_SECTION
+
+START_SECTION((std::vector<double> sumIntensity(const std::vector<Area>& areas) const))
+{
+  vector<double> sums = indices[2].sumIntensity(areas);
+  TEST_EQUAL(sums.size(), areas.size())
+  for (Size i = 0; i < areas.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(sums[i], indices[2].sumIntensity(areas[i]))
+  }
+  TEST_EQUAL(indices[2].sumIntensity(vector<Area>()).size(), 0)
+}
+END_SECTION
+
+START_SECTION((std::vector<PeakIndex> findHighestPeak(const std::vector<Area>& areas) const))
+{
+  vector<PeakIndex> highest = indices[2].findHighestPeak(areas);
+  TEST_EQUAL(highest.size(), areas.size())
+  for (Size i = 0; i < areas.size(); ++i)
+  {
+    TEST_EQUAL(highest[i] == indices[2].findHighestPeak(areas[i]), true)
+  }
+}
+END_SECTION
+
+START_SECTION((std::vector<std::vector<PeakIndex> > extract(const std::vector<Area>& areas) const))
+{
+  vector<vector<PeakIndex> > peaks = indices[2].extract(areas);
+  TEST_EQUAL(peaks.size(), areas.size())
+  for (Size i = 0; i < areas.size(); ++i)
+  {
+    TEST_EQUAL(peaks[i] == areaPeaks(exp, areas[i]), true)
+  }
+}
+END_SECTION
+
+START_SECTION((UInt getMSLevel() const))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION((Size getNrSpectra() const))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION((Size getNrPeaks() const))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
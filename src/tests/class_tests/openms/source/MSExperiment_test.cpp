@@ -300,6 +300,80 @@ START_SECTION((template<class Container> void get2DData(Container& cont) const))
 }
 END_SECTION
 
+START_SECTION((Size countPeaks(Int ms_level = -1, CoordinateType min_rt = -std::numeric_limits<CoordinateType>::max(), CoordinateType max_rt = std::numeric_limits<CoordinateType>::max(), CoordinateType min_mz = -std::numeric_limits<CoordinateType>::max(), CoordinateType max_mz = std::numeric_limits<CoordinateType>::max()) const))
+{
+  PeakMap exp;
+  PeakMap::SpectrumType spec;
+  PeakMap::PeakType peak;
+  for (Size i = 0; i < 3; ++i)
+  {
+    spec.clear(true);
+    spec.setRT(10.0 * (i + 1));
+    spec.setMSLevel(i == 1 ? 2 : 1);
+    for (Size j = 0; j < 4; ++j)
+    {
+      peak.setMZ(100.0 * (j + 1));
+      peak.setIntensity(float(i * 10 + j));
+      spec.push_back(peak);
+    }
+    exp.addSpectrum(spec);
+  }
+
+  TEST_EQUAL(exp.countPeaks(), 12)
+  TEST_EQUAL(exp.countPeaks(1), 8)
+  TEST_EQUAL(exp.countPeaks(2), 4)
+  TEST_EQUAL(exp.countPeaks(1, 15.0, 35.0), 4)
+  TEST_EQUAL(exp.countPeaks(-1, 0.0, 100.0, 150.0, 400.0), 6)
+  TEST_EQUAL(exp.countPeaks(3), 0)
+  TEST_EQUAL(PeakMap().countPeaks(), 0)
+}
+END_SECTION
+
+START_SECTION((Size exportPeaks(double* rt, double* mz, float* intensity, double* ion_mobility, Size* spectrum_index, Int ms_level = -1, CoordinateType min_rt = -std::numeric_limits<CoordinateType>::max(), CoordinateType max_rt = std::numeric_limits<CoordinateType>::max(), CoordinateType min_mz = -std::numeric_limits<CoordinateType>::max(), CoordinateType max_mz = std::numeric_limits<CoordinateType>::max()) const))
+{
+  PeakMap exp;
+  PeakMap::SpectrumType spec;
+  PeakMap::PeakType peak;
+  for (Size i = 0; i < 3; ++i)
+  {
+    spec.clear(true);
+    spec.setRT(10.0 * (i + 1));
+    spec.setMSLevel(i == 1 ? 2 : 1);
+    for (Size j = 0; j < 4; ++j)
+    {
+      peak.setMZ(100.0 * (j + 1));
+      peak.setIntensity(float(i * 10 + j));
+      spec.push_back(peak);
+    }
+    exp.addSpectrum(spec);
+  }
+
+  Size n = exp.countPeaks();
+  std::vector<double> rt(n), mz(n), im(n);
+  std::vector<float> intensity(n);
+  std::vector<Size> index(n);
+  TEST_EQUAL(exp.exportPeaks(&rt[0], &mz[0], &intensity[0], &im[0], &index[0]), 12)
+  TEST_REAL_SIMILAR(rt[0], 10.0)
+  TEST_REAL_SIMILAR(rt[11], 30.0)
+  TEST_REAL_SIMILAR(mz[5], 200.0)
+  TEST_REAL_SIMILAR(intensity[5], 11.0)
+  TEST_REAL_SIMILAR(im[5], -1.0) // no drift time
+  TEST_EQUAL(index[5], 1)
+  TEST_EQUAL(index[11], 2)
+
+  // MS1 only, RT and m/z range, some columns skipped
+  n = exp.countPeaks(1, 15.0, 35.0, 150.0, 350.0);
+  TEST_EQUAL(n, 2)
+  TEST_EQUAL(exp.exportPeaks(nullptr, &mz[0], &intensity[0], nullptr, &index[0], 1, 15.0, 35.0, 150.0, 350.0), 2)
+  TEST_REAL_SIMILAR(mz[0], 200.0)
+  TEST_REAL_SIMILAR(mz[1], 300.0)
+  TEST_REAL_SIMILAR(intensity[1], 22.0)
+  TEST_EQUAL(index[0], 2)
+
+  TEST_EQUAL(exp.exportPeaks(nullptr, nullptr, nullptr, nullptr, nullptr, 1, 50.0, 60.0), 0)
+}
+END_SECTION
+
 START_SECTION((template <class Container> void set2DData(const Container& cont, const StringList& store_metadata_names = StringList())))
 {
   NOT_TESTABLE // tested below
@@ -1144,6 +1218,34 @@ START_SECTION((void sortChromatograms(bool sort_rt=true)))
 }
 END_SECTION
 
+START_SECTION((template <typename FunctionType> void forEachSpectrumParallel(FunctionType f)))
+{
+  PeakMap exp;
+  for (Size s = 0; s < 100; ++s)
+  {
+    MSSpectrum spec;
+    spec.setRT(double(s));
+    Peak1D p;
+    p.setMZ(500.0);
+    p.setIntensity(float(s));
+    spec.push_back(p);
+    exp.addSpectrum(spec);
+  }
+
+  exp.forEachSpectrumParallel([](MSSpectrum& spec) { spec[0].setIntensity(spec[0].getIntensity() * 2); });
+  for (Size s = 0; s < exp.size(); ++s)
+  {
+    TEST_REAL_SIMILAR(exp[s][0].getIntensity(), 2.0 * s)
+  }
+
+  // the exception of the first failing spectrum is rethrown
+  TEST_EXCEPTION_WITH_MESSAGE(Exception::InvalidValue, exp.forEachSpectrumParallel([](MSSpectrum& spec)
+  {
+    if (spec.getRT() >= 42.0) throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "test", String(Int(spec.getRT())));
+  }), "the value '42' was used but is not valid; test")
+}
+END_SECTION
+
 START_SECTION((void setChromatograms(const std::vector< MSChromatogram > &chromatograms)))
 {
   PeakMap exp;
@@ -297,6 +297,59 @@ START_SECTION((MSSpectrum& select(const std::vector<Size>& indices)))
 }
 END_SECTION
 
+START_SECTION((Int getIonMobilityArrayIndex() const))
+{
+  MSSpectrum s;
+  s.push_back(p1);
+  s.push_back(p2);
+  TEST_EQUAL(s.getIonMobilityArrayIndex(), -1)
+
+  s.getFloatDataArrays().resize(2);
+  s.getFloatDataArrays()[0].setName("other");
+  s.getFloatDataArrays()[0].push_back(1.0);
+  s.getFloatDataArrays()[0].push_back(2.0);
+  s.getFloatDataArrays()[1].setName("Ion Mobility");
+  s.getFloatDataArrays()[1].push_back(3.0);
+  TEST_EQUAL(s.getIonMobilityArrayIndex(), -1) // one value per peak is required
+  s.getFloatDataArrays()[1].push_back(4.0);
+  TEST_EQUAL(s.getIonMobilityArrayIndex(), 1)
+}
+END_SECTION
+
+START_SECTION((Size exportPeaks(double* mz, float* intensity, double* ion_mobility = nullptr, CoordinateType min_mz = -std::numeric_limits<CoordinateType>::max(), CoordinateType max_mz = std::numeric_limits<CoordinateType>::max()) const))
+{
+  MSSpectrum s;
+  s.setDriftTime(7.5);
+  s.push_back(p1);
+  s.push_back(p2);
+  s.push_back(p3);
+
+  std::vector<double> mz(3), im(3);
+  std::vector<float> intensity(3);
+  TEST_EQUAL(s.exportPeaks(&mz[0], &intensity[0], &im[0]), 3)
+  TEST_REAL_SIMILAR(mz[0], 2.0)
+  TEST_REAL_SIMILAR(mz[2], 30.0)
+  TEST_REAL_SIMILAR(intensity[1], 2.0)
+  TEST_REAL_SIMILAR(im[2], 7.5) // drift time of the spectrum
+
+  // m/z range, skipped columns
+  mz.assign(3, 0.0);
+  TEST_EQUAL(s.exportPeaks(&mz[0], nullptr, nullptr, 5.0, 30.0), 1)
+  TEST_REAL_SIMILAR(mz[0], 10.0)
+  TEST_EQUAL(s.exportPeaks(&mz[0], nullptr, nullptr, 40.0, 50.0), 0)
+
+  // ion mobility of each peak
+  s.getFloatDataArrays().resize(1);
+  s.getFloatDataArrays()[0].setName("Ion Mobility");
+  s.getFloatDataArrays()[0].push_back(0.5);
+  s.getFloatDataArrays()[0].push_back(0.6);
+  s.getFloatDataArrays()[0].push_back(0.7);
+  TEST_EQUAL(s.exportPeaks(nullptr, nullptr, &im[0], 5.0), 2)
+  TEST_REAL_SIMILAR(im[0], 0.6)
+  TEST_REAL_SIMILAR(im[1], 0.7)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 // RangeManager
 
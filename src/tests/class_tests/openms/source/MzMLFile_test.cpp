@@ -1230,6 +1230,27 @@ START_SECTION(void transform(const String& filename_in, Interfaces::IMSDataConsu
   TEST_REAL_SIMILAR(consumer.TIC, 350)
 
   TEST_EQUAL(map.getNrSpectra(), 4)
+
+  // pipelined decoding (one spectrum per chunk, minimal byte budget)
+  TICConsumer consumer_pipelined;
+  PeakMap map_pipelined;
+  opt.setMaxDataPoolSize(1);
+  opt.setPipelinedDecoding(true);
+  opt.setMaxPipelineBytes(1);
+  mzml.setOptions(opt);
+  mzml.transform(in, &consumer_pipelined, map_pipelined, true, true);
+
+  TEST_EQUAL(consumer_pipelined.nr_spectra, 4)
+  TEST_EQUAL(consumer_pipelined.nr_peaks, 40)
+  TEST_REAL_SIMILAR(consumer_pipelined.TIC, 350)
+
+  TEST_EQUAL(map_pipelined.getNrSpectra(), 4)
+  TEST_EQUAL(map_pipelined.getNrChromatograms(), map.getNrChromatograms())
+  for (Size i = 0; i < map.getNrSpectra(); ++i)
+  {
+    TEST_EQUAL(map_pipelined[i].getNativeID(), map[i].getNativeID())
+    TEST_EQUAL(map_pipelined[i] == map[i], true)
+  }
 }
 END_SECTION
 
@@ -147,6 +147,79 @@ START_SECTION(static std::vector<OPXLDataStructs::XLPrecursor> enumerateCrossLin
 
 END_SECTION
 
+START_SECTION(static std::vector<OPXLDataStructs::XLPrecursor> enumerateCrossLinksAlphaFirst(const std::vector<OPXLDataStructs::AASeqWithMass>& peptides, double cross_link_mass, const std::vector< double >& alpha_masses, double alpha_mass_tolerance, bool alpha_mass_tolerance_unit_ppm, const std::vector< double >& spectrum_precursors, std::vector< int >& precursor_correction_positions, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm))
+
+  std::vector< double > precursors_alpha;
+  precursors_alpha.push_back(peptides[10].peptide_mass + peptides[20].peptide_mass + cross_link_mass);
+  std::vector< double > alpha_masses;
+  alpha_masses.push_back(peptides[20].peptide_mass);
+
+  std::vector< int > alpha_correction_positions;
+  std::vector<OPXLDataStructs::XLPrecursor> alpha_first = OPXLHelper::enumerateCrossLinksAlphaFirst(peptides, cross_link_mass, alpha_masses, 0.01, false, precursors_alpha, alpha_correction_positions, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm);
+
+  TEST_EQUAL(alpha_first.empty(), false)
+  TEST_EQUAL(alpha_first.size(), alpha_correction_positions.size())
+  bool found = false;
+  for (Size i = 0; i < alpha_first.size(); ++i)
+  {
+    // only cross-links, smaller index first, one side matches the alpha mass
+    TEST_EQUAL(alpha_first[i].alpha_index <= alpha_first[i].beta_index, true)
+    TEST_EQUAL(alpha_first[i].beta_index < peptides.size(), true)
+    double mass_first = peptides[alpha_first[i].alpha_index].peptide_mass;
+    double mass_second = peptides[alpha_first[i].beta_index].peptide_mass;
+    TEST_EQUAL(std::fabs(mass_first - alpha_masses[0]) <= 0.01 || std::fabs(mass_second - alpha_masses[0]) <= 0.01, true)
+    TEST_EQUAL(std::fabs(mass_first + mass_second + cross_link_mass - precursors_alpha[0]) <= precursors_alpha[0] * precursor_mass_tolerance * 1e-6 + 1e-3, true)
+    if (alpha_first[i].alpha_index == 10 && alpha_first[i].beta_index == 20) found = true;
+  }
+  TEST_EQUAL(found, true)
+
+  // the same cross-links are found by the full enumeration
+  std::vector< int > full_correction_positions;
+  std::vector<OPXLDataStructs::XLPrecursor> full = OPXLHelper::enumerateCrossLinksAndMasses(peptides, cross_link_mass, DoubleList(), cross_link_residue1, cross_link_residue2, precursors_alpha, full_correction_positions, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm);
+  Size full_alpha = 0;
+  for (Size i = 0; i < full.size(); ++i)
+  {
+    if (full[i].beta_index >= peptides.size()) continue;
+    if (std::fabs(peptides[full[i].alpha_index].peptide_mass - alpha_masses[0]) <= 0.01 || std::fabs(peptides[full[i].beta_index].peptide_mass - alpha_masses[0]) <= 0.01)
+    {
+      ++full_alpha;
+    }
+  }
+  TEST_EQUAL(alpha_first.size(), full_alpha)
+
+  // no alpha masses, no candidates
+  alpha_correction_positions.clear();
+  TEST_EQUAL(OPXLHelper::enumerateCrossLinksAlphaFirst(peptides, cross_link_mass, std::vector< double >(), 0.01, false, precursors_alpha, alpha_correction_positions, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm).size(), 0)
+
+END_SECTION
+
+START_SECTION(static std::vector< double > findSignatureDoubletMasses(const PeakSpectrum& spectrum, const DoubleList& stub_masses, Int max_charge, double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm))
+
+  // DSSO stubs (alkene, thiol)
+  DoubleList stub_masses = ListUtils::create<double>("54.01056, 85.98264");
+  const double peptide_mass = peptides[20].peptide_mass;
+  PeakSpectrum doublet_spec;
+  Peak1D peak;
+  peak.setMZ(300.0); // noise
+  doublet_spec.push_back(peak);
+  // doublet with charge 2:
+  peak.setMZ((peptide_mass + 54.01056) / 2.0 + Constants::PROTON_MASS_U);
+  doublet_spec.push_back(peak);
+  peak.setMZ((peptide_mass + 85.98264) / 2.0 + Constants::PROTON_MASS_U);
+  doublet_spec.push_back(peak);
+  doublet_spec.sortByPosition();
+
+  std::vector< double > doublet_masses = OPXLHelper::findSignatureDoubletMasses(doublet_spec, stub_masses, 3, 10.0, true);
+  TEST_EQUAL(doublet_masses.size(), 1)
+  TEST_REAL_SIMILAR(doublet_masses[0], peptide_mass)
+
+  // charge 2 is not considered:
+  TEST_EQUAL(OPXLHelper::findSignatureDoubletMasses(doublet_spec, stub_masses, 1, 10.0, true).size(), 0)
+
+  TEST_EXCEPTION(Exception::InvalidParameter, OPXLHelper::findSignatureDoubletMasses(doublet_spec, ListUtils::create<double>("54.01056"), 3, 10.0, true))
+
+END_SECTION
+
 // building more data structures required in the following test
 std::cout << std::endl;
 std::vector< int > spectrum_precursor_correction_positions;
@@ -0,0 +1,245 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/KERNEL/OnDiscSpectrumCache.h>
+///////////////////////////
+
+#include <chrono>
+#include <thread>
+
+using namespace OpenMS;
+using namespace std;
+
+// waits (at most ~10s) until the background thread has read all prefetched spectra
+void waitForPrefetch(const OnDiscSpectrumCache& cache)
+{
+  for (Size i = 0; i < 1000 && cache.isPrefetching(); ++i)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+}
+
+START_TEST(OnDiscSpectrumCache, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+OnDiscPeakMap od_exp;
+od_exp.openFile(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"));
+
+OnDiscSpectrumCache* ptr = nullptr;
+OnDiscSpectrumCache* null_ptr = nullptr;
+START_SECTION((explicit OnDiscSpectrumCache(const OnDiscMSExperiment& experiment, Size max_peaks = 20000000)))
+{
+  ptr = new OnDiscSpectrumCache(od_exp);
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->getMaxPeaks(), 20000000)
+
+  OnDiscPeakMap no_meta;
+  no_meta.openFile(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"), true);
+  TEST_EXCEPTION(Exception::MissingInformation, OnDiscSpectrumCache tmp(no_meta))
+}
+END_SECTION
+
+START_SECTION((~OnDiscSpectrumCache()))
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((Size size() const))
+{
+  OnDiscSpectrumCache cache(od_exp);
+  TEST_EQUAL(cache.size(), 2)
+  TEST_EQUAL(cache.getMetaData()->size(), 2)
+  TEST_EQUAL((*cache.getMetaData())[0].size(), 0)
+}
+END_SECTION
+
+START_SECTION((SpectrumPtr getSpectrum(Size index)))
+{
+  OnDiscSpectrumCache cache(od_exp);
+  TEST_EQUAL(cache.isCached(0), false)
+  OnDiscSpectrumCache::SpectrumPtr s = cache.getSpectrum(0);
+  TEST_EQUAL(s->size(), 19914)
+  TEST_EQUAL(cache.isCached(0), true)
+  TEST_EQUAL(cache.getCachedSpectrumCount(), 1)
+  TEST_EQUAL(cache.getCachedPeakCount(), 19914)
+  // a hit returns the same spectrum
+  TEST_EQUAL(cache.getSpectrum(0) == s, true)
+  TEST_EXCEPTION(Exception::IndexOverflow, cache.getSpectrum(2))
+}
+END_SECTION
+
+START_SECTION((SpectrumPtr getCachedSpectrum(Size index)))
+{
+  OnDiscSpectrumCache cache(od_exp);
+  TEST_EQUAL(cache.getCachedSpectrum(1) == nullptr, true)
+  cache.getSpectrum(1);
+  TEST_EQUAL(cache.getCachedSpectrum(1)->size(), 19800)
+}
+END_SECTION
+
+START_SECTION((bool isCached(Size index) const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((Size getMaxPeaks() const))
+{
+  NOT_TESTABLE // tested below
+}
+END_SECTION
+
+START_SECTION((void setMaxPeaks(Size max_peaks)))
+{
+  OnDiscSpectrumCache cache(od_exp, 30000);
+  cache.getSpectrum(0);
+  cache.getSpectrum(1);
+  // only one spectrum fits, the least recently used one was evicted
+  TEST_EQUAL(cache.getCachedSpectrumCount(), 1)
+  TEST_EQUAL(cache.isCached(1), true)
+
+  cache.setMaxPeaks(100000);
+  TEST_EQUAL(cache.getMaxPeaks(), 100000)
+  cache.getSpectrum(0);
+  TEST_EQUAL(cache.getCachedSpectrumCount(), 2)
+  TEST_EQUAL(cache.getCachedPeakCount(), 19914 + 19800)
+
+  // spectrum 1 is used last -> spectrum 0 is evicted first
+  cache.getCachedSpectrum(1);
+  cache.setMaxPeaks(20000);
+  TEST_EQUAL(cache.isCached(0), false)
+  TEST_EQUAL(cache.isCached(1), true)
+
+  // the most recently used spectrum is kept even if it exceeds the budget
+  cache.setMaxPeaks(0);
+  TEST_EQUAL(cache.getCachedSpectrumCount(), 1)
+}
+END_SECTION
+
+START_SECTION((Size getCachedSpectrumCount() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((Size getCachedPeakCount() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((void clear()))
+{
+  OnDiscSpectrumCache cache(od_exp);
+  cache.getSpectrum(0);
+  cache.clear();
+  TEST_EQUAL(cache.getCachedSpectrumCount(), 0)
+  TEST_EQUAL(cache.getCachedPeakCount(), 0)
+  TEST_EQUAL(cache.isCached(0), false)
+}
+END_SECTION
+
+START_SECTION((void prefetch(const std::vector<Size>& indices)))
+{
+  OnDiscSpectrumCache cache(od_exp);
+  vector<Size> indices;
+  indices.push_back(1);
+  indices.push_back(0);
+  indices.push_back(17); // out of range -> ignored
+  cache.prefetch(indices);
+  waitForPrefetch(cache);
+  TEST_EQUAL(cache.isPrefetching(), false)
+  TEST_EQUAL(cache.isCached(0), true)
+  TEST_EQUAL(cache.isCached(1), true)
+  TEST_EQUAL(cache.getCachedSpectrum(0)->size(), 19914)
+}
+END_SECTION
+
+START_SECTION((void cancelPrefetch()))
+{
+  OnDiscSpectrumCache cache(od_exp);
+  cache.cancelPrefetch();
+  TEST_EQUAL(cache.isPrefetching(), false)
+}
+END_SECTION
+
+START_SECTION((bool isPrefetching() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((std::vector<OverviewPoint> getOverview() const))
+{
+  // the file contains TIC, base peak and m/z range of its spectra -> nothing needs to be read
+  OnDiscSpectrumCache cache(od_exp);
+  TEST_EQUAL(cache.isOverviewComplete(), true)
+  vector<OnDiscSpectrumCache::OverviewPoint> overview = cache.getOverview();
+  TEST_EQUAL(overview.size(), 2)
+  TEST_EQUAL(overview[1].index, 1)
+  TEST_REAL_SIMILAR(overview[1].rt, (*cache.getMetaData())[1].getRT())
+  TEST_REAL_SIMILAR(overview[0].tic, 15245068)
+  TEST_REAL_SIMILAR(overview[0].base_peak_intensity, 1471973.875)
+  TEST_REAL_SIMILAR(overview[1].mz_min, 200.090909093618)
+  TEST_REAL_SIMILAR(overview[1].mz_max, 2000.00005364418)
+  TEST_EQUAL(cache.getCachedSpectrumCount(), 0)
+}
+END_SECTION
+
+START_SECTION((bool isOverviewComplete() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((bool getOverviewRanges(double& mz_min, double& mz_max, double& max_intensity) const))
+{
+  OnDiscSpectrumCache cache(od_exp);
+  double mz_min(0), mz_max(0), max_int(0);
+  TEST_EQUAL(cache.getOverviewRanges(mz_min, mz_max, max_int), true)
+  TEST_REAL_SIMILAR(mz_min, 200.00018816645)
+  TEST_REAL_SIMILAR(mz_max, 2000.00994662038)
+  TEST_REAL_SIMILAR(max_int, 1471973.875)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -0,0 +1,154 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/CONCEPT/ParallelExceptionCollector.h>
+///////////////////////////
+
+#include <OpenMS/CONCEPT/Exception.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(ParallelExceptionCollector, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+ParallelExceptionCollector* ptr = nullptr;
+ParallelExceptionCollector* null_ptr = nullptr;
+START_SECTION(ParallelExceptionCollector())
+{
+  ptr = new ParallelExceptionCollector();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->hasError(), false)
+  ptr->rethrowFirst(); // nothing to throw
+}
+END_SECTION
+
+START_SECTION(~ParallelExceptionCollector())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((void capture(SignedSize index)))
+{
+  ParallelExceptionCollector errors;
+  try
+  {
+    throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "second", "5");
+  }
+  catch (...)
+  {
+    errors.capture(5);
+  }
+  try
+  {
+    throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "first", "2");
+  }
+  catch (...)
+  {
+    errors.capture(2);
+  }
+  try
+  {
+    throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "third", "7");
+  }
+  catch (...)
+  {
+    errors.capture(7);
+  }
+  TEST_EQUAL(errors.hasError(), true)
+  TEST_EQUAL(errors.getFirstIndex(), 2)
+  TEST_EXCEPTION_WITH_MESSAGE(Exception::InvalidValue, errors.rethrowFirst(), "the value '2' was used but is not valid; first")
+}
+END_SECTION
+
+START_SECTION((void capture(SignedSize index, std::exception_ptr error)))
+{
+  ParallelExceptionCollector errors;
+  errors.capture(1, std::exception_ptr());
+  TEST_EQUAL(errors.hasError(), false)
+  errors.capture(3, std::make_exception_ptr(Exception::NotImplemented(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION)));
+  TEST_EQUAL(errors.hasError(), true)
+  TEST_EQUAL(errors.getFirstIndex(), 3)
+  TEST_EXCEPTION(Exception::NotImplemented, errors.rethrowFirst())
+}
+END_SECTION
+
+START_SECTION((void rethrowFirst() const))
+{
+  // the exception of the lowest iteration is rethrown, independent of the thread schedule
+  ParallelExceptionCollector errors;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+  for (SignedSize i = 0; i < 100; ++i)
+  {
+    try
+    {
+      if (i % 10 == 7)
+      {
+        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "failed", String(i));
+      }
+    }
+    catch (...)
+    {
+      errors.capture(i);
+    }
+  }
+  TEST_EQUAL(errors.getFirstIndex(), 7)
+  TEST_EXCEPTION_WITH_MESSAGE(Exception::InvalidValue, errors.rethrowFirst(), "the value '7' was used but is not valid; failed")
+}
+END_SECTION
+
+START_SECTION((bool hasError() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((SignedSize getFirstIndex() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -957,6 +957,76 @@ START_SECTION((Param& operator = (const Param& rhs)))
 	TEST_EQUAL(p2.getTags("test:float") == ListUtils::create<String>("a,b,c"), true)
 END_SECTION
 
+START_SECTION(([EXTRA] copies are independent and lookups stay correct after modifications))
+{
+  Param p1;
+  for (Int i = 0; i < 50; ++i)
+  {
+    p1.setValue("section" + String(i % 5) + ":sub:value" + String(i), i, "desc");
+  }
+  // enough lookups to use the index
+  for (Int i = 0; i < 50; ++i)
+  {
+    TEST_EQUAL(Int(p1.getValue("section" + String(i % 5) + ":sub:value" + String(i))), i)
+  }
+  TEST_EQUAL(p1.exists("section0:sub"), false)
+  TEST_EQUAL(p1.exists("section0:sub:value1"), false)
+
+  Param p2(p1);
+  Param p3;
+  p3 = p1;
+  p2.setValue("section0:sub:value0", 100);
+  p2.setValue("section9:new", 1);
+  p2.remove("section1:sub:value1");
+  p3.setMinInt("section2:sub:value2", 2);
+  p3.addTag("section2:sub:value2", "advanced");
+
+  // the original is unchanged
+  TEST_EQUAL(Int(p1.getValue("section0:sub:value0")), 0)
+  TEST_EQUAL(p1.exists("section9:new"), false)
+  TEST_EQUAL(p1.exists("section1:sub:value1"), true)
+  TEST_EQUAL(p1.getEntry("section2:sub:value2").min_int, -std::numeric_limits<Int>::max())
+  TEST_EQUAL(p1.hasTag("section2:sub:value2", "advanced"), false)
+
+  TEST_EQUAL(Int(p2.getValue("section0:sub:value0")), 100)
+  TEST_EQUAL(Int(p2.getValue("section9:new")), 1)
+  TEST_EQUAL(p2.exists("section1:sub:value1"), false)
+  TEST_EQUAL(p2.size(), 50)
+  TEST_EQUAL(p3.getEntry("section2:sub:value2").min_int, 2)
+  TEST_EQUAL(p3.hasTag("section2:sub:value2", "advanced"), true)
+
+  // removing and re-adding entries after the index was built
+  for (Int i = 0; i < 50; ++i)
+  {
+    TEST_EQUAL(p2.exists("section" + String(i % 5) + ":sub:value" + String(i)), i != 1)
+  }
+  p2.removeAll("section3:");
+  TEST_EQUAL(p2.exists("section3:sub:value3"), false)
+  TEST_EQUAL(p2.exists("section4:sub:value4"), true)
+  p2.setValue("section3:sub:value3", 3);
+  TEST_EQUAL(Int(p2.getValue("section3:sub:value3")), 3)
+  p2.clear();
+  TEST_EQUAL(p2.exists("section0:sub:value0"), false)
+  TEST_EQUAL(p1.exists("section0:sub:value0"), true)
+
+  // inserting a Param into itself
+  Param p4;
+  p4.setValue("a", 1);
+  p4.insert("b:", p4);
+  TEST_EQUAL(Int(p4.getValue("a")), 1)
+  TEST_EQUAL(Int(p4.getValue("b:a")), 1)
+  TEST_EQUAL(p4.size(), 2)
+
+  // moved-from Params are empty and usable
+  Param p5(std::move(p4));
+  TEST_EQUAL(p5.size(), 2)
+  TEST_EQUAL(p4.empty(), true)
+  p4.setValue("c", 3);
+  TEST_EQUAL(p4.size(), 1)
+  TEST_EQUAL(Param().empty(), true)
+}
+END_SECTION
+
 START_SECTION((Param copy(const String &prefix, bool remove_prefix=false) const))
 	Param p2;
 
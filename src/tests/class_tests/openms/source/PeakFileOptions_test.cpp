@@ -246,6 +246,40 @@ START_SECTION(void setMaxDataPoolSize(Size size))
 }
 END_SECTION
 
+START_SECTION(bool getPipelinedDecoding() const)
+{
+	PeakFileOptions tmp;
+	TEST_EQUAL(tmp.getPipelinedDecoding(), false);
+}
+END_SECTION
+
+START_SECTION(void setPipelinedDecoding(bool pipelined))
+{
+	PeakFileOptions tmp;
+	tmp.setPipelinedDecoding(true);
+	TEST_EQUAL(tmp.getPipelinedDecoding(), true);
+	PeakFileOptions copy(tmp);
+	TEST_EQUAL(copy.getPipelinedDecoding(), true);
+}
+END_SECTION
+
+START_SECTION(Size getMaxPipelineBytes() const)
+{
+	PeakFileOptions tmp;
+	TEST_EQUAL(tmp.getMaxPipelineBytes() != 0, true);
+}
+END_SECTION
+
+START_SECTION(void setMaxPipelineBytes(Size bytes))
+{
+	PeakFileOptions tmp;
+	tmp.setMaxPipelineBytes(1024);
+	TEST_EQUAL(tmp.getMaxPipelineBytes(), 1024);
+	PeakFileOptions copy(tmp);
+	TEST_EQUAL(copy.getMaxPipelineBytes(), 1024);
+}
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
@@ -108,6 +108,111 @@ START_SECTION((void readQuantData(vector<ProteinIdentification>& proteins, vecto
 }
 END_SECTION
 
+START_SECTION((void startQuantData(const ExperimentalDesign& ed)))
+{
+  // tested with "addQuantData" below
+  NOT_TESTABLE
+}
+END_SECTION
+
+START_SECTION((void addQuantData(ConsensusMap& consensus, Size first_ms_file_row = 0)))
+{
+  // streaming the consensus map in two parts gives the same result as reading it at once:
+  ConsensusMap consensus;
+  ConsensusXMLFile().load(OPENMS_GET_TEST_DATA_PATH("ProteinQuantifier_input.consensusXML"), consensus);
+  ExperimentalDesign design = ExperimentalDesign::fromConsensusMap(consensus);
+  ConsensusMap first_half = consensus, second_half = consensus;
+  first_half.resize(consensus.size() / 2);
+  second_half.clear(false);
+  for (Size i = consensus.size() / 2; i < consensus.size(); ++i)
+  {
+    second_half.push_back(consensus[i]);
+  }
+  second_half.getUnassignedPeptideIdentifications().clear(); // already in first half
+
+  PeptideAndProteinQuant quantifier;
+  quantifier.setParameters(params);
+  quantifier.startQuantData(design);
+  quantifier.addQuantData(first_half);
+  quantifier.addQuantData(second_half);
+  quantifier.finishQuantData();
+  quantifier.quantifyPeptides();
+
+  PeptideAndProteinQuant::PeptideQuant pep_quant = quantifier.getPeptideResults();
+  PeptideAndProteinQuant::PeptideQuant expected = quantifier_consensus.getPeptideResults();
+  TEST_EQUAL(pep_quant.size(), expected.size());
+  PeptideAndProteinQuant::PeptideQuant::iterator pep_it = pep_quant.begin(), exp_it = expected.begin();
+  for (; (pep_it != pep_quant.end()) && (exp_it != expected.end()); ++pep_it, ++exp_it)
+  {
+    TEST_EQUAL(pep_it->first, exp_it->first);
+    TEST_EQUAL(pep_it->second.id_count, exp_it->second.id_count);
+    TEST_EQUAL(pep_it->second.accessions == exp_it->second.accessions, true);
+    TEST_EQUAL(pep_it->second.total_abundances == exp_it->second.total_abundances, true);
+  }
+  TEST_EQUAL(quantifier.getStatistics().total_features, quantifier_consensus.getStatistics().total_features);
+  TEST_EQUAL(quantifier.getStatistics().quant_features, quantifier_consensus.getStatistics().quant_features);
+
+  // map indexes beyond the experimental design:
+  quantifier.startQuantData(design);
+  TEST_EXCEPTION(Exception::IndexOverflow, quantifier.addQuantData(consensus, design.getNumberOfMSFiles()));
+}
+END_SECTION
+
+START_SECTION((void addQuantData(FeatureMap& features, Size ms_file_row)))
+{
+  // the same run added as two samples:
+  FeatureMap features;
+  FeatureXMLFile().load(OPENMS_GET_TEST_DATA_PATH("ProteinQuantifier_input.featureXML"), features);
+  ExperimentalDesign::MSFileSection rows(2);
+  for (Size i = 0; i < rows.size(); ++i)
+  {
+    rows[i].path = "run" + String(i + 1) + ".mzML";
+    rows[i].fraction = 1;
+    rows[i].fraction_group = i + 1;
+    rows[i].sample = i + 1;
+    rows[i].label = 1;
+  }
+  ExperimentalDesign design;
+  design.setMSFileSection(rows);
+
+  PeptideAndProteinQuant quantifier;
+  quantifier.setParameters(params);
+  quantifier.startQuantData(design);
+  quantifier.addQuantData(features, 0);
+  quantifier.addQuantData(features, 1);
+  TEST_EXCEPTION(Exception::IndexOverflow, quantifier.addQuantData(features, 2));
+  quantifier.finishQuantData();
+  quantifier.quantifyPeptides();
+
+  TEST_EQUAL(quantifier.getStatistics().n_samples, 2);
+  PeptideAndProteinQuant::PeptideQuant pep_quant = quantifier.getPeptideResults();
+  PeptideAndProteinQuant::PeptideQuant expected = quantifier_features.getPeptideResults();
+  TEST_EQUAL(pep_quant.size(), expected.size());
+  for (PeptideAndProteinQuant::PeptideQuant::iterator exp_it = expected.begin(); exp_it != expected.end(); ++exp_it)
+  {
+    const PeptideAndProteinQuant::PeptideData& data = pep_quant[exp_it->first];
+    TEST_EQUAL(data.id_count, 2 * exp_it->second.id_count);
+    if (exp_it->second.total_abundances.empty())
+    {
+      TEST_EQUAL(data.total_abundances.empty(), true);
+    }
+    else
+    {
+      TEST_EQUAL(data.total_abundances.size(), 2);
+      TEST_REAL_SIMILAR(data.total_abundances.find(1)->second, exp_it->second.total_abundances.find(1)->second);
+      TEST_REAL_SIMILAR(data.total_abundances.find(2)->second, exp_it->second.total_abundances.find(1)->second);
+    }
+  }
+}
+END_SECTION
+
+START_SECTION((void finishQuantData()))
+{
+  // tested with "addQuantData" above
+  NOT_TESTABLE
+}
+END_SECTION
+
 START_SECTION((void quantifyPeptides(const std::vector<PeptideIdentification>& peptides = std::vector<PeptideIdentification>())))
 {
   NOT_TESTABLE // tested together with the "readQuantData" methods
@@ -106,6 +106,17 @@ START_SECTION((PeptideHit(const PeptideHit& source)))
 	TEST_EQUAL((UInt)hit.getMetaValue("label"),17) 
 END_SECTION
 
+START_SECTION((PeptideHit(PeptideHit&& source) noexcept))
+	PeptideHit source(score, rank, charge, sequence);
+	PeptideHit hit(std::move(source));
+	TEST_EQUAL(hit.getSequence(), sequence)
+	// moved-from hit is still usable:
+	TEST_EQUAL(source.getSequence().empty(), true)
+	TEST_REAL_SIMILAR(source.getInternedSequence().getMonoWeight(), 0.0)
+	source.setSequence(sequence);
+	TEST_EQUAL(source.getSequence(), sequence)
+END_SECTION
+
 START_SECTION((bool operator == (const PeptideHit& rhs) const))
   PeptideHit hit, hit2;
   TEST_EQUAL(hit==hit2,true);
@@ -184,6 +195,22 @@ START_SECTION((void setSequence(const AASequence& sequence)))
 	TEST_EQUAL(hit.getSequence(), sequence)	
 END_SECTION
 
+START_SECTION((const InternedAASequence& getInternedSequence() const))
+	PeptideHit hit(score, rank, charge, sequence);
+	TEST_EQUAL(hit.getInternedSequence().getSequence(), sequence)
+	// copies of a hit share the sequence:
+	PeptideHit copy(hit);
+	TEST_EQUAL(&copy.getSequence(), &hit.getSequence())
+END_SECTION
+
+START_SECTION((void setSequence(const InternedAASequence& sequence)))
+	PeptideHit hit;
+	InternedAASequence interned(sequence);
+	hit.setSequence(interned);
+	TEST_EQUAL(hit.getSequence(), sequence)
+	TEST_EQUAL(&hit.getSequence(), &interned.getSequence())
+END_SECTION
+
         ;
 START_SECTION((void setPeptideEvidences(const vector<PeptideEvidence> & peptide_evidences)))
      PeptideHit hit;
@@ -0,0 +1,212 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/SYSTEM/Profiler.h>
+///////////////////////////
+
+#include <OpenMS/CONCEPT/ProgressLogger.h>
+
+#include <sstream>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(Profiler, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+START_SECTION((static bool isEnabled()))
+{
+  TEST_EQUAL(Profiler::isEnabled(), false)
+  Profiler::enable();
+  TEST_EQUAL(Profiler::isEnabled(), true)
+  Profiler::disable();
+  TEST_EQUAL(Profiler::isEnabled(), false)
+}
+END_SECTION
+
+START_SECTION((static SpanId beginSpan(const String& name, const String& category = "algorithm")))
+{
+  Profiler::clear();
+  // disabled: nothing is recorded
+  Profiler::SpanId id = Profiler::beginSpan("disabled");
+  TEST_EQUAL(id == Profiler::INVALID_SPAN, true)
+  Profiler::endSpan(id);
+  TEST_EQUAL(Profiler::getSpans().size(), 0)
+
+  Profiler::enable();
+  Profiler::SpanId outer = Profiler::beginSpan("outer", "tool");
+  Profiler::SpanId inner = Profiler::beginSpan("inner");
+  TEST_NOT_EQUAL(outer, inner)
+  Profiler::endSpan(inner, 42);
+  Profiler::endSpan(inner); // closing twice is ignored and keeps the nesting depth
+  Profiler::SpanId next = Profiler::beginSpan("next");
+  Profiler::endSpan(next);
+  Profiler::endSpan(outer);
+  Profiler::endSpan(outer); // closing twice is ignored
+  Profiler::SpanId last = Profiler::beginSpan("last");
+  Profiler::endSpan(last);
+  Profiler::disable();
+
+  vector<Profiler::Span> spans = Profiler::getSpans();
+  TEST_EQUAL(spans.size(), 4)
+  ABORT_IF(spans.size() != 4)
+  TEST_EQUAL(spans[0].name, "inner")
+  TEST_EQUAL(spans[0].category, "algorithm")
+  TEST_EQUAL(spans[0].depth, 1)
+  TEST_EQUAL(spans[0].items, 42)
+  TEST_EQUAL(spans[1].name, "next")
+  TEST_EQUAL(spans[1].depth, 1)
+  TEST_EQUAL(spans[2].name, "outer")
+  TEST_EQUAL(spans[2].category, "tool")
+  TEST_EQUAL(spans[2].depth, 0)
+  TEST_EQUAL(spans[2].items, -1)
+  TEST_EQUAL(spans[3].name, "last")
+  TEST_EQUAL(spans[3].depth, 0)
+  TEST_EQUAL(spans[0].thread, spans[2].thread)
+  TEST_EQUAL(spans[2].start <= spans[0].start, true)
+  TEST_EQUAL(spans[2].wall_time >= spans[0].wall_time, true)
+}
+END_SECTION
+
+START_SECTION((static void clear()))
+{
+  Profiler::clear();
+  TEST_EQUAL(Profiler::getSpans().size(), 0)
+}
+END_SECTION
+
+START_SECTION((Scope(const char* name, const char* category = "algorithm")))
+{
+  Profiler::clear();
+  {
+    Profiler::Scope scope("not recorded");
+  }
+  TEST_EQUAL(Profiler::getSpans().size(), 0)
+
+  Profiler::enable();
+  {
+    Profiler::Scope scope("scope", "test");
+    scope.setItems(7);
+    OPENMS_PROFILE_SCOPE("macro");
+  }
+  Profiler::disable();
+  vector<Profiler::Span> spans = Profiler::getSpans();
+  TEST_EQUAL(spans.size(), 2)
+  ABORT_IF(spans.size() != 2)
+  TEST_EQUAL(spans[0].name, "macro")
+  TEST_EQUAL(spans[1].name, "scope")
+  TEST_EQUAL(spans[1].category, "test")
+  TEST_EQUAL(spans[1].items, 7)
+}
+END_SECTION
+
+START_SECTION([EXTRA] ProgressLogger records spans)
+{
+  Profiler::clear();
+  Profiler::enable();
+  ProgressLogger pl;
+  pl.startProgress(0, 10, "outer stage");
+  pl.startProgress(0, 0, "inner stage");
+  pl.endProgress();
+  pl.endProgress();
+  Profiler::disable();
+  vector<Profiler::Span> spans = Profiler::getSpans();
+  TEST_EQUAL(spans.size(), 2)
+  ABORT_IF(spans.size() != 2)
+  TEST_EQUAL(spans[0].name, "inner stage")
+  TEST_EQUAL(spans[0].category, "progress")
+  TEST_EQUAL(spans[0].items, -1)
+  TEST_EQUAL(spans[1].name, "outer stage")
+  TEST_EQUAL(spans[1].items, 10)
+}
+END_SECTION
+
+START_SECTION((static void writeChromeTrace(std::ostream& os)))
+{
+  Profiler::clear();
+  Profiler::enable();
+  Profiler::endSpan(Profiler::beginSpan("say \"hi\"", "test"), 3);
+  Profiler::disable();
+  stringstream ss;
+  Profiler::writeChromeTrace(ss);
+  String json = ss.str();
+  TEST_EQUAL(json.hasPrefix("{"), true)
+  TEST_EQUAL(json.hasSubstring("\"traceEvents\""), true)
+  TEST_EQUAL(json.hasSubstring("\"name\": \"say \\\"hi\\\"\""), true)
+  TEST_EQUAL(json.hasSubstring("\"ph\": \"X\""), true)
+  TEST_EQUAL(json.hasSubstring("\"items\": 3"), true)
+}
+END_SECTION
+
+START_SECTION((static void writeTSV(std::ostream& os)))
+{
+  stringstream ss;
+  Profiler::writeTSV(ss);
+  vector<String> lines;
+  String(ss.str()).trim().split('\n', lines);
+  TEST_EQUAL(lines.size(), 2)
+  ABORT_IF(lines.size() != 2)
+  TEST_EQUAL(lines[0].hasPrefix("name\tcategory\tthread"), true)
+  vector<String> cells;
+  lines[1].split('\t', cells);
+  TEST_EQUAL(cells.size(), 10)
+  TEST_EQUAL(cells[0], "say \"hi\"")
+  TEST_EQUAL(cells[9], "3")
+}
+END_SECTION
+
+START_SECTION((static void write(const String& filename)))
+{
+  String filename;
+  NEW_TMP_FILE(filename);
+  filename += ".tsv";
+  Profiler::write(filename);
+  ifstream is(filename.c_str());
+  String header;
+  getline(is, header);
+  TEST_EQUAL(header.hasPrefix("name\tcategory"), true)
+
+  TEST_EXCEPTION(Exception::UnableToCreateFile, Profiler::write("/does/not/exist/profile.json"))
+  Profiler::clear();
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
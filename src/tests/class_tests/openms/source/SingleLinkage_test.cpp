@@ -39,6 +39,7 @@
 #include <OpenMS/COMPARISON/CLUSTERING/SingleLinkage.h>
 #include <OpenMS/COMPARISON/CLUSTERING/ClusterAnalyzer.h>
 #include <OpenMS/DATASTRUCTURES/DistanceMatrix.h>
+#include <OpenMS/DATASTRUCTURES/SparseDistanceMatrix.h>
 #include <vector>
 ///////////////////////////
 
@@ -141,6 +142,81 @@ START_SECTION((void operator()(DistanceMatrix< float > &original_distance, std::
 }
 END_SECTION
 
+START_SECTION((void operator()(const SparseDistanceMatrix& distance, std::vector<BinaryTreeNode>& cluster_tree, const float threshold=1) const))
+{
+	DistanceMatrix<float> matrix(6,666);
+	matrix.setValue(1,0,0.5f);
+	matrix.setValue(2,0,0.8f);
+	matrix.setValue(2,1,0.3f);
+	matrix.setValue(3,0,0.6f);
+	matrix.setValue(3,1,0.8f);
+	matrix.setValue(3,2,0.8f);
+	matrix.setValue(4,0,0.8f);
+	matrix.setValue(4,1,0.8f);
+	matrix.setValue(4,2,0.8f);
+	matrix.setValue(4,3,0.4f);
+	matrix.setValue(5,0,0.7f);
+	matrix.setValue(5,1,0.8f);
+	matrix.setValue(5,2,0.8f);
+	matrix.setValue(5,3,0.8f);
+	matrix.setValue(5,4,0.8f);
+	SparseDistanceMatrix sparse(matrix, 1.0f);
+
+	// same tree as the DistanceMatrix version
+	vector< BinaryTreeNode > result;
+	vector< BinaryTreeNode > tree;
+	tree.push_back(BinaryTreeNode(1,2,0.3f));
+	tree.push_back(BinaryTreeNode(3,4,0.4f));
+	tree.push_back(BinaryTreeNode(0,1,0.5f));
+	tree.push_back(BinaryTreeNode(0,3,0.6f));
+	tree.push_back(BinaryTreeNode(0,5,0.7f));
+
+	(*ptr)(sparse,result);
+	TEST_EQUAL(tree.size(), result.size());
+	for (Size i = 0; i < result.size(); ++i)
+	{
+			TEST_EQUAL(tree[i].left_child, result[i].left_child);
+			TEST_EQUAL(tree[i].right_child, result[i].right_child);
+			TOLERANCE_ABSOLUTE(0.0001);
+			TEST_REAL_SIMILAR(tree[i].distance, result[i].distance);
+	}
+
+	// threshold is supported on sparse input
+	tree.pop_back();
+	tree.pop_back();
+	tree.push_back(BinaryTreeNode(0,3,-1.0f));
+	tree.push_back(BinaryTreeNode(0,5,-1.0f));
+	result.clear();
+
+	(*ptr)(sparse,result,0.55f);
+	TEST_EQUAL(tree.size(), result.size());
+	for (Size i = 0; i < result.size(); ++i)
+	{
+			TEST_EQUAL(tree[i].left_child, result[i].left_child);
+			TEST_EQUAL(tree[i].right_child, result[i].right_child);
+			TOLERANCE_ABSOLUTE(0.0001);
+			TEST_REAL_SIMILAR(tree[i].distance, result[i].distance);
+	}
+
+	// only the stored pairs are needed
+	SparseDistanceMatrix thresholded(matrix, 0.55f);
+	TEST_EQUAL(thresholded.size(), 3)
+	result.clear();
+	(*ptr)(thresholded,result,0.55f);
+	TEST_EQUAL(tree.size(), result.size());
+	for (Size i = 0; i < result.size(); ++i)
+	{
+			TEST_EQUAL(tree[i].left_child, result[i].left_child);
+			TEST_EQUAL(tree[i].right_child, result[i].right_child);
+			TOLERANCE_ABSOLUTE(0.0001);
+			TEST_REAL_SIMILAR(tree[i].distance, result[i].distance);
+	}
+
+	SparseDistanceMatrix single(1, vector<SparseDistanceMatrix::Entry>());
+	TEST_EXCEPTION(ClusterFunctor::InsufficientInput, (*ptr)(single,result))
+}
+END_SECTION
+
 START_SECTION((static const String getProductName()))
 {
   TEST_EQUAL(ptr->getProductName(), "SingleLinkage")
@@ -0,0 +1,195 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Mathias Walzer $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/DATASTRUCTURES/SparseDistanceMatrix.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(SparseDistanceMatrix, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+SparseDistanceMatrix* ptr = nullptr;
+SparseDistanceMatrix* nullPointer = nullptr;
+START_SECTION(SparseDistanceMatrix())
+{
+  ptr = new SparseDistanceMatrix();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->dimensionsize(), 0)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_EQUAL(ptr->getRowOffsets().size(), 1)
+}
+END_SECTION
+
+START_SECTION(~SparseDistanceMatrix())
+{
+  delete ptr;
+}
+END_SECTION
+
+vector<SparseDistanceMatrix::Entry> entries;
+entries.push_back(SparseDistanceMatrix::Entry(1, 0, 0.5f));
+entries.push_back(SparseDistanceMatrix::Entry(2, 3, 0.25f));
+entries.push_back(SparseDistanceMatrix::Entry(3, 2, 0.125f)); // duplicate, smaller value is kept
+entries.push_back(SparseDistanceMatrix::Entry(0, 3, 0.75f));
+entries.push_back(SparseDistanceMatrix::Entry(4, 4, 0.1f)); // main diagonal, ignored
+
+START_SECTION((SparseDistanceMatrix(Size dimensionsize, const std::vector<Entry>& entries, float missing_value = 1)))
+{
+  SparseDistanceMatrix sdm(5, entries);
+  TEST_EQUAL(sdm.dimensionsize(), 5)
+  TEST_EQUAL(sdm.size(), 3)
+  TEST_REAL_SIMILAR(sdm.getMissingValue(), 1.0)
+
+  SparseDistanceMatrix sdm2(5, entries, 2.0f);
+  TEST_REAL_SIMILAR(sdm2.getMissingValue(), 2.0)
+
+  vector<SparseDistanceMatrix::Entry> wrong(1, SparseDistanceMatrix::Entry(0, 5, 0.1f));
+  TEST_EXCEPTION(Exception::IndexOverflow, SparseDistanceMatrix(5, wrong))
+}
+END_SECTION
+
+START_SECTION((SparseDistanceMatrix(const DistanceMatrix<float>& matrix, float cutoff, float missing_value = 1)))
+{
+  DistanceMatrix<float> dm(4, 1);
+  dm.setValue(1, 0, 0.5f);
+  dm.setValue(2, 1, 0.9f);
+  dm.setValue(3, 2, 0.2f);
+
+  SparseDistanceMatrix sdm(dm, 0.6f);
+  TEST_EQUAL(sdm.dimensionsize(), 4)
+  TEST_EQUAL(sdm.size(), 2)
+  TEST_REAL_SIMILAR(sdm.getValue(0, 1), 0.5)
+  TEST_REAL_SIMILAR(sdm.getValue(2, 3), 0.2)
+  TEST_EQUAL(sdm.hasValue(1, 2), false)
+  TEST_REAL_SIMILAR(sdm.getValue(1, 2), 1.0)
+}
+END_SECTION
+
+START_SECTION((bool operator==(const SparseDistanceMatrix& rhs) const))
+{
+  SparseDistanceMatrix sdm(5, entries), sdm2(5, entries), sdm3(6, entries), sdm4(5, entries, 2.0f);
+  TEST_EQUAL(sdm == sdm2, true)
+  TEST_EQUAL(sdm == sdm3, false)
+  TEST_EQUAL(sdm == sdm4, false)
+}
+END_SECTION
+
+SparseDistanceMatrix sdm(5, entries);
+
+START_SECTION((Size dimensionsize() const))
+{
+  TEST_EQUAL(sdm.dimensionsize(), 5)
+}
+END_SECTION
+
+START_SECTION((Size size() const))
+{
+  TEST_EQUAL(sdm.size(), 3)
+}
+END_SECTION
+
+START_SECTION((float getMissingValue() const))
+{
+  TEST_REAL_SIMILAR(sdm.getMissingValue(), 1.0)
+}
+END_SECTION
+
+START_SECTION((bool hasValue(Size i, Size j) const))
+{
+  TEST_EQUAL(sdm.hasValue(0, 1), true)
+  TEST_EQUAL(sdm.hasValue(1, 0), true)
+  TEST_EQUAL(sdm.hasValue(2, 3), true)
+  TEST_EQUAL(sdm.hasValue(1, 2), false)
+  TEST_EQUAL(sdm.hasValue(4, 4), false)
+  TEST_EQUAL(sdm.hasValue(0, 7), false)
+}
+END_SECTION
+
+START_SECTION((float getValue(Size i, Size j) const))
+{
+  TEST_REAL_SIMILAR(sdm.getValue(0, 1), 0.5)
+  TEST_REAL_SIMILAR(sdm.getValue(1, 0), 0.5)
+  TEST_REAL_SIMILAR(sdm.getValue(2, 3), 0.125)
+  TEST_REAL_SIMILAR(sdm.getValue(3, 0), 0.75)
+  TEST_REAL_SIMILAR(sdm.getValue(1, 2), 1.0)
+  TEST_REAL_SIMILAR(sdm.getValue(4, 4), 0.0)
+  TEST_EXCEPTION(Exception::IndexOverflow, sdm.getValue(5, 0))
+}
+END_SECTION
+
+START_SECTION((const std::vector<Size>& getRowOffsets() const))
+{
+  // row 0: 1, 3; row 1: 0; row 2: 3; row 3: 0, 2; row 4: -
+  TEST_EQUAL(sdm.getRowOffsets().size(), 6)
+  TEST_EQUAL(sdm.getRowOffsets()[0], 0)
+  TEST_EQUAL(sdm.getRowOffsets()[1], 2)
+  TEST_EQUAL(sdm.getRowOffsets()[2], 3)
+  TEST_EQUAL(sdm.getRowOffsets()[3], 4)
+  TEST_EQUAL(sdm.getRowOffsets()[4], 6)
+  TEST_EQUAL(sdm.getRowOffsets()[5], 6)
+}
+END_SECTION
+
+START_SECTION((const std::vector<Size>& getColumns() const))
+{
+  TEST_EQUAL(sdm.getColumns().size(), 6)
+  TEST_EQUAL(sdm.getColumns()[0], 1)
+  TEST_EQUAL(sdm.getColumns()[1], 3)
+  TEST_EQUAL(sdm.getColumns()[2], 0)
+  TEST_EQUAL(sdm.getColumns()[3], 3)
+  TEST_EQUAL(sdm.getColumns()[4], 0)
+  TEST_EQUAL(sdm.getColumns()[5], 2)
+}
+END_SECTION
+
+START_SECTION((const std::vector<float>& getValues() const))
+{
+  TEST_EQUAL(sdm.getValues().size(), 6)
+  TEST_REAL_SIMILAR(sdm.getValues()[0], 0.5)
+  TEST_REAL_SIMILAR(sdm.getValues()[1], 0.75)
+  TEST_REAL_SIMILAR(sdm.getValues()[5], 0.125)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
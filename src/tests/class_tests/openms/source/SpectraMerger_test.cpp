@@ -144,6 +144,35 @@ START_SECTION((template < typename MapType > void mergeSpectraPrecursors(MapType
     TEST_EQUAL(exp[i].getMSLevel (), exp2[i].getMSLevel ())
   }
 
+  // single linkage: spectra are merged via chains of neighbours
+  // (RT 0 and 8 are too far apart, but both are linked to RT 4)
+  PeakMap chain;
+  double rts[] = {0.0, 4.0, 8.0, 100.0};
+  for (Size i = 0; i < 4; ++i)
+  {
+    MSSpectrum spec;
+    spec.setMSLevel(2);
+    spec.setRT(rts[i]);
+    std::vector<Precursor> precursors(1);
+    precursors[0].setMZ(500.0);
+    spec.setPrecursors(precursors);
+    Peak1D peak;
+    peak.setMZ(100.0 + i);
+    peak.setIntensity(1.0);
+    spec.push_back(peak);
+    chain.addSpectrum(spec);
+  }
+  merger.mergeSpectraPrecursors(chain);
+  TEST_EQUAL(chain.size(), 2)
+  ABORT_IF(chain.size() != 2)
+  TEST_EQUAL(chain[0].size(), 3)
+  TEST_EQUAL(chain[1].size(), 1)
+
+  // nothing to cluster:
+  PeakMap empty;
+  merger.mergeSpectraPrecursors(empty);
+  TEST_EQUAL(empty.size(), 0)
+
 END_SECTION
 
 START_SECTION((template < typename MapType > void averageGaussian(MapType &exp)))
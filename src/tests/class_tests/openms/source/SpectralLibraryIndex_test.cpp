@@ -0,0 +1,210 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg$
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/COMPARISON/SPECTRA/SpectralLibraryIndex.h>
+#include <OpenMS/COMPARISON/SPECTRA/SpectraSTSimilarityScore.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+PeakSpectrum makeSpectrum(double precursor_mz, const vector<pair<double, double> >& peaks)
+{
+  PeakSpectrum spec;
+  if (precursor_mz > 0)
+  {
+    Precursor prec;
+    prec.setMZ(precursor_mz);
+    spec.getPrecursors().push_back(prec);
+  }
+  for (const auto& p : peaks)
+  {
+    spec.push_back(Peak1D(p.first, p.second));
+  }
+  return spec;
+}
+
+START_TEST(SpectralLibraryIndex, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+SpectralLibraryIndex* ptr = nullptr;
+SpectralLibraryIndex* null_ptr = nullptr;
+START_SECTION((SpectralLibraryIndex(float bin_size = 1.0f, UInt bin_spread = 1, float offset = BinnedSpectrum::DEFAULT_BIN_OFFSET_LOWRES, Size top_bins = 5)))
+{
+  ptr = new SpectralLibraryIndex();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_EQUAL(ptr->getNumberOfTopBins(), 5)
+}
+END_SECTION
+
+START_SECTION((virtual ~SpectralLibraryIndex()))
+{
+  delete ptr;
+}
+END_SECTION
+
+vector<PeakSpectrum> library;
+library.push_back(makeSpectrum(500.0, {{100.2, 10.0}, {200.2, 5.0}, {300.2, 1.0}}));
+library.push_back(makeSpectrum(400.0, {{150.2, 10.0}, {250.2, 8.0}}));
+library.push_back(makeSpectrum(500.0, {{100.2, 1.0}, {600.2, 10.0}}));
+library.push_back(makeSpectrum(600.0, {{100.2, 3.0}}));
+
+PeakSpectrum query = makeSpectrum(500.0, {{100.3, 10.0}, {250.3, 1.0}});
+
+// one bin per Th, no spread, only the most intense bin is indexed:
+SpectralLibraryIndex index(1.0f, 0, 0.0f, 1);
+
+START_SECTION((void build(const std::vector<PeakSpectrum>& library)))
+{
+  index.build(library);
+  TEST_EQUAL(index.size(), 4)
+
+  SpectralLibraryIndex other;
+  vector<PeakSpectrum> no_precursor(1, makeSpectrum(0.0, {{100.0, 1.0}}));
+  TEST_EXCEPTION(Exception::MissingInformation, other.build(no_precursor))
+}
+END_SECTION
+
+START_SECTION((Size size() const))
+{
+  TEST_EQUAL(index.size(), 4)
+}
+END_SECTION
+
+START_SECTION((Size getNumberOfTopBins() const))
+{
+  TEST_EQUAL(index.getNumberOfTopBins(), 1)
+}
+END_SECTION
+
+START_SECTION((std::vector<Size> findByPrecursor(double min_mz, double max_mz) const))
+{
+  vector<Size> result = index.findByPrecursor(499.0, 501.0);
+  ABORT_IF(result.size() != 2)
+  TEST_EQUAL(result[0], 0)
+  TEST_EQUAL(result[1], 2)
+
+  // sorted by precursor m/z, window boundaries are included:
+  result = index.findByPrecursor(400.0, 600.0);
+  ABORT_IF(result.size() != 4)
+  TEST_EQUAL(result[0], 1)
+  TEST_EQUAL(result[1], 0)
+  TEST_EQUAL(result[2], 2)
+  TEST_EQUAL(result[3], 3)
+
+  TEST_EQUAL(index.findByPrecursor(700.0, 800.0).size(), 0)
+  TEST_EQUAL(index.findByPrecursor(501.0, 499.0).size(), 0)
+}
+END_SECTION
+
+START_SECTION((std::vector<Size> findCandidates(const BinnedSpectrum& query, double min_mz, double max_mz, Size min_shared_bins) const))
+{
+  BinnedSpectrum binned = index.binSpectrum(query);
+  vector<Size> result = index.findCandidates(binned, 499.0, 501.0, 0);
+  TEST_EQUAL(result == index.findByPrecursor(499.0, 501.0), true)
+
+  // only library spectrum 0 has the same most intense bin:
+  result = index.findCandidates(binned, 499.0, 501.0, 1);
+  ABORT_IF(result.size() != 1)
+  TEST_EQUAL(result[0], 0)
+
+  result = index.findCandidates(binned, 0.0, 1000.0, 1);
+  ABORT_IF(result.size() != 2)
+  TEST_EQUAL(result[0], 0)
+  TEST_EQUAL(result[1], 3)
+
+  TEST_EQUAL(index.findCandidates(binned, 0.0, 1000.0, 2).size(), 0)
+}
+END_SECTION
+
+START_SECTION((const BinnedSpectrum& getBinnedSpectrum(Size index) const))
+{
+  const BinnedSpectrum& binned = index.getBinnedSpectrum(0);
+  TEST_EQUAL(binned.getBins().nonZeros(), 3)
+  TEST_REAL_SIMILAR(binned.getBins().norm(), 1.0)
+  TEST_EXCEPTION(Exception::IndexOverflow, index.getBinnedSpectrum(4))
+}
+END_SECTION
+
+START_SECTION((BinnedSpectrum binSpectrum(const PeakSpectrum& spectrum) const))
+{
+  BinnedSpectrum binned = index.binSpectrum(query);
+  TEST_EQUAL(binned.getBins().nonZeros(), 2)
+  TEST_REAL_SIMILAR(binned.getBins().norm(), 1.0)
+
+  // empty spectra can still be compared:
+  BinnedSpectrum empty = index.binSpectrum(PeakSpectrum());
+  TEST_EQUAL(empty.getBins().nonZeros(), 0)
+  TEST_REAL_SIMILAR(empty.getBins().dot(binned.getBins()), 0.0)
+
+  // default settings reproduce SpectraST scores:
+  SpectralLibraryIndex spectrast_index;
+  spectrast_index.build(library);
+  SpectraSTSimilarityScore spectrast;
+  BinnedSpectrum spectrast_query = spectrast_index.binSpectrum(query);
+  for (Size i = 0; i < library.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(spectrast(spectrast_query, spectrast_index.getBinnedSpectrum(i)), spectrast(query, library[i]))
+  }
+}
+END_SECTION
+
+START_SECTION((std::vector<BinIndex> getTopBins(const BinnedSpectrum& binned) const))
+{
+  vector<SpectralLibraryIndex::BinIndex> top = index.getTopBins(index.getBinnedSpectrum(0));
+  ABORT_IF(top.size() != 1)
+  TEST_EQUAL(top[0], 100)
+
+  SpectralLibraryIndex index2(1.0f, 0, 0.0f, 2);
+  top = index2.getTopBins(index2.binSpectrum(library[2]));
+  ABORT_IF(top.size() != 2)
+  TEST_EQUAL(top[0], 100)
+  TEST_EQUAL(top[1], 600)
+
+  // fewer bins than requested:
+  top = index2.getTopBins(index2.binSpectrum(library[3]));
+  TEST_EQUAL(top.size(), 1)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -77,4 +77,19 @@ START_SECTION(static bool getProcessMemoryConsumption(size_t& mem_virtual))
 }
 END_SECTION
 
+START_SECTION(static bool getProcessPeakMemoryConsumption(size_t& mem_virtual))
+{
+  size_t current, peak;
+  TEST_EQUAL(SysInfo::getProcessMemoryConsumption(current), true);
+  if (SysInfo::getProcessPeakMemoryConsumption(peak))
+  {
+    TEST_EQUAL(peak > 0, true)
+  }
+  else
+  { // not supported on this platform
+    TEST_EQUAL(peak, 0)
+  }
+}
+END_SECTION
+
 END_TEST
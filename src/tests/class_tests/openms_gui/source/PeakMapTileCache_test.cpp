@@ -0,0 +1,247 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+
+///////////////////////////
+#include <OpenMS/VISUAL/PeakMapTileCache.h>
+///////////////////////////
+
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(PeakMapTileCache, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+// four MS1 spectra (RT 0, 10, 20, 30) with peaks at m/z 100 and 1100, and one MS2 spectrum
+PeakMap exp;
+for (Size i = 0; i < 4; ++i)
+{
+  MSSpectrum spec;
+  spec.setRT(10.0 * i);
+  spec.setMSLevel(1);
+  Peak1D p;
+  p.setMZ(100.0);
+  p.setIntensity(i + 1.0);
+  spec.push_back(p);
+  p.setMZ(1100.0);
+  p.setIntensity(10.0 * (i + 1));
+  spec.push_back(p);
+  exp.addSpectrum(spec);
+  if (i == 1)
+  {
+    MSSpectrum ms2;
+    ms2.setRT(15.0);
+    ms2.setMSLevel(2);
+    p.setMZ(500.0);
+    p.setIntensity(1000.0);
+    ms2.push_back(p);
+    exp.addSpectrum(ms2);
+  }
+}
+
+PeakMapTileCache* ptr = nullptr;
+PeakMapTileCache* null_ptr = nullptr;
+START_SECTION((PeakMapTileCache(Size rt_bins = 2048, Size mz_bins = 2048)))
+{
+  ptr = new PeakMapTileCache();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->isReady(), false)
+  TEST_EQUAL(ptr->getLevelCount(), 0)
+}
+END_SECTION
+
+START_SECTION((~PeakMapTileCache()))
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((void build(const PeakMap& map)))
+{
+  PeakMapTileCache cache(16, 8);
+  cache.build(exp);
+  TEST_EQUAL(cache.isReady(), true)
+  TEST_REAL_SIMILAR(cache.getRTMin(), 0.0)
+  TEST_REAL_SIMILAR(cache.getRTMax(), 30.0)
+  TEST_REAL_SIMILAR(cache.getMZMin(), 100.0)
+  TEST_REAL_SIMILAR(cache.getMZMax(), 1100.0)
+  // 4x8 (RT bins limited by the number of MS1 spectra), 2x4, 1x2, 1x1
+  TEST_EQUAL(cache.getLevelCount(), 4)
+  ABORT_IF(cache.getLevelCount() != 4)
+
+  const PeakMapTileCache::Level& fine = cache.getLevel(0);
+  TEST_EQUAL(fine.rt_bins, 4)
+  TEST_EQUAL(fine.mz_bins, 8)
+  TEST_REAL_SIMILAR(fine.maxAt(0, 0), 1.0)
+  TEST_REAL_SIMILAR(fine.maxAt(0, 7), 10.0)
+  TEST_REAL_SIMILAR(fine.maxAt(3, 7), 40.0)
+  TEST_REAL_SIMILAR(fine.maxAt(1, 3), -1.0) // MS2 peaks are ignored
+  TEST_REAL_SIMILAR(fine.sumAt(2, 0), 3.0)
+
+  const PeakMapTileCache::Level& mid = cache.getLevel(1);
+  TEST_EQUAL(mid.rt_bins, 2)
+  TEST_EQUAL(mid.mz_bins, 4)
+  TEST_REAL_SIMILAR(mid.maxAt(1, 3), 40.0)
+  TEST_REAL_SIMILAR(mid.sumAt(1, 3), 70.0)
+
+  const PeakMapTileCache::Level& top = cache.getLevel(3);
+  TEST_EQUAL(top.rt_bins, 1)
+  TEST_EQUAL(top.mz_bins, 1)
+  TEST_REAL_SIMILAR(top.maxAt(0, 0), 40.0)
+  TEST_REAL_SIMILAR(top.sumAt(0, 0), 110.0)
+
+  TEST_EXCEPTION(Exception::IndexOverflow, cache.getLevel(4))
+
+  // no MS1 data
+  PeakMap empty;
+  cache.build(empty);
+  TEST_EQUAL(cache.isReady(), false)
+  TEST_EQUAL(cache.getLevelCount(), 0)
+}
+END_SECTION
+
+START_SECTION((Int selectLevel(double rt_pixel_size, double mz_pixel_size) const))
+{
+  PeakMapTileCache cache(16, 8);
+  TEST_EQUAL(cache.selectLevel(100.0, 10000.0), -1) // not ready
+  cache.build(exp);
+  TEST_EQUAL(cache.selectLevel(7.5, 125.0), 0)
+  TEST_EQUAL(cache.selectLevel(15.0, 250.0), 1)
+  TEST_EQUAL(cache.selectLevel(100.0, 10000.0), 3)
+  TEST_EQUAL(cache.selectLevel(1.0, 1.0), -1) // zoomed in too far
+}
+END_SECTION
+
+START_SECTION((void sampleMaxima(Size level_index, double rt_min, double rt_max, double mz_min, double mz_max, Size rt_pixel_count, Size mz_pixel_count, std::vector<float>& pixels) const))
+{
+  PeakMapTileCache cache(16, 8);
+  cache.build(exp);
+  std::vector<float> pixels;
+
+  // one pixel per tile
+  cache.sampleMaxima(0, 0.0, 30.0, 100.0, 1100.0, 4, 8, pixels);
+  TEST_EQUAL(pixels.size(), 32)
+  TEST_REAL_SIMILAR(pixels[0], 1.0)
+  TEST_REAL_SIMILAR(pixels[1], -1.0)
+  TEST_REAL_SIMILAR(pixels[7], 10.0)
+  TEST_REAL_SIMILAR(pixels[3 * 8 + 7], 40.0)
+
+  // everything in one pixel
+  cache.sampleMaxima(0, 0.0, 30.0, 100.0, 1100.0, 1, 1, pixels);
+  TEST_EQUAL(pixels.size(), 1)
+  TEST_REAL_SIMILAR(pixels[0], 40.0)
+
+  // view covering only the low m/z tiles of the first two spectra
+  cache.sampleMaxima(0, 0.0, 15.0, 100.0, 350.0, 2, 2, pixels);
+  TEST_REAL_SIMILAR(pixels[0], 1.0)
+  TEST_REAL_SIMILAR(pixels[1], -1.0)
+  TEST_REAL_SIMILAR(pixels[2], 2.0)
+  TEST_REAL_SIMILAR(pixels[3], -1.0)
+}
+END_SECTION
+
+START_SECTION((void buildAsync(ConstExperimentSharedPtrType map, const String& store_filename = "", const String& data_filename = "")))
+{
+  PeakMapTileCache cache(16, 8);
+  cache.buildAsync(PeakMapTileCache::ConstExperimentSharedPtrType(new PeakMap(exp)));
+  while (cache.isBuilding())
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  TEST_EQUAL(cache.isReady(), true)
+  TEST_EQUAL(cache.getLevelCount(), 4)
+}
+END_SECTION
+
+START_SECTION((bool store(const String& filename, const String& data_filename) const))
+{
+  String data_file, tile_file;
+  NEW_TMP_FILE(data_file);
+  NEW_TMP_FILE(tile_file);
+  {
+    std::ofstream os(data_file.c_str());
+    os << "placeholder for the peak map file";
+  }
+  PeakMapTileCache cache(16, 8);
+  TEST_EQUAL(cache.store(tile_file, data_file), false) // not ready
+  cache.build(exp);
+  TEST_EQUAL(cache.store(tile_file, data_file), true)
+
+  PeakMapTileCache loaded(16, 8);
+  TEST_EQUAL(loaded.load(tile_file, data_file, exp), true)
+  TEST_EQUAL(loaded.isReady(), true)
+  TEST_EQUAL(loaded.getLevelCount(), 4)
+  TEST_REAL_SIMILAR(loaded.getMZMax(), 1100.0)
+  TEST_EQUAL(loaded.getLevel(0).max == cache.getLevel(0).max, true)
+  TEST_EQUAL(loaded.getLevel(2).sum == cache.getLevel(2).sum, true)
+
+  // different resolution
+  PeakMapTileCache other_resolution(16, 16);
+  TEST_EQUAL(other_resolution.load(tile_file, data_file, exp), false)
+  TEST_EQUAL(other_resolution.isReady(), false)
+
+  // different data
+  PeakMap changed = exp;
+  changed[0].push_back(changed[0].back());
+  TEST_EQUAL(loaded.load(tile_file, data_file, changed), false)
+  TEST_EQUAL(loaded.isReady(), false)
+
+  // not a tile file
+  TEST_EQUAL(loaded.load(data_file, data_file, exp), false)
+}
+END_SECTION
+
+START_SECTION((bool load(const String& filename, const String& data_filename, const PeakMap& map)))
+{
+  NOT_TESTABLE // see store()
+}
+END_SECTION
+
+START_SECTION((static String cacheFilename(const String& data_filename)))
+{
+  TEST_EQUAL(PeakMapTileCache::cacheFilename("/data/run.mzML"), "/data/run.mzML.tiles")
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
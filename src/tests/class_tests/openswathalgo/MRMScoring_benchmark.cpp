@@ -0,0 +1,169 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Hannes Roest $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/OPENSWATHALGO/ALGO/MRMScoring.h>
+#include <OpenMS/OPENSWATHALGO/ALGO/Scoring.h>
+#include <OpenMS/OPENSWATHALGO/DATAACCESS/MockObjects.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace OpenMS;
+using namespace OpenSwath;
+using namespace std;
+
+/*
+  Computes the cross-correlation and mutual information matrices of N peak
+  groups with T transitions of L data points each (N = 2000, T = 8, L = 60 by
+  default):
+
+  - pairwise: one Scoring::normalizedCrossCorrelation and one
+              Scoring::rankedMutualInformation call per transition pair
+              (traces fetched, standardized and ranked for every pair)
+  - matrix:   MRMScoring::initializeXCorrMatrix/initializeMIMatrix (traces
+              fetched, standardized and ranked once per peak group)
+
+  Usage: MRMScoring_benchmark [N [T [L]]]
+*/
+
+namespace
+{
+  void randomPeakGroup(Size n_transitions, Size length, mt19937& rng,
+                       MockMRMFeature& feature, vector<string>& native_ids)
+  {
+    normal_distribution<double> noise(0.0, 0.1);
+    uniform_real_distribution<double> shift(-3.0, 3.0);
+    uniform_real_distribution<double> height(10.0, 1000.0);
+    native_ids.clear();
+    for (Size t = 0; t < n_transitions; ++t)
+    {
+      boost::shared_ptr<MockFeature> trace(new MockFeature());
+      double apex = length / 2.0 + shift(rng), scale = height(rng);
+      for (Size i = 0; i < length; ++i)
+      {
+        double x = (i - apex) / (length / 8.0);
+        trace->m_intensity_vec.push_back(max(0.0, scale * (exp(-x * x / 2.0) + noise(rng))));
+      }
+      native_ids.push_back("transition_" + to_string(t));
+      feature.m_features[native_ids.back()] = trace;
+    }
+  }
+}
+
+int main(int argc, const char** argv)
+{
+  Size n = 2000, n_transitions = 8, length = 60;
+  if (argc > 1) n = static_cast<Size>(atoi(argv[1]));
+  if (argc > 2) n_transitions = static_cast<Size>(atoi(argv[2]));
+  if (argc > 3) length = static_cast<Size>(atoi(argv[3]));
+
+  mt19937 rng(42);
+  vector<MockMRMFeature> features(n);
+  vector<vector<string> > native_ids(n);
+  for (Size k = 0; k < n; ++k)
+  {
+    randomPeakGroup(n_transitions, length, rng, features[k], native_ids[k]);
+  }
+
+  // pairwise:
+  vector<MRMScoring::XCorrMatrixType> xcorr_pairwise(n);
+  vector<vector<vector<double> > > mi_pairwise(n);
+  StopWatch sw;
+  sw.start();
+  for (Size k = 0; k < n; ++k)
+  {
+    const vector<string>& ids = native_ids[k];
+    xcorr_pairwise[k].resize(ids.size(), vector<MRMScoring::XCorrArrayType>(ids.size()));
+    mi_pairwise[k].resize(ids.size(), vector<double>(ids.size()));
+    vector<double> intensity_i, intensity_j;
+    for (Size i = 0; i < ids.size(); ++i)
+    {
+      for (Size j = i; j < ids.size(); ++j)
+      {
+        intensity_i.clear();
+        intensity_j.clear();
+        features[k].getFeature(ids[i])->getIntensity(intensity_i);
+        features[k].getFeature(ids[j])->getIntensity(intensity_j);
+        mi_pairwise[k][i][j] = Scoring::rankedMutualInformation(intensity_i, intensity_j);
+        xcorr_pairwise[k][i][j] = Scoring::normalizedCrossCorrelation(intensity_i, intensity_j, int(intensity_i.size()), 1);
+      }
+    }
+  }
+  sw.stop();
+  double t_pairwise = sw.getClockTime();
+
+  // matrix:
+  vector<MRMScoring> scorings(n);
+  sw.reset();
+  sw.start();
+  for (Size k = 0; k < n; ++k)
+  {
+    scorings[k].initializeXCorrMatrix(&features[k], native_ids[k]);
+    scorings[k].initializeMIMatrix(&features[k], native_ids[k]);
+  }
+  sw.stop();
+  double t_matrix = sw.getClockTime();
+
+  double max_xcorr_diff(0), max_mi_diff(0);
+  for (Size k = 0; k < n; ++k)
+  {
+    for (Size i = 0; i < n_transitions; ++i)
+    {
+      for (Size j = i; j < n_transitions; ++j)
+      {
+        max_mi_diff = max(max_mi_diff, fabs(mi_pairwise[k][i][j] - scorings[k].getMIMatrix()[i][j]));
+        const MRMScoring::XCorrArrayType& a = xcorr_pairwise[k][i][j];
+        const MRMScoring::XCorrArrayType& b = scorings[k].getXCorrMatrix()[i][j];
+        for (Size d = 0; d < a.data.size(); ++d)
+        {
+          max_xcorr_diff = max(max_xcorr_diff, fabs(a.data[d].second - b.data[d].second));
+        }
+      }
+    }
+  }
+
+  cout << n << " peak groups, " << n_transitions << " transitions, " << length << " data points" << "\n"
+       << "  pairwise: " << t_pairwise << " s" << "\n"
+       << "  matrix:   " << t_matrix << " s (x" << t_pairwise / max(t_matrix, 1e-9) << ")" << "\n"
+       << "  max. cross-correlation difference: " << max_xcorr_diff << "\n"
+       << "  max. mutual information difference: " << max_mi_diff << endl;
+
+  return 0;
+}
@@ -220,6 +220,38 @@ BOOST_AUTO_TEST_CASE(test_calculateCrossCorrelation)
 }
 END_SECTION
 
+BOOST_AUTO_TEST_CASE(test_calculateCrossCorrelation_arrays)
+//START_SECTION((void calculateCrossCorrelation(const double* data1, const double* data2, int datasize, int maxdelay, double* result)))
+{
+  static const double arr1[] = {0,1,3,5,2,0};
+  static const double arr2[] = {1,3,5,2,0,0};
+  std::vector<double> data1 (arr1, arr1 + sizeof(arr1) / sizeof(arr1[0]) );
+  std::vector<double> data2 (arr2, arr2 + sizeof(arr2) / sizeof(arr2[0]) );
+
+  Scoring::standardize_data(data1);
+  Scoring::standardize_data(data2);
+
+  std::vector<double> result(2 * 6 + 1);
+  Scoring::calculateCrossCorrelation(&data1[0], &data2[0], 6, 6, &result[0]);
+
+  TEST_REAL_SIMILAR (result[6 + 2] / 6.0, -0.7374631);
+  TEST_REAL_SIMILAR (result[6 + 1] / 6.0, -0.567846);
+  TEST_REAL_SIMILAR (result[6 + 0] / 6.0,  0.4159292);
+  TEST_REAL_SIMILAR (result[6 - 1] / 6.0,  0.8215339);
+  TEST_REAL_SIMILAR (result[6 - 2] / 6.0,  0.15634218);
+
+  // same result as the per-delay computation (lag 2 takes that code path):
+  OpenSwath::Scoring::XCorrArrayType expected = Scoring::calculateCrossCorrelation(data1, data2, 6, 2);
+  for (OpenSwath::Scoring::XCorrArrayType::iterator it = expected.begin(); it != expected.end(); ++it)
+  {
+    TEST_EQUAL (result[6 + it->first], it->second)
+  }
+  // no overlap of the data at the largest delays:
+  TEST_EQUAL (result[0], 0.0)
+  TEST_EQUAL (result[12], 0.0)
+}
+END_SECTION
+
 BOOST_AUTO_TEST_CASE(test_MRMFeatureScoring_normalizedCrossCorrelation)
 //START_SECTION((MRMFeatureScoring::XCorrArrayType MRMFeatureScoring::normalizedCrossCorrelation(std::vector<double>& data1, std::vector<double>& data2, int maxdelay, int lag)))
 {
@@ -353,6 +385,31 @@ m1 = mi(x_ranking,y_ranking)
 }
 END_SECTION
 
+BOOST_AUTO_TEST_CASE(test_rankedMutualInformation_ranks)
+{
+  static const double arr1[] =
+  {
+    5.97543668746948, 4.2749171257019, 3.3301842212677, 4.08597040176392, 5.50307035446167, 5.24326848983765,
+    8.40812492370605, 2.83419919013977, 6.94378805160522, 7.69957494735718, 4.08597040176392
+  };
+  static const double arr2[] =
+  {
+    15.8951349258423, 41.5446395874023, 76.0746307373047, 109.069435119629, 111.90364074707, 169.79216003418,
+    121.043930053711, 63.0136985778809, 44.6150207519531, 21.4926776885986, 7.93575811386108
+  };
+  std::vector<double> data1 (arr1, arr1 + sizeof(arr1) / sizeof(arr1[0]) );
+  std::vector<double> data2 (arr2, arr2 + sizeof(arr2) / sizeof(arr2[0]) );
+
+  std::vector<unsigned int> ranks1 = Scoring::computeRank(data1);
+  std::vector<unsigned int> ranks2 = Scoring::computeRank(data2);
+  double result = Scoring::rankedMutualInformation(ranks1, ranks2);
+
+  TEST_REAL_SIMILAR (result, 3.2776);
+  TEST_EQUAL (result, Scoring::rankedMutualInformation(data1, data2));
+  TEST_EQUAL (Scoring::rankedMutualInformation(ranks1, ranks1), Scoring::rankedMutualInformation(data1, data1));
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
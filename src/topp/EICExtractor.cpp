@@ -39,6 +39,7 @@
 #include <OpenMS/FORMAT/EDTAFile.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/KERNEL/MSExperimentAreaIndex.h>
 #include <OpenMS/KERNEL/MSChromatogram.h>
 #include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimatorMedian.h>
 #include <OpenMS/FILTERING/SMOOTHING/GaussFilter.h>
@@ -414,27 +415,56 @@ public:
       tf_single_header1 << description << "" << "" << "" << "";
       tf_single_header2 << "RTobs" << "dRT" << "mzobs" << "dppm" << "intensity";
 
+      // find the highest peak of each EIC
+      std::vector<MSExperimentAreaIndex::Area> eic_areas;
+      eic_areas.reserve(cm.size());
+      Size window_spectra(0); // number of spectra visited by scanning each window separately
+      for (Size i = 0; i < cm.size(); ++i)
+      {
+        double mz_da = mztol * cm[i].getMZ() / 1e6; // mz tolerance in Dalton
+        eic_areas.push_back(MSExperimentAreaIndex::Area(cm[i].getRT() - rttol / 2,
+                                                        cm[i].getRT() + rttol / 2,
+                                                        cm[i].getMZ() - mz_da,
+                                                        cm[i].getMZ() + mz_da));
+        window_spectra += std::distance(exp.RTBegin(eic_areas.back().min_rt), exp.RTEnd(eic_areas.back().max_rt));
+      }
+      std::vector<PeakIndex> highest_peaks;
+      if (window_spectra > exp.size())
+      { // windows cover the map more than once: binning all peaks once pays off
+        MSExperimentAreaIndex area_index(exp);
+        highest_peaks = area_index.findHighestPeak(eic_areas);
+      }
+      else
+      { // few windows: scan each one directly instead of copying the map into an index
+        highest_peaks.resize(eic_areas.size());
+        for (Size i = 0; i < eic_areas.size(); ++i)
+        {
+          double max_intensity(0);
+          for (PeakMap::ConstAreaIterator it = exp.areaBeginConst(eic_areas[i].min_rt, eic_areas[i].max_rt, eic_areas[i].min_mz, eic_areas[i].max_mz); it != exp.areaEndConst(); ++it)
+          {
+            if (max_intensity < it->getIntensity())
+            {
+              max_intensity = it->getIntensity();
+              highest_peaks[i] = it.getPeakIndex();
+            }
+          }
+        }
+      }
+
       for (Size i = 0; i < cm.size(); ++i)
       {
         //std::cerr << "Rt" << cm[i].getRT() << "  mz: " << cm[i].getMZ() << " R " <<  cm[i].getMetaValue("rank") << "\n";
 
         double mz_da = mztol * cm[i].getMZ() / 1e6; // mz tolerance in Dalton
-        PeakMap::ConstAreaIterator it = exp.areaBeginConst(cm[i].getRT() - rttol / 2,
-                                                                  cm[i].getRT() + rttol / 2,
-                                                                  cm[i].getMZ() - mz_da,
-                                                                  cm[i].getMZ() + mz_da);
         Peak2D max_peak;
         max_peak.setIntensity(0);
         max_peak.setRT(cm[i].getRT());
         max_peak.setMZ(cm[i].getMZ());
-        for (; it != exp.areaEndConst(); ++it)
+        if (highest_peaks[i].isValid() && highest_peaks[i].getPeak(exp).getIntensity() > 0)
         {
-          if (max_peak.getIntensity() < it->getIntensity())
-          {
-            max_peak.setIntensity(it->getIntensity());
-            max_peak.setRT(it.getRT());
-            max_peak.setMZ(it->getMZ());
-          }
+          max_peak.setIntensity(highest_peaks[i].getPeak(exp).getIntensity());
+          max_peak.setRT(highest_peaks[i].getSpectrum(exp).getRT());
+          max_peak.setMZ(highest_peaks[i].getPeak(exp).getMZ());
         }
         double ppm = 0; // observed m/z offset
 
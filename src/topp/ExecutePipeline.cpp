@@ -108,8 +108,12 @@ protected:
     setValidFormats_("in", ListUtils::create<String>("toppas"));
     registerStringOption_("out_dir", "<directory>", "", "Directory for output files (default: user's home directory)", false);
     registerStringOption_("resource_file", "<file>", "", "A TOPPAS resource file (*.trf) specifying the files this workflow is to be applied to", false);
-    registerIntOption_("num_jobs", "<integer>", 1, "Maximum number of jobs running in parallel", false, false);
+    registerIntOption_("num_jobs", "<integer>", 1, "Maximum number of threads used by all tools running in parallel (a tool counts with the value of its 'threads' parameter)", false, false);
     setMinInt_("num_jobs", 1);
+    registerIntOption_("max_memory", "<MB>", 0, "Maximum memory reserved by all tools running in parallel (0: no limit). Each run of a tool reserves the memory declared for its node in TOPPAS or, if none, the peak memory recorded in previous runs", false, true);
+    setMinInt_("max_memory", 0);
+    registerStringOption_("work_dir", "<directory>", "", "Directory for intermediate files, which is kept after the run (default: a new temporary directory which is removed)", false, true);
+    registerFlag_("resume", "Resume from the intermediate files of a previous run in 'work_dir': tool runs whose output files are up-to-date are skipped", true);
   }
 
   ExitCodes main_(int argc, const char ** argv) override
@@ -118,15 +122,40 @@ protected:
     QString out_dir_name = getStringOption_("out_dir").toQString();
     QString resource_file = getStringOption_("resource_file").toQString();
     int num_jobs = getIntOption_("num_jobs");
+    int max_memory = getIntOption_("max_memory");
+    QString work_dir = getStringOption_("work_dir").toQString();
+    bool resume = getFlag_("resume");
+    if (resume && work_dir.isEmpty())
+    {
+      writeLog_("Resuming requires a working directory ('work_dir') from a previous run.");
+      return ILLEGAL_PARAMETERS;
+    }
 
     QApplication a(argc, const_cast<char **>(argv), false);
 
-    //set & create temporary path -- make sure its a new subdirectory, as it will be deleted later
-    QString new_tmp_dir = File::getUniqueName().toQString();
-    QDir qd(File::getTempDirectory().toQString());
-    qd.mkdir(new_tmp_dir);
-    qd.cd(new_tmp_dir);
-    QString tmp_path = qd.absolutePath();
+    QString tmp_path;
+    if (!work_dir.isEmpty())
+    {
+      // use the given working directory and keep its content
+      QDir qd;
+      if (!qd.mkpath(work_dir))
+      {
+        writeLog_("Cannot create the working directory '" + String(work_dir) + "'.");
+        return CANNOT_WRITE_OUTPUT_FILE;
+      }
+      tmp_path = QDir(work_dir).absolutePath();
+    }
+    else
+    {
+      //set & create temporary path -- make sure its a new subdirectory, as it will be deleted later
+      QString new_tmp_dir = File::getUniqueName().toQString();
+      QDir qd(File::getTempDirectory().toQString());
+      qd.mkdir(new_tmp_dir);
+      qd.cd(new_tmp_dir);
+      tmp_path = qd.absolutePath();
+    }
+    // peak memory of the tools, recorded to schedule later runs
+    String resource_usage_file = String(tmp_path) + "/resource_usage.ini";
 
     TOPPASScene ts(nullptr, tmp_path, false);
     if (!a.connect(&ts, SIGNAL(entirePipelineFinished()), &a, SLOT(quit()))) return UNKNOWN_ERROR;
@@ -137,6 +166,9 @@ protected:
 
     ts.load(toppas_file);
     ts.setAllowedThreads(num_jobs);
+    ts.setAllowedMemory(UInt(max_memory));
+    ts.setResumeEnabled(resume);
+    ts.loadResourceUsage(resource_usage_file);
 
     if (resource_file != "")
     {
@@ -178,11 +210,17 @@ protected:
 
     ts.runPipeline();
 
-    if (a.exec() == 0)
+    int ret = a.exec();
+    if (!work_dir.isEmpty())
+    {
+      ts.storeResourceUsage(resource_usage_file);
+    }
+
+    if (ret == 0)
     {
       // delete temporary files
       // safety measure: only delete if subdirectory of Temp path; we do not want to delete / or c:
-      if (String(tmp_path).substitute("\\", "/").hasPrefix(File::getTempDirectory().substitute("\\", "/") + "/"))
+      if (work_dir.isEmpty() && String(tmp_path).substitute("\\", "/").hasPrefix(File::getTempDirectory().substitute("\\", "/") + "/"))
       {
         File::removeDirRecursively(tmp_path);
       }
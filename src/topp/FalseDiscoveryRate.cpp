@@ -109,9 +109,9 @@ protected:
   void registerOptionsAndFlags_() override
   {
     registerInputFile_("in", "<file>", "", "Identifications from searching a target-decoy database.");
-    setValidFormats_("in", ListUtils::create<String>("idXML"));
+    setValidFormats_("in", ListUtils::create<String>("idXML,idBin"));
     registerOutputFile_("out", "<file>", "", "Identifications with annotated FDR");
-    setValidFormats_("out", ListUtils::create<String>("idXML"));
+    setValidFormats_("out", ListUtils::create<String>("idXML,idBin"));
     registerStringOption_("PSM", "<FDR level>", "true", "Perform FDR calculation on PSM level", false);
     setValidStrings_("PSM", ListUtils::create<String>("true,false"));
     registerStringOption_("protein", "<FDR level>", "true", "Perform FDR calculation on protein level", false);
@@ -166,7 +166,11 @@ protected:
     vector<PeptideIdentification> pep_ids;
     vector<ProteinIdentification> prot_ids;
 
-    IdXMLFile().load(in, prot_ids, pep_ids);
+    if (!FileHandler().loadIdentifications(in, prot_ids, pep_ids))
+    {
+      writeLog_("Error: Unsupported or corrupt input file '" + in + "'. Aborting!");
+      return INCOMPATIBLE_INPUT_DATA;
+    }
 
     Size n_prot_ids = prot_ids.size();
     Size n_prot_hits = IDFilter::countHits(prot_ids);
@@ -283,7 +287,13 @@ protected:
              << IDFilter::countHits(pep_ids) << " pep_ids hit(s)." << endl;
 
     OPENMS_LOG_INFO << "Writing filtered output..." << endl;
-    IdXMLFile().store(out, prot_ids, pep_ids);
+    // the output is written in the input format, unless the file name says otherwise
+    FileTypes::Type out_type = FileHandler::getTypeByFileName(out);
+    if (out_type == FileTypes::UNKNOWN)
+    {
+      out_type = FileHandler::getType(in);
+    }
+    FileHandler().storeIdentifications(out, prot_ids, pep_ids, out_type);
     return EXECUTION_OK;
   }
 
@@ -142,9 +142,9 @@ protected:
     specificity.assign(EnzymaticDigestion::NamesOfSpecificity, EnzymaticDigestion::NamesOfSpecificity + EnzymaticDigestion::SIZE_OF_SPECIFICITY);
 
     registerInputFile_("in", "<file>", "", "input file ");
-    setValidFormats_("in", ListUtils::create<String>("idXML"));
+    setValidFormats_("in", ListUtils::create<String>("idXML,idBin"));
     registerOutputFile_("out", "<file>", "", "output file ");
-    setValidFormats_("out", ListUtils::create<String>("idXML"));
+    setValidFormats_("out", ListUtils::create<String>("idXML,idBin"));
 
     registerTOPPSubsection_("precursor", "Filtering by precursor attributes (RT, m/z, charge, length)");
     registerStringOption_("precursor:rt", "[min]:[max]", ":", "Retention time range to extract.", false);
@@ -243,7 +243,11 @@ protected:
 
     vector<ProteinIdentification> proteins;
     vector<PeptideIdentification> peptides;
-    IdXMLFile().load(inputfile_name, proteins, peptides);
+    if (!FileHandler().loadIdentifications(inputfile_name, proteins, peptides))
+    {
+      writeLog_("Error: Unsupported or corrupt input file '" + inputfile_name + "'. Aborting!");
+      return INCOMPATIBLE_INPUT_DATA;
+    }
 
     Size n_prot_ids = proteins.size();
     Size n_prot_hits = IDFilter::countHits(proteins);
@@ -705,7 +709,13 @@ protected:
              << peptides.size() << " peptide identification(s) with "
              << IDFilter::countHits(peptides) << " peptides hit(s)." << endl;
 
-    IdXMLFile().store(outputfile_name, proteins, peptides);
+    // the output is written in the input format, unless the file name says otherwise
+    FileTypes::Type out_type = FileHandler::getTypeByFileName(outputfile_name);
+    if (out_type == FileTypes::UNKNOWN)
+    {
+      out_type = FileHandler::getType(inputfile_name);
+    }
+    FileHandler().storeIdentifications(outputfile_name, proteins, peptides, out_type);
 
     return EXECUTION_OK;
   }
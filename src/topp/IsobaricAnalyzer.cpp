@@ -52,6 +52,7 @@
 #include <OpenMS/FORMAT/ConsensusXMLFile.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
 #include <OpenMS/FORMAT/MzQuantMLFile.h>
+#include <OpenMS/KERNEL/OnDiscMSExperiment.h>
 
 #include <OpenMS/METADATA/MSQuantifications.h>
 
@@ -111,6 +112,9 @@ using namespace std;
   but the intensities of the overall feature and of all its sub-elements will be zero.
   (If desired, such features can be removed by applying an intensity filter in @ref TOPP_FileFilter.)
   However, if the spectrum is completely empty (no ions whatsoever), no consensus feature will be generated.
+
+  Indexed mzML input is processed on disc, i.e. only the meta data of the spectra is held in memory and the peaks are read
+  on demand. Other input is loaded into memory completely. The results are the same in both cases.
   
   Isotope correction is done using non-negative least squares (NNLS), i.e.:@n
   Minimize ||Ax - b||, subject to x >= 0, where b is the vector of observed reporter intensities (with "contaminating" isotope species), 
@@ -266,10 +270,18 @@ protected:
     // loading input
     //-------------------------------------------------------------
 
-    MzMLFile mz_data_file;
+    // indexed mzML is processed on disc, i.e. only the meta data of all spectra is held in memory;
+    // the meta data is only parsed if the file has an index
+    OnDiscPeakMap exp_on_disc;
+    bool on_disc = exp_on_disc.openFile(in);
+
     PeakMap exp;
-    mz_data_file.setLogType(log_type_);
-    mz_data_file.load(in, exp);
+    if (!on_disc)
+    {
+      MzMLFile mz_data_file;
+      mz_data_file.setLogType(log_type_);
+      mz_data_file.load(in, exp);
+    }
 
     //-------------------------------------------------------------
     // init quant method
@@ -289,7 +301,14 @@ protected:
     ConsensusMap consensus_map_raw, consensus_map_quant;
 
     // extract channel information
-    channel_extractor.extractChannels(exp, consensus_map_raw);
+    if (on_disc)
+    {
+      channel_extractor.extractChannels(exp_on_disc, consensus_map_raw);
+    }
+    else
+    {
+      channel_extractor.extractChannels(exp, consensus_map_raw);
+    }
 
     IsobaricQuantifier quantifier(quant_method);
     Param quant_param(getParam_().copy("quantification:", true));
@@ -35,6 +35,7 @@
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
 
 #include <OpenMS/ANALYSIS/ID/PeptideIndexing.h>
+#include <OpenMS/FORMAT/IdBinaryFile.h>
 #include <OpenMS/FORMAT/IdXMLFile.h>
 #include <OpenMS/FORMAT/FileHandler.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
@@ -120,11 +121,11 @@ protected:
   void registerOptionsAndFlags_() override
   {
     registerInputFile_("in", "<file>", "", "Input idXML file containing the identifications.");
-    setValidFormats_("in", ListUtils::create<String>("idXML"));
+    setValidFormats_("in", ListUtils::create<String>("idXML,idBin"));
     registerInputFile_("fasta", "<file>", "", "Input sequence database in FASTA format. Non-existing relative filenames are looked up via 'OpenMS.ini:id_db_dir'", true, false, ListUtils::create<String>("skipexists"));
     setValidFormats_("fasta", ListUtils::create<String>("fasta"));
     registerOutputFile_("out", "<file>", "", "Output idXML file.");
-    setValidFormats_("out", ListUtils::create<String>("idXML"));
+    setValidFormats_("out", ListUtils::create<String>("idXML,idBin"));
 
     registerFullParam_(PeptideIndexing().getParameters());
    }
@@ -170,7 +171,18 @@ protected:
 
     IdXMLFile idxmlfile;
     idxmlfile.setLogType(this->log_type_);
-    idxmlfile.load(in, prot_ids, pep_ids);
+    IdBinaryFile idbinfile;
+    idbinfile.setLogType(this->log_type_);
+
+    const FileTypes::Type in_type = FileHandler::getType(in);
+    if (in_type == FileTypes::IDBIN)
+    {
+      idbinfile.load(in, prot_ids, pep_ids);
+    }
+    else
+    {
+      idxmlfile.load(in, prot_ids, pep_ids);
+    }
 
     //-------------------------------------------------------------
     // calculations
@@ -194,7 +206,20 @@ protected:
     //-------------------------------------------------------------
     // writing output
     //-------------------------------------------------------------
-    idxmlfile.store(out, prot_ids, pep_ids);
+    // the output is written in the input format, unless the file name says otherwise
+    FileTypes::Type out_type = FileHandler::getTypeByFileName(out);
+    if (out_type == FileTypes::UNKNOWN)
+    {
+      out_type = in_type;
+    }
+    if (out_type == FileTypes::IDBIN)
+    {
+      idbinfile.store(out, prot_ids, pep_ids);
+    }
+    else
+    {
+      idxmlfile.store(out, prot_ids, pep_ids);
+    }
 
     if (indexer_exit == PeptideIndexing::DATABASE_EMPTY)
     {
@@ -36,7 +36,7 @@
 #include <OpenMS/ANALYSIS/ID/IDMergerAlgorithm.h>
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
 #include <OpenMS/CONCEPT/VersionInfo.h>
-#include <OpenMS/FORMAT/IdXMLFile.h>
+#include <OpenMS/FORMAT/FileHandler.h>
 #include <OpenMS/SYSTEM/StopWatch.h>
 
 #include <set>
@@ -107,9 +107,9 @@ protected:
   {
     //TODO allow consensusXML version
     registerInputFileList_("in", "<file>", StringList(), "input file(s)");
-    setValidFormats_("in", ListUtils::create<String>("idXML"));
+    setValidFormats_("in", ListUtils::create<String>("idXML,idBin"));
     registerOutputFile_("out", "<file>", "", "output file");
-    setValidFormats_("out", ListUtils::create<String>("idXML"));
+    setValidFormats_("out", ListUtils::create<String>("idXML,idBin"));
 
     //TODO add function to merge based on replicates only. Needs additional exp. design file then.
     registerStringOption_("merge_runs", "<choice>", "no",
@@ -155,7 +155,7 @@ protected:
     vector<ProteinIdentification> inferred_protein_ids{1};
     vector<PeptideIdentification> inferred_peptide_ids;
 
-    IdXMLFile f;
+    FileHandler f;
     if (merge_runs)
     {
       //TODO allow keep_best_pepmatch_only option during merging (Peptide-level datastructure would help a lot,
@@ -169,14 +169,22 @@ protected:
       {
         vector<ProteinIdentification> protein_ids;
         vector<PeptideIdentification> peptide_ids;
-        f.load(idfile, protein_ids, peptide_ids);
+        if (!f.loadIdentifications(idfile, protein_ids, peptide_ids))
+        {
+          writeLog_("Error: Unsupported or corrupt input file '" + idfile + "'. Aborting!");
+          return INCOMPATIBLE_INPUT_DATA;
+        }
         merger.insertRuns(std::move(protein_ids), std::move(peptide_ids));
       }
       merger.returnResultsAndClear(inferred_protein_ids[0], inferred_peptide_ids);
     }
     else
     {
-      f.load(in[0], inferred_protein_ids, inferred_peptide_ids);
+      if (!f.loadIdentifications(in[0], inferred_protein_ids, inferred_peptide_ids))
+      {
+        writeLog_("Error: Unsupported or corrupt input file '" + in[0] + "'. Aborting!");
+        return INCOMPATIBLE_INPUT_DATA;
+      }
     }
     OPENMS_LOG_INFO << "Loading input took " << sw.toString() << std::endl;
     sw.reset();
@@ -212,7 +220,13 @@ protected:
     OPENMS_LOG_INFO << "Storing output..." << std::endl;
     sw.start();
     // write output
-    IdXMLFile().store(out, inferred_protein_ids, inferred_peptide_ids);
+    // the output is written in the format of the (first) input, unless the file name says otherwise
+    FileTypes::Type out_type = FileHandler::getTypeByFileName(out);
+    if (out_type == FileTypes::UNKNOWN)
+    {
+      out_type = FileHandler::getType(in[0]);
+    }
+    f.storeIdentifications(out, inferred_protein_ids, inferred_peptide_ids, out_type);
     OPENMS_LOG_INFO << "Storing output took " << sw.toString() << std::endl;
     sw.stop();
 
@@ -94,6 +94,10 @@ using namespace std;
 
     Only features/feature groups with unambiguous peptide annotation are used for peptide quantification. It is possible to resolve ambiguities before applying ProteinQuantifier using one of several equivalent mechanisms in OpenMS: @ref TOPP_IDConflictResolver, @ref TOPP_ConsensusID (algorithm @p best), or @ref TOPP_FileFilter (option @p id:keep_best_score_id).
 
+    <B>Input: several featureXML or consensusXML files</B>
+
+    To quantify many runs without holding all of them in memory, further files of the same type as @p in can be given as @p in_additional. All files are loaded and aggregated one at a time, so that only the peptide-level data is kept between files (see PeptideAndProteinQuant::addQuantData()). For featureXML input, file number @e i (counting @p in as the first file) corresponds to the @e i-th row of the MS file section of the experimental @p design; without a design, each file is treated as a separate sample. For consensusXML input, an experimental @p design is required: the map indexes of the first file refer to the first rows of the design, those of the second file to the following rows, and so on. Protein inference results contained in the input files themselves are only used for single-file input (use @p protein_groups otherwise), and mzTab output is only available for a single consensusXML file.
+
     Similarly, only proteotypic peptides (i.e. those matching to exactly one protein) are used for protein quantification <em>by default</em>. Peptide/protein IDs from multiple identification runs can be handled, but will not be differentiated (i.e. protein accessions for a peptide will be accumulated over all identification runs). See section "Optional input: Protein inference/grouping results" below for exceptions to this.
 
     Peptides with the same sequence, but with different modifications are quantified separately on the peptide level, but treated as one peptide for the protein quantification (i.e. the contributions of differently-modified variants of the same peptide are accumulated).
@@ -356,6 +360,8 @@ protected:
   {
     registerInputFile_("in", "<file>", "", "Input file");
     setValidFormats_("in", ListUtils::create<String>("featureXML,consensusXML,idXML"));
+    registerInputFileList_("in_additional", "<files>", StringList(), "Further input files of the same type as 'in' (featureXML or consensusXML); all files are aggregated one at a time, in the order 'in', 'in_additional'", false);
+    setValidFormats_("in_additional", ListUtils::create<String>("featureXML,consensusXML"));
     registerInputFile_("protein_groups", "<file>", "", "Protein inference results for the identification runs that were used to annotate the input (e.g. from ProteinProphet via IDFileConverter or Fido via FidoAdapter).\nInformation about indistinguishable proteins will be used for protein quantification.", false);
     setValidFormats_("protein_groups", ListUtils::create<String>("idXML"));
 
@@ -585,8 +591,16 @@ protected:
   {
     String what = (proteins ? "Protein" : "Peptide");
     bool old = out.modifyStrings(false);
-    out << "# " + what + " abundances computed from file '" +
-      getStringOption_("in") + "'" << endl;
+    StringList in = getInputFiles_();
+    if (in.size() == 1)
+    {
+      out << "# " + what + " abundances computed from file '" + in[0] + "'" << endl;
+    }
+    else
+    {
+      out << "# " + what + " abundances computed from files '" +
+        ListUtils::concatenate(in, "', '") + "'" << endl;
+    }
     StringList relevant_params;
     if (proteins) // parameters relevant only for protein output
     {
@@ -712,9 +726,18 @@ protected:
     }
   }
 
+  /// Returns all input files ('in' followed by 'in_additional')
+  StringList getInputFiles_() const
+  {
+    StringList in(1, getStringOption_("in"));
+    StringList additional = getStringList_("in_additional");
+    in.insert(in.end(), additional.begin(), additional.end());
+    return in;
+  }
+
   ExitCodes main_(int, const char**) override
   {
-    String in = getStringOption_("in");
+    StringList in = getInputFiles_();
     String out = getStringOption_("out");
     String peptide_out = getStringOption_("peptide_out");
     String mztab = getStringOption_("mztab");
@@ -751,7 +774,33 @@ protected:
       }
     }
 
-    FileTypes::Type in_type = FileHandler::getType(in);
+    FileTypes::Type in_type = FileHandler::getType(in[0]);
+    for (const String& file : in)
+    {
+      if (FileHandler::getType(file) != in_type)
+      {
+        writeLog_("All input files must be of the same type. Aborting!");
+        return ILLEGAL_PARAMETERS;
+      }
+    }
+    if (in.size() > 1)
+    {
+      if (in_type == FileTypes::IDXML)
+      {
+        writeLog_("Only a single idXML input file is supported (use IDMerger to combine several files). Aborting!");
+        return ILLEGAL_PARAMETERS;
+      }
+      if ((in_type == FileTypes::CONSENSUSXML) && design_file.empty())
+      {
+        writeLog_("An experimental design ('design') is required for several consensusXML input files. Aborting!");
+        return ILLEGAL_PARAMETERS;
+      }
+      if (!mztab.empty())
+      {
+        writeLog_("mzTab output is only supported for a single consensusXML input file. Aborting!");
+        return ILLEGAL_PARAMETERS;
+      }
+    }
 
     PeptideAndProteinQuant quantifier;
     algo_params_ = quantifier.getParameters();
@@ -762,11 +811,71 @@ protected:
 
     ExperimentalDesign ed;
 
-    if (in_type == FileTypes::FEATUREXML)
+    if ((in_type == FileTypes::FEATUREXML) && (in.size() > 1))
+    {
+      if (!design_file.empty())
+      {
+        ed = ExperimentalDesignFile::load(design_file, false);
+        if (ed.getNumberOfMSFiles() != in.size())
+        {
+          writeLog_("The experimental design must contain one MS file row per input file. Aborting!");
+          return ILLEGAL_PARAMETERS;
+        }
+      }
+      else // one sample per input file
+      {
+        ExperimentalDesign::MSFileSection rows;
+        for (Size i = 0; i < in.size(); ++i)
+        {
+          ExperimentalDesign::MSFileSectionEntry r;
+          r.path = in[i];
+          r.fraction = 1;
+          r.sample = i + 1;
+          r.fraction_group = i + 1;
+          r.label = 1;
+          rows.push_back(r);
+        }
+        ed.setMSFileSection(rows);
+      }
+
+      quantifier.startQuantData(ed);
+      for (Size i = 0; i < in.size(); ++i)
+      {
+        FeatureMap features;
+        FeatureXMLFile().load(in[i], features);
+        columns_headers_[i].filename = in[i];
+        quantifier.addQuantData(features, i);
+      } // "features" is released here, only the accumulated data is kept
+      quantifier.finishQuantData();
+      quantifier.quantifyPeptides(peptides_); // quantify on peptide level
+      quantifier.quantifyProteins(proteins_);
+    }
+    else if ((in_type == FileTypes::CONSENSUSXML) && (in.size() > 1))
+    {
+      ed = ExperimentalDesignFile::load(design_file, false);
+
+      quantifier.startQuantData(ed);
+      Size first_row = 0;
+      for (const String& file : in)
+      {
+        ConsensusMap consensus;
+        ConsensusXMLFile().load(file, consensus);
+        for (const auto& header : consensus.getColumnHeaders())
+        {
+          columns_headers_[first_row + header.first] = header.second;
+        }
+        quantifier.addQuantData(consensus, first_row);
+        first_row += consensus.getColumnHeaders().size();
+      } // "consensus" is released here, only the accumulated data is kept
+      quantifier.finishQuantData();
+      quantifier.quantifyPeptides(peptides_); // quantify on peptide level
+      quantifier.quantifyProteins(proteins_);
+    }
+    else if (in_type == FileTypes::FEATUREXML)
     {
       FeatureMap features;
-      FeatureXMLFile().load(in, features);
-      columns_headers_[0].filename = in;
+      FeatureXMLFile().load(in[0], features);
+      columns_headers_[0].filename = in[0];
 
       ed = getExperimentalDesignFeatureMap_(design_file, features);
 
@@ -786,7 +895,7 @@ protected:
       spectral_counting_ = true;
       vector<ProteinIdentification> proteins;
       vector<PeptideIdentification> peptides;
-      IdXMLFile().load(in, proteins, peptides);
+      IdXMLFile().load(in[0], proteins, peptides);
       for (Size i = 0; i < proteins.size(); ++i)
       {
         columns_headers_[i].filename = proteins[i].getSearchEngine() + "_" + proteins[i].getDateTime().toString(Qt::ISODate);
@@ -807,7 +916,7 @@ protected:
     else // consensusXML
     {
       ConsensusMap consensus;
-      ConsensusXMLFile().load(in, consensus);
+      ConsensusXMLFile().load(in[0], consensus);
       columns_headers_ = consensus.getColumnHeaders();
 
       ed = getExperimentalDesignConsensusMap_(design_file, consensus);
@@ -843,7 +952,7 @@ protected:
         const bool report_unmapped(true);
         const bool report_unidentified_features(false);
         const bool report_subfeatures(false);
-        MzTab m = MzTab::exportConsensusMapToMzTab(consensus, in, true, report_unidentified_features, report_unmapped, report_subfeatures);
+        MzTab m = MzTab::exportConsensusMapToMzTab(consensus, in[0], true, report_unidentified_features, report_unmapped, report_subfeatures);
         MzTabFile().store(mztab, m);
       }
     }
@@ -36,10 +36,12 @@
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
 #include <OpenMS/CONCEPT/Factory.h>
+#include <OpenMS/CONCEPT/ParallelExceptionCollector.h>
 #include <OpenMS/FORMAT/MSPFile.h>
 #include <OpenMS/FORMAT/IdXMLFile.h>
 #include <OpenMS/COMPARISON/SPECTRA/BinnedSpectrum.h>
 #include <OpenMS/COMPARISON/SPECTRA/SpectraSTSimilarityScore.h>
+#include <OpenMS/COMPARISON/SPECTRA/SpectralLibraryIndex.h>
 #include <OpenMS/COMPARISON/SPECTRA/ZhangSimilarityScore.h>
 #include <OpenMS/CHEMISTRY/ModificationsDB.h>
 #include <OpenMS/MATH/MISC/MathFunctions.h>
@@ -48,6 +50,12 @@
 #include <vector>
 #include <map>
 #include <cmath>
+#include <memory>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace OpenMS;
 using namespace std;
 
@@ -74,6 +82,11 @@ using namespace std;
     </table>
 </CENTER>
 
+    Library spectra are binned once and kept in a search index (see SpectralLibraryIndex), which is sorted by precursor m/z
+    and additionally stores the most intense fragment bins of every library spectrum. With @p filter:min_shared_top_bins,
+    only library spectra that share the given number of their top fragment bins with the query are scored.
+    Query spectra are searched in parallel.
+
     @experimental This TOPP-tool is not well tested and not all features might be properly implemented and tested.
 
     @note Currently mzIdentML (mzid) is not directly supported as an input/output format of this tool. Convert mzid files to/from idXML using @ref TOPP_IDFileConverter if necessary.
@@ -147,6 +160,9 @@ protected:
     registerIntOption_("filter:min_peaks", "<number>", 5, "required minimum number of peaks for a query spectrum", false);
     registerIntOption_("filter:max_peaks", "<number>", 150, "Use only the top <number> of peaks.", false);
     registerIntOption_("filter:cut_peaks_below", "<number>", 1000, "Remove all peaks which are lower than 1/<number> of the highest peaks. Default equals all peaks which are lower than 0.001 of the maximum intensity peak", false);
+    registerIntOption_("filter:min_shared_top_bins", "<number>", 0, "Only score library spectra that share at least <number> of their five most intense fragment bins (1 Th) with the five most intense bins of the query spectrum ('0' to score all library spectra in the precursor window)", false, true);
+    setMinInt_("filter:min_shared_top_bins", 0);
+    setMaxInt_("filter:min_shared_top_bins", 5);
 
     registerTOPPSubsection_("modifications", "Modifications Options");
     vector<String> all_mods;
@@ -160,15 +176,13 @@ protected:
     addEmptyLine_();
   }
 
-  using MapLibraryPrecursorToLibrarySpectrum = multimap<double, PeakSpectrum>;
-    
-  MapLibraryPrecursorToLibrarySpectrum annotateIdentificationsToSpectra_(const vector<PeptideIdentification>& ids, 
+  vector<PeakSpectrum> annotateIdentificationsToSpectra_(const vector<PeptideIdentification>& ids, 
     const PeakMap& library, 
     StringList variable_modifications, 
     StringList fixed_modifications,
     double remove_peaks_below_threshold)
   {
-    MapLibraryPrecursorToLibrarySpectrum annotated_lib;
+    vector<PeakSpectrum> annotated_lib;
 
     ModificationsDB* mdb = ModificationsDB::getInstance();
 
@@ -179,7 +193,6 @@ protected:
     for (; library_it < library.end(); ++library_it, ++id_it)
     {
       const MSSpectrum& lib_spec = *library_it;
-      const double& precursor_MZ = lib_spec.getPrecursors()[0].getMZ();
 
       const PeptideIdentification& id = *id_it;
       const AASequence& aaseq = id.getHits()[0].getSequence();
@@ -260,7 +273,7 @@ protected:
            lib_entry.push_back(peak);
          }
        }
-       annotated_lib.insert(make_pair(precursor_MZ, lib_entry));
+       annotated_lib.push_back(lib_entry);
      }
     return annotated_lib;
   }
@@ -293,6 +306,7 @@ protected:
     UInt min_peaks = getIntOption_("filter:min_peaks");
     UInt max_peaks = getIntOption_("filter:max_peaks");
     Int cut_peaks_below = getIntOption_("filter:cut_peaks_below");
+    Size min_shared_top_bins = getIntOption_("filter:min_shared_top_bins");
 
     StringList fixed_modifications = getStringList_("modifications:fixed");
     StringList variable_modifications = getStringList_("modifications:variable");
@@ -349,18 +363,22 @@ protected:
     cout << endl;
     */
 
-    MapLibraryPrecursorToLibrarySpectrum mslib = annotateIdentificationsToSpectra_(ids, library, variable_modifications, fixed_modifications, remove_peaks_below_threshold);
+    vector<PeakSpectrum> mslib = annotateIdentificationsToSpectra_(ids, library, variable_modifications, fixed_modifications, remove_peaks_below_threshold);
+
+    // sort by precursor m/z and bin library spectra once (for all queries)
+    SpectralLibraryIndex lib_index;
+    lib_index.build(mslib);
 
     time_t end_build_time = time(nullptr);
     OPENMS_LOG_INFO << "Time needed for preprocessing data: " << (end_build_time - start_build_time) << "\n";
 
-    //compare function
-    PeakSpectrumCompareFunctor* comparor = Factory<PeakSpectrumCompareFunctor>::create(compare_function);
- 
-   //-------------------------------------------------------------
+    // SpectraST scores are dot products of the binned spectra (cached in the index)
+    const bool spectrast_score = (compare_function == "SpectraSTSimilarityScore");
+    SpectraSTSimilarityScore spectrast;
+
+    //-------------------------------------------------------------
     // calculations
     //-------------------------------------------------------------
-    double score;
     StringList::iterator in, out_file;
     for (in  = in_spec.begin(), out_file  = out.begin(); in < in_spec.end(); ++in, ++out_file)
     {
@@ -400,179 +418,235 @@ protected:
       /***********SEARCH**********/
       for (UInt j = 0; j < query.size(); ++j)
       {
-        //Set identifier for each identifications
-        PeptideIdentification pid;
-        pid.setIdentifier("test");
-        pid.setScoreType(compare_function);
         ProteinHit pr_hit;
         pr_hit.setAccession(j);
         prot_id.insertHit(pr_hit);
+      }
 
-        // proper MS2?
-        if (query[j].empty() || query[j].getMSLevel() != 2) {continue; }
-
-        if (query[j].getPrecursors().empty())
-        {
-          writeLog_("Warning MS2 spectrum without precursor information");
-          continue;
-        }
-
-        // filter query spectrum
-        double max_intensity = std::max_element(query[j].begin(), query[j].end(), 
-                                [](const Peak1D& l, const Peak1D& r) 
-                                { 
-                                  return (l.getIntensity() < r.getIntensity()); 
-                                })->getIntensity();
-
-        double min_high_intensity = max_intensity / cut_peaks_below;
+      // query spectra are searched independently; results are stored by
+      // query index to keep the output order independent of the threads
+      vector<PeptideIdentification> query_ids(query.size());
+      vector<Int> searched(query.size(), 0);
+      // compare functors may keep internal state, so every thread uses its own;
+      // they are created before the parallel region so that errors propagate:
+#ifdef _OPENMP
+      const Size n_threads = omp_get_max_threads();
+#else
+      const Size n_threads = 1;
+#endif
+      vector<unique_ptr<PeakSpectrumCompareFunctor> > comparors;
+      for (Size t = 0; t < n_threads; ++t)
+      {
+        comparors.emplace_back(Factory<PeakSpectrumCompareFunctor>::create(compare_function));
+      }
 
-        PeakSpectrum filtered_query;
-        for (UInt k = 0; k < query[j].size(); ++k)
+      ParallelExceptionCollector errors;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+      {
+#ifdef _OPENMP
+        PeakSpectrumCompareFunctor* comparor = comparors[omp_get_thread_num()].get();
+#else
+        PeakSpectrumCompareFunctor* comparor = comparors[0].get();
+#endif
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 10)
+#endif
+        for (SignedSize j = 0; j < SignedSize(query.size()); ++j)
         {
-          if (query[j][k].getIntensity() >= remove_peaks_below_threshold 
-           && query[j][k].getIntensity() >= min_high_intensity)
+          try
           {
-            Peak1D peak;
-            peak.setIntensity(sqrt(query[j][k].getIntensity()));
-            peak.setMZ(query[j][k].getMZ());
-            filtered_query.push_back(peak);
-          }
-        }
-
-        // retain only top N peaks
-        if (filtered_query.size() > max_peaks)
-        {
-          filtered_query.sortByIntensity(true);
-          filtered_query.resize(max_peaks);
-          filtered_query.sortByPosition();
-        }
-
-        if (filtered_query.size() < min_peaks) { continue; }
+            //Set identifier for each identifications
+            PeptideIdentification pid;
+            pid.setIdentifier("test");
+            pid.setScoreType(compare_function);
+            String accession(j);
 
-        const double& query_rt = query[j].getRT();
-        const int& query_charge = query[j].getPrecursors()[0].getCharge();
-        const double query_mz = query[j].getPrecursors()[0].getMZ();
-        
-        if (query_charge > 0 && (query_charge < pc_min_charge || query_charge > pc_max_charge)) { continue; } 
+            // proper MS2?
+            if (query[j].empty() || query[j].getMSLevel() != 2) {continue; }
 
-        for (auto const & iso : isotopes)
-        {
-          // isotopic misassignment corrected query
-          const double ic_query_mz = query_mz - iso * Constants::C13C12_MASSDIFF_U;
+            if (query[j].getPrecursors().empty())
+            {
+#ifdef _OPENMP
+#pragma omp critical (SpecLibSearcher_Log)
+#endif
+              writeLog_("Warning MS2 spectrum without precursor information");
+              continue;
+            }
 
-          // if tolerance unit is ppm convert to m/z
-          const double precursor_mass_tolerance_mz = precursor_mass_tolerance_unit_ppm ? ic_query_mz * precursor_mass_tolerance * 1e-6 : precursor_mass_tolerance;
+            // filter query spectrum
+            double max_intensity = std::max_element(query[j].begin(), query[j].end(), 
+                                    [](const Peak1D& l, const Peak1D& r) 
+                                    { 
+                                      return (l.getIntensity() < r.getIntensity()); 
+                                    })->getIntensity();
 
-          // skip matching of isotopic misassignments if charge not annotated
-          if (iso != 0 && query_charge == 0) { continue; }
+            double min_high_intensity = max_intensity / cut_peaks_below;
 
-          // skip matching of isotopic misassignments if search windows around isotopic peaks would overlap (resulting in more than one report of the same hit)
-          const double isotopic_peak_distance_mz = Constants::C13C12_MASSDIFF_U / query_charge;
-          if (iso != 0 && precursor_mass_tolerance_mz >= 0.5 * isotopic_peak_distance_mz) { continue; }
+            PeakSpectrum filtered_query;
+            for (UInt k = 0; k < query[j].size(); ++k)
+            {
+              if (query[j][k].getIntensity() >= remove_peaks_below_threshold 
+               && query[j][k].getIntensity() >= min_high_intensity)
+              {
+                Peak1D peak;
+                peak.setIntensity(sqrt(query[j][k].getIntensity()));
+                peak.setMZ(query[j][k].getMZ());
+                filtered_query.push_back(peak);
+              }
+            }
 
-          /* TODO: remove old code for charge estimation?
-          bool charge_one = false;
-          Int percent = (Int) Math::round((query[j].size() / 100.0) * 3.0);
-          Int margin  = (Int) Math::round((query[j].size() / 100.0) * 1.0);
-          for (vector<Peak1D>::iterator peak = query[j].end() - 1; percent >= 0; --peak, --percent)
-          {
-            if (peak->getMZ() < query_MZ)
+            // retain only top N peaks
+            if (filtered_query.size() > max_peaks)
             {
-              break;
+              filtered_query.sortByIntensity(true);
+              filtered_query.resize(max_peaks);
+              filtered_query.sortByPosition();
             }
-          }
-          if (percent > margin)
-          {
-            charge_one = true;
-          }
-          */
 
+            if (filtered_query.size() < min_peaks) { continue; }
 
-          // determine MS2 precursors that match to the current peptide mass
-          MapLibraryPrecursorToLibrarySpectrum::const_iterator low_it, up_it;
-        
-          low_it = mslib.lower_bound(ic_query_mz - 0.5 * precursor_mass_tolerance_mz);
-          up_it = mslib.upper_bound(ic_query_mz + 0.5 * precursor_mass_tolerance_mz);
+            const double& query_rt = query[j].getRT();
+            const int& query_charge = query[j].getPrecursors()[0].getCharge();
+            const double query_mz = query[j].getPrecursors()[0].getMZ();
         
-          // no matching precursor in data
-          if (low_it == up_it) { continue; }
-       
-          for (; low_it != up_it; ++low_it)
-          {
-            const PeakSpectrum& lib_spec = low_it->second;;
-            PeptideHit hit = lib_spec.getPeptideIdentifications()[0].getHits()[0];
-            const int& lib_charge = hit.getCharge();  
-
-            // check if charge state between library and experimental spectrum match
-            if (query_charge > 0 && lib_charge != query_charge) { continue; }
+            if (query_charge > 0 && (query_charge < pc_min_charge || query_charge > pc_max_charge)) { continue; } 
 
-            // Special treatment for SpectraST score as it computes a score based on the whole library
-            if (compare_function == "SpectraSTSimilarityScore")
+            // binned query (only needed for SpectraST scores and the top bin filter)
+            BinnedSpectrum quer_bin_spec;
+            if (spectrast_score || min_shared_top_bins > 0)
             {
-              SpectraSTSimilarityScore* sp = static_cast<SpectraSTSimilarityScore*>(comparor);
-              BinnedSpectrum quer_bin_spec = sp->transform(filtered_query);
-              BinnedSpectrum lib_bin_spec = sp->transform(lib_spec);
-              score = (*sp)(filtered_query, lib_spec); //(*sp)(quer_bin,librar_bin);
-              double dot_bias = sp->dot_bias(quer_bin_spec, lib_bin_spec, score);
-              hit.setMetaValue("DOTBIAS", dot_bias);
+              quer_bin_spec = lib_index.binSpectrum(filtered_query);
             }
-            else
+
+            for (auto const & iso : isotopes)
             {
-              score = (*comparor)(filtered_query, lib_spec);
-            }
+              // isotopic misassignment corrected query
+              const double ic_query_mz = query_mz - iso * Constants::C13C12_MASSDIFF_U;
 
-            DataValue RT(lib_spec.getRT());
-            DataValue MZ(lib_spec.getPrecursors()[0].getMZ());
-            hit.setMetaValue("lib:RT", RT);
-            hit.setMetaValue("lib:MZ", MZ);
-            hit.setMetaValue("isotope_error", iso);
-            hit.setScore(score);
-            PeptideEvidence pe;
-            pe.setProteinAccession(pr_hit.getAccession());
-            hit.addPeptideEvidence(pe);
-            pid.insertHit(hit);
-          }
-        }
+              // if tolerance unit is ppm convert to m/z
+              const double precursor_mass_tolerance_mz = precursor_mass_tolerance_unit_ppm ? ic_query_mz * precursor_mass_tolerance * 1e-6 : precursor_mass_tolerance;
 
-        pid.setHigherScoreBetter(true);
-        pid.sort();
+              // skip matching of isotopic misassignments if charge not annotated
+              if (iso != 0 && query_charge == 0) { continue; }
 
-        if (compare_function == "SpectraSTSimilarityScore")
-        {
-          if (!pid.empty() && !pid.getHits().empty())
-          {
-            vector<PeptideHit> final_hits;
-            final_hits.resize(pid.getHits().size());
-            SpectraSTSimilarityScore* sp = static_cast<SpectraSTSimilarityScore*>(comparor);
-            Size runner_up = 1;
-            for (; runner_up < pid.getHits().size(); ++runner_up)
+              // skip matching of isotopic misassignments if search windows around isotopic peaks would overlap (resulting in more than one report of the same hit)
+              const double isotopic_peak_distance_mz = Constants::C13C12_MASSDIFF_U / query_charge;
+              if (iso != 0 && precursor_mass_tolerance_mz >= 0.5 * isotopic_peak_distance_mz) { continue; }
+
+              /* TODO: remove old code for charge estimation?
+              bool charge_one = false;
+              Int percent = (Int) Math::round((query[j].size() / 100.0) * 3.0);
+              Int margin  = (Int) Math::round((query[j].size() / 100.0) * 1.0);
+              for (vector<Peak1D>::iterator peak = query[j].end() - 1; percent >= 0; --peak, --percent)
+              {
+                if (peak->getMZ() < query_MZ)
+                {
+                  break;
+                }
+              }
+              if (percent > margin)
+              {
+                charge_one = true;
+              }
+              */
+
+
+              // determine MS2 precursors that match to the current peptide mass
+              vector<Size> candidates = lib_index.findCandidates(quer_bin_spec,
+                ic_query_mz - 0.5 * precursor_mass_tolerance_mz,
+                ic_query_mz + 0.5 * precursor_mass_tolerance_mz,
+                min_shared_top_bins);
+
+              for (Size lib_idx : candidates)
+              {
+                const PeakSpectrum& lib_spec = mslib[lib_idx];
+                PeptideHit hit = lib_spec.getPeptideIdentifications()[0].getHits()[0];
+                const int& lib_charge = hit.getCharge();  
+
+                // check if charge state between library and experimental spectrum match
+                if (query_charge > 0 && lib_charge != query_charge) { continue; }
+
+                // Special treatment for SpectraST score as it computes a score based on the whole library
+                double score;
+                if (spectrast_score)
+                {
+                  const BinnedSpectrum& lib_bin_spec = lib_index.getBinnedSpectrum(lib_idx);
+                  score = spectrast(quer_bin_spec, lib_bin_spec);
+                  double dot_bias = spectrast.dot_bias(quer_bin_spec, lib_bin_spec, score);
+                  hit.setMetaValue("DOTBIAS", dot_bias);
+                }
+                else
+                {
+                  score = (*comparor)(filtered_query, lib_spec);
+                }
+
+                DataValue RT(lib_spec.getRT());
+                DataValue MZ(lib_spec.getPrecursors()[0].getMZ());
+                hit.setMetaValue("lib:RT", RT);
+                hit.setMetaValue("lib:MZ", MZ);
+                hit.setMetaValue("isotope_error", iso);
+                hit.setScore(score);
+                PeptideEvidence pe;
+                pe.setProteinAccession(accession);
+                hit.addPeptideEvidence(pe);
+                pid.insertHit(hit);
+              }
+            }
+
+            pid.setHigherScoreBetter(true);
+            pid.sort();
+
+            if (spectrast_score)
             {
-              if (pid.getHits()[0].getSequence().toUnmodifiedString() != pid.getHits()[runner_up].getSequence().toUnmodifiedString() 
-               || runner_up > 5)
+              if (!pid.empty() && !pid.getHits().empty())
               {
-                break;
+                vector<PeptideHit> final_hits;
+                final_hits.resize(pid.getHits().size());
+                Size runner_up = 1;
+                for (; runner_up < pid.getHits().size(); ++runner_up)
+                {
+                  if (pid.getHits()[0].getSequence().toUnmodifiedString() != pid.getHits()[runner_up].getSequence().toUnmodifiedString() 
+                   || runner_up > 5)
+                  {
+                    break;
+                  }
+                }
+                double delta_D = spectrast.delta_D(pid.getHits()[0].getScore(), pid.getHits()[runner_up].getScore());
+                for (Size s = 0; s < pid.getHits().size(); ++s)
+                {
+                  final_hits[s] = pid.getHits()[s];
+                  final_hits[s].setMetaValue("delta D", delta_D);
+                  final_hits[s].setMetaValue("dot product", pid.getHits()[s].getScore());
+                  final_hits[s].setScore(spectrast.compute_F(pid.getHits()[s].getScore(), delta_D, pid.getHits()[s].getMetaValue("DOTBIAS")));
+                }
+                pid.setHits(final_hits);
+                pid.sort();
+                pid.setMZ(query[j].getPrecursors()[0].getMZ());
+                pid.setRT(query_rt);
               }
             }
-            double delta_D = sp->delta_D(pid.getHits()[0].getScore(), pid.getHits()[runner_up].getScore());
-            for (Size s = 0; s < pid.getHits().size(); ++s)
+
+            if (top_hits != -1 && (UInt)top_hits < pid.getHits().size())
             {
-              final_hits[s] = pid.getHits()[s];
-              final_hits[s].setMetaValue("delta D", delta_D);
-              final_hits[s].setMetaValue("dot product", pid.getHits()[s].getScore());
-              final_hits[s].setScore(sp->compute_F(pid.getHits()[s].getScore(), delta_D, pid.getHits()[s].getMetaValue("DOTBIAS")));
+              pid.getHits().resize(top_hits);
             }
-            pid.setHits(final_hits);
-            pid.sort();
-            pid.setMZ(query[j].getPrecursors()[0].getMZ());
-            pid.setRT(query_rt);
+            query_ids[j] = pid;
+            searched[j] = 1;
+          }
+          catch (...)
+          {
+            errors.capture(j);
           }
         }
+      }
+      errors.rethrowFirst();
 
-        if (top_hits != -1 && (UInt)top_hits < pid.getHits().size())
-        {
-          pid.getHits().resize(top_hits);
-        }
-        peptide_ids.push_back(pid);
+      for (Size j = 0; j < query.size(); ++j)
+      {
+        if (searched[j]) peptide_ids.push_back(query_ids[j]);
       }
       protein_ids.push_back(prot_id);
 